@@ -21,6 +21,10 @@
 
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <vector>
 
 #include "celix_log_sink.h"
 #include "celix_log_control.h"
@@ -31,9 +35,12 @@
 
 class LogBundleTestSuite : public ::testing::Test {
 public:
-    LogBundleTestSuite() {
+    explicit LogBundleTestSuite(std::vector<std::pair<std::string, std::string>> config = {}) {
         auto* properties = celix_properties_create();
         celix_properties_set(properties, "org.osgi.framework.storage", ".cacheLogBundleTestSuite");
+        for (const auto& entry : config) {
+            celix_properties_set(properties, entry.first.c_str(), entry.second.c_str());
+        }
 
 
         auto* fwPtr = celix_frameworkFactory_createFramework(properties);
@@ -470,4 +477,175 @@ TEST_F(LogBundleTestSuite, LogAdminCmd) {
     };
     called = celix_bundleContext_useServiceWithOptions(ctx.get(), &opts);
     EXPECT_TRUE(called);
-}
\ No newline at end of file
+}
+class LogBundleAsyncTestSuite : public LogBundleTestSuite {
+public:
+    explicit LogBundleAsyncTestSuite(const char* policy = "drop") : LogBundleTestSuite{{
+            {"CELIX_LOG_ADMIN_ASYNC", "true"},
+            {"CELIX_LOG_ADMIN_ASYNC_BUFFER_SIZE", "4"},
+            {"CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY", policy}}} {}
+};
+
+class LogBundleAsyncBlockTestSuite : public LogBundleAsyncTestSuite {
+public:
+    LogBundleAsyncBlockTestSuite() : LogBundleAsyncTestSuite{"block"} {}
+};
+
+/**
+ * Log sink which stores the formatted log messages and can be paused to simulate a slow log sink.
+ */
+struct RecordingLogSink {
+    std::mutex mutex{};
+    std::condition_variable cond{};
+    bool paused{false};
+    std::vector<std::string> messages{};
+    std::vector<std::thread::id> threads{};
+
+    static void sinkLog(void *handle, celix_log_level_e, long, const char*, const char*, const char*, int, const char *format, va_list formatArgs) {
+        auto* self = static_cast<RecordingLogSink*>(handle);
+        char buf[256];
+        vsnprintf(buf, sizeof(buf), format, formatArgs);
+        std::unique_lock<std::mutex> lck{self->mutex};
+        self->cond.wait(lck, [self]{ return !self->paused; });
+        self->messages.emplace_back(buf);
+        self->threads.emplace_back(std::this_thread::get_id());
+    }
+
+    void setPaused(bool p) {
+        std::lock_guard<std::mutex> lck{mutex};
+        paused = p;
+        cond.notify_all();
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lck{mutex};
+        return messages.size();
+    }
+};
+
+static long registerRecordingSink(celix_bundle_context_t* ctx, RecordingLogSink* recorder, celix_log_sink_t* sink) {
+    sink->handle = recorder;
+    sink->sinkLog = RecordingLogSink::sinkLog;
+    auto *svcProps = celix_properties_create();
+    celix_properties_set(svcProps, "name", "test::RecordingSink");
+    celix_service_registration_options_t opts{};
+    opts.serviceName = CELIX_LOG_SINK_NAME;
+    opts.serviceVersion = CELIX_LOG_SINK_VERSION;
+    opts.properties = svcProps;
+    opts.svc = sink;
+    return celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+}
+
+static long trackLogService(celix_bundle_context_t* ctx, celix_framework_t* fw, std::atomic<celix_log_service_t*>* logSvc) {
+    celix_service_tracking_options_t opts{};
+    opts.filter.serviceName = CELIX_LOG_SERVICE_NAME;
+    opts.filter.filter = "(name=test::Log1)";
+    opts.callbackHandle = (void*)logSvc;
+    opts.set = [](void *handle, void *svc) {
+        auto* p = static_cast<std::atomic<celix_log_service_t*>*>(handle);
+        p->store((celix_log_service_t*)svc);
+    };
+    long trkId = celix_bundleContext_trackServicesWithOptions(ctx, &opts);
+    celix_framework_waitForEmptyEventQueue(fw);
+    return trkId;
+}
+
+TEST_F(LogBundleAsyncTestSuite, LogAsyncAndFlush) {
+    ASSERT_TRUE(control);
+    RecordingLogSink recorder{};
+    celix_log_sink_t sink{};
+    long svcId = registerRecordingSink(ctx.get(), &recorder, &sink);
+    std::atomic<celix_log_service_t*> logSvc{nullptr};
+    long trkId = trackLogService(ctx.get(), fw.get(), &logSvc);
+    auto* ls = logSvc.load();
+    ASSERT_TRUE(ls != nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        ls->info(ls->handle, "test %i", i);
+    }
+    ls->debug(ls->handle, "not an active log level");
+    control->flush(control->handle);
+
+    ASSERT_EQ(3, recorder.size());
+    EXPECT_EQ("test 0", recorder.messages[0]);
+    EXPECT_EQ("test 2", recorder.messages[2]);
+    EXPECT_NE(std::this_thread::get_id(), recorder.threads[0]); //forwarded on the log admin thread
+    EXPECT_EQ(0, control->nrOfDroppedLogMessages(control->handle));
+
+    celix_bundleContext_stopTracker(ctx.get(), trkId);
+    celix_bundleContext_unregisterService(ctx.get(), svcId);
+}
+
+TEST_F(LogBundleAsyncTestSuite, DropWhenBufferIsFull) {
+    ASSERT_TRUE(control);
+    RecordingLogSink recorder{};
+    celix_log_sink_t sink{};
+    long svcId = registerRecordingSink(ctx.get(), &recorder, &sink);
+    std::atomic<celix_log_service_t*> logSvc{nullptr};
+    long trkId = trackLogService(ctx.get(), fw.get(), &logSvc);
+    auto* ls = logSvc.load();
+    ASSERT_TRUE(ls != nullptr);
+
+    recorder.setPaused(true);
+    const int nrOfMessages = 20;
+    for (int i = 0; i < nrOfMessages; ++i) {
+        ls->info(ls->handle, "test %i", i);
+    }
+    auto dropped = control->nrOfDroppedLogMessages(control->handle);
+    EXPECT_GT(dropped, 0);
+    recorder.setPaused(false);
+    control->flush(control->handle);
+    EXPECT_EQ(nrOfMessages, recorder.size() + dropped);
+
+    celix_bundleContext_stopTracker(ctx.get(), trkId);
+    celix_bundleContext_unregisterService(ctx.get(), svcId);
+}
+
+TEST_F(LogBundleAsyncBlockTestSuite, BlockWhenBufferIsFull) {
+    ASSERT_TRUE(control);
+    RecordingLogSink recorder{};
+    celix_log_sink_t sink{};
+    long svcId = registerRecordingSink(ctx.get(), &recorder, &sink);
+    std::atomic<celix_log_service_t*> logSvc{nullptr};
+    long trkId = trackLogService(ctx.get(), fw.get(), &logSvc);
+    auto* ls = logSvc.load();
+    ASSERT_TRUE(ls != nullptr);
+
+    recorder.setPaused(true);
+    const int nrOfMessages = 20;
+    std::thread logThread{[ls]{
+        for (int i = 0; i < nrOfMessages; ++i) {
+            ls->info(ls->handle, "test %i", i);
+        }
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    recorder.setPaused(false);
+    logThread.join();
+    control->flush(control->handle);
+
+    EXPECT_EQ(nrOfMessages, recorder.size());
+    EXPECT_EQ("test 19", recorder.messages[nrOfMessages - 1]);
+    EXPECT_EQ(0, control->nrOfDroppedLogMessages(control->handle));
+
+    celix_bundleContext_stopTracker(ctx.get(), trkId);
+    celix_bundleContext_unregisterService(ctx.get(), svcId);
+}
+
+TEST_F(LogBundleAsyncBlockTestSuite, FlushOnStop) {
+    RecordingLogSink recorder{};
+    celix_log_sink_t sink{};
+    long svcId = registerRecordingSink(ctx.get(), &recorder, &sink);
+    std::atomic<celix_log_service_t*> logSvc{nullptr};
+    long trkId = trackLogService(ctx.get(), fw.get(), &logSvc);
+    auto* ls = logSvc.load();
+    ASSERT_TRUE(ls != nullptr);
+
+    for (int i = 0; i < 10; ++i) {
+        ls->info(ls->handle, "test %i", i);
+    }
+    celix_bundleContext_stopBundle(ctx.get(), bndId);
+    EXPECT_EQ(10, recorder.size());
+
+    celix_bundleContext_stopTracker(ctx.get(), trkId);
+    celix_bundleContext_unregisterService(ctx.get(), svcId);
+}
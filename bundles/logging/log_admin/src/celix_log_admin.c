@@ -21,7 +21,9 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <string.h>
+#include <strings.h>
 
 #include <celix_constants.h>
 #include <celix_log_control.h>
@@ -40,6 +42,33 @@
 #define CELIX_LOG_ADMIN_DEFAULT_LOG_NAME "default"
 #define CELIX_LOG_ADMIN_FRAMEWORK_LOG_NAME "celix_framework"
 
+#define CELIX_LOG_ADMIN_ASYNC_MIN_MESSAGE_SIZE 128
+#define CELIX_LOG_ADMIN_ASYNC_WRITER_IDLE_TIMEOUT_NS (100 * 1000 * 1000)
+#define CELIX_LOG_ADMIN_ASYNC_WAIT_FOR_PROGRESS_TIMEOUT_NS (10 * 1000 * 1000)
+
+typedef enum celix_log_admin_overflow_policy {
+    CELIX_LOG_ADMIN_OVERFLOW_POLICY_DROP,
+    CELIX_LOG_ADMIN_OVERFLOW_POLICY_BLOCK,
+    CELIX_LOG_ADMIN_OVERFLOW_POLICY_SYNC
+} celix_log_admin_overflow_policy_e;
+
+/**
+ * A slot in the async log ring buffer.
+ * The ring buffer is a bounded multi-producer/single-consumer queue where every slot has a sequence number:
+ * a slot at position pos is free for producers if sequence == pos and ready for the writer thread if
+ * sequence == pos + 1. The strings point into the (pre-allocated) message buffer of the slot.
+ */
+typedef struct celix_log_admin_async_slot {
+    size_t sequence; //atomic
+    celix_log_level_e level;
+    long logSvcId;
+    int line;
+    const char* name;
+    const char* file;
+    const char* function;
+    const char* message;
+} celix_log_admin_async_slot_t;
+
 struct celix_log_admin {
     celix_bundle_context_t* ctx;
     long logWriterTrackerId;
@@ -58,6 +87,28 @@ struct celix_log_admin {
     celix_thread_rwlock_t lock; //protects below
     hash_map_t *loggers; //key = name, value = celix_log_service_instance_t
     hash_map_t* sinks; //key = name, value = celix_log_sink_t
+
+    struct {
+        bool enabled; //note immutable after create
+        celix_log_admin_overflow_policy_e policy;
+        size_t capacity; //power of 2
+        size_t maxMessageSize;
+        celix_log_admin_async_slot_t* slots;
+        char* messageBuffer; //capacity * maxMessageSize bytes
+
+        size_t enqueuePos; //atomic, next position claimed by a producer
+        size_t dequeuePos; //atomic, next position forwarded by the writer thread (only updated by the writer thread)
+        size_t droppedCount; //atomic
+        bool running; //atomic
+        bool writerSleeping; //atomic
+        size_t nrOfWaiters; //atomic, nr of threads waiting on progressCond
+        size_t nrOfProducers; //atomic, nr of threads in the async log path
+
+        celix_thread_t writerThread;
+        celix_thread_mutex_t mutex; //used for writerCond and progressCond
+        celix_thread_cond_t writerCond;
+        celix_thread_cond_t progressCond;
+    } async;
 };
 
 typedef struct celix_log_service_entry {
@@ -67,7 +118,7 @@ typedef struct celix_log_service_entry {
     long logSvcId;
     celix_log_service_t logSvc;
 
-    //mutable and protected by admin->lock
+    //mutable and protected by admin->lock, note also updated atomically for the (lock free) async log path
     celix_log_level_e activeLogLevel;
 } celix_log_service_entry_t;
 
@@ -80,6 +131,153 @@ typedef struct celix_log_sink_entry {
     bool enabled;
 } celix_log_sink_entry_t;
 
+/**
+ * Forwards a log message to the enabled log sinks (or stdout). Should be called with admin->lock (read) locked.
+ */
+static void celix_logAdmin_forwardToSinks(celix_log_admin_t* admin, celix_log_level_e level, long logSvcId, const char* logSvcName, const char* file, const char* function, int line, const char *format, va_list formatArgs) {
+    int nrOfLogWriters = hashMap_size(admin->sinks);
+    hash_map_iterator_t iter = hashMapIterator_construct(admin->sinks);
+    while (hashMapIterator_hasNext(&iter)) {
+        celix_log_sink_entry_t *sinkEntry = hashMapIterator_nextValue(&iter);
+        if (sinkEntry->enabled) {
+            celix_log_sink_t *sink = sinkEntry->sink;
+            va_list argCopy;
+            va_copy(argCopy, formatArgs);
+            sink->sinkLog(sink->handle, level, logSvcId, logSvcName, file, function, line, format, argCopy);
+            va_end(argCopy);
+        }
+    }
+
+    if (admin->alwaysLogToStdOut || (nrOfLogWriters == 0 && admin->fallbackToStdOut)) {
+        celix_logUtils_vLogToStdoutDetails(logSvcName, level, file, function, line, format, formatArgs);
+    }
+}
+
+static void celix_logAdmin_forwardFormattedToSinks(celix_log_admin_t* admin, celix_log_level_e level, long logSvcId, const char* logSvcName, const char* file, const char* function, int line, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    celix_logAdmin_forwardToSinks(admin, level, logSvcId, logSvcName, file, function, line, format, args);
+    va_end(args);
+}
+
+static const char* celix_logAdmin_copyToSlotBuffer(char* buf, size_t bufSize, size_t* offset, const char* str) {
+    if (str == NULL || *offset + 1 >= bufSize) {
+        return NULL;
+    }
+    size_t len = strnlen(str, bufSize - *offset - 1);
+    char* dst = buf + *offset;
+    memcpy(dst, str, len);
+    dst[len] = '\0';
+    *offset += len + 1;
+    return dst;
+}
+
+static bool celix_logAdmin_isOnWriterThread(celix_log_admin_t* admin) {
+    return celixThread_equals(celixThread_self(), admin->async.writerThread);
+}
+
+/**
+ * Tries to claim a slot in the async ring buffer and formats the log message into the slot.
+ * Returns false if the ring buffer is full.
+ */
+static bool celix_logAdmin_tryEnqueue(celix_log_service_entry_t* entry, celix_log_level_e level, const char* file, const char* function, int line, const char *format, va_list formatArgs) {
+    celix_log_admin_t* admin = entry->admin;
+    size_t pos = __atomic_load_n(&admin->async.enqueuePos, __ATOMIC_RELAXED);
+    celix_log_admin_async_slot_t* slot;
+    for (;;) {
+        slot = &admin->async.slots[pos & (admin->async.capacity - 1)];
+        size_t seq = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&admin->async.enqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; //full
+        } else {
+            pos = __atomic_load_n(&admin->async.enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    char* buf = admin->async.messageBuffer + (pos & (admin->async.capacity - 1)) * admin->async.maxMessageSize;
+    size_t offset = 0;
+    slot->level = level;
+    slot->logSvcId = entry->logSvcId;
+    slot->line = line;
+    slot->name = celix_logAdmin_copyToSlotBuffer(buf, admin->async.maxMessageSize, &offset, entry->name);
+    slot->file = celix_logAdmin_copyToSlotBuffer(buf, admin->async.maxMessageSize, &offset, file);
+    slot->function = celix_logAdmin_copyToSlotBuffer(buf, admin->async.maxMessageSize, &offset, function);
+    if (offset < admin->async.maxMessageSize) {
+        va_list argCopy;
+        va_copy(argCopy, formatArgs);
+        vsnprintf(buf + offset, admin->async.maxMessageSize - offset, format, argCopy); //note truncates too long messages
+        va_end(argCopy);
+        slot->message = buf + offset;
+    } else {
+        slot->message = "";
+    }
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    //wake up the writer thread if it is (going to) sleep
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&admin->async.writerSleeping, __ATOMIC_RELAXED)) {
+        celixThreadMutex_lock(&admin->async.mutex);
+        celixThreadCondition_broadcast(&admin->async.writerCond);
+        celixThreadMutex_unlock(&admin->async.mutex);
+    }
+    return true;
+}
+
+static void celix_logAdmin_waitForProgress(celix_log_admin_t* admin) {
+    celixThreadMutex_lock(&admin->async.mutex);
+    __atomic_add_fetch(&admin->async.nrOfWaiters, 1, __ATOMIC_SEQ_CST);
+    celixThreadCondition_broadcast(&admin->async.writerCond);
+    celixThreadCondition_timedwaitRelative(&admin->async.progressCond, &admin->async.mutex, 0, CELIX_LOG_ADMIN_ASYNC_WAIT_FOR_PROGRESS_TIMEOUT_NS);
+    __atomic_sub_fetch(&admin->async.nrOfWaiters, 1, __ATOMIC_SEQ_CST);
+    celixThreadMutex_unlock(&admin->async.mutex);
+}
+
+static void celix_logAdmin_enqueue(celix_log_service_entry_t* entry, celix_log_level_e level, const char* file, const char* function, int line, const char *format, va_list formatArgs) {
+    celix_log_admin_t* admin = entry->admin;
+    while (!celix_logAdmin_tryEnqueue(entry, level, file, function, line, format, formatArgs)) {
+        bool onWriterThread = celix_logAdmin_isOnWriterThread(admin);
+        if (admin->async.policy == CELIX_LOG_ADMIN_OVERFLOW_POLICY_SYNC ||
+            (!onWriterThread && !__atomic_load_n(&admin->async.running, __ATOMIC_ACQUIRE)) /*note writer thread is stopping*/) {
+            celixThreadRwlock_readLock(&admin->lock);
+            celix_logAdmin_forwardToSinks(admin, level, entry->logSvcId, entry->name, file, function, line, format, formatArgs);
+            celixThreadRwlock_unlock(&admin->lock);
+            return;
+        } else if (admin->async.policy == CELIX_LOG_ADMIN_OVERFLOW_POLICY_DROP ||
+                   onWriterThread /*note a sink logging on the writer thread cannot wait for itself*/) {
+            __atomic_add_fetch(&admin->async.droppedCount, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        celix_logAdmin_waitForProgress(admin);
+    }
+}
+
+static void celix_logAdmin_leaveAsyncLog(celix_log_admin_t* admin) {
+    if (__atomic_sub_fetch(&admin->async.nrOfProducers, 1, __ATOMIC_SEQ_CST) == 0 && !__atomic_load_n(&admin->async.running, __ATOMIC_SEQ_CST)) {
+        celixThreadMutex_lock(&admin->async.mutex);
+        celixThreadCondition_broadcast(&admin->async.progressCond);
+        celixThreadMutex_unlock(&admin->async.mutex);
+    }
+}
+
+/**
+ * Registers the calling thread as async log producer. Returns false - and does not register - if the writer thread
+ * is stopping; the log message should then be forwarded synchronously.
+ * Registered producers are waited on when the writer thread is stopped, so that their messages are not lost.
+ */
+static bool celix_logAdmin_enterAsyncLog(celix_log_admin_t* admin) {
+    __atomic_add_fetch(&admin->async.nrOfProducers, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&admin->async.running, __ATOMIC_SEQ_CST)) {
+        return true;
+    }
+    celix_logAdmin_leaveAsyncLog(admin);
+    return false;
+}
+
 static void celix_logAdmin_vlogDetails(void *handle, celix_log_level_e level, const char* file, const char* function, int line, const char *format, va_list formatArgs) {
     celix_log_service_entry_t* entry = handle;
 
@@ -88,26 +286,157 @@ static void celix_logAdmin_vlogDetails(void *handle, celix_log_level_e level, co
         return;
     }
 
+    if (entry->admin->async.enabled && celix_logAdmin_enterAsyncLog(entry->admin)) {
+        //note async logging does not lock the admin, the active log level is updated atomically
+        if (level >= __atomic_load_n(&entry->activeLogLevel, __ATOMIC_RELAXED)) {
+            celix_logAdmin_enqueue(entry, level, file, function, line, format, formatArgs);
+        }
+        celix_logAdmin_leaveAsyncLog(entry->admin);
+        return;
+    }
+
     celixThreadRwlock_readLock(&entry->admin->lock);
     if (level >= entry->activeLogLevel) {
-        int nrOfLogWriters = hashMap_size(entry->admin->sinks);
-        hash_map_iterator_t iter = hashMapIterator_construct(entry->admin->sinks);
-        while (hashMapIterator_hasNext(&iter)) {
-            celix_log_sink_entry_t *sinkEntry = hashMapIterator_nextValue(&iter);
-            if (sinkEntry->enabled) {
-                celix_log_sink_t *sink = sinkEntry->sink;
-                va_list argCopy;
-                va_copy(argCopy, formatArgs);
-                sink->sinkLog(sink->handle, level, entry->logSvcId, entry->name, file, function, line, format, argCopy);
-                va_end(argCopy);
+        celix_logAdmin_forwardToSinks(entry->admin, level, entry->logSvcId, entry->name, file, function, line, format, formatArgs);
+    }
+    celixThreadRwlock_unlock(&entry->admin->lock);
+}
+
+/**
+ * Forwards the ready log messages in the async ring buffer to the log sinks.
+ * Only called by the writer thread or, after the writer thread is joined, by the stopping thread.
+ * Returns the number of forwarded log messages.
+ */
+static size_t celix_logAdmin_forwardQueuedMessages(celix_log_admin_t* admin) {
+    size_t count = 0;
+    size_t pos = __atomic_load_n(&admin->async.dequeuePos, __ATOMIC_RELAXED);
+    celix_log_admin_async_slot_t* slot = &admin->async.slots[pos & (admin->async.capacity - 1)];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != pos + 1) {
+        return 0;
+    }
+
+    celixThreadRwlock_readLock(&admin->lock);
+    while (count < admin->async.capacity && __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) == pos + 1) {
+        celix_logAdmin_forwardFormattedToSinks(admin, slot->level, slot->logSvcId, slot->name, slot->file, slot->function, slot->line, "%s", slot->message);
+        __atomic_store_n(&slot->sequence, pos + admin->async.capacity, __ATOMIC_RELEASE);
+        pos += 1;
+        __atomic_store_n(&admin->async.dequeuePos, pos, __ATOMIC_RELEASE);
+        count += 1;
+        slot = &admin->async.slots[pos & (admin->async.capacity - 1)];
+    }
+    celixThreadRwlock_unlock(&admin->lock);
+    return count;
+}
+
+static bool celix_logAdmin_hasQueuedMessages(celix_log_admin_t* admin) {
+    size_t pos = __atomic_load_n(&admin->async.dequeuePos, __ATOMIC_RELAXED);
+    celix_log_admin_async_slot_t* slot = &admin->async.slots[pos & (admin->async.capacity - 1)];
+    return __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) == pos + 1;
+}
+
+static void* celix_logAdmin_asyncWriterThread(void* data) {
+    celix_log_admin_t* admin = data;
+    for (;;) {
+        bool running = __atomic_load_n(&admin->async.running, __ATOMIC_ACQUIRE);
+        size_t count = celix_logAdmin_forwardQueuedMessages(admin);
+        if (count > 0) {
+            if (__atomic_load_n(&admin->async.nrOfWaiters, __ATOMIC_SEQ_CST) > 0) {
+                celixThreadMutex_lock(&admin->async.mutex);
+                celixThreadCondition_broadcast(&admin->async.progressCond);
+                celixThreadMutex_unlock(&admin->async.mutex);
             }
+        } else if (!running) {
+            //note all log messages enqueued before stopping are forwarded
+            break;
+        } else {
+            celixThreadMutex_lock(&admin->async.mutex);
+            __atomic_store_n(&admin->async.writerSleeping, true, __ATOMIC_SEQ_CST);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (!celix_logAdmin_hasQueuedMessages(admin) && __atomic_load_n(&admin->async.running, __ATOMIC_ACQUIRE)) {
+                celixThreadCondition_timedwaitRelative(&admin->async.writerCond, &admin->async.mutex, 0, CELIX_LOG_ADMIN_ASYNC_WRITER_IDLE_TIMEOUT_NS);
+            }
+            __atomic_store_n(&admin->async.writerSleeping, false, __ATOMIC_RELAXED);
+            celixThreadMutex_unlock(&admin->async.mutex);
         }
+    }
+    return NULL;
+}
 
-        if (entry->admin->alwaysLogToStdOut || (nrOfLogWriters == 0 && entry->admin->fallbackToStdOut)) {
-            celix_logUtils_vLogToStdoutDetails(entry->name, level, file, function, line, format, formatArgs);
-        }
+void celix_logAdmin_flush(celix_log_admin_t* admin) {
+    if (!admin->async.enabled || celix_logAdmin_isOnWriterThread(admin)) {
+        return;
     }
-    celixThreadRwlock_unlock(&entry->admin->lock);
+    size_t target = __atomic_load_n(&admin->async.enqueuePos, __ATOMIC_ACQUIRE);
+    while (__atomic_load_n(&admin->async.dequeuePos, __ATOMIC_ACQUIRE) < target && __atomic_load_n(&admin->async.running, __ATOMIC_ACQUIRE)) {
+        celix_logAdmin_waitForProgress(admin);
+    }
+}
+
+static celix_log_admin_overflow_policy_e celix_logAdmin_overflowPolicyFromString(const char* str) {
+    if (strcasecmp(str, "block") == 0) {
+        return CELIX_LOG_ADMIN_OVERFLOW_POLICY_BLOCK;
+    } else if (strcasecmp(str, "sync") == 0) {
+        return CELIX_LOG_ADMIN_OVERFLOW_POLICY_SYNC;
+    } else if (strcasecmp(str, "drop") != 0) {
+        celix_logUtils_logToStdout(CELIX_LOG_ADMIN_DEFAULT_LOG_NAME, CELIX_LOG_LEVEL_WARNING, "Unknown async log overflow policy '%s', using 'drop'.", str);
+    }
+    return CELIX_LOG_ADMIN_OVERFLOW_POLICY_DROP;
+}
+
+static void celix_logAdmin_startAsyncWriter(celix_log_admin_t* admin) {
+    long bufferSize = celix_bundleContext_getPropertyAsLong(admin->ctx, CELIX_LOG_ADMIN_ASYNC_BUFFER_SIZE_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_BUFFER_SIZE_DEFAULT_VALUE);
+    long maxMessageSize = celix_bundleContext_getPropertyAsLong(admin->ctx, CELIX_LOG_ADMIN_ASYNC_MAX_MESSAGE_SIZE_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_MAX_MESSAGE_SIZE_DEFAULT_VALUE);
+    const char* policy = celix_bundleContext_getProperty(admin->ctx, CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY_DEFAULT_VALUE);
+
+    size_t capacity = 2;
+    while (bufferSize > 0 && capacity < (size_t)bufferSize) {
+        capacity *= 2; //note round up to a power of 2, so that a position can be masked to a slot index
+    }
+    admin->async.capacity = capacity;
+    admin->async.maxMessageSize = maxMessageSize < CELIX_LOG_ADMIN_ASYNC_MIN_MESSAGE_SIZE ? CELIX_LOG_ADMIN_ASYNC_MIN_MESSAGE_SIZE : (size_t)maxMessageSize;
+    admin->async.policy = celix_logAdmin_overflowPolicyFromString(policy);
+    admin->async.slots = calloc(capacity, sizeof(*admin->async.slots));
+    admin->async.messageBuffer = malloc(capacity * admin->async.maxMessageSize);
+    for (size_t i = 0; i < capacity; ++i) {
+        admin->async.slots[i].sequence = i;
+    }
+
+    celixThreadMutex_create(&admin->async.mutex, NULL);
+    celixThreadCondition_init(&admin->async.writerCond, NULL);
+    celixThreadCondition_init(&admin->async.progressCond, NULL);
+    __atomic_store_n(&admin->async.running, true, __ATOMIC_RELEASE);
+    admin->async.enabled = true;
+    celixThread_create(&admin->async.writerThread, NULL, celix_logAdmin_asyncWriterThread, admin);
+    celixThread_setName(&admin->async.writerThread, "CelixLogAdmin");
+}
+
+static void celix_logAdmin_stopAsyncWriter(celix_log_admin_t* admin) {
+    celix_logAdmin_flush(admin);
+    celixThreadMutex_lock(&admin->async.mutex);
+    __atomic_store_n(&admin->async.running, false, __ATOMIC_SEQ_CST);
+    celixThreadCondition_broadcast(&admin->async.writerCond);
+    celixThreadCondition_broadcast(&admin->async.progressCond);
+    celixThreadMutex_unlock(&admin->async.mutex);
+    celixThread_join(admin->async.writerThread, NULL);
+
+    //note producers which entered the async log path before running was cleared, can still be enqueueing.
+    //wait for them and forward their log messages on this thread.
+    celixThreadMutex_lock(&admin->async.mutex);
+    while (__atomic_load_n(&admin->async.nrOfProducers, __ATOMIC_SEQ_CST) > 0) {
+        celixThreadCondition_timedwaitRelative(&admin->async.progressCond, &admin->async.mutex, 0, CELIX_LOG_ADMIN_ASYNC_WAIT_FOR_PROGRESS_TIMEOUT_NS);
+    }
+    celixThreadMutex_unlock(&admin->async.mutex);
+    while (celix_logAdmin_forwardQueuedMessages(admin) > 0) {
+        //nop
+    }
+}
+
+static void celix_logAdmin_destroyAsyncWriter(celix_log_admin_t* admin) {
+    celixThreadCondition_destroy(&admin->async.progressCond);
+    celixThreadCondition_destroy(&admin->async.writerCond);
+    celixThreadMutex_destroy(&admin->async.mutex);
+    free(admin->async.messageBuffer);
+    free(admin->async.slots);
 }
 
 static void celix_logAdmin_vlog(void *handle, celix_log_level_e level, const char *format, va_list formatArgs) {
@@ -379,13 +708,13 @@ static size_t celix_logAdmin_setActiveLogLevels(void *handle, const char* select
     while (hashMapIterator_hasNext(&iter)) {
         celix_log_service_entry_t* visit = hashMapIterator_nextValue(&iter);
         if (select == NULL) {
-            visit->activeLogLevel = activeLogLevel;
+            __atomic_store_n(&visit->activeLogLevel, activeLogLevel, __ATOMIC_RELAXED);
             count += 1;
         } else {
             char *match = strcasestr(visit->name, select);
             if (match != NULL && match == visit->name) {
                 //note if select is found in visit->name and visit->name start with select
-                visit->activeLogLevel = activeLogLevel;
+                __atomic_store_n(&visit->activeLogLevel, activeLogLevel, __ATOMIC_RELAXED);
                 count += 1;
             }
         }
@@ -466,6 +795,16 @@ static bool celix_logAdmin_sinkInfo(void *handle, const char* sinkName, bool* ou
     return found != NULL;
 }
 
+static size_t celix_logAdmin_nrOfDroppedLogMessages(void *handle) {
+    celix_log_admin_t* admin = handle;
+    return __atomic_load_n(&admin->async.droppedCount, __ATOMIC_RELAXED);
+}
+
+static void celix_logAdmin_flushControl(void *handle) {
+    celix_log_admin_t* admin = handle;
+    celix_logAdmin_flush(admin);
+}
+
 static void celix_logAdmin_setLogLevelCmd(celix_log_admin_t* admin, const char* select, const char* level, FILE* outStream, FILE* errorStream) {
     bool converted;
     celix_log_level_e logLevel = celix_logUtils_logLevelFromStringWithCheck(level, CELIX_LOG_LEVEL_TRACE, &converted);
@@ -528,6 +867,11 @@ static void celix_logAdmin_InfoCmd(celix_log_admin_t* admin, FILE* outStream, FI
         fprintf(outStream, "Log Admin has found 0 log sinks\n");
     }
     celix_arrayList_destroy(sinks);
+
+    if (admin->async.enabled) {
+        fprintf(outStream, "Log Admin async logging enabled, buffer size %lu, %lu dropped log messages\n",
+                (long unsigned int) admin->async.capacity, (long unsigned int) celix_logAdmin_nrOfDroppedLogMessages(admin));
+    }
 }
 
 static bool celix_logAdmin_executeCommand(void *handle, const char *commandLine, FILE *outStream, FILE *errorStream) {
@@ -587,6 +931,10 @@ celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
 
     celixThreadRwlock_create(&admin->lock, NULL);
 
+    if (celix_bundleContext_getPropertyAsBool(ctx, CELIX_LOG_ADMIN_ASYNC_CONFIG_NAME, CELIX_LOG_ADMIN_ASYNC_DEFAULT_VALUE)) {
+        celix_logAdmin_startAsyncWriter(admin);
+    }
+
     {
         celix_service_tracking_options_t opts = CELIX_EMPTY_SERVICE_TRACKING_OPTIONS;
         opts.filter.serviceName = CELIX_LOG_SINK_NAME;
@@ -609,6 +957,8 @@ celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
         admin->controlSvc.sinkInfo = celix_logAdmin_sinkInfo;
         admin->controlSvc.setActiveLogLevels = celix_logAdmin_setActiveLogLevels;
         admin->controlSvc.setSinkEnabled = celix_logAdmin_setSinkEnabled;
+        admin->controlSvc.nrOfDroppedLogMessages = celix_logAdmin_nrOfDroppedLogMessages;
+        admin->controlSvc.flush = celix_logAdmin_flushControl;
 
 
         celix_service_registration_options_t opts = CELIX_EMPTY_SERVICE_REGISTRATION_OPTIONS;
@@ -642,6 +992,10 @@ celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t *ctx) {
 
 void celix_logAdmin_destroy(celix_log_admin_t *admin) {
     if (admin != NULL) {
+        if (admin->async.enabled) {
+            //note flush and stop the writer thread while the log sinks are still available, after this log calls are synchronous
+            celix_logAdmin_stopAsyncWriter(admin);
+        }
         celix_logAdmin_remLogSvcForName(admin, CELIX_LOG_ADMIN_FRAMEWORK_LOG_NAME);
 
         celix_bundleContext_unregisterServiceAsync(admin->ctx, admin->cmdSvcId, NULL, NULL);
@@ -656,6 +1010,9 @@ void celix_logAdmin_destroy(celix_log_admin_t *admin) {
         assert(hashMap_size(admin->sinks) == 0); //note stopping service tracker should triggered all needed remove events
         hashMap_destroy(admin->sinks, false, false);
 
+        if (admin->async.enabled) {
+            celix_logAdmin_destroyAsyncWriter(admin);
+        }
         celixThreadRwlock_destroy(&admin->lock);
         free(admin);
     }
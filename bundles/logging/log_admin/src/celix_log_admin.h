@@ -36,6 +36,18 @@ extern "C" {
 #define CELIX_LOG_ADMIN_LOG_SINKS_DEFAULT_ENABLED_CONFIG_NAME               "CELIX_LOG_ADMIN_LOG_SINKS_DEFAULT_ENABLED"
 #define CELIX_LOG_ADMIN_SINKS_DEFAULT_ENABLED_DEFAULT_VALUE                 true
 
+#define CELIX_LOG_ADMIN_ASYNC_CONFIG_NAME                                   "CELIX_LOG_ADMIN_ASYNC"
+#define CELIX_LOG_ADMIN_ASYNC_DEFAULT_VALUE                                 false
+
+#define CELIX_LOG_ADMIN_ASYNC_BUFFER_SIZE_CONFIG_NAME                       "CELIX_LOG_ADMIN_ASYNC_BUFFER_SIZE"
+#define CELIX_LOG_ADMIN_ASYNC_BUFFER_SIZE_DEFAULT_VALUE                     1024
+
+#define CELIX_LOG_ADMIN_ASYNC_MAX_MESSAGE_SIZE_CONFIG_NAME                  "CELIX_LOG_ADMIN_ASYNC_MAX_MESSAGE_SIZE"
+#define CELIX_LOG_ADMIN_ASYNC_MAX_MESSAGE_SIZE_DEFAULT_VALUE                512
+
+#define CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY_CONFIG_NAME                   "CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY"
+#define CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY_DEFAULT_VALUE                 "drop"
+
 /**
  * Celix log service admin will monitoring celix log service and create celix log services on
  * demand. For every unique requested celix log service name, a new log service istance will be
@@ -56,6 +68,12 @@ extern "C" {
  *
  * When requesting this service a name can be used in the service filter. If the name is present,
  * a logging instance for that name will be created.
+ *
+ * If CELIX_LOG_ADMIN_ASYNC config/env is set to true (default false), log calls only format the log
+ * message into a pre-allocated ring buffer and a single log admin thread forwards the messages to the
+ * log sinks. CELIX_LOG_ADMIN_ASYNC_OVERFLOW_POLICY configures what happens when the ring buffer is full:
+ * "drop" (drop the message and count it), "block" (wait until there is room) or "sync" (forward the
+ * message on the calling thread).
  */
 typedef struct celix_log_admin celix_log_admin_t; //opaque
 
@@ -64,8 +82,15 @@ typedef struct celix_log_admin celix_log_admin_t; //opaque
  */
 celix_log_admin_t* celix_logAdmin_create(celix_bundle_context_t* ctx);
 
+/**
+ * Blocks until all log messages logged before this call are forwarded to the log sinks.
+ * Does nothing if the log admin is not configured for async logging.
+ */
+void celix_logAdmin_flush(celix_log_admin_t* admin);
+
 /**
  * Destroys a log service admin.
+ * Pending async log messages are flushed before the log sinks are released.
  */
 void celix_logAdmin_destroy(celix_log_admin_t* admin);
 
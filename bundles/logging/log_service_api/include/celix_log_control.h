@@ -28,7 +28,7 @@ extern "C" {
 #endif
 
 #define CELIX_LOG_CONTROL_NAME      "celix_log_control"
-#define CELIX_LOG_CONTROL_VERSION   "1.0.0"
+#define CELIX_LOG_CONTROL_VERSION   "1.1.0"
 #define CELIX_LOG_CONTROL_USE_RANGE "[1.0.0,2)"
 
 typedef struct celix_log_control {
@@ -50,6 +50,20 @@ typedef struct celix_log_control {
 
     bool (*sinkInfo)(void *handle, const char* sinkName, bool *outEnabled);
 
+    /**
+     * @brief Returns the number of log messages dropped because the async log buffer was full.
+     * Always 0 if the log admin is not configured for async logging.
+     * @since 1.1.0
+     */
+    size_t (*nrOfDroppedLogMessages)(void *handle);
+
+    /**
+     * @brief Blocks until all log messages logged before this call are forwarded to the log sinks.
+     * Returns immediately if the log admin is not configured for async logging.
+     * @since 1.1.0
+     */
+    void (*flush)(void *handle);
+
 } celix_log_control_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,331 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "celix_framework_factory.h"
+#include "celix_bundle_context.h"
+#include "celix_log_helper.h"
+#include "pubsub_wire_v2_protocol_impl.h"
+
+extern "C" {
+#include "pubsub_tcp_handler.h"
+}
+
+/**
+ * Tests the asynchronous send mode of the tcp handler, using a second tcp handler as receiver.
+ * The receiver can be blocked in its message callback, so that the socket of the receiver is not read anymore and
+ * the write queue of the sender fills up.
+ */
+class PubSubTcpHandlerTestSuite : public ::testing::Test {
+public:
+    static constexpr size_t PAYLOAD_SIZE = 64 * 1024;
+    static constexpr uint32_t MAX_NR_OF_MESSAGES = 2000; //> kernel socket buffers
+
+    PubSubTcpHandlerTestSuite() {
+        auto* props = celix_properties_create();
+        celix_properties_set(props, "LOGHELPER_ENABLE_STDOUT_FALLBACK", "true");
+        celix_properties_set(props, "org.osgi.framework.storage", ".cacheTcpHandlerTestSuite");
+        fw = std::shared_ptr<celix_framework_t>{celix_frameworkFactory_createFramework(props), [](celix_framework_t* f) {
+            celix_frameworkFactory_destroyFramework(f);
+        }};
+        auto* ctx = celix_framework_getFrameworkContext(fw.get());
+        logHelper = std::shared_ptr<celix_log_helper_t>{celix_logHelper_create(ctx, "PubSubTcpHandlerTestSuite"), celix_logHelper_destroy};
+
+        pubsubProtocol_wire_v2_create(&wireProtocol);
+        protocol.handle = wireProtocol;
+        protocol.getHeaderSize = pubsubProtocol_wire_v2_getHeaderSize;
+        protocol.getHeaderBufferSize = pubsubProtocol_wire_v2_getHeaderBufferSize;
+        protocol.getSyncHeaderSize = pubsubProtocol_wire_v2_getSyncHeaderSize;
+        protocol.getSyncHeader = pubsubProtocol_wire_v2_getSyncHeader;
+        protocol.getFooterSize = pubsubProtocol_wire_v2_getFooterSize;
+        protocol.isMessageSegmentationSupported = pubsubProtocol_wire_v2_isMessageSegmentationSupported;
+        protocol.encodeHeader = pubsubProtocol_wire_v2_encodeHeader;
+        protocol.encodePayload = pubsubProtocol_wire_v2_encodePayload;
+        protocol.encodeMetadata = pubsubProtocol_wire_v2_encodeMetadata;
+        protocol.encodeFooter = pubsubProtocol_wire_v2_encodeFooter;
+        protocol.decodeHeader = pubsubProtocol_wire_v2_decodeHeader;
+        protocol.decodePayload = pubsubProtocol_wire_v2_decodePayload;
+        protocol.decodeMetadata = pubsubProtocol_wire_v2_decodeMetadata;
+        protocol.decodeFooter = pubsubProtocol_wire_v2_decodeFooter;
+
+        sender = pubsub_tcpHandler_create(&protocol, logHelper.get());
+        pubsub_tcpHandler_addAcceptConnectionCallback(sender, this, senderAccepted, nullptr);
+        receiver = pubsub_tcpHandler_create(&protocol, logHelper.get());
+        pubsub_tcpHandler_addMessageHandler(receiver, this, receiveMessage);
+        pubsub_tcpHandler_addReceiverConnectionCallback(receiver, this, nullptr, receiverDisconnected);
+    }
+
+    ~PubSubTcpHandlerTestSuite() override {
+        unblockReceiver();
+        pubsub_tcpHandler_destroy(receiver);
+        pubsub_tcpHandler_destroy(sender);
+        pubsubProtocol_wire_v2_destroy(wireProtocol);
+    }
+
+    PubSubTcpHandlerTestSuite(PubSubTcpHandlerTestSuite&&) = delete;
+    PubSubTcpHandlerTestSuite(const PubSubTcpHandlerTestSuite&) = delete;
+    PubSubTcpHandlerTestSuite& operator=(PubSubTcpHandlerTestSuite&&) = delete;
+    PubSubTcpHandlerTestSuite& operator=(const PubSubTcpHandlerTestSuite&) = delete;
+
+    static uint8_t pattern(uint32_t seqNr, size_t index) {
+        return static_cast<uint8_t>(seqNr * 31 + index);
+    }
+
+    static void senderAccepted(void* handle, const char* /*url*/) {
+        auto* suite = static_cast<PubSubTcpHandlerTestSuite*>(handle);
+        std::lock_guard<std::mutex> lock{suite->mutex};
+        suite->nrOfAccepted += 1;
+        suite->cond.notify_all();
+    }
+
+    static void receiverDisconnected(void* handle, const char* /*url*/, bool /*lock*/) {
+        auto* suite = static_cast<PubSubTcpHandlerTestSuite*>(handle);
+        std::lock_guard<std::mutex> lock{suite->mutex};
+        suite->nrOfDisconnects += 1;
+        suite->cond.notify_all();
+    }
+
+    static void receiveMessage(void* handle, const pubsub_protocol_message_t* message, bool* /*release*/, struct timespec* /*receiveTime*/) {
+        auto* suite = static_cast<PubSubTcpHandlerTestSuite*>(handle);
+        auto seqNr = message->header.seqNr;
+        bool intact = message->payload.length == suite->payloadSize;
+        auto* data = static_cast<const uint8_t*>(message->payload.payload);
+        for (size_t i = 0; intact && i < message->payload.length; ++i) {
+            intact = data[i] == pattern(seqNr, i);
+        }
+
+        std::unique_lock<std::mutex> lock{suite->mutex};
+        suite->received.push_back(seqNr);
+        if (!intact) {
+            suite->nrOfCorrupted += 1;
+        }
+        suite->cond.notify_all();
+        suite->cond.wait(lock, [suite]{ return !suite->receiverBlocked; });
+    }
+
+    void enableAsyncSend(pubsub_tcpHandler_sendQueuePolicy_e policy, unsigned int queueSize) {
+        pubsub_tcpHandler_setSendQueueSize(sender, queueSize);
+        pubsub_tcpHandler_setSendQueuePolicy(sender, policy);
+        pubsub_tcpHandler_enableAsyncSend(sender, true);
+    }
+
+    void connect(bool blockReceiver) {
+        receiverBlocked = blockReceiver;
+        ASSERT_GE(pubsub_tcpHandler_listen(sender, (char*)"tcp://127.0.0.1:0"), 0);
+        char* url = pubsub_tcpHandler_get_interface_url(sender);
+        ASSERT_NE(url, nullptr);
+        ASSERT_GE(pubsub_tcpHandler_connect(receiver, url), 0);
+        free(url);
+
+        std::unique_lock<std::mutex> lock{mutex};
+        ASSERT_TRUE(cond.wait_for(lock, std::chrono::seconds{5}, [this]{ return nrOfAccepted > 0; }));
+        lock.unlock();
+        //the accepted connection is marked as connected by the sender socket thread, just after the accept callback
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+
+    int publish(uint32_t seqNr) {
+        std::vector<uint8_t> payload(payloadSize);
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = pattern(seqNr, i);
+        }
+        pubsub_protocol_message_t message{};
+        message.header.msgId = 42;
+        message.header.seqNr = seqNr;
+        message.header.msgMajorVersion = 1;
+        message.payload.payload = payload.data();
+        message.payload.length = payload.size();
+        struct iovec iov{payload.data(), payload.size()};
+        return pubsub_tcpHandler_write(sender, &message, &iov, 1, 0);
+    }
+
+    void unblockReceiver() {
+        std::lock_guard<std::mutex> lock{mutex};
+        receiverBlocked = false;
+        cond.notify_all();
+    }
+
+    template<typename Predicate>
+    bool waitFor(Predicate predicate) {
+        std::unique_lock<std::mutex> lock{mutex};
+        return cond.wait_for(lock, std::chrono::seconds{30}, [&]{ return predicate(); });
+    }
+
+    std::vector<uint32_t> receivedSeqNrs() {
+        std::lock_guard<std::mutex> lock{mutex};
+        return received;
+    }
+
+    std::shared_ptr<celix_framework_t> fw{};
+    std::shared_ptr<celix_log_helper_t> logHelper{};
+    pubsub_protocol_wire_v2_t* wireProtocol{nullptr};
+    pubsub_protocol_service_t protocol{};
+    pubsub_tcpHandler_t* sender{nullptr};
+    pubsub_tcpHandler_t* receiver{nullptr};
+    size_t payloadSize{PAYLOAD_SIZE};
+
+    std::mutex mutex{}; //protects below
+    std::condition_variable cond{};
+    bool receiverBlocked{false};
+    int nrOfAccepted{0};
+    int nrOfDisconnects{0};
+    int nrOfCorrupted{0};
+    std::vector<uint32_t> received{};
+};
+
+TEST_F(PubSubTcpHandlerTestSuite, AsyncSendDropOldestPolicy) {
+    enableAsyncSend(PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DROP_OLDEST, 8);
+    connect(true);
+
+    //publishing never blocks or fails, the oldest queued messages are dropped
+    for (uint32_t seqNr = 0; seqNr < MAX_NR_OF_MESSAGES; ++seqNr) {
+        EXPECT_EQ(0, publish(seqNr));
+    }
+
+    unblockReceiver();
+    const uint32_t lastSeqNr = MAX_NR_OF_MESSAGES - 1;
+    ASSERT_TRUE(waitFor([&]{ return !received.empty() && received.back() == lastSeqNr; }));
+
+    auto seqNrs = receivedSeqNrs();
+    EXPECT_LT(seqNrs.size(), MAX_NR_OF_MESSAGES);
+    for (size_t i = 1; i < seqNrs.size(); ++i) {
+        EXPECT_LT(seqNrs[i - 1], seqNrs[i]);
+    }
+    EXPECT_EQ(0, nrOfCorrupted);
+}
+
+TEST_F(PubSubTcpHandlerTestSuite, AsyncSendBlockPolicy) {
+    pubsub_tcpHandler_setSendTimeOut(sender, 0.2);
+    enableAsyncSend(PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_BLOCK, 8);
+    connect(true);
+
+    //publishing blocks - max the send timeout - when the queue is full and then fails
+    uint32_t failedSeqNr = MAX_NR_OF_MESSAGES;
+    double failedWriteTime = 0.0;
+    for (uint32_t seqNr = 0; seqNr < MAX_NR_OF_MESSAGES; ++seqNr) {
+        auto start = std::chrono::steady_clock::now();
+        int rc = publish(seqNr);
+        if (rc != 0) {
+            failedWriteTime = std::chrono::duration<double>{std::chrono::steady_clock::now() - start}.count();
+            failedSeqNr = seqNr;
+            break;
+        }
+    }
+    ASSERT_LT(failedSeqNr, MAX_NR_OF_MESSAGES);
+    EXPECT_GE(failedWriteTime, 0.15);
+
+    //and all messages before the failed message are delivered in order
+    unblockReceiver();
+    ASSERT_TRUE(waitFor([&]{ return received.size() >= failedSeqNr; }));
+    auto seqNrs = receivedSeqNrs();
+    ASSERT_EQ(failedSeqNr, seqNrs.size());
+    for (uint32_t i = 0; i < failedSeqNr; ++i) {
+        EXPECT_EQ(i, seqNrs[i]);
+    }
+    EXPECT_EQ(0, nrOfCorrupted);
+}
+
+TEST_F(PubSubTcpHandlerTestSuite, AsyncSendBlockPolicyDoesNotBlockConnectionAdministration) {
+    pubsub_tcpHandler_setSendTimeOut(sender, 5.0);
+    enableAsyncSend(PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_BLOCK, 8);
+    connect(true);
+
+    //given a publisher blocked on a full write queue
+    std::atomic<bool> blocked{false};
+    std::thread publisher{[&]{
+        for (uint32_t seqNr = 0; seqNr < MAX_NR_OF_MESSAGES; ++seqNr) {
+            auto start = std::chrono::steady_clock::now();
+            int rc = publish(seqNr);
+            if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds{500}) {
+                blocked = true;
+            }
+            if (rc != 0 || blocked) {
+                break;
+            }
+        }
+    }};
+    std::this_thread::sleep_for(std::chrono::seconds{2});
+
+    //when the connection administration is write locked, it is not blocked by the waiting publisher
+    auto start = std::chrono::steady_clock::now();
+    char* url = pubsub_tcpHandler_get_connection_url(sender);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    free(url);
+    EXPECT_LT(elapsed, std::chrono::milliseconds{500});
+
+    //and the blocked publisher continues when the receiver reads again
+    unblockReceiver();
+    publisher.join();
+    EXPECT_TRUE(blocked);
+    EXPECT_EQ(0, nrOfCorrupted);
+}
+
+TEST_F(PubSubTcpHandlerTestSuite, AsyncSendDisconnectPolicy) {
+    enableAsyncSend(PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DISCONNECT, 8);
+    connect(true);
+
+    //publishing fails when the queue is full and the slow connection is closed
+    uint32_t failedSeqNr = MAX_NR_OF_MESSAGES;
+    for (uint32_t seqNr = 0; seqNr < MAX_NR_OF_MESSAGES; ++seqNr) {
+        if (publish(seqNr) != 0) {
+            failedSeqNr = seqNr;
+            break;
+        }
+    }
+    ASSERT_LT(failedSeqNr, MAX_NR_OF_MESSAGES);
+
+    //and the receiver is disconnected after receiving the already written messages, without gaps
+    unblockReceiver();
+    ASSERT_TRUE(waitFor([&]{ return nrOfDisconnects > 0; }));
+    auto seqNrs = receivedSeqNrs();
+    EXPECT_LT(seqNrs.size(), failedSeqNr);
+    for (uint32_t i = 0; i < seqNrs.size(); ++i) {
+        EXPECT_EQ(i, seqNrs[i]);
+    }
+    EXPECT_EQ(0, nrOfCorrupted);
+}
+
+TEST_F(PubSubTcpHandlerTestSuite, AsyncSendResumesPartialWrites) {
+    //messages larger than the socket send buffer are always partially written
+    payloadSize = 4 * 1024 * 1024;
+    const uint32_t nrOfMessages = 10;
+    enableAsyncSend(PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DROP_OLDEST, nrOfMessages);
+    connect(false);
+
+    for (uint32_t seqNr = 0; seqNr < nrOfMessages; ++seqNr) {
+        EXPECT_EQ(0, publish(seqNr));
+    }
+
+    ASSERT_TRUE(waitFor([&]{ return received.size() >= nrOfMessages; }));
+    auto seqNrs = receivedSeqNrs();
+    ASSERT_EQ(nrOfMessages, seqNrs.size());
+    for (uint32_t i = 0; i < nrOfMessages; ++i) {
+        EXPECT_EQ(i, seqNrs[i]);
+    }
+    EXPECT_EQ(0, nrOfCorrupted);
+}
@@ -57,6 +57,29 @@
 #define PUBSUB_TCP_SUBSCRIBER_RETRY_CNT_DEFAULT 5
 
 
+/**
+ * If set to true, the publisher encodes a message once and enqueues it on the (bounded) write queue of every
+ * connection. The queues are drained by the socket thread, which coalesces queued messages and resumes partial writes.
+ * Can be set in the topic properties.
+ */
+#define PUBSUB_TCP_PUBLISHER_ASYNC_SEND_KEY      "PUBSUB_TCP_PUBLISHER_ASYNC_SEND"
+#define PUBSUB_TCP_PUBLISHER_ASYNC_SEND_DEFAULT  false
+
+/**
+ * The max number of messages in the write queue of a connection, when async send is enabled.
+ * Can be set in the topic properties.
+ */
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_KEY     "PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE"
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_DEFAULT 256
+
+/**
+ * The back-pressure policy used when the write queue of a connection is full, when async send is enabled.
+ * Supported values are "drop_oldest", "block" (max PUBSUB_TCP_PUBLISHER_SEND_TIMEOUT) and "disconnect".
+ * Can be set in the topic properties.
+ */
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_POLICY_KEY      "PUBSUB_TCP_PUBLISHER_SEND_QUEUE_POLICY"
+#define PUBSUB_TCP_PUBLISHER_SEND_QUEUE_POLICY_DEFAULT  "drop_oldest"
+
 //Time-out settings are only for BLOCKING connections
 #define PUBSUB_TCP_PUBLISHER_SNDTIMEO_KEY       "PUBSUB_TCP_PUBLISHER_SEND_TIMEOUT"
 #define PUBSUB_TCP_PUBLISHER_SNDTIMEO_DEFAULT   5.0
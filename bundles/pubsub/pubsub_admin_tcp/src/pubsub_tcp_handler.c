@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -44,10 +45,12 @@
 #include <netinet/tcp.h>
 #include "hash_map.h"
 #include "utils.h"
+#include "celix_utils.h"
 #include "pubsub_tcp_handler.h"
 
 #define MAX_EVENTS   64
 #define MAX_DEFAULT_BUFFER_SIZE 4u
+#define MAX_DEFAULT_SEND_QUEUE_SIZE 256u
 
 #if defined(__APPLE__)
 #ifndef MSG_NOSIGNAL
@@ -64,6 +67,16 @@
 #define L_ERROR(...) \
     celix_logHelper_log(handle->logHelper, CELIX_LOG_LEVEL_ERROR, __VA_ARGS__)
 
+//
+// Encoded message, shared (ref counted) between the write queues of the connections (async send)
+//
+typedef struct psa_tcp_send_buffer {
+    int refCount; //atomic
+    size_t size;
+    size_t capacity;
+    char *data;
+} psa_tcp_send_buffer_t;
+
 //
 // Entry administration
 //
@@ -96,6 +109,15 @@ typedef struct psa_tcp_connection_entry {
     unsigned int retryCount;
     celix_thread_mutex_t writeMutex;
     struct msghdr readMsg;
+    unsigned int pollEvents; // registered poll events
+    struct {
+        psa_tcp_send_buffer_t **buffers; // ring buffer with queued messages, protected by writeMutex
+        unsigned int capacity;
+        unsigned int head;
+        unsigned int count;
+        size_t offset; // nr of bytes of the head message already written
+        bool pollOut; // true if the socket thread is polling for write readiness
+    } writeQueue;
 } psa_tcp_connection_entry_t;
 
 //
@@ -128,13 +150,28 @@ struct pubsub_tcpHandler {
     celix_thread_t thread;
     bool running;
     bool enableReceiveEvent;
+    bool asyncSend;
+    unsigned int sendQueueSize;
+    pubsub_tcpHandler_sendQueuePolicy_e sendQueuePolicy;
+    psa_tcp_connection_entry_t *encodeEntry; // scratch buffers to encode a message once, protected by its writeMutex
+    struct {
+        celix_thread_mutex_t mutex; // protects below
+        celix_thread_cond_t cond; // signalled when messages are removed from a write queue
+        unsigned long generation; // incremented when messages are removed from a write queue
+    } writeQueueDrained;
 };
 
+typedef long int (*pubsub_tcpHandler_writeSegment_callback_t)(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, struct msghdr *msg, size_t msgPartSize, int flags, void *data);
+
 static inline int pubsub_tcpHandler_closeConnectionEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, bool lock);
 static inline int pubsub_tcpHandler_closeInterfaceEntry(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry);
 static inline int pubsub_tcpHandler_makeNonBlocking(pubsub_tcpHandler_t *handle, int fd);
 static inline psa_tcp_connection_entry_t* pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, char *interface_url, struct sockaddr_in *addr);
+static inline void pubsub_tcpHandler_initEntryBuffers(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry);
 static inline void pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t *entry);
+static inline void pubsub_tcpHandler_releaseSendBuffer(psa_tcp_send_buffer_t *buffer);
+static inline void pubsub_tcpHandler_updatePollOut(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, bool enable);
+static inline void pubsub_tcpHandler_writeQueuedMessages(pubsub_tcpHandler_t *handle, int fd);
 static inline void pubsub_tcpHandler_releaseEntryBuffer(pubsub_tcpHandler_t *handle, int fd, unsigned int index);
 static inline long int pubsub_tcpHandler_getMsgSize(psa_tcp_connection_entry_t *entry);
 static inline void pubsub_tcpHandler_ensureReadBufferCapacity(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry);
@@ -166,7 +203,11 @@ pubsub_tcpHandler_t *pubsub_tcpHandler_create(pubsub_protocol_service_t *protoco
         handle->logHelper = logHelper;
         handle->protocol = protocol;
         handle->bufferSize = MAX_DEFAULT_BUFFER_SIZE;
+        handle->sendQueueSize = MAX_DEFAULT_SEND_QUEUE_SIZE;
+        handle->sendQueuePolicy = PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DROP_OLDEST;
         celixThreadRwlock_create(&handle->dbLock, 0);
+        celixThreadMutex_create(&handle->writeQueueDrained.mutex, NULL);
+        celixThreadCondition_init(&handle->writeQueueDrained.cond, NULL);
         handle->running = true;
         celixThread_create(&handle->thread, NULL, pubsub_tcpHandler_thread, handle);
         // signal(SIGPIPE, SIG_IGN);
@@ -209,8 +250,11 @@ void pubsub_tcpHandler_destroy(pubsub_tcpHandler_t *handle) {
         hashMap_destroy(handle->connection_fd_map, false, false);
         hashMap_destroy(handle->interface_url_map, false, false);
         hashMap_destroy(handle->interface_fd_map, false, false);
+        pubsub_tcpHandler_freeEntry(handle->encodeEntry);
         celixThreadRwlock_unlock(&handle->dbLock);
         celixThreadRwlock_destroy(&handle->dbLock);
+        celixThreadCondition_destroy(&handle->writeQueueDrained.cond);
+        celixThreadMutex_destroy(&handle->writeQueueDrained.mutex);
         free(handle);
     }
 }
@@ -324,34 +368,42 @@ pubsub_tcpHandler_createEntry(pubsub_tcpHandler_t *handle, int fd, char *url, ch
             entry->addr = *addr;
         }
         entry->len = sizeof(struct sockaddr_in);
-        size_t headerSize = 0;
-        size_t footerSize = 0;
-        handle->protocol->getHeaderSize(handle->protocol->handle, &headerSize);
-        handle->protocol->getFooterSize(handle->protocol->handle, &footerSize);
-        entry->readHeaderBufferSize = headerSize;
-        entry->writeHeaderBufferSize = headerSize;
-
-        entry->readFooterBufferSize = footerSize;
-        entry->writeFooterBufferSize = footerSize;
-        entry->bufferSize = MAX(handle->bufferSize, headerSize);
         entry->connected = false;
-        unsigned minimalMsgSize = entry->writeHeaderBufferSize + entry->writeFooterBufferSize;
-        if ((minimalMsgSize > handle->maxMsgSize) && (handle->maxMsgSize)) {
-            L_ERROR("[TCP Socket] maxMsgSize (%d) < headerSize + FooterSize (%d)\n", handle->maxMsgSize, minimalMsgSize);
-        } else {
-            entry->maxMsgSize = (handle->maxMsgSize) ? handle->maxMsgSize : LONG_MAX;
-        }
-        entry->readHeaderBuffer = calloc(sizeof(char), headerSize);
-        entry->writeHeaderBuffer = calloc(sizeof(char), headerSize);
-        if (entry->readFooterBufferSize ) entry->readFooterBuffer = calloc(sizeof(char), entry->readFooterBufferSize );
-        if (entry->writeFooterBufferSize) entry->writeFooterBuffer = calloc(sizeof(char), entry->writeFooterBufferSize);
-        if (entry->bufferSize) entry->buffer = calloc(sizeof(char), entry->bufferSize);
-        memset(&entry->readMsg, 0x00, sizeof(struct msghdr));
-        entry->readMsg.msg_iov = calloc(sizeof(struct iovec), IOV_MAX);
+        pubsub_tcpHandler_initEntryBuffers(handle, entry);
     }
     return entry;
 }
 
+//
+// Initialize the protocol buffers of a connection/interface entry
+//
+static inline void
+pubsub_tcpHandler_initEntryBuffers(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry) {
+    size_t headerSize = 0;
+    size_t footerSize = 0;
+    handle->protocol->getHeaderSize(handle->protocol->handle, &headerSize);
+    handle->protocol->getFooterSize(handle->protocol->handle, &footerSize);
+    entry->readHeaderBufferSize = headerSize;
+    entry->writeHeaderBufferSize = headerSize;
+
+    entry->readFooterBufferSize = footerSize;
+    entry->writeFooterBufferSize = footerSize;
+    entry->bufferSize = MAX(handle->bufferSize, headerSize);
+    unsigned minimalMsgSize = entry->writeHeaderBufferSize + entry->writeFooterBufferSize;
+    if ((minimalMsgSize > handle->maxMsgSize) && (handle->maxMsgSize)) {
+        L_ERROR("[TCP Socket] maxMsgSize (%d) < headerSize + FooterSize (%d)\n", handle->maxMsgSize, minimalMsgSize);
+    } else {
+        entry->maxMsgSize = (handle->maxMsgSize) ? handle->maxMsgSize : LONG_MAX;
+    }
+    entry->readHeaderBuffer = calloc(sizeof(char), headerSize);
+    entry->writeHeaderBuffer = calloc(sizeof(char), headerSize);
+    if (entry->readFooterBufferSize ) entry->readFooterBuffer = calloc(sizeof(char), entry->readFooterBufferSize );
+    if (entry->writeFooterBufferSize) entry->writeFooterBuffer = calloc(sizeof(char), entry->writeFooterBufferSize);
+    if (entry->bufferSize) entry->buffer = calloc(sizeof(char), entry->bufferSize);
+    memset(&entry->readMsg, 0x00, sizeof(struct msghdr));
+    entry->readMsg.msg_iov = calloc(sizeof(struct iovec), IOV_MAX);
+}
+
 //
 // Free connection/interface entry
 //
@@ -369,6 +421,10 @@ pubsub_tcpHandler_freeEntry(psa_tcp_connection_entry_t *entry) {
         free(entry->readMetaBuffer);
         free(entry->writeMetaBuffer);
         free(entry->readMsg.msg_iov);
+        for (unsigned int i = 0; i < entry->writeQueue.count; ++i) {
+            pubsub_tcpHandler_releaseSendBuffer(entry->writeQueue.buffers[(entry->writeQueue.head + i) % entry->writeQueue.capacity]);
+        }
+        free(entry->writeQueue.buffers);
         celixThreadMutex_destroy(&entry->writeMutex);
         free(entry);
     }
@@ -424,6 +480,7 @@ int pubsub_tcpHandler_connect(pubsub_tcpHandler_t *handle, char *url) {
             bzero(&event,  sizeof(struct epoll_event)); // zero the struct
             event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
             event.data.fd = entry->fd;
+            entry->pollEvents = event.events;
             rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, entry->fd, &event);
 #endif
             if (rc < 0) {
@@ -487,8 +544,8 @@ static inline int pubsub_tcpHandler_closeConnectionEntry(
         if (entry->fd >= 0) {
             if (handle->receiverDisconnectMessageCallback)
                 handle->receiverDisconnectMessageCallback(handle->receiverConnectPayload, entry->url, lock);
-            if (handle->acceptConnectMessageCallback)
-                handle->acceptConnectMessageCallback(handle->acceptConnectPayload, entry->url);
+            if (handle->acceptDisconnectMessageCallback)
+                handle->acceptDisconnectMessageCallback(handle->acceptConnectPayload, entry->url);
             pubsub_tcpHandler_freeEntry(entry);
             entry = NULL;
         }
@@ -751,6 +808,45 @@ void pubsub_tcpHandler_setReceiveTimeOut(pubsub_tcpHandler_t *handle, double tim
     }
 }
 
+void pubsub_tcpHandler_enableAsyncSend(pubsub_tcpHandler_t *handle, bool enable) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->asyncSend = enable;
+        if (enable && handle->encodeEntry == NULL) {
+            handle->encodeEntry = calloc(1, sizeof(*handle->encodeEntry));
+            handle->encodeEntry->fd = -1;
+            celixThreadMutex_create(&handle->encodeEntry->writeMutex, NULL);
+            pubsub_tcpHandler_initEntryBuffers(handle, handle->encodeEntry);
+        }
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+void pubsub_tcpHandler_setSendQueueSize(pubsub_tcpHandler_t *handle, unsigned int size) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->sendQueueSize = size > 0 ? size : 1;
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+void pubsub_tcpHandler_setSendQueuePolicy(pubsub_tcpHandler_t *handle, pubsub_tcpHandler_sendQueuePolicy_e policy) {
+    if (handle != NULL) {
+        celixThreadRwlock_writeLock(&handle->dbLock);
+        handle->sendQueuePolicy = policy;
+        celixThreadRwlock_unlock(&handle->dbLock);
+    }
+}
+
+pubsub_tcpHandler_sendQueuePolicy_e pubsub_tcpHandler_parseSendQueuePolicy(const char *policy) {
+    if (policy != NULL && strcasecmp(policy, "block") == 0) {
+        return PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_BLOCK;
+    } else if (policy != NULL && strcasecmp(policy, "disconnect") == 0) {
+        return PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DISCONNECT;
+    }
+    return PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DROP_OLDEST;
+}
+
 void pubsub_tcpHandler_enableReceiveEvent(pubsub_tcpHandler_t *handle,bool enable) {
     if (handle != NULL) {
         celixThreadRwlock_writeLock(&handle->dbLock);
@@ -983,226 +1079,556 @@ int pubsub_tcpHandler_addReceiverConnectionCallback(pubsub_tcpHandler_t *handle,
     return result;
 }
 
+int pubsub_tcpHandler_addAcceptConnectionCallback(pubsub_tcpHandler_t *handle, void *payload,
+                                                  pubsub_tcpHandler_acceptConnectMessage_callback_t connectMessageCallback,
+                                                  pubsub_tcpHandler_acceptConnectMessage_callback_t disconnectMessageCallback) {
+    int result = 0;
+    celixThreadRwlock_writeLock(&handle->dbLock);
+    handle->acceptConnectMessageCallback = connectMessageCallback;
+    handle->acceptDisconnectMessageCallback = disconnectMessageCallback;
+    handle->acceptConnectPayload = payload;
+    celixThreadRwlock_unlock(&handle->dbLock);
+    return result;
+}
+
 //
-// Write large data to TCP. .
+// Encodes the message in (protocol) segments and writes each segment using the writeSegment callback.
+// The protocol header, footer and metadata buffers of the entry are used as scratch buffers.
 //
-int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_protocol_message_t *message, struct iovec *msgIoVec,
-                            size_t msg_iov_len, int flags) {
+static inline int pubsub_tcpHandler_writeSegments(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry,
+                                                  pubsub_protocol_message_t *message, struct iovec *msgIoVec,
+                                                  size_t msg_iov_len, int flags,
+                                                  pubsub_tcpHandler_writeSegment_callback_t writeSegment, void *data) {
     int result = 0;
-    if (handle == NULL) {
-        return -1;
+    size_t max_msg_iov_len = IOV_MAX - 2; // header , footer, padding
+    void *payloadData = NULL;
+    size_t payloadSize = 0;
+    if (msg_iov_len == 1) {
+        handle->protocol->encodePayload(handle->protocol->handle, message, &payloadData, &payloadSize);
+    } else {
+        for (size_t i = 0; i < msg_iov_len; i++) {
+            payloadSize += msgIoVec[i].iov_len;
+        }
     }
-    int connFdCloseQueue[hashMap_size(handle->connection_fd_map)+1]; // +1 to ensure a size of 0 never occurs.
-    int nofConnToClose = 0;
-    if (handle) {
-        celixThreadRwlock_readLock(&handle->dbLock);
-        hash_map_iterator_t iter = hashMapIterator_construct(handle->connection_fd_map);
-        size_t max_msg_iov_len = IOV_MAX - 2; // header , footer, padding
-        while (hashMapIterator_hasNext(&iter)) {
-            psa_tcp_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
-            if (!__atomic_load_n(&entry->connected, __ATOMIC_ACQUIRE)) {
-                continue;
-            }
-            // When maxMsgSize is zero then payloadSize is disabled
-            if (entry->maxMsgSize == 0) {
-                // if max msg size is set to zero nothing will be send
-                continue;
-            }
-            celixThreadMutex_lock(&entry->writeMutex);
-            void *payloadData = NULL;
-            size_t payloadSize = 0;
-            if (msg_iov_len == 1) {
-                handle->protocol->encodePayload(handle->protocol->handle, message, &payloadData, &payloadSize);
+
+    // check if message is not too large
+    bool isMessageSegmentationSupported = false;
+    handle->protocol->isMessageSegmentationSupported(handle->protocol->handle, &isMessageSegmentationSupported);
+    if (!isMessageSegmentationSupported && (msg_iov_len > max_msg_iov_len || payloadSize > entry->maxMsgSize)) {
+        L_WARN("[TCP Socket] Failed to send message (fd: %d), Message segmentation is not supported\n", entry->fd);
+        return result;
+    }
+
+    message->header.convertEndianess = 0;
+    message->header.payloadSize = payloadSize;
+    message->header.payloadPartSize = payloadSize;
+    message->header.payloadOffset = 0;
+    message->header.isLastSegment = 1;
+
+    size_t metadataSize = 0;
+    if (message->metadata.metadata) {
+        handle->protocol->encodeMetadata(handle->protocol->handle, message, &entry->writeMetaBuffer, &entry->writeMetaBufferSize, &metadataSize);
+        // When maxMsgSize is smaller then meta data is disabled
+       if (metadataSize > entry->maxMsgSize) {
+            metadataSize = 0;
+        }
+    }
+
+    message->header.metadataSize = metadataSize;
+    size_t totalMsgSize = payloadSize + metadataSize;
+
+    size_t sendMsgSize = 0;
+    size_t msgPayloadOffset = 0;
+    size_t msgIovOffset     = 0;
+    bool allPayloadAdded = (payloadSize == 0);
+    long int nbytes = LONG_MAX;
+    while (sendMsgSize < totalMsgSize && nbytes > 0) {
+        struct msghdr msg;
+        struct iovec msg_iov[IOV_MAX];
+        memset(&msg, 0x00, sizeof(struct msghdr));
+        msg.msg_name = &entry->addr;
+        msg.msg_namelen = entry->len;
+        msg.msg_flags = flags;
+        msg.msg_iov = msg_iov;
+
+        size_t msgPartSize = 0;
+        message->header.payloadPartSize = 0;
+        message->header.payloadOffset = 0;
+        message->header.metadataSize = 0;
+        message->header.isLastSegment = 0;
+
+        size_t protocolHeaderBufferSize = 0;
+        // Get HeaderBufferSize of the Protocol Header, when headerBufferSize == 0, the protocol header is included in the payload (needed for endpoints)
+        handle->protocol->getHeaderBufferSize(handle->protocol->handle, &protocolHeaderBufferSize);
+        size_t footerSize = 0;
+        // Get size of the Protocol Footer
+        handle->protocol->getFooterSize(handle->protocol->handle, &footerSize);
+        size_t maxMsgSize = entry->maxMsgSize - protocolHeaderBufferSize - footerSize;
+
+        // reserve space for the header if required, header is added later when size of message is known (message can split in parts)
+        if (protocolHeaderBufferSize) {
+            msg.msg_iovlen++;
+        }
+        // Write generic seralized payload in vector buffer
+        if (!allPayloadAdded) {
+            if (payloadSize && payloadData && maxMsgSize) {
+                char *buffer = payloadData;
+                msg.msg_iov[msg.msg_iovlen].iov_base = &buffer[msgPayloadOffset];
+                msg.msg_iov[msg.msg_iovlen].iov_len = MIN((payloadSize - msgPayloadOffset), maxMsgSize);
+                msgPartSize += msg.msg_iov[msg.msg_iovlen].iov_len;
+                msg.msg_iovlen++;
+
             } else {
-                for (size_t i = 0; i < msg_iov_len; i++) {
-                    payloadSize += msgIoVec[i].iov_len;
+                // copy serialized vector into vector buffer
+                size_t i;
+                for (i = msgIovOffset; i < MIN(msg_iov_len, msgIovOffset + max_msg_iov_len); i++) {
+                    if ((msgPartSize + msgIoVec[i].iov_len) > maxMsgSize) {
+                        break;
+                    }
+                    msg.msg_iov[msg.msg_iovlen].iov_base = msgIoVec[i].iov_base;
+                    msg.msg_iov[msg.msg_iovlen].iov_len = msgIoVec[i].iov_len;
+                    msgPartSize += msg.msg_iov[msg.msg_iovlen].iov_len;
+                    msg.msg_iovlen++;
+                }
+                // if no entry could be added
+                if (i == msgIovOffset) {
+                    // TODO element can be split in parts?
+                    L_ERROR("[TCP Socket] vector io element is larger than max msg size");
+                    break;
                 }
+                msgIovOffset = i;
             }
+            message->header.payloadPartSize = msgPartSize;
+            message->header.payloadOffset   = msgPayloadOffset;
+            msgPayloadOffset += message->header.payloadPartSize;
+            sendMsgSize = msgPayloadOffset;
+            allPayloadAdded= msgPayloadOffset >= payloadSize;
+        }
 
-            // check if message is not too large
-            bool isMessageSegmentationSupported = false;
-            handle->protocol->isMessageSegmentationSupported(handle->protocol->handle, &isMessageSegmentationSupported);
-            if (!isMessageSegmentationSupported && (msg_iov_len > max_msg_iov_len || payloadSize > entry->maxMsgSize)) {
-                L_WARN("[TCP Socket] Failed to send message (fd: %d), Message segmentation is not supported\n", entry->fd);
-                celixThreadMutex_unlock(&entry->writeMutex);
-                continue;
+        // Write optional metadata in vector buffer
+        if (allPayloadAdded &&
+            (metadataSize != 0 && entry->writeMetaBuffer) &&
+            (msgPartSize < maxMsgSize) &&
+            (msg.msg_iovlen-1 < max_msg_iov_len)) {  // header is already included
+            msg.msg_iov[msg.msg_iovlen].iov_base = entry->writeMetaBuffer;
+            msg.msg_iov[msg.msg_iovlen].iov_len = metadataSize;
+            msg.msg_iovlen++;
+            msgPartSize += metadataSize;
+            message->header.metadataSize = metadataSize;
+            sendMsgSize += metadataSize;
+        }
+        if (sendMsgSize >= totalMsgSize) {
+            message->header.isLastSegment = 0x1;
+        }
+
+        void *headerData = NULL;
+        size_t headerSize = 0;
+        // Get HeaderSize of the Protocol Header
+        handle->protocol->getHeaderSize(handle->protocol->handle, &headerSize);
+
+        // check if header is not part of the payload (=> headerBufferSize = 0)
+        if (protocolHeaderBufferSize) {
+            headerData = entry->writeHeaderBuffer;
+            // Encode the header, with payload size and metadata size
+            handle->protocol->encodeHeader(handle->protocol->handle, message, &headerData, &headerSize);
+            entry->writeHeaderBufferSize = MAX(headerSize, entry->writeHeaderBufferSize);
+            if (headerData && entry->writeHeaderBuffer != headerData) {
+                entry->writeHeaderBuffer = headerData;
+            }
+            if (headerSize && headerData) {
+                // Write header in 1st vector buffer item
+                msg.msg_iov[0].iov_base = headerData;
+                msg.msg_iov[0].iov_len = headerSize;
+                msgPartSize += msg.msg_iov[0].iov_len;
+            } else {
+                L_ERROR("[TCP Socket] No header buffer is generated");
+                break;
             }
+        }
 
-            message->header.convertEndianess = 0;
-            message->header.payloadSize = payloadSize;
-            message->header.payloadPartSize = payloadSize;
-            message->header.payloadOffset = 0;
-            message->header.isLastSegment = 1;
-
-            size_t metadataSize = 0;
-            if (message->metadata.metadata) {
-                handle->protocol->encodeMetadata(handle->protocol->handle, message, &entry->writeMetaBuffer, &entry->writeMetaBufferSize, &metadataSize);
-                // When maxMsgSize is smaller then meta data is disabled
-               if (metadataSize > entry->maxMsgSize) {
-                    metadataSize = 0;
-                }
+        void *footerData = NULL;
+        // Write optional footerData in vector buffer
+        if (footerSize) {
+            footerData = entry->writeFooterBuffer;
+            handle->protocol->encodeFooter(handle->protocol->handle, message, &footerData, &footerSize);
+            if (footerData && entry->writeFooterBuffer != footerData) {
+                entry->writeFooterBuffer = footerData;
+                entry->writeFooterBufferSize = footerSize;
+            }
+            if (footerData) {
+                msg.msg_iov[msg.msg_iovlen].iov_base = footerData;
+                msg.msg_iov[msg.msg_iovlen].iov_len  = footerSize;
+                msg.msg_iovlen++;
+                msgPartSize += footerSize;
             }
+        }
+        nbytes = writeSegment(handle, entry, &msg, msgPartSize, flags, data);
+        if (nbytes == -1) {
+            result = -1;
+        }
+    }
+    // Note: serialized Payload is deleted by serializer
+    if (payloadData && (payloadData != message->payload.payload)) {
+        free(payloadData);
+    }
+    return result;
+}
 
-            message->header.metadataSize = metadataSize;
-            size_t totalMsgSize = payloadSize + metadataSize;
-
-            size_t sendMsgSize = 0;
-            size_t msgPayloadOffset = 0;
-            size_t msgIovOffset     = 0;
-            bool allPayloadAdded = (payloadSize == 0);
-            long int nbytes = LONG_MAX;
-            while (sendMsgSize < totalMsgSize && nbytes > 0) {
-                struct msghdr msg;
-                struct iovec msg_iov[IOV_MAX];
-                memset(&msg, 0x00, sizeof(struct msghdr));
-                msg.msg_name = &entry->addr;
-                msg.msg_namelen = entry->len;
-                msg.msg_flags = flags;
-                msg.msg_iov = msg_iov;
-
-                size_t msgPartSize = 0;
-                message->header.payloadPartSize = 0;
-                message->header.payloadOffset = 0;
-                message->header.metadataSize = 0;
-                message->header.isLastSegment = 0;
-
-                size_t protocolHeaderBufferSize = 0;
-                // Get HeaderBufferSize of the Protocol Header, when headerBufferSize == 0, the protocol header is included in the payload (needed for endpoints)
-                handle->protocol->getHeaderBufferSize(handle->protocol->handle, &protocolHeaderBufferSize);
-                size_t footerSize = 0;
-                // Get size of the Protocol Footer
-                handle->protocol->getFooterSize(handle->protocol->handle, &footerSize);
-                size_t maxMsgSize = entry->maxMsgSize - protocolHeaderBufferSize - footerSize;
-
-                // reserve space for the header if required, header is added later when size of message is known (message can split in parts)
-                if (protocolHeaderBufferSize) {
-                    msg.msg_iovlen++;
+typedef struct psa_tcp_send_segment_data {
+    pubsub_protocol_message_t *message;
+    bool closeConnection;
+} psa_tcp_send_segment_data_t;
+
+//
+// Sends a message segment directly to the socket of the entry (sync send)
+//
+static long int pubsub_tcpHandler_sendSegment(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry,
+                                              struct msghdr *msg, size_t msgPartSize, int flags, void *data) {
+    psa_tcp_send_segment_data_t *sendData = data;
+    long int nbytes = sendmsg(entry->fd, msg, flags | MSG_NOSIGNAL);
+
+    //  When a specific socket keeps reporting errors can indicate a subscriber
+    //  which is not active anymore, the connection will remain until the retry
+    //  counter exceeds the maximum retry count.
+    //  Btw, also, SIGSTOP issued by a debugging tool can result in EINTR error.
+    if (nbytes == -1) {
+        if (entry->retryCount < handle->maxSendRetryCount) {
+            entry->retryCount++;
+            L_ERROR(
+                "[TCP Socket] Failed to send message (fd: %d), try again. Retry count %u of %u, error(%d): %s.",
+                entry->fd, entry->retryCount, handle->maxSendRetryCount, errno, strerror(errno));
+        } else {
+            L_ERROR(
+                "[TCP Socket] Failed to send message (fd: %d) after %u retries! Closing connection... Error: %s", entry->fd, handle->maxSendRetryCount, strerror(errno));
+            sendData->closeConnection = true;
+        }
+    } else if (msgPartSize) {
+        entry->retryCount = 0;
+        if (nbytes != msgPartSize) {
+            L_ERROR("[TCP Socket] seq: %d MsgSize not correct: %zu != %ld (%s)\n", sendData->message->header.seqNr, msgPartSize, nbytes, strerror(errno));
+        }
+    }
+    return nbytes;
+}
+
+//
+// Appends a message segment to a send buffer (async send)
+//
+static long int pubsub_tcpHandler_appendSegment(pubsub_tcpHandler_t *handle __attribute__((unused)),
+                                                psa_tcp_connection_entry_t *entry __attribute__((unused)),
+                                                struct msghdr *msg, size_t msgPartSize,
+                                                int flags __attribute__((unused)), void *data) {
+    psa_tcp_send_buffer_t *buffer = data;
+    if (buffer->size + msgPartSize > buffer->capacity) {
+        size_t newCapacity = MAX(buffer->capacity * 2, buffer->size + msgPartSize);
+        char *newData = realloc(buffer->data, newCapacity);
+        if (newData == NULL) {
+            return -1;
+        }
+        buffer->data = newData;
+        buffer->capacity = newCapacity;
+    }
+    for (size_t i = 0; i < msg->msg_iovlen; i++) {
+        memcpy(buffer->data + buffer->size, msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+        buffer->size += msg->msg_iov[i].iov_len;
+    }
+    return (long int)msgPartSize;
+}
+
+static inline void pubsub_tcpHandler_releaseSendBuffer(psa_tcp_send_buffer_t *buffer) {
+    if (buffer != NULL && __atomic_sub_fetch(&buffer->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(buffer->data);
+        free(buffer);
+    }
+}
+
+//
+// Enqueue an encoded message on the write queue of the entry, applying the back-pressure policy if the queue is full.
+// Should be called with the entry writeMutex locked. Returns false if the message could not be enqueued.
+// For the block policy the function does not block, but sets blocked to true if the queue is full; the caller should
+// wait for the queue to drain - without holding the dbLock - using pubsub_tcpHandler_enqueueBlockedMessage.
+//
+static inline bool pubsub_tcpHandler_enqueueMessage(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry,
+                                                    psa_tcp_send_buffer_t *buffer, bool *closeConnection, bool *blocked) {
+    if (entry->writeQueue.buffers == NULL) {
+        entry->writeQueue.capacity = handle->sendQueueSize;
+        entry->writeQueue.buffers = calloc(entry->writeQueue.capacity, sizeof(*entry->writeQueue.buffers));
+    }
+    if (entry->writeQueue.count == entry->writeQueue.capacity) {
+        switch (handle->sendQueuePolicy) {
+            case PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_BLOCK:
+                *blocked = true;
+                return false;
+            case PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DISCONNECT:
+                L_ERROR("[TCP Socket] Write queue of %s full, closing connection", entry->url);
+                *closeConnection = true;
+                return false;
+            default: {
+                // drop the oldest message which is not (partially) written yet, by advancing the ring head.
+                unsigned int dropIndex = entry->writeQueue.offset > 0 ? 1 : 0;
+                if (dropIndex >= entry->writeQueue.count) {
+                    return false;
                 }
-                // Write generic seralized payload in vector buffer
-                if (!allPayloadAdded) {
-                    if (payloadSize && payloadData && maxMsgSize) {
-                        char *buffer = payloadData;
-                        msg.msg_iov[msg.msg_iovlen].iov_base = &buffer[msgPayloadOffset];
-                        msg.msg_iov[msg.msg_iovlen].iov_len = MIN((payloadSize - msgPayloadOffset), maxMsgSize);
-                        msgPartSize += msg.msg_iov[msg.msg_iovlen].iov_len;
-                        msg.msg_iovlen++;
-
-                    } else {
-                        // copy serialized vector into vector buffer
-                        size_t i;
-                        for (i = msgIovOffset; i < MIN(msg_iov_len, msgIovOffset + max_msg_iov_len); i++) {
-                            if ((msgPartSize + msgIoVec[i].iov_len) > maxMsgSize) {
-                                break;
-                            }
-                            msg.msg_iov[msg.msg_iovlen].iov_base = msgIoVec[i].iov_base;
-                            msg.msg_iov[msg.msg_iovlen].iov_len = msgIoVec[i].iov_len;
-                            msgPartSize += msg.msg_iov[msg.msg_iovlen].iov_len;
-                            msg.msg_iovlen++;
-                        }
-                        // if no entry could be added
-                        if (i == msgIovOffset) {
-                            // TODO element can be split in parts?
-                            L_ERROR("[TCP Socket] vector io element is larger than max msg size");
-                            break;
-                        }
-                        msgIovOffset = i;
-                    }
-                    message->header.payloadPartSize = msgPartSize;
-                    message->header.payloadOffset   = msgPayloadOffset;
-                    msgPayloadOffset += message->header.payloadPartSize;
-                    sendMsgSize = msgPayloadOffset;
-                    allPayloadAdded= msgPayloadOffset >= payloadSize;
+                unsigned int capacity = entry->writeQueue.capacity;
+                unsigned int head = entry->writeQueue.head;
+                unsigned int next = (head + 1) % capacity;
+                if (dropIndex == 0) {
+                    pubsub_tcpHandler_releaseSendBuffer(entry->writeQueue.buffers[head]);
+                } else {
+                    //keep the partially written head message, by moving it to the slot of the dropped message
+                    pubsub_tcpHandler_releaseSendBuffer(entry->writeQueue.buffers[next]);
+                    entry->writeQueue.buffers[next] = entry->writeQueue.buffers[head];
                 }
+                entry->writeQueue.buffers[head] = NULL;
+                entry->writeQueue.head = next;
+                entry->writeQueue.count -= 1;
+                L_DEBUG("[TCP Socket] Write queue of %s full, dropped oldest message", entry->url);
+                break;
+            }
+        }
+    }
+    __atomic_add_fetch(&buffer->refCount, 1, __ATOMIC_ACQ_REL);
+    unsigned int tail = (entry->writeQueue.head + entry->writeQueue.count) % entry->writeQueue.capacity;
+    entry->writeQueue.buffers[tail] = buffer;
+    entry->writeQueue.count += 1;
+    if (!entry->writeQueue.pollOut) {
+        pubsub_tcpHandler_updatePollOut(handle, entry, true);
+    }
+    return true;
+}
 
-                // Write optional metadata in vector buffer
-                if (allPayloadAdded &&
-                    (metadataSize != 0 && entry->writeMetaBuffer) &&
-                    (msgPartSize < maxMsgSize) &&
-                    (msg.msg_iovlen-1 < max_msg_iov_len)) {  // header is already included
-                    msg.msg_iov[msg.msg_iovlen].iov_base = entry->writeMetaBuffer;
-                    msg.msg_iov[msg.msg_iovlen].iov_len = metadataSize;
-                    msg.msg_iovlen++;
-                    msgPartSize += metadataSize;
-                    message->header.metadataSize = metadataSize;
-                    sendMsgSize += metadataSize;
+//
+// Enable/disable polling for write readiness of the entry socket.
+// Should be called with the entry writeMutex locked.
+//
+static inline void pubsub_tcpHandler_updatePollOut(pubsub_tcpHandler_t *handle, psa_tcp_connection_entry_t *entry, bool enable) {
+    int rc;
+#if defined(__APPLE__)
+    struct kevent ev;
+    EV_SET (&ev, entry->fd, EVFILT_WRITE, enable ? (EV_ADD | EV_ENABLE) : EV_DELETE, 0, 0, 0);
+    rc = kevent (handle->efd, &ev, 1, NULL, 0, NULL);
+#else
+    struct epoll_event event;
+    bzero(&event, sizeof(event)); // zero the struct
+    event.events = enable ? (entry->pollEvents | EPOLLOUT) : entry->pollEvents;
+    event.data.fd = entry->fd;
+    rc = epoll_ctl(handle->efd, EPOLL_CTL_MOD, entry->fd, &event);
+#endif
+    if (rc < 0) {
+        L_ERROR("[TCP Socket] Cannot update poll event for %s: %s\n", entry->url, strerror(errno));
+    } else {
+        entry->writeQueue.pollOut = enable;
+    }
+}
+
+//
+// Write the queued messages of a connection (async send), called from the socket thread when the socket is writable.
+// Small messages are coalesced in a single sendmsg call and partial writes are resumed on the next call.
+//
+static inline void pubsub_tcpHandler_writeQueuedMessages(pubsub_tcpHandler_t *handle, int fd) {
+    bool closeConnection = false;
+    celixThreadRwlock_readLock(&handle->dbLock);
+    psa_tcp_connection_entry_t *entry = hashMap_get(handle->connection_fd_map, (void *) (intptr_t) fd);
+    if (entry != NULL) {
+        celixThreadMutex_lock(&entry->writeMutex);
+        while (entry->writeQueue.count > 0) {
+            struct iovec msg_iov[IOV_MAX];
+            struct msghdr msg;
+            memset(&msg, 0x00, sizeof(struct msghdr));
+            msg.msg_iov = msg_iov;
+            for (unsigned int i = 0; i < entry->writeQueue.count && msg.msg_iovlen < IOV_MAX; ++i) {
+                psa_tcp_send_buffer_t *buffer = entry->writeQueue.buffers[(entry->writeQueue.head + i) % entry->writeQueue.capacity];
+                size_t offset = i == 0 ? entry->writeQueue.offset : 0;
+                msg_iov[msg.msg_iovlen].iov_base = buffer->data + offset;
+                msg_iov[msg.msg_iovlen].iov_len = buffer->size - offset;
+                msg.msg_iovlen++;
+            }
+            long int nbytes = sendmsg(entry->fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (nbytes < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    L_ERROR("[TCP Socket] Failed to send queued messages (fd: %d). Closing connection... Error: %s", entry->fd, strerror(errno));
+                    closeConnection = true;
                 }
-                if (sendMsgSize >= totalMsgSize) {
-                    message->header.isLastSegment = 0x1;
+                break;
+            }
+            //release the completely written messages and remember the offset of a partially written message
+            size_t written = (size_t)nbytes;
+            while (entry->writeQueue.count > 0) {
+                psa_tcp_send_buffer_t *buffer = entry->writeQueue.buffers[entry->writeQueue.head];
+                size_t remaining = buffer->size - entry->writeQueue.offset;
+                if (written < remaining) {
+                    entry->writeQueue.offset += written;
+                    break;
                 }
+                written -= remaining;
+                entry->writeQueue.offset = 0;
+                entry->writeQueue.buffers[entry->writeQueue.head] = NULL;
+                entry->writeQueue.head = (entry->writeQueue.head + 1) % entry->writeQueue.capacity;
+                entry->writeQueue.count -= 1;
+                pubsub_tcpHandler_releaseSendBuffer(buffer);
+            }
+            if (entry->writeQueue.offset > 0) {
+                //partial write, wait till the socket is writable again
+                break;
+            }
+        }
+        if (entry->writeQueue.count == 0 && entry->writeQueue.pollOut) {
+            pubsub_tcpHandler_updatePollOut(handle, entry, false);
+        }
+        celixThreadMutex_lock(&handle->writeQueueDrained.mutex);
+        handle->writeQueueDrained.generation += 1;
+        celixThreadCondition_broadcast(&handle->writeQueueDrained.cond);
+        celixThreadMutex_unlock(&handle->writeQueueDrained.mutex);
+        celixThreadMutex_unlock(&entry->writeMutex);
+    }
+    celixThreadRwlock_unlock(&handle->dbLock);
+    if (closeConnection) {
+        pubsub_tcpHandler_close(handle, fd);
+    }
+}
 
-                void *headerData = NULL;
-                size_t headerSize = 0;
-                // Get HeaderSize of the Protocol Header
-                handle->protocol->getHeaderSize(handle->protocol->handle, &headerSize);
-
-                // check if header is not part of the payload (=> headerBufferSize = 0)
-                if (protocolHeaderBufferSize) {
-                    headerData = entry->writeHeaderBuffer;
-                    // Encode the header, with payload size and metadata size
-                    handle->protocol->encodeHeader(handle->protocol->handle, message, &headerData, &headerSize);
-                    entry->writeHeaderBufferSize = MAX(headerSize, entry->writeHeaderBufferSize);
-                    if (headerData && entry->writeHeaderBuffer != headerData) {
-                        entry->writeHeaderBuffer = headerData;
-                    }
-                    if (headerSize && headerData) {
-                        // Write header in 1st vector buffer item
-                        msg.msg_iov[0].iov_base = headerData;
-                        msg.msg_iov[0].iov_len = headerSize;
-                        msgPartSize += msg.msg_iov[0].iov_len;
-                    } else {
-                        L_ERROR("[TCP Socket] No header buffer is generated");
-                        break;
-                    }
-                }
+//
+// Wait - max the send timeout - until the full write queue of the connection for fd has room for the message and
+// enqueue it (async send with the block policy).
+// Should be called without the dbLock locked, so that the socket thread can drain the write queue and connections
+// can be added and removed while waiting. Returns false if the message could not be enqueued.
+//
+static inline bool pubsub_tcpHandler_enqueueBlockedMessage(pubsub_tcpHandler_t *handle, int fd, psa_tcp_send_buffer_t *buffer) {
+    bool enqueued = false;
+    bool done = false;
+    celixThreadRwlock_readLock(&handle->dbLock);
+    double timeout = handle->sendTimeout > 0.0 ? handle->sendTimeout : handle->timeout / 1000.0;
+    celixThreadRwlock_unlock(&handle->dbLock);
+    struct timespec start = celix_gettime(CLOCK_MONOTONIC);
+    while (!done) {
+        unsigned long generation = 0;
+        celixThreadRwlock_readLock(&handle->dbLock);
+        psa_tcp_connection_entry_t *entry = hashMap_get(handle->connection_fd_map, (void *) (intptr_t) fd);
+        if (entry == NULL || !__atomic_load_n(&entry->connected, __ATOMIC_ACQUIRE)) {
+            done = true;
+        } else {
+            celixThreadMutex_lock(&entry->writeMutex);
+            if (entry->writeQueue.count < entry->writeQueue.capacity) {
+                bool closeConnection = false;
+                bool blocked = false;
+                enqueued = pubsub_tcpHandler_enqueueMessage(handle, entry, buffer, &closeConnection, &blocked);
+                done = true;
+            } else if (celix_elapsedtime(CLOCK_MONOTONIC, start) >= timeout) {
+                L_WARN("[TCP Socket] Write queue of %s still full after %f seconds, dropping message", entry->url, timeout);
+                done = true;
+            }
+            celixThreadMutex_lock(&handle->writeQueueDrained.mutex);
+            generation = handle->writeQueueDrained.generation;
+            celixThreadMutex_unlock(&handle->writeQueueDrained.mutex);
+            celixThreadMutex_unlock(&entry->writeMutex);
+        }
+        celixThreadRwlock_unlock(&handle->dbLock);
 
-                void *footerData = NULL;
-                // Write optional footerData in vector buffer
-                if (footerSize) {
-                    footerData = entry->writeFooterBuffer;
-                    handle->protocol->encodeFooter(handle->protocol->handle, message, &footerData, &footerSize);
-                    if (footerData && entry->writeFooterBuffer != footerData) {
-                        entry->writeFooterBuffer = footerData;
-                        entry->writeFooterBufferSize = footerSize;
-                    }
-                    if (footerData) {
-                        msg.msg_iov[msg.msg_iovlen].iov_base = footerData;
-                        msg.msg_iov[msg.msg_iovlen].iov_len  = footerSize;
-                        msg.msg_iovlen++;
-                        msgPartSize += footerSize;
-                    }
+        if (!done) {
+            celixThreadMutex_lock(&handle->writeQueueDrained.mutex);
+            if (generation == handle->writeQueueDrained.generation) {
+                celixThreadCondition_timedwaitRelative(&handle->writeQueueDrained.cond, &handle->writeQueueDrained.mutex, 0, 100000000);
+            }
+            celixThreadMutex_unlock(&handle->writeQueueDrained.mutex);
+        }
+    }
+    return enqueued;
+}
+
+//
+// Encodes the message once and enqueue it on the write queues of all connections (async send).
+// Connections with a full write queue and the block policy are waited for after the dbLock is released.
+//
+static inline int pubsub_tcpHandler_writeAsync(pubsub_tcpHandler_t *handle, pubsub_protocol_message_t *message, struct iovec *msgIoVec,
+                                               size_t msg_iov_len, int flags, int *connFdCloseQueue, int *nofConnToClose) {
+    int result = 0;
+    psa_tcp_send_buffer_t *buffer = calloc(1, sizeof(*buffer));
+    buffer->refCount = 1;
+
+    celixThreadRwlock_readLock(&handle->dbLock);
+    psa_tcp_connection_entry_t *encodeEntry = handle->encodeEntry;
+    celixThreadMutex_lock(&encodeEntry->writeMutex);
+    encodeEntry->maxMsgSize = (handle->maxMsgSize) ? handle->maxMsgSize : LONG_MAX;
+    result = pubsub_tcpHandler_writeSegments(handle, encodeEntry, message, msgIoVec, msg_iov_len, flags, pubsub_tcpHandler_appendSegment, buffer);
+    celixThreadMutex_unlock(&encodeEntry->writeMutex);
+
+    int blockedFds[hashMap_size(handle->connection_fd_map)+1]; // +1 to ensure a size of 0 never occurs.
+    int nofBlocked = 0;
+    if (result == 0 && buffer->size > 0) {
+        hash_map_iterator_t iter = hashMapIterator_construct(handle->connection_fd_map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_tcp_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (!__atomic_load_n(&entry->connected, __ATOMIC_ACQUIRE) || entry->maxMsgSize == 0) {
+                continue;
+            }
+            bool closeConnection = false;
+            bool blocked = false;
+            celixThreadMutex_lock(&entry->writeMutex);
+            if (!pubsub_tcpHandler_enqueueMessage(handle, entry, buffer, &closeConnection, &blocked) && !blocked) {
+                result = -1; //At least one connection dropped the message
+            }
+            celixThreadMutex_unlock(&entry->writeMutex);
+            if (closeConnection) {
+                connFdCloseQueue[(*nofConnToClose)++] = entry->fd;
+            }
+            if (blocked) {
+                blockedFds[nofBlocked++] = entry->fd;
+            }
+        }
+    }
+    celixThreadRwlock_unlock(&handle->dbLock);
+
+    for (int i = 0; i < nofBlocked; ++i) {
+        if (!pubsub_tcpHandler_enqueueBlockedMessage(handle, blockedFds[i], buffer)) {
+            result = -1; //At least one connection dropped the message
+        }
+    }
+    pubsub_tcpHandler_releaseSendBuffer(buffer);
+    return result;
+}
+
+//
+// Write large data to TCP. .
+//
+int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle, pubsub_protocol_message_t *message, struct iovec *msgIoVec,
+                            size_t msg_iov_len, int flags) {
+    int result = 0;
+    if (handle == NULL) {
+        return -1;
+    }
+    int connFdCloseQueue[hashMap_size(handle->connection_fd_map)+1]; // +1 to ensure a size of 0 never occurs.
+    int nofConnToClose = 0;
+    if (handle) {
+        celixThreadRwlock_readLock(&handle->dbLock);
+        bool asyncSend = handle->asyncSend;
+        if (!asyncSend) {
+            hash_map_iterator_t iter = hashMapIterator_construct(handle->connection_fd_map);
+            while (hashMapIterator_hasNext(&iter)) {
+                psa_tcp_connection_entry_t *entry = hashMapIterator_nextValue(&iter);
+                if (!__atomic_load_n(&entry->connected, __ATOMIC_ACQUIRE)) {
+                    continue;
                 }
-                nbytes = sendmsg(entry->fd, &msg, flags | MSG_NOSIGNAL);
-
-                //  When a specific socket keeps reporting errors can indicate a subscriber
-                //  which is not active anymore, the connection will remain until the retry
-                //  counter exceeds the maximum retry count.
-                //  Btw, also, SIGSTOP issued by a debugging tool can result in EINTR error.
-                if (nbytes == -1) {
-                    if (entry->retryCount < handle->maxSendRetryCount) {
-                        entry->retryCount++;
-                        L_ERROR(
-                            "[TCP Socket] Failed to send message (fd: %d), try again. Retry count %u of %u, error(%d): %s.",
-                            entry->fd, entry->retryCount, handle->maxSendRetryCount, errno, strerror(errno));
-                    } else {
-                        L_ERROR(
-                            "[TCP Socket] Failed to send message (fd: %d) after %u retries! Closing connection... Error: %s", entry->fd, handle->maxSendRetryCount, strerror(errno));
-                        connFdCloseQueue[nofConnToClose++] = entry->fd;
-                    }
+                // When maxMsgSize is zero then payloadSize is disabled
+                if (entry->maxMsgSize == 0) {
+                    // if max msg size is set to zero nothing will be send
+                    continue;
+                }
+                psa_tcp_send_segment_data_t sendData = {.message = message, .closeConnection = false};
+                celixThreadMutex_lock(&entry->writeMutex);
+                if (pubsub_tcpHandler_writeSegments(handle, entry, message, msgIoVec, msg_iov_len, flags, pubsub_tcpHandler_sendSegment, &sendData) != 0) {
                     result = -1; //At least one connection failed sending
-                } else if (msgPartSize) {
-                    entry->retryCount = 0;
-                    if (nbytes != msgPartSize) {
-                        L_ERROR("[TCP Socket] seq: %d MsgSize not correct: %zu != %ld (%s)\n", message->header.seqNr, msgPartSize, nbytes, strerror(errno));
-                    }
                 }
-                // Note: serialized Payload is deleted by serializer
-                if (payloadData && (payloadData != message->payload.payload)) {
-                    free(payloadData);
+                celixThreadMutex_unlock(&entry->writeMutex);
+                if (sendData.closeConnection) {
+                    connFdCloseQueue[nofConnToClose++] = entry->fd;
                 }
             }
-            celixThreadMutex_unlock(&entry->writeMutex);
         }
         celixThreadRwlock_unlock(&handle->dbLock);
+        if (asyncSend) {
+            //note the async write locks the dbLock itself, so that it can wait for full write queues without the dbLock
+            result = pubsub_tcpHandler_writeAsync(handle, message, msgIoVec, msg_iov_len, flags, connFdCloseQueue, &nofConnToClose);
+        }
     }
     //Force close all connections that are queued in a list, done outside of locking handle->dbLock to prevent deadlock
     for (int i = 0; i < nofConnToClose; i++) {
@@ -1293,6 +1719,7 @@ int pubsub_tcpHandler_acceptHandler(pubsub_tcpHandler_t *handle, psa_tcp_connect
         event.events = EPOLLRDHUP | EPOLLERR;
         if (handle->enableReceiveEvent) event.events |= EPOLLIN;
         event.data.fd = entry->fd;
+        entry->pollEvents = event.events;
         // Register Read to epoll
         rc = epoll_ctl(handle->efd, EPOLL_CTL_ADD, entry->fd, &event);
 #endif
@@ -1360,6 +1787,8 @@ void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
       if (pendingConnectionEntry) {
         int fd = pubsub_tcpHandler_acceptHandler(handle, pendingConnectionEntry);
         pubsub_tcpHandler_connectionHandler(handle, fd);
+      } else if (events[i].filter == EVFILT_WRITE) {
+        pubsub_tcpHandler_writeQueuedMessages(handle, events[i].ident);
       } else if (events[i].filter & EVFILT_READ) {
         int rc = pubsub_tcpHandler_read(handle, events[i].ident);
         if (rc == 0) pubsub_tcpHandler_close(handle, events[i].ident);
@@ -1407,6 +1836,9 @@ void pubsub_tcpHandler_handler(pubsub_tcpHandler_t *handle) {
                 if (events[i].data.fd == entry->fd)
                     pendingConnectionEntry = entry;
             }
+            if (!pendingConnectionEntry && (events[i].events & EPOLLOUT)) {
+                pubsub_tcpHandler_writeQueuedMessages(handle, events[i].data.fd);
+            }
             if (pendingConnectionEntry) {
                int fd = pubsub_tcpHandler_acceptHandler(handle, pendingConnectionEntry);
                pubsub_tcpHandler_connectionHandler(handle, fd);
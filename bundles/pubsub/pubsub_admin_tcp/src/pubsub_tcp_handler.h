@@ -46,6 +46,16 @@
 #endif
 
 typedef struct pubsub_tcpHandler pubsub_tcpHandler_t;
+
+/**
+ * Back-pressure policy used by the asynchronous send mode when the write queue of a connection is full.
+ */
+typedef enum pubsub_tcpHandler_sendQueuePolicy {
+    PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DROP_OLDEST = 0, // drop the oldest - not yet partially written - message
+    PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_BLOCK = 1,       // block the publisher until there is room (max send timeout)
+    PUBSUB_TCP_HANDLER_SEND_QUEUE_POLICY_DISCONNECT = 2,  // disconnect the slow subscriber
+} pubsub_tcpHandler_sendQueuePolicy_e;
+
 typedef void(*pubsub_tcpHandler_processMessage_callback_t)
     (void *payload, const pubsub_protocol_message_t *header, bool *release, struct timespec *receiveTime);
 typedef void (*pubsub_tcpHandler_receiverConnectMessage_callback_t)(void *payload, const char *url, bool lock);
@@ -66,6 +76,10 @@ void pubsub_tcpHandler_setReceiveRetryCnt(pubsub_tcpHandler_t *handle, unsigned
 void pubsub_tcpHandler_setSendTimeOut(pubsub_tcpHandler_t *handle, double timeout);
 void pubsub_tcpHandler_setReceiveTimeOut(pubsub_tcpHandler_t *handle, double timeout);
 void pubsub_tcpHandler_enableReceiveEvent(pubsub_tcpHandler_t *handle, bool enable);
+void pubsub_tcpHandler_enableAsyncSend(pubsub_tcpHandler_t *handle, bool enable);
+void pubsub_tcpHandler_setSendQueueSize(pubsub_tcpHandler_t *handle, unsigned int size);
+void pubsub_tcpHandler_setSendQueuePolicy(pubsub_tcpHandler_t *handle, pubsub_tcpHandler_sendQueuePolicy_e policy);
+pubsub_tcpHandler_sendQueuePolicy_e pubsub_tcpHandler_parseSendQueuePolicy(const char *policy);
 
 int pubsub_tcpHandler_read(pubsub_tcpHandler_t *handle, int fd);
 int pubsub_tcpHandler_write(pubsub_tcpHandler_t *handle,
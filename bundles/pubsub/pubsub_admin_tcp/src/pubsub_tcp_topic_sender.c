@@ -179,6 +179,14 @@ pubsub_tcp_topic_sender_t *pubsub_tcpTopicSender_create(
         // Because the topic receiver is already started, enable the receive event.
         pubsub_tcpHandler_enableReceiveEvent(sender->socketHandler, (passiveKey) ? true : false);
         pubsub_tcpHandler_setTimeout(sender->socketHandler, (unsigned int) timeout);
+        bool asyncSend = celix_properties_getAsBool(topicProperties, PUBSUB_TCP_PUBLISHER_ASYNC_SEND_KEY, PUBSUB_TCP_PUBLISHER_ASYNC_SEND_DEFAULT);
+        if (asyncSend) {
+            long queueSize = celix_properties_getAsLong(topicProperties, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_KEY, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_SIZE_DEFAULT);
+            const char *policy = celix_properties_get(topicProperties, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_POLICY_KEY, PUBSUB_TCP_PUBLISHER_SEND_QUEUE_POLICY_DEFAULT);
+            pubsub_tcpHandler_setSendQueueSize(sender->socketHandler, (unsigned int) queueSize);
+            pubsub_tcpHandler_setSendQueuePolicy(sender->socketHandler, pubsub_tcpHandler_parseSendQueuePolicy(policy));
+            pubsub_tcpHandler_enableAsyncSend(sender->socketHandler, true);
+        }
     }
 
     if (!sender->isPassive) {
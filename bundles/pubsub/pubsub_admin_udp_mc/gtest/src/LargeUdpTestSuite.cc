@@ -0,0 +1,276 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+#include "large_udp.h"
+}
+
+/**
+ * Tests the fragmentation and reassembly of large UDP messages over a loopback socket pair.
+ * Fragments can also be sent directly on the sender socket, to test the handling of duplicate and invalid fragments.
+ */
+class LargeUdpTestSuite : public ::testing::Test {
+public:
+    // Must match the part header and the max part size of large_udp.c
+    struct PartHeader {
+        unsigned int msgIdent;
+        unsigned int totalMsgSize;
+        unsigned int partMsgSize;
+        unsigned int offset;
+    };
+    static constexpr unsigned int MAX_PART_SIZE = 65535 - (20 + 8 + sizeof(PartHeader));
+    static constexpr long PARTIAL_MSG_TIMEOUT_IN_MS = 50;
+
+    LargeUdpTestSuite() {
+        receiveFd = socket(AF_INET, SOCK_DGRAM, 0);
+        int rcvBufSize = 4 * 1024 * 1024;
+        setsockopt(receiveFd, SOL_SOCKET, SO_RCVBUF, &rcvBufSize, sizeof(rcvBufSize));
+        memset(&receiveAddr, 0, sizeof(receiveAddr));
+        receiveAddr.sin_family = AF_INET;
+        receiveAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        receiveAddr.sin_port = 0;
+        bind(receiveFd, (struct sockaddr*)&receiveAddr, sizeof(receiveAddr));
+        socklen_t addrLen = sizeof(receiveAddr);
+        getsockname(receiveFd, (struct sockaddr*)&receiveAddr, &addrLen);
+
+        sendFd = socket(AF_INET, SOCK_DGRAM, 0);
+        int sndBufSize = 4 * 1024 * 1024;
+        setsockopt(sendFd, SOL_SOCKET, SO_SNDBUF, &sndBufSize, sizeof(sndBufSize));
+
+        sender = largeUdp_create(1, PARTIAL_MSG_TIMEOUT_IN_MS);
+        receiver = largeUdp_create(2, PARTIAL_MSG_TIMEOUT_IN_MS);
+    }
+
+    ~LargeUdpTestSuite() override {
+        largeUdp_destroy(sender);
+        largeUdp_destroy(receiver);
+        close(sendFd);
+        close(receiveFd);
+    }
+
+    LargeUdpTestSuite(LargeUdpTestSuite&&) = delete;
+    LargeUdpTestSuite(const LargeUdpTestSuite&) = delete;
+    LargeUdpTestSuite& operator=(LargeUdpTestSuite&&) = delete;
+    LargeUdpTestSuite& operator=(const LargeUdpTestSuite&) = delete;
+
+    static void receiveMessage(void* handle, void* msg, unsigned int size) {
+        auto* suite = static_cast<LargeUdpTestSuite*>(handle);
+        suite->receivedMsgs.emplace_back(static_cast<char*>(msg), size);
+        free(msg);
+    }
+
+    /**
+     * Calls largeUdp_receiveBatch until the expected number of datagrams are read or a timeout occurs.
+     */
+    void receiveDatagrams(unsigned long expectedNrOfDatagrams) {
+        unsigned long nrOfDatagrams = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (nrOfDatagrams < expectedNrOfDatagrams && std::chrono::steady_clock::now() - start < std::chrono::seconds{5}) {
+            int n = largeUdp_receiveBatch(receiver, receiveFd, receiveMessage, this);
+            ASSERT_GE(n, 0);
+            if (n == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+            nrOfDatagrams += (unsigned long)n;
+        }
+        ASSERT_EQ(nrOfDatagrams, expectedNrOfDatagrams);
+    }
+
+    void sendFragment(const PartHeader& header, const std::string& payload) {
+        std::vector<char> datagram(sizeof(header) + payload.size());
+        memcpy(datagram.data(), &header, sizeof(header));
+        memcpy(datagram.data() + sizeof(header), payload.data(), payload.size());
+        sendDatagram(datagram.data(), datagram.size());
+    }
+
+    void sendDatagram(const void* data, size_t size) {
+        auto w = sendto(sendFd, data, size, 0, (struct sockaddr*)&receiveAddr, sizeof(receiveAddr));
+        ASSERT_EQ(w, (ssize_t)size);
+    }
+
+    static std::string createPayload(size_t size) {
+        std::string payload(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            payload[i] = (char)('a' + (i % 26));
+        }
+        return payload;
+    }
+
+    static largeUdp_statistics_t getStatistics(largeUdp_t* handle) {
+        largeUdp_statistics_t stats;
+        largeUdp_getStatistics(handle, &stats);
+        return stats;
+    }
+
+    int receiveFd{-1};
+    int sendFd{-1};
+    struct sockaddr_in receiveAddr{};
+    largeUdp_t* sender{nullptr};
+    largeUdp_t* receiver{nullptr};
+    std::vector<std::string> receivedMsgs{};
+};
+
+TEST_F(LargeUdpTestSuite, SingleFragmentRoundTrip) {
+    auto payload = createPayload(100);
+    int w = largeUdp_sendto(sender, sendFd, payload.data(), payload.size(), 0, &receiveAddr, sizeof(receiveAddr));
+    EXPECT_EQ(w, (int)(payload.size() + sizeof(PartHeader)));
+
+    receiveDatagrams(1);
+    ASSERT_EQ(receivedMsgs.size(), 1);
+    EXPECT_EQ(receivedMsgs[0], payload);
+
+    auto sendStats = getStatistics(sender);
+    EXPECT_EQ(sendStats.nrOfSendSyscalls, 1);
+    EXPECT_EQ(sendStats.nrOfSentDatagrams, 1);
+    auto recvStats = getStatistics(receiver);
+    EXPECT_EQ(recvStats.nrOfReceivedDatagrams, 1);
+    EXPECT_EQ(recvStats.nrOfReceivedMsgs, 1);
+    EXPECT_EQ(recvStats.nrOfDroppedFragments, 0);
+}
+
+TEST_F(LargeUdpTestSuite, MultiFragmentRoundTrip) {
+    //3 fragments, spread over input iovecs which do not align with the fragment boundaries
+    auto payload = createPayload(2 * MAX_PART_SIZE + 1000);
+    size_t firstLen = 100;
+    size_t secondLen = MAX_PART_SIZE + 50;
+    struct iovec iov[3];
+    iov[0].iov_base = &payload[0];
+    iov[0].iov_len = firstLen;
+    iov[1].iov_base = &payload[firstLen];
+    iov[1].iov_len = secondLen;
+    iov[2].iov_base = &payload[firstLen + secondLen];
+    iov[2].iov_len = payload.size() - firstLen - secondLen;
+
+    int w = largeUdp_sendmsg(sender, sendFd, iov, 3, 0, &receiveAddr, sizeof(receiveAddr));
+    EXPECT_EQ(w, (int)(payload.size() + 3 * sizeof(PartHeader)));
+
+    receiveDatagrams(3);
+    ASSERT_EQ(receivedMsgs.size(), 1);
+    EXPECT_EQ(receivedMsgs[0], payload);
+
+    auto sendStats = getStatistics(sender);
+    EXPECT_EQ(sendStats.nrOfSendSyscalls, 1); //all fragments in a single sendmmsg batch
+    EXPECT_EQ(sendStats.nrOfSentDatagrams, 3);
+    auto recvStats = getStatistics(receiver);
+    EXPECT_GE(recvStats.nrOfReceiveSyscalls, 1);
+    EXPECT_EQ(recvStats.nrOfReceivedDatagrams, 3);
+    EXPECT_EQ(recvStats.nrOfReceivedMsgs, 1);
+    EXPECT_EQ(recvStats.nrOfDroppedFragments, 0);
+    EXPECT_EQ(recvStats.nrOfIncompleteMsgs, 0);
+}
+
+TEST_F(LargeUdpTestSuite, OutOfOrderAndDuplicateFragments) {
+    auto payload = createPayload(MAX_PART_SIZE + 10);
+    PartHeader first{42, (unsigned int)payload.size(), MAX_PART_SIZE, 0};
+    PartHeader second{42, (unsigned int)payload.size(), 10, MAX_PART_SIZE};
+
+    sendFragment(second, payload.substr(MAX_PART_SIZE));
+    sendFragment(second, payload.substr(MAX_PART_SIZE)); //duplicate
+    sendFragment(first, payload.substr(0, MAX_PART_SIZE));
+    receiveDatagrams(3);
+
+    ASSERT_EQ(receivedMsgs.size(), 1);
+    EXPECT_EQ(receivedMsgs[0], payload);
+    auto stats = getStatistics(receiver);
+    EXPECT_EQ(stats.nrOfReceivedDatagrams, 3);
+    EXPECT_EQ(stats.nrOfReceivedMsgs, 1);
+    EXPECT_EQ(stats.nrOfDroppedFragments, 1);
+    EXPECT_EQ(stats.nrOfIncompleteMsgs, 0);
+}
+
+TEST_F(LargeUdpTestSuite, InvalidFragmentsAreDropped) {
+    auto payload = createPayload(MAX_PART_SIZE + 10);
+
+    unsigned int tooShort = 42;
+    sendDatagram(&tooShort, sizeof(tooShort)); //smaller than the part header
+    sendFragment(PartHeader{1, 100, 50, 0}, createPayload(100)); //part size does not match the datagram size
+    sendFragment(PartHeader{2, (unsigned int)payload.size(), 10, 10}, createPayload(10)); //unaligned offset
+    sendFragment(PartHeader{3, 100, 100, MAX_PART_SIZE}, createPayload(100)); //offset beyond the message size
+    sendFragment(PartHeader{4, (unsigned int)payload.size(), 10, 0}, createPayload(10)); //first part must be full
+    receiveDatagrams(5);
+
+    EXPECT_TRUE(receivedMsgs.empty());
+    auto stats = getStatistics(receiver);
+    EXPECT_EQ(stats.nrOfReceivedDatagrams, 5);
+    EXPECT_EQ(stats.nrOfReceivedMsgs, 0);
+    EXPECT_EQ(stats.nrOfDroppedFragments, 5);
+    EXPECT_EQ(stats.nrOfIncompleteMsgs, 0);
+
+    //the receiver still reassembles valid messages
+    int w = largeUdp_sendto(sender, sendFd, payload.data(), payload.size(), 0, &receiveAddr, sizeof(receiveAddr));
+    EXPECT_GT(w, 0);
+    receiveDatagrams(2);
+    ASSERT_EQ(receivedMsgs.size(), 1);
+    EXPECT_EQ(receivedMsgs[0], payload);
+}
+
+TEST_F(LargeUdpTestSuite, PartialMessageIsDiscardedAfterTimeout) {
+    auto payload = createPayload(2 * MAX_PART_SIZE + 10);
+    sendFragment(PartHeader{7, (unsigned int)payload.size(), MAX_PART_SIZE, 0}, payload.substr(0, MAX_PART_SIZE));
+    sendFragment(PartHeader{7, (unsigned int)payload.size(), MAX_PART_SIZE, MAX_PART_SIZE}, payload.substr(MAX_PART_SIZE, MAX_PART_SIZE));
+    receiveDatagrams(2);
+    EXPECT_EQ(getStatistics(receiver).nrOfIncompleteMsgs, 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{PARTIAL_MSG_TIMEOUT_IN_MS * 3});
+
+    //the last part arrives too late, the partial message is discarded before the new datagrams are handled
+    sendFragment(PartHeader{7, (unsigned int)payload.size(), 10, 2 * MAX_PART_SIZE}, payload.substr(2 * MAX_PART_SIZE));
+    receiveDatagrams(1);
+
+    EXPECT_TRUE(receivedMsgs.empty());
+    auto stats = getStatistics(receiver);
+    EXPECT_EQ(stats.nrOfReceivedMsgs, 0);
+    EXPECT_EQ(stats.nrOfIncompleteMsgs, 1);
+    EXPECT_EQ(stats.nrOfIncompleteFragments, 2);
+}
+
+TEST_F(LargeUdpTestSuite, OldestPartialMessageIsDiscardedWhenReassemblyTableIsFull) {
+    //the receiver can reassemble 2 messages concurrently
+    auto payload = createPayload(MAX_PART_SIZE + 10);
+    for (unsigned int ident = 1; ident <= 3; ++ident) {
+        sendFragment(PartHeader{ident, (unsigned int)payload.size(), 10, MAX_PART_SIZE}, payload.substr(MAX_PART_SIZE));
+    }
+    receiveDatagrams(3);
+    auto stats = getStatistics(receiver);
+    EXPECT_EQ(stats.nrOfIncompleteMsgs, 1);
+    EXPECT_EQ(stats.nrOfIncompleteFragments, 1);
+
+    //message 1 is discarded, message 3 can still be completed
+    sendFragment(PartHeader{1, (unsigned int)payload.size(), MAX_PART_SIZE, 0}, payload.substr(0, MAX_PART_SIZE));
+    sendFragment(PartHeader{3, (unsigned int)payload.size(), MAX_PART_SIZE, 0}, payload.substr(0, MAX_PART_SIZE));
+    receiveDatagrams(2);
+    ASSERT_EQ(receivedMsgs.size(), 1);
+    EXPECT_EQ(receivedMsgs[0], payload);
+    stats = getStatistics(receiver);
+    EXPECT_EQ(stats.nrOfReceivedMsgs, 1);
+    //the new partial message 1 evicted the oldest, message 2
+    EXPECT_EQ(stats.nrOfIncompleteMsgs, 2);
+    EXPECT_EQ(stats.nrOfIncompleteFragments, 2);
+}
@@ -30,9 +30,11 @@
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <errno.h>
-#include <array_list.h>
+#include <time.h>
 #include <pthread.h>
+#include "celix_long_hash_map.h"
 
 #define MAX_UDP_MSG_SIZE        65535 /* 2^16 -1 */
 #define IP_HEADER_SIZE          20
@@ -40,29 +42,61 @@
 //#define MTU_SIZE                1500
 #define MTU_SIZE                8000
 #define MAX_MSG_VECTOR_LEN      64
+#define BATCH_SIZE              8 /* nr of datagrams per sendmmsg/recvmmsg call */
 
 //#define NO_IP_FRAGMENTATION
 
-struct largeUdp {
-    unsigned int maxNrLists;
-    array_list_pt udpPartLists;
-    pthread_mutex_t dbLock;
+#if defined(__APPLE__)
+// No sendmmsg/recvmmsg available, emulated with a sendmsg/recvmsg per datagram
+struct mmsghdr {
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
 };
+#endif
+
+typedef struct msg_part_header {
+    unsigned int msg_ident;
+    unsigned int total_msg_size;
+    unsigned int part_msg_size;
+    unsigned int offset;
+} msg_part_header_t;
 
 typedef struct udpPartList {
     unsigned int msg_ident;
     unsigned int msg_size;
+    unsigned int nrParts;
     unsigned int nrPartsRemaining;
+    struct timespec firstPartTime;
+    struct udpPartList *prev; // reception order, used for the timeout and to discard the oldest partial message
+    struct udpPartList *next;
+    uint8_t *receivedParts; // bitmap, to drop duplicated parts
     char *data;
 } udpPartList_t;
 
+typedef struct completed_msg {
+    char *data;
+    unsigned int size;
+} completed_msg_t;
 
-typedef struct msg_part_header {
-    unsigned int msg_ident;
-    unsigned int total_msg_size;
-    unsigned int part_msg_size;
-    unsigned int offset;
-} msg_part_header_t;
+struct largeUdp {
+    unsigned int maxNrLists;
+    long partialMsgTimeoutInMs;
+    pthread_mutex_t dbLock; // protects the reassembly administration and the statistics
+    celix_long_hash_map_t *udpPartLists; // key = msg ident, value = udpPartList_t*
+    udpPartList_t *oldest;
+    udpPartList_t *newest;
+    largeUdp_statistics_t stats;
+
+    // Receive batch, allocated on first use. Only used by the thread calling largeUdp_receiveBatch
+    struct mmsghdr *recvMsgs;
+    struct iovec *recvIovecs;
+    char *recvBuffers;
+
+    pthread_mutex_t sendLock; // protects the send batch
+    struct mmsghdr sendMsgs[BATCH_SIZE];
+    msg_part_header_t sendHeaders[BATCH_SIZE];
+    struct iovec sendIovecs[BATCH_SIZE][MAX_MSG_VECTOR_LEN];
+};
 
 #ifdef NO_IP_FRAGMENTATION
 #define MAX_PART_SIZE   (MTU_SIZE - (IP_HEADER_SIZE + UDP_HEADER_SIZE + sizeof(struct msg_part_header) ))
@@ -70,25 +104,60 @@ typedef struct msg_part_header {
 #define MAX_PART_SIZE   (MAX_UDP_MSG_SIZE - (IP_HEADER_SIZE + UDP_HEADER_SIZE + sizeof(struct msg_part_header) ))
 #endif
 
+#if defined(__APPLE__)
+static int sendmmsg(int fd, struct mmsghdr *msgs, unsigned int len, int flags) {
+    unsigned int i;
+    for (i = 0; i < len; i++) {
+        ssize_t w = sendmsg(fd, &msgs[i].msg_hdr, flags);
+        if (w == -1) {
+            return i == 0 ? -1 : (int)i;
+        }
+        msgs[i].msg_len = (unsigned int)w;
+    }
+    return (int)i;
+}
+
+static int recvmmsg(int fd, struct mmsghdr *msgs, unsigned int len, int flags, struct timespec *timeout __attribute__((unused))) {
+    unsigned int i;
+    for (i = 0; i < len; i++) {
+        ssize_t r = recvmsg(fd, &msgs[i].msg_hdr, flags);
+        if (r == -1) {
+            return i == 0 ? -1 : (int)i;
+        }
+        msgs[i].msg_len = (unsigned int)r;
+    }
+    return (int)i;
+}
+#endif
+
 //
 // Create a handle
 //
-largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions)
+largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions, long partialMsgTimeoutInMs)
 {
     printf("## Creating large UDP\n");
     largeUdp_t *handle = calloc(sizeof(*handle), 1);
     if (handle != NULL) {
         handle->maxNrLists = maxNrUdpReceptions;
-        if (arrayList_create(&handle->udpPartLists) != CELIX_SUCCESS) {
+        handle->partialMsgTimeoutInMs = partialMsgTimeoutInMs;
+        handle->udpPartLists = celix_longHashMap_create();
+        if (handle->udpPartLists == NULL) {
             free(handle);
-            handle = NULL;
+            return NULL;
         }
         pthread_mutex_init(&handle->dbLock, 0);
+        pthread_mutex_init(&handle->sendLock, 0);
     }
 
     return handle;
 }
 
+static void largeUdp_freePartList(udpPartList_t *udpPartList) {
+    free(udpPartList->receivedParts);
+    free(udpPartList->data);
+    free(udpPartList);
+}
+
 //
 // Destroys the handle
 //
@@ -97,26 +166,52 @@ void largeUdp_destroy(largeUdp_t *handle)
     printf("### Destroying large UDP\n");
     if (handle != NULL) {
         pthread_mutex_lock(&handle->dbLock);
-        int nrUdpLists = arrayList_size(handle->udpPartLists);
-        int i;
-        for (i=0; i < nrUdpLists; i++) {
-            udpPartList_t *udpPartList = arrayList_remove(handle->udpPartLists, i);
-            if (udpPartList) {
-                if (udpPartList->data) {
-                    free(udpPartList->data);
-                    udpPartList->data = NULL;
-                }
-                free(udpPartList);
-            }
+        udpPartList_t *udpPartList = handle->oldest;
+        while (udpPartList != NULL) {
+            udpPartList_t *next = udpPartList->next;
+            largeUdp_freePartList(udpPartList);
+            udpPartList = next;
         }
-        arrayList_destroy(handle->udpPartLists);
+        celix_longHashMap_destroy(handle->udpPartLists);
         handle->udpPartLists = NULL;
         pthread_mutex_unlock(&handle->dbLock);
         pthread_mutex_destroy(&handle->dbLock);
+        pthread_mutex_destroy(&handle->sendLock);
+        free(handle->recvMsgs);
+        free(handle->recvIovecs);
+        free(handle->recvBuffers);
         free(handle);
     }
 }
 
+//
+// Sends the first nrOfMsgs prepared datagrams of the send batch. Must be called with the sendLock locked.
+//
+static int largeUdp_flushSendBatch(largeUdp_t *handle, int fd, unsigned int nrOfMsgs, int flags)
+{
+    int written = 0;
+    unsigned int sent = 0;
+    while (sent < nrOfMsgs) {
+        int n = sendmmsg(fd, &handle->sendMsgs[sent], nrOfMsgs - sent, flags);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("sendmmsg()");
+            return -1;
+        }
+        pthread_mutex_lock(&handle->dbLock);
+        handle->stats.nrOfSendSyscalls += 1;
+        handle->stats.nrOfSentDatagrams += (unsigned long)n;
+        pthread_mutex_unlock(&handle->dbLock);
+        for (int i = 0; i < n; i++) {
+            written += (int)handle->sendMsgs[sent + i].msg_len;
+        }
+        sent += (unsigned int)n;
+    }
+    return written;
+}
+
 //
 // Write large data to UDP. This function splits the data in chunks and sends these chunks with a header over UDP.
 //
@@ -124,68 +219,68 @@ int largeUdp_sendmsg(largeUdp_t *handle, int fd, struct iovec *largeMsg_iovec, i
 {
     int n;
     int result = 0;
-    msg_part_header_t header;
-
     int written = 0;
-    header.msg_ident = (unsigned int)random();
-    header.total_msg_size = 0;
+    unsigned int msg_ident = (unsigned int)random();
+    unsigned int total_msg_size = 0;
     for (n = 0; n < len ;n++) {
-        header.total_msg_size += largeMsg_iovec[n].iov_len;
+        total_msg_size += largeMsg_iovec[n].iov_len;
     }
-    int nr_buffers = (header.total_msg_size / MAX_PART_SIZE) + 1;
-
-    struct iovec msg_iovec[MAX_MSG_VECTOR_LEN];
-    struct msghdr msg;
-    msg.msg_name = dest_addr;
-    msg.msg_namelen = addrlen;
-    msg.msg_flags = 0;
-    msg.msg_iov = msg_iovec;
-    msg.msg_iovlen = 2; // header and payload;
-    msg.msg_control = NULL;
-    msg.msg_controllen = 0;
-
-    msg.msg_iov[0].iov_base = &header;
-    msg.msg_iov[0].iov_len = sizeof(header);
+    int nr_buffers = (total_msg_size / MAX_PART_SIZE) + 1;
 
+    pthread_mutex_lock(&handle->sendLock);
+    int recvPart = 0;
+    unsigned int remainingOffset = 0;
+    unsigned int slot = 0;
     for (n = 0; n < nr_buffers; n++) {
-
-        header.part_msg_size = (((header.total_msg_size - n * MAX_PART_SIZE) >  MAX_PART_SIZE) ?  MAX_PART_SIZE  : (header.total_msg_size - n * MAX_PART_SIZE));
-        header.offset = n * MAX_PART_SIZE;
-        int remainingOffset = header.offset;
-        int recvPart = 0;
-        // find the start of the part
-        while (remainingOffset > largeMsg_iovec[recvPart].iov_len) {
-            remainingOffset -= largeMsg_iovec[recvPart].iov_len;
-            recvPart++;
-        }
-        int remainingData = header.part_msg_size;
-        int sendPart = 1;
-        msg.msg_iovlen = 1;
+        msg_part_header_t *header = &handle->sendHeaders[slot];
+        header->msg_ident = msg_ident;
+        header->total_msg_size = total_msg_size;
+        header->part_msg_size = (((total_msg_size - n * MAX_PART_SIZE) >  MAX_PART_SIZE) ?  MAX_PART_SIZE  : (total_msg_size - n * MAX_PART_SIZE));
+        header->offset = n * MAX_PART_SIZE;
+
+        struct msghdr *msg = &handle->sendMsgs[slot].msg_hdr;
+        memset(msg, 0, sizeof(*msg));
+        msg->msg_name = dest_addr;
+        msg->msg_namelen = addrlen;
+        msg->msg_iov = handle->sendIovecs[slot];
+        msg->msg_iov[0].iov_base = header;
+        msg->msg_iov[0].iov_len = sizeof(*header);
+        msg->msg_iovlen = 1;
 
         // fill in the output iovec from the input iovec in such a way that all UDP frames are filled maximal.
-        while (remainingData > 0) {
-            int partLen = ( (largeMsg_iovec[recvPart].iov_len - remainingOffset) <= remainingData ? (largeMsg_iovec[recvPart].iov_len -remainingOffset) : remainingData);
-            msg.msg_iov[sendPart].iov_base = largeMsg_iovec[recvPart].iov_base + remainingOffset;
-            msg.msg_iov[sendPart].iov_len = partLen;
+        // The parts are consecutive, so the input position continues where the previous part ended.
+        unsigned int remainingData = header->part_msg_size;
+        while (remainingData > 0 && recvPart < len && msg->msg_iovlen < MAX_MSG_VECTOR_LEN) {
+            unsigned int available = largeMsg_iovec[recvPart].iov_len - remainingOffset;
+            unsigned int partLen = available <= remainingData ? available : remainingData;
+            msg->msg_iov[msg->msg_iovlen].iov_base = (char*)largeMsg_iovec[recvPart].iov_base + remainingOffset;
+            msg->msg_iov[msg->msg_iovlen].iov_len = partLen;
+            msg->msg_iovlen++;
             remainingData -= partLen;
-            remainingOffset = 0;
-            sendPart++;
-            recvPart++;
-            msg.msg_iovlen++;
+            remainingOffset += partLen;
+            if (remainingOffset == largeMsg_iovec[recvPart].iov_len) {
+                remainingOffset = 0;
+                recvPart++;
+            }
         }
-        int tmp, tmptot;
-        for (tmp = 0, tmptot=0; tmp < msg.msg_iovlen; tmp++) {
-            tmptot += msg.msg_iov[tmp].iov_len;
+        if (remainingData > 0) {
+            fprintf(stderr, "ERROR: Cannot send large UDP msg, too many input iovecs\n");
+            result = -1;
+            break;
         }
 
-        int w = sendmsg(fd, &msg, 0);
-        if (w == -1) {
-            perror("send()");
-            result =  -1;
-            break;
+        slot++;
+        if (slot == BATCH_SIZE || n == nr_buffers - 1) {
+            int w = largeUdp_flushSendBatch(handle, fd, slot, flags);
+            if (w == -1) {
+                result = -1;
+                break;
+            }
+            written += w;
+            slot = 0;
         }
-        written += w;
     }
+    pthread_mutex_unlock(&handle->sendLock);
 
     return (result == 0 ? written : result);
 }
@@ -195,172 +290,181 @@ int largeUdp_sendmsg(largeUdp_t *handle, int fd, struct iovec *largeMsg_iovec, i
 //
 int largeUdp_sendto(largeUdp_t *handle, int fd, void *buf, size_t count, int flags, struct sockaddr_in *dest_addr, size_t addrlen)
 {
-    int n;
-    int nr_buffers = (count / MAX_PART_SIZE) + 1;
-    int result = 0;
-    msg_part_header_t header;
-
-    int written = 0;
-    header.msg_ident = (unsigned int)random();
-    header.total_msg_size = count;
-    char *databuf = buf;
-
-    struct iovec msg_iovec[2];
-    struct msghdr msg;
-    msg.msg_name = dest_addr;
-    msg.msg_namelen = addrlen;
-    msg.msg_flags = 0;
-    msg.msg_iov = msg_iovec;
-    msg.msg_iovlen = 2; // header and payload;
-    msg.msg_control = NULL;
-    msg.msg_controllen = 0;
-
-    msg.msg_iov[0].iov_base = &header;
-    msg.msg_iov[0].iov_len = sizeof(header);
+    struct iovec msg_iovec;
+    msg_iovec.iov_base = buf;
+    msg_iovec.iov_len = count;
+    return largeUdp_sendmsg(handle, fd, &msg_iovec, 1, flags, dest_addr, addrlen);
+}
 
-    for (n = 0; n < nr_buffers; n++) {
+static long largeUdp_elapsedInMs(const struct timespec *start, const struct timespec *now) {
+    return (now->tv_sec - start->tv_sec) * 1000 + (now->tv_nsec - start->tv_nsec) / 1000000;
+}
 
-        header.part_msg_size = (((header.total_msg_size - n * MAX_PART_SIZE) >  MAX_PART_SIZE) ?  MAX_PART_SIZE  : (header.total_msg_size - n * MAX_PART_SIZE));
-        header.offset = n * MAX_PART_SIZE;
-        msg.msg_iov[1].iov_base = &databuf[header.offset];
-        msg.msg_iov[1].iov_len = header.part_msg_size;
-        int w = sendmsg(fd, &msg, 0);
-        if (w == -1) {
-            perror("send()");
-            result =  -1;
-            break;
-        }
-        written += w;
-        //usleep(1000); // TODO: If not slept a UDP buffer overflow occurs and parts are missing at the reception side (at least via localhost)
+//
+// Removes a part list from the reassembly administration. Must be called with the dbLock locked.
+//
+static void largeUdp_removePartList(largeUdp_t *handle, udpPartList_t *udpPartList) {
+    celix_longHashMap_remove(handle->udpPartLists, udpPartList->msg_ident);
+    if (udpPartList->prev != NULL) {
+        udpPartList->prev->next = udpPartList->next;
+    } else {
+        handle->oldest = udpPartList->next;
     }
+    if (udpPartList->next != NULL) {
+        udpPartList->next->prev = udpPartList->prev;
+    } else {
+        handle->newest = udpPartList->prev;
+    }
+    udpPartList->prev = NULL;
+    udpPartList->next = NULL;
+}
 
-    return (result == 0 ? written : result);
+//
+// Discards a partially received message. Must be called with the dbLock locked.
+//
+static void largeUdp_discardPartList(largeUdp_t *handle, udpPartList_t *udpPartList) {
+    largeUdp_removePartList(handle, udpPartList);
+    handle->stats.nrOfIncompleteMsgs += 1;
+    handle->stats.nrOfIncompleteFragments += udpPartList->nrParts - udpPartList->nrPartsRemaining;
+    largeUdp_freePartList(udpPartList);
 }
 
 //
-// Reads data from the filedescriptor which has date (determined by epoll()) and stores it in the internal structure
-// If the message is completely reassembled true is returned and the index and size have valid values
+// Stores a received datagram in the reassembly administration. Must be called with the dbLock locked.
+// Returns true if the message is complete, in which case the completed message is owned by the caller.
 //
-bool largeUdp_dataAvailable(largeUdp_t *handle, int fd, unsigned int *index, unsigned int *size) {
+static bool largeUdp_handleFragment(largeUdp_t *handle, const char *datagram, size_t datagramSize, const struct timespec *now, completed_msg_t *completed) {
     msg_part_header_t header;
-    int result = false;
-    // Only read the header, we don't know yet where to store the payload
-    if (recv(fd, &header, sizeof(header), MSG_PEEK) < 0) {
-        perror("read()");
+    if (datagramSize < sizeof(header)) {
+        handle->stats.nrOfDroppedFragments += 1;
+        return false;
+    }
+    memcpy(&header, datagram, sizeof(header));
+    const char *payload = datagram + sizeof(header);
+    unsigned int nrParts = (header.total_msg_size / MAX_PART_SIZE) + 1;
+    unsigned int partIndex = header.offset / MAX_PART_SIZE;
+    unsigned int expectedPartSize = header.offset > header.total_msg_size ? 0 :
+            (header.total_msg_size - header.offset > MAX_PART_SIZE ? MAX_PART_SIZE : header.total_msg_size - header.offset);
+    if (header.part_msg_size != datagramSize - sizeof(header) || header.offset % MAX_PART_SIZE != 0 ||
+        header.offset > header.total_msg_size || header.part_msg_size != expectedPartSize) {
+        handle->stats.nrOfDroppedFragments += 1;
         return false;
     }
 
-    struct iovec msg_vec[2];
-    struct msghdr msg;
-    msg.msg_name = NULL;
-    msg.msg_namelen = 0;
-    msg.msg_flags = 0;
-    msg.msg_iov = msg_vec;
-    msg.msg_iovlen = 2; // header and payload;
-    msg.msg_control = NULL;
-    msg.msg_controllen = 0;
-
-    msg.msg_iov[0].iov_base = &header;
-    msg.msg_iov[0].iov_len = sizeof(header);
-
-    pthread_mutex_lock(&handle->dbLock);
-
-    int nrUdpLists = arrayList_size(handle->udpPartLists);
-    int i;
-    bool found = false;
-    for (i = 0; i < nrUdpLists; i++) {
-        udpPartList_t *udpPartList = arrayList_get(handle->udpPartLists, i);
-        if (udpPartList->msg_ident == header.msg_ident) {
-            found = true;
-
-            //sanity check
-            if (udpPartList->msg_size != header.total_msg_size) {
-                // Corruption occurred. Remove the existing administration and build up a new one.
-                arrayList_remove(handle->udpPartLists, i);
-                free(udpPartList->data);
-                free(udpPartList);
-                found = false;
-                break;
-            }
-
-            msg.msg_iov[1].iov_base = &udpPartList->data[header.offset];
-            msg.msg_iov[1].iov_len = header.part_msg_size;
-            if (recvmsg(fd, &msg, 0)<0) {
-                found=true;
-                result=false;
-                break;
-            }
+    if (nrParts == 1) {
+        // Not fragmented, no reassembly needed
+        completed->data = malloc(header.total_msg_size == 0 ? 1 : header.total_msg_size);
+        memcpy(completed->data, payload, header.part_msg_size);
+        completed->size = header.total_msg_size;
+        return true;
+    }
 
-            udpPartList->nrPartsRemaining--;
-            if (udpPartList->nrPartsRemaining == 0) {
-                *index = i;
-                *size = udpPartList->msg_size;
-                result = true;
-                break;
-            } else {
-                result = false; // not complete
-                break;
-            }
-        }
+    udpPartList_t *udpPartList = celix_longHashMap_get(handle->udpPartLists, header.msg_ident);
+    if (udpPartList != NULL && udpPartList->msg_size != header.total_msg_size) {
+        // Corruption occurred. Remove the existing administration and build up a new one.
+        largeUdp_discardPartList(handle, udpPartList);
+        udpPartList = NULL;
     }
 
-    if (found == false) {
-        udpPartList_t *udpPartList = NULL;
-        if (nrUdpLists == handle->maxNrLists) {
-            // remove list at index 0
-            udpPartList = arrayList_remove(handle->udpPartLists, 0);
-            fprintf(stderr, "ERROR: Removing entry for id %d: %d parts not received\n",udpPartList->msg_ident, udpPartList->nrPartsRemaining );
-            free(udpPartList->data);
-            free(udpPartList);
-            nrUdpLists--;
+    if (udpPartList == NULL) {
+        if (handle->oldest != NULL && celix_longHashMap_size(handle->udpPartLists) >= handle->maxNrLists) {
+            largeUdp_discardPartList(handle, handle->oldest);
         }
         udpPartList = calloc(sizeof(*udpPartList), 1);
-        udpPartList->msg_ident =  header.msg_ident;
-        udpPartList->msg_size =  header.total_msg_size;
-        udpPartList->nrPartsRemaining = header.total_msg_size / MAX_PART_SIZE;
+        udpPartList->msg_ident = header.msg_ident;
+        udpPartList->msg_size = header.total_msg_size;
+        udpPartList->nrParts = nrParts;
+        udpPartList->nrPartsRemaining = nrParts;
+        udpPartList->firstPartTime = *now;
+        udpPartList->receivedParts = calloc((nrParts + 7) / 8, 1);
         udpPartList->data = calloc(sizeof(char), header.total_msg_size);
-
-        msg.msg_iov[1].iov_base = &udpPartList->data[header.offset];
-        msg.msg_iov[1].iov_len = header.part_msg_size;
-        if (recvmsg(fd, &msg, 0)<0) {
-            free(udpPartList->data);
-            free(udpPartList);
-            result=false;
+        udpPartList->prev = handle->newest;
+        if (handle->newest != NULL) {
+            handle->newest->next = udpPartList;
         } else {
-            arrayList_add(handle->udpPartLists, udpPartList);
-
-            if (udpPartList->nrPartsRemaining == 0) {
-                *index = nrUdpLists;
-                *size = udpPartList->msg_size;
-                result = true;
-            } else {
-                result = false;
-            }
+            handle->oldest = udpPartList;
         }
-
+        handle->newest = udpPartList;
+        celix_longHashMap_put(handle->udpPartLists, header.msg_ident, udpPartList);
     }
 
-    pthread_mutex_unlock(&handle->dbLock);
+    uint8_t partBit = (uint8_t)(1u << (partIndex % 8));
+    if ((udpPartList->receivedParts[partIndex / 8] & partBit) != 0) {
+        handle->stats.nrOfDroppedFragments += 1;
+        return false;
+    }
+    udpPartList->receivedParts[partIndex / 8] |= partBit;
+    memcpy(&udpPartList->data[header.offset], payload, header.part_msg_size);
 
-    return result;
+    udpPartList->nrPartsRemaining--;
+    if (udpPartList->nrPartsRemaining > 0) {
+        return false; // not complete
+    }
+    largeUdp_removePartList(handle, udpPartList);
+    completed->data = udpPartList->data;
+    completed->size = udpPartList->msg_size;
+    udpPartList->data = NULL;
+    largeUdp_freePartList(udpPartList);
+    return true;
 }
 
 //
-// Read out the message which is indicated available by the largeUdp_dataAvailable function
+// Reads the datagrams from the filedescriptor which has data (determined by epoll()) and reassembles the messages.
 //
-int largeUdp_read(largeUdp_t *handle, unsigned int index, void ** buffer, unsigned int size)
-{
-    int result = 0;
-    pthread_mutex_lock(&handle->dbLock);
+int largeUdp_receiveBatch(largeUdp_t *handle, int fd, largeUdp_receive_callback_fp callback, void *callbackHandle) {
+    if (handle->recvMsgs == NULL) {
+        handle->recvMsgs = calloc(BATCH_SIZE, sizeof(*handle->recvMsgs));
+        handle->recvIovecs = calloc(BATCH_SIZE, sizeof(*handle->recvIovecs));
+        handle->recvBuffers = malloc((size_t)BATCH_SIZE * MAX_UDP_MSG_SIZE);
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            handle->recvIovecs[i].iov_base = &handle->recvBuffers[(size_t)i * MAX_UDP_MSG_SIZE];
+            handle->recvIovecs[i].iov_len = MAX_UDP_MSG_SIZE;
+        }
+    }
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        memset(&handle->recvMsgs[i], 0, sizeof(handle->recvMsgs[i]));
+        handle->recvMsgs[i].msg_hdr.msg_iov = &handle->recvIovecs[i];
+        handle->recvMsgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
-    udpPartList_t *udpPartList = arrayList_remove(handle->udpPartLists, index);
-    if (udpPartList) {
-        *buffer = udpPartList->data;
-        free(udpPartList);
-    } else {
-        result = -1;
+    int n = recvmmsg(fd, handle->recvMsgs, BATCH_SIZE, MSG_DONTWAIT, NULL);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        perror("recvmmsg()");
+        return -1;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    completed_msg_t completed[BATCH_SIZE];
+    int nrOfCompleted = 0;
+
+    pthread_mutex_lock(&handle->dbLock);
+    handle->stats.nrOfReceiveSyscalls += 1;
+    handle->stats.nrOfReceivedDatagrams += (unsigned long)n;
+    while (handle->oldest != NULL && largeUdp_elapsedInMs(&handle->oldest->firstPartTime, &now) > handle->partialMsgTimeoutInMs) {
+        largeUdp_discardPartList(handle, handle->oldest);
     }
+    for (int i = 0; i < n; i++) {
+        if ((handle->recvMsgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+            handle->stats.nrOfDroppedFragments += 1;
+        } else if (largeUdp_handleFragment(handle, handle->recvIovecs[i].iov_base, handle->recvMsgs[i].msg_len, &now, &completed[nrOfCompleted])) {
+            nrOfCompleted++;
+        }
+    }
+    handle->stats.nrOfReceivedMsgs += (unsigned long)nrOfCompleted;
     pthread_mutex_unlock(&handle->dbLock);
 
-    return result;
+    for (int i = 0; i < nrOfCompleted; i++) {
+        callback(callbackHandle, completed[i].data, completed[i].size);
+    }
+    return n;
+}
+
+void largeUdp_getStatistics(largeUdp_t *handle, largeUdp_statistics_t *stats) {
+    pthread_mutex_lock(&handle->dbLock);
+    *stats = handle->stats;
+    pthread_mutex_unlock(&handle->dbLock);
 }
@@ -35,12 +35,49 @@
 
 typedef struct largeUdp largeUdp_t;
 
-largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions);
+/**
+ * Statistics of a large UDP handle. The receive statistics are only updated by largeUdp_receiveBatch.
+ */
+typedef struct largeUdp_statistics {
+    unsigned long nrOfSendSyscalls;
+    unsigned long nrOfSentDatagrams;
+    unsigned long nrOfReceiveSyscalls;
+    unsigned long nrOfReceivedDatagrams;
+    unsigned long nrOfReceivedMsgs; // completely reassembled messages
+    unsigned long nrOfDroppedFragments; // truncated, invalid or duplicate datagrams
+    unsigned long nrOfIncompleteMsgs; // partial messages discarded because of a timeout or a full reassembly table
+    unsigned long nrOfIncompleteFragments; // received fragments of the discarded partial messages
+} largeUdp_statistics_t;
+
+/**
+ * Callback for a completely reassembled message. The callback takes ownership of the msg buffer and must free it.
+ */
+typedef void (*largeUdp_receive_callback_fp)(void *handle, void *msg, unsigned int size);
+
+/**
+ * Creates a large UDP handle.
+ * @param maxNrUdpReceptions The maximum number of messages which can be reassembled concurrently.
+ * @param partialMsgTimeoutInMs The time after which a partially received message is discarded.
+ */
+largeUdp_t *largeUdp_create(unsigned int maxNrUdpReceptions, long partialMsgTimeoutInMs);
 void largeUdp_destroy(largeUdp_t *handle);
 
 int largeUdp_sendto(largeUdp_t *handle, int fd, void *buf, size_t count, int flags, struct sockaddr_in *dest_addr, size_t addrlen);
+
+/**
+ * Splits the data in parts, each sent as a datagram with a part header. The datagrams are sent in batches
+ * using sendmmsg.
+ * @return The number of bytes written (including the part headers) or -1 on error.
+ */
 int largeUdp_sendmsg(largeUdp_t *handle, int fd, struct iovec *largeMsg_iovec, int len, int flags, struct sockaddr_in *dest_addr, size_t addrlen);
-bool largeUdp_dataAvailable(largeUdp_t *handle, int fd, unsigned int *index, unsigned int *size);
-int largeUdp_read(largeUdp_t *handle, unsigned int index, void ** buffer, unsigned int size);
+
+/**
+ * Reads the available datagrams from a non-blocking read of the file descriptor, using a single recvmmsg call,
+ * and reassembles them. The callback is called for every completed message, outside the internal lock.
+ * @return The number of datagrams read, 0 if no data was available or -1 on error.
+ */
+int largeUdp_receiveBatch(largeUdp_t *handle, int fd, largeUdp_receive_callback_fp callback, void *callbackHandle);
+
+void largeUdp_getStatistics(largeUdp_t *handle, largeUdp_statistics_t *stats);
 
 #endif /* _LARGE_UDP_H_ */
@@ -73,4 +73,11 @@
  */
 #define PUBSUB_UDPMC_STATIC_CONNECT_URLS_FOR "PSA_UDPMC_STATIC_CONNECT_URLS_FOR_"
 
+/**
+ * Can be set in the topic properties to configure the time (in ms) after which a topic receiver discards
+ * a partially received (fragmented) message.
+ */
+#define PUBSUB_UDPMC_PARTIAL_MSG_TIMEOUT_KEY            "udpmc.partial.msg.timeout.ms"
+#define PUBSUB_UDPMC_PARTIAL_MSG_TIMEOUT_DEFAULT        1000
+
 #endif /* PUBSUB_PSA_UDPMC_CONSTANTS_H_ */
@@ -586,6 +586,12 @@ bool pubsub_udpmcAdmin_executeCommand(void *handle, const char *commandLine __at
             free(conn);
         }
         celix_arrayList_destroy(connections);
+        largeUdp_statistics_t stats;
+        pubsub_udpmcTopicReceiver_getStatistics(receiver, &stats);
+        fprintf(out, "   |- received datagrams         = %lu (in %lu receive calls)\n", stats.nrOfReceivedDatagrams, stats.nrOfReceiveSyscalls);
+        fprintf(out, "   |- received msgs              = %lu\n", stats.nrOfReceivedMsgs);
+        fprintf(out, "   |- dropped fragments          = %lu\n", stats.nrOfDroppedFragments);
+        fprintf(out, "   |- incomplete msgs/fragments  = %lu/%lu\n", stats.nrOfIncompleteMsgs, stats.nrOfIncompleteFragments);
     }
     celixThreadMutex_unlock(&psa->topicReceivers.mutex);
     celixThreadMutex_unlock(&psa->serializers.mutex);
@@ -110,6 +110,7 @@ typedef struct pubsub_udp_msg {
 static void pubsub_udpmcTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
 static void pubsub_udpmcTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props, const celix_bundle_t *owner);
 static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub_udp_msg_t *msg);
+static void psa_udpmc_receiveMsg(void *handle, void *msg, unsigned int size);
 static void* psa_udpmc_recvThread(void * data);
 static void psa_udpmc_connectToAllRequestedConnections(pubsub_udpmc_topic_receiver_t *receiver);
 static void psa_udpmc_initializeAllSubscribers(pubsub_udpmc_topic_receiver_t *receiver);
@@ -131,7 +132,8 @@ pubsub_udpmc_topic_receiver_t* pubsub_udpmcTopicReceiver_create(celix_bundle_con
     receiver->topic = strndup(topic, 1024 * 1024);
     receiver->ifIpAddress = strndup(ifIP, 1024 * 1024);
     receiver->recvThread.running = true;
-    receiver->largeUdpHandle = largeUdp_create(MAX_UDP_SESSIONS);
+    long partialMsgTimeout = celix_properties_getAsLong(topicProperties, PUBSUB_UDPMC_PARTIAL_MSG_TIMEOUT_KEY, PUBSUB_UDPMC_PARTIAL_MSG_TIMEOUT_DEFAULT);
+    receiver->largeUdpHandle = largeUdp_create(MAX_UDP_SESSIONS, partialMsgTimeout);
 #if defined(__APPLE__)
     receiver->topicEpollFd = kqueue();
 #else
@@ -429,25 +431,12 @@ static void* psa_udpmc_recvThread(void * data) {
 #endif
         int i;
         for (i = 0; i < nfds; i++ ) {
-            unsigned int index;
-            unsigned int size;
 #if defined(__APPLE__)
             int fd = events[i].ident;
 #else
             int fd = events[i].data.fd;
 #endif
-            if (largeUdp_dataAvailable(receiver->largeUdpHandle, fd, &index, &size) == true) {
-                // Handle data
-                pubsub_udp_msg_t *udpMsg = NULL;
-                if (largeUdp_read(receiver->largeUdpHandle, index, (void**) &udpMsg, size) != 0) {
-                    printf("[PSA_UDPMC]: ERROR largeUdp_read with index %d\n", index);
-                    continue;
-                }
-
-                psa_udpmc_processMsg(receiver, udpMsg);
-
-                free(udpMsg);
-            }
+            largeUdp_receiveBatch(receiver->largeUdpHandle, fd, psa_udpmc_receiveMsg, receiver);
         }
 
         celixThreadMutex_lock(&receiver->recvThread.mutex);
@@ -466,6 +455,12 @@ static void* psa_udpmc_recvThread(void * data) {
     return NULL;
 }
 
+static void psa_udpmc_receiveMsg(void *handle, void *msg, unsigned int size __attribute__((unused))) {
+    pubsub_udpmc_topic_receiver_t *receiver = handle;
+    psa_udpmc_processMsg(receiver, msg);
+    free(msg);
+}
+
 static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub_udp_msg_t *msg) {
     celixThreadMutex_lock(&receiver->subscribers.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
@@ -525,6 +520,10 @@ static void psa_udpmc_processMsg(pubsub_udpmc_topic_receiver_t *receiver, pubsub
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
 
+void pubsub_udpmcTopicReceiver_getStatistics(pubsub_udpmc_topic_receiver_t *receiver, largeUdp_statistics_t *stats) {
+    largeUdp_getStatistics(receiver->largeUdpHandle, stats);
+}
+
 void pubsub_udpmcTopicReceiver_listConnections(pubsub_udpmc_topic_receiver_t *receiver, celix_array_list_t *connections) {
     celixThreadMutex_lock(&receiver->requestedConnections.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->requestedConnections.map);
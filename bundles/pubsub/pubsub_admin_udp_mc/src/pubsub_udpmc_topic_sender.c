@@ -235,7 +235,7 @@ static void* psa_udpmc_getPublisherService(void *handle, const celix_bundle_t *r
         entry->getCount = 1;
         entry->parent = sender;
         entry->bndId = bndId;
-        entry->largeUdpHandle = largeUdp_create(1);
+        entry->largeUdpHandle = largeUdp_create(1, PUBSUB_UDPMC_PARTIAL_MSG_TIMEOUT_DEFAULT);
         entry->msgTypeIds = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
 
         int rc = sender->serializer->createSerializerMap(sender->serializer->handle, (celix_bundle_t*)requestingBundle, &entry->msgTypes);
@@ -51,4 +51,14 @@
  */
 #define PUBSUB_WEBSOCKET_STATIC_CONNECT_SOCKET_ADDRESSES_FOR "PUBSUB_WEBSOCKET_STATIC_CONNECT_SOCKET_ADDRESSES_FOR_"
 
+/**
+ * Topic property to send the messages of a topic as binary websocket frames.
+ * A binary frame carries a small binary header (msg fqn, version and seqNr) followed by the serialized message as-is,
+ * so that topics using a non-JSON serializer (e.g. avrobin) can be used with websocket.
+ * If false (default) the messages are sent as JSON text frames, which requires a JSON serializer.
+ * Topic receivers accept both frame types.
+ */
+#define PUBSUB_WEBSOCKET_BINARY_FRAMES_KEY                  "websocket.binary.frames"
+#define PUBSUB_WEBSOCKET_BINARY_FRAMES_DEFAULT              false
+
 #endif /* PUBSUB_PSA_WEBSOCKET_CONSTANTS_H_ */
@@ -228,7 +228,7 @@ celix_status_t pubsub_websocketAdmin_setupTopicSender(void *handle, const char *
     celixThreadMutex_lock(&psa->topicSenders.mutex);
     pubsub_websocket_topic_sender_t *sender = hashMap_get(psa->topicSenders.map, key);
     if (sender == NULL) {
-        sender = pubsub_websocketTopicSender_create(psa->ctx, psa->log, scope, topic, handler, psa);
+        sender = pubsub_websocketTopicSender_create(psa->ctx, psa->log, scope, topic, topicProperties, handler, psa);
         if (sender != NULL) {
             const char *psaType = PUBSUB_WEBSOCKET_ADMIN_TYPE;
             newEndpoint = pubsubEndpoint_create(psa->fwUUID, scope, topic, PUBSUB_PUBLISHER_ENDPOINT_TYPE, psaType,
@@ -20,6 +20,7 @@
 #include <memory.h>
 #include <assert.h>
 #include <stdio.h>
+#include <arpa/inet.h>
 #include "pubsub_websocket_common.h"
 
 bool psa_websocket_checkVersion(version_pt msgVersion, const pubsub_websocket_msg_header_t *hdr) {
@@ -66,3 +67,53 @@ char *psa_websocket_createURI(const char *scope, const char *topic) {
     }
     return uri;
 }
+
+size_t psa_websocket_binaryHeaderSize(const pubsub_websocket_msg_header_t *hdr) {
+    return PSA_WEBSOCKET_BINARY_HEADER_SIZE + strlen(hdr->fqn) + 1;
+}
+
+void psa_websocket_encodeBinaryHeader(const pubsub_websocket_msg_header_t *hdr, uint32_t payloadSize, char *buf) {
+    size_t fqnSize = strlen(hdr->fqn) + 1;
+    uint32_t sync = htonl(PSA_WEBSOCKET_BINARY_SYNC);
+    uint32_t seqNr = htonl(hdr->seqNr);
+    uint16_t nFqnSize = htons((uint16_t)fqnSize);
+    uint32_t nPayloadSize = htonl(payloadSize);
+    memcpy(buf, &sync, 4);
+    buf[4] = PSA_WEBSOCKET_BINARY_HEADER_VERSION;
+    buf[5] = (char)hdr->major;
+    buf[6] = (char)hdr->minor;
+    buf[7] = 0;
+    memcpy(buf + 8, &seqNr, 4);
+    memcpy(buf + 12, &nFqnSize, 2);
+    memset(buf + 14, 0, 2);
+    memcpy(buf + 16, &nPayloadSize, 4);
+    memcpy(buf + PSA_WEBSOCKET_BINARY_HEADER_SIZE, hdr->fqn, fqnSize);
+}
+
+bool psa_websocket_decodeBinaryFrame(const char *data, size_t size, pubsub_websocket_msg_header_t *hdr, const char **payload, size_t *payloadSize) {
+    if (size < PSA_WEBSOCKET_BINARY_HEADER_SIZE) {
+        return false;
+    }
+    uint32_t sync;
+    uint32_t seqNr;
+    uint16_t fqnSize;
+    uint32_t nPayloadSize;
+    memcpy(&sync, data, 4);
+    memcpy(&seqNr, data + 8, 4);
+    memcpy(&fqnSize, data + 12, 2);
+    memcpy(&nPayloadSize, data + 16, 4);
+    fqnSize = ntohs(fqnSize);
+    nPayloadSize = ntohl(nPayloadSize);
+    if (ntohl(sync) != PSA_WEBSOCKET_BINARY_SYNC || data[4] != PSA_WEBSOCKET_BINARY_HEADER_VERSION || fqnSize == 0 ||
+        size != PSA_WEBSOCKET_BINARY_HEADER_SIZE + (size_t)fqnSize + nPayloadSize ||
+        data[PSA_WEBSOCKET_BINARY_HEADER_SIZE + fqnSize - 1] != '\0') {
+        return false;
+    }
+    hdr->fqn = data + PSA_WEBSOCKET_BINARY_HEADER_SIZE;
+    hdr->major = (uint8_t)data[5];
+    hdr->minor = (uint8_t)data[6];
+    hdr->seqNr = ntohl(seqNr);
+    *payload = data + PSA_WEBSOCKET_BINARY_HEADER_SIZE + fqnSize;
+    *payloadSize = nPayloadSize;
+    return true;
+}
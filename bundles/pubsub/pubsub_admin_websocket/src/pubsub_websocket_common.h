@@ -22,6 +22,7 @@
 
 #include <utils.h>
 #include <stdint.h>
+#include <stddef.h>
 
 #include "version.h"
 
@@ -35,6 +36,33 @@ struct pubsub_websocket_msg_header {
 
 typedef struct pubsub_websocket_msg_header pubsub_websocket_msg_header_t;
 
+/**
+ * Binary websocket frames start with a fixed size header in network byte order:
+ *   sync (4 bytes), header version (1), msg major (1), msg minor (1), reserved (1),
+ *   seqNr (4), fqn size incl. '\0' (2), reserved (2), payload size (4)
+ * followed by the '\0' terminated msg fqn and the serialized payload.
+ */
+#define PSA_WEBSOCKET_BINARY_SYNC                   0x50535742 //"PSWB"
+#define PSA_WEBSOCKET_BINARY_HEADER_VERSION         1
+#define PSA_WEBSOCKET_BINARY_HEADER_SIZE            20
+
+/**
+ * Returns the size of the binary frame header including the msg fqn.
+ */
+size_t psa_websocket_binaryHeaderSize(const pubsub_websocket_msg_header_t *hdr);
+
+/**
+ * Writes the binary frame header and msg fqn for a payload of payloadSize bytes to buf.
+ * buf must be at least psa_websocket_binaryHeaderSize bytes.
+ */
+void psa_websocket_encodeBinaryHeader(const pubsub_websocket_msg_header_t *hdr, uint32_t payloadSize, char *buf);
+
+/**
+ * Decodes the header of a binary frame. The fqn of the decoded header points into the frame data.
+ * @return true if the frame is valid, false otherwise.
+ */
+bool psa_websocket_decodeBinaryFrame(const char *data, size_t size, pubsub_websocket_msg_header_t *hdr, const char **payload, size_t *payloadSize);
+
 void psa_websocket_setScopeAndTopicFilter(const char* scope, const char *topic, char *filter);
 char *psa_websocket_createURI(const char *scope, const char *topic);
 
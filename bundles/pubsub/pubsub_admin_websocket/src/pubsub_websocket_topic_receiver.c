@@ -27,6 +27,7 @@
 #include <arpa/inet.h>
 #include <celix_log_helper.h>
 #include <math.h>
+#include <ctype.h>
 #include "pubsub_websocket_topic_receiver.h"
 #include "pubsub_psa_websocket_constants.h"
 #include "pubsub_websocket_common.h"
@@ -61,7 +62,8 @@ typedef struct pubsub_websocket_rcv_buffer {
 
 typedef struct pubsub_websocket_msg_entry {
     size_t msgSize;
-    const char *msgData;
+    char *msgData; //'\0' terminated
+    bool binary; //true if received as binary frame
 } pubsub_websocket_msg_entry_t;
 
 struct pubsub_websocket_topic_receiver {
@@ -470,7 +472,7 @@ static void callReceivers(
     celixThreadMutex_unlock(&receiver->subscribers.mutex);
 }
 
-static void processJsonMsg(pubsub_websocket_topic_receiver_t *receiver, const pubsub_websocket_msg_header_t* header, const char *payload, size_t payloadSize) {
+static void processPayload(pubsub_websocket_topic_receiver_t *receiver, const pubsub_websocket_msg_header_t* header, const char *payload, size_t payloadSize) {
     uint32_t msgId = pubsub_serializerHandler_getMsgId(receiver->serializerHandler, header->fqn);
     if (msgId == 0) {
         L_WARN("Cannot find msg id for msg fqn %s", header->fqn);
@@ -516,7 +518,70 @@ static void processJsonMsg(pubsub_websocket_topic_receiver_t *receiver, const pu
     }
 }
 
-static void processMsg(pubsub_websocket_topic_receiver_t *receiver, const char *msg, size_t msgSize) {
+static const char* parseEnvelopeUInt(const char *pos, const char *key, unsigned long max, unsigned long *out) {
+    size_t keyLen = strlen(key);
+    if (strncmp(pos, key, keyLen) != 0 || pos[keyLen] < '0' || pos[keyLen] > '9') {
+        return NULL;
+    }
+    char *end = NULL;
+    *out = strtoul(pos + keyLen, &end, 10);
+    return *out <= max ? end : NULL;
+}
+
+/**
+ * Parses a text frame in the layout written by the websocket topic sender, without building a JSON DOM:
+ * {"id":"<msg fqn>","major":<major>,"minor":<minor>,"seqNr":<seqNr>,"data":<payload>}
+ * The payload is returned as a span of msg. The fqn is '\0' terminated in place, so msg is modified.
+ * @return false if the msg has another layout (e.g. from a webpage); the msg is then not modified.
+ */
+static bool parseEnvelope(char *msg, size_t msgSize, pubsub_websocket_msg_header_t *hdr, const char **payload, size_t *payloadSize) {
+    static const char idPrefix[] = "{\"id\":\"";
+    if (strncmp(msg, idPrefix, sizeof(idPrefix) - 1) != 0) {
+        return false;
+    }
+    char *fqn = msg + sizeof(idPrefix) - 1;
+    char *fqnEnd = strpbrk(fqn, "\"\\");
+    if (fqnEnd == NULL || *fqnEnd != '"') {
+        return false; //note escaped fqns are left to the JSON parser
+    }
+    unsigned long major;
+    unsigned long minor;
+    unsigned long seqNr;
+    const char *pos = parseEnvelopeUInt(fqnEnd + 1, ",\"major\":", UINT8_MAX, &major);
+    pos = pos == NULL ? NULL : parseEnvelopeUInt(pos, ",\"minor\":", UINT8_MAX, &minor);
+    pos = pos == NULL ? NULL : parseEnvelopeUInt(pos, ",\"seqNr\":", UINT32_MAX, &seqNr);
+    static const char dataKey[] = ",\"data\":";
+    if (pos == NULL || strncmp(pos, dataKey, sizeof(dataKey) - 1) != 0) {
+        return false;
+    }
+    pos += sizeof(dataKey) - 1;
+    const char *end = msg + msgSize;
+    while (end > pos && isspace((unsigned char)end[-1])) {
+        --end;
+    }
+    if (end - pos < 2 || end[-1] != '}') {
+        return false;
+    }
+    *fqnEnd = '\0';
+    hdr->fqn = fqn;
+    hdr->major = (uint8_t)major;
+    hdr->minor = (uint8_t)minor;
+    hdr->seqNr = (uint32_t)seqNr;
+    *payload = pos;
+    *payloadSize = (size_t)(end - 1 - pos);
+    return true;
+}
+
+static void processJsonMsg(pubsub_websocket_topic_receiver_t *receiver, char *msg, size_t msgSize) {
+    pubsub_websocket_msg_header_t hdr;
+    const char *payload = NULL;
+    size_t payloadSize = 0;
+    if (parseEnvelope(msg, msgSize, &hdr, &payload, &payloadSize)) {
+        L_TRACE("Received msg: fqn %s\tmajor %u\tminor %u\tseqNr %u\tdata %.*s\n", hdr.fqn, hdr.major, hdr.minor, hdr.seqNr, (int)payloadSize, payload);
+        processPayload(receiver, &hdr, payload, payloadSize);
+        return;
+    }
+
     json_error_t error;
     json_t *jsMsg = json_loadb(msg, msgSize, 0, &error);
     if (jsMsg != NULL) {
@@ -527,16 +592,15 @@ static void processMsg(pubsub_websocket_topic_receiver_t *receiver, const char *
         json_t *jsData = json_object_get(jsMsg, "data");
 
         if (jsId && jsMajor && jsMinor && jsSeqNr && jsData) {
-            pubsub_websocket_msg_header_t hdr;
             hdr.fqn = json_string_value(jsId);
             hdr.major = (uint8_t) json_integer_value(jsMajor);
             hdr.minor = (uint8_t) json_integer_value(jsMinor);
             hdr.seqNr = (uint32_t) json_integer_value(jsSeqNr);
-            char *payload = json_dumps(jsData, 0);
-            size_t payloadSize = strlen(payload);
-            L_TRACE("Received msg: fqn %s\tmajor %u\tminor %u\tseqNr %u\tdata %s\n", hdr.fqn, hdr.major, hdr.minor, hdr.seqNr, payload);
-            processJsonMsg(receiver, &hdr, payload, payloadSize);
-            free(payload);
+            char *data = json_dumps(jsData, 0);
+            size_t dataSize = strlen(data);
+            L_TRACE("Received msg: fqn %s\tmajor %u\tminor %u\tseqNr %u\tdata %s\n", hdr.fqn, hdr.major, hdr.minor, hdr.seqNr, data);
+            processPayload(receiver, &hdr, data, dataSize);
+            free(data);
         } else {
             L_WARN("[PSA_WEBSOCKET_TR] Received unsupported message: "
                    "ID = %s, major = %"JSON_INTEGER_FORMAT", minor = %"JSON_INTEGER_FORMAT", seqNr = %"JSON_INTEGER_FORMAT", data valid? %s",
@@ -550,6 +614,18 @@ static void processMsg(pubsub_websocket_topic_receiver_t *receiver, const char *
     }
 }
 
+static void processBinaryMsg(pubsub_websocket_topic_receiver_t *receiver, const char *msg, size_t msgSize) {
+    pubsub_websocket_msg_header_t hdr;
+    const char *payload = NULL;
+    size_t payloadSize = 0;
+    if (psa_websocket_decodeBinaryFrame(msg, msgSize, &hdr, &payload, &payloadSize)) {
+        L_TRACE("Received binary msg: fqn %s\tmajor %u\tminor %u\tseqNr %u\tsize %zu\n", hdr.fqn, hdr.major, hdr.minor, hdr.seqNr, payloadSize);
+        processPayload(receiver, &hdr, payload, payloadSize);
+    } else {
+        L_WARN("[PSA_WEBSOCKET_TR] Received invalid binary websocket frame of %zu bytes", msgSize);
+    }
+}
+
 static void* psa_websocket_recvThread(void * data) {
     pubsub_websocket_topic_receiver_t *receiver = data;
 
@@ -580,7 +656,11 @@ static void* psa_websocket_recvThread(void * data) {
             celix_arrayList_removeAt(receiver->recvBuffer.list, 0);
             celixThreadMutex_unlock(&receiver->recvBuffer.mutex);
 
-            processMsg(receiver, msg->msgData, msg->msgSize);
+            if (msg->binary) {
+                processBinaryMsg(receiver, msg->msgData, msg->msgSize);
+            } else {
+                processJsonMsg(receiver, msg->msgData, msg->msgSize);
+            }
             free((void *)msg->msgData);
             free(msg);
         }
@@ -635,7 +715,7 @@ static void psa_websocketTopicReceiver_ready(struct mg_connection *connection, v
 
 
 static int psa_websocketTopicReceiver_data(struct mg_connection *connection __attribute__((unused)),
-                                            int op_code __attribute__((unused)),
+                                            int op_code,
                                             char *data,
                                             size_t length,
                                             void *handle) {
@@ -645,10 +725,12 @@ static int psa_websocketTopicReceiver_data(struct mg_connection *connection __at
 
         celixThreadMutex_lock(&receiver->recvBuffer.mutex);
         pubsub_websocket_msg_entry_t *msg = malloc(sizeof(*msg));
-        const char *rcvdMsgData = malloc(length);
-        memcpy((void *) rcvdMsgData, data, length);
+        char *rcvdMsgData = malloc(length + 1);
+        memcpy(rcvdMsgData, data, length);
+        rcvdMsgData[length] = '\0';
         msg->msgData = rcvdMsgData;
         msg->msgSize = length;
+        msg->binary = (op_code & 0xf) == MG_WEBSOCKET_OPCODE_BINARY;
         celix_arrayList_add(receiver->recvBuffer.list, msg);
         celixThreadMutex_unlock(&receiver->recvBuffer.mutex);
     }
@@ -28,7 +28,6 @@
 #include "pubsub_websocket_topic_sender.h"
 #include "pubsub_psa_websocket_constants.h"
 #include "pubsub_websocket_common.h"
-#include <jansson.h>
 #include "celix_constants.h"
 #include "http_admin/api.h"
 #include "civetweb.h"
@@ -60,6 +59,7 @@ struct pubsub_websocket_topic_sender {
     pubsub_interceptors_handler_t *interceptorsHandler;
 
     int seqNr; //atomic
+    bool binaryFrames; //true if messages are sent as binary frames instead of JSON text frames
 
     celix_websocket_service_t websockSvc;
     long websockSvcId;
@@ -96,12 +96,14 @@ pubsub_websocket_topic_sender_t* pubsub_websocketTopicSender_create(
         celix_log_helper_t *logHelper,
         const char *scope,
         const char *topic,
+        const celix_properties_t *topicProperties,
         pubsub_serializer_handler_t* serializerHandler,
         void *admin) {
     pubsub_websocket_topic_sender_t *sender = calloc(1, sizeof(*sender));
     sender->ctx = ctx;
     sender->logHelper = logHelper;
     sender->serializerHandler = serializerHandler;
+    sender->binaryFrames = celix_properties_getAsBool(topicProperties, PUBSUB_WEBSOCKET_BINARY_FRAMES_KEY, PUBSUB_WEBSOCKET_BINARY_FRAMES_DEFAULT);
     sender->interceptorsHandler = pubsubInterceptorsHandler_create(ctx, scope, topic, PUBSUB_WEBSOCKET_ADMIN_TYPE, pubsub_serializerHandler_getSerializationType(serializerHandler));
 
     psa_websocket_setScopeAndTopicFilter(scope, topic, sender->scopeAndTopicFilter);
@@ -251,6 +253,96 @@ static void psa_websocket_ungetPublisherService(void *handle, const celix_bundle
     celixThreadMutex_unlock(&sender->boundedServices.mutex);
 }
 
+static size_t psa_websocket_payloadSize(const struct iovec *payload, size_t payloadLen) {
+    size_t size = 0;
+    for (size_t i = 0; i < payloadLen; ++i) {
+        size += payload[i].iov_len;
+    }
+    return size;
+}
+
+static char* psa_websocket_copyPayload(const struct iovec *payload, size_t payloadLen, char *buf) {
+    for (size_t i = 0; i < payloadLen; ++i) {
+        memcpy(buf, payload[i].iov_base, payload[i].iov_len);
+        buf += payload[i].iov_len;
+    }
+    return buf;
+}
+
+/**
+ * Writes str as a JSON string (incl. quotes) to buf, or only counts the needed size if buf is NULL.
+ */
+static size_t psa_websocket_writeJsonString(const char *str, char *buf) {
+    size_t size = 0;
+    if (buf != NULL) {
+        buf[size] = '"';
+    }
+    size += 1;
+    for (const char *c = str; *c != '\0'; ++c) {
+        char escaped[8];
+        int len;
+        if (*c == '"' || *c == '\\') {
+            len = snprintf(escaped, sizeof(escaped), "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            len = snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)*c);
+        } else {
+            escaped[0] = *c;
+            len = 1;
+        }
+        if (buf != NULL) {
+            memcpy(buf + size, escaped, len);
+        }
+        size += len;
+    }
+    if (buf != NULL) {
+        buf[size] = '"';
+    }
+    return size + 1;
+}
+
+/**
+ * Creates a JSON text frame by writing the envelope around the already serialized JSON payload:
+ * {"id":"<msg fqn>","major":<major>,"minor":<minor>,"seqNr":<seqNr>,"data":<payload>}
+ */
+static char* psa_websocket_createTextFrame(const pubsub_websocket_msg_header_t *hdr, const struct iovec *payload, size_t payloadLen, size_t *frameSize) {
+    size_t payloadSize = psa_websocket_payloadSize(payload, payloadLen);
+    if (payloadSize == 0) {
+        return NULL; //not a valid JSON value
+    }
+    char versions[64];
+    int versionsLen = snprintf(versions, sizeof(versions), ",\"major\":%u,\"minor\":%u,\"seqNr\":%u,\"data\":",
+                               (unsigned int)hdr->major, (unsigned int)hdr->minor, (unsigned int)hdr->seqNr);
+    static const char idPrefix[] = "{\"id\":";
+    size_t size = (sizeof(idPrefix) - 1) + psa_websocket_writeJsonString(hdr->fqn, NULL) + versionsLen + payloadSize + 1;
+    char *frame = malloc(size);
+    char *pos = frame;
+    memcpy(pos, idPrefix, sizeof(idPrefix) - 1);
+    pos += sizeof(idPrefix) - 1;
+    pos += psa_websocket_writeJsonString(hdr->fqn, pos);
+    memcpy(pos, versions, versionsLen);
+    pos += versionsLen;
+    pos = psa_websocket_copyPayload(payload, payloadLen, pos);
+    *pos = '}';
+    *frameSize = size;
+    return frame;
+}
+
+/**
+ * Creates a binary frame: the binary header, the msg fqn and the serialized payload as-is.
+ */
+static char* psa_websocket_createBinaryFrame(const pubsub_websocket_msg_header_t *hdr, const struct iovec *payload, size_t payloadLen, size_t *frameSize) {
+    size_t payloadSize = psa_websocket_payloadSize(payload, payloadLen);
+    size_t headerSize = psa_websocket_binaryHeaderSize(hdr);
+    if (payloadSize > UINT32_MAX || headerSize - PSA_WEBSOCKET_BINARY_HEADER_SIZE > UINT16_MAX) {
+        return NULL;
+    }
+    char *frame = malloc(headerSize + payloadSize);
+    psa_websocket_encodeBinaryHeader(hdr, (uint32_t)payloadSize, frame);
+    psa_websocket_copyPayload(payload, payloadLen, frame + headerSize);
+    *frameSize = headerSize + payloadSize;
+    return frame;
+}
+
 static int psa_websocket_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
     psa_websocket_bounded_service_entry_t *bound = handle;
     pubsub_websocket_topic_sender_t *sender = bound->parent;
@@ -277,33 +369,29 @@ static int psa_websocket_topicPublicationSend(void* handle, unsigned int msgType
         struct iovec* serializedOutput = NULL;
         status = pubsub_serializerHandler_serialize(sender->serializerHandler, msgTypeId, inMsg, &serializedOutput, &serializedOutputLen);
         if (status == CELIX_SUCCESS /*ser ok*/) {
-            json_error_t jsError;
-
-            json_t *jsMsg = json_object();
-            json_object_set_new_nocheck(jsMsg, "id", json_string(msgFqn));
-            json_object_set_new_nocheck(jsMsg, "major", json_integer(majorVersion));
-            json_object_set_new_nocheck(jsMsg, "minor", json_integer(minorVersion));
-            uint32_t seqNr = __atomic_fetch_add(&sender->seqNr, 1, __ATOMIC_RELAXED);
-            json_object_set_new_nocheck(jsMsg, "seqNr", json_integer(seqNr));
-
-            json_t *jsData;
-            jsData = json_loadb((const char *)serializedOutput->iov_base, serializedOutput->iov_len, 0, &jsError);
-            if (jsData != NULL) {
-                json_object_set_new_nocheck(jsMsg, "data", jsData);
-                const char *msg = json_dumps(jsMsg, 0);
-                size_t bytes_to_write = strlen(msg);
-                int bytes_written = mg_websocket_write(sender->sockConnection, MG_WEBSOCKET_OPCODE_TEXT, msg,
-                                                              bytes_to_write);
-                free((void *) msg);
-                json_decref(jsData); //Decrease ref count means freeing the object
-                if (bytes_written != (int) bytes_to_write) {
-                    L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, written %d of total %lu bytes", bytes_written, bytes_to_write);
+            pubsub_websocket_msg_header_t hdr;
+            hdr.fqn = msgFqn;
+            hdr.major = (uint8_t) majorVersion;
+            hdr.minor = (uint8_t) minorVersion;
+            hdr.seqNr = __atomic_fetch_add(&sender->seqNr, 1, __ATOMIC_RELAXED);
+
+            size_t frameSize = 0;
+            char *frame = sender->binaryFrames ?
+                    psa_websocket_createBinaryFrame(&hdr, serializedOutput, serializedOutputLen, &frameSize) :
+                    psa_websocket_createTextFrame(&hdr, serializedOutput, serializedOutputLen, &frameSize);
+            if (frame != NULL) {
+                int bytes_written = mg_websocket_write(sender->sockConnection,
+                                                       sender->binaryFrames ? MG_WEBSOCKET_OPCODE_BINARY : MG_WEBSOCKET_OPCODE_TEXT,
+                                                       frame, frameSize);
+                free(frame);
+                if (bytes_written != (int) frameSize) {
+                    L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, written %d of total %lu bytes", bytes_written, frameSize);
                 }
             } else {
-                L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, serialized data corrupt. Error(%d;%d;%d): %s", jsError.column, jsError.line, jsError.position, jsError.text);
+                L_WARN("[PSA_WEBSOCKET_TS] Error sending websocket, cannot create a %s frame for msg type %s",
+                       sender->binaryFrames ? "binary" : "text", msgFqn);
             }
 
-            json_decref(jsMsg); //Decrease ref count means freeing the object
             pubsub_serializerHandler_freeSerializedMsg(sender->serializerHandler, msgTypeId, serializedOutput, serializedOutputLen);
         } else {
             L_WARN("[PSA_WEBSOCKET_TS] Error serialize message of type %u for scope/topic %s/%s",
@@ -31,6 +31,7 @@ pubsub_websocket_topic_sender_t* pubsub_websocketTopicSender_create(
         celix_log_helper_t *logHelper,
         const char *scope,
         const char *topic,
+        const celix_properties_t *topicProperties,
         pubsub_serializer_handler_t* serializerHandler,
         void *admin);
 void pubsub_websocketTopicSender_destroy(pubsub_websocket_topic_sender_t *sender);
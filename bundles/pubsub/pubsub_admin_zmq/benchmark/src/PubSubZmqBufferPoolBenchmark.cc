@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "pubsub_zmq_buffer_pool.h"
+
+/**
+ * Measures the buffer handling of a zero copy publish: a buffer is acquired, the message is written into it and
+ * zmq holds a ref per frame (header, payload and footer) until the frames are sent.
+ * Reference: a heap buffer per publish.
+ */
+static constexpr int NR_OF_FRAMES = 3;
+
+static void PubSubZmqBufferPoolBenchmark_pooledBuffers(benchmark::State& state) {
+    auto msgSize = static_cast<size_t>(state.range(0));
+    auto* pool = pubsub_zmqBufferPool_create("1024,16384,131072", 16);
+    std::vector<char> msg(msgSize, 'x');
+    for (auto _ : state) {
+        // This code gets timed
+        auto* buffer = pubsub_zmqBufferPool_acquire(pool, msgSize);
+        memcpy(pubsub_zmqBuffer_data(buffer), msg.data(), msgSize);
+        for (int i = 0; i < NR_OF_FRAMES; ++i) {
+            pubsub_zmqBuffer_retain(buffer);
+        }
+        pubsub_zmqBuffer_release(buffer);
+        for (int i = 0; i < NR_OF_FRAMES; ++i) {
+            pubsub_zmqBuffer_zmqFree(pubsub_zmqBuffer_data(buffer), buffer);
+        }
+    }
+    pubsub_zmq_buffer_pool_statistics_t stats;
+    pubsub_zmqBufferPool_getStatistics(pool, &stats);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocations_per_msg"] = benchmark::Counter(
+            static_cast<double>(stats.nrOfHeapBuffers + stats.nrOfPooledBuffers) / static_cast<double>(state.iterations()));
+    pubsub_zmqBufferPool_destroy(pool);
+}
+
+static void PubSubZmqBufferPoolBenchmark_heapBuffers(benchmark::State& state) {
+    auto msgSize = static_cast<size_t>(state.range(0));
+    std::vector<char> msg(msgSize, 'x');
+    for (auto _ : state) {
+        // This code gets timed
+        auto* buffer = static_cast<char*>(malloc(msgSize));
+        memcpy(buffer, msg.data(), msgSize);
+        benchmark::DoNotOptimize(buffer);
+        free(buffer);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(PubSubZmqBufferPoolBenchmark_pooledBuffers)->Arg(64)->Arg(4096)->Arg(65536)->Arg(1024 * 1024);
+CELIX_BENCHMARK(PubSubZmqBufferPoolBenchmark_heapBuffers)->Arg(64)->Arg(4096)->Arg(65536)->Arg(1024 * 1024); //reference
@@ -0,0 +1,185 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "celix_api.h"
+#include "celix_log_constants.h"
+#include "celix_log_helper.h"
+#include "pubsub_message_serialization_service.h"
+#include "pubsub_zmq_dispatcher.h"
+
+/**
+ * Measures the dispatch of a received message to the subscribers of a topic.
+ * The message serialization service copies the payload, so that a deserialization has a cost related to the payload size.
+ */
+class PubSubZmqDispatchBenchmark {
+public:
+    enum class TakeMode {
+        NONE, //all subscribers only read the message
+        FIRST, //the first subscriber takes ownership of the message
+        ALL, //all subscribers take ownership of the message
+    };
+
+    PubSubZmqDispatchBenchmark(size_t nrOfSubscribers, TakeMode mode) : takeMode{mode} {
+        auto* config = celix_properties_create();
+        celix_properties_set(config, CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL_CONFIG_NAME, "error");
+        celix_properties_set(config, CELIX_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_NAME, "onFirstInit");
+        fw = celix_frameworkFactory_createFramework(config);
+        ctx = celix_framework_getFrameworkContext(fw);
+        logHelper = celix_logHelper_create(ctx, "pubsub_zmq_benchmark");
+
+        msgSerSvc.handle = this;
+        msgSerSvc.deserialize = [](void* handle, const struct iovec* input, size_t, void** out) -> celix_status_t {
+            auto* bench = static_cast<PubSubZmqDispatchBenchmark*>(handle);
+            bench->nrOfDeserializations += 1;
+            auto* copy = malloc(input->iov_len);
+            memcpy(copy, input->iov_base, input->iov_len);
+            *out = copy;
+            return CELIX_SUCCESS;
+        };
+        msgSerSvc.freeDeserializedMsg = [](void*, void* msg) {
+            free(msg);
+        };
+        auto* props = celix_properties_create();
+        celix_properties_set(props, PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZATION_TYPE_PROPERTY, "benchmark");
+        celix_properties_setLong(props, PUBSUB_MESSAGE_SERIALIZATION_SERVICE_MSG_ID_PROPERTY, MSG_ID);
+        celix_properties_set(props, PUBSUB_MESSAGE_SERIALIZATION_SERVICE_MSG_FQN_PROPERTY, MSG_FQN);
+        celix_properties_set(props, PUBSUB_MESSAGE_SERIALIZATION_SERVICE_MSG_VERSION_PROPERTY, "1.0.0");
+        celix_service_registration_options_t opts{};
+        opts.svc = static_cast<void*>(&msgSerSvc);
+        opts.properties = props;
+        opts.serviceName = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_NAME;
+        opts.serviceVersion = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_VERSION;
+        msgSerSvcId = celix_bundleContext_registerServiceWithOptions(ctx, &opts);
+        serHandler = pubsub_serializerHandler_create(ctx, "benchmark", true);
+        celix_bundleContext_waitForEvents(ctx); //note the serializer handler tracks services async
+
+        dispatcher = pubsub_zmqDispatcher_create(logHelper, serHandler, nullptr, "benchmark");
+        subscribers.resize(nrOfSubscribers);
+        for (size_t i = 0; i < nrOfSubscribers; ++i) {
+            subscribers[i].handle = this;
+            subscribers[i].receive = i == 0 ? receiveFirst : receive;
+            pubsub_zmqDispatcher_addSubscriber(dispatcher, (long)i + 1, &subscribers[i]);
+        }
+        pubsub_zmqDispatcher_initializeAllSubscribers(dispatcher);
+    }
+
+    ~PubSubZmqDispatchBenchmark() {
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+            pubsub_zmqDispatcher_removeSubscriber(dispatcher, (long)i + 1);
+        }
+        pubsub_zmqDispatcher_destroy(dispatcher);
+        pubsub_serializerHandler_destroy(serHandler);
+        celix_bundleContext_unregisterService(ctx, msgSerSvcId);
+        celix_logHelper_destroy(logHelper);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    PubSubZmqDispatchBenchmark(PubSubZmqDispatchBenchmark&&) = delete;
+    PubSubZmqDispatchBenchmark& operator=(PubSubZmqDispatchBenchmark&&) = delete;
+    PubSubZmqDispatchBenchmark(const PubSubZmqDispatchBenchmark&) = delete;
+    PubSubZmqDispatchBenchmark& operator=(const PubSubZmqDispatchBenchmark&) = delete;
+
+    void receiveMessage(std::string& payload) {
+        pubsub_protocol_message_t message{};
+        message.header.msgId = MSG_ID;
+        message.header.msgMajorVersion = 1;
+        message.header.msgMinorVersion = 0;
+        message.payload.payload = payload.data();
+        message.payload.length = payload.size();
+        auto* msg = pubsub_zmqReceivedMsg_create(dispatcher, &message);
+        if (msg == nullptr) {
+            std::cerr << "Error deserializing message" << std::endl;
+            abort();
+        }
+        pubsub_zmqDispatcher_dispatch(dispatcher, MSG_FQN, msg, nullptr);
+        pubsub_zmqReceivedMsg_release(msg);
+    }
+
+    static constexpr uint32_t MSG_ID = 42;
+    static constexpr const char* MSG_FQN = "example::Msg";
+    const TakeMode takeMode;
+    celix_framework_t* fw{nullptr};
+    celix_bundle_context_t* ctx{nullptr};
+    celix_log_helper_t* logHelper{nullptr};
+    pubsub_message_serialization_service_t msgSerSvc{};
+    long msgSerSvcId{-1};
+    pubsub_serializer_handler_t* serHandler{nullptr};
+    pubsub_zmq_dispatcher_t* dispatcher{nullptr};
+    std::vector<pubsub_subscriber_t> subscribers{};
+    size_t nrOfDeserializations{0};
+
+private:
+    static int handleReceive(bool take, void* msg, bool* release) {
+        benchmark::DoNotOptimize(*static_cast<char*>(msg));
+        if (take) {
+            //subscriber takes ownership of the message and is done with it
+            *release = false;
+            free(msg);
+        }
+        return 0;
+    }
+
+    static int receiveFirst(void* handle, const char*, unsigned int, void* msg, const celix_properties_t*, bool* release) {
+        auto* bench = static_cast<PubSubZmqDispatchBenchmark*>(handle);
+        return handleReceive(bench->takeMode != TakeMode::NONE, msg, release);
+    }
+
+    static int receive(void* handle, const char*, unsigned int, void* msg, const celix_properties_t*, bool* release) {
+        auto* bench = static_cast<PubSubZmqDispatchBenchmark*>(handle);
+        return handleReceive(bench->takeMode == TakeMode::ALL, msg, release);
+    }
+};
+
+static void dispatchMessage(benchmark::State& state, PubSubZmqDispatchBenchmark::TakeMode takeMode) {
+    PubSubZmqDispatchBenchmark benchmark{static_cast<size_t>(state.range(0)), takeMode};
+    std::string payload(1024, 'x');
+    for (auto _ : state) {
+        // This code gets timed
+        benchmark.receiveMessage(payload);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["deserializations_per_msg"] = benchmark::Counter(
+            static_cast<double>(benchmark.nrOfDeserializations) / static_cast<double>(state.iterations()));
+}
+
+static void PubSubZmqDispatchBenchmark_sharedReadOnly(benchmark::State& state) {
+    dispatchMessage(state, PubSubZmqDispatchBenchmark::TakeMode::NONE);
+}
+
+static void PubSubZmqDispatchBenchmark_firstSubscriberTakes(benchmark::State& state) {
+    dispatchMessage(state, PubSubZmqDispatchBenchmark::TakeMode::FIRST);
+}
+
+static void PubSubZmqDispatchBenchmark_allSubscribersTake(benchmark::State& state) {
+    dispatchMessage(state, PubSubZmqDispatchBenchmark::TakeMode::ALL);
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(PubSubZmqDispatchBenchmark_sharedReadOnly)->Arg(1)->Arg(8)->Arg(64);
+CELIX_BENCHMARK(PubSubZmqDispatchBenchmark_firstSubscriberTakes)->Arg(1)->Arg(8)->Arg(64);
+CELIX_BENCHMARK(PubSubZmqDispatchBenchmark_allSubscribersTake)->Arg(1)->Arg(8)->Arg(64); //reference, a copy per subscriber
@@ -38,6 +38,14 @@
 #define PSA_ZMQ_ZEROCOPY_ENABLED "PSA_ZMQ_ZEROCOPY_ENABLED"
 #define PSA_ZMQ_DEFAULT_ZEROCOPY_ENABLED false
 
+/**
+ * If enabled, the topic senders and receivers record latency histograms (serialization, send, end-to-end and
+ * subscriber callback latency) which are provided through the pubsub admin metrics service.
+ * Note that for the end-to-end latency the send timestamp is added to the metadata of every message.
+ */
+#define PSA_ZMQ_METRICS_ENABLED                 "PSA_ZMQ_METRICS_ENABLED"
+#define PSA_ZMQ_DEFAULT_METRICS_ENABLED         false
+
 
 #define PUBSUB_ZMQ_VERBOSE_KEY      "PSA_ZMQ_VERBOSE"
 #define PUBSUB_ZMQ_VERBOSE_DEFAULT  true
@@ -105,4 +113,18 @@
  */
 #define PUBSUB_ZMQ_HWM                      "zmq.hwm"
 
+/**
+ * The buffer pool used by a topic sender if zero copy is enabled (PSA_ZMQ_ZEROCOPY_ENABLED).
+ * The messages are serialized into pooled buffers which are handed to zmq without copying.
+ * Can be set in the topic properties.
+ *
+ * PUBSUB_ZMQ_BUFFER_POOL_CLASSES is a comma separated list of buffer sizes in bytes,
+ * PUBSUB_ZMQ_BUFFER_POOL_SIZE is the max number of pooled buffers per buffer size.
+ * A message which does not fit in a (free) pooled buffer is sent using a heap allocated buffer.
+ */
+#define PUBSUB_ZMQ_BUFFER_POOL_CLASSES              "zmq.buffer.pool.classes"
+#define PUBSUB_ZMQ_BUFFER_POOL_CLASSES_DEFAULT      "1024,16384,131072"
+#define PUBSUB_ZMQ_BUFFER_POOL_SIZE                 "zmq.buffer.pool.size"
+#define PUBSUB_ZMQ_BUFFER_POOL_SIZE_DEFAULT         16
+
 #endif /* PUBSUB_PSA_ZMQ_CONSTANTS_H_ */
@@ -408,7 +408,7 @@ celix_status_t pubsub_zmqAdmin_setupTopicSender(void *handle, const char *scope,
     if (sender == NULL) {
         psa_zmq_protocol_entry_t *protEntry = hashMap_get(psa->protocols.map, (void*)protocolSvcId);
         if (protEntry != NULL) {
-            sender = pubsub_zmqTopicSender_create(psa->ctx, psa->log, scope, topic, handler, handle,
+            sender = pubsub_zmqTopicSender_create(psa->ctx, psa->log, scope, topic, topicProperties, handler, handle,
                     protocolSvcId, protEntry->svc, psa->ipAddress, staticBindUrl, psa->basePort, psa->maxPort);
         }
         if (sender != NULL) {
@@ -703,6 +703,11 @@ bool pubsub_zmqAdmin_executeCommand(void *handle, const char *commandLine, FILE
         fprintf(out, "   |- serializer type = %s\n", serType);
         fprintf(out, "   |- protocol type = %s\n", protType);
         fprintf(out, "   |- url            = %s%s\n", url, postUrl);
+        pubsub_zmq_buffer_pool_statistics_t poolStats;
+        if (pubsub_zmqTopicSender_getBufferPoolStatistics(sender, &poolStats)) {
+            fprintf(out, "   |- buffer pool    = %lu acquired, %lu pooled, %lu heap, %lu in use\n",
+                    poolStats.nrOfAcquiredBuffers, poolStats.nrOfPooledBuffers, poolStats.nrOfHeapBuffers, poolStats.nrOfBuffersInUse);
+        }
     }
     celixThreadMutex_unlock(&psa->topicSenders.mutex);
     celixThreadMutex_unlock(&psa->protocols.mutex);
@@ -751,6 +756,38 @@ bool pubsub_zmqAdmin_executeCommand(void *handle, const char *commandLine, FILE
     return status;
 }
 
+pubsub_admin_metrics_t* pubsub_zmqAdmin_metrics(void *handle) {
+    pubsub_zmq_admin_t *psa = handle;
+    pubsub_admin_metrics_t *result = calloc(1, sizeof(*result));
+    snprintf(result->psaType, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", PUBSUB_ZMQ_ADMIN_TYPE);
+    result->senders = celix_arrayList_create();
+    result->receivers = celix_arrayList_create();
+
+    celixThreadMutex_lock(&psa->topicSenders.mutex);
+    hash_map_iterator_t iter = hashMapIterator_construct(psa->topicSenders.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_zmq_topic_sender_t *sender = hashMapIterator_nextValue(&iter);
+        pubsub_admin_sender_metrics_t *metrics = pubsub_zmqTopicSender_metrics(sender);
+        if (metrics != NULL) {
+            celix_arrayList_add(result->senders, metrics);
+        }
+    }
+    celixThreadMutex_unlock(&psa->topicSenders.mutex);
+
+    celixThreadMutex_lock(&psa->topicReceivers.mutex);
+    iter = hashMapIterator_construct(psa->topicReceivers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pubsub_zmq_topic_receiver_t *receiver = hashMapIterator_nextValue(&iter);
+        pubsub_admin_receiver_metrics_t *metrics = pubsub_zmqTopicReceiver_metrics(receiver);
+        if (metrics != NULL) {
+            celix_arrayList_add(result->receivers, metrics);
+        }
+    }
+    celixThreadMutex_unlock(&psa->topicReceivers.mutex);
+
+    return result;
+}
+
 static pubsub_serializer_handler_t* pubsub_zmqAdmin_getSerializationHandler(pubsub_zmq_admin_t* psa, long msgSerializationMarkerSvcId) {
     pubsub_serializer_handler_t* handler = NULL;
     celixThreadMutex_lock(&psa->serializationHandlers.mutex);
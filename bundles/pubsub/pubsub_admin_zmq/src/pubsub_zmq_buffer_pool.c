@@ -0,0 +1,201 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "pubsub_zmq_buffer_pool.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "celix_threads.h"
+
+struct pubsub_zmq_buffer {
+    pubsub_zmq_buffer_pool_t *pool;
+    int classIndex; //-1 for an unpooled heap buffer
+    size_t size;
+    int refCount; //atomic
+    pubsub_zmq_buffer_t *next; //next free buffer, only used when in the pool
+    _Alignas(16) char data[];
+};
+
+typedef struct pubsub_zmq_buffer_class {
+    size_t bufferSize;
+    size_t nrOfAllocated;
+    pubsub_zmq_buffer_t *freeList;
+} pubsub_zmq_buffer_class_t;
+
+struct pubsub_zmq_buffer_pool {
+    size_t buffersPerClass;
+    size_t nrOfClasses;
+    pubsub_zmq_buffer_class_t classes[PUBSUB_ZMQ_BUFFER_POOL_MAX_CLASSES]; //sorted on buffer size
+    int refCount; //atomic, 1 for the pool owner and 1 per buffer in use
+
+    celix_thread_mutex_t mutex; //protects below and the class free lists
+    bool destroyed;
+    pubsub_zmq_buffer_pool_statistics_t stats;
+};
+
+static int pubsub_zmqBufferPool_compareClasses(const void *a, const void *b) {
+    const pubsub_zmq_buffer_class_t *classA = a;
+    const pubsub_zmq_buffer_class_t *classB = b;
+    return classA->bufferSize < classB->bufferSize ? -1 : (classA->bufferSize > classB->bufferSize ? 1 : 0);
+}
+
+pubsub_zmq_buffer_pool_t* pubsub_zmqBufferPool_create(const char *bufferClasses, size_t buffersPerClass) {
+    pubsub_zmq_buffer_pool_t *pool = calloc(1, sizeof(*pool));
+    const char *pos = bufferClasses;
+    while (pos != NULL && *pos != '\0' && pool->nrOfClasses < PUBSUB_ZMQ_BUFFER_POOL_MAX_CLASSES) {
+        char *end = NULL;
+        errno = 0;
+        unsigned long long size = strtoull(pos, &end, 10);
+        if (end == pos) {
+            ++end; //skip invalid character
+        } else if (errno == 0 && size > 0 && size <= SIZE_MAX / 2) {
+            pool->classes[pool->nrOfClasses++].bufferSize = (size_t)size;
+        }
+        pos = end;
+    }
+    if (pool->nrOfClasses == 0) {
+        free(pool);
+        return NULL;
+    }
+    qsort(pool->classes, pool->nrOfClasses, sizeof(pool->classes[0]), pubsub_zmqBufferPool_compareClasses);
+    pool->buffersPerClass = buffersPerClass;
+    pool->refCount = 1;
+    celixThreadMutex_create(&pool->mutex, NULL);
+    return pool;
+}
+
+static void pubsub_zmqBufferPool_unref(pubsub_zmq_buffer_pool_t *pool) {
+    if (__atomic_sub_fetch(&pool->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        celixThreadMutex_destroy(&pool->mutex);
+        free(pool);
+    }
+}
+
+void pubsub_zmqBufferPool_destroy(pubsub_zmq_buffer_pool_t *pool) {
+    if (pool != NULL) {
+        celixThreadMutex_lock(&pool->mutex);
+        pool->destroyed = true;
+        for (size_t i = 0; i < pool->nrOfClasses; ++i) {
+            pubsub_zmq_buffer_t *buffer = pool->classes[i].freeList;
+            while (buffer != NULL) {
+                pubsub_zmq_buffer_t *next = buffer->next;
+                free(buffer);
+                buffer = next;
+            }
+            pool->classes[i].freeList = NULL;
+        }
+        celixThreadMutex_unlock(&pool->mutex);
+        pubsub_zmqBufferPool_unref(pool);
+    }
+}
+
+static pubsub_zmq_buffer_t* pubsub_zmqBufferPool_allocBuffer(pubsub_zmq_buffer_pool_t *pool, int classIndex, size_t size) {
+    pubsub_zmq_buffer_t *buffer = malloc(sizeof(*buffer) + size);
+    if (buffer != NULL) {
+        buffer->pool = pool;
+        buffer->classIndex = classIndex;
+        buffer->size = size;
+        buffer->next = NULL;
+    }
+    return buffer;
+}
+
+pubsub_zmq_buffer_t* pubsub_zmqBufferPool_acquire(pubsub_zmq_buffer_pool_t *pool, size_t minSize) {
+    pubsub_zmq_buffer_t *buffer = NULL;
+    celixThreadMutex_lock(&pool->mutex);
+    pool->stats.nrOfAcquiredBuffers += 1;
+    for (size_t i = 0; buffer == NULL && i < pool->nrOfClasses; ++i) {
+        pubsub_zmq_buffer_class_t *class = &pool->classes[i];
+        if (class->bufferSize < minSize) {
+            continue;
+        }
+        if (class->freeList != NULL) {
+            buffer = class->freeList;
+            class->freeList = buffer->next;
+            buffer->next = NULL;
+        } else if (class->nrOfAllocated < pool->buffersPerClass) {
+            buffer = pubsub_zmqBufferPool_allocBuffer(pool, (int)i, class->bufferSize);
+            if (buffer != NULL) {
+                class->nrOfAllocated += 1;
+                pool->stats.nrOfPooledBuffers += 1;
+            }
+        }
+        //else class exhausted, try a larger class
+    }
+    if (buffer == NULL) {
+        pool->stats.nrOfHeapBuffers += 1;
+    }
+    celixThreadMutex_unlock(&pool->mutex);
+
+    if (buffer == NULL) {
+        buffer = pubsub_zmqBufferPool_allocBuffer(pool, -1, minSize);
+    }
+    if (buffer != NULL) {
+        buffer->refCount = 1;
+        __atomic_add_fetch(&pool->refCount, 1, __ATOMIC_RELAXED);
+    }
+    return buffer;
+}
+
+void pubsub_zmqBufferPool_getStatistics(pubsub_zmq_buffer_pool_t *pool, pubsub_zmq_buffer_pool_statistics_t *stats) {
+    celixThreadMutex_lock(&pool->mutex);
+    *stats = pool->stats;
+    celixThreadMutex_unlock(&pool->mutex);
+    stats->nrOfBuffersInUse = (unsigned long)__atomic_load_n(&pool->refCount, __ATOMIC_RELAXED) - 1;
+}
+
+void* pubsub_zmqBuffer_data(pubsub_zmq_buffer_t *buffer) {
+    return buffer->data;
+}
+
+size_t pubsub_zmqBuffer_size(const pubsub_zmq_buffer_t *buffer) {
+    return buffer->size;
+}
+
+void pubsub_zmqBuffer_retain(pubsub_zmq_buffer_t *buffer) {
+    __atomic_add_fetch(&buffer->refCount, 1, __ATOMIC_RELAXED);
+}
+
+void pubsub_zmqBuffer_release(pubsub_zmq_buffer_t *buffer) {
+    if (buffer == NULL || __atomic_sub_fetch(&buffer->refCount, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+    pubsub_zmq_buffer_pool_t *pool = buffer->pool;
+    bool returned = false;
+    if (buffer->classIndex >= 0) {
+        celixThreadMutex_lock(&pool->mutex);
+        if (!pool->destroyed) {
+            pubsub_zmq_buffer_class_t *class = &pool->classes[buffer->classIndex];
+            buffer->next = class->freeList;
+            class->freeList = buffer;
+            returned = true;
+        }
+        celixThreadMutex_unlock(&pool->mutex);
+    }
+    if (!returned) {
+        free(buffer);
+    }
+    pubsub_zmqBufferPool_unref(pool);
+}
+
+void pubsub_zmqBuffer_zmqFree(void *data __attribute__((unused)), void *hint) {
+    pubsub_zmqBuffer_release(hint);
+}
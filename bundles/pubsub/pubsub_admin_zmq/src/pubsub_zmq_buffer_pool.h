@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_ZMQ_BUFFER_POOL_H
+#define CELIX_PUBSUB_ZMQ_BUFFER_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * The maximum number of buffer classes of a buffer pool.
+ */
+#define PUBSUB_ZMQ_BUFFER_POOL_MAX_CLASSES 8
+
+/**
+ * @brief A pool of fixed-size, ref-counted message buffers, used to hand messages to zmq without copying.
+ *
+ * A pool has a number of buffer classes (buffer sizes) and keeps at most buffersPerClass buffers per class.
+ * Pooled buffers are allocated on first use and are returned to the pool when their ref count drops to 0, so in steady
+ * state acquiring a buffer does not allocate.
+ * If a class is exhausted or a buffer larger than the largest class is requested, an unpooled heap buffer is used.
+ *
+ * Buffers can outlive the pool (e.g. when still queued in zmq); the pool memory is freed when the pool is destroyed
+ * and the last buffer is released.
+ */
+typedef struct pubsub_zmq_buffer_pool pubsub_zmq_buffer_pool_t;
+
+typedef struct pubsub_zmq_buffer pubsub_zmq_buffer_t;
+
+typedef struct pubsub_zmq_buffer_pool_statistics {
+    unsigned long nrOfAcquiredBuffers; //total number of acquired buffers
+    unsigned long nrOfPooledBuffers; //number of buffers allocated for the pool
+    unsigned long nrOfHeapBuffers; //number of acquired buffers which could not be served from the pool
+    unsigned long nrOfBuffersInUse; //number of buffers currently in use
+} pubsub_zmq_buffer_pool_statistics_t;
+
+/**
+ * @brief Creates a buffer pool.
+ * @param bufferClasses A comma separated list of buffer sizes in bytes (e.g. "1024,16384,131072").
+ *                      Invalid sizes are ignored. If no valid size is provided, NULL is returned.
+ * @param buffersPerClass The maximum number of pooled buffers per buffer class.
+ */
+pubsub_zmq_buffer_pool_t* pubsub_zmqBufferPool_create(const char *bufferClasses, size_t buffersPerClass);
+
+/**
+ * @brief Destroys the pool. Buffers which are still in use are freed when released.
+ */
+void pubsub_zmqBufferPool_destroy(pubsub_zmq_buffer_pool_t *pool);
+
+/**
+ * @brief Acquires a buffer of at least minSize bytes with a ref count of 1.
+ */
+pubsub_zmq_buffer_t* pubsub_zmqBufferPool_acquire(pubsub_zmq_buffer_pool_t *pool, size_t minSize);
+
+void pubsub_zmqBufferPool_getStatistics(pubsub_zmq_buffer_pool_t *pool, pubsub_zmq_buffer_pool_statistics_t *stats);
+
+void* pubsub_zmqBuffer_data(pubsub_zmq_buffer_t *buffer);
+
+size_t pubsub_zmqBuffer_size(const pubsub_zmq_buffer_t *buffer);
+
+void pubsub_zmqBuffer_retain(pubsub_zmq_buffer_t *buffer);
+
+/**
+ * @brief Decreases the ref count and returns the buffer to the pool when the count drops to 0.
+ */
+void pubsub_zmqBuffer_release(pubsub_zmq_buffer_t *buffer);
+
+/**
+ * @brief zmq_free_fn compatible release function, the hint must be the buffer.
+ */
+void pubsub_zmqBuffer_zmqFree(void *data, void *hint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_PUBSUB_ZMQ_BUFFER_POOL_H
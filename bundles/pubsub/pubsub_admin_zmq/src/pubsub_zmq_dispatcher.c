@@ -0,0 +1,313 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include "pubsub_zmq_dispatcher.h"
+#include "celix_threads.h"
+#include "celix_array_list.h"
+#include "celix_utils.h"
+#include "hash_map.h"
+
+#define L_WARN(...) \
+    celix_logHelper_log(dispatcher->logHelper, CELIX_LOG_LEVEL_WARNING, __VA_ARGS__)
+
+typedef struct psa_zmq_subscriber_entry {
+    pubsub_subscriber_t* subscriberSvc;
+    bool initialized; //true if the init function is called through the receive thread
+} psa_zmq_subscriber_entry_t;
+
+/**
+ * An immutable list of the subscriber entries, used by the dispatch without holding the subscribers mutex.
+ */
+typedef struct psa_zmq_subscriber_snapshot {
+    size_t size;
+    psa_zmq_subscriber_entry_t* entries[];
+} psa_zmq_subscriber_snapshot_t;
+
+struct pubsub_zmq_dispatcher {
+    celix_log_helper_t *logHelper;
+    pubsub_serializer_handler_t* serializerHandler;
+    char *scope;
+    char *topic;
+
+    struct {
+        celix_thread_mutex_t mutex; //protects map, allInitialized, the retired lists and writing current
+        celix_thread_cond_t reclaimed;
+        hash_map_t *map; //key = long svc id, value = psa_zmq_subscriber_entry_t
+        bool allInitialized;
+        psa_zmq_subscriber_snapshot_t* current; //atomic, the snapshot picked up by a new dispatch
+        size_t activeDispatches; //atomic
+        bool dispatchThreadKnown; //atomic
+        celix_thread_t dispatchThread;
+        celix_array_list_t* retiredSnapshots; //snapshots replaced while a dispatch could still use them
+        celix_array_list_t* retiredEntries; //removed entries which a dispatch could still use
+        unsigned long nrOfRetired; //atomic
+        unsigned long nrOfReclaimed; //atomic
+    } subscribers;
+};
+
+struct pubsub_zmq_received_msg {
+    pubsub_zmq_dispatcher_t *dispatcher;
+    long refCount;
+    uint32_t msgId;
+    int majorVersion;
+    int minorVersion;
+    struct iovec payload;
+    void* instance; //the shared deserialized instance, NULL if taken by a subscriber
+};
+
+pubsub_zmq_dispatcher_t* pubsub_zmqDispatcher_create(celix_log_helper_t *logHelper,
+                                                     pubsub_serializer_handler_t* serHandler,
+                                                     const char *scope,
+                                                     const char *topic) {
+    pubsub_zmq_dispatcher_t *dispatcher = calloc(1, sizeof(*dispatcher));
+    dispatcher->logHelper = logHelper;
+    dispatcher->serializerHandler = serHandler;
+    dispatcher->scope = scope == NULL ? NULL : celix_utils_strdup(scope);
+    dispatcher->topic = celix_utils_strdup(topic);
+    celixThreadMutex_create(&dispatcher->subscribers.mutex, NULL);
+    celixThreadCondition_init(&dispatcher->subscribers.reclaimed, NULL);
+    dispatcher->subscribers.map = hashMap_create(NULL, NULL, NULL, NULL);
+    dispatcher->subscribers.allInitialized = true;
+    dispatcher->subscribers.current = calloc(1, sizeof(psa_zmq_subscriber_snapshot_t));
+    dispatcher->subscribers.retiredSnapshots = celix_arrayList_create();
+    dispatcher->subscribers.retiredEntries = celix_arrayList_create();
+    return dispatcher;
+}
+
+static void pubsub_zmqDispatcher_reclaimRetired(pubsub_zmq_dispatcher_t *dispatcher) {
+    for (int i = 0; i < celix_arrayList_size(dispatcher->subscribers.retiredSnapshots); ++i) {
+        free(celix_arrayList_get(dispatcher->subscribers.retiredSnapshots, i));
+    }
+    celix_arrayList_clear(dispatcher->subscribers.retiredSnapshots);
+    for (int i = 0; i < celix_arrayList_size(dispatcher->subscribers.retiredEntries); ++i) {
+        free(celix_arrayList_get(dispatcher->subscribers.retiredEntries, i));
+    }
+    celix_arrayList_clear(dispatcher->subscribers.retiredEntries);
+    __atomic_store_n(&dispatcher->subscribers.nrOfReclaimed,
+                     __atomic_load_n(&dispatcher->subscribers.nrOfRetired, __ATOMIC_RELAXED), __ATOMIC_SEQ_CST);
+    celixThreadCondition_broadcast(&dispatcher->subscribers.reclaimed);
+}
+
+void pubsub_zmqDispatcher_destroy(pubsub_zmq_dispatcher_t *dispatcher) {
+    if (dispatcher != NULL) {
+        celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+        pubsub_zmqDispatcher_reclaimRetired(dispatcher);
+        free(dispatcher->subscribers.current);
+        hashMap_destroy(dispatcher->subscribers.map, false, true);
+        celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+
+        celix_arrayList_destroy(dispatcher->subscribers.retiredSnapshots);
+        celix_arrayList_destroy(dispatcher->subscribers.retiredEntries);
+        celixThreadCondition_destroy(&dispatcher->subscribers.reclaimed);
+        celixThreadMutex_destroy(&dispatcher->subscribers.mutex);
+        free(dispatcher->scope);
+        free(dispatcher->topic);
+        free(dispatcher);
+    }
+}
+
+/**
+ * Publishes a new snapshot of the subscriber map and retires the old snapshot (and optionally a removed entry).
+ * Must be called with the subscribers mutex locked.
+ * @return The number of retired items which must be reclaimed before the removed entry is no longer in use.
+ */
+static unsigned long pubsub_zmqDispatcher_publishSnapshot(pubsub_zmq_dispatcher_t *dispatcher, psa_zmq_subscriber_entry_t *removedEntry) {
+    size_t size = (size_t)hashMap_size(dispatcher->subscribers.map);
+    psa_zmq_subscriber_snapshot_t *snapshot = malloc(sizeof(*snapshot) + size * sizeof(psa_zmq_subscriber_entry_t*));
+    snapshot->size = 0;
+    hash_map_iterator_t iter = hashMapIterator_construct(dispatcher->subscribers.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        snapshot->entries[snapshot->size++] = hashMapIterator_nextValue(&iter);
+    }
+
+    //note retire before swapping, so that a dispatch ending after the swap notices the retired items
+    celix_arrayList_add(dispatcher->subscribers.retiredSnapshots, dispatcher->subscribers.current);
+    if (removedEntry != NULL) {
+        celix_arrayList_add(dispatcher->subscribers.retiredEntries, removedEntry);
+    }
+    unsigned long ticket = __atomic_add_fetch(&dispatcher->subscribers.nrOfRetired, 1, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&dispatcher->subscribers.current, snapshot, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&dispatcher->subscribers.activeDispatches, __ATOMIC_SEQ_CST) == 0) {
+        //a dispatch starting from now on will use the new snapshot
+        pubsub_zmqDispatcher_reclaimRetired(dispatcher);
+    }
+    return ticket;
+}
+
+void pubsub_zmqDispatcher_addSubscriber(pubsub_zmq_dispatcher_t *dispatcher, long svcId, pubsub_subscriber_t *svc) {
+    psa_zmq_subscriber_entry_t *entry = calloc(1, sizeof(*entry));
+    entry->subscriberSvc = svc;
+    entry->initialized = false;
+
+    celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+    psa_zmq_subscriber_entry_t *replaced = hashMap_put(dispatcher->subscribers.map, (void*)svcId, entry);
+    dispatcher->subscribers.allInitialized = false;
+    pubsub_zmqDispatcher_publishSnapshot(dispatcher, replaced);
+    celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+}
+
+void pubsub_zmqDispatcher_removeSubscriber(pubsub_zmq_dispatcher_t *dispatcher, long svcId) {
+    celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+    psa_zmq_subscriber_entry_t *entry = hashMap_remove(dispatcher->subscribers.map, (void*)svcId);
+    if (entry != NULL) {
+        unsigned long ticket = pubsub_zmqDispatcher_publishSnapshot(dispatcher, entry);
+        bool calledFromDispatch = __atomic_load_n(&dispatcher->subscribers.dispatchThreadKnown, __ATOMIC_ACQUIRE) &&
+                                  celixThread_equals(celixThread_self(), dispatcher->subscribers.dispatchThread);
+        while (!calledFromDispatch && __atomic_load_n(&dispatcher->subscribers.nrOfReclaimed, __ATOMIC_SEQ_CST) < ticket) {
+            celixThreadCondition_wait(&dispatcher->subscribers.reclaimed, &dispatcher->subscribers.mutex);
+        }
+    }
+    celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+}
+
+bool pubsub_zmqDispatcher_allSubscribersInitialized(pubsub_zmq_dispatcher_t *dispatcher) {
+    celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+    bool allInitialized = dispatcher->subscribers.allInitialized;
+    celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+    return allInitialized;
+}
+
+void pubsub_zmqDispatcher_initializeAllSubscribers(pubsub_zmq_dispatcher_t *dispatcher) {
+    celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+    if (!dispatcher->subscribers.allInitialized) {
+        bool allInitialized = true;
+        hash_map_iterator_t iter = hashMapIterator_construct(dispatcher->subscribers.map);
+        while (hashMapIterator_hasNext(&iter)) {
+            psa_zmq_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
+            if (!entry->initialized) {
+                int rc = 0;
+                if (entry->subscriberSvc != NULL && entry->subscriberSvc->init != NULL) {
+                    rc = entry->subscriberSvc->init(entry->subscriberSvc->handle);
+                }
+                if (rc == 0) {
+                    //note now only initialized on first subscriber entries added.
+                    entry->initialized = true;
+                } else {
+                    L_WARN("Cannot initialize subscriber svc. Got rc %i", rc);
+                    allInitialized = false;
+                }
+            }
+        }
+        dispatcher->subscribers.allInitialized = allInitialized;
+    }
+    celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+}
+
+static psa_zmq_subscriber_snapshot_t* pubsub_zmqDispatcher_acquireSnapshot(pubsub_zmq_dispatcher_t *dispatcher) {
+    if (!__atomic_load_n(&dispatcher->subscribers.dispatchThreadKnown, __ATOMIC_ACQUIRE)) {
+        celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+        dispatcher->subscribers.dispatchThread = celixThread_self();
+        __atomic_store_n(&dispatcher->subscribers.dispatchThreadKnown, true, __ATOMIC_RELEASE);
+        celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+    }
+    __atomic_add_fetch(&dispatcher->subscribers.activeDispatches, 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&dispatcher->subscribers.current, __ATOMIC_SEQ_CST);
+}
+
+static void pubsub_zmqDispatcher_releaseSnapshot(pubsub_zmq_dispatcher_t *dispatcher) {
+    if (__atomic_sub_fetch(&dispatcher->subscribers.activeDispatches, 1, __ATOMIC_SEQ_CST) == 0 &&
+        __atomic_load_n(&dispatcher->subscribers.nrOfRetired, __ATOMIC_SEQ_CST) !=
+        __atomic_load_n(&dispatcher->subscribers.nrOfReclaimed, __ATOMIC_SEQ_CST)) {
+        celixThreadMutex_lock(&dispatcher->subscribers.mutex);
+        if (__atomic_load_n(&dispatcher->subscribers.activeDispatches, __ATOMIC_SEQ_CST) == 0) {
+            pubsub_zmqDispatcher_reclaimRetired(dispatcher);
+        }
+        celixThreadMutex_unlock(&dispatcher->subscribers.mutex);
+    }
+}
+
+void pubsub_zmqDispatcher_dispatch(pubsub_zmq_dispatcher_t *dispatcher, const char *msgFqn, pubsub_zmq_received_msg_t *msg, const celix_properties_t *metadata) {
+    psa_zmq_subscriber_snapshot_t *snapshot = pubsub_zmqDispatcher_acquireSnapshot(dispatcher);
+    for (size_t i = 0; i < snapshot->size; ++i) {
+        psa_zmq_subscriber_entry_t *entry = snapshot->entries[i];
+        if (entry->subscriberSvc->receive == NULL) {
+            continue;
+        }
+        void *instance = (void*)pubsub_zmqReceivedMsg_get(msg);
+        if (instance == NULL) {
+            break;
+        }
+        bool release = true;
+        entry->subscriberSvc->receive(entry->subscriberSvc->handle, msgFqn, msg->msgId, instance, metadata, &release);
+        if (!release) {
+            //receive function has taken ownership, a next subscriber gets a newly deserialized instance
+            msg->instance = NULL;
+        }
+    }
+    pubsub_zmqDispatcher_releaseSnapshot(dispatcher);
+}
+
+static celix_status_t pubsub_zmqReceivedMsg_deserialize(pubsub_zmq_received_msg_t *msg) {
+    pubsub_zmq_dispatcher_t *dispatcher = msg->dispatcher;
+    celix_status_t status = pubsub_serializerHandler_deserialize(dispatcher->serializerHandler, msg->msgId,
+                                                                 msg->majorVersion, msg->minorVersion,
+                                                                 &msg->payload, 0, &msg->instance);
+    if (status != CELIX_SUCCESS) {
+        msg->instance = NULL;
+        L_WARN("[PSA_ZMQ_TR] Cannot deserialize msg type %s for scope/topic %s/%s",
+               pubsub_serializerHandler_getMsgFqn(dispatcher->serializerHandler, msg->msgId),
+               dispatcher->scope == NULL ? "(null)" : dispatcher->scope, dispatcher->topic);
+    }
+    return status;
+}
+
+pubsub_zmq_received_msg_t* pubsub_zmqReceivedMsg_create(pubsub_zmq_dispatcher_t *dispatcher, const pubsub_protocol_message_t *message) {
+    pubsub_zmq_received_msg_t *msg = calloc(1, sizeof(*msg));
+    msg->dispatcher = dispatcher;
+    msg->refCount = 1;
+    msg->msgId = message->header.msgId;
+    msg->majorVersion = message->header.msgMajorVersion;
+    msg->minorVersion = message->header.msgMinorVersion;
+    msg->payload.iov_base = message->payload.payload;
+    msg->payload.iov_len = message->payload.length;
+    if (pubsub_zmqReceivedMsg_deserialize(msg) != CELIX_SUCCESS) {
+        free(msg);
+        msg = NULL;
+    }
+    return msg;
+}
+
+void pubsub_zmqReceivedMsg_retain(pubsub_zmq_received_msg_t *msg) {
+    __atomic_add_fetch(&msg->refCount, 1, __ATOMIC_RELAXED);
+}
+
+void pubsub_zmqReceivedMsg_release(pubsub_zmq_received_msg_t *msg) {
+    if (msg != NULL && __atomic_sub_fetch(&msg->refCount, 1, __ATOMIC_ACQ_REL) == 0) {
+        if (msg->instance != NULL) {
+            pubsub_serializerHandler_freeDeserializedMsg(msg->dispatcher->serializerHandler, msg->msgId, msg->instance);
+        }
+        free(msg);
+    }
+}
+
+uint32_t pubsub_zmqReceivedMsg_msgId(const pubsub_zmq_received_msg_t *msg) {
+    return msg->msgId;
+}
+
+const void* pubsub_zmqReceivedMsg_get(pubsub_zmq_received_msg_t *msg) {
+    if (msg->instance == NULL) {
+        (void)pubsub_zmqReceivedMsg_deserialize(msg);
+    }
+    return msg->instance;
+}
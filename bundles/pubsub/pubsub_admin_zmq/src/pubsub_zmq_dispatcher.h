@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_PUBSUB_ZMQ_DISPATCHER_H
+#define CELIX_PUBSUB_ZMQ_DISPATCHER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <pubsub/subscriber.h>
+#include "pubsub_protocol.h"
+#include "pubsub_serializer_handler.h"
+#include "celix_log_helper.h"
+#include "celix_properties.h"
+
+/**
+ * @brief Dispatches the received messages of a topic receiver to its subscribers.
+ *
+ * The subscriber list is published as an immutable snapshot. Adding or removing a subscriber builds a new snapshot
+ * under the subscribers mutex, dispatching only holds the mutex long enough to pick up the current snapshot.
+ * Removed subscriber entries and replaced snapshots are reclaimed once no dispatch is in progress, so that
+ * removeSubscriber can return knowing that the subscriber svc is no longer used.
+ */
+typedef struct pubsub_zmq_dispatcher pubsub_zmq_dispatcher_t;
+
+/**
+ * @brief A received message, deserialized once and shared read-only by all subscribers.
+ *
+ * If a subscriber takes ownership of the shared instance (release == false), the next subscriber that needs the
+ * message gets a new instance, deserialized from the retained payload (copy-on-take).
+ * The message is ref-counted and must be released with pubsub_zmqReceivedMsg_release.
+ */
+typedef struct pubsub_zmq_received_msg pubsub_zmq_received_msg_t;
+
+pubsub_zmq_dispatcher_t* pubsub_zmqDispatcher_create(celix_log_helper_t *logHelper,
+                                                     pubsub_serializer_handler_t* serHandler,
+                                                     const char *scope,
+                                                     const char *topic);
+void pubsub_zmqDispatcher_destroy(pubsub_zmq_dispatcher_t *dispatcher);
+
+void pubsub_zmqDispatcher_addSubscriber(pubsub_zmq_dispatcher_t *dispatcher, long svcId, pubsub_subscriber_t *svc);
+
+/**
+ * @brief Removes a subscriber and waits until a dispatch in progress no longer uses it.
+ * If called from within a dispatch (e.g. from a subscriber receive callback), the subscriber entry is reclaimed
+ * after that dispatch.
+ */
+void pubsub_zmqDispatcher_removeSubscriber(pubsub_zmq_dispatcher_t *dispatcher, long svcId);
+
+bool pubsub_zmqDispatcher_allSubscribersInitialized(pubsub_zmq_dispatcher_t *dispatcher);
+
+/**
+ * @brief Calls the init function of the subscribers which are not yet initialized.
+ * Should be called from the thread which dispatches the messages.
+ */
+void pubsub_zmqDispatcher_initializeAllSubscribers(pubsub_zmq_dispatcher_t *dispatcher);
+
+/**
+ * @brief Calls the receive function of all subscribers with the shared message instance.
+ * Should only be called from a single (receive) thread.
+ */
+void pubsub_zmqDispatcher_dispatch(pubsub_zmq_dispatcher_t *dispatcher, const char *msgFqn, pubsub_zmq_received_msg_t *msg, const celix_properties_t *metadata);
+
+/**
+ * @brief Deserializes the payload of a protocol message into a shared received message.
+ *
+ * The payload is referenced and not copied, so the protocol message payload must outlive the received message.
+ * @return The received message with a ref count of 1 or NULL if the payload could not be deserialized.
+ */
+pubsub_zmq_received_msg_t* pubsub_zmqReceivedMsg_create(pubsub_zmq_dispatcher_t *dispatcher, const pubsub_protocol_message_t *message);
+
+void pubsub_zmqReceivedMsg_retain(pubsub_zmq_received_msg_t *msg);
+
+/**
+ * @brief Decreases the ref count and frees the shared instance, if still owned, when the count drops to 0.
+ */
+void pubsub_zmqReceivedMsg_release(pubsub_zmq_received_msg_t *msg);
+
+uint32_t pubsub_zmqReceivedMsg_msgId(const pubsub_zmq_received_msg_t *msg);
+
+/**
+ * @brief Returns the shared read-only instance, deserializing a new instance if the previous one was taken.
+ * @return The shared instance or NULL if deserialization failed.
+ */
+const void* pubsub_zmqReceivedMsg_get(pubsub_zmq_received_msg_t *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CELIX_PUBSUB_ZMQ_DISPATCHER_H
@@ -44,6 +44,8 @@
 #include "pubsub_interceptors_handler.h"
 #include "celix_utils_api.h"
 #include "pubsub_zmq_admin.h"
+#include "pubsub_zmq_dispatcher.h"
+#include "pubsub_latency_histogram.h"
 
 #define PSA_ZMQ_RECV_TIMEOUT 1000
 
@@ -92,11 +94,13 @@ struct pubsub_zmq_topic_receiver {
     } requestedConnections;
 
     long subscriberTrackerId;
+    pubsub_zmq_dispatcher_t *dispatcher;
+
     struct {
-        celix_thread_mutex_t mutex;
-        hash_map_t *map; //key = long svc id, value = psa_zmq_subscriber_entry_t
-        bool allInitialized;
-    } subscribers;
+        bool enabled;
+        pubsub_latency_histogram_t *endToEnd;
+        pubsub_latency_histogram_t *subscriberCallback;
+    } metrics;
 };
 
 typedef struct psa_zmq_requested_connection_entry {
@@ -105,17 +109,11 @@ typedef struct psa_zmq_requested_connection_entry {
     bool statically; //true if the connection is statically configured through the topic properties.
 } psa_zmq_requested_connection_entry_t;
 
-typedef struct psa_zmq_subscriber_entry {
-    pubsub_subscriber_t* subscriberSvc;
-    bool initialized; //true if the init function is called through the receive thread
-} psa_zmq_subscriber_entry_t;
-
 
 static void pubsub_zmqTopicReceiver_addSubscriber(void *handle, void *svc, const celix_properties_t *props);
 static void pubsub_zmqTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props);
 static void* psa_zmq_recvThread(void * data);
 static void psa_zmq_connectToAllRequestedConnections(pubsub_zmq_topic_receiver_t *receiver);
-static void psa_zmq_initializeAllSubscribers(pubsub_zmq_topic_receiver_t *receiver);
 static void psa_zmq_setupZmqContext(pubsub_zmq_topic_receiver_t *receiver, const celix_properties_t *topicProperties);
 static void psa_zmq_setupZmqSocket(pubsub_zmq_topic_receiver_t *receiver, const celix_properties_t *topicProperties);
 
@@ -201,11 +199,15 @@ pubsub_zmq_topic_receiver_t* pubsub_zmqTopicReceiver_create(celix_bundle_context
 
 
     if (receiver->zmqSock != NULL) {
-        celixThreadMutex_create(&receiver->subscribers.mutex, NULL);
         celixThreadMutex_create(&receiver->requestedConnections.mutex, NULL);
         celixThreadMutex_create(&receiver->recvThread.mutex, NULL);
 
-        receiver->subscribers.map = hashMap_create(NULL, NULL, NULL, NULL);
+        receiver->dispatcher = pubsub_zmqDispatcher_create(logHelper, serHandler, scope, topic);
+        receiver->metrics.enabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_METRICS_ENABLED, PSA_ZMQ_DEFAULT_METRICS_ENABLED);
+        if (receiver->metrics.enabled) {
+            receiver->metrics.endToEnd = pubsub_latencyHistogram_create();
+            receiver->metrics.subscriberCallback = pubsub_latencyHistogram_create();
+        }
         receiver->requestedConnections.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
     }
 
@@ -276,9 +278,7 @@ void pubsub_zmqTopicReceiver_destroy(pubsub_zmq_topic_receiver_t *receiver) {
 
         celix_bundleContext_stopTracker(receiver->ctx, receiver->subscriberTrackerId);
 
-        celixThreadMutex_lock(&receiver->subscribers.mutex);
-        hashMap_destroy(receiver->subscribers.map, false, true);
-        celixThreadMutex_unlock(&receiver->subscribers.mutex);
+        pubsub_zmqDispatcher_destroy(receiver->dispatcher);
 
         celixThreadMutex_lock(&receiver->requestedConnections.mutex);
         hash_map_iterator_t iter = hashMapIterator_construct(receiver->requestedConnections.map);
@@ -292,7 +292,6 @@ void pubsub_zmqTopicReceiver_destroy(pubsub_zmq_topic_receiver_t *receiver) {
         hashMap_destroy(receiver->requestedConnections.map, false, false);
         celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-        celixThreadMutex_destroy(&receiver->subscribers.mutex);
         celixThreadMutex_destroy(&receiver->requestedConnections.mutex);
         celixThreadMutex_destroy(&receiver->recvThread.mutex);
 
@@ -300,6 +299,8 @@ void pubsub_zmqTopicReceiver_destroy(pubsub_zmq_topic_receiver_t *receiver) {
         zmq_ctx_term(receiver->zmqCtx);
 
         pubsubInterceptorsHandler_destroy(receiver->interceptorsHandler);
+        pubsub_latencyHistogram_destroy(receiver->metrics.endToEnd);
+        pubsub_latencyHistogram_destroy(receiver->metrics.subscriberCallback);
 
         free(receiver->scope);
         free(receiver->topic);
@@ -322,6 +323,18 @@ long pubsub_zmqTopicReceiver_protocolSvcId(pubsub_zmq_topic_receiver_t *receiver
     return receiver->protocolSvcId;
 }
 
+pubsub_admin_receiver_metrics_t* pubsub_zmqTopicReceiver_metrics(pubsub_zmq_topic_receiver_t *receiver) {
+    if (!receiver->metrics.enabled) {
+        return NULL;
+    }
+    pubsub_admin_receiver_metrics_t *result = calloc(1, sizeof(*result));
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : receiver->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", receiver->topic);
+    pubsub_latencyHistogram_getMetrics(receiver->metrics.endToEnd, &result->endToEndLatency);
+    pubsub_latencyHistogram_getMetrics(receiver->metrics.subscriberCallback, &result->subscriberCallbackLatency);
+    return result;
+}
+
 void pubsub_zmqTopicReceiver_listConnections(pubsub_zmq_topic_receiver_t *receiver, celix_array_list_t *connectedUrls, celix_array_list_t *unconnectedUrls) {
     celixThreadMutex_lock(&receiver->requestedConnections.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(receiver->requestedConnections.map);
@@ -397,55 +410,27 @@ static void pubsub_zmqTopicReceiver_addSubscriber(void *handle, void *svc, const
         return;
     }
 
-    psa_zmq_subscriber_entry_t *entry = calloc(1, sizeof(*entry));
-    entry->subscriberSvc = svc;
-    entry->initialized = false;
-
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
-    hashMap_put(receiver->subscribers.map, (void*)svcId, entry);
-    receiver->subscribers.allInitialized = false;
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    pubsub_zmqDispatcher_addSubscriber(receiver->dispatcher, svcId, svc);
 }
 
 static void pubsub_zmqTopicReceiver_removeSubscriber(void *handle, void *svc, const celix_properties_t *props) {
     pubsub_zmq_topic_receiver_t *receiver = handle;
 
     long svcId = celix_properties_getAsLong(props, OSGI_FRAMEWORK_SERVICE_ID, -1);
-
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
-    psa_zmq_subscriber_entry_t *entry = hashMap_remove(receiver->subscribers.map, (void*)svcId);
-    free(entry);
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    pubsub_zmqDispatcher_removeSubscriber(receiver->dispatcher, svcId);
 }
 
-static void callReceivers(pubsub_zmq_topic_receiver_t *receiver, const char* msgFqn, const pubsub_protocol_message_t *message, void** msg, bool* release, const celix_properties_t* metadata) {
-    *release = true;
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
-    while (hashMapIterator_hasNext(&iter)) {
-        psa_zmq_subscriber_entry_t* entry = hashMapIterator_nextValue(&iter);
-        if (entry != NULL && entry->subscriberSvc->receive != NULL) {
-            entry->subscriberSvc->receive(entry->subscriberSvc->handle, msgFqn, message->header.msgId, *msg, metadata, release);
-            if (!(*release)) {
-                //receive function has taken ownership, deserialize again for new message
-                struct iovec deSerializeBuffer;
-                deSerializeBuffer.iov_base = message->payload.payload;
-                deSerializeBuffer.iov_len = message->payload.length;
-                celix_status_t status = pubsub_serializerHandler_deserialize(receiver->serializerHandler,
-                                                             message->header.msgId,
-                                                             message->header.msgMajorVersion,
-                                                             message->header.msgMinorVersion,
-                                                              &deSerializeBuffer, 0, msg);
-                if (status != CELIX_SUCCESS) {
-                    L_WARN("[PSA_ZMQ_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgFqn,
-                           receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
-                    break;
-                }
-            }
-            *release = true;
-        }
+/**
+ * Records the latency from the send timestamp, added by the sender if metrics are enabled, till the receive time.
+ * Note that this requires synchronized clocks if sender and receiver are on different hosts.
+ */
+static void psa_zmq_recordEndToEndLatency(pubsub_zmq_topic_receiver_t *receiver, const celix_properties_t *metadata, const struct timespec *receiveTime) {
+    long sendTime = celix_properties_getAsLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIMESTAMP_METADATA_KEY, -1L);
+    if (sendTime < 0) {
+        return;
     }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    long latency = (long)receiveTime->tv_sec * 1000000000L + receiveTime->tv_nsec - sendTime;
+    pubsub_latencyHistogram_record(receiver->metrics.endToEnd, latency > 0 ? (uint64_t)latency : 0);
 }
 
 static inline void processMsg(pubsub_zmq_topic_receiver_t *receiver, pubsub_protocol_message_t *message, struct timespec *receiveTime) {
@@ -454,39 +439,37 @@ static inline void processMsg(pubsub_zmq_topic_receiver_t *receiver, pubsub_prot
         L_WARN("Cannot find msg fqn for msg id %u", message->header.msgId);
         return;
     }
-    void *deserializedMsg = NULL;
     bool validVersion = pubsub_serializerHandler_isMessageSupported(receiver->serializerHandler, message->header.msgId,
                                                                     message->header.msgMajorVersion,
                                                                     message->header.msgMinorVersion);
     if (validVersion) {
-        struct iovec deSerializeBuffer;
-        deSerializeBuffer.iov_base = message->payload.payload;
-        deSerializeBuffer.iov_len = message->payload.length;
-        celix_status_t status = pubsub_serializerHandler_deserialize(receiver->serializerHandler, message->header.msgId,
-                                                                     message->header.msgMajorVersion,
-                                                                     message->header.msgMinorVersion,
-                                                                     &deSerializeBuffer, 0, &deserializedMsg);
-        if (status == CELIX_SUCCESS) {
+        //note deserialized once and shared by all subscribers, see pubsub_zmq_dispatcher.h
+        pubsub_zmq_received_msg_t *msg = pubsub_zmqReceivedMsg_create(receiver->dispatcher, message);
+        if (msg != NULL) {
             celix_properties_t *metadata = message->metadata.metadata;
             bool metadataWasNull = metadata == NULL;
-            bool cont = pubsubInterceptorHandler_invokePreReceive(receiver->interceptorsHandler, msgFqn, message->header.msgId, deserializedMsg, &metadata);
-            bool release = true;
+            bool cont = pubsubInterceptorHandler_invokePreReceive(receiver->interceptorsHandler, msgFqn, message->header.msgId, pubsub_zmqReceivedMsg_get(msg), &metadata);
             if (cont) {
-                callReceivers(receiver, msgFqn, message, &deserializedMsg, &release, metadata);
-                pubsubInterceptorHandler_invokePostReceive(receiver->interceptorsHandler, msgFqn, message->header.msgId, deserializedMsg, metadata);
+                struct timespec start;
+                if (receiver->metrics.enabled) {
+                    psa_zmq_recordEndToEndLatency(receiver, metadata, receiveTime);
+                    clock_gettime(CLOCK_MONOTONIC, &start);
+                }
+                pubsub_zmqDispatcher_dispatch(receiver->dispatcher, msgFqn, msg, metadata);
+                if (receiver->metrics.enabled) {
+                    pubsub_latencyHistogram_recordElapsed(receiver->metrics.subscriberCallback, &start);
+                }
+                if (pubsubInterceptorHandler_nrOfInterceptors(receiver->interceptorsHandler) > 0) {
+                    pubsubInterceptorHandler_invokePostReceive(receiver->interceptorsHandler, msgFqn, message->header.msgId, pubsub_zmqReceivedMsg_get(msg), metadata);
+                }
             } else {
                 L_TRACE("Skipping receive for msg type %s, based on pre receive interceptor result", msgFqn);
             }
-            if (release) {
-                pubsub_serializerHandler_freeDeserializedMsg(receiver->serializerHandler, message->header.msgId, deserializedMsg);
-            }
+            pubsub_zmqReceivedMsg_release(msg);
             if (metadataWasNull) {
                 //note that if the metadata was created by the pubsubInterceptorHandler_invokePreReceive, this needs to be deallocated
                 celix_properties_destroy(metadata);
             }
-        } else {
-            L_WARN("[PSA_ZMQ_TR] Cannot deserialize msg type %s for scope/topic %s/%s", msgFqn,
-                   receiver->scope == NULL ? "(null)" : receiver->scope, receiver->topic);
         }
     } else {
         L_WARN("[PSA_ZMQ_TR] Cannot deserialize message '%s' using %s, version mismatch. Version received: %i.%i.x, version local: %i.%i.x",
@@ -510,16 +493,14 @@ static void* psa_zmq_recvThread(void * data) {
     bool allConnected = receiver->requestedConnections.allConnected;
     celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
-    bool allInitialized = receiver->subscribers.allInitialized;
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
+    bool allInitialized = pubsub_zmqDispatcher_allSubscribersInitialized(receiver->dispatcher);
 
     while (running) {
         if (!allConnected) {
             psa_zmq_connectToAllRequestedConnections(receiver);
         }
         if (!allInitialized) {
-            psa_zmq_initializeAllSubscribers(receiver);
+            pubsub_zmqDispatcher_initializeAllSubscribers(receiver->dispatcher);
         }
 
         zmsg_t *zmsg = zmsg_recv(receiver->zmqSock);
@@ -583,9 +564,7 @@ static void* psa_zmq_recvThread(void * data) {
         allConnected = receiver->requestedConnections.allConnected;
         celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 
-        celixThreadMutex_lock(&receiver->subscribers.mutex);
-        allInitialized = receiver->subscribers.allInitialized;
-        celixThreadMutex_unlock(&receiver->subscribers.mutex);
+        allInitialized = pubsub_zmqDispatcher_allSubscribersInitialized(receiver->dispatcher);
     } // while
 
     return NULL;
@@ -613,32 +592,6 @@ static void psa_zmq_connectToAllRequestedConnections(pubsub_zmq_topic_receiver_t
     celixThreadMutex_unlock(&receiver->requestedConnections.mutex);
 }
 
-static void psa_zmq_initializeAllSubscribers(pubsub_zmq_topic_receiver_t *receiver) {
-    celixThreadMutex_lock(&receiver->subscribers.mutex);
-    if (!receiver->subscribers.allInitialized) {
-        bool allInitialized = true;
-        hash_map_iterator_t iter = hashMapIterator_construct(receiver->subscribers.map);
-        while (hashMapIterator_hasNext(&iter)) {
-            psa_zmq_subscriber_entry_t *entry = hashMapIterator_nextValue(&iter);
-            if (!entry->initialized) {
-                int rc = 0;
-                if (entry->subscriberSvc != NULL && entry->subscriberSvc->init != NULL) {
-                    rc = entry->subscriberSvc->init(entry->subscriberSvc->handle);
-                }
-                if (rc == 0) {
-                    //note now only initialized on first subscriber entries added.
-                    entry->initialized = true;
-                } else {
-                    L_WARN("Cannot initialize subscriber svc. Got rc %i", rc);
-                    allInitialized = false;
-                }
-            }
-        }
-        receiver->subscribers.allInitialized = allInitialized;
-    }
-    celixThreadMutex_unlock(&receiver->subscribers.mutex);
-}
-
 static void psa_zmq_setupZmqContext(pubsub_zmq_topic_receiver_t *receiver, const celix_properties_t *topicProperties) {
     //NOTE. ZMQ will abort when performing a sched_setscheduler without permission.
     //As result permission has to be checked first.
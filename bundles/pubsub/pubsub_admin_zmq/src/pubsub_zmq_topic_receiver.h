@@ -45,6 +45,12 @@ const char* pubsub_zmqTopicReceiver_serializerType(pubsub_zmq_topic_receiver_t *
 long pubsub_zmqTopicReceiver_protocolSvcId(pubsub_zmq_topic_receiver_t *receiver);
 void pubsub_zmqTopicReceiver_listConnections(pubsub_zmq_topic_receiver_t *receiver, celix_array_list_t *connectedUrls, celix_array_list_t *unconnectedUrls);
 
+/**
+ * @brief Creates the receiver metrics, the caller is owner of the returned metrics.
+ * @return The metrics or NULL if metrics are not enabled (PSA_ZMQ_METRICS_ENABLED).
+ */
+pubsub_admin_receiver_metrics_t* pubsub_zmqTopicReceiver_metrics(pubsub_zmq_topic_receiver_t *receiver);
+
 void pubsub_zmqTopicReceiver_connectTo(pubsub_zmq_topic_receiver_t *receiver, const char *url);
 void pubsub_zmqTopicReceiver_disconnectFrom(pubsub_zmq_topic_receiver_t *receiver, const char *url);
 
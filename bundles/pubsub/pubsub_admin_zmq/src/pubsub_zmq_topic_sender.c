@@ -36,9 +36,12 @@
 #include "celix_constants.h"
 #include "pubsub_interceptors_handler.h"
 #include "pubsub_zmq_admin.h"
+#include "pubsub_zmq_buffer_pool.h"
+#include "pubsub_latency_histogram.h"
 
 #define FIRST_SEND_DELAY_IN_SECONDS             2
 #define ZMQ_BIND_MAX_RETRY                      10
+#define ZMQ_PAYLOAD_SIZE_HINTS                  16 //note must be a power of 2
 
 #define L_DEBUG(...) \
     celix_logHelper_log(sender->logHelper, CELIX_LOG_LEVEL_DEBUG, __VA_ARGS__)
@@ -58,6 +61,19 @@ struct pubsub_zmq_topic_sender {
     uuid_t fwUUID;
     bool zeroCopyEnabled;
 
+    struct {
+        pubsub_zmq_buffer_pool_t *pool; //only used if zero copy is enabled
+        size_t headerSize;
+        size_t footerSize;
+        size_t payloadSizeHints[ZMQ_PAYLOAD_SIZE_HINTS]; //atomic, last payload size per msg id bucket
+    } zeroCopy;
+
+    struct {
+        bool enabled;
+        pubsub_latency_histogram_t *serialization;
+        pubsub_latency_histogram_t *send;
+    } metrics;
+
     pubsub_serializer_handler_t* serializerHandler;
     pubsub_interceptors_handler_t *interceptorsHandler;
 
@@ -101,13 +117,6 @@ typedef struct psa_zmq_bounded_service_entry {
     int getCount;
 } psa_zmq_bounded_service_entry_t;
 
-typedef struct psa_zmq_zerocopy_free_entry {
-    uint32_t msgId;
-    pubsub_serializer_handler_t *serHandler;
-    struct iovec *serializedOutput;
-    size_t serializedOutputLen;
-} psa_zmq_zerocopy_free_entry;
-
 
 static void* psa_zmq_getPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
 static void psa_zmq_ungetPublisherService(void *handle, const celix_bundle_t *requestingBundle, const celix_properties_t *svcProperties);
@@ -119,6 +128,7 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
         celix_log_helper_t *logHelper,
         const char *scope,
         const char *topic,
+        const celix_properties_t *topicProperties,
         pubsub_serializer_handler_t* serializerHandler,
         void *admin,
         long protocolSvcId,
@@ -139,6 +149,22 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
         uuid_parse(uuid, sender->fwUUID);
     }
     sender->zeroCopyEnabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_ZEROCOPY_ENABLED, PSA_ZMQ_DEFAULT_ZEROCOPY_ENABLED);
+    if (sender->zeroCopyEnabled) {
+        const char *bufferClasses = celix_properties_get(topicProperties, PUBSUB_ZMQ_BUFFER_POOL_CLASSES, PUBSUB_ZMQ_BUFFER_POOL_CLASSES_DEFAULT);
+        long poolSize = celix_properties_getAsLong(topicProperties, PUBSUB_ZMQ_BUFFER_POOL_SIZE, PUBSUB_ZMQ_BUFFER_POOL_SIZE_DEFAULT);
+        sender->zeroCopy.pool = pubsub_zmqBufferPool_create(bufferClasses, poolSize > 0 ? (size_t)poolSize : 0);
+        if (sender->zeroCopy.pool == NULL) {
+            L_WARN("Invalid %s '%s' for topic %s, using default '%s'", PUBSUB_ZMQ_BUFFER_POOL_CLASSES, bufferClasses, topic, PUBSUB_ZMQ_BUFFER_POOL_CLASSES_DEFAULT);
+            sender->zeroCopy.pool = pubsub_zmqBufferPool_create(PUBSUB_ZMQ_BUFFER_POOL_CLASSES_DEFAULT, poolSize > 0 ? (size_t)poolSize : 0);
+        }
+        prot->getHeaderSize(prot->handle, &sender->zeroCopy.headerSize);
+        prot->getFooterSize(prot->handle, &sender->zeroCopy.footerSize);
+    }
+    sender->metrics.enabled = celix_bundleContext_getPropertyAsBool(ctx, PSA_ZMQ_METRICS_ENABLED, PSA_ZMQ_DEFAULT_METRICS_ENABLED);
+    if (sender->metrics.enabled) {
+        sender->metrics.serialization = pubsub_latencyHistogram_create();
+        sender->metrics.send = pubsub_latencyHistogram_create();
+    }
 
     sender->interceptorsHandler = pubsubInterceptorsHandler_create(ctx, scope, topic, PUBSUB_ZMQ_ADMIN_TYPE,
                                                                    pubsub_serializerHandler_getSerializationType(serializerHandler));
@@ -282,6 +308,9 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
     }
 
     if (sender->url == NULL) {
+        pubsub_zmqBufferPool_destroy(sender->zeroCopy.pool);
+        pubsub_latencyHistogram_destroy(sender->metrics.serialization);
+        pubsub_latencyHistogram_destroy(sender->metrics.send);
         free(sender);
         sender = NULL;
     }
@@ -311,10 +340,33 @@ void pubsub_zmqTopicSender_destroy(pubsub_zmq_topic_sender_t *sender) {
         free(sender->zmqBuffers.headerBuffer);
         free(sender->zmqBuffers.metadataBuffer);
         free(sender->zmqBuffers.footerBuffer);
+        pubsub_zmqBufferPool_destroy(sender->zeroCopy.pool); //note pooled buffers still queued in zmq are freed on release
+        pubsub_latencyHistogram_destroy(sender->metrics.serialization);
+        pubsub_latencyHistogram_destroy(sender->metrics.send);
         free(sender);
     }
 }
 
+bool pubsub_zmqTopicSender_getBufferPoolStatistics(pubsub_zmq_topic_sender_t *sender, pubsub_zmq_buffer_pool_statistics_t *stats) {
+    if (sender->zeroCopy.pool == NULL) {
+        return false;
+    }
+    pubsub_zmqBufferPool_getStatistics(sender->zeroCopy.pool, stats);
+    return true;
+}
+
+pubsub_admin_sender_metrics_t* pubsub_zmqTopicSender_metrics(pubsub_zmq_topic_sender_t *sender) {
+    if (!sender->metrics.enabled) {
+        return NULL;
+    }
+    pubsub_admin_sender_metrics_t *result = calloc(1, sizeof(*result));
+    snprintf(result->scope, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->scope == NULL ? PUBSUB_DEFAULT_ENDPOINT_SCOPE : sender->scope);
+    snprintf(result->topic, PUBSUB_AMDIN_METRICS_NAME_MAX, "%s", sender->topic);
+    pubsub_latencyHistogram_getMetrics(sender->metrics.serialization, &result->serializationLatency);
+    pubsub_latencyHistogram_getMetrics(sender->metrics.send, &result->sendLatency);
+    return result;
+}
+
 const char* pubsub_zmqTopicSender_serializerType(pubsub_zmq_topic_sender_t *sender) {
     return pubsub_serializerHandler_getSerializationType(sender->serializerHandler);
 }
@@ -385,51 +437,179 @@ static void psa_zmq_ungetPublisherService(void *handle, const celix_bundle_t *re
     celixThreadMutex_unlock(&sender->boundedServices.mutex);
 }
 
-static void psa_zmq_freeMsg(void *msg, void *hint) {
-    psa_zmq_zerocopy_free_entry *entry = hint;
-    pubsub_serializerHandler_freeSerializedMsg(entry->serHandler, entry->msgId, entry->serializedOutput, entry->serializedOutputLen);
-    free(entry);
+/**
+ * Serializes the message into a pooled buffer, after reservedSize bytes for the header and footer.
+ * The buffer is sized using the payload size of the previous message with a similar msg id and if it is too small,
+ * the message is serialized again into a larger buffer.
+ */
+static celix_status_t psa_zmq_serializeIntoBuffer(pubsub_zmq_topic_sender_t *sender, unsigned int msgTypeId, const void *inMsg, size_t reservedSize, pubsub_zmq_buffer_t **bufferOut, size_t *payloadSizeOut) {
+    size_t *hint = &sender->zeroCopy.payloadSizeHints[msgTypeId & (ZMQ_PAYLOAD_SIZE_HINTS - 1)];
+    size_t neededSize = reservedSize + __atomic_load_n(hint, __ATOMIC_RELAXED);
+    celix_status_t status;
+    while (true) {
+        pubsub_zmq_buffer_t *buffer = pubsub_zmqBufferPool_acquire(sender->zeroCopy.pool, neededSize);
+        if (buffer == NULL) {
+            return CELIX_ENOMEM;
+        }
+        size_t bufferSize = pubsub_zmqBuffer_size(buffer);
+        size_t payloadSize = 0;
+        status = pubsub_serializerHandler_serializeInto(sender->serializerHandler, msgTypeId, inMsg,
+                                                        (char*)pubsub_zmqBuffer_data(buffer) + reservedSize,
+                                                        bufferSize - reservedSize, &payloadSize);
+        if (status == CELIX_SUCCESS) {
+            __atomic_store_n(hint, payloadSize, __ATOMIC_RELAXED);
+            *bufferOut = buffer;
+            *payloadSizeOut = payloadSize;
+            break;
+        }
+        pubsub_zmqBuffer_release(buffer);
+        if (status != CELIX_ENOMEM) {
+            break;
+        }
+        //buffer too small, retry with the needed size or, if not known, twice the buffer size
+        size_t newNeededSize = payloadSize > 0 ? reservedSize + payloadSize : bufferSize * 2;
+        if (newNeededSize <= bufferSize) {
+            status = CELIX_ILLEGAL_STATE;
+            break;
+        }
+        neededSize = newNeededSize;
+    }
+    return status;
 }
 
-static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
-    psa_zmq_bounded_service_entry_t *bound = handle;
-    pubsub_zmq_topic_sender_t *sender = bound->parent;
+/**
+ * Sends a part of a pooled buffer as zmq frame without copying. The frame holds a buffer ref until zmq is done with it.
+ */
+static int psa_zmq_sendBufferFrame(void *socket, pubsub_zmq_buffer_t *buffer, void *data, size_t size, int flags) {
+    zmq_msg_t msg;
+    pubsub_zmqBuffer_retain(buffer);
+    int rc = zmq_msg_init_data(&msg, data, size, pubsub_zmqBuffer_zmqFree, buffer);
+    if (rc == -1) {
+        pubsub_zmqBuffer_release(buffer);
+        return rc;
+    }
+    rc = zmq_msg_send(&msg, socket, flags);
+    if (rc == -1) {
+        zmq_msg_close(&msg);
+    }
+    return rc;
+}
 
-    const char* msgFqn;
-    int majorVersion;
-    int minorversion;
-    celix_status_t status = pubsub_serializerHandler_getMsgInfo(sender->serializerHandler, msgTypeId, &msgFqn, &majorVersion, &minorversion);
-    if (status != CELIX_SUCCESS) {
-        L_WARN("Cannot find serializer for msg id %u for serializer %s", msgTypeId, pubsub_serializerHandler_getSerializationType(sender->serializerHandler));
-        celix_properties_destroy(metadata);
-        return status;
+/**
+ * Zero copy send. The header, footer, payload and (if it fits) metadata are written into a single pooled buffer:
+ * [header | footer | payload | metadata]. The zmq frames reference parts of this buffer.
+ */
+static bool psa_zmq_sendZeroCopy(pubsub_zmq_topic_sender_t *sender, unsigned int msgTypeId, int majorVersion, int minorVersion, pubsub_zmq_buffer_t *buffer, size_t payloadSize, celix_properties_t *metadata) {
+    char *data = pubsub_zmqBuffer_data(buffer);
+    size_t headerSize = sender->zeroCopy.headerSize;
+    size_t footerSize = sender->zeroCopy.footerSize;
+    void *socket = zsock_resolve(sender->zmq.socket);
+
+    pubsub_protocol_message_t message;
+    message.payload.payload = data + headerSize + footerSize;
+    message.payload.length = payloadSize;
+    message.header.convertEndianess = 0;
+
+    void *payloadData = NULL;
+    size_t payloadLength = 0;
+    sender->protocol->encodePayload(sender->protocol->handle, &message, &payloadData, &payloadLength);
+
+    size_t metadataSize = 0;
+    pubsub_zmq_buffer_t *metadataBuffer = buffer;
+    void *metadataData = NULL;
+    if (metadata != NULL) {
+        message.metadata.metadata = metadata;
+        sender->protocol->encodeMetadata(sender->protocol->handle, &message, &sender->zmqBuffers.metadataBuffer, &sender->zmqBuffers.metadataBufferSize, &metadataSize);
+        size_t used = headerSize + footerSize + payloadSize;
+        if (metadataSize <= pubsub_zmqBuffer_size(buffer) - used) {
+            metadataData = data + used;
+        } else if (metadataSize > 0) {
+            metadataBuffer = pubsub_zmqBufferPool_acquire(sender->zeroCopy.pool, metadataSize);
+            metadataData = metadataBuffer == NULL ? NULL : pubsub_zmqBuffer_data(metadataBuffer);
+        }
+        if (metadataData == NULL) {
+            L_WARN("Cannot allocate buffer for metadata, sending message without metadata");
+            metadataBuffer = buffer;
+            metadataSize = 0;
+        } else if (metadataSize > 0) {
+            memcpy(metadataData, sender->zmqBuffers.metadataBuffer, metadataSize);
+        }
+    } else {
+        message.metadata.metadata = NULL;
     }
 
-    bool cont = pubsubInterceptorHandler_invokePreSend(sender->interceptorsHandler, msgFqn, msgTypeId, inMsg, &metadata);
-    if (!cont) {
-        L_DEBUG("Cancel send based on pubsub interceptor cancel return");
-        celix_properties_destroy(metadata);
-        return status;
+    //note the protocol encodes the header and footer in place, because the provided buffer length matches
+    void *footerData = data + headerSize;
+    size_t footerLength = footerSize;
+    sender->protocol->encodeFooter(sender->protocol->handle, &message, &footerData, &footerLength);
+
+    message.header.msgId = msgTypeId;
+    message.header.seqNr = __atomic_fetch_add(&sender->seqNr, 1, __ATOMIC_RELAXED);
+    message.header.msgMajorVersion = majorVersion;
+    message.header.msgMinorVersion = minorVersion;
+    message.header.payloadSize = payloadLength;
+    message.header.metadataSize = metadataSize;
+    message.header.payloadPartSize = payloadLength;
+    message.header.payloadOffset = 0;
+    message.header.isLastSegment = 1;
+
+    void *headerData = data;
+    size_t headerLength = headerSize;
+    sender->protocol->encodeHeader(sender->protocol->handle, &message, &headerData, &headerLength);
+
+    //send header
+    int rc = psa_zmq_sendBufferFrame(socket, buffer, headerData, headerLength, ZMQ_SNDMORE);
+    if (rc == -1) {
+        L_WARN("Error sending header msg. %s", strerror(errno));
     }
 
-    size_t serializedIoVecOutputLen = 0; //entry->serializedIoVecOutputLen;
-    struct iovec *serializedIoVecOutput = NULL;
-    status = pubsub_serializerHandler_serialize(sender->serializerHandler, msgTypeId, inMsg, &serializedIoVecOutput, &serializedIoVecOutputLen);
+    //send payload
+    if (rc != -1) {
+        int flag = ((metadataSize > 0) || (footerLength > 0)) ? ZMQ_SNDMORE : 0;
+        if (payloadData == message.payload.payload) {
+            rc = psa_zmq_sendBufferFrame(socket, buffer, payloadData, payloadLength, flag);
+        } else {
+            //protocol encoded the payload in a new buffer
+            zmq_msg_t msg;
+            zmq_msg_init_size(&msg, payloadLength);
+            memcpy(zmq_msg_data(&msg), payloadData, payloadLength);
+            rc = zmq_msg_send(&msg, socket, flag);
+            if (rc == -1) {
+                zmq_msg_close(&msg);
+            }
+        }
+        if (rc == -1) {
+            L_WARN("Error sending payload msg. %s", strerror(errno));
+        }
+    }
 
-    if (status != CELIX_SUCCESS /*serialization not ok*/) {
-        L_WARN("[PSA_ZMQ_TS] Error serialize message of type %s for scope/topic %s/%s", msgFqn, sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
-        celix_properties_destroy(metadata);
-        return status;
+    //send metadata
+    if (rc != -1 && metadataSize > 0) {
+        int flag = (footerLength > 0) ? ZMQ_SNDMORE : 0;
+        rc = psa_zmq_sendBufferFrame(socket, metadataBuffer, metadataData, metadataSize, flag);
+        if (rc == -1) {
+            L_WARN("Error sending metadata msg. %s", strerror(errno));
+        }
     }
 
-    // Some ZMQ functions are not thread-safe, but this atomic compare exchange ensures one access at a time.
-    // Also protect sender->zmqBuffers (header, meta and footer)
-    bool expected = false;
-    while(!__atomic_compare_exchange_n(&sender->zmqBuffers.dataLock, &expected, true, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
-        expected = false;
-        usleep(5);
+    //send footer
+    if (rc != -1 && footerLength > 0) {
+        rc = psa_zmq_sendBufferFrame(socket, buffer, footerData, footerLength, 0);
+        if (rc == -1) {
+            L_WARN("Error sending footer msg. %s", strerror(errno));
+        }
     }
 
+    if (metadataBuffer != buffer) {
+        pubsub_zmqBuffer_release(metadataBuffer);
+    }
+    if (payloadData != message.payload.payload) {
+        free(payloadData);
+    }
+    return rc != -1;
+}
+
+static bool psa_zmq_sendCopy(pubsub_zmq_topic_sender_t *sender, unsigned int msgTypeId, int majorVersion, int minorVersion, struct iovec *serializedIoVecOutput, celix_properties_t *metadata) {
     pubsub_protocol_message_t message;
     message.payload.payload = serializedIoVecOutput->iov_base;
     message.payload.length = serializedIoVecOutput->iov_len;
@@ -452,7 +632,7 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
     message.header.msgId = msgTypeId;
     message.header.seqNr = __atomic_fetch_add(&sender->seqNr, 1, __ATOMIC_RELAXED);
     message.header.msgMajorVersion = majorVersion;
-    message.header.msgMinorVersion = minorversion;
+    message.header.msgMinorVersion = minorVersion;
     message.header.payloadSize = payloadLength;
     message.header.metadataSize = metadataSize;
     message.header.payloadPartSize = payloadLength;
@@ -461,87 +641,107 @@ static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, co
 
     sender->protocol->encodeHeader(sender->protocol->handle, &message, &sender->zmqBuffers.headerBuffer, &sender->zmqBuffers.headerBufferSize);
 
-    errno = 0;
-    bool sendOk;
-    if (bound->parent->zeroCopyEnabled) {
-        zmq_msg_t msg1; // Header
-        zmq_msg_t msg2; // Payload
-        zmq_msg_t msg3; // Metadata
-        zmq_msg_t msg4; // Footer
-        void *socket = zsock_resolve(sender->zmq.socket);
-        psa_zmq_zerocopy_free_entry *freeMsgEntry = malloc(sizeof(psa_zmq_zerocopy_free_entry)); //NOTE should be improved. Not really zero copy
-        freeMsgEntry->serHandler = sender->serializerHandler;
-        freeMsgEntry->msgId = msgTypeId;
-        freeMsgEntry->serializedOutput = serializedIoVecOutput;
-        freeMsgEntry->serializedOutputLen = serializedIoVecOutputLen;
-
-        zmq_msg_init_data(&msg1, sender->zmqBuffers.headerBuffer, sender->zmqBuffers.headerBufferSize, NULL, NULL);
-        //send header
-        int rc = zmq_msg_send(&msg1, socket, ZMQ_SNDMORE);
-        if (rc == -1) {
-            L_WARN("Error sending header msg. %s", strerror(errno));
-            zmq_msg_close(&msg1);
-        }
+    zmsg_t *msg = zmsg_new();
+    zmsg_addmem(msg, sender->zmqBuffers.headerBuffer, sender->zmqBuffers.headerBufferSize);
+    zmsg_addmem(msg, payloadData, payloadLength);
+    if (metadataSize > 0) {
+        zmsg_addmem(msg, sender->zmqBuffers.metadataBuffer, metadataSize);
+    }
+    if (sender->zmqBuffers.footerBufferSize > 0) {
+        zmsg_addmem(msg, sender->zmqBuffers.footerBuffer, sender->zmqBuffers.footerBufferSize);
+    }
+    int rc = zmsg_send(&msg, sender->zmq.socket);
+    bool sendOk = rc == 0;
 
-        //send Payload
-        if (rc > 0) {
-            int flag = ((metadataSize > 0)  || (sender->zmqBuffers.footerBufferSize > 0)) ? ZMQ_SNDMORE : 0;
-            zmq_msg_init_data(&msg2, payloadData, payloadLength, psa_zmq_freeMsg, freeMsgEntry);
-            rc = zmq_msg_send(&msg2, socket, flag);
-            if (rc == -1) {
-                L_WARN("Error sending payload msg. %s", strerror(errno));
-                zmq_msg_close(&msg2);
-            }
-        }
+    if (!sendOk) {
+        zmsg_destroy(&msg); //if send was not ok, no owner change -> destroy msg
+    }
 
-        //send MetaData
-        if (rc > 0 && metadataSize > 0) {
-            int flag = (sender->zmqBuffers.footerBufferSize > 0 ) ? ZMQ_SNDMORE : 0;
-            zmq_msg_init_data(&msg3, sender->zmqBuffers.metadataBuffer, metadataSize, NULL, NULL);
-            rc = zmq_msg_send(&msg3, socket, flag);
-            if (rc == -1) {
-                L_WARN("Error sending metadata msg. %s", strerror(errno));
-                zmq_msg_close(&msg3);
-            }
-        }
+    // Note: serialized Payload is deleted by serializer
+    if (payloadData && (payloadData != message.payload.payload)) {
+        free(payloadData);
+    }
+    return sendOk;
+}
 
-        //send Footer
-        if (rc > 0 && sender->zmqBuffers.footerBufferSize > 0) {
-            zmq_msg_init_data(&msg4, sender->zmqBuffers.footerBuffer, sender->zmqBuffers.footerBufferSize, NULL, NULL);
-            rc = zmq_msg_send(&msg4, socket, 0);
-            if (rc == -1) {
-                L_WARN("Error sending footer msg. %s", strerror(errno));
-                zmq_msg_close(&msg4);
-            }
-        }
-        sendOk = rc > 0;
+static int psa_zmq_topicPublicationSend(void* handle, unsigned int msgTypeId, const void *inMsg, celix_properties_t *metadata) {
+    psa_zmq_bounded_service_entry_t *bound = handle;
+    pubsub_zmq_topic_sender_t *sender = bound->parent;
+
+    const char* msgFqn;
+    int majorVersion;
+    int minorversion;
+    celix_status_t status = pubsub_serializerHandler_getMsgInfo(sender->serializerHandler, msgTypeId, &msgFqn, &majorVersion, &minorversion);
+    if (status != CELIX_SUCCESS) {
+        L_WARN("Cannot find serializer for msg id %u for serializer %s", msgTypeId, pubsub_serializerHandler_getSerializationType(sender->serializerHandler));
+        celix_properties_destroy(metadata);
+        return status;
+    }
+
+    bool cont = pubsubInterceptorHandler_invokePreSend(sender->interceptorsHandler, msgFqn, msgTypeId, inMsg, &metadata);
+    if (!cont) {
+        L_DEBUG("Cancel send based on pubsub interceptor cancel return");
+        celix_properties_destroy(metadata);
+        return status;
+    }
+
+    size_t serializedIoVecOutputLen = 0; //entry->serializedIoVecOutputLen;
+    struct iovec *serializedIoVecOutput = NULL;
+    pubsub_zmq_buffer_t *buffer = NULL;
+    size_t payloadSize = 0;
+    struct timespec start;
+    if (sender->metrics.enabled) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+    if (sender->zeroCopy.pool != NULL) {
+        size_t reservedSize = sender->zeroCopy.headerSize + sender->zeroCopy.footerSize;
+        status = psa_zmq_serializeIntoBuffer(sender, msgTypeId, inMsg, reservedSize, &buffer, &payloadSize);
     } else {
-        //no zero copy
-        zmsg_t *msg = zmsg_new();
-        zmsg_addmem(msg, sender->zmqBuffers.headerBuffer, sender->zmqBuffers.headerBufferSize);
-        zmsg_addmem(msg, payloadData, payloadLength);
-        if (metadataSize > 0) {
-            zmsg_addmem(msg, sender->zmqBuffers.metadataBuffer, metadataSize);
-        }
-        if (sender->zmqBuffers.footerBufferSize > 0) {
-            zmsg_addmem(msg, sender->zmqBuffers.footerBuffer, sender->zmqBuffers.footerBufferSize);
-        }
-        int rc = zmsg_send(&msg, sender->zmq.socket);
-        sendOk = rc == 0;
+        status = pubsub_serializerHandler_serialize(sender->serializerHandler, msgTypeId, inMsg, &serializedIoVecOutput, &serializedIoVecOutputLen);
+    }
 
-        if (!sendOk) {
-            zmsg_destroy(&msg); //if send was not ok, no owner change -> destroy msg
-        }
+    if (status != CELIX_SUCCESS /*serialization not ok*/) {
+        L_WARN("[PSA_ZMQ_TS] Error serialize message of type %s for scope/topic %s/%s", msgFqn, sender->scope == NULL ? "(null)" : sender->scope, sender->topic);
+        celix_properties_destroy(metadata);
+        return status;
+    }
 
-        // Note: serialized Payload is deleted by serializer
-        if (payloadData && (payloadData != message.payload.payload)) {
-            free(payloadData);
+    if (sender->metrics.enabled) {
+        pubsub_latencyHistogram_recordElapsed(sender->metrics.serialization, &start);
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        if (metadata == NULL) {
+            metadata = celix_properties_create();
         }
+        celix_properties_setLong(metadata, PUBSUB_ADMIN_METRICS_SEND_TIMESTAMP_METADATA_KEY, (long)now.tv_sec * 1000000000L + now.tv_nsec);
+    }
+
+    // Some ZMQ functions are not thread-safe, but this atomic compare exchange ensures one access at a time.
+    // Also protect sender->zmqBuffers (header, meta and footer)
+    bool expected = false;
+    while(!__atomic_compare_exchange_n(&sender->zmqBuffers.dataLock, &expected, true, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        expected = false;
+        usleep(5);
+    }
+
+    errno = 0;
+    bool sendOk;
+    if (sender->metrics.enabled) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+    if (buffer != NULL) {
+        sendOk = psa_zmq_sendZeroCopy(sender, msgTypeId, majorVersion, minorversion, buffer, payloadSize, metadata);
+    } else {
+        sendOk = psa_zmq_sendCopy(sender, msgTypeId, majorVersion, minorversion, serializedIoVecOutput, metadata);
+    }
+    if (sender->metrics.enabled && sendOk) {
+        pubsub_latencyHistogram_recordElapsed(sender->metrics.send, &start);
     }
     __atomic_store_n(&sender->zmqBuffers.dataLock, false, __ATOMIC_RELEASE);
     pubsubInterceptorHandler_invokePostSend(sender->interceptorsHandler, msgFqn, msgTypeId, inMsg, metadata);
 
-    if (!bound->parent->zeroCopyEnabled && serializedIoVecOutput) {
+    pubsub_zmqBuffer_release(buffer); //note zmq holds its own buffer refs until the frames are sent
+    if (serializedIoVecOutput) {
         pubsub_serializerHandler_freeSerializedMsg(sender->serializerHandler, msgTypeId, serializedIoVecOutput, serializedIoVecOutputLen);
     }
 
@@ -24,6 +24,7 @@
 #include "celix_bundle_context.h"
 #include "pubsub_admin_metrics.h"
 #include "celix_log_helper.h"
+#include "pubsub_zmq_buffer_pool.h"
 
 typedef struct pubsub_zmq_topic_sender pubsub_zmq_topic_sender_t;
 
@@ -32,6 +33,7 @@ pubsub_zmq_topic_sender_t* pubsub_zmqTopicSender_create(
         celix_log_helper_t *logHelper,
         const char *scope,
         const char *topic,
+        const celix_properties_t *topicProperties,
         pubsub_serializer_handler_t* serializerHandler,
         void *admin,
         long protocolSvcId,
@@ -51,5 +53,17 @@ bool pubsub_zmqTopicSender_isStatic(pubsub_zmq_topic_sender_t *sender);
 const char* pubsub_zmqTopicSender_serializerType(pubsub_zmq_topic_sender_t *sender);
 long pubsub_zmqTopicSender_protocolSvcId(pubsub_zmq_topic_sender_t *sender);
 
+/**
+ * @brief Returns the statistics of the buffer pool used for zero copy sending.
+ * @return false if zero copy is not enabled for the sender.
+ */
+bool pubsub_zmqTopicSender_getBufferPoolStatistics(pubsub_zmq_topic_sender_t *sender, pubsub_zmq_buffer_pool_statistics_t *stats);
+
+/**
+ * @brief Creates the sender metrics, the caller is owner of the returned metrics.
+ * @return The metrics or NULL if metrics are not enabled (PSA_ZMQ_METRICS_ENABLED).
+ */
+pubsub_admin_sender_metrics_t* pubsub_zmqTopicSender_metrics(pubsub_zmq_topic_sender_t *sender);
+
 
 #endif //CELIX_PUBSUB_ZMQ_TOPIC_SENDER_H
@@ -23,6 +23,7 @@
 
 #include <celix_api.h>
 #include "pubsub_message_serialization_service.h"
+#include "AllocationCounter.h"
 
 class PubSubAvrobinSerializationProviderTestSuite : public ::testing::Test {
 public:
@@ -106,3 +107,65 @@ TEST_F(PubSubAvrobinSerializationProviderTestSuite, SerializeAndDeserializeTest)
     bool called = celix_bundleContext_useServiceWithOptions(ctx.get(), &opts);
     EXPECT_TRUE(called);
 }
+
+TEST_F(PubSubAvrobinSerializationProviderTestSuite, SerializeIntoWithoutAllocationTest) {
+    if (!pubsub_test::isAllocationCountingSupported()) {
+        GTEST_SKIP() << "Counting allocations is not supported for this build";
+    }
+
+    struct poi1 {
+        struct {
+            double lat;
+            double lon;
+        } location;
+        const char *name;
+    };
+
+    poi1 input;
+    input.location.lat = 42;
+    input.location.lon = 43;
+    input.name = "test";
+
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_NAME;
+    opts.filter.filter = "(msg.fqn=poi1)";
+    opts.callbackHandle = static_cast<void*>(&input);
+    opts.use = [](void *handle, void *svc) {
+        auto* ser = static_cast<pubsub_message_serialization_service_t*>(svc);
+        ASSERT_TRUE(ser->serializeInto != nullptr);
+        char buffer[256];
+        size_t outSize = 0;
+        int rc = ser->serializeInto(ser->handle, handle, buffer, sizeof(buffer), &outSize);
+        ASSERT_EQ(CELIX_SUCCESS, rc);
+        size_t firstSize = outSize;
+
+        pubsub_test::startCountingAllocations();
+        for (int i = 0; i < 100; ++i) {
+            rc |= ser->serializeInto(ser->handle, handle, buffer, sizeof(buffer), &outSize);
+        }
+        size_t nrOfAllocations = pubsub_test::stopCountingAllocations();
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        EXPECT_EQ(0, nrOfAllocations);
+        EXPECT_EQ(firstSize, outSize);
+
+        //the buffer contains the same serialized message as serialize
+        struct iovec inVec;
+        inVec.iov_base = buffer;
+        inVec.iov_len = outSize;
+        poi1* output = nullptr;
+        rc = ser->deserialize(ser->handle, &inVec, 1, (void**)(&output));
+        ASSERT_EQ(CELIX_SUCCESS, rc);
+        EXPECT_EQ(42, output->location.lat);
+        EXPECT_EQ(43, output->location.lon);
+        EXPECT_STREQ("test", output->name);
+        ser->freeDeserializedMsg(ser->handle, output);
+
+        //buffer too small, the needed size is returned
+        size_t neededSize = 0;
+        rc = ser->serializeInto(ser->handle, handle, buffer, 8, &neededSize);
+        EXPECT_EQ(CELIX_ENOMEM, rc);
+        EXPECT_EQ(firstSize, neededSize);
+    };
+    bool called = celix_bundleContext_useServiceWithOptions(ctx.get(), &opts);
+    EXPECT_TRUE(called);
+}
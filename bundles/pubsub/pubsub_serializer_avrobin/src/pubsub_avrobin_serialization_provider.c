@@ -22,7 +22,6 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
-#include <assert.h>
 
 #include "avrobin_serializer.h"
 #include "dyn_message.h"
@@ -83,6 +82,19 @@ void pubsub_avrobinSerializationProvider_freeSerializeMsg(pubsub_serialization_e
     }
 }
 
+static celix_status_t pubsub_avrobinSerializationProvider_serializeInto(pubsub_serialization_entry_t* entry, const void* msg, void* buffer, size_t bufferSize, size_t* outputSize) {
+    celix_status_t status = CELIX_SUCCESS;
+    dyn_type* dynType;
+    dynMessage_getMessageType(entry->msgType, &dynType);
+
+    size_t serializedLen = 0;
+    if (avrobinSerializer_serializeInto(dynType, msg, buffer, bufferSize, &serializedLen) != 0) {
+        status = serializedLen > bufferSize ? CELIX_ENOMEM : CELIX_ILLEGAL_ARGUMENT;
+    }
+    *outputSize = serializedLen;
+    return status;
+}
+
 celix_status_t pubsub_avrobinSerializationProvider_deserialize(pubsub_serialization_entry_t* entry, const struct iovec* input, size_t inputIovLen, void **out) {
     celix_status_t status = CELIX_SUCCESS;
     if (input == NULL) return CELIX_BUNDLE_EXCEPTION;
@@ -90,9 +102,7 @@ celix_status_t pubsub_avrobinSerializationProvider_deserialize(pubsub_serializat
     dyn_type* dynType;
     dynMessage_getMessageType(entry->msgType, &dynType);
 
-    assert(inputIovLen == 1);
-
-    if (avrobinSerializer_deserialize(dynType, (uint8_t *)input->iov_base, input->iov_len, &msg) != 0) {
+    if (avrobinSerializer_deserializeIoVec(dynType, input, inputIovLen, &msg) != 0) {
         status = CELIX_BUNDLE_EXCEPTION;
     } else{
         *out = msg;
@@ -110,7 +120,7 @@ void pubsub_avrobinSerializationProvider_freeDeserializeMsg(pubsub_serialization
 }
 
 pubsub_serialization_provider_t* pubsub_avrobinSerializationProvider_create(celix_bundle_context_t* ctx)  {
-    pubsub_serialization_provider_t* provider = pubsub_serializationProvider_create(ctx, "avrobin", false, 0, pubsub_avrobinSerializationProvider_serialize, pubsub_avrobinSerializationProvider_freeSerializeMsg, pubsub_avrobinSerializationProvider_deserialize, pubsub_avrobinSerializationProvider_freeDeserializeMsg);
+    pubsub_serialization_provider_t* provider = pubsub_serializationProvider_create(ctx, "avrobin", false, 0, pubsub_avrobinSerializationProvider_serialize, pubsub_avrobinSerializationProvider_freeSerializeMsg, pubsub_avrobinSerializationProvider_deserialize, pubsub_avrobinSerializationProvider_freeDeserializeMsg, pubsub_avrobinSerializationProvider_serializeInto);
     avrobinSerializer_logSetup(dfi_log, pubsub_serializationProvider_getLogHelper(provider), 1);
     return provider;
 }
@@ -20,11 +20,13 @@
 #include "gtest/gtest.h"
 
 #include <memory>
+#include <string>
 
 #include "celix_framework_factory.h"
 #include "celix_constants.h"
 #include "celix_bundle_context.h"
 #include "pubsub_message_serialization_service.h"
+#include "AllocationCounter.h"
 
 class PubSubJsonSerializationProviderTestSuite : public ::testing::Test {
 public:
@@ -115,3 +117,47 @@ TEST_F(PubSubJsonSerializationProviderTestSuite, DeserializeTest) {
     bool called = celix_bundleContext_useServiceWithOptions(ctx.get(), &opts);
     EXPECT_TRUE(called);
 }
+
+TEST_F(PubSubJsonSerializationProviderTestSuite, SerializeIntoWithoutAllocationTest) {
+    if (!pubsub_test::isAllocationCountingSupported()) {
+        GTEST_SKIP() << "Counting allocations is not supported for this build";
+    }
+
+    poi1 p;
+    p.location.lat = 42;
+    p.location.lon = 43;
+    p.name = "test";
+
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_NAME;
+    opts.filter.filter = "(msg.fqn=poi1)";
+    opts.callbackHandle = static_cast<void*>(&p);
+    opts.use = [](void *handle, void *svc) {
+        auto* ser = static_cast<pubsub_message_serialization_service_t*>(svc);
+        ASSERT_TRUE(ser->serializeInto != nullptr);
+        char buffer[256];
+        size_t outSize = 0;
+        int rc = ser->serializeInto(ser->handle, handle, buffer, sizeof(buffer), &outSize);
+        ASSERT_EQ(CELIX_SUCCESS, rc);
+        std::string json{buffer, outSize};
+        EXPECT_TRUE(json.find("\"lat\":42") != std::string::npos);
+        EXPECT_TRUE(json.find("\"name\":\"test\"") != std::string::npos);
+
+        pubsub_test::startCountingAllocations();
+        for (int i = 0; i < 100; ++i) {
+            rc |= ser->serializeInto(ser->handle, handle, buffer, sizeof(buffer), &outSize);
+        }
+        size_t nrOfAllocations = pubsub_test::stopCountingAllocations();
+        EXPECT_EQ(CELIX_SUCCESS, rc);
+        EXPECT_EQ(0, nrOfAllocations);
+        EXPECT_EQ(json, std::string(buffer, outSize));
+
+        //buffer too small, the needed size is returned
+        size_t neededSize = 0;
+        rc = ser->serializeInto(ser->handle, handle, buffer, 8, &neededSize);
+        EXPECT_EQ(CELIX_ENOMEM, rc);
+        EXPECT_EQ(json.size(), neededSize);
+    };
+    bool called = celix_bundleContext_useServiceWithOptions(ctx.get(), &opts);
+    EXPECT_TRUE(called);
+}
@@ -81,6 +81,19 @@ static void pubsub_jsonSerializationProvider_freeSerializeMsg(pubsub_serializati
     }
 }
 
+static celix_status_t pubsub_jsonSerializationProvider_serializeInto(pubsub_serialization_entry_t* entry, const void* msg, void* buffer, size_t bufferSize, size_t* outputSize) {
+    celix_status_t status = CELIX_SUCCESS;
+    dyn_type* dynType;
+    dynMessage_getMessageType(entry->msgType, &dynType);
+
+    size_t jsonLen = 0;
+    if (jsonSerializer_serializeInto(dynType, msg, buffer, bufferSize, &jsonLen) != 0) {
+        status = jsonLen > bufferSize ? CELIX_ENOMEM : CELIX_ILLEGAL_ARGUMENT;
+    }
+    *outputSize = jsonLen;
+    return status;
+}
+
 static celix_status_t pubsub_jsonSerializationProvider_deserialize(pubsub_serialization_entry_t* entry, const struct iovec* input, size_t inputIovLen __attribute__((unused)), void **out) {
     celix_status_t status = CELIX_SUCCESS;
     if (input == NULL) return CELIX_BUNDLE_EXCEPTION;
@@ -106,7 +119,7 @@ static void pubsub_jsonSerializationProvider_freeDeserializeMsg(pubsub_serializa
 }
 
 pubsub_serialization_provider_t* pubsub_jsonSerializationProvider_create(celix_bundle_context_t* ctx)  {
-    pubsub_serialization_provider_t* provider = pubsub_serializationProvider_create(ctx, "json", true, 0, pubsub_jsonSerializationProvider_serialize, pubsub_jsonSerializationProvider_freeSerializeMsg, pubsub_jsonSerializationProvider_deserialize, pubsub_jsonSerializationProvider_freeDeserializeMsg);
+    pubsub_serialization_provider_t* provider = pubsub_serializationProvider_create(ctx, "json", true, 0, pubsub_jsonSerializationProvider_serialize, pubsub_jsonSerializationProvider_freeSerializeMsg, pubsub_jsonSerializationProvider_deserialize, pubsub_jsonSerializationProvider_freeDeserializeMsg, pubsub_jsonSerializationProvider_serializeInto);
     jsonSerializer_logSetup(dfi_log, pubsub_serializationProvider_getLogHelper(provider), 1);;
     return provider;
 }
@@ -0,0 +1,107 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "pubsub_latency_histogram.h"
+
+class PubSubLatencyHistogramTestSuite : public ::testing::Test {
+public:
+    PubSubLatencyHistogramTestSuite() : histogram{pubsub_latencyHistogram_create(), pubsub_latencyHistogram_destroy} {}
+
+    std::shared_ptr<pubsub_latency_histogram_t> histogram;
+};
+
+TEST_F(PubSubLatencyHistogramTestSuite, EmptyHistogram) {
+    EXPECT_EQ(0, pubsub_latencyHistogram_count(histogram.get()));
+    EXPECT_EQ(0, pubsub_latencyHistogram_valueAtPercentile(histogram.get(), 50.0));
+
+    pubsub_admin_latency_metrics_t metrics;
+    pubsub_latencyHistogram_getMetrics(histogram.get(), &metrics);
+    EXPECT_EQ(0, metrics.count);
+    EXPECT_EQ(0.0, metrics.maxInSeconds);
+    EXPECT_EQ(0.0, metrics.p99InSeconds);
+}
+
+TEST_F(PubSubLatencyHistogramTestSuite, SmallValuesAreExact) {
+    for (uint64_t i = 1; i <= 20; ++i) {
+        pubsub_latencyHistogram_record(histogram.get(), i);
+    }
+    EXPECT_EQ(20, pubsub_latencyHistogram_count(histogram.get()));
+    EXPECT_EQ(10, pubsub_latencyHistogram_valueAtPercentile(histogram.get(), 50.0));
+    EXPECT_EQ(18, pubsub_latencyHistogram_valueAtPercentile(histogram.get(), 90.0));
+    EXPECT_EQ(20, pubsub_latencyHistogram_valueAtPercentile(histogram.get(), 100.0));
+    EXPECT_EQ(1, pubsub_latencyHistogram_valueAtPercentile(histogram.get(), 0.0));
+}
+
+TEST_F(PubSubLatencyHistogramTestSuite, RelativeErrorIsBounded) {
+    //1us .. 10ms uniform in steps of 1us
+    for (uint64_t i = 1; i <= 10000; ++i) {
+        pubsub_latencyHistogram_record(histogram.get(), i * 1000);
+    }
+    const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+    for (double p : percentiles) {
+        auto expected = static_cast<double>(p / 100.0 * 10000 * 1000);
+        auto value = static_cast<double>(pubsub_latencyHistogram_valueAtPercentile(histogram.get(), p));
+        EXPECT_GE(value, expected) << "percentile " << p;
+        EXPECT_LE(value, expected * (1.0 + 1.0 / 32.0)) << "percentile " << p;
+    }
+
+    pubsub_admin_latency_metrics_t metrics;
+    pubsub_latencyHistogram_getMetrics(histogram.get(), &metrics);
+    EXPECT_EQ(10000, metrics.count);
+    EXPECT_DOUBLE_EQ(0.000001, metrics.minInSeconds);
+    EXPECT_DOUBLE_EQ(0.01, metrics.maxInSeconds);
+    EXPECT_NEAR(0.0050005, metrics.averageInSeconds, 1e-9);
+    EXPECT_NEAR(0.005, metrics.p50InSeconds, 0.005 / 32.0);
+    EXPECT_NEAR(0.00999, metrics.p999InSeconds, 0.01 / 32.0);
+    EXPECT_LE(metrics.p999InSeconds, metrics.maxInSeconds);
+}
+
+TEST_F(PubSubLatencyHistogramTestSuite, LargeValuesAreClamped) {
+    pubsub_latencyHistogram_record(histogram.get(), UINT64_MAX);
+    pubsub_latencyHistogram_record(histogram.get(), 1ULL << 50);
+    EXPECT_EQ(2, pubsub_latencyHistogram_count(histogram.get()));
+    EXPECT_GE(pubsub_latencyHistogram_valueAtPercentile(histogram.get(), 50.0), (1ULL << PUBSUB_LATENCY_HISTOGRAM_MAX_VALUE_BITS) - (1ULL << (PUBSUB_LATENCY_HISTOGRAM_MAX_VALUE_BITS - PUBSUB_LATENCY_HISTOGRAM_SUB_BUCKET_BITS)));
+}
+
+TEST_F(PubSubLatencyHistogramTestSuite, ConcurrentRecording) {
+    const int nrOfThreads = 4;
+    const uint64_t nrOfValues = 100000;
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < nrOfThreads; ++t) {
+        threads.emplace_back([this, t, nrOfValues]{
+            for (uint64_t i = 0; i < nrOfValues; ++i) {
+                pubsub_latencyHistogram_record(histogram.get(), 100 + (uint64_t)t);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    pubsub_admin_latency_metrics_t metrics;
+    pubsub_latencyHistogram_getMetrics(histogram.get(), &metrics);
+    EXPECT_EQ(nrOfThreads * nrOfValues, metrics.count);
+    EXPECT_DOUBLE_EQ(100e-9, metrics.minInSeconds);
+    EXPECT_DOUBLE_EQ(103e-9, metrics.maxInSeconds);
+}
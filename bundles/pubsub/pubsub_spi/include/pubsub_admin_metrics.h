@@ -32,6 +32,27 @@ extern "C" {
 
 #define PUBSUB_AMDIN_METRICS_NAME_MAX       1024
 
+/**
+ * Metadata entry used by PSAs with enabled metrics to pass the send time (CLOCK_REALTIME, in nanoseconds since
+ * epoch) of a message to the receiver, so that the receiver can measure the end-to-end latency.
+ */
+#define PUBSUB_ADMIN_METRICS_SEND_TIMESTAMP_METADATA_KEY    "celix.pubsub.send.timestamp"
+
+/**
+ * Latency metrics based on a histogram of the recorded values (see pubsub_latency_histogram.h).
+ * All values are 0 if count is 0.
+ */
+typedef struct pubsub_admin_latency_metrics {
+    unsigned long count;
+    double minInSeconds;
+    double maxInSeconds;
+    double averageInSeconds;
+    double p50InSeconds;
+    double p90InSeconds;
+    double p99InSeconds;
+    double p999InSeconds;
+} pubsub_admin_latency_metrics_t;
+
 typedef struct pubsub_admin_sender_msg_type_metrics {
     long bndId;
     char typeFqn[PUBSUB_AMDIN_METRICS_NAME_MAX];
@@ -50,6 +71,8 @@ typedef struct pubsub_admin_sender_metrics {
     unsigned long nrOfUnknownMessagesRetrieved;
     unsigned int nrOfmsgMetrics;
     pubsub_admin_sender_msg_type_metrics_t *msgMetrics; //size = nrOfMessageTypes
+    pubsub_admin_latency_metrics_t serializationLatency;
+    pubsub_admin_latency_metrics_t sendLatency; //time spend in the send call(s) of the transport
 } pubsub_admin_sender_metrics_t;
 
 typedef struct pubsub_admin_receiver_metrics {
@@ -73,6 +96,8 @@ typedef struct pubsub_admin_receiver_metrics {
             double maxDelayInSeconds;
         } *origins;
     } *msgTypes;
+    pubsub_admin_latency_metrics_t endToEndLatency; //from send timestamp (metadata) till received
+    pubsub_admin_latency_metrics_t subscriberCallbackLatency; //time spend in the subscriber receive callbacks
 } pubsub_admin_receiver_metrics_t;
 
 
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PUBSUB_LATENCY_HISTOGRAM_H_
+#define PUBSUB_LATENCY_HISTOGRAM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <time.h>
+#include "pubsub_admin_metrics.h"
+
+/**
+ * The number of sub buckets per power of two is 2^PUBSUB_LATENCY_HISTOGRAM_SUB_BUCKET_BITS.
+ * With 5 bits the relative error of a recorded value is at most 1/32 (~3%).
+ */
+#define PUBSUB_LATENCY_HISTOGRAM_SUB_BUCKET_BITS    5
+
+/**
+ * Values up to 2^PUBSUB_LATENCY_HISTOGRAM_MAX_VALUE_BITS ns (~18 minutes) are tracked,
+ * larger values are counted in the highest bucket.
+ */
+#define PUBSUB_LATENCY_HISTOGRAM_MAX_VALUE_BITS     40
+
+/**
+ * @brief A log-linear (HDR style) latency histogram with nanosecond values.
+ *
+ * Every power of two is divided in a fixed number of linear sub buckets, so that the relative error is bounded
+ * independent of the magnitude of the value. Recording is lock-free and can be done concurrently from multiple
+ * threads, reading the percentiles gives a (not necessarily atomic) snapshot of the recorded values.
+ */
+typedef struct pubsub_latency_histogram pubsub_latency_histogram_t;
+
+pubsub_latency_histogram_t* pubsub_latencyHistogram_create(void);
+
+void pubsub_latencyHistogram_destroy(pubsub_latency_histogram_t *histogram);
+
+/**
+ * @brief Records a value in nanoseconds.
+ */
+void pubsub_latencyHistogram_record(pubsub_latency_histogram_t *histogram, uint64_t valueInNs);
+
+/**
+ * @brief Records the elapsed time since the provided start time (CLOCK_MONOTONIC).
+ */
+void pubsub_latencyHistogram_recordElapsed(pubsub_latency_histogram_t *histogram, const struct timespec *start);
+
+/**
+ * @brief Returns the nr of recorded values.
+ */
+uint64_t pubsub_latencyHistogram_count(pubsub_latency_histogram_t *histogram);
+
+/**
+ * @brief Returns the value in nanoseconds at the provided percentile (0 - 100), or 0 if no values are recorded.
+ * The value is the highest value equivalent to the bucket of the percentile, capped by the recorded max value.
+ */
+uint64_t pubsub_latencyHistogram_valueAtPercentile(pubsub_latency_histogram_t *histogram, double percentile);
+
+/**
+ * @brief Fills the latency metrics (count, min, max, average and percentiles) from the recorded values.
+ */
+void pubsub_latencyHistogram_getMetrics(pubsub_latency_histogram_t *histogram, pubsub_admin_latency_metrics_t *metrics);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PUBSUB_LATENCY_HISTOGRAM_H_ */
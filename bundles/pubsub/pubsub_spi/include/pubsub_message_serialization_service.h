@@ -30,9 +30,12 @@ extern "C" {
 #include "sys/uio.h"
 
 #define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_NAME      "pubsub_message_serialization_service"
-#define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_VERSION   "1.0.0"
+#define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_VERSION   "1.1.0"
 #define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_RANGE     "[1,2)"
 
+//The service version since which the serializeInto member is part of the service struct.
+#define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZE_INTO_VERSION "1.1.0"
+
 #define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZATION_TYPE_PROPERTY     "serialization.type"
 #define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_MSG_FQN_PROPERTY                "msg.fqn"
 #define PUBSUB_MESSAGE_SERIALIZATION_SERVICE_MSG_VERSION_PROPERTY            "msg.version"
@@ -94,6 +97,25 @@ typedef struct pubsub_message_serialization_service {
      */
     void (*freeDeserializedMsg)(void* handle, void* msg);
 
+    /**
+     * @brief Optional. Serialize a message directly into a caller provided buffer.
+     *
+     * Added in service version 1.1.0 (PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZE_INTO_VERSION). Users should only
+     * use this function for services registered with a service version of 1.1.0 or higher, because providers
+     * registered with version 1.0.0 do not know this member.
+     * Can be NULL, in which case users will fall back to serialize and copy the iovec output.
+     *
+     * @param handle        The pubsub message serialization service handle.
+     * @param input         A pointer to the message object
+     * @param buffer        The buffer to serialize the message into.
+     * @param bufferSize    The size of the buffer.
+     * @param outputSize    Output pointer to the size of the serialized message.
+     *                      If the buffer is too small, this is set to the needed size (if known, otherwise 0).
+     * @return              CELIX_SUCCESS on success, CELIX_ENOMEM if the buffer is too small or CELIX_ILLEGAL_ARGUMENT
+     *                      if serialization failed.
+     */
+    celix_status_t (*serializeInto)(void* handle, const void* input, void* buffer, size_t bufferSize, size_t* outputSize);
+
 } pubsub_message_serialization_service_t;
 
 #ifdef __cplusplus
@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pubsub_latency_histogram.h"
+
+#define SUB_BUCKET_BITS     PUBSUB_LATENCY_HISTOGRAM_SUB_BUCKET_BITS
+#define SUB_BUCKET_COUNT    (1UL << SUB_BUCKET_BITS)
+#define MAX_VALUE           ((1ULL << PUBSUB_LATENCY_HISTOGRAM_MAX_VALUE_BITS) - 1)
+#define NR_OF_BUCKETS       ((PUBSUB_LATENCY_HISTOGRAM_MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT)
+
+struct pubsub_latency_histogram {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[NR_OF_BUCKETS];
+};
+
+/**
+ * Values below 2^SUB_BUCKET_BITS have their own bucket. Larger values are shifted, so that the most significant
+ * SUB_BUCKET_BITS + 1 bits select the sub bucket within the bucket range of the power of two.
+ */
+static size_t pubsub_latencyHistogram_bucketIndex(uint64_t value) {
+    if (value > MAX_VALUE) {
+        value = MAX_VALUE;
+    }
+    if (value < SUB_BUCKET_COUNT) {
+        return (size_t)value;
+    }
+    unsigned int msb = 63 - (unsigned int)__builtin_clzll(value);
+    unsigned int shift = msb - SUB_BUCKET_BITS;
+    return ((size_t)shift << SUB_BUCKET_BITS) + (size_t)(value >> shift);
+}
+
+static uint64_t pubsub_latencyHistogram_highestValueOfBucket(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    unsigned int shift = (unsigned int)(index >> SUB_BUCKET_BITS) - 1;
+    uint64_t subBucket = index - ((size_t)shift << SUB_BUCKET_BITS);
+    return (subBucket << shift) + (1ULL << shift) - 1;
+}
+
+pubsub_latency_histogram_t* pubsub_latencyHistogram_create(void) {
+    pubsub_latency_histogram_t *histogram = calloc(1, sizeof(*histogram));
+    if (histogram != NULL) {
+        histogram->min = UINT64_MAX;
+    }
+    return histogram;
+}
+
+void pubsub_latencyHistogram_destroy(pubsub_latency_histogram_t *histogram) {
+    free(histogram);
+}
+
+void pubsub_latencyHistogram_record(pubsub_latency_histogram_t *histogram, uint64_t valueInNs) {
+    __atomic_fetch_add(&histogram->buckets[pubsub_latencyHistogram_bucketIndex(valueInNs)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->sum, valueInNs, __ATOMIC_RELAXED);
+
+    uint64_t current = __atomic_load_n(&histogram->min, __ATOMIC_RELAXED);
+    while (valueInNs < current && !__atomic_compare_exchange_n(&histogram->min, &current, valueInNs, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        //retry, current is updated with the actual min
+    }
+    current = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    while (valueInNs > current && !__atomic_compare_exchange_n(&histogram->max, &current, valueInNs, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        //retry, current is updated with the actual max
+    }
+    __atomic_fetch_add(&histogram->count, 1, __ATOMIC_RELEASE);
+}
+
+void pubsub_latencyHistogram_recordElapsed(pubsub_latency_histogram_t *histogram, const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t elapsed = (int64_t)(now.tv_sec - start->tv_sec) * 1000000000LL + (now.tv_nsec - start->tv_nsec);
+    pubsub_latencyHistogram_record(histogram, elapsed > 0 ? (uint64_t)elapsed : 0);
+}
+
+uint64_t pubsub_latencyHistogram_count(pubsub_latency_histogram_t *histogram) {
+    return __atomic_load_n(&histogram->count, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Finds the values at the requested percentiles with a single pass over the buckets.
+ * The percentiles must be sorted ascending.
+ */
+static void pubsub_latencyHistogram_valuesAtPercentiles(pubsub_latency_histogram_t *histogram, const double *percentiles, uint64_t *values, size_t nrOfPercentiles) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < NR_OF_BUCKETS; ++i) {
+        total += __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+    }
+    memset(values, 0, nrOfPercentiles * sizeof(*values));
+    if (total == 0) {
+        return;
+    }
+    uint64_t max = __atomic_load_n(&histogram->max, __ATOMIC_RELAXED);
+    uint64_t cumulative = 0;
+    size_t p = 0;
+    for (size_t i = 0; i < NR_OF_BUCKETS && p < nrOfPercentiles; ++i) {
+        cumulative += __atomic_load_n(&histogram->buckets[i], __ATOMIC_RELAXED);
+        while (p < nrOfPercentiles) {
+            double exactRank = percentiles[p] / 100.0 * (double)total;
+            uint64_t rank = (uint64_t)exactRank;
+            if ((double)rank < exactRank || rank == 0) {
+                rank += 1; //rounded up, at least the first value
+            }
+            if (cumulative < rank) {
+                break;
+            }
+            uint64_t value = pubsub_latencyHistogram_highestValueOfBucket(i);
+            values[p++] = value > max ? max : value;
+        }
+    }
+    for (; p < nrOfPercentiles; ++p) {
+        values[p] = max; //note buckets updated during the pass
+    }
+}
+
+uint64_t pubsub_latencyHistogram_valueAtPercentile(pubsub_latency_histogram_t *histogram, double percentile) {
+    uint64_t value = 0;
+    pubsub_latencyHistogram_valuesAtPercentiles(histogram, &percentile, &value, 1);
+    return value;
+}
+
+void pubsub_latencyHistogram_getMetrics(pubsub_latency_histogram_t *histogram, pubsub_admin_latency_metrics_t *metrics) {
+    static const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+    uint64_t values[sizeof(percentiles) / sizeof(percentiles[0])];
+
+    memset(metrics, 0, sizeof(*metrics));
+    uint64_t count = pubsub_latencyHistogram_count(histogram);
+    if (count == 0) {
+        return;
+    }
+    pubsub_latencyHistogram_valuesAtPercentiles(histogram, percentiles, values, sizeof(percentiles) / sizeof(percentiles[0]));
+    metrics->count = (unsigned long)count;
+    metrics->minInSeconds = (double)__atomic_load_n(&histogram->min, __ATOMIC_RELAXED) / 1e9;
+    metrics->maxInSeconds = (double)__atomic_load_n(&histogram->max, __ATOMIC_RELAXED) / 1e9;
+    metrics->averageInSeconds = (double)__atomic_load_n(&histogram->sum, __ATOMIC_RELAXED) / (double)count / 1e9;
+    metrics->p50InSeconds = (double)values[0] / 1e9;
+    metrics->p90InSeconds = (double)values[1] / 1e9;
+    metrics->p99InSeconds = (double)values[2] / 1e9;
+    metrics->p999InSeconds = (double)values[3] / 1e9;
+}
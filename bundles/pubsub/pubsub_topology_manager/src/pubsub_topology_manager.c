@@ -30,6 +30,7 @@
 #include "celix_array_list.h"
 #include "celix_bundle_context.h"
 #include "celix_constants.h"
+#include "celix_utils.h"
 #include "utils.h"
 #include "celix_log_helper.h"
 
@@ -45,6 +46,72 @@
 
 static void *pstm_psaHandlingThread(void *data);
 
+static void pstm_dirtyKeys_init(pstm_dirty_keys_t *keys) {
+    keys->senders = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+    keys->receivers = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+    keys->endpoints = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+}
+
+static void pstm_dirtyKeys_clear(pstm_dirty_keys_t *keys) {
+    hashMap_clear(keys->senders, true, false);
+    hashMap_clear(keys->receivers, true, false);
+    hashMap_clear(keys->endpoints, true, false);
+}
+
+static void pstm_dirtyKeys_deinit(pstm_dirty_keys_t *keys) {
+    hashMap_destroy(keys->senders, true, false);
+    hashMap_destroy(keys->receivers, true, false);
+    hashMap_destroy(keys->endpoints, true, false);
+}
+
+static bool pstm_dirtyKeys_isEmpty(pstm_dirty_keys_t *keys) {
+    return hashMap_isEmpty(keys->senders) && hashMap_isEmpty(keys->receivers) && hashMap_isEmpty(keys->endpoints);
+}
+
+static void pstm_dirtyKeys_addKey(hash_map_t *keys, const char *key) {
+    if (!hashMap_containsKey(keys, key)) {
+        hashMap_put(keys, celix_utils_strdup(key), NULL);
+    }
+}
+
+/**
+ * Moves all keys from the source to the destination, which takes over ownership of the keys.
+ */
+static void pstm_dirtyKeys_moveKeys(hash_map_t *src, hash_map_t *dst) {
+    hash_map_iterator_t iter = hashMapIterator_construct(src);
+    while (hashMapIterator_hasNext(&iter)) {
+        char *key = hashMapIterator_nextKey(&iter);
+        if (hashMap_containsKey(dst, key)) {
+            free(key);
+        } else {
+            hashMap_put(dst, key, NULL);
+        }
+    }
+    hashMap_clear(src, false, false);
+}
+
+static void pstm_wakeupPsaHandling(pubsub_topology_manager_t *manager) {
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
+    celixThreadCondition_broadcast(&manager->psaHandling.cond);
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+}
+
+static void pstm_markDirtyKey(pubsub_topology_manager_t *manager, hash_map_t *keys, const char *key) {
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
+    pstm_dirtyKeys_addKey(keys, key);
+    celixThreadCondition_broadcast(&manager->psaHandling.cond);
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+}
+
+/**
+ * Marks a key for a retry, without waking up the psa handling thread.
+ */
+static void pstm_markRetryKey(pubsub_topology_manager_t *manager, hash_map_t *keys, const char *key) {
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
+    pstm_dirtyKeys_addKey(keys, key);
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+}
+
 celix_status_t pubsub_topologyManager_create(celix_bundle_context_t *context, celix_log_helper_t *logHelper, pubsub_topology_manager_t **out) {
     celix_status_t status = CELIX_SUCCESS;
 
@@ -67,6 +134,8 @@ celix_status_t pubsub_topologyManager_create(celix_bundle_context_t *context, ce
     status |= celixThreadMutex_create(&manager->psaHandling.mutex, NULL);
 
     status |= celixThreadCondition_init(&manager->psaHandling.cond, NULL);
+    pstm_dirtyKeys_init(&manager->psaHandling.dirty);
+    pstm_dirtyKeys_init(&manager->psaHandling.retry);
 
     manager->discoveredEndpoints.map = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
     manager->announceEndpointListeners.list = celix_arrayList_create();
@@ -97,6 +166,8 @@ celix_status_t pubsub_topologyManager_destroy(pubsub_topology_manager_t *manager
     celixThreadCondition_broadcast(&manager->psaHandling.cond);
     celixThreadMutex_unlock(&manager->psaHandling.mutex);
     celixThread_join(manager->psaHandling.thread, NULL);
+    pstm_dirtyKeys_deinit(&manager->psaHandling.dirty);
+    pstm_dirtyKeys_deinit(&manager->psaHandling.retry);
 
     celixThreadMutex_lock(&manager->pubsubadmins.mutex);
     hashMap_destroy(manager->pubsubadmins.map, false, false);
@@ -197,32 +268,48 @@ void pubsub_topologyManager_psaAdded(void *handle, void *svc, const celix_proper
     int needsRematchCount = 0;
 
     celixThreadMutex_lock(&manager->topicSenders.mutex);
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(manager->topicSenders.map);
     while (hashMapIterator_hasNext(&iter)) {
         pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
         entry->matching.needsMatch = true;
+        pstm_dirtyKeys_addKey(manager->psaHandling.dirty.senders, entry->scopeAndTopicKey);
         ++needsRematchCount;
     }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
     celixThreadMutex_unlock(&manager->topicSenders.mutex);
     celixThreadMutex_lock(&manager->topicReceivers.mutex);
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
     iter = hashMapIterator_construct(manager->topicReceivers.map);
     while (hashMapIterator_hasNext(&iter)) {
         pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
         entry->matching.needsMatch = true;
+        pstm_dirtyKeys_addKey(manager->psaHandling.dirty.receivers, entry->scopeAndTopicKey);
         ++needsRematchCount;
     }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
     celixThreadMutex_unlock(&manager->topicReceivers.mutex);
 
+    //The new PSA can also match the discovered endpoints for which no psa is selected
+    celixThreadMutex_lock(&manager->discoveredEndpoints.mutex);
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
+    iter = hashMapIterator_construct(manager->discoveredEndpoints.map);
+    while (hashMapIterator_hasNext(&iter)) {
+        pstm_discovered_endpoint_entry_t *entry = hashMapIterator_nextValue(&iter);
+        if (entry->selectedPsaSvcId < 0) {
+            pstm_dirtyKeys_addKey(manager->psaHandling.dirty.endpoints, entry->uuid);
+        }
+    }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+    celixThreadMutex_unlock(&manager->discoveredEndpoints.mutex);
+
     if (needsRematchCount > 0) {
         celix_logHelper_info(manager->loghelper,
                       "A new PSA is added after at least one active publisher/provided. \
                 It is preferred that all PSA are started before publiser/subscriber are started!\n\
                 Current topic/sender count is %i", needsRematchCount);
-        celixThreadMutex_lock(&manager->psaHandling.mutex);
-        celixThreadCondition_broadcast(&manager->psaHandling.cond);
-        celixThreadMutex_unlock(&manager->psaHandling.mutex);
     }
-
+    pstm_wakeupPsaHandling(manager);
 }
 
 void pubsub_topologyManager_psaRemoved(void *handle, void *svc __attribute__((unused)), const celix_properties_t *props) {
@@ -239,13 +326,16 @@ void pubsub_topologyManager_psaRemoved(void *handle, void *svc __attribute__((un
 
     // Remove the svcId from the discovered endpoint, because the service is not available
     celixThreadMutex_lock(&manager->discoveredEndpoints.mutex);
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
     hash_map_iterator_t iter_endpoint = hashMapIterator_construct(manager->discoveredEndpoints.map);
     while (hashMapIterator_hasNext(&iter_endpoint)) {
         pstm_discovered_endpoint_entry_t *entry = hashMapIterator_nextValue(&iter_endpoint);
         if (entry != NULL && entry->selectedPsaSvcId > 0 && entry->selectedPsaSvcId == svcId) {
             entry->selectedPsaSvcId = -1L; //NOTE not selected a psa anymore
+            pstm_dirtyKeys_addKey(manager->psaHandling.dirty.endpoints, entry->uuid);
         }
     }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
     celixThreadMutex_unlock(&manager->discoveredEndpoints.mutex);
 
     //NOTE psa shutdown will teardown topic receivers / topic senders
@@ -254,6 +344,7 @@ void pubsub_topologyManager_psaRemoved(void *handle, void *svc __attribute__((un
 
     celix_array_list_t* revokedEndpoints = celix_arrayList_create();
     celixThreadMutex_lock(&manager->topicSenders.mutex);
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
     hash_map_iterator_t iter = hashMapIterator_construct(manager->topicSenders.map);
     while (hashMapIterator_hasNext(&iter)) {
         pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
@@ -267,11 +358,14 @@ void pubsub_topologyManager_psaRemoved(void *handle, void *svc __attribute__((un
             entry->matching.selectedProtocolSvcId = -1L;
             entry->matching.selectedPsaSvcId = -1L;
             entry->endpoint = NULL;
+            pstm_dirtyKeys_addKey(manager->psaHandling.dirty.senders, entry->scopeAndTopicKey);
         }
     }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
     celixThreadMutex_unlock(&manager->topicSenders.mutex);
 
     celixThreadMutex_lock(&manager->topicReceivers.mutex);
+    celixThreadMutex_lock(&manager->psaHandling.mutex);
     iter = hashMapIterator_construct(manager->topicReceivers.map);
     while (hashMapIterator_hasNext(&iter)) {
         pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
@@ -285,8 +379,10 @@ void pubsub_topologyManager_psaRemoved(void *handle, void *svc __attribute__((un
             entry->matching.selectedProtocolSvcId = -1L;
             entry->matching.selectedPsaSvcId = -1L;
             entry->endpoint = NULL;
+            pstm_dirtyKeys_addKey(manager->psaHandling.dirty.receivers, entry->scopeAndTopicKey);
         }
     }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
     celixThreadMutex_unlock(&manager->topicReceivers.mutex);
 
     /* de-announce all senders & receiver endpoints */
@@ -303,9 +399,7 @@ void pubsub_topologyManager_psaRemoved(void *handle, void *svc __attribute__((un
     }
     celix_arrayList_destroy(revokedEndpoints);
 
-    celixThreadMutex_lock(&manager->psaHandling.mutex);
-    celixThreadCondition_broadcast(&manager->psaHandling.cond);
-    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+    pstm_wakeupPsaHandling(manager);
 }
 
 void pubsub_topologyManager_subscriberAdded(void *handle, void *svc __attribute__((unused)), const celix_properties_t *props, const celix_bundle_t *bnd) {
@@ -350,14 +444,10 @@ void pubsub_topologyManager_subscriberAdded(void *handle, void *svc __attribute_
         celix_logHelper_trace(manager->loghelper, "Created new topic receiver entry %s", entry->scopeAndTopicKey);
     }
     //signal psa handling thread
-    bool triggerCondition = (entry->usageCount == 1);
-    celixThreadMutex_unlock(&manager->topicReceivers.mutex);
-
-    if (triggerCondition) {
-        celixThreadMutex_lock(&manager->psaHandling.mutex);
-        celixThreadCondition_broadcast(&manager->psaHandling.cond);
-        celixThreadMutex_unlock(&manager->psaHandling.mutex);
+    if (entry->usageCount == 1) {
+        pstm_markDirtyKey(manager, manager->psaHandling.dirty.receivers, entry->scopeAndTopicKey);
     }
+    celixThreadMutex_unlock(&manager->topicReceivers.mutex);
 }
 
 void pubsub_topologyManager_subscriberRemoved(void *handle, void *svc __attribute__((unused)), const celix_properties_t *props, const celix_bundle_t *bnd) {
@@ -379,11 +469,13 @@ void pubsub_topologyManager_subscriberRemoved(void *handle, void *svc __attribut
     pstm_topic_receiver_or_sender_entry_t *entry = hashMap_get(manager->topicReceivers.map, scopeAndTopicKey);
     if (entry != NULL) {
         entry->usageCount -= 1;
+        if (entry->usageCount <= 0) {
+            //signal psa handling thread to teardown the topic receiver
+            pstm_markDirtyKey(manager, manager->psaHandling.dirty.receivers, entry->scopeAndTopicKey);
+        }
     }
     celixThreadMutex_unlock(&manager->topicReceivers.mutex);
     free(scopeAndTopicKey);
-
-    //NOTE not waking up psaHandling thread, topic receiver does not need to be removed immediately.
 }
 
 void pubsub_topologyManager_pubsubAnnounceEndpointListenerAdded(void *handle, void *svc, const celix_properties_t *props __attribute__((unused))) {
@@ -494,15 +586,10 @@ void pubsub_topologyManager_publisherTrackerAdded(void *handle, const celix_serv
         celix_logHelper_trace(manager->loghelper, "Created new topic sender entry %s", entry->scopeAndTopicKey);
     }
     //new entry -> wakeup psaHandling thread
-    bool triggerCondition = (entry->usageCount == 1);
-
-    celixThreadMutex_unlock(&manager->topicSenders.mutex);
-
-    if (triggerCondition) {
-        celixThreadMutex_lock(&manager->psaHandling.mutex);
-        celixThreadCondition_broadcast(&manager->psaHandling.cond);
-        celixThreadMutex_unlock(&manager->psaHandling.mutex);
+    if (entry->usageCount == 1) {
+        pstm_markDirtyKey(manager, manager->psaHandling.dirty.senders, entry->scopeAndTopicKey);
     }
+    celixThreadMutex_unlock(&manager->topicSenders.mutex);
 }
 
 void pubsub_topologyManager_publisherTrackerRemoved(void *handle, const celix_service_tracker_info_t *info) {
@@ -530,6 +617,10 @@ void pubsub_topologyManager_publisherTrackerRemoved(void *handle, const celix_se
     pstm_topic_receiver_or_sender_entry_t *entry = hashMap_get(manager->topicSenders.map, scopeAndTopicKey);
     if (entry != NULL) {
         entry->usageCount -= 1;
+        if (entry->usageCount <= 0) {
+            //signal psa handling thread to teardown the topic sender
+            pstm_markDirtyKey(manager, manager->psaHandling.dirty.senders, entry->scopeAndTopicKey);
+        }
     }
     celixThreadMutex_unlock(&manager->topicSenders.mutex);
 
@@ -538,8 +629,6 @@ void pubsub_topologyManager_publisherTrackerRemoved(void *handle, const celix_se
     if (scopeFromFilter != NULL) {
         free(scopeFromFilter);
     }
-
-    //NOTE not waking up psaHandling thread, topic sender does not need to be removed immediately.
 }
 
 celix_status_t pubsub_topologyManager_addDiscoveredEndpoint(void *handle, const celix_properties_t *endpoint) {
@@ -552,7 +641,6 @@ celix_status_t pubsub_topologyManager_addDiscoveredEndpoint(void *handle, const
     // 1) See if endpoint is already discovered, if so increase usage count.
     // 1) If not, find matching psa using the matchEndpoint
     // 2) if found call addEndpoint of the matching psa
-    bool triggerCondition = false;
 
     if (manager->verbose) {
         celix_logHelper_trace(manager->loghelper,
@@ -580,17 +668,10 @@ celix_status_t pubsub_topologyManager_addDiscoveredEndpoint(void *handle, const
         celix_logHelper_trace(manager->loghelper, "Created new discovered endpoint entry %s", uuid);
 
         //waking up psa handling thread to select psa
-        triggerCondition = true;
-
+        pstm_markDirtyKey(manager, manager->psaHandling.dirty.endpoints, entry->uuid);
     }
     celixThreadMutex_unlock(&manager->discoveredEndpoints.mutex);
 
-    if (triggerCondition) {
-        celixThreadMutex_lock(&manager->psaHandling.mutex);
-        celixThreadCondition_broadcast(&manager->psaHandling.cond);
-        celixThreadMutex_unlock(&manager->psaHandling.mutex);
-    }
-
     return status;
 }
 
@@ -663,15 +744,15 @@ static void pstm_teardownTopicSenderCallback(void *handle, void *svc) {
 }
 
 //Note called on pstm update thread
-static void pstm_teardownTopicSenders(pubsub_topology_manager_t *manager) {
+static void pstm_teardownTopicSenders(pubsub_topology_manager_t *manager, hash_map_t *dirtyKeys) {
     celix_array_list_t* revokeEndpoints = celix_arrayList_create();
     celix_array_list_t* teardownEntries = celix_arrayList_create();
 
     celixThreadMutex_lock(&manager->topicSenders.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(manager->topicSenders.map);
+    hash_map_iterator_t iter = hashMapIterator_construct(dirtyKeys);
     while (hashMapIterator_hasNext(&iter)) {
-        pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
-
+        const char *key = hashMapIterator_nextKey(&iter);
+        pstm_topic_receiver_or_sender_entry_t *entry = hashMap_get(manager->topicSenders.map, key);
         if (entry != NULL && (entry->usageCount <= 0 || entry->matching.needsMatch)) {
             if (manager->verbose && entry->endpoint != NULL) {
                 celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG,
@@ -689,7 +770,7 @@ static void pstm_teardownTopicSenders(pubsub_topology_manager_t *manager) {
             //cleanup entry
             if (entry->usageCount <= 0) {
                 //no usage -> remove
-                hashMapIterator_remove(&iter);
+                hashMap_remove(manager->topicSenders.map, key);
                 free(entry->scopeAndTopicKey);
                 if (entry->scope != NULL) {
                     free(entry->scope);
@@ -755,14 +836,15 @@ static void pstm_teardownTopicReceiverCallback(void *handle, void *svc) {
     psa->teardownTopicReceiver(psa->handle, entry->scope, entry->topic);
 }
 
-static void pstm_teardownTopicReceivers(pubsub_topology_manager_t *manager) {
+static void pstm_teardownTopicReceivers(pubsub_topology_manager_t *manager, hash_map_t *dirtyKeys) {
     celix_array_list_t* revokeEndpoints = celix_arrayList_create();
     celix_array_list_t* teardownEntries = celix_arrayList_create();
 
     celixThreadMutex_lock(&manager->topicReceivers.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(manager->topicReceivers.map);
+    hash_map_iterator_t iter = hashMapIterator_construct(dirtyKeys);
     while (hashMapIterator_hasNext(&iter)) {
-        pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
+        const char *key = hashMapIterator_nextKey(&iter);
+        pstm_topic_receiver_or_sender_entry_t *entry = hashMap_get(manager->topicReceivers.map, key);
         if (entry != NULL && (entry->usageCount <= 0 || entry->matching.needsMatch)) {
             if (manager->verbose && entry->endpoint != NULL) {
                 const char *adminType = celix_properties_get(entry->endpoint, PUBSUB_ENDPOINT_ADMIN_TYPE, "!Error!");
@@ -782,7 +864,7 @@ static void pstm_teardownTopicReceivers(pubsub_topology_manager_t *manager) {
 
             if (entry->usageCount <= 0) {
                 //no usage -> remove
-                hashMapIterator_remove(&iter);
+                hashMap_remove(manager->topicReceivers.map, key);
                 //cleanup entry
                 free(entry->scopeAndTopicKey);
                 if (entry->scope != NULL) {
@@ -848,11 +930,11 @@ static void pstm_addEndpointCallback(void *handle, void *svc) {
     psa->addDiscoveredEndpoint(psa->handle, endpoint);
 }
 
-static void pstm_findPsaForEndpoints(pubsub_topology_manager_t *manager) {
+static void pstm_findPsaForEndpoints(pubsub_topology_manager_t *manager, hash_map_t *dirtyUUIDs) {
     celixThreadMutex_lock(&manager->discoveredEndpoints.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(manager->discoveredEndpoints.map);
+    hash_map_iterator_t iter = hashMapIterator_construct(dirtyUUIDs);
     while (hashMapIterator_hasNext(&iter)) {
-        pstm_discovered_endpoint_entry_t *entry = hashMapIterator_nextValue(&iter);
+        pstm_discovered_endpoint_entry_t *entry = hashMap_get(manager->discoveredEndpoints.map, hashMapIterator_nextKey(&iter));
         if (entry != NULL && entry->selectedPsaSvcId < 0) {
             long psaSvcId = -1L;
 
@@ -878,6 +960,7 @@ static void pstm_findPsaForEndpoints(pubsub_topology_manager_t *manager) {
                                                      (void *) entry->endpoint, pstm_addEndpointCallback);
             } else {
                 celix_logHelper_log(manager->loghelper, CELIX_LOG_LEVEL_DEBUG, "Cannot find psa for endpoint %s\n", entry->uuid);
+                pstm_markRetryKey(manager, manager->psaHandling.retry.endpoints, entry->uuid);
             }
 
             entry->selectedPsaSvcId = psaSvcId;
@@ -903,13 +986,13 @@ static void pstm_setupTopicSenderCallback(void *handle, void *svc) {
     psa->setupTopicSender(psa->handle, entry->scope, entry->topic, entry->topicProperties, entry->selectedSerializerSvcId, entry->selectedProtocolSvcId, &entry->endpointResult);
 }
 
-static void pstm_setupTopicSenders(pubsub_topology_manager_t *manager) {
+static void pstm_setupTopicSenders(pubsub_topology_manager_t *manager, hash_map_t *dirtyKeys) {
     celix_array_list_t* setupEntries = celix_arrayList_create();
 
     celixThreadMutex_lock(&manager->topicSenders.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(manager->topicSenders.map);
+    hash_map_iterator_t iter = hashMapIterator_construct(dirtyKeys);
     while (hashMapIterator_hasNext(&iter)) {
-        pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
+        pstm_topic_receiver_or_sender_entry_t *entry = hashMap_get(manager->topicSenders.map, hashMapIterator_nextKey(&iter));
         if (entry != NULL && entry->matching.needsMatch && entry->usageCount > 0) {
             //new topic sender needed, requesting match with current psa
             double highestScore = PUBSUB_ADMIN_NO_MATCH_SCORE;
@@ -967,6 +1050,7 @@ static void pstm_setupTopicSenders(pubsub_topology_manager_t *manager) {
                                       entry->topic,
                                       celix_filter_getFilterString(entry->publisherFilter));
                 celix_properties_destroy(topicPropertiesForHighestMatch);
+                pstm_markRetryKey(manager, manager->psaHandling.retry.senders, entry->scopeAndTopicKey);
             }
         }
     }
@@ -999,6 +1083,7 @@ static void pstm_setupTopicSenders(pubsub_topology_manager_t *manager) {
             celixThreadMutex_lock(&manager->topicSenders.mutex);
             pstm_topic_receiver_or_sender_entry_t* entry = hashMap_get(manager->topicSenders.map, setupEntry->key);
             entry->matching.needsMatch = true;
+            pstm_markRetryKey(manager, manager->psaHandling.retry.senders, setupEntry->key);
             celixThreadMutex_unlock(&manager->topicSenders.mutex);
             celix_properties_destroy(setupEntry->topicProperties);
             celix_properties_destroy(setupEntry->endpointResult);
@@ -1018,13 +1103,13 @@ static void pstm_setupTopicReceiverCallback(void *handle, void *svc) {
     psa->setupTopicReceiver(psa->handle, entry->scope, entry->topic, entry->topicProperties, entry->selectedSerializerSvcId, entry->selectedProtocolSvcId, &entry->endpointResult);
 }
 
-static void pstm_setupTopicReceivers(pubsub_topology_manager_t *manager) {
+static void pstm_setupTopicReceivers(pubsub_topology_manager_t *manager, hash_map_t *dirtyKeys) {
     celix_array_list_t* setupEntries = celix_arrayList_create();
 
     celixThreadMutex_lock(&manager->topicReceivers.mutex);
-    hash_map_iterator_t iter = hashMapIterator_construct(manager->topicReceivers.map);
+    hash_map_iterator_t iter = hashMapIterator_construct(dirtyKeys);
     while (hashMapIterator_hasNext(&iter)) {
-        pstm_topic_receiver_or_sender_entry_t *entry = hashMapIterator_nextValue(&iter);
+        pstm_topic_receiver_or_sender_entry_t *entry = hashMap_get(manager->topicReceivers.map, hashMapIterator_nextKey(&iter));
         if (entry != NULL && entry->matching.needsMatch && entry->usageCount > 0) {
 
             double highestScore = PUBSUB_ADMIN_NO_MATCH_SCORE;
@@ -1082,6 +1167,7 @@ static void pstm_setupTopicReceivers(pubsub_topology_manager_t *manager) {
                                       "No PSA match for subscriber with scope/topic %s/%s.",
                                       entry->scope,
                                       entry->topic);
+                pstm_markRetryKey(manager, manager->psaHandling.retry.receivers, entry->scopeAndTopicKey);
             }
         }
     }
@@ -1116,6 +1202,7 @@ static void pstm_setupTopicReceivers(pubsub_topology_manager_t *manager) {
             celixThreadMutex_lock(&manager->topicReceivers.mutex);
             pstm_topic_receiver_or_sender_entry_t* entry = hashMap_get(manager->topicReceivers.map, setupEntry->key);
             entry->matching.needsMatch = true;
+            pstm_markRetryKey(manager, manager->psaHandling.retry.receivers, setupEntry->key);
             celixThreadMutex_unlock(&manager->topicReceivers.mutex);
         }
         free(setupEntry->scope);
@@ -1130,26 +1217,51 @@ static void pstm_setupTopicReceivers(pubsub_topology_manager_t *manager) {
 static void *pstm_psaHandlingThread(void *data) {
     pubsub_topology_manager_t *manager = data;
 
+    //Only the dirty keys are handled. Keys of failed setups are retried every handlingThreadSleepTime, because
+    //a failed match can depend on services (e.g. serializers or protocols) which are not tracked by the manager.
+    pstm_dirty_keys_t handling;
+    pstm_dirtyKeys_init(&handling);
+    struct timespec lastRetry = celix_gettime(CLOCK_MONOTONIC);
+
     celixThreadMutex_lock(&manager->psaHandling.mutex);
-    bool running = manager->psaHandling.running;
-    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+    while (manager->psaHandling.running) {
+        double sleepTimeInSeconds = manager->handlingThreadSleepTime / 1000.0;
+        double elapsed = celix_elapsedtime(CLOCK_MONOTONIC, lastRetry);
+        if (elapsed >= sleepTimeInSeconds) {
+            pstm_dirtyKeys_moveKeys(manager->psaHandling.retry.senders, manager->psaHandling.dirty.senders);
+            pstm_dirtyKeys_moveKeys(manager->psaHandling.retry.receivers, manager->psaHandling.dirty.receivers);
+            pstm_dirtyKeys_moveKeys(manager->psaHandling.retry.endpoints, manager->psaHandling.dirty.endpoints);
+            lastRetry = celix_gettime(CLOCK_MONOTONIC);
+            elapsed = 0.0;
+        }
+        if (pstm_dirtyKeys_isEmpty(&manager->psaHandling.dirty)) {
+            long waitTimeInMs = (long)((sleepTimeInSeconds - elapsed) * 1000.0) + 1;
+            celixThreadCondition_timedwaitRelative(&manager->psaHandling.cond, &manager->psaHandling.mutex, waitTimeInMs / 1000, (waitTimeInMs % 1000) * 1000000);
+            continue;
+        }
+
+        //take the dirty keys, so that new changes can be marked while handling
+        pstm_dirty_keys_t tmp = manager->psaHandling.dirty;
+        manager->psaHandling.dirty = handling;
+        handling = tmp;
+        celixThreadMutex_unlock(&manager->psaHandling.mutex);
 
-    while (running) {
         //first teardown -> also if rematch is needed
-        pstm_teardownTopicSenders(manager);
-        pstm_teardownTopicReceivers(manager);
+        pstm_teardownTopicSenders(manager, handling.senders);
+        pstm_teardownTopicReceivers(manager, handling.receivers);
 
         //then see if any topic sender/receiver are needed
-        pstm_setupTopicSenders(manager);
-        pstm_setupTopicReceivers(manager);
+        pstm_setupTopicSenders(manager, handling.senders);
+        pstm_setupTopicReceivers(manager, handling.receivers);
 
-        pstm_findPsaForEndpoints(manager); //trying to find psa and possible set for endpoints with no psa
+        pstm_findPsaForEndpoints(manager, handling.endpoints); //trying to find psa and possible set for endpoints with no psa
+        pstm_dirtyKeys_clear(&handling);
 
         celixThreadMutex_lock(&manager->psaHandling.mutex);
-        celixThreadCondition_timedwaitRelative(&manager->psaHandling.cond, &manager->psaHandling.mutex, manager->handlingThreadSleepTime  / 1000, (manager->handlingThreadSleepTime  % 1000) * 1000000);
-        running = manager->psaHandling.running;
-        celixThreadMutex_unlock(&manager->psaHandling.mutex);
     }
+    celixThreadMutex_unlock(&manager->psaHandling.mutex);
+
+    pstm_dirtyKeys_deinit(&handling);
     return NULL;
 }
 
@@ -1323,6 +1435,15 @@ static void fetchBundleName(void *handle, const bundle_t *bundle) {
     *out = celix_bundle_getSymbolicName(bundle);
 }
 
+static void pubsub_topologyManager_printLatency(FILE *os, const char *name, const pubsub_admin_latency_metrics_t *latency) {
+    if (latency->count == 0) {
+        return;
+    }
+    fprintf(os, "   |- %s latency (%lu samples):\n", name, latency->count);
+    fprintf(os, "      |- min/avg/max = %fs / %fs / %fs\n", latency->minInSeconds, latency->averageInSeconds, latency->maxInSeconds);
+    fprintf(os, "      |- p50/p90/p99/p99.9 = %fs / %fs / %fs / %fs\n", latency->p50InSeconds, latency->p90InSeconds, latency->p99InSeconds, latency->p999InSeconds);
+}
+
 static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *manager, const char *commandLine __attribute__((unused)), FILE *os, FILE *errorStream __attribute__((unused))) {
     celix_array_list_t *psaMetrics = celix_arrayList_create();
     celixThreadMutex_lock(&manager->psaMetrics.mutex);
@@ -1330,7 +1451,9 @@ static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *
     while (hashMapIterator_hasNext(&iter)) {
         pubsub_admin_metrics_service_t *svc = hashMapIterator_nextValue(&iter);
         pubsub_admin_metrics_t *m = svc->metrics(svc->handle);
-        celix_arrayList_add(psaMetrics, m);
+        if (m != NULL) {
+            celix_arrayList_add(psaMetrics, m);
+        }
     }
     celixThreadMutex_unlock(&manager->psaMetrics.mutex);
 
@@ -1340,6 +1463,8 @@ static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *
         for (int k = 0; k < celix_arrayList_size(metrics->senders); ++k) {
             pubsub_admin_sender_metrics_t *sm = celix_arrayList_get(metrics->senders, k);
             fprintf(os, "|- Topic Sender %s/%s\n", sm->scope, sm->topic);
+            pubsub_topologyManager_printLatency(os, "serialization", &sm->serializationLatency);
+            pubsub_topologyManager_printLatency(os, "send", &sm->sendLatency);
             for (int j = 0; j < sm->nrOfmsgMetrics; ++j) {
                 if (sm->msgMetrics[j].nrOfMessagesSend == 0 && sm->msgMetrics[j].nrOfMessagesSendFailed == 0 && sm->msgMetrics[j].nrOfSerializationErrors == 0) {
                     continue;
@@ -1358,6 +1483,8 @@ static celix_status_t pubsub_topologyManager_metrics(pubsub_topology_manager_t *
         for (int k = 0; k < celix_arrayList_size(metrics->receivers); ++k) {
             pubsub_admin_receiver_metrics_t *rm = celix_arrayList_get(metrics->receivers, k);
             fprintf(os, "|- Topic Receiver %s/%s:\n", rm->scope, rm->topic);
+            pubsub_topologyManager_printLatency(os, "end-to-end", &rm->endToEndLatency);
+            pubsub_topologyManager_printLatency(os, "subscriber callback", &rm->subscriberCallbackLatency);
             for (int j = 0; j < rm->nrOfMsgTypes; ++j) {
                 int nrOfOrigins = rm->msgTypes[j].nrOfOrigins;
                 for (int m = 0; m < nrOfOrigins; ++m) {
@@ -36,6 +36,16 @@
 #define PUBSUB_TOPOLOGY_MANAGER_DEFAULT_VERBOSE     false
 
 
+/**
+ * @brief Sets of keys for which the topology changed and needs to be (re)handled by the psa handling thread.
+ * The hash maps own the (string) keys, the values are not used.
+ */
+typedef struct pstm_dirty_keys {
+    hash_map_t *senders; //key = scope/topic key
+    hash_map_t *receivers; //key = scope/topic key
+    hash_map_t *endpoints; //key = discovered endpoint uuid
+} pstm_dirty_keys_t;
+
 typedef struct pubsub_topology_manager {
     celix_bundle_context_t *context;
 
@@ -71,9 +81,11 @@ typedef struct pubsub_topology_manager {
 
     struct {
         celix_thread_t thread;
-        celix_thread_mutex_t mutex; //protect running and condition
+        celix_thread_mutex_t mutex; //protect running, condition, dirty and retry. Locked after the other manager mutexes
         celix_thread_cond_t cond;
         bool running;
+        pstm_dirty_keys_t dirty; //keys which need to be handled by the psa handling thread
+        pstm_dirty_keys_t retry; //keys of failed setups, retried every handlingThreadSleepTime
     } psaHandling;
 
     celix_log_helper_t *loghelper;
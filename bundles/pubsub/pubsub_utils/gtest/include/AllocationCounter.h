@@ -0,0 +1,49 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Test helper to count the memory allocations (malloc, calloc and realloc) of the calling thread.
+ *
+ * Linking the pubsub_allocation_counter library interposes the malloc functions of libc for the complete test
+ * executable, including the bundles it starts. Counting is only supported for glibc builds without address sanitizer.
+ */
+namespace pubsub_test {
+
+/**
+ * @brief Returns whether counting allocations is supported for this build.
+ */
+bool isAllocationCountingSupported();
+
+/**
+ * @brief Resets the allocation count and starts counting the allocations of the calling thread.
+ */
+void startCountingAllocations();
+
+/**
+ * @brief Stops counting the allocations of the calling thread.
+ * @return The number of allocations since startCountingAllocations.
+ */
+std::size_t stopCountingAllocations();
+
+}
@@ -0,0 +1,71 @@
+/**
+ *Licensed to the Apache Software Foundation (ASF) under one
+ *or more contributor license agreements.  See the NOTICE file
+ *distributed with this work for additional information
+ *regarding copyright ownership.  The ASF licenses this file
+ *to you under the Apache License, Version 2.0 (the
+ *"License"); you may not use this file except in compliance
+ *with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *Unless required by applicable law or agreed to in writing,
+ *software distributed under the License is distributed on an
+ *"AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ *specific language governing permissions and limitations
+ *under the License.
+ */
+
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define COUNT_ALLOCATIONS
+#endif
+
+static thread_local bool countAllocations = false;
+static thread_local std::size_t nrOfAllocations = 0;
+
+#ifdef COUNT_ALLOCATIONS
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t nmemb, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+}
+
+void* malloc(size_t size) noexcept {
+    nrOfAllocations += countAllocations ? 1 : 0;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size) noexcept {
+    nrOfAllocations += countAllocations ? 1 : 0;
+    return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    nrOfAllocations += countAllocations ? 1 : 0;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+bool pubsub_test::isAllocationCountingSupported() {
+#ifdef COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void pubsub_test::startCountingAllocations() {
+    nrOfAllocations = 0;
+    countAllocations = true;
+}
+
+std::size_t pubsub_test::stopCountingAllocations() {
+    countAllocations = false;
+    return nrOfAllocations;
+}
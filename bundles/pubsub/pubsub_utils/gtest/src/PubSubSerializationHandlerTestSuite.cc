@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <cstdarg>
+#include <cstring>
 
 #include "celix_bundle_context.h"
 #include "pubsub_message_serialization_service.h"
@@ -73,7 +74,7 @@ public:
         };
     }
 
-    long registerSerSvc(const char* type, uint32_t msgId, const char* msgFqn, const char* msgVersion) {
+    long registerSerSvc(const char* type, uint32_t msgId, const char* msgFqn, const char* msgVersion, const char* svcVersion = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_VERSION) {
         auto* p = celix_properties_create();
         celix_properties_set(p, PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZATION_TYPE_PROPERTY, type);
         celix_properties_set(p, PUBSUB_MESSAGE_SERIALIZATION_SERVICE_MSG_ID_PROPERTY, std::to_string(msgId).c_str());
@@ -83,7 +84,7 @@ public:
         opts.svc = static_cast<void*>(&msgSerSvc);
         opts.properties = p;
         opts.serviceName = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_NAME;
-        opts.serviceVersion = PUBSUB_MESSAGE_SERIALIZATION_SERVICE_VERSION;
+        opts.serviceVersion = svcVersion;
         return celix_bundleContext_registerServiceWithOptions(ctx.get(), &opts);
     }
 
@@ -92,6 +93,7 @@ public:
     pubsub_message_serialization_service_t  msgSerSvc{};
 
     size_t serializeCallCount = 0;
+    size_t serializeIntoCallCount = 0;
     size_t freeSerializedMsgCallCount = 0;
     size_t deserializeCallCount = 0;
     size_t freeDeserializedMsgCallCount = 0;
@@ -336,4 +338,66 @@ TEST_F(PubSubSerializationHandlerTestSuite, CallingFreeWithNULLWillBeSilentlyIgn
 
     celix_bundleContext_unregisterService(ctx.get(), svcId1);
     pubsub_serializerHandler_destroy(handler);
-}
\ No newline at end of file
+}
+TEST_F(PubSubSerializationHandlerTestSuite, SerializeIntoBuffer) {
+    auto *handler = pubsub_serializerHandler_create(ctx.get(), "json", true);
+    static char serialized[] = "{\"value\":42}";
+    msgSerSvc.serialize = [](void* handle, const void*, struct iovec** output, size_t* outputIovLen) -> celix_status_t {
+        auto* suite = static_cast<PubSubSerializationHandlerTestSuite*>(handle);
+        suite->serializeCallCount += 1;
+        *output = static_cast<iovec*>(calloc(2, sizeof(iovec)));
+        (*output)[0].iov_base = serialized;
+        (*output)[0].iov_len = 5;
+        (*output)[1].iov_base = serialized + 5;
+        (*output)[1].iov_len = strlen(serialized) - 5;
+        *outputIovLen = 2;
+        return CELIX_SUCCESS;
+    };
+    msgSerSvc.freeSerializedMsg = [](void* handle, struct iovec* input, size_t) {
+        auto* suite = static_cast<PubSubSerializationHandlerTestSuite*>(handle);
+        suite->freeSerializedMsgCallCount += 1;
+        free(input);
+    };
+    long svcId1 = registerSerSvc("json", 42, "example::Msg1", "1.0.0");
+
+    //no serializeInto, so serialize and copy
+    char buffer[64];
+    size_t size = 0;
+    EXPECT_EQ(CELIX_SUCCESS, pubsub_serializerHandler_serializeInto(handler, 42, nullptr, buffer, sizeof(buffer), &size));
+    EXPECT_EQ(strlen(serialized), size);
+    EXPECT_EQ(0, strncmp(serialized, buffer, size));
+    EXPECT_EQ(CELIX_ENOMEM, pubsub_serializerHandler_serializeInto(handler, 42, nullptr, buffer, 4, &size));
+    EXPECT_EQ(strlen(serialized), size);
+    EXPECT_EQ(2, serializeCallCount);
+    EXPECT_EQ(2, freeSerializedMsgCallCount);
+    EXPECT_EQ(CELIX_ILLEGAL_ARGUMENT, pubsub_serializerHandler_serializeInto(handler, 43, nullptr, buffer, sizeof(buffer), &size));
+    celix_bundleContext_unregisterService(ctx.get(), svcId1);
+
+    //serializeInto provided by the serialization service
+    msgSerSvc.serializeInto = [](void* handle, const void*, void* buf, size_t bufSize, size_t* outputSize) -> celix_status_t {
+        auto* suite = static_cast<PubSubSerializationHandlerTestSuite*>(handle);
+        suite->serializeIntoCallCount += 1;
+        *outputSize = 2;
+        if (bufSize < 2) {
+            return CELIX_ENOMEM;
+        }
+        memcpy(buf, "{}", 2);
+        return CELIX_SUCCESS;
+    };
+    long svcId2 = registerSerSvc("json", 42, "example::Msg1", "1.0.0");
+    EXPECT_EQ(CELIX_SUCCESS, pubsub_serializerHandler_serializeInto(handler, 42, nullptr, buffer, sizeof(buffer), &size));
+    EXPECT_EQ(2, size);
+    EXPECT_EQ(1, serializeIntoCallCount);
+    EXPECT_EQ(2, serializeCallCount);
+    celix_bundleContext_unregisterService(ctx.get(), svcId2);
+
+    //serializeInto is not used for services registered with a service version without serializeInto
+    long svcId3 = registerSerSvc("json", 42, "example::Msg1", "1.0.0", "1.0.0");
+    EXPECT_EQ(CELIX_SUCCESS, pubsub_serializerHandler_serializeInto(handler, 42, nullptr, buffer, sizeof(buffer), &size));
+    EXPECT_EQ(strlen(serialized), size);
+    EXPECT_EQ(1, serializeIntoCallCount);
+    EXPECT_EQ(3, serializeCallCount);
+
+    celix_bundleContext_unregisterService(ctx.get(), svcId3);
+    pubsub_serializerHandler_destroy(handler);
+}
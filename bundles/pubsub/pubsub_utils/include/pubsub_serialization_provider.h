@@ -84,6 +84,8 @@ typedef struct {
  * @param freeSerializeMsg              The freeSerializeMsg function to use
  * @param deserialize                   The deserialize function to use
  * @param freeDeserializeMsg            The freeDesrializeMsg function to use
+ * @param serializeInto                 Optional (can be NULL). The function to use to serialize directly into a
+ *                                      caller provided buffer.
  * @return                              A pubsub serialization provided for the requested serialization type using the
  *                                      provided serialization functions.
  */
@@ -95,7 +97,8 @@ pubsub_serialization_provider_t *pubsub_serializationProvider_create(
         celix_status_t (*serialize)(pubsub_serialization_entry_t* entry, const void* msg, struct iovec** output, size_t* outputIovLen),
         void (*freeSerializeMsg)(pubsub_serialization_entry_t* entry, struct iovec* input, size_t inputIovLen),
         celix_status_t (*deserialize)(pubsub_serialization_entry_t* entry, const struct iovec* input, size_t inputIovLen __attribute__((unused)), void **out),
-        void (*freeDeserializeMsg)(pubsub_serialization_entry_t* entry, void *msg));
+        void (*freeDeserializeMsg)(pubsub_serialization_entry_t* entry, void *msg),
+        celix_status_t (*serializeInto)(pubsub_serialization_entry_t* entry, const void* msg, void* buffer, size_t bufferSize, size_t* outputSize));
 
 /**
  * Destroys the provided JSON Serialization Provider.
@@ -97,6 +97,24 @@ void pubsub_serializerHandler_destroy(pubsub_serializer_handler_t* handler);
  */
 celix_status_t pubsub_serializerHandler_serialize(pubsub_serializer_handler_t* handler, uint32_t msgId, const void* input, struct iovec** output, size_t* outputIovLen);
 
+/**
+ * @brief Serialize a message directly into a caller provided buffer.
+ *
+ * If the message serialization service does not support serializing into a buffer, the message is serialized into
+ * iovec structs and copied into the buffer.
+ *
+ * @param handler       The pubsub serialization handler.
+ * @param msgId         The msg id for the message to be serialized.
+ * @param input         A pointer to the message object
+ * @param buffer        The buffer to serialize the message into.
+ * @param bufferSize    The size of the buffer.
+ * @param outputSize    Output pointer to the size of the serialized message.
+ *                      If the buffer is too small, this is set to the needed size (if known, otherwise 0).
+ * @return              CELIX_SUCCESS on success, CELIX_ENOMEM if the buffer is too small or CELIX_ILLEGAL_ARGUMENT
+ *                      if the msg id is not known or serialization failed.
+ */
+celix_status_t pubsub_serializerHandler_serializeInto(pubsub_serializer_handler_t* handler, uint32_t msgId, const void* input, void* buffer, size_t bufferSize, size_t* outputSize);
+
 /**
  * @brief Free the memory of for the serialized msg.
  */
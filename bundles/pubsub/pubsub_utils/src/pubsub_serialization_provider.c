@@ -65,6 +65,7 @@ struct pubsub_serialization_provider {
     void (*freeSerializeMsg)(pubsub_serialization_entry_t* entry, struct iovec* input, size_t inputIovLen);
     celix_status_t (*deserialize)(pubsub_serialization_entry_t* entry, const struct iovec* input, size_t inputIovLen __attribute__((unused)), void **out);
     void (*freeDeserializeMsg)(pubsub_serialization_entry_t* entry, void *msg);
+    celix_status_t (*serializeInto)(pubsub_serialization_entry_t* entry, const void* msg, void* buffer, size_t bufferSize, size_t* outputSize);
 
     //updated serialization services
     long bundleTrackerId;
@@ -440,6 +441,7 @@ static void pubsub_serializationProvider_parseDescriptors(pubsub_serialization_p
         serEntry->svc.freeSerializedMsg = (void*)provider->freeSerializeMsg;
         serEntry->svc.deserialize = (void*)provider->deserialize;
         serEntry->svc.freeDeserializedMsg = (void*)provider->freeDeserializeMsg;
+        serEntry->svc.serializeInto = (void*)provider->serializeInto;
         serEntry->svcId = -1L;
 
         if (pubsub_serializationProvider_alreadyAddedEntry(provider, serEntry)) {
@@ -595,7 +597,8 @@ pubsub_serialization_provider_t *pubsub_serializationProvider_create(
         celix_status_t (*serialize)(pubsub_serialization_entry_t* entry, const void* msg, struct iovec** output, size_t* outputIovLen),
         void (*freeSerializeMsg)(pubsub_serialization_entry_t* entry, struct iovec* input, size_t inputIovLen),
         celix_status_t (*deserialize)(pubsub_serialization_entry_t* entry, const struct iovec* input, size_t inputIovLen __attribute__((unused)), void **out),
-        void (*freeDeserializeMsg)(pubsub_serialization_entry_t* entry, void *msg)) {
+        void (*freeDeserializeMsg)(pubsub_serialization_entry_t* entry, void *msg),
+        celix_status_t (*serializeInto)(pubsub_serialization_entry_t* entry, const void* msg, void* buffer, size_t bufferSize, size_t* outputSize)) {
     pubsub_serialization_provider_t* provider = calloc(1, sizeof(*provider));
     provider->ctx = ctx;
     celixThreadMutex_create(&provider->mutex, NULL);
@@ -606,6 +609,7 @@ pubsub_serialization_provider_t *pubsub_serializationProvider_create(
     provider->freeSerializeMsg = freeSerializeMsg;
     provider->deserialize = deserialize;
     provider->freeDeserializeMsg = freeDeserializeMsg;
+    provider->serializeInto = serializeInto;
     provider->logHelper = celix_logHelper_create(ctx, "celix_pubsub_serialization_provider");
 
     dynFunction_logSetup(dfi_log, provider, 1);
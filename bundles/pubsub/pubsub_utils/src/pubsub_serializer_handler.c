@@ -46,6 +46,7 @@ typedef struct pubsub_serialization_service_entry {
     uint32_t msgId;
     celix_version_t* msgVersion;
     const char* msgFqn;
+    bool serializeIntoSupported; //true if the service version is at least PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZE_INTO_VERSION
     pubsub_message_serialization_service_t* svc;
 } pubsub_serialization_service_entry_t;
 
@@ -77,6 +78,23 @@ static void removeSerializationService(void *handle, void* svc, const celix_prop
     pubsub_serializerHandler_removeSerializationService(handler, serSvc, props);
 }
 
+/**
+ * Returns whether the serialization service is registered with a service version which includes the serializeInto
+ * member. Older (1.0.0) providers do not know the member, so it can contain garbage.
+ */
+static bool pubsub_serializerHandler_isSerializeIntoSupported(const celix_properties_t* svcProperties) {
+    bool supported = false;
+    const char* svcVersion = celix_properties_get(svcProperties, CELIX_FRAMEWORK_SERVICE_VERSION, NULL);
+    celix_version_t* version = svcVersion != NULL ? celix_version_createVersionFromString(svcVersion) : NULL;
+    celix_version_t* minVersion = celix_version_createVersionFromString(PUBSUB_MESSAGE_SERIALIZATION_SERVICE_SERIALIZE_INTO_VERSION);
+    if (version != NULL && minVersion != NULL) {
+        supported = celix_version_compareTo(version, minVersion) >= 0;
+    }
+    celix_version_destroy(version);
+    celix_version_destroy(minVersion);
+    return supported;
+}
+
 static int compareEntries(const void *a, const void *b) {
     const pubsub_serialization_service_entry_t* aEntry = a;
     const pubsub_serialization_service_entry_t* bEntry = b;
@@ -257,6 +275,7 @@ void pubsub_serializerHandler_addSerializationService(pubsub_serializer_handler_
         entry->msgFqn = fqn;
         entry->msgId = msgId;
         entry->msgVersion = msgVersion;
+        entry->serializeIntoSupported = pubsub_serializerHandler_isSerializeIntoSupported(svcProperties);
         entry->svc = svc;
         celix_arrayList_add(entries, entry);
         celix_arrayList_sort(entries, compareEntries);
@@ -316,6 +335,48 @@ celix_status_t pubsub_serializerHandler_serialize(pubsub_serializer_handler_t* h
     return status;
 }
 
+static celix_status_t pubsub_serializerHandler_serializeAndCopy(pubsub_message_serialization_service_t* svc, const void* input, void* buffer, size_t bufferSize, size_t* outputSize) {
+    struct iovec* output = NULL;
+    size_t outputIovLen = 0;
+    celix_status_t status = svc->serialize(svc->handle, input, &output, &outputIovLen);
+    if (status != CELIX_SUCCESS) {
+        return status;
+    }
+    size_t size = 0;
+    for (size_t i = 0; i < outputIovLen; ++i) {
+        size += output[i].iov_len;
+    }
+    *outputSize = size;
+    if (size <= bufferSize) {
+        char* pos = buffer;
+        for (size_t i = 0; i < outputIovLen; ++i) {
+            memcpy(pos, output[i].iov_base, output[i].iov_len);
+            pos += output[i].iov_len;
+        }
+    } else {
+        status = CELIX_ENOMEM;
+    }
+    svc->freeSerializedMsg(svc->handle, output, outputIovLen);
+    return status;
+}
+
+celix_status_t pubsub_serializerHandler_serializeInto(pubsub_serializer_handler_t* handler, uint32_t msgId, const void* input, void* buffer, size_t bufferSize, size_t* outputSize) {
+    celix_status_t status;
+    *outputSize = 0;
+    celixThreadRwlock_readLock(&handler->lock);
+    pubsub_serialization_service_entry_t* entry = findEntry(handler, msgId);
+    if (entry != NULL && entry->serializeIntoSupported && entry->svc->serializeInto != NULL) {
+        status = entry->svc->serializeInto(entry->svc->handle, input, buffer, bufferSize, outputSize);
+    } else if (entry != NULL) {
+        status = pubsub_serializerHandler_serializeAndCopy(entry->svc, input, buffer, bufferSize, outputSize);
+    } else {
+        status = CELIX_ILLEGAL_ARGUMENT;
+        L_ERROR("Cannot find message serialization service for msg id %u.", msgId);
+    }
+    celixThreadRwlock_unlock(&handler->lock);
+    return status;
+}
+
 celix_status_t pubsub_serializerHandler_freeSerializedMsg(pubsub_serializer_handler_t* handler, uint32_t msgId, struct iovec* input, size_t inputIovLen) {
     celix_status_t status = CELIX_SUCCESS;
     if (input == NULL) {
@@ -21,6 +21,12 @@
 #include <remote_constants.h>
 #include <tst_service.h>
 #include "celix_api.h"
+#include "calculator_service.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 extern "C" {
 
@@ -57,7 +63,7 @@ typedef struct rsa_dfi_exception_test_service {
     static bool clientInterceptorPreProxyCallRetval=true;
     static bool svcInterceptorPreExportCallRetval=true;
 
-    static void setupFm(bool useCurlShare) {
+    static void setupFm(bool useCurlShare, long curlPoolSize = -1 /*default*/, bool useAsyncCurl = false) {
         //server
         celix_properties_t *serverProps = celix_properties_load("server.properties");
         ASSERT_TRUE(serverProps != NULL);
@@ -69,6 +75,11 @@ typedef struct rsa_dfi_exception_test_service {
         //client
         celix_properties_t *clientProperties = celix_properties_load("client.properties");
         celix_properties_setBool(clientProperties, "RSA_DFI_USE_CURL_SHARE_HANDLE", useCurlShare);
+        if (curlPoolSize >= 0) {
+            celix_properties_setLong(clientProperties, "RSA_DFI_CURL_POOL_SIZE", curlPoolSize);
+            celix_properties_setLong(clientProperties, "RSA_DFI_CURL_POOL_IDLE_TIMEOUT", 1);
+        }
+        celix_properties_setBool(clientProperties, "RSA_DFI_USE_ASYNC_CURL", useAsyncCurl);
         ASSERT_TRUE(clientProperties != NULL);
         clientFramework = celix_frameworkFactory_createFramework(clientProperties);
         ASSERT_TRUE(clientFramework != NULL);
@@ -302,6 +313,92 @@ static void test(F&& f) {
     ASSERT_TRUE(called);
 }
 
+/**
+ * Calls the (imported) remote calculator service from the client framework.
+ * Returns true if the service was found and the call returned the correct result.
+ */
+static bool callRemoteCalculator() {
+    std::atomic<bool> ok{false};
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = CALCULATOR_SERVICE;
+    opts.filter.ignoreServiceLanguage = true;
+    opts.callbackHandle = &ok;
+    opts.use = [](void *handle, void *svc) {
+        auto *calc = static_cast<calculator_service_t *>(svc);
+        double result = -1.0;
+        int rc = calc->sqrt(calc->handle, 4, &result);
+        static_cast<std::atomic<bool>*>(handle)->store(rc == 0 && result == 2.0);
+    };
+    bool called = celix_bundleContext_useServiceWithOptions(clientContext, &opts);
+    return called && ok.load();
+}
+
+static void testConcurrentRemoteCalls() {
+    test(testCalculator); //ensure the calculator is discovered
+
+    const int nrOfThreads = 8;
+    const int nrOfCallsPerThread = 20;
+    std::atomic<int> nrOfSuccessfulCalls{0};
+    std::vector<std::thread> threads{};
+    for (int i = 0; i < nrOfThreads; ++i) {
+        threads.emplace_back([&nrOfSuccessfulCalls] {
+            for (int j = 0; j < nrOfCallsPerThread; ++j) {
+                if (callRemoteCalculator()) {
+                    nrOfSuccessfulCalls.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(nrOfThreads * nrOfCallsPerThread, nrOfSuccessfulCalls.load());
+}
+
+static void testStopRsaWithCallsInFlight() {
+    test(testCalculator); //ensure the calculator is discovered
+
+    long rsaBndId = -1L;
+    auto *bundles = celix_bundleContext_listBundles(clientContext);
+    for (int i = 0; i < celix_arrayList_size(bundles); ++i) {
+        long bndId = celix_arrayList_getLong(bundles, i);
+        char *name = celix_bundleContext_getBundleSymbolicName(clientContext, bndId);
+        if (name != nullptr && strcmp(name, "apache_celix_remote_service_admin_dfi") == 0) {
+            rsaBndId = bndId;
+        }
+        free(name);
+    }
+    celix_arrayList_destroy(bundles);
+    ASSERT_GE(rsaBndId, 0);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> nrOfSuccessfulCalls{0};
+    std::vector<std::thread> threads{};
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            while (!stop.load()) {
+                if (callRemoteCalculator()) {
+                    nrOfSuccessfulCalls.fetch_add(1);
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+
+    //stopping the rsa (and the curl pool / curl thread) should wait for - or fail - the calls in flight
+    EXPECT_TRUE(celix_bundleContext_stopBundle(clientContext, rsaBndId));
+    EXPECT_FALSE(callRemoteCalculator()); //proxy is gone
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_GT(nrOfSuccessfulCalls.load(), 0);
+
+    //and the rsa can be restarted
+    EXPECT_TRUE(celix_bundleContext_startBundle(clientContext, rsaBndId));
+    test(testCalculator);
+}
+
 class RsaDfiClientServerTests : public ::testing::Test {
 public:
     RsaDfiClientServerTests() {
@@ -324,6 +421,28 @@ public:
 
 };
 
+class RsaDfiClientServerWithCurlPoolTests : public ::testing::Test {
+public:
+    RsaDfiClientServerWithCurlPoolTests() {
+        setupFm(false, 2);
+    }
+    ~RsaDfiClientServerWithCurlPoolTests() override {
+        teardownFm();
+    }
+
+};
+
+class RsaDfiClientServerWithAsyncCurlTests : public ::testing::Test {
+public:
+    RsaDfiClientServerWithAsyncCurlTests() {
+        setupFm(false, 2, true);
+    }
+    ~RsaDfiClientServerWithAsyncCurlTests() override {
+        teardownFm();
+    }
+
+};
+
 class RsaDfiClientServerInterceptorTests : public ::testing::Test {
 public:
     RsaDfiClientServerInterceptorTests() {
@@ -356,6 +475,41 @@ TEST_F(RsaDfiClientServerWithCurlShareTests, TestRemoteCalculator) {
     test(testCalculator);
 }
 
+TEST_F(RsaDfiClientServerWithCurlPoolTests, TestRemoteCalculator) {
+    test(testCalculator);
+}
+
+TEST_F(RsaDfiClientServerWithCurlPoolTests, TestConcurrentRemoteCalls) {
+    testConcurrentRemoteCalls();
+}
+
+TEST_F(RsaDfiClientServerWithCurlPoolTests, TestRemoteCallAfterIdleExpiry) {
+    test(testCalculator);
+    //pooled curl handles expire after the idle timeout (1s)
+    std::this_thread::sleep_for(std::chrono::milliseconds{2500});
+    EXPECT_TRUE(callRemoteCalculator());
+}
+
+TEST_F(RsaDfiClientServerWithCurlPoolTests, TestStopRsaWithCallsInFlight) {
+    testStopRsaWithCallsInFlight();
+}
+
+TEST_F(RsaDfiClientServerWithAsyncCurlTests, TestRemoteCalculator) {
+    test(testCalculator);
+}
+
+TEST_F(RsaDfiClientServerWithAsyncCurlTests, TestRemoteComplex) {
+    test(testComplex);
+}
+
+TEST_F(RsaDfiClientServerWithAsyncCurlTests, TestConcurrentRemoteCalls) {
+    testConcurrentRemoteCalls();
+}
+
+TEST_F(RsaDfiClientServerWithAsyncCurlTests, TestStopRsaWithCallsInFlight) {
+    testStopRsaWithCallsInFlight();
+}
+
 TEST_F(RsaDfiClientServerTests, TestRemoteComplex) {
     test(testComplex);
 }
@@ -44,6 +44,8 @@
 
 #include "remote_service_admin_dfi_constants.h"
 #include "celix_bundle_context.h"
+#include "celix_string_hash_map.h"
+#include "celix_utils.h"
 
 // defines how often the webserver is restarted (with an increased port number)
 #define MAX_NUMBER_OF_RESTARTS 5
@@ -97,6 +99,20 @@ struct remote_service_admin {
     pthread_mutex_t curlMutexConnect;
     pthread_mutex_t curlMutexCookie;
     pthread_mutex_t curlMutexDns;
+
+    long curlPoolSize;
+    long curlPoolIdleTimeout; //in seconds
+    celix_thread_mutex_t curlPoolsLock; //protects curlPools
+    celix_string_hash_map_t* curlPools; //key = endpoint url, value = celix_array_list_t* of rsa_dfi_curl_pool_entry_t*
+
+    //NOTE curlMulti, curlThread and the curlRequests fields are only used if RSA_DFI_USE_ASYNC_CURL is set to true
+    bool curlAsyncEnabled;
+    CURLM* curlMulti;
+    celix_thread_t curlThread;
+    celix_thread_mutex_t curlRequestsLock; //protects below
+    celix_thread_cond_t curlRequestsCond;
+    celix_array_list_t* curlPendingRequests; //entries are rsa_dfi_curl_request_t*
+    bool curlThreadActive;
 };
 
 struct celix_post_data {
@@ -106,11 +122,25 @@ struct celix_post_data {
 };
 
 struct celix_get_data_reply {
-    FILE* stream;
     char* buf;
     size_t size;
+    size_t capacity;
 };
 
+typedef struct rsa_dfi_curl_pool_entry {
+    CURL* curl;
+    struct timespec lastUsed;
+} rsa_dfi_curl_pool_entry_t;
+
+/**
+ * A remote call handed over to the curl I/O thread. Lives on the stack of the calling thread.
+ */
+typedef struct rsa_dfi_curl_request {
+    CURL* curl;
+    CURLcode result;
+    bool done; //protected by curlRequestsLock
+} rsa_dfi_curl_request_t;
+
 #define OSGI_RSA_REMOTE_PROXY_FACTORY   "remote_proxy_factory"
 #define OSGI_RSA_REMOTE_PROXY_TIMEOUT   "remote_proxy_timeout"
 
@@ -134,6 +164,9 @@ static size_t remoteServiceAdmin_write(void *contents, size_t size, size_t nmemb
 static void remoteServiceAdmin_log(remote_service_admin_t *admin, int level, const char *file, int line, const char *msg, ...);
 static void remoteServiceAdmin_setupStopExportsThread(remote_service_admin_t* admin);
 static void remoteServiceAdmin_teardownStopExportsThread(remote_service_admin_t* admin);
+static void remoteServiceAdmin_destroyCurlPool(void* data);
+static void remoteServiceAdmin_setupCurlThread(remote_service_admin_t* admin);
+static void remoteServiceAdmin_teardownCurlThread(remote_service_admin_t* admin);
 
 static void remoteServiceAdmin_curlshare_lock(CURL *handle, curl_lock_data data, curl_lock_access laccess, void *userptr)
 {
@@ -203,6 +236,14 @@ celix_status_t remoteServiceAdmin_create(celix_bundle_context_t *context, remote
         const char *ip = celix_bundleContext_getProperty(context, RSA_IP_KEY, RSA_IP_DEFAULT);
         const char *interface = celix_bundleContext_getProperty(context, RSA_INTERFACE_KEY, NULL);
         (*admin)->curlShareEnabled = celix_bundleContext_getPropertyAsBool(context, RSA_DFI_USE_CURL_SHARE_HANDLE, RSA_DFI_USE_CURL_SHARE_HANDLE_DEFAULT);
+        (*admin)->curlPoolSize = celix_bundleContext_getPropertyAsLong(context, RSA_DFI_CURL_POOL_SIZE, RSA_DFI_CURL_POOL_SIZE_DEFAULT);
+        (*admin)->curlPoolIdleTimeout = celix_bundleContext_getPropertyAsLong(context, RSA_DFI_CURL_POOL_IDLE_TIMEOUT, RSA_DFI_CURL_POOL_IDLE_TIMEOUT_DEFAULT);
+        (*admin)->curlAsyncEnabled = celix_bundleContext_getPropertyAsBool(context, RSA_DFI_USE_ASYNC_CURL, RSA_DFI_USE_ASYNC_CURL_DEFAULT);
+
+        celixThreadMutex_create(&(*admin)->curlPoolsLock, NULL);
+        celix_string_hash_map_create_options_t poolOpts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+        poolOpts.simpleRemovedCallback = remoteServiceAdmin_destroyCurlPool;
+        (*admin)->curlPools = celix_stringHashMap_createWithOptions(&poolOpts);
 
         char *detectedIp = NULL;
         if ((interface != NULL) && (remoteServiceAdmin_getIpAddress((char*)interface, &detectedIp) != CELIX_SUCCESS)) {
@@ -246,6 +287,9 @@ celix_status_t remoteServiceAdmin_create(celix_bundle_context_t *context, remote
         }
 
         remoteServiceAdmin_setupStopExportsThread(*admin);
+        if ((*admin)->curlAsyncEnabled) {
+            remoteServiceAdmin_setupCurlThread(*admin);
+        }
 
         // Prepare callbacks structure. We have only one callback, the rest are NULL.
         struct mg_callbacks callbacks;
@@ -312,6 +356,8 @@ celix_status_t remoteServiceAdmin_destroy(remote_service_admin_t **admin) {
 
     free((*admin)->ip);
     free((*admin)->port);
+    celix_stringHashMap_destroy((*admin)->curlPools);
+    celixThreadMutex_destroy(&(*admin)->curlPoolsLock);
     curl_share_cleanup((*admin)->curlShare);
     pthread_mutex_destroy(&(*admin)->curlMutexConnect);
     pthread_mutex_destroy(&(*admin)->curlMutexCookie);
@@ -414,6 +460,10 @@ celix_status_t remoteServiceAdmin_stop(remote_service_admin_t *admin) {
     }
     celixThreadMutex_unlock(&admin->importedServicesLock);
 
+    if (admin->curlAsyncEnabled) {
+        remoteServiceAdmin_teardownCurlThread(admin);
+    }
+
     if (admin->ctx != NULL) {
         celix_logHelper_log(admin->loghelper, CELIX_LOG_LEVEL_INFO, "RSA: Stopping webserver...");
         mg_stop(admin->ctx);
@@ -723,10 +773,9 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
         }
     }
 
-    hash_map_entry_pt entry = hashMap_getEntry(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
-
-    char* key = hashMapEntry_getKey(entry);
-    char *serviceId = (char *) hashMap_remove(endpointProperties, (void *) OSGI_FRAMEWORK_SERVICE_ID);
+    const char* svcIdStr = celix_properties_get(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID, NULL);
+    char *serviceId = svcIdStr == NULL ? NULL : strdup(svcIdStr);
+    celix_properties_unset(endpointProperties, OSGI_FRAMEWORK_SERVICE_ID);
     const char *uuid = NULL;
 
     char buf[512];
@@ -750,12 +799,10 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
     celix_properties_set(endpointProperties, RSA_DFI_ENDPOINT_URL, url);
 
     if (props != NULL) {
-        hash_map_iterator_pt propIter = hashMapIterator_create(props);
-        while (hashMapIterator_hasNext(propIter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(propIter);
-            celix_properties_set(endpointProperties, (char*)hashMapEntry_getKey(entry), (char*)hashMapEntry_getValue(entry));
+        const char* propKey = NULL;
+        CELIX_PROPERTIES_FOR_EACH(props, propKey) {
+            celix_properties_set(endpointProperties, propKey, celix_properties_get(props, propKey, NULL));
         }
-        hashMapIterator_destroy(propIter);
     }
 
     *endpoint = calloc(1, sizeof(**endpoint));
@@ -769,7 +816,6 @@ static celix_status_t remoteServiceAdmin_createEndpointDescription(remote_servic
         (*endpoint)->properties = endpointProperties;
     }
 
-    free(key);
     free(serviceId);
     free(keys);
 
@@ -912,6 +958,201 @@ celix_status_t remoteServiceAdmin_removeImportedService(remote_service_admin_t *
     return status;
 }
 
+static void remoteServiceAdmin_destroyCurlPool(void* data) {
+    celix_array_list_t* idleHandles = data;
+    for (int i = 0; i < celix_arrayList_size(idleHandles); ++i) {
+        rsa_dfi_curl_pool_entry_t* entry = celix_arrayList_get(idleHandles, i);
+        curl_easy_cleanup(entry->curl);
+        free(entry);
+    }
+    celix_arrayList_destroy(idleHandles);
+}
+
+/**
+ * Returns a (reset) pooled curl handle for the provided endpoint url or a new curl handle if no usable idle
+ * curl handle is available. Idle curl handles which exceeded the idle timeout are cleaned up.
+ */
+static CURL* remoteServiceAdmin_acquireCurl(remote_service_admin_t* rsa, const char* url) {
+    CURL* curl = NULL;
+    celixThreadMutex_lock(&rsa->curlPoolsLock);
+    celix_array_list_t* idleHandles = celix_stringHashMap_get(rsa->curlPools, url);
+    while (curl == NULL && idleHandles != NULL && celix_arrayList_size(idleHandles) > 0) {
+        int last = celix_arrayList_size(idleHandles) - 1;
+        rsa_dfi_curl_pool_entry_t* entry = celix_arrayList_get(idleHandles, last);
+        celix_arrayList_removeAt(idleHandles, last);
+        if (celix_elapsedtime(CLOCK_MONOTONIC, entry->lastUsed) > (double)rsa->curlPoolIdleTimeout) {
+            curl_easy_cleanup(entry->curl);
+        } else {
+            curl = entry->curl;
+        }
+        free(entry);
+    }
+    celixThreadMutex_unlock(&rsa->curlPoolsLock);
+
+    if (curl != NULL) {
+        //note resetting keeps the open connections, DNS cache and TLS sessions of the curl handle
+        curl_easy_reset(curl);
+    } else {
+        curl = curl_easy_init();
+    }
+    return curl;
+}
+
+/**
+ * Returns a curl handle to the pool of the provided endpoint url, or cleans up the curl handle
+ * if the call failed or the pool is full.
+ */
+static void remoteServiceAdmin_releaseCurl(remote_service_admin_t* rsa, const char* url, CURL* curl, bool reusable) {
+    if (reusable && rsa->curlPoolSize > 0) {
+        celixThreadMutex_lock(&rsa->curlPoolsLock);
+        celix_array_list_t* idleHandles = celix_stringHashMap_get(rsa->curlPools, url);
+        if (idleHandles == NULL) {
+            idleHandles = celix_arrayList_create();
+            celix_stringHashMap_put(rsa->curlPools, url, idleHandles);
+        }
+        if (celix_arrayList_size(idleHandles) < rsa->curlPoolSize) {
+            rsa_dfi_curl_pool_entry_t* entry = malloc(sizeof(*entry));
+            entry->curl = curl;
+            entry->lastUsed = celix_gettime(CLOCK_MONOTONIC);
+            celix_arrayList_add(idleHandles, entry);
+            curl = NULL;
+        }
+        celixThreadMutex_unlock(&rsa->curlPoolsLock);
+    }
+    if (curl != NULL) {
+        curl_easy_cleanup(curl);
+    }
+}
+
+static void remoteServiceAdmin_curlMultiPoll(CURLM* multi) {
+#if LIBCURL_VERSION_NUM >= 0x074400 //7.68.0
+    curl_multi_poll(multi, NULL, 0, 1000, NULL);
+#else
+    //note no curl_multi_wakeup support, use a short timeout so that new requests are picked up
+    curl_multi_wait(multi, NULL, 0, 10, NULL);
+#endif
+}
+
+static void remoteServiceAdmin_curlMultiWakeup(CURLM* multi) {
+#if LIBCURL_VERSION_NUM >= 0x074400 //7.68.0
+    curl_multi_wakeup(multi);
+#else
+    (void)multi;
+#endif
+}
+
+static void* remoteServiceAdmin_curlThread(void *data) {
+    remote_service_admin_t* admin = data;
+    celix_array_list_t* activeRequests = celix_arrayList_create();
+
+    celixThreadMutex_lock(&admin->curlRequestsLock);
+    bool active = admin->curlThreadActive;
+    celixThreadMutex_unlock(&admin->curlRequestsLock);
+
+    while (active) {
+        celixThreadMutex_lock(&admin->curlRequestsLock);
+        for (int i = 0; i < celix_arrayList_size(admin->curlPendingRequests); ++i) {
+            rsa_dfi_curl_request_t* req = celix_arrayList_get(admin->curlPendingRequests, i);
+            curl_multi_add_handle(admin->curlMulti, req->curl);
+            celix_arrayList_add(activeRequests, req);
+        }
+        celix_arrayList_clear(admin->curlPendingRequests);
+        active = admin->curlThreadActive;
+        celixThreadMutex_unlock(&admin->curlRequestsLock);
+
+        int running = 0;
+        curl_multi_perform(admin->curlMulti, &running);
+
+        CURLMsg* msg;
+        int msgsLeft;
+        while ((msg = curl_multi_info_read(admin->curlMulti, &msgsLeft)) != NULL) {
+            if (msg->msg == CURLMSG_DONE) {
+                CURL* curl = msg->easy_handle;
+                CURLcode result = msg->data.result; //note msg is invalid after curl_multi_remove_handle
+                rsa_dfi_curl_request_t* req = NULL;
+                curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&req);
+                curl_multi_remove_handle(admin->curlMulti, curl);
+                celix_arrayList_remove(activeRequests, req);
+
+                celixThreadMutex_lock(&admin->curlRequestsLock);
+                req->result = result;
+                req->done = true;
+                celixThreadCondition_broadcast(&admin->curlRequestsCond);
+                celixThreadMutex_unlock(&admin->curlRequestsLock);
+            }
+        }
+
+        if (active) {
+            remoteServiceAdmin_curlMultiPoll(admin->curlMulti);
+        }
+    }
+
+    //abort the remote calls which are still in progress
+    celixThreadMutex_lock(&admin->curlRequestsLock);
+    for (int i = 0; i < celix_arrayList_size(activeRequests); ++i) {
+        rsa_dfi_curl_request_t* req = celix_arrayList_get(activeRequests, i);
+        curl_multi_remove_handle(admin->curlMulti, req->curl);
+        req->result = CURLE_ABORTED_BY_CALLBACK;
+        req->done = true;
+    }
+    for (int i = 0; i < celix_arrayList_size(admin->curlPendingRequests); ++i) {
+        rsa_dfi_curl_request_t* req = celix_arrayList_get(admin->curlPendingRequests, i);
+        req->result = CURLE_ABORTED_BY_CALLBACK;
+        req->done = true;
+    }
+    celix_arrayList_clear(admin->curlPendingRequests);
+    celixThreadCondition_broadcast(&admin->curlRequestsCond);
+    celixThreadMutex_unlock(&admin->curlRequestsLock);
+
+    celix_arrayList_destroy(activeRequests);
+    return NULL;
+}
+
+static void remoteServiceAdmin_setupCurlThread(remote_service_admin_t* admin) {
+    admin->curlMulti = curl_multi_init();
+    admin->curlPendingRequests = celix_arrayList_create();
+    admin->curlThreadActive = true;
+    celixThreadMutex_create(&admin->curlRequestsLock, NULL);
+    celixThreadCondition_init(&admin->curlRequestsCond, NULL);
+    celixThread_create(&admin->curlThread, NULL, remoteServiceAdmin_curlThread, admin);
+    celixThread_setName(&admin->curlThread, "RSA-Curl");
+}
+
+static void remoteServiceAdmin_teardownCurlThread(remote_service_admin_t* admin) {
+    celixThreadMutex_lock(&admin->curlRequestsLock);
+    admin->curlThreadActive = false;
+    celixThreadMutex_unlock(&admin->curlRequestsLock);
+    remoteServiceAdmin_curlMultiWakeup(admin->curlMulti);
+    celixThread_join(admin->curlThread, NULL);
+
+    curl_multi_cleanup(admin->curlMulti);
+    celix_arrayList_destroy(admin->curlPendingRequests);
+    celixThreadMutex_destroy(&admin->curlRequestsLock);
+    celixThreadCondition_destroy(&admin->curlRequestsCond);
+}
+
+/**
+ * Hands over a prepared curl handle to the curl I/O thread and waits until the remote call is done.
+ */
+static CURLcode remoteServiceAdmin_performAsync(remote_service_admin_t* rsa, CURL* curl) {
+    rsa_dfi_curl_request_t req;
+    req.curl = curl;
+    req.result = CURLE_FAILED_INIT;
+    req.done = false;
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, &req);
+
+    celixThreadMutex_lock(&rsa->curlRequestsLock);
+    if (rsa->curlThreadActive) {
+        celix_arrayList_add(rsa->curlPendingRequests, &req);
+        remoteServiceAdmin_curlMultiWakeup(rsa->curlMulti);
+        while (!req.done) {
+            celixThreadCondition_wait(&rsa->curlRequestsCond, &rsa->curlRequestsLock);
+        }
+    }
+    celixThreadMutex_unlock(&rsa->curlRequestsLock);
+    return req.result;
+}
+
 static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description_t *endpointDescription, char *request, celix_properties_t *metadata, char **reply, int* replyStatus) {
     remote_service_admin_t * rsa = handle;
     struct celix_post_data post;
@@ -922,7 +1163,7 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
     struct celix_get_data_reply get;
     get.buf = NULL;
     get.size = 0;
-    get.stream = open_memstream(&get.buf, &get.size);
+    get.capacity = 0;
 
     const char *serviceUrl = celix_properties_get(endpointDescription->properties, (char*) RSA_DFI_ENDPOINT_URL, NULL);
     char url[256];
@@ -948,11 +1189,12 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
     CURL *curl;
     CURLcode res;
 
-    curl = curl_easy_init();
+    curl = remoteServiceAdmin_acquireCurl(rsa, url);
     if(!curl) {
         status = CELIX_ILLEGAL_STATE;
     } else {
-        struct curl_slist *metadataHeader = NULL;
+        //note disable "Expect: 100-continue", this saves a round trip for larger requests
+        struct curl_slist *headers = curl_slist_append(NULL, "Expect:");
         if (metadata != NULL && celix_properties_size(metadata) > 0) {
             const char *key = NULL;
             CELIX_PROPERTIES_FOR_EACH(metadata, key) {
@@ -962,13 +1204,13 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
                 char header[length];
 
                 snprintf(header, length, "X-RSA-Metadata-%s: %s", key, val);
-                metadataHeader = curl_slist_append(metadataHeader, header);
+                headers = curl_slist_append(headers, header);
             }
-
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, metadataHeader);
         }
 
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
         curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
         curl_easy_setopt(curl, CURLOPT_URL, url);
         curl_easy_setopt(curl, CURLOPT_POST, 1L);
@@ -980,15 +1222,20 @@ static celix_status_t remoteServiceAdmin_send(void *handle, endpoint_description
         if (rsa->curlShareEnabled) {
             curl_easy_setopt(curl, CURLOPT_SHARE, rsa->curlShare);
         }
-        res = curl_easy_perform(curl);
+        if (rsa->curlAsyncEnabled) {
+            res = remoteServiceAdmin_performAsync(rsa, curl);
+        } else {
+            res = curl_easy_perform(curl);
+        }
 
-        fputc('\0', get.stream);
-        fclose(get.stream);
+        if (get.buf == NULL) {
+            get.buf = celix_utils_strdup("");
+        }
         *reply = get.buf;
         *replyStatus = (res == CURLE_OK) ? CELIX_SUCCESS:CELIX_ERROR_MAKE(CELIX_FACILITY_HTTP,res);
 
-        curl_easy_cleanup(curl);
-        curl_slist_free_all(metadataHeader);
+        remoteServiceAdmin_releaseCurl(rsa, url, curl, res == CURLE_OK);
+        curl_slist_free_all(headers);
     }
 
     return status;
@@ -1009,8 +1256,23 @@ static size_t remoteServiceAdmin_readCallback(void *voidBuffer, size_t size, siz
 
 static size_t remoteServiceAdmin_write(void *contents, size_t size, size_t nmemb, void *userp) {
     struct celix_get_data_reply *get = userp;
-    fwrite(contents, size, nmemb, get->stream);
-    return size * nmemb;
+    size_t len = size * nmemb;
+    if (get->size + len + 1 > get->capacity) {
+        size_t newCapacity = get->capacity == 0 ? 1024 : get->capacity;
+        while (get->size + len + 1 > newCapacity) {
+            newCapacity *= 2;
+        }
+        char* newBuf = realloc(get->buf, newCapacity);
+        if (newBuf == NULL) {
+            return 0; //note signals an error to curl
+        }
+        get->buf = newBuf;
+        get->capacity = newCapacity;
+    }
+    memcpy(get->buf + get->size, contents, len);
+    get->size += len;
+    get->buf[get->size] = '\0';
+    return len;
 }
 
 
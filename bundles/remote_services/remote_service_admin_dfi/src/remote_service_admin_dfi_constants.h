@@ -52,6 +52,51 @@
  */
 #define RSA_DFI_USE_CURL_SHARE_HANDLE_DEFAULT   false
 
+/**
+ * @brief Remote Service Admin DFI environment property (named "RSA_DFI_CURL_POOL_SIZE") which specifies
+ * the max number of idle (keep-alive) curl handles the RSA DFI keeps per imported endpoint.
+ *
+ * Reusing a curl handle reuses its open connection, DNS cache and TLS session. If set to 0, a curl handle
+ * is created and cleaned up for every remote call.
+ *
+ * The property is of the type long and the default is 8
+ */
+#define RSA_DFI_CURL_POOL_SIZE                  "RSA_DFI_CURL_POOL_SIZE"
+
+/**
+ * @brief Default value for the environment property RSA_DFI_CURL_POOL_SIZE
+ */
+#define RSA_DFI_CURL_POOL_SIZE_DEFAULT          8
+
+/**
+ * @brief Remote Service Admin DFI environment property (named "RSA_DFI_CURL_POOL_IDLE_TIMEOUT") which specifies
+ * after how many seconds an idle pooled curl handle (and its connection) is closed instead of reused.
+ *
+ * The property is of the type long and the default is 30
+ */
+#define RSA_DFI_CURL_POOL_IDLE_TIMEOUT          "RSA_DFI_CURL_POOL_IDLE_TIMEOUT"
+
+/**
+ * @brief Default value for the environment property RSA_DFI_CURL_POOL_IDLE_TIMEOUT
+ */
+#define RSA_DFI_CURL_POOL_IDLE_TIMEOUT_DEFAULT  30
+
+/**
+ * @brief Remote Service Admin DFI environment property (named "RSA_DFI_USE_ASYNC_CURL") which specifies
+ * whether remote calls are performed by a single I/O thread using a curl multi handle.
+ *
+ * Remote calls still block the calling thread, but concurrent calls are handled by one thread and share the
+ * connections of the curl multi handle.
+ *
+ * The property is of the type boolean and the default is false
+ */
+#define RSA_DFI_USE_ASYNC_CURL                  "RSA_DFI_USE_ASYNC_CURL"
+
+/**
+ * @brief Default value for the environment property RSA_DFI_USE_ASYNC_CURL
+ */
+#define RSA_DFI_USE_ASYNC_CURL_DEFAULT          false
+
 /**
  * @brief Remote Service Admin DFI environment property (named "CELIX_RSA_BIND_ON_ALL_INTERFACES") which specifies
  * whether the RSA server is reachable from all network interfaces.
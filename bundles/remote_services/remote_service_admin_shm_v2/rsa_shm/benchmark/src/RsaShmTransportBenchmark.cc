@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "celix_api.h"
+#include "celix_log_constants.h"
+#include "celix_log_helper.h"
+#include "rsa_shm_client.h"
+#include "rsa_shm_server.h"
+#include "rsa_shm_constants.h"
+
+/**
+ * Measures the round trip latency of a shm RSA call, using the datagram transport or the request ring transport.
+ * The server echoes the request, so the call size applies to the request and the response.
+ * In both modes the server hands the request over to its thread pool (one allocation per request) and signals the reply
+ * with a pshared condition variable, the request ring only replaces the request datagram.
+ */
+class RsaShmTransportBenchmark {
+public:
+    RsaShmTransportBenchmark(bool useRequestRing) : serverName{useRequestRing ? "rsa_shm_bench_ring" : "rsa_shm_bench_dgram"} {
+        auto* config = celix_properties_create();
+        celix_properties_set(config, CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL_CONFIG_NAME, "error");
+        celix_properties_set(config, CELIX_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_NAME, "onFirstInit");
+        celix_properties_setBool(config, RSA_SHM_REQUEST_RING_ENABLED_KEY, useRequestRing);
+        fw = celix_frameworkFactory_createFramework(config);
+        ctx = celix_framework_getFrameworkContext(fw);
+        logHelper = celix_logHelper_create(ctx, "rsa_shm_benchmark");
+
+        auto status = rsaShmServer_create(ctx, serverName.c_str(), logHelper, echo, nullptr, &server);
+        status = status == CELIX_SUCCESS ? rsaShmClientManager_create(ctx, logHelper, &clientManager) : status;
+        status = status == CELIX_SUCCESS ? rsaShmClientManager_createOrAttachClient(clientManager, serverName.c_str(), SERVICE_ID, true) : status;
+        if (status != CELIX_SUCCESS) {
+            std::cerr << "Error creating shm client/server: " << status << std::endl;
+            abort();
+        }
+        metadata = celix_properties_create();
+        celix_properties_setLong(metadata, "endpoint.service.id", SERVICE_ID);
+    }
+
+    ~RsaShmTransportBenchmark() {
+        celix_properties_destroy(metadata);
+        rsaShmClientManager_destroyOrDetachClient(clientManager, serverName.c_str(), SERVICE_ID);
+        rsaShmClientManager_destory(clientManager);
+        rsaShmServer_destroy(server);
+        celix_logHelper_destroy(logHelper);
+        celix_frameworkFactory_destroyFramework(fw);
+    }
+
+    RsaShmTransportBenchmark(RsaShmTransportBenchmark&&) = delete;
+    RsaShmTransportBenchmark& operator=(RsaShmTransportBenchmark&&) = delete;
+    RsaShmTransportBenchmark(const RsaShmTransportBenchmark&) = delete;
+    RsaShmTransportBenchmark& operator=(const RsaShmTransportBenchmark&) = delete;
+
+    void call(std::string& request) {
+        struct iovec req = {request.data(), request.size()};
+        struct iovec response = {nullptr, 0};
+        auto status = rsaShmClientManager_sendMsgTo(clientManager, serverName.c_str(), SERVICE_ID, metadata, &req, &response);
+        if (status != CELIX_SUCCESS || response.iov_len != request.size()) {
+            std::cerr << "Error calling shm server: " << status << std::endl;
+            abort();
+        }
+        free(response.iov_base);
+    }
+
+    static constexpr long SERVICE_ID = 42;
+    const std::string serverName;
+    celix_framework_t* fw{nullptr};
+    celix_bundle_context_t* ctx{nullptr};
+    celix_log_helper_t* logHelper{nullptr};
+    rsa_shm_server_t* server{nullptr};
+    rsa_shm_client_manager_t* clientManager{nullptr};
+    celix_properties_t* metadata{nullptr};
+
+private:
+    static celix_status_t echo(void*, rsa_shm_server_t*, celix_properties_t*, const struct iovec* request, struct iovec* response) {
+        response->iov_base = malloc(request->iov_len);
+        memcpy(response->iov_base, request->iov_base, request->iov_len);
+        response->iov_len = request->iov_len;
+        return CELIX_SUCCESS;
+    }
+};
+
+static void callRemoteService(benchmark::State& state, bool useRequestRing) {
+    RsaShmTransportBenchmark benchmark{useRequestRing};
+    std::string request(state.range(0), 'x');
+    //The request ring is attached asynchronously by the server, warm up until it is used
+    for (int i = 0; i < 100; ++i) {
+        benchmark.call(request);
+    }
+
+    std::vector<double> latenciesInUs{};
+    latenciesInUs.reserve(1024 * 64);
+    for (auto _ : state) {
+        // This code gets timed
+        auto start = std::chrono::steady_clock::now();
+        benchmark.call(request);
+        auto end = std::chrono::steady_clock::now();
+        latenciesInUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0) * 2);
+
+    std::sort(latenciesInUs.begin(), latenciesInUs.end());
+    auto percentile = [&latenciesInUs](double p) {
+        return latenciesInUs.empty() ? 0.0 : latenciesInUs[static_cast<size_t>(p * (latenciesInUs.size() - 1))];
+    };
+    state.counters["p50_us"] = percentile(0.50);
+    state.counters["p99_us"] = percentile(0.99);
+    state.SetLabel(useRequestRing ? "ring request, thpool handoff, condvar reply" : "datagram request, thpool handoff, condvar reply");
+}
+
+static void RsaShmTransportBenchmark_datagram(benchmark::State& state) {
+    callRemoteService(state, false);
+}
+
+static void RsaShmTransportBenchmark_requestRing(benchmark::State& state) {
+    callRemoteService(state, true);
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(RsaShmTransportBenchmark_datagram)->RangeMultiplier(8)->Range(16, 8192); //reference
+CELIX_BENCHMARK(RsaShmTransportBenchmark_requestRing)->RangeMultiplier(8)->Range(16, 8192);
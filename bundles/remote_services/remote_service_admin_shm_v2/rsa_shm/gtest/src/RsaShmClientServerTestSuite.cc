@@ -16,13 +16,14 @@
  * specific language governing permissions and limitations
  * under the License.
  */
+#include <rsa_shm_constants.h>
 #include <celix_shell_command.h>
 #include <celix_api.h>
 #include <gtest/gtest.h>
 
 class RsaShmClientServerTestSuite : public ::testing::Test {
 public:
-    RsaShmClientServerTestSuite() {
+    explicit RsaShmClientServerTestSuite(bool useRequestRing = false) {
         celix_properties_t *serverProps = celix_properties_load("server.properties");
         EXPECT_TRUE(serverProps != NULL);
         sfw = std::shared_ptr<celix_framework_t>{celix_frameworkFactory_createFramework(serverProps),
@@ -32,6 +33,7 @@ public:
 
         celix_properties_t *clientProps = celix_properties_load("client.properties");
         EXPECT_TRUE(clientProps != NULL);
+        celix_properties_setBool(clientProps, RSA_SHM_REQUEST_RING_ENABLED_KEY, useRequestRing);
         cfw = std::shared_ptr<celix_framework_t>{celix_frameworkFactory_createFramework(clientProps),
             [](auto* f) {celix_frameworkFactory_destroyFramework(f);}};
         cctx = std::shared_ptr<celix_bundle_context_t>{celix_framework_getFrameworkContext(cfw.get()),
@@ -44,6 +46,11 @@ public:
     std::shared_ptr<celix_bundle_context_t> cctx{};
 };
 
+class RsaShmRequestRingClientServerTestSuite : public RsaShmClientServerTestSuite {
+public:
+    RsaShmRequestRingClientServerTestSuite() : RsaShmClientServerTestSuite{true} {}
+};
+
 void rsaJsonRpcTestSuite_useCmd(void *handle, void *svc) {
     (void)handle;
     auto *cmd = static_cast<celix_shell_command_t *>(svc);
@@ -60,3 +67,37 @@ TEST_F(RsaShmClientServerTestSuite, CallRemoteService) {
     auto found = celix_bundleContext_useServiceWithOptions(cctx.get(), &opts);
     EXPECT_TRUE(found);
 }
+
+TEST_F(RsaShmClientServerTestSuite, CallRemoteServiceRepeatedly) {
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = CELIX_SHELL_COMMAND_SERVICE_NAME;
+    opts.callbackHandle = this;
+    opts.use = rsaJsonRpcTestSuite_useCmd;
+    opts.flags = CELIX_SERVICE_USE_DIRECT | CELIX_SERVICE_USE_SOD;
+    auto found = celix_bundleContext_useServiceWithOptions(cctx.get(), &opts);
+    EXPECT_TRUE(found);
+
+    //Subsequent invocations reuse the msg controls of the previous invocations
+    opts.flags = CELIX_SERVICE_USE_DIRECT;
+    for (int i = 0; i < 10; ++i) {
+        found = celix_bundleContext_useServiceWithOptions(cctx.get(), &opts);
+        EXPECT_TRUE(found);
+    }
+}
+
+TEST_F(RsaShmRequestRingClientServerTestSuite, CallRemoteServiceRepeatedly) {
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = CELIX_SHELL_COMMAND_SERVICE_NAME;
+    opts.callbackHandle = this;
+    opts.use = rsaJsonRpcTestSuite_useCmd;
+    opts.flags = CELIX_SERVICE_USE_DIRECT | CELIX_SERVICE_USE_SOD;
+    auto found = celix_bundleContext_useServiceWithOptions(cctx.get(), &opts);
+    EXPECT_TRUE(found);
+
+    //The first invocation requests the server to attach the request ring, subsequent invocations use it
+    opts.flags = CELIX_SERVICE_USE_DIRECT;
+    for (int i = 0; i < 10; ++i) {
+        found = celix_bundleContext_useServiceWithOptions(cctx.get(), &opts);
+        EXPECT_TRUE(found);
+    }
+}
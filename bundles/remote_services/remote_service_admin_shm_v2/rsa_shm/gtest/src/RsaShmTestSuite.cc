@@ -118,6 +118,8 @@ TEST_F(RsaShmTestSuite, ExportService) {
         endpoint_description_t *endpoint = nullptr;
         status = admin->exportReference_getExportedEndpoint(ref, &endpoint);
         EXPECT_EQ(CELIX_SUCCESS, status);
+        //clients only send binary metadata if the exporting server advertises it
+        EXPECT_TRUE(celix_properties_getAsBool(endpoint->properties, RSA_SHM_BINARY_METADATA_SUPPORTED_KEY, false));
         service_reference_pt service = nullptr;
         status = admin->exportReference_getExportedService(ref, &service);
         EXPECT_EQ(CELIX_SUCCESS, status);
@@ -19,6 +19,7 @@
 
 #include <rsa_shm_client.h>
 #include <rsa_shm_msg.h>
+#include <rsa_shm_ring.h>
 #include <rsa_shm_constants.h>
 #include <celix_log_helper.h>
 #include <shm_pool.h>
@@ -33,6 +34,8 @@
 #include <sys/param.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
 
 
@@ -41,6 +44,7 @@ struct rsa_shm_client_manager {
     celix_log_helper_t *logHelper;
     long msgTimeOutInSec;
     long maxConcurrentNum;
+    bool requestRingEnabled;
     shm_pool_t *shmPool;
     celix_thread_mutex_t cliensMutex;
     celix_string_hash_map_t *clients;// Key: peer server name; value: client instance
@@ -66,6 +70,13 @@ typedef struct rsa_shm_client {
     char *peerServerName;
     int cfd;
     struct sockaddr_un serverAddr;
+    celix_thread_mutex_t msgCtrlFreeListMutex;
+    celix_array_list_t *msgCtrlFreeList;// Initialized msg controls that can be reused by the next invocation
+    rsa_shm_ring_t *ring;// Request ring in shared memory, NULL if the request ring is not enabled
+    celix_thread_mutex_t ringProducerMutex;// Protects ringAttachRequested and serializes pushes to the ring, not held while waiting on a full ring
+    bool ringAttachRequested;
+    unsigned int replySpinLimit;// Adaptive spin limit for replies of requests sent by the ring
+    bool binaryMetadataSupported;// Atomic, whether the peer server decodes RSA_SHM_METADATA_FORMAT_BINARY
 }rsa_shm_client_t;
 
 typedef struct rsa_shm_exception_msg {
@@ -79,6 +90,62 @@ static celix_status_t rsaShmClientManager_createMsgControl(rsa_shm_client_manage
         rsa_shm_msg_control_t **ctrl);
 static void rsaShmClientManager_destroyMsgControl(rsa_shm_client_manager_t *clientManager,
         rsa_shm_msg_control_t *ctrl);
+static celix_status_t rsaShmClient_tryPushToRing(rsa_shm_client_t *client, const rsa_shm_msg_t *msgInfo) {
+    rsa_shm_client_manager_t *clientManager = client->manager;
+    celix_status_t status = CELIX_ILLEGAL_STATE;
+    if (rsaShmRing_isAttached(client->ring)) {
+        status = rsaShmRing_tryPush(client->ring, msgInfo);
+    } else if (!client->ringAttachRequested) {
+        // The server attaches the ring asynchronously, until then requests are sent as datagrams
+        rsa_shm_msg_t attachMsg = {
+                .size = sizeof(rsa_shm_msg_t),
+                .shmId = shmPool_getShmId(clientManager->shmPool),
+                .ctrlDataOffset = shmPool_getMemoryOffset(clientManager->shmPool, client->ring),
+                .ctrlDataSize = sizeof(rsa_shm_ring_t),
+                .msgBodyOffset = -1,
+                .msgType = RSA_SHM_MSG_TYPE_RING_ATTACH,
+        };
+        client->ringAttachRequested = sendto(client->cfd, &attachMsg, sizeof(attachMsg), 0,
+                (struct sockaddr *) &client->serverAddr, sizeof(struct sockaddr_un)) == sizeof(attachMsg);
+    }
+    return status;
+}
+
+static bool rsaShmClient_pushToRing(rsa_shm_client_t *client, const rsa_shm_msg_t *msgInfo) {
+    rsa_shm_client_manager_t *clientManager = client->manager;
+    celix_status_t status = CELIX_ILLEGAL_STATE;
+    struct timespec start = celix_gettime(CLOCK_MONOTONIC);
+    while (true) {
+        celixThreadMutex_lock(&client->ringProducerMutex);
+        status = rsaShmClient_tryPushToRing(client, msgInfo);
+        celixThreadMutex_unlock(&client->ringProducerMutex);
+        if (status != CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, EAGAIN)) {
+            break;
+        }
+        // The ring is full, wait for a free entry without blocking the other producers of this client
+        long remainingInMs = clientManager->msgTimeOutInSec * 1000 - (long)(celix_elapsedtime(CLOCK_MONOTONIC, start) * 1000);
+        if (remainingInMs <= 0 || rsaShmRing_waitUntilNotFull(client->ring, remainingInMs) != CELIX_SUCCESS) {
+            break;
+        }
+    }
+    return status == CELIX_SUCCESS;
+}
+
+static void rsaShmClient_spinForReply(rsa_shm_client_t *client, rsa_shm_msg_control_t *msgCtrl) {
+    // Short calls are often replied before the client would sleep on the condition, spin a while to catch them
+    unsigned int spinLimit = __atomic_load_n(&client->replySpinLimit, __ATOMIC_RELAXED);
+    if (rsaShmRing_spinWhileRequesting(msgCtrl, spinLimit)) {
+        spinLimit = spinLimit * 2 > RSA_SHM_RING_MAX_SPINS ? RSA_SHM_RING_MAX_SPINS : spinLimit * 2;
+    } else {
+        spinLimit = spinLimit / 2 < RSA_SHM_RING_MIN_SPINS ? RSA_SHM_RING_MIN_SPINS : spinLimit / 2;
+    }
+    __atomic_store_n(&client->replySpinLimit, spinLimit, __ATOMIC_RELAXED);
+}
+
+static celix_status_t rsaShmClient_acquireMsgControl(rsa_shm_client_t *client, rsa_shm_msg_control_t **ctrl);
+static void rsaShmClient_releaseMsgControl(rsa_shm_client_t *client, rsa_shm_msg_control_t *ctrl);
+static size_t rsaShmClient_metadataSize(const celix_properties_t *metadata, rsa_shm_metadata_format format);
+static void rsaShmClient_encodeMetadata(const celix_properties_t *metadata, rsa_shm_metadata_format format, char *buf);
 static void *rsaShmClientManager_exceptionMsgHandlerThread(void *data);
 static celix_status_t rsaShmClientManager_createClient(rsa_shm_client_manager_t *clientManager,
         const char *peerServerName, rsa_shm_client_t **clientOut);
@@ -94,6 +161,8 @@ static void rsaShmClientManager_markSvcCallFinished(rsa_shm_client_manager_t *cl
 static celix_status_t rsaShmClientManager_receiveResponse(rsa_shm_client_manager_t *clientManager,
         rsa_shm_msg_control_t *msgCtrl, char *msgBuffer, size_t bufSize,
         struct iovec *response, bool *replyed);
+static bool rsaShmClient_pushToRing(rsa_shm_client_t *client, const rsa_shm_msg_t *msgInfo);
+static void rsaShmClient_spinForReply(rsa_shm_client_t *client, rsa_shm_msg_control_t *msgCtrl);
 static void rsaShmClient_destroyOrDetachSvcDiagInfo(rsa_shm_client_t *client, long serviceId);
 static void rsaShmClient_createOrAttachSvcDiagInfo(rsa_shm_client_t *client, long serviceId);
 static bool rsaShmClient_shouldBreakInvocation(rsa_shm_client_t *client, long serviceId);
@@ -113,6 +182,8 @@ celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
             RSA_SHM_MAX_CONCURRENT_INVOCATIONS_KEY, RSA_SHM_MAX_CONCURRENT_INVOCATIONS_DEFAULT);
     clientManager->msgTimeOutInSec = celix_bundleContext_getPropertyAsLong(ctx,
             RSA_SHM_MSG_TIMEOUT_KEY, RSA_SHM_MSG_TIMEOUT_DEFAULT_IN_S);
+    clientManager->requestRingEnabled = celix_bundleContext_getPropertyAsBool(ctx,
+            RSA_SHM_REQUEST_RING_ENABLED_KEY, RSA_SHM_REQUEST_RING_ENABLED_DEFAULT);
 
     long shmPoolSize = celix_bundleContext_getPropertyAsLong(ctx, RSA_SHM_MEMORY_POOL_SIZE_KEY,
             RSA_SHM_MEMORY_POOL_SIZE_DEFAULT);
@@ -197,7 +268,7 @@ void rsaShmClientManager_destory(rsa_shm_client_manager_t *clientManager) {
 
 
 celix_status_t rsaShmClientManager_createOrAttachClient(rsa_shm_client_manager_t *clientManager,
-        const char *peerServerName, long serviceId) {
+        const char *peerServerName, long serviceId, bool binaryMetadataSupported) {
     celix_status_t status = CELIX_SUCCESS;
     if (clientManager == NULL || peerServerName == NULL) {
         return CELIX_ILLEGAL_ARGUMENT;
@@ -213,6 +284,8 @@ celix_status_t rsaShmClientManager_createOrAttachClient(rsa_shm_client_manager_t
         celix_stringHashMap_put(clientManager->clients, client->peerServerName, client);
     }
     client->refCnt ++;
+    // Endpoints of the same server advertise the same capabilities, the latest import reflects the running server
+    __atomic_store_n(&client->binaryMetadataSupported, binaryMetadataSupported, __ATOMIC_RELAXED);
 
     rsaShmClient_createOrAttachSvcDiagInfo(client, serviceId);
 
@@ -249,14 +322,9 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
         const struct iovec *request, struct iovec *response) {
     celix_status_t status = CELIX_SUCCESS;
     if (clientManager == NULL || peerServerName == NULL || strlen(peerServerName) >= MAX_RSA_SHM_SERVER_NAME_SIZE
-            || request == NULL || request->iov_base == NULL || request->iov_len == 0
-            || response == NULL) {
+            || request == NULL || request->iov_base == NULL || request->iov_len == 0 || response == NULL) {
         return CELIX_ILLEGAL_ARGUMENT;
     }
-    const char *key = NULL;
-    char *metadataString = NULL;
-    size_t metadataStringSize = 0;
-    FILE *fp = NULL;
     rsa_shm_msg_control_t *msgCtrl = NULL;
 
     rsa_shm_client_t *client = rsaShmClientManager_getClient(clientManager, peerServerName);
@@ -271,22 +339,12 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
         goto invocation_breaked;
     }
 
-    fp = open_memstream(&metadataString, &metadataStringSize);
-    if (fp == NULL) {
-        celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error opening metadata memory. %d.", errno);
-        status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
-        goto err_opening_metadata_mem;
-    }
-    CELIX_PROPERTIES_FOR_EACH(metadata, key) {
-        const char * value = celix_properties_get(metadata, key,"");
-        fprintf(fp,"%s=%s\n", key, value);
-    }
-    fclose(fp);
-    // make the metadata include the terminating null byte ('\0')
-    size_t metadataSize = (metadataStringSize == 0) ? 0 : metadataStringSize +1;
+    rsa_shm_metadata_format metadataFormat = __atomic_load_n(&client->binaryMetadataSupported, __ATOMIC_RELAXED) ?
+            RSA_SHM_METADATA_FORMAT_BINARY : RSA_SHM_METADATA_FORMAT_TEXT;
+    size_t metadataSize = rsaShmClient_metadataSize(metadata, metadataFormat);
     size_t msgBodySize = MAX((metadataSize + request->iov_len), ESTIMATED_MSG_RESPONSE_SIZE_DEFAULT);
 
-    status = rsaShmClientManager_createMsgControl(clientManager, &msgCtrl);
+    status = rsaShmClient_acquireMsgControl(client, &msgCtrl);
     if (status != CELIX_SUCCESS) {
         celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error creating msg control. %d.", status);
         goto err_creating_msgctrl;
@@ -297,10 +355,8 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
         celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error allocing msg buffer.");
         goto err_allocing_msg_buf;
     }
-    if (metadataSize != 0) {
-        memcpy(msgBody, metadataString, metadataSize);
-    }
-    memcpy(msgBody + metadataSize, request->iov_base,request->iov_len);
+    rsaShmClient_encodeMetadata(metadata, metadataFormat, msgBody);
+    memcpy(msgBody + metadataSize, request->iov_base, request->iov_len);
 
     rsa_shm_msg_t msgInfo = {
             .size = sizeof(rsa_shm_msg_t),
@@ -311,19 +367,24 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
             .msgBodyTotalSize = msgBodySize,
             .metadataSize = metadataSize,
             .requestSize = request->iov_len,
+            .metadataFormat = metadataFormat,
     };
     if (msgInfo.shmId < 0 || msgInfo.ctrlDataOffset < 0 || msgInfo.msgBodyOffset < 0) {
         status = CELIX_ILLEGAL_ARGUMENT;
         celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Illegal message info.");
         goto illegal_msg;
     }
-    if (sendto(client->cfd, &msgInfo, sizeof(msgInfo), 0, (struct sockaddr *) &client->serverAddr,
+    bool sentByRing = client->ring != NULL && rsaShmClient_pushToRing(client, &msgInfo);
+    if (!sentByRing && sendto(client->cfd, &msgInfo, sizeof(msgInfo), 0, (struct sockaddr *) &client->serverAddr,
             sizeof(struct sockaddr_un)) != sizeof(msgInfo)) {
         status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, errno);
         celix_logHelper_error(clientManager->logHelper, "RsaShmClient: Error sending message to %s. %d",
                 peerServerName, errno);
         goto err_sending_msg;
     }
+    if (sentByRing) {
+        rsaShmClient_spinForReply(client, msgCtrl);
+    }
     bool replyed = false;
     status = rsaShmClientManager_receiveResponse(clientManager, msgCtrl, msgBody,
             msgBodySize, response, &replyed);
@@ -335,7 +396,7 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
     if (replyed) {
         rsaShmClientManager_markSvcCallFinished(clientManager, peerServerName, serviceId);
         shmPool_free(clientManager->shmPool, msgBody);
-        rsaShmClientManager_destroyMsgControl(clientManager, msgCtrl);
+        rsaShmClient_releaseMsgControl(client, msgCtrl);
     } else {
         rsa_shm_exception_msg_t *exceptionMsg = (rsa_shm_exception_msg_t *)malloc(sizeof(*exceptionMsg));
         assert(exceptionMsg != NULL);
@@ -350,27 +411,80 @@ celix_status_t rsaShmClientManager_sendMsgTo(rsa_shm_client_manager_t *clientMan
         celixThreadCondition_signal(&clientManager->exceptionMsgListNotEmpty);
     }
 
-    if (metadataString != NULL) {
-        free(metadataString);
-    }
     rsaShmClientManager_ungetClient(clientManager, client);
     return status;
 err_sending_msg:
 illegal_msg:
     shmPool_free(clientManager->shmPool, msgBody);
 err_allocing_msg_buf:
-    rsaShmClientManager_destroyMsgControl(clientManager, msgCtrl);
+    rsaShmClient_releaseMsgControl(client, msgCtrl);
 err_creating_msgctrl:
-    if (metadataString != NULL) {
-        free(metadataString);
-    }
-err_opening_metadata_mem:
 invocation_breaked:
     rsaShmClientManager_ungetClient(clientManager, client);
 err_getting_client:
     return status;
 }
 
+static size_t rsaShmClient_metadataSize(const celix_properties_t *metadata, rsa_shm_metadata_format format) {
+    if (metadata == NULL || celix_properties_size(metadata) == 0) {
+        return 0;
+    }
+    // Text: "key=value\n" entries and a terminating null byte
+    size_t size = format == RSA_SHM_METADATA_FORMAT_BINARY ? sizeof(uint32_t) : 1;
+    const char *key = NULL;
+    CELIX_PROPERTIES_FOR_EACH(metadata, key) {
+        const char *value = celix_properties_get(metadata, key, "");
+        if (format == RSA_SHM_METADATA_FORMAT_BINARY) {
+            size += sizeof(uint32_t) + strlen(key) + 1 + sizeof(uint32_t) + strlen(value) + 1;
+        } else {
+            size += strlen(key) + 1 + strlen(value) + 1;
+        }
+    }
+    return size;
+}
+
+static char* rsaShmClient_encodeMetadataString(char *buf, const char *str) {
+    uint32_t len = (uint32_t)strlen(str);
+    memcpy(buf, &len, sizeof(len));
+    buf += sizeof(len);
+    memcpy(buf, str, len + 1);
+    return buf + len + 1;
+}
+
+static void rsaShmClient_encodeTextMetadata(const celix_properties_t *metadata, char *buf) {
+    const char *key = NULL;
+    CELIX_PROPERTIES_FOR_EACH(metadata, key) {
+        const char *value = celix_properties_get(metadata, key, "");
+        size_t keyLen = strlen(key);
+        size_t valueLen = strlen(value);
+        memcpy(buf, key, keyLen);
+        buf[keyLen] = '=';
+        memcpy(buf + keyLen + 1, value, valueLen);
+        buf[keyLen + 1 + valueLen] = '\n';
+        buf += keyLen + 1 + valueLen + 1;
+    }
+    *buf = '\0';
+}
+
+static void rsaShmClient_encodeMetadata(const celix_properties_t *metadata, rsa_shm_metadata_format format, char *buf) {
+    if (metadata == NULL || celix_properties_size(metadata) == 0) {
+        return;
+    }
+    if (format == RSA_SHM_METADATA_FORMAT_TEXT) {
+        rsaShmClient_encodeTextMetadata(metadata, buf);
+        return;
+    }
+    uint32_t nrOfEntries = 0;
+    char *cur = buf + sizeof(nrOfEntries);
+    const char *key = NULL;
+    CELIX_PROPERTIES_FOR_EACH(metadata, key) {
+        cur = rsaShmClient_encodeMetadataString(cur, key);
+        cur = rsaShmClient_encodeMetadataString(cur, celix_properties_get(metadata, key, ""));
+        nrOfEntries++;
+    }
+    memcpy(buf, &nrOfEntries, sizeof(nrOfEntries));
+}
+
 static celix_status_t rsaShmClientManager_createClient(rsa_shm_client_manager_t *clientManager,
         const char *peerServerName, rsa_shm_client_t **clientOut) {
     celix_status_t status = CELIX_SUCCESS;
@@ -392,6 +506,28 @@ static celix_status_t rsaShmClientManager_createClient(rsa_shm_client_manager_t
     assert(client->svcDiagInfo != NULL);
     client->peerServerName = strdup(peerServerName);
     assert(client->peerServerName != NULL);
+    status = celixThreadMutex_create(&client->msgCtrlFreeListMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        goto msg_ctrl_free_list_mutex_err;
+    }
+    client->msgCtrlFreeList = celix_arrayList_create();
+    assert(client->msgCtrlFreeList != NULL);
+    status = celixThreadMutex_create(&client->ringProducerMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        goto ring_producer_mutex_err;
+    }
+    client->ringAttachRequested = false;
+    client->replySpinLimit = RSA_SHM_RING_MIN_SPINS;
+    client->binaryMetadataSupported = false;
+    client->ring = NULL;
+    if (clientManager->requestRingEnabled) {
+        client->ring = (rsa_shm_ring_t *)shmPool_malloc(clientManager->shmPool, sizeof(rsa_shm_ring_t));
+        if (client->ring != NULL) {
+            rsaShmRing_init(client->ring);
+        } else {
+            celix_logHelper_warning(clientManager->logHelper, "RsaShmClient: Error allocing request ring, use datagrams instead.");
+        }
+    }
 
     //Create client socket, and bind to unique pathname(based on PID)
     client->cfd = socket(AF_UNIX, SOCK_DGRAM, 0);
@@ -430,6 +566,14 @@ bind_cfd_err:
 client_pathname_invalid:
     close(client->cfd);
 cfd_err:
+    if (client->ring != NULL) {
+        shmPool_free(clientManager->shmPool, client->ring);
+    }
+    (void)celixThreadMutex_destroy(&client->ringProducerMutex);
+ring_producer_mutex_err:
+    celix_arrayList_destroy(client->msgCtrlFreeList);
+    (void)celixThreadMutex_destroy(&client->msgCtrlFreeListMutex);
+msg_ctrl_free_list_mutex_err:
     free(client->peerServerName);
     celix_longHashMap_destroy(client->svcDiagInfo);
     (void)celixThreadMutex_destroy(&client->diagInfoMutex);
@@ -439,7 +583,22 @@ diag_info_mutex_err:
 }
 
 static void rsaShmClientManager_destroyClient(rsa_shm_client_t *client) {
+    if (client->ring != NULL) {
+        if (rsaShmRing_close(client->ring, 1000)) {
+            shmPool_free(client->manager->shmPool, client->ring);
+        } else {
+            //The server may still access the ring, it is released together with the shared memory pool
+            celix_logHelper_warning(client->manager->logHelper, "RsaShmClient: Server %s did not detach request ring.", client->peerServerName);
+        }
+    }
+    (void)celixThreadMutex_destroy(&client->ringProducerMutex);
     close(client->cfd);
+    int nrOfFreeCtrls = celix_arrayList_size(client->msgCtrlFreeList);
+    for (int i = 0; i < nrOfFreeCtrls; ++i) {
+        rsaShmClientManager_destroyMsgControl(client->manager, celix_arrayList_get(client->msgCtrlFreeList, i));
+    }
+    celix_arrayList_destroy(client->msgCtrlFreeList);
+    (void)celixThreadMutex_destroy(&client->msgCtrlFreeListMutex);
     free(client->peerServerName);
     /* Service diagnostics information have been destroyed by rsaShmClientManager_destroyOrDetachClient.
      * Therefore, the hash map of service diagnostics information must be empty here.
@@ -573,6 +732,38 @@ static void rsaShmClientManager_destroyMsgControl(rsa_shm_client_manager_t *clie
     return;
 }
 
+static celix_status_t rsaShmClient_acquireMsgControl(rsa_shm_client_t *client, rsa_shm_msg_control_t **ctrl) {
+    rsa_shm_msg_control_t *msgCtrl = NULL;
+    celixThreadMutex_lock(&client->msgCtrlFreeListMutex);
+    int nrOfFreeCtrls = celix_arrayList_size(client->msgCtrlFreeList);
+    if (nrOfFreeCtrls > 0) {
+        msgCtrl = celix_arrayList_get(client->msgCtrlFreeList, nrOfFreeCtrls - 1);
+        celix_arrayList_removeAt(client->msgCtrlFreeList, nrOfFreeCtrls - 1);
+    }
+    celixThreadMutex_unlock(&client->msgCtrlFreeListMutex);
+    if (msgCtrl == NULL) {
+        return rsaShmClientManager_createMsgControl(client->manager, ctrl);
+    }
+    // The msg control is not shared with a server until the msg info is sent, so no lock is needed here
+    msgCtrl->msgState = REQUESTING;
+    msgCtrl->actualReplyedSize = 0;
+    *ctrl = msgCtrl;
+    return CELIX_SUCCESS;
+}
+
+static void rsaShmClient_releaseMsgControl(rsa_shm_client_t *client, rsa_shm_msg_control_t *ctrl) {
+    bool recycled = false;
+    celixThreadMutex_lock(&client->msgCtrlFreeListMutex);
+    if (celix_arrayList_size(client->msgCtrlFreeList) < client->manager->maxConcurrentNum) {
+        celix_arrayList_add(client->msgCtrlFreeList, ctrl);
+        recycled = true;
+    }
+    celixThreadMutex_unlock(&client->msgCtrlFreeListMutex);
+    if (!recycled) {
+        rsaShmClientManager_destroyMsgControl(client->manager, ctrl);
+    }
+}
+
 static bool rsaShmClientManager_handleMsgState(rsa_shm_client_manager_t *clientManager,
         struct rsa_shm_exception_msg *msgEntry) {
     bool removed = false;
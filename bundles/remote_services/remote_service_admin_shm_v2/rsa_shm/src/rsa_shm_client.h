@@ -36,8 +36,14 @@ celix_status_t rsaShmClientManager_create(celix_bundle_context_t *ctx,
 
 void rsaShmClientManager_destory(rsa_shm_client_manager_t *clientManager);
 
+/**
+ * @brief Creates a client for the peer server or attaches to the existing one.
+ *
+ * @param[in] binaryMetadataSupported Whether the peer server decodes binary metadata (see RSA_SHM_BINARY_METADATA_SUPPORTED_KEY).
+ * If false, the metadata is sent in the text format understood by older servers.
+ */
 celix_status_t rsaShmClientManager_createOrAttachClient(rsa_shm_client_manager_t *clientManager,
-        const char *peerServerName, long serviceId);
+        const char *peerServerName, long serviceId, bool binaryMetadataSupported);
 
 void rsaShmClientManager_destroyOrDetachClient(rsa_shm_client_manager_t *clientManager,
         const char *peerServerName, long serviceId);
@@ -29,6 +29,12 @@ extern "C" {
 
 #define RSA_SHM_SERVER_NAME_KEY "rsaShmServerName"
 
+/**
+ * Endpoint property which is set to true if the exporting shm server decodes binary metadata
+ * (RSA_SHM_METADATA_FORMAT_BINARY). Absent for older servers, clients then send text metadata.
+ */
+#define RSA_SHM_BINARY_METADATA_SUPPORTED_KEY "rsaShmBinaryMetadataSupported"
+
 /**
  * @brief A property of RsaShm bundle that indicates the shared memory pool size.
  *  Its value should be greater than 8192
@@ -65,6 +71,20 @@ extern "C" {
  */
 #define RSA_SHM_MAX_CONCURRENT_INVOCATIONS_DEFAULT 32
 
+/**
+ * @brief A property of RsaShm bundle that enables the shared memory request ring of the clients.
+ * If it is true, a client pushes its requests to a ring in shared memory, which the server consumes
+ * without a datagram per request. Servers always support clients that use the request ring.
+ *
+ */
+#define RSA_SHM_REQUEST_RING_ENABLED_KEY "rsaShmRequestRingEnabled"
+
+/**
+ * @brief The default value of RSA_SHM_REQUEST_RING_ENABLED_KEY
+ *
+ */
+#define RSA_SHM_REQUEST_RING_ENABLED_DEFAULT false
+
 /**
  * @brief The maximum failures of service invocation.
  * If there are more invocation failures than this value, the service invocation will fail for the next 'RSA_SHM_MAX_SVC_BREAKED_TIME_IN_S' seconds
@@ -529,6 +529,7 @@ static celix_status_t rsaShm_createEndpointDescription(rsa_shm_t *admin,
     free(rpcType);
     celix_properties_setWithoutCopy(endpointProperties, strdup(OSGI_RSA_SERVICE_IMPORTED_CONFIGS), importedConfigs);
     celix_properties_set(endpointProperties, (char *) RSA_SHM_SERVER_NAME_KEY, admin->shmServerName);
+    celix_properties_setBool(endpointProperties, RSA_SHM_BINARY_METADATA_SUPPORTED_KEY, true);
 
     *description = calloc(1, sizeof(**description));
     assert(*description != NULL);
@@ -597,8 +598,10 @@ celix_status_t rsaShm_importService(rsa_shm_t *admin, endpoint_description_t *en
             goto shm_server_name_err;
         }
 
+        bool binaryMetadataSupported = celix_properties_getAsBool(endpointDesc->properties,
+                RSA_SHM_BINARY_METADATA_SUPPORTED_KEY, false);
         status = rsaShmClientManager_createOrAttachClient(admin->shmClientManager,
-                shmServerName, (long)endpointDesc->serviceId);
+                shmServerName, (long)endpointDesc->serviceId, binaryMetadataSupported);
         if (status != CELIX_SUCCESS) {
             celix_logHelper_error(admin->logHelper, "Error Creating shm client for service %s. %d", endpointDesc->serviceName, status);
             goto shm_client_err;
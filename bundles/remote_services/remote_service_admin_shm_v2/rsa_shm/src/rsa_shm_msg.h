@@ -34,6 +34,25 @@ typedef enum {
     ABEND = 3,//abnormal end
 }rsa_shm_msg_state;
 
+/**
+ * @brief Encoding of the metadata at the start of the message body.
+ *
+ * RSA_SHM_METADATA_FORMAT_TEXT is a null-terminated "key=value\n" string.
+ * RSA_SHM_METADATA_FORMAT_BINARY is a uint32_t entry count followed by, for every entry,
+ * a uint32_t key length, the key, a uint32_t value length and the value. Lengths exclude
+ * the terminating null byte, which is always written after the key and the value.
+ * Integers use host byte order and are not aligned.
+ */
+typedef enum {
+    RSA_SHM_METADATA_FORMAT_TEXT = 0,
+    RSA_SHM_METADATA_FORMAT_BINARY = 1,
+}rsa_shm_metadata_format;
+
+typedef enum {
+    RSA_SHM_MSG_TYPE_REQUEST = 0,
+    RSA_SHM_MSG_TYPE_RING_ATTACH = 1,//ctrlDataOffset and ctrlDataSize describe a 'struct rsa_shm_ring' of the client
+}rsa_shm_msg_type;
+
 typedef struct rsa_shm_msg_control {
     size_t size;//The size of ‘struct rsa_shm_msg_control‘.It is used to extend 'struct rsa_shm_msg_control' in the future.
     rsa_shm_msg_state msgState;
@@ -51,6 +70,8 @@ typedef struct rsa_shm_msg {
     size_t msgBodyTotalSize;//equal metadataSize + requestSize + reserve space size
     size_t metadataSize;
     size_t requestSize;
+    rsa_shm_metadata_format metadataFormat;//Absent(treated as RSA_SHM_METADATA_FORMAT_TEXT) if the peer uses an older 'struct rsa_shm_msg'
+    rsa_shm_msg_type msgType;//Absent(treated as RSA_SHM_MSG_TYPE_REQUEST) if the peer uses an older 'struct rsa_shm_msg'
 }rsa_shm_msg_t;
 
 #ifdef __cplusplus
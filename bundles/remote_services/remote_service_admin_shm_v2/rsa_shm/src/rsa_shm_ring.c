@@ -0,0 +1,214 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <rsa_shm_ring.h>
+#include <celix_build_assert.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#define RSA_SHM_RING_WAIT_SLICE_IN_MS 100
+
+//Spinning only helps if the peer can run at the same time
+static bool rsaShmRing_spinningUseful(void) {
+    static int nrOfCpus = 0;
+    int cpus = __atomic_load_n(&nrOfCpus, __ATOMIC_RELAXED);
+    if (cpus == 0) {
+        cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        __atomic_store_n(&nrOfCpus, cpus, __ATOMIC_RELAXED);
+    }
+    return cpus > 1;
+}
+
+static inline void rsaShmRing_cpuRelax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+//The ring is shared between processes, so the futexes must not be private
+static int rsaShmRing_futexWait(uint32_t *addr, uint32_t expected, long timeoutInMs) {
+    struct timespec timeout = {timeoutInMs / 1000, (timeoutInMs % 1000) * 1000000};
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT, expected, &timeout, NULL, 0);
+}
+
+static void rsaShmRing_futexWake(uint32_t *addr, int nrOfWaiters) {
+    (void)syscall(SYS_futex, addr, FUTEX_WAKE, nrOfWaiters, NULL, NULL, 0);
+}
+
+void rsaShmRing_init(rsa_shm_ring_t *ring) {
+    CELIX_BUILD_ASSERT((RSA_SHM_RING_CAPACITY & (RSA_SHM_RING_CAPACITY - 1)) == 0);
+    memset(ring, 0, sizeof(*ring));
+    ring->size = sizeof(*ring);
+    ring->clientPid = getpid();
+    __atomic_store_n(&ring->state, RSA_SHM_RING_CREATED, __ATOMIC_RELEASE);
+}
+
+bool rsaShmRing_attach(rsa_shm_ring_t *ring) {
+    uint32_t expected = RSA_SHM_RING_CREATED;
+    return __atomic_compare_exchange_n(&ring->state, &expected, RSA_SHM_RING_ATTACHED, false,
+            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+bool rsaShmRing_isAttached(rsa_shm_ring_t *ring) {
+    return __atomic_load_n(&ring->state, __ATOMIC_ACQUIRE) == RSA_SHM_RING_ATTACHED;
+}
+
+celix_status_t rsaShmRing_tryPush(rsa_shm_ring_t *ring, const rsa_shm_msg_t *msg) {
+    if (!rsaShmRing_isAttached(ring)) {
+        return CELIX_ILLEGAL_STATE;
+    }
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head >= RSA_SHM_RING_CAPACITY) {
+        return CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, EAGAIN);
+    }
+
+    ring->entries[tail & (RSA_SHM_RING_CAPACITY - 1)] = *msg;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->consumerWaiting, __ATOMIC_SEQ_CST)) {
+        rsaShmRing_futexWake(&ring->tail, 1);
+    }
+    return CELIX_SUCCESS;
+}
+
+celix_status_t rsaShmRing_waitUntilNotFull(rsa_shm_ring_t *ring, long timeoutInMs) {
+    celix_status_t status = CELIX_SUCCESS;
+    long waitedInMs = 0;
+    //Announce that a producer is waiting before checking the head again
+    __atomic_add_fetch(&ring->producerWaiting, 1, __ATOMIC_SEQ_CST);
+    for (;;) {
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head < RSA_SHM_RING_CAPACITY) {
+            break;
+        }
+        if (!rsaShmRing_isAttached(ring)) {
+            status = CELIX_ILLEGAL_STATE;
+            break;
+        }
+        if (waitedInMs >= timeoutInMs) {
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, ETIMEDOUT);
+            break;
+        }
+        long sliceInMs = timeoutInMs - waitedInMs < RSA_SHM_RING_WAIT_SLICE_IN_MS ? timeoutInMs - waitedInMs : RSA_SHM_RING_WAIT_SLICE_IN_MS;
+        (void)rsaShmRing_futexWait(&ring->head, head, sliceInMs);
+        waitedInMs += sliceInMs;
+    }
+    __atomic_sub_fetch(&ring->producerWaiting, 1, __ATOMIC_SEQ_CST);
+    return status;
+}
+
+static void rsaShmRing_takeEntry(rsa_shm_ring_t *ring, uint32_t head, rsa_shm_msg_t *msg) {
+    *msg = ring->entries[head & (RSA_SHM_RING_CAPACITY - 1)];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->producerWaiting, __ATOMIC_SEQ_CST)) {
+        rsaShmRing_futexWake(&ring->head, INT_MAX);
+    }
+}
+
+celix_status_t rsaShmRing_pop(rsa_shm_ring_t *ring, rsa_shm_msg_t *msg, unsigned int *spinLimit, long timeoutInMs) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    unsigned int spins = rsaShmRing_spinningUseful() ? *spinLimit : 0;
+    for (unsigned int i = 0; i < spins; ++i) {
+        if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) != head) {
+            //Spinning paid off, allow more spinning next time
+            *spinLimit = *spinLimit * 2 > RSA_SHM_RING_MAX_SPINS ? RSA_SHM_RING_MAX_SPINS : *spinLimit * 2;
+            rsaShmRing_takeEntry(ring, head, msg);
+            return CELIX_SUCCESS;
+        }
+        rsaShmRing_cpuRelax();
+    }
+    *spinLimit = *spinLimit / 2 < RSA_SHM_RING_MIN_SPINS ? RSA_SHM_RING_MIN_SPINS : *spinLimit / 2;
+
+    //Ring is empty, announce that the consumer is waiting before checking the tail again
+    celix_status_t status = CELIX_SUCCESS;
+    __atomic_store_n(&ring->consumerWaiting, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) == head) {
+        if (__atomic_load_n(&ring->state, __ATOMIC_ACQUIRE) != RSA_SHM_RING_ATTACHED) {
+            status = CELIX_ILLEGAL_STATE;
+            break;
+        }
+        if (rsaShmRing_futexWait(&ring->tail, head, timeoutInMs) != 0 && errno == ETIMEDOUT) {
+            status = CELIX_ERROR_MAKE(CELIX_FACILITY_CERRNO, ETIMEDOUT);
+            break;
+        }
+    }
+    __atomic_store_n(&ring->consumerWaiting, 0, __ATOMIC_RELAXED);
+    if (status == CELIX_SUCCESS) {
+        rsaShmRing_takeEntry(ring, head, msg);
+    }
+    return status;
+}
+
+bool rsaShmRing_tryPop(rsa_shm_ring_t *ring, rsa_shm_msg_t *msg) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head) {
+        return false;
+    }
+    rsaShmRing_takeEntry(ring, head, msg);
+    return true;
+}
+
+bool rsaShmRing_close(rsa_shm_ring_t *ring, long timeoutInMs) {
+    uint32_t state = __atomic_load_n(&ring->state, __ATOMIC_ACQUIRE);
+    while (state == RSA_SHM_RING_CREATED || state == RSA_SHM_RING_ATTACHED) {
+        if (__atomic_compare_exchange_n(&ring->state, &state, RSA_SHM_RING_CLOSED, false,
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            if (state == RSA_SHM_RING_CREATED) {
+                return true;
+            }
+            state = RSA_SHM_RING_CLOSED;
+            break;
+        }
+    }
+    //Wake up the consumer, so that it notices the closed ring and detaches
+    rsaShmRing_futexWake(&ring->tail, 1);
+    long waitedInMs = 0;
+    while ((state = __atomic_load_n(&ring->state, __ATOMIC_ACQUIRE)) != RSA_SHM_RING_DETACHED
+            && waitedInMs < timeoutInMs) {
+        (void)rsaShmRing_futexWait(&ring->state, state, RSA_SHM_RING_WAIT_SLICE_IN_MS);
+        waitedInMs += RSA_SHM_RING_WAIT_SLICE_IN_MS;
+    }
+    return state == RSA_SHM_RING_DETACHED;
+}
+
+void rsaShmRing_detach(rsa_shm_ring_t *ring) {
+    __atomic_store_n(&ring->state, RSA_SHM_RING_DETACHED, __ATOMIC_SEQ_CST);
+    rsaShmRing_futexWake(&ring->state, INT_MAX);
+    rsaShmRing_futexWake(&ring->head, INT_MAX);
+    rsaShmRing_futexWake(&ring->tail, INT_MAX);
+}
+
+bool rsaShmRing_spinWhileRequesting(rsa_shm_msg_control_t *msgCtrl, unsigned int spinLimit) {
+    if (!rsaShmRing_spinningUseful()) {
+        return false;
+    }
+    for (unsigned int i = 0; i < spinLimit; ++i) {
+        if (__atomic_load_n(&msgCtrl->msgState, __ATOMIC_ACQUIRE) != REQUESTING) {
+            return true;
+        }
+        rsaShmRing_cpuRelax();
+    }
+    return false;
+}
@@ -0,0 +1,150 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _RSA_SHM_RING_H_
+#define _RSA_SHM_RING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <rsa_shm_msg.h>
+#include <celix_errno.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/**
+ * @brief The number of entries of a request ring. It must be a power of two.
+ */
+#define RSA_SHM_RING_CAPACITY 64
+
+/**
+ * @brief The minimum and maximum number of spins before a ring consumer sleeps on a futex.
+ * The consumer adapts its spin limit between these values, depending on whether spinning was successful.
+ */
+#define RSA_SHM_RING_MIN_SPINS 16
+#define RSA_SHM_RING_MAX_SPINS 8192
+
+typedef enum {
+    RSA_SHM_RING_CREATED = 0,
+    RSA_SHM_RING_ATTACHED = 1,//The server consumes the ring
+    RSA_SHM_RING_CLOSED = 2,//The client closed the ring, the server must detach it
+    RSA_SHM_RING_DETACHED = 3,//The server no longer consumes the ring
+}rsa_shm_ring_state;
+
+/**
+ * @brief A single producer, single consumer request ring in shared memory.
+ *
+ * The client(producer) allocates the ring in its shared memory pool and pushes rsa_shm_msg_t entries,
+ * the server(consumer) pops them. Producer and consumer positions live on separate cache lines.
+ * Waiting sides sleep on a futex of the position they are waiting for and are only woken if
+ * they announced that they are waiting.
+ */
+typedef struct rsa_shm_ring {
+    size_t size;//The size of 'struct rsa_shm_ring'. It is used to extend 'struct rsa_shm_ring' in the future.
+    pid_t clientPid;
+    uint32_t state;//rsa_shm_ring_state, futex word for the attach/detach handshake
+    char statePadding[64];
+    uint32_t head;//Next entry to consume, futex word for producers waiting on a full ring
+    uint32_t producerWaiting;//Nr of producers waiting on a full ring
+    char headPadding[64];
+    uint32_t tail;//Next entry to produce, futex word for a consumer waiting on an empty ring
+    uint32_t consumerWaiting;
+    char tailPadding[64];
+    rsa_shm_msg_t entries[RSA_SHM_RING_CAPACITY];
+}rsa_shm_ring_t;
+
+/**
+ * @brief Initialize a ring which is allocated by the client.
+ */
+void rsaShmRing_init(rsa_shm_ring_t *ring);
+
+/**
+ * @brief Attach the server to the ring.
+ * @return true if the ring was created and is now attached.
+ */
+bool rsaShmRing_attach(rsa_shm_ring_t *ring);
+
+/**
+ * @brief Check whether the server consumes the ring.
+ */
+bool rsaShmRing_isAttached(rsa_shm_ring_t *ring);
+
+/**
+ * @brief Push a message to the ring without waiting. The caller must serialize calls to this function.
+ *
+ * @param[in] ring The ring
+ * @param[in] msg The message
+ * @return CELIX_SUCCESS, CELIX_ILLEGAL_STATE if the ring is not attached or an EAGAIN error if the ring is full.
+ */
+celix_status_t rsaShmRing_tryPush(rsa_shm_ring_t *ring, const rsa_shm_msg_t *msg);
+
+/**
+ * @brief Wait until the ring has a free entry. Can be called concurrently by multiple producers,
+ * so a producer does not need to hold its push serialization while waiting.
+ * Note that the free entry can be taken by another producer before the next push.
+ *
+ * @param[in] ring The ring
+ * @param[in] timeoutInMs The maximum time to wait
+ * @return CELIX_SUCCESS, CELIX_ILLEGAL_STATE if the ring is not attached or a timeout error.
+ */
+celix_status_t rsaShmRing_waitUntilNotFull(rsa_shm_ring_t *ring, long timeoutInMs);
+
+/**
+ * @brief Pop a message from the ring. Only the server thread that attached the ring may call this function.
+ *
+ * @param[in] ring The ring
+ * @param[out] msg The popped message
+ * @param[in,out] spinLimit The adaptive spin limit of the consumer
+ * @param[in] timeoutInMs The maximum time to sleep if the ring is empty
+ * @return CELIX_SUCCESS, CELIX_ILLEGAL_STATE if the ring is closed or a timeout error.
+ */
+celix_status_t rsaShmRing_pop(rsa_shm_ring_t *ring, rsa_shm_msg_t *msg, unsigned int *spinLimit, long timeoutInMs);
+
+/**
+ * @brief Pop a message without waiting, used to drain the ring after it has been detached.
+ * @return true if a message has been popped.
+ */
+bool rsaShmRing_tryPop(rsa_shm_ring_t *ring, rsa_shm_msg_t *msg);
+
+/**
+ * @brief Close the ring by the client and wait until the server has detached it.
+ *
+ * @param[in] ring The ring
+ * @param[in] timeoutInMs The maximum time to wait for the server
+ * @return true if the server no longer uses the ring, and the ring can be freed.
+ */
+bool rsaShmRing_close(rsa_shm_ring_t *ring, long timeoutInMs);
+
+/**
+ * @brief Detach the server from the ring, and wake up the waiting producer and consumer.
+ */
+void rsaShmRing_detach(rsa_shm_ring_t *ring);
+
+/**
+ * @brief Spin until the message state is no longer REQUESTING, or until the spin limit is reached.
+ * @return true if the message state changed while spinning.
+ */
+bool rsaShmRing_spinWhileRequesting(rsa_shm_msg_control_t *msgCtrl, unsigned int spinLimit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RSA_SHM_RING_H_ */
@@ -18,6 +18,7 @@
  */
 #include <rsa_shm_server.h>
 #include <rsa_shm_msg.h>
+#include <rsa_shm_ring.h>
 #include <rsa_shm_constants.h>
 #include <shm_cache.h>
 #include <celix_log_helper.h>
@@ -34,7 +35,10 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <errno.h>
+#include <signal.h>
 
 #define MAX_RSA_SHM_SERVER_HANDLE_MSG_THREADS_NUM 5
 
@@ -50,8 +54,18 @@ struct rsa_shm_server {
     rsaShmServer_receiveMsgCB revCB;
     void *revCBHandle;
     long msgTimeOutInSec;
+    celix_thread_mutex_t ringConsumersMutex;
+    celix_array_list_t *ringConsumers;// Element: rsa_shm_server_ring_consumer_t*
 };
 
+typedef struct rsa_shm_server_ring_consumer {
+    rsa_shm_server_t *server;
+    rsa_shm_ring_t *ring;
+    celix_thread_t thread;
+    bool active;
+    bool finished;
+}rsa_shm_server_ring_consumer_t;
+
 struct rsa_shm_server_thpool_work_data {
     rsa_shm_server_t *server;
     rsa_shm_msg_control_t *msgCtrl;
@@ -59,9 +73,11 @@ struct rsa_shm_server_thpool_work_data {
     size_t msgBodyTotalSize;
     size_t metadataSize;
     size_t requestSize;
+    rsa_shm_metadata_format metadataFormat;
 };
 
 static void *rsaShmServer_receiveMsgThread(void *data);
+static void rsaShmServer_stopRingConsumers(rsa_shm_server_t *server, bool onlyFinished);
 
 celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name, celix_log_helper_t *loghelper,
         rsaShmServer_receiveMsgCB receiveCB, void *revHandle, rsa_shm_server_t **shmServerOut) {
@@ -110,6 +126,13 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
         status = CELIX_ILLEGAL_STATE;
         goto create_thpool_err;
     }
+    status = celixThreadMutex_create(&server->ringConsumersMutex, NULL);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(loghelper, "RsaShmServer: create ring consumers mutex err.");
+        goto create_ring_consumers_mutex_err;
+    }
+    server->ringConsumers = celix_arrayList_create();
+    assert(server->ringConsumers != NULL);
     server->revCB = receiveCB;
     server->revCBHandle = revHandle;
     server->revMsgThreadActive = true;
@@ -121,6 +144,9 @@ celix_status_t rsaShmServer_create(celix_bundle_context_t *ctx, const char *name
     *shmServerOut = server;
     return CELIX_SUCCESS;
 create_rev_msg_thread_err:
+    celix_arrayList_destroy(server->ringConsumers);
+    (void)celixThreadMutex_destroy(&server->ringConsumersMutex);
+create_ring_consumers_mutex_err:
     thpool_destroy(server->threadPool);
 create_thpool_err:
     shmCache_destroy(shmCache);
@@ -140,6 +166,9 @@ void rsaShmServer_destroy(rsa_shm_server_t *server) {
     server->revMsgThreadActive = false;
     shutdown(server->sfd,SHUT_RD);
     celixThread_join(server->revMsgThread, NULL);
+    rsaShmServer_stopRingConsumers(server, false);
+    celix_arrayList_destroy(server->ringConsumers);
+    (void)celixThreadMutex_destroy(&server->ringConsumersMutex);
     thpool_destroy(server->threadPool);
     shmCache_destroy(server->shmCache);
     close(server->sfd);
@@ -162,10 +191,49 @@ static void rsaShmServer_terminateMsgHandling(rsa_shm_msg_control_t *ctrl) {
     return;
 }
 
-static void rsaShmServer_msgHandlingWork(void *data) {
-    assert(data != NULL);
+static bool rsaShmServer_readMetadataUint32(const char **cur, const char *end, uint32_t *val) {
+    if ((size_t)(end - *cur) < sizeof(*val)) {
+        return false;
+    }
+    memcpy(val, *cur, sizeof(*val));
+    *cur += sizeof(*val);
+    return true;
+}
+
+static const char* rsaShmServer_readMetadataString(const char **cur, const char *end) {
+    uint32_t len = 0;
+    if (!rsaShmServer_readMetadataUint32(cur, end, &len) || (size_t)(end - *cur) <= len || (*cur)[len] != '\0') {
+        return NULL;
+    }
+    const char *str = *cur;
+    *cur += len + 1;
+    return str;
+}
+
+static celix_properties_t* rsaShmServer_decodeBinaryMetadata(const char *metadata, size_t metadataSize) {
+    const char *cur = metadata;
+    const char *end = metadata + metadataSize;
+    uint32_t nrOfEntries = 0;
+    if (!rsaShmServer_readMetadataUint32(&cur, end, &nrOfEntries)) {
+        return NULL;
+    }
+    celix_properties_t *props = celix_properties_create();
+    assert(props != NULL);
+    for (uint32_t i = 0; i < nrOfEntries; ++i) {
+        const char *key = rsaShmServer_readMetadataString(&cur, end);
+        const char *value = key == NULL ? NULL : rsaShmServer_readMetadataString(&cur, end);
+        if (value == NULL) {
+            celix_properties_destroy(props);
+            return NULL;
+        }
+        celix_properties_set(props, key, value);
+    }
+    return props;
+}
+
+static void rsaShmServer_handleMsg(struct rsa_shm_server_thpool_work_data *workData) {
+    assert(workData != NULL);
     int status =  CELIX_SUCCESS;
-    struct rsa_shm_server_thpool_work_data *workData = data;
     rsa_shm_server_t *server = workData->server;
     assert(server != NULL);
 
@@ -176,7 +244,11 @@ static void rsaShmServer_msgHandlingWork(void *data) {
 
     celix_properties_t *metadataProps = NULL;
     if (workData->metadataSize != 0) {
-        metadataProps = celix_properties_loadFromString(metaDataString);
+        if (workData->metadataFormat == RSA_SHM_METADATA_FORMAT_BINARY) {
+            metadataProps = rsaShmServer_decodeBinaryMetadata(metaDataString, workData->metadataSize);
+        } else {
+            metadataProps = celix_properties_loadFromString(metaDataString);
+        }
         if (metadataProps == NULL) {
             celix_logHelper_warning(server->loghelper, "RsaShmServer: Parse metadata failed.");
         }
@@ -237,8 +309,6 @@ static void rsaShmServer_msgHandlingWork(void *data) {
     }
     shmCache_releaseMemoryPtr(server->shmCache, msgBuffer);
     shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
-
-    free(data);
     return;
 
 reply_err:
@@ -250,10 +320,14 @@ call_receive_cb_failed:
     rsaShmServer_terminateMsgHandling(msgCtrl);
     shmCache_releaseMemoryPtr(server->shmCache, msgBuffer);
     shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
-    free(data);
     return;
 }
 
+static void rsaShmServer_msgHandlingWork(void *data) {
+    rsaShmServer_handleMsg((struct rsa_shm_server_thpool_work_data *)data);
+    free(data);
+}
+
 static bool rsaShmServer_msgInvalid(rsa_shm_server_t *server, const rsa_shm_msg_t *msgInfo) {
     assert(msgInfo != NULL);
     assert(server != NULL);
@@ -282,6 +356,154 @@ static bool rsaShmServer_msgCtrlInvalid(rsa_shm_server_t *server, const rsa_shm_
     return false;
 }
 
+static bool rsaShmServer_prepareWorkData(rsa_shm_server_t *server, const rsa_shm_msg_t *msgInfo, size_t msgInfoSize,
+        struct rsa_shm_server_thpool_work_data *workData) {
+    if (msgInfoSize <= sizeof(msgInfo->size) || rsaShmServer_msgInvalid(server, msgInfo)) {
+        celix_logHelper_error(server->loghelper,"RsaShmServer: Shm message info is invalid. It maybe cause memory leak!");
+        return false;
+    }
+    rsa_shm_msg_control_t *msgCtrl = shmCache_getMemoryPtr(server->shmCache,
+            msgInfo->shmId, msgInfo->ctrlDataOffset);
+    if (rsaShmServer_msgCtrlInvalid(server, msgCtrl)) {
+        celix_logHelper_error(server->loghelper,"RsaShmServer: Get msg ctrl cache failed. It maybe cause memory leak!");
+        return false;
+    }
+    char *msgBody = shmCache_getMemoryPtr(server->shmCache, msgInfo->shmId,
+            msgInfo->msgBodyOffset);
+    if (msgBody == NULL) {
+        celix_logHelper_error(server->loghelper,"RsaShmServer: Get msg data buffer cache failed.");
+        rsaShmServer_terminateMsgHandling(msgCtrl);
+        shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
+        return false;
+    }
+    workData->server = server;
+    workData->msgCtrl = msgCtrl;
+    workData->msgBody = msgBody;
+    workData->msgBodyTotalSize = msgInfo->msgBodyTotalSize;
+    workData->metadataSize = msgInfo->metadataSize;
+    workData->requestSize = msgInfo->requestSize;
+    //Older clients do not send the metadata format and always use the text format
+    bool hasMetadataFormat = msgInfo->size >= offsetof(rsa_shm_msg_t, metadataFormat) + sizeof(msgInfo->metadataFormat)
+            && msgInfoSize >= offsetof(rsa_shm_msg_t, metadataFormat) + sizeof(msgInfo->metadataFormat);
+    workData->metadataFormat = hasMetadataFormat ? msgInfo->metadataFormat : RSA_SHM_METADATA_FORMAT_TEXT;
+    return true;
+}
+
+/**
+ * Hands over a received request to the thread pool, so that the requests of a client - whether received as datagram
+ * or from a request ring - are handled concurrently.
+ *
+ * Note that the request ring only replaces the request datagram. A ring request still costs a work data and thpool job
+ * allocation and a thread handoff, and the reply is still signalled with the pshared condition variable of the msg ctrl.
+ */
+static void rsaShmServer_dispatchMsg(rsa_shm_server_t *server, const rsa_shm_msg_t *msgInfo, size_t msgInfoSize) {
+    struct rsa_shm_server_thpool_work_data *workData = ( struct rsa_shm_server_thpool_work_data *)malloc(sizeof(*workData));
+    assert(workData != NULL);
+    if (!rsaShmServer_prepareWorkData(server, msgInfo, msgInfoSize, workData)) {
+        free(workData);
+        return;
+    }
+    rsa_shm_msg_control_t *msgCtrl = workData->msgCtrl;
+    char *msgBody = workData->msgBody;
+    int retVal = thpool_add_work(server->threadPool, (void *)rsaShmServer_msgHandlingWork, (void*)workData);
+    if (retVal != 0) {
+        celix_logHelper_error(server->loghelper, "RsaShmServer: maybe pool thread is full, error code is %d.", retVal);
+        rsaShmServer_terminateMsgHandling(msgCtrl);
+        shmCache_releaseMemoryPtr(server->shmCache, msgBody);
+        shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
+        free(workData);
+    }
+}
+
+static void *rsaShmServer_ringConsumerThread(void *data) {
+    rsa_shm_server_ring_consumer_t *consumer = data;
+    rsa_shm_server_t *server = consumer->server;
+    rsa_shm_ring_t *ring = consumer->ring;
+    unsigned int spinLimit = RSA_SHM_RING_MIN_SPINS;
+    rsa_shm_msg_t msgInfo;
+    while (__atomic_load_n(&consumer->active, __ATOMIC_ACQUIRE)) {
+        celix_status_t status = rsaShmRing_pop(ring, &msgInfo, &spinLimit, 1000);
+        if (status == CELIX_ILLEGAL_STATE) {
+            break;//client closed the ring
+        } else if (status != CELIX_SUCCESS) {
+            if (kill(ring->clientPid, 0) != 0 && errno == ESRCH) {
+                celix_logHelper_warning(server->loghelper, "RsaShmServer: Client %d of request ring exited.", (int)ring->clientPid);
+                break;
+            }
+            continue;
+        }
+        rsaShmServer_dispatchMsg(server, &msgInfo, sizeof(msgInfo));
+    }
+    rsaShmRing_detach(ring);
+    //Requests pushed before the ring was detached will not be handled, terminate them
+    while (rsaShmRing_tryPop(ring, &msgInfo)) {
+        rsa_shm_msg_control_t *msgCtrl = shmCache_getMemoryPtr(server->shmCache, msgInfo.shmId, msgInfo.ctrlDataOffset);
+        if (!rsaShmServer_msgCtrlInvalid(server, msgCtrl)) {
+            rsaShmServer_terminateMsgHandling(msgCtrl);
+            shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
+        }
+    }
+    __atomic_store_n(&consumer->finished, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void rsaShmServer_stopRingConsumers(rsa_shm_server_t *server, bool onlyFinished) {
+    celixThreadMutex_lock(&server->ringConsumersMutex);
+    for (int i = celix_arrayList_size(server->ringConsumers) - 1; i >= 0; --i) {
+        rsa_shm_server_ring_consumer_t *consumer = celix_arrayList_get(server->ringConsumers, i);
+        if (onlyFinished && !__atomic_load_n(&consumer->finished, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+        __atomic_store_n(&consumer->active, false, __ATOMIC_RELEASE);
+        //The ring is released after joining the consumer thread, so it is still mapped here
+        rsaShmRing_detach(consumer->ring);
+        celixThread_join(consumer->thread, NULL);
+        shmCache_releaseMemoryPtr(server->shmCache, consumer->ring);
+        celix_arrayList_removeAt(server->ringConsumers, i);
+        free(consumer);
+    }
+    celixThreadMutex_unlock(&server->ringConsumersMutex);
+}
+
+static void rsaShmServer_attachRing(rsa_shm_server_t *server, const rsa_shm_msg_t *msgInfo) {
+    //Clean up the consumers of closed rings
+    rsaShmServer_stopRingConsumers(server, true);
+
+    if (msgInfo->shmId < 0 || msgInfo->ctrlDataOffset < 0 || msgInfo->ctrlDataSize < sizeof(rsa_shm_ring_t)) {
+        celix_logHelper_error(server->loghelper, "RsaShmServer: Request ring info invalid. %d, %zd, %zu.",
+                msgInfo->shmId, msgInfo->ctrlDataOffset, msgInfo->ctrlDataSize);
+        return;
+    }
+    rsa_shm_ring_t *ring = shmCache_getMemoryPtr(server->shmCache, msgInfo->shmId, msgInfo->ctrlDataOffset);
+    if (ring == NULL) {
+        celix_logHelper_error(server->loghelper, "RsaShmServer: Get request ring cache failed.");
+        return;
+    }
+    if (ring->size < sizeof(rsa_shm_ring_t) || !rsaShmRing_attach(ring)) {
+        celix_logHelper_error(server->loghelper, "RsaShmServer: Request ring is invalid or already attached.");
+        shmCache_releaseMemoryPtr(server->shmCache, ring);
+        return;
+    }
+    rsa_shm_server_ring_consumer_t *consumer = calloc(1, sizeof(*consumer));
+    assert(consumer != NULL);
+    consumer->server = server;
+    consumer->ring = ring;
+    consumer->active = true;
+    consumer->finished = false;
+    celix_status_t status = celixThread_create(&consumer->thread, NULL, rsaShmServer_ringConsumerThread, consumer);
+    if (status != CELIX_SUCCESS) {
+        celix_logHelper_error(server->loghelper, "RsaShmServer: create request ring consumer thread err.");
+        rsaShmRing_detach(ring);
+        shmCache_releaseMemoryPtr(server->shmCache, ring);
+        free(consumer);
+        return;
+    }
+    celixThread_setName(&consumer->thread, "rsaShmRingConsumer");
+    celixThreadMutex_lock(&server->ringConsumersMutex);
+    celix_arrayList_add(server->ringConsumers, consumer);
+    celixThreadMutex_unlock(&server->ringConsumersMutex);
+}
+
 static void *rsaShmServer_receiveMsgThread(void *data) {
     rsa_shm_server_t *server = data;
     assert(server != NULL);
@@ -294,40 +516,13 @@ static void *rsaShmServer_receiveMsgThread(void *data) {
             celix_logHelper_error(server->loghelper, "RsaShmServer: recv msg err(%d) or recv zero-length datagrams.", errno);
             continue;
         }
-        if (revBytes <= sizeof(msgInfo.size) || rsaShmServer_msgInvalid(server, &msgInfo)) {
-            celix_logHelper_error(server->loghelper,"RsaShmServer: Shm message info is invalid. It maybe cause memory leak!");
-            continue;
-        }
-        rsa_shm_msg_control_t *msgCtrl = shmCache_getMemoryPtr(server->shmCache,
-                msgInfo.shmId, msgInfo.ctrlDataOffset);
-        if (rsaShmServer_msgCtrlInvalid(server, msgCtrl)) {
-            celix_logHelper_error(server->loghelper,"RsaShmServer: Get msg ctrl cache failed. It maybe cause memory leak!");
-            continue;
-        }
-        char *msgBody = shmCache_getMemoryPtr(server->shmCache, msgInfo.shmId,
-                msgInfo.msgBodyOffset);
-        if (msgBody == NULL) {
-            celix_logHelper_error(server->loghelper,"RsaShmServer: Get msg data buffer cache failed.");
-            rsaShmServer_terminateMsgHandling(msgCtrl);
-            shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
-            continue;
-        }
-        struct rsa_shm_server_thpool_work_data *workData = ( struct rsa_shm_server_thpool_work_data *)malloc(sizeof(*workData));
-        assert(workData != NULL);
-        workData->server = server;
-        workData->msgCtrl = msgCtrl;
-        workData->msgBody = msgBody;
-        workData->msgBodyTotalSize = msgInfo.msgBodyTotalSize;
-        workData->metadataSize = msgInfo.metadataSize;
-        workData->requestSize = msgInfo.requestSize;
-        int retVal = thpool_add_work(server->threadPool, (void *)rsaShmServer_msgHandlingWork, (void*)workData);
-        if (retVal != 0) {
-            celix_logHelper_error(server->loghelper, "RsaShmServer: maybe pool thread is full, error code is %d.", retVal);
-            rsaShmServer_terminateMsgHandling(msgCtrl);
-            shmCache_releaseMemoryPtr(server->shmCache, msgBody);
-            shmCache_releaseMemoryPtr(server->shmCache, msgCtrl);
+        if (revBytes >= offsetof(rsa_shm_msg_t, msgType) + sizeof(msgInfo.msgType)
+                && msgInfo.size >= offsetof(rsa_shm_msg_t, msgType) + sizeof(msgInfo.msgType)
+                && msgInfo.msgType == RSA_SHM_MSG_TYPE_RING_ATTACH) {
+            rsaShmServer_attachRing(server, &msgInfo);
             continue;
         }
+        rsaShmServer_dispatchMsg(server, &msgInfo, revBytes);
     }
 
     return NULL;
@@ -0,0 +1,227 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "thpool.h"
+
+extern "C" {
+/* the original thread pool, compiled with prefixed symbols (see CMakeLists.txt) */
+struct thpool_legacy_;
+struct thpool_legacy_* thpool_legacy_init(int num_threads);
+int thpool_legacy_add_work(struct thpool_legacy_* pool, void (*function_p)(void*), void* arg_p);
+void thpool_legacy_wait(struct thpool_legacy_* pool);
+void thpool_legacy_destroy(struct thpool_legacy_* pool);
+}
+
+/**
+ * Measures the jobs per second of the work stealing thread pool against the original (single job queue) thread pool.
+ * The jobs are small, so that the cost of adding and dispatching a job dominates.
+ */
+namespace {
+    constexpr int JOB_WORK = 64;
+    constexpr int JOBS_PER_ITERATION = 4096;
+
+    void job(void* arg) {
+        auto* counter = static_cast<std::atomic<long>*>(arg);
+        long value = 0;
+        for (int i = 0; i < JOB_WORK; ++i) {
+            benchmark::DoNotOptimize(value += i);
+        }
+        counter->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<bool Legacy>
+    class ThreadPool {
+    public:
+        explicit ThreadPool(int nrOfThreads) {
+            if (Legacy) {
+                legacyPool = thpool_legacy_init(nrOfThreads);
+            } else {
+                pool = thpool_init(nrOfThreads);
+            }
+            if (legacyPool == nullptr && pool == nullptr) {
+                std::cerr << "Error creating thread pool" << std::endl;
+                abort();
+            }
+        }
+
+        ~ThreadPool() {
+            if (Legacy) {
+                thpool_legacy_destroy(legacyPool);
+            } else {
+                thpool_destroy(pool);
+            }
+        }
+
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void addWork(void (*function)(void*), void* arg) {
+            int rc = Legacy ? thpool_legacy_add_work(legacyPool, function, arg) : thpool_add_work(pool, function, arg);
+            if (rc != 0) {
+                abort();
+            }
+        }
+
+        void wait() {
+            if (Legacy) {
+                thpool_legacy_wait(legacyPool);
+            } else {
+                thpool_wait(pool);
+            }
+        }
+
+    private:
+        threadpool pool{nullptr};
+        struct thpool_legacy_* legacyPool{nullptr};
+    };
+
+    int nrOfThreads(benchmark::State& state) {
+        return state.range(0) > 0 ? static_cast<int>(state.range(0)) : static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    /**
+     * A single thread adds all jobs, like the shm RSA server receive thread.
+     */
+    template<bool Legacy>
+    void addWork(benchmark::State& state) {
+        ThreadPool<Legacy> pool{nrOfThreads(state)};
+        std::atomic<long> counter{0};
+        for (auto _ : state) {
+            // This code gets timed
+            for (int i = 0; i < JOBS_PER_ITERATION; ++i) {
+                pool.addWork(job, &counter);
+            }
+            pool.wait();
+        }
+        if (counter.load() != state.iterations() * JOBS_PER_ITERATION) {
+            state.SkipWithError("Not all jobs executed");
+        }
+        state.counters["jobs"] = benchmark::Counter(static_cast<double>(counter.load()), benchmark::Counter::kIsRate);
+    }
+
+    /**
+     * Multiple threads add jobs concurrently.
+     */
+    template<bool Legacy>
+    void addWorkFromMultipleThreads(benchmark::State& state) {
+        constexpr int NR_OF_PRODUCERS = 4;
+        ThreadPool<Legacy> pool{nrOfThreads(state)};
+        std::atomic<long> counter{0};
+        for (auto _ : state) {
+            // This code gets timed
+            std::vector<std::thread> producers;
+            for (int p = 0; p < NR_OF_PRODUCERS; ++p) {
+                producers.emplace_back([&pool, &counter] {
+                    for (int i = 0; i < JOBS_PER_ITERATION / NR_OF_PRODUCERS; ++i) {
+                        pool.addWork(job, &counter);
+                    }
+                });
+            }
+            for (auto& producer : producers) {
+                producer.join();
+            }
+            pool.wait();
+        }
+        if (counter.load() != state.iterations() * JOBS_PER_ITERATION) {
+            state.SkipWithError("Not all jobs executed");
+        }
+        state.counters["jobs"] = benchmark::Counter(static_cast<double>(counter.load()), benchmark::Counter::kIsRate);
+    }
+
+    template<bool Legacy>
+    struct NestedWork {
+        static constexpr int NR_OF_PARENTS = 64;
+
+        ThreadPool<Legacy>* pool;
+        std::atomic<long>* counter;
+
+        static void parentJob(void* arg) {
+            auto* work = static_cast<NestedWork*>(arg);
+            for (int i = 0; i < JOBS_PER_ITERATION / NR_OF_PARENTS - 1; ++i) {
+                work->pool->addWork(job, work->counter);
+            }
+            job(work->counter);
+        }
+    };
+
+    /**
+     * Jobs add follow-up jobs from the pool threads.
+     */
+    template<bool Legacy>
+    void addNestedWork(benchmark::State& state) {
+        ThreadPool<Legacy> pool{nrOfThreads(state)};
+        std::atomic<long> counter{0};
+        NestedWork<Legacy> work{&pool, &counter};
+        for (auto _ : state) {
+            // This code gets timed
+            for (int i = 0; i < NestedWork<Legacy>::NR_OF_PARENTS; ++i) {
+                pool.addWork(NestedWork<Legacy>::parentJob, &work);
+            }
+            pool.wait();
+        }
+        if (counter.load() != state.iterations() * JOBS_PER_ITERATION) {
+            state.SkipWithError("Not all jobs executed");
+        }
+        state.counters["jobs"] = benchmark::Counter(static_cast<double>(counter.load()), benchmark::Counter::kIsRate);
+    }
+}
+
+static void ThpoolBenchmark_addWork(benchmark::State& state) {
+    addWork<false>(state);
+}
+
+static void ThpoolBenchmark_addWorkLegacy(benchmark::State& state) {
+    addWork<true>(state);
+}
+
+static void ThpoolBenchmark_addWorkFromMultipleThreads(benchmark::State& state) {
+    addWorkFromMultipleThreads<false>(state);
+}
+
+static void ThpoolBenchmark_addWorkFromMultipleThreadsLegacy(benchmark::State& state) {
+    addWorkFromMultipleThreads<true>(state);
+}
+
+static void ThpoolBenchmark_addNestedWork(benchmark::State& state) {
+    addNestedWork<false>(state);
+}
+
+static void ThpoolBenchmark_addNestedWorkLegacy(benchmark::State& state) {
+    addNestedWork<true>(state);
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+//note argument is the number of pool threads, 0 is the number of cpus
+CELIX_BENCHMARK(ThpoolBenchmark_addWork)->Arg(1)->Arg(4)->Arg(0);
+CELIX_BENCHMARK(ThpoolBenchmark_addWorkLegacy)->Arg(1)->Arg(4)->Arg(0); //reference
+CELIX_BENCHMARK(ThpoolBenchmark_addWorkFromMultipleThreads)->Arg(4)->Arg(0);
+CELIX_BENCHMARK(ThpoolBenchmark_addWorkFromMultipleThreadsLegacy)->Arg(4)->Arg(0); //reference
+CELIX_BENCHMARK(ThpoolBenchmark_addNestedWork)->Arg(4)->Arg(0);
+CELIX_BENCHMARK(ThpoolBenchmark_addNestedWorkLegacy)->Arg(4)->Arg(0); //reference
@@ -37,6 +37,34 @@ typedef struct thpool_* threadpool;
 threadpool thpool_init(int num_threads);
 
 
+/**
+ * @brief Options for thpool_init_with_options
+ * Fields which are 0 result in the defaults. The queue_size and cpu_affinity
+ * options are only used by the work stealing implementation (thpool_ws.c).
+ */
+typedef struct thpool_options {
+	int num_threads;       /* number of threads to be created in the threadpool    */
+	int queue_size;        /* per thread job queue size, rounded to a power of two */
+	int cpu_affinity;      /* if not 0, thread n is pinned to cpu n % nr of cpus   */
+} thpool_options;
+
+
+/**
+ * @brief  Initialize threadpool with options
+ * Same as thpool_init, but also configures the job queue size and cpu
+ * affinity of the threads.
+ * @example
+ *    ..
+ *    thpool_options options = {8, 0, 1};    //8 pinned threads, default queue size
+ *    threadpool thpool = thpool_init_with_options(&options);
+ *    ..
+ * @param  options       the threadpool options
+ * @return threadpool    created threadpool on success,
+ *                       NULL on error
+ */
+threadpool thpool_init_with_options(const thpool_options* options);
+
+
 /**
  * @brief Add work to the job queue
  *
@@ -178,6 +178,12 @@ struct thpool_* thpool_init(int num_threads){
 }
 
 
+/* Initialise thread pool with options, the queue size and cpu affinity are not supported */
+struct thpool_* thpool_init_with_options(const thpool_options* options){
+	return thpool_init(options->num_threads);
+}
+
+
 /* Add work to the thread pool */
 int thpool_add_work(thpool_* thpool_p, void (*function_p)(void*), void* arg_p){
 	job* newjob;
@@ -0,0 +1,679 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Work stealing implementation of the thpool API.
+ *
+ * Every worker owns two lock-free job queues:
+ *  - a Chase-Lev deque for jobs added by the worker itself (e.g. a job adding follow-up work). The owner pushes and
+ *    takes at the bottom (LIFO, cache friendly), other workers steal from the top.
+ *  - a bounded multi-producer/multi-consumer inbox for jobs added by other threads. Adding threads spread their jobs
+ *    over the worker inboxes, so there is no single lock or queue head all threads contend on.
+ * An idle worker first checks its own deque and inbox and then steals from the other workers. Only when no job is
+ * found anywhere the worker sleeps on the pool condition.
+ *
+ * Inbox jobs are stored by value in the inbox cells and deque jobs in job nodes pooled per worker, so adding work
+ * does not allocate. Only when all queues are full, jobs are added to a mutex protected overflow list.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* pthread_setaffinity_np */
+#endif
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+#include "thpool.h"
+
+#define THPOOL_DEFAULT_QUEUE_SIZE   1024
+#define THPOOL_STEAL_ROUNDS         2
+#define THPOOL_CACHE_LINE_SIZE      64
+
+#if !defined(DISABLE_PRINT) || defined(THPOOL_DEBUG)
+#define err(str) fprintf(stderr, str)
+#else
+#define err(str)
+#endif
+
+typedef void (*thpool_job_function)(void* arg);
+
+/* Job node, pooled per worker and used for the jobs in the worker deque */
+typedef struct thpool_job_node {
+    thpool_job_function function;
+    void* arg;
+    struct thpool_job_node* next;           /* next free node */
+    struct thpool_worker* owner;            /* worker owning the node pool */
+} thpool_job_node;
+
+/* Chase-Lev work stealing deque, only the owner pushes and takes */
+typedef struct thpool_deque {
+    int64_t top __attribute__((aligned(THPOOL_CACHE_LINE_SIZE)));
+    int64_t bottom __attribute__((aligned(THPOOL_CACHE_LINE_SIZE)));
+    thpool_job_node** buffer;
+    int64_t mask;
+} thpool_deque;
+
+/* Cell of the bounded MPMC inbox (D. Vyukov), the sequence number guards the job data */
+typedef struct thpool_inbox_cell {
+    size_t sequence;
+    thpool_job_function function;
+    void* arg;
+} thpool_inbox_cell;
+
+typedef struct thpool_inbox {
+    size_t enqueuePos __attribute__((aligned(THPOOL_CACHE_LINE_SIZE)));
+    size_t dequeuePos __attribute__((aligned(THPOOL_CACHE_LINE_SIZE)));
+    thpool_inbox_cell* cells;
+    size_t mask;
+} thpool_inbox;
+
+/* Job in the overflow list */
+typedef struct thpool_overflow_job {
+    thpool_job_function function;
+    void* arg;
+    struct thpool_overflow_job* next;
+} thpool_overflow_job;
+
+typedef struct thpool_worker {
+    thpool_deque deque;
+    thpool_inbox inbox;
+    thpool_job_node* nodes;                 /* node pool storage */
+    thpool_job_node* freeNodes;             /* free nodes, only used by the worker itself */
+    thpool_job_node* returnedNodes __attribute__((aligned(THPOOL_CACHE_LINE_SIZE))); /* nodes freed by thieves */
+    struct thpool_* pool;
+    int id;
+    uint32_t random;                        /* xorshift state for the victim selection */
+    pthread_t thread;
+    int started;
+} thpool_worker;
+
+typedef struct thpool_ {
+    thpool_worker* workers;
+    int nrOfWorkers;
+    int cpuAffinity;
+
+    int64_t queued __attribute__((aligned(THPOOL_CACHE_LINE_SIZE)));      /* jobs added and not yet taken */
+    int64_t outstanding __attribute__((aligned(THPOOL_CACHE_LINE_SIZE))); /* jobs added and not yet finished */
+    int sleepers __attribute__((aligned(THPOOL_CACHE_LINE_SIZE)));        /* workers (about to) wait on hasJobs */
+    int keepalive;
+    int paused;
+
+    pthread_mutex_t mutex;                  /* protects the sleep/pause conditions */
+    pthread_cond_t hasJobs;
+    pthread_cond_t resumed;
+    pthread_mutex_t idleMutex;
+    pthread_cond_t idle;                    /* signalled when outstanding drops to 0 */
+
+    pthread_mutex_t overflowMutex;
+    thpool_overflow_job* overflowFront;
+    thpool_overflow_job* overflowRear;
+    int64_t overflowLen;
+} thpool_;
+
+static __thread thpool_worker* currentWorker = NULL;
+static __thread unsigned int submitIndex = 0;
+
+static int  deque_init(thpool_deque* deque, size_t size);
+static int  deque_push(thpool_deque* deque, thpool_job_node* node);
+static thpool_job_node* deque_take(thpool_deque* deque);
+static thpool_job_node* deque_steal(thpool_deque* deque);
+
+static int  inbox_init(thpool_inbox* inbox, size_t size);
+static int  inbox_push(thpool_inbox* inbox, thpool_job_function function, void* arg);
+static int  inbox_pop(thpool_inbox* inbox, thpool_job_function* function, void** arg);
+
+static thpool_job_node* worker_allocNode(thpool_worker* worker);
+static void worker_freeNode(thpool_job_node* node);
+static int  worker_findJob(thpool_worker* worker, thpool_job_function* function, void** arg);
+static void* worker_run(void* data);
+
+static int  overflow_push(thpool_* pool, thpool_job_function function, void* arg);
+static int  overflow_pop(thpool_* pool, thpool_job_function* function, void** arg);
+
+static size_t thpool_roundUpToPowerOfTwo(size_t size) {
+    size_t result = 2;
+    while (result < size) {
+        result <<= 1;
+    }
+    return result;
+}
+
+
+/* ========================== THREADPOOL ============================ */
+
+
+struct thpool_* thpool_init(int num_threads) {
+    thpool_options options;
+    memset(&options, 0, sizeof(options));
+    options.num_threads = num_threads;
+    return thpool_init_with_options(&options);
+}
+
+struct thpool_* thpool_init_with_options(const thpool_options* options) {
+    int nrOfWorkers = options->num_threads < 0 ? 0 : options->num_threads;
+    size_t queueSize = thpool_roundUpToPowerOfTwo(options->queue_size > 0 ? (size_t)options->queue_size : THPOOL_DEFAULT_QUEUE_SIZE);
+
+    thpool_* pool = NULL;
+    if (posix_memalign((void**)&pool, THPOOL_CACHE_LINE_SIZE, sizeof(*pool)) != 0) {
+        err("thpool_init(): Could not allocate memory for thread pool\n");
+        return NULL;
+    }
+    memset(pool, 0, sizeof(*pool));
+    pool->nrOfWorkers = nrOfWorkers;
+    pool->cpuAffinity = options->cpu_affinity;
+    pool->keepalive = 1;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->hasJobs, NULL);
+    pthread_cond_init(&pool->resumed, NULL);
+    pthread_mutex_init(&pool->idleMutex, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    pthread_mutex_init(&pool->overflowMutex, NULL);
+
+    int status = 0;
+    if (nrOfWorkers > 0 && posix_memalign((void**)&pool->workers, THPOOL_CACHE_LINE_SIZE, nrOfWorkers * sizeof(thpool_worker)) != 0) {
+        pool->workers = NULL;
+        status = -1;
+    } else if (nrOfWorkers > 0) {
+        memset(pool->workers, 0, nrOfWorkers * sizeof(thpool_worker));
+    }
+    for (int i = 0; i < nrOfWorkers && status == 0; ++i) {
+        thpool_worker* worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->id = i;
+        worker->random = 2654435761U * (uint32_t)(i + 1);
+        status = deque_init(&worker->deque, queueSize);
+        if (status == 0) {
+            status = inbox_init(&worker->inbox, queueSize);
+        }
+        if (status == 0) {
+            worker->nodes = calloc(queueSize, sizeof(thpool_job_node));
+            status = worker->nodes != NULL ? 0 : -1;
+        }
+        for (size_t n = 0; status == 0 && n < queueSize; ++n) {
+            worker->nodes[n].owner = worker;
+            worker->nodes[n].next = worker->freeNodes;
+            worker->freeNodes = &worker->nodes[n];
+        }
+    }
+    if (status != 0) {
+        err("thpool_init(): Could not allocate memory for the worker queues\n");
+        thpool_destroy(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < nrOfWorkers; ++i) {
+        thpool_worker* worker = &pool->workers[i];
+        if (pthread_create(&worker->thread, NULL, worker_run, worker) != 0) {
+            err("thpool_init(): Could not create thread\n");
+            thpool_destroy(pool);
+            return NULL;
+        }
+        worker->started = 1;
+    }
+    return pool;
+}
+
+int thpool_add_work(thpool_* pool, void (*function_p)(void*), void* arg_p) {
+    __atomic_fetch_add(&pool->outstanding, 1, __ATOMIC_RELAXED);
+
+    int added = -1;
+    thpool_worker* self = currentWorker;
+    if (self != NULL && self->pool == pool) {
+        /* work added by a job, keep it local */
+        thpool_job_node* node = worker_allocNode(self);
+        if (node != NULL) {
+            node->function = function_p;
+            node->arg = arg_p;
+            added = deque_push(&self->deque, node);
+            if (added != 0) {
+                worker_freeNode(node);
+            }
+        }
+        if (added != 0) {
+            added = inbox_push(&self->inbox, function_p, arg_p);
+        }
+    }
+    for (int i = 0; added != 0 && i < pool->nrOfWorkers; ++i) {
+        unsigned int index = submitIndex++ % (unsigned int)pool->nrOfWorkers;
+        added = inbox_push(&pool->workers[index].inbox, function_p, arg_p);
+    }
+    if (added != 0) {
+        added = overflow_push(pool, function_p, arg_p);
+    }
+    if (added != 0) {
+        __atomic_fetch_sub(&pool->outstanding, 1, __ATOMIC_RELAXED);
+        err("thpool_add_work(): Could not allocate memory for new job\n");
+        return -1;
+    }
+
+    /*
+     * Note queued and sleepers form a Dekker pair with the sleeping worker (see worker_run): either this thread
+     * sees the sleeper, or the sleeper sees the queued job.
+     */
+    __atomic_fetch_add(&pool->queued, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&pool->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_signal(&pool->hasJobs);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return 0;
+}
+
+void thpool_wait(thpool_* pool) {
+    pthread_mutex_lock(&pool->idleMutex);
+    while (__atomic_load_n(&pool->outstanding, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_wait(&pool->idle, &pool->idleMutex);
+    }
+    pthread_mutex_unlock(&pool->idleMutex);
+}
+
+void thpool_destroy(thpool_* pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_store_n(&pool->keepalive, 0, __ATOMIC_SEQ_CST);
+    pthread_cond_broadcast(&pool->hasJobs);
+    pthread_cond_broadcast(&pool->resumed);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; pool->workers != NULL && i < pool->nrOfWorkers; ++i) {
+        if (pool->workers[i].started) {
+            pthread_join(pool->workers[i].thread, NULL);
+        }
+    }
+
+    /* like the original thread pool, jobs which are still queued are dropped */
+    thpool_job_function function;
+    void* arg;
+    while (overflow_pop(pool, &function, &arg) == 0) {
+        /* nop */
+    }
+    for (int i = 0; pool->workers != NULL && i < pool->nrOfWorkers; ++i) {
+        thpool_worker* worker = &pool->workers[i];
+        free(worker->deque.buffer);
+        free(worker->inbox.cells);
+        free(worker->nodes);
+    }
+    free(pool->workers);
+
+    pthread_mutex_destroy(&pool->overflowMutex);
+    pthread_cond_destroy(&pool->idle);
+    pthread_mutex_destroy(&pool->idleMutex);
+    pthread_cond_destroy(&pool->resumed);
+    pthread_cond_destroy(&pool->hasJobs);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+void thpool_pause(thpool_* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_store_n(&pool->paused, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+void thpool_resume(thpool_* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_store_n(&pool->paused, 0, __ATOMIC_SEQ_CST);
+    pthread_cond_broadcast(&pool->resumed);
+    pthread_cond_broadcast(&pool->hasJobs);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+int thpool_num_threads_working(thpool_* pool) {
+    int64_t outstanding = __atomic_load_n(&pool->outstanding, __ATOMIC_RELAXED);
+    int64_t queued = __atomic_load_n(&pool->queued, __ATOMIC_RELAXED);
+    int64_t working = outstanding - queued;
+    if (working < 0) {
+        working = 0;
+    } else if (working > pool->nrOfWorkers) {
+        working = pool->nrOfWorkers;
+    }
+    return (int)working;
+}
+
+
+/* ============================ WORKER ============================== */
+
+
+static void worker_setup(thpool_worker* worker) {
+    char threadName[32];
+    snprintf(threadName, sizeof(threadName), "thread-pool-%d", worker->id);
+#if defined(__linux__)
+    prctl(PR_SET_NAME, threadName);
+#elif defined(__APPLE__) && defined(__MACH__)
+    pthread_setname_np(threadName);
+#endif
+
+#if defined(__linux__)
+    if (worker->pool->cpuAffinity) {
+        long nrOfCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (nrOfCpus > 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(worker->id % nrOfCpus, &cpus);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+                err("worker_setup(): Could not set the cpu affinity\n");
+            }
+        }
+    }
+#endif
+    currentWorker = worker;
+}
+
+/* Waits until the pool is resumed, returns 0 if the pool is destroyed */
+static int worker_waitWhilePaused(thpool_* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    while (__atomic_load_n(&pool->paused, __ATOMIC_RELAXED) && __atomic_load_n(&pool->keepalive, __ATOMIC_RELAXED)) {
+        pthread_cond_wait(&pool->resumed, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return __atomic_load_n(&pool->keepalive, __ATOMIC_RELAXED);
+}
+
+/* Sleeps until jobs are queued, returns 0 if the pool is destroyed */
+static int worker_sleep(thpool_* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    __atomic_fetch_add(&pool->sleepers, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&pool->queued, __ATOMIC_SEQ_CST) <= 0 && __atomic_load_n(&pool->keepalive, __ATOMIC_RELAXED) &&
+           !__atomic_load_n(&pool->paused, __ATOMIC_RELAXED)) {
+        pthread_cond_wait(&pool->hasJobs, &pool->mutex);
+    }
+    __atomic_fetch_sub(&pool->sleepers, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&pool->mutex);
+    return __atomic_load_n(&pool->keepalive, __ATOMIC_RELAXED);
+}
+
+static void* worker_run(void* data) {
+    thpool_worker* worker = data;
+    thpool_* pool = worker->pool;
+    worker_setup(worker);
+
+    while (__atomic_load_n(&pool->keepalive, __ATOMIC_RELAXED)) {
+        if (__atomic_load_n(&pool->paused, __ATOMIC_RELAXED) && !worker_waitWhilePaused(pool)) {
+            break;
+        }
+
+        thpool_job_function function;
+        void* arg;
+        if (worker_findJob(worker, &function, &arg) != 0) {
+            if (!worker_sleep(pool)) {
+                break;
+            }
+            continue;
+        }
+
+        __atomic_fetch_sub(&pool->queued, 1, __ATOMIC_RELAXED);
+        function(arg);
+        if (__atomic_sub_fetch(&pool->outstanding, 1, __ATOMIC_ACQ_REL) == 0) {
+            pthread_mutex_lock(&pool->idleMutex);
+            pthread_cond_broadcast(&pool->idle);
+            pthread_mutex_unlock(&pool->idleMutex);
+        }
+    }
+    currentWorker = NULL;
+    return NULL;
+}
+
+static uint32_t worker_random(thpool_worker* worker) {
+    uint32_t x = worker->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->random = x;
+    return x;
+}
+
+static int worker_takeNode(thpool_job_node* node, thpool_job_function* function, void** arg) {
+    *function = node->function;
+    *arg = node->arg;
+    worker_freeNode(node);
+    return 0;
+}
+
+/* Finds a job in the own queues, the overflow list or by stealing from a random other worker */
+static int worker_findJob(thpool_worker* worker, thpool_job_function* function, void** arg) {
+    thpool_* pool = worker->pool;
+    thpool_job_node* node = deque_take(&worker->deque);
+    if (node != NULL) {
+        return worker_takeNode(node, function, arg);
+    }
+    if (inbox_pop(&worker->inbox, function, arg) == 0) {
+        return 0;
+    }
+    if (__atomic_load_n(&pool->overflowLen, __ATOMIC_RELAXED) > 0 && overflow_pop(pool, function, arg) == 0) {
+        return 0;
+    }
+
+    int nrOfVictims = pool->nrOfWorkers - 1;
+    for (int round = 0; nrOfVictims > 0 && round < THPOOL_STEAL_ROUNDS; ++round) {
+        int start = (int)(worker_random(worker) % (uint32_t)nrOfVictims);
+        for (int i = 0; i < nrOfVictims; ++i) {
+            thpool_worker* victim = &pool->workers[(worker->id + 1 + (start + i) % nrOfVictims) % pool->nrOfWorkers];
+            node = deque_steal(&victim->deque);
+            if (node != NULL) {
+                return worker_takeNode(node, function, arg);
+            }
+            if (inbox_pop(&victim->inbox, function, arg) == 0) {
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+static thpool_job_node* worker_allocNode(thpool_worker* worker) {
+    if (worker->freeNodes == NULL) {
+        /* take all nodes freed by the other workers */
+        worker->freeNodes = __atomic_exchange_n(&worker->returnedNodes, NULL, __ATOMIC_ACQUIRE);
+    }
+    thpool_job_node* node = worker->freeNodes;
+    if (node != NULL) {
+        worker->freeNodes = node->next;
+    }
+    return node;
+}
+
+static void worker_freeNode(thpool_job_node* node) {
+    thpool_worker* owner = node->owner;
+    if (owner == currentWorker) {
+        node->next = owner->freeNodes;
+        owner->freeNodes = node;
+    } else {
+        /* note only pushed by others and taken all at once by the owner, so no ABA problem */
+        thpool_job_node* head = __atomic_load_n(&owner->returnedNodes, __ATOMIC_RELAXED);
+        do {
+            node->next = head;
+        } while (!__atomic_compare_exchange_n(&owner->returnedNodes, &head, node, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+}
+
+
+/* ============================ DEQUE =============================== */
+
+
+static int deque_init(thpool_deque* deque, size_t size) {
+    deque->top = 0;
+    deque->bottom = 0;
+    deque->mask = (int64_t)size - 1;
+    deque->buffer = calloc(size, sizeof(thpool_job_node*));
+    return deque->buffer != NULL ? 0 : -1;
+}
+
+static int deque_push(thpool_deque* deque, thpool_job_node* node) {
+    int64_t b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    if (b - t > deque->mask) {
+        return -1; /* full */
+    }
+    __atomic_store_n(&deque->buffer[b & deque->mask], node, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static thpool_job_node* deque_take(thpool_deque* deque) {
+    int64_t b = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t t = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+    thpool_job_node* node = NULL;
+    if (t <= b) {
+        node = __atomic_load_n(&deque->buffer[b & deque->mask], __ATOMIC_RELAXED);
+        if (t == b) {
+            /* last job, race against the thieves */
+            if (!__atomic_compare_exchange_n(&deque->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                node = NULL;
+            }
+            __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+        }
+    } else {
+        __atomic_store_n(&deque->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return node;
+}
+
+static thpool_job_node* deque_steal(thpool_deque* deque) {
+    int64_t t = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int64_t b = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (t < b) {
+        thpool_job_node* node = __atomic_load_n(&deque->buffer[t & deque->mask], __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&deque->top, &t, t + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            return node;
+        }
+    }
+    return NULL; /* empty or lost the race, the caller retries elsewhere */
+}
+
+
+/* ============================ INBOX =============================== */
+
+
+static int inbox_init(thpool_inbox* inbox, size_t size) {
+    inbox->enqueuePos = 0;
+    inbox->dequeuePos = 0;
+    inbox->mask = size - 1;
+    inbox->cells = calloc(size, sizeof(thpool_inbox_cell));
+    if (inbox->cells == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        inbox->cells[i].sequence = i;
+    }
+    return 0;
+}
+
+static int inbox_push(thpool_inbox* inbox, thpool_job_function function, void* arg) {
+    thpool_inbox_cell* cell;
+    size_t pos = __atomic_load_n(&inbox->enqueuePos, __ATOMIC_RELAXED);
+    while (1) {
+        cell = &inbox->cells[pos & inbox->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&inbox->enqueuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1; /* full */
+        } else {
+            pos = __atomic_load_n(&inbox->enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+    cell->function = function;
+    cell->arg = arg;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static int inbox_pop(thpool_inbox* inbox, thpool_job_function* function, void** arg) {
+    thpool_inbox_cell* cell;
+    size_t pos = __atomic_load_n(&inbox->dequeuePos, __ATOMIC_RELAXED);
+    while (1) {
+        cell = &inbox->cells[pos & inbox->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&inbox->dequeuePos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1; /* empty */
+        } else {
+            pos = __atomic_load_n(&inbox->dequeuePos, __ATOMIC_RELAXED);
+        }
+    }
+    *function = cell->function;
+    *arg = cell->arg;
+    __atomic_store_n(&cell->sequence, pos + inbox->mask + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+
+/* ============================ OVERFLOW ============================ */
+
+
+static int overflow_push(thpool_* pool, thpool_job_function function, void* arg) {
+    thpool_overflow_job* job = malloc(sizeof(*job));
+    if (job == NULL) {
+        return -1;
+    }
+    job->function = function;
+    job->arg = arg;
+    job->next = NULL;
+    pthread_mutex_lock(&pool->overflowMutex);
+    if (pool->overflowRear != NULL) {
+        pool->overflowRear->next = job;
+    } else {
+        pool->overflowFront = job;
+    }
+    pool->overflowRear = job;
+    __atomic_fetch_add(&pool->overflowLen, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&pool->overflowMutex);
+    return 0;
+}
+
+static int overflow_pop(thpool_* pool, thpool_job_function* function, void** arg) {
+    pthread_mutex_lock(&pool->overflowMutex);
+    thpool_overflow_job* job = pool->overflowFront;
+    if (job != NULL) {
+        pool->overflowFront = job->next;
+        if (pool->overflowFront == NULL) {
+            pool->overflowRear = NULL;
+        }
+        __atomic_fetch_sub(&pool->overflowLen, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&pool->overflowMutex);
+    if (job == NULL) {
+        return -1;
+    }
+    *function = job->function;
+    *arg = job->arg;
+    free(job);
+    return 0;
+}
@@ -102,6 +102,7 @@ TEST_F(ShellTestSuite, testAllCommandsAreCallable) {
     callCommand(ctx, "start 15", false);
     callCommand(ctx, "uninstall 15", false);
     callCommand(ctx, "update 15", false);
+    callCommand(ctx, "trace", false); //note framework trace not enabled
 }
 
 TEST_F(ShellTestSuite, quitTest) {
@@ -133,6 +133,14 @@ celix_std_commands_t* celix_stdCommands_create(celix_bundle_context_t* ctx) {
                     .usage = "quit"
             };
     commands->std_commands[11] =
+            (struct celix_shell_command_register_entry) {
+                    .exec = traceCommand_execute,
+                    .name = "celix::trace",
+                    .description = "Write the framework trace as Chrome trace event JSON to the provided file or, if no file is " \
+                            "provided, to stdout.\nRequires the CELIX_FRAMEWORK_TRACE framework property.",
+                    .usage = "trace [<file>]"
+            };
+    commands->std_commands[12] =
             (struct celix_shell_command_register_entry) {
                     .exec = NULL
             };
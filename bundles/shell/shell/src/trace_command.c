@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "celix_api.h"
+#include "std_commands.h"
+
+bool traceCommand_execute(void *handle, const char *const_command, FILE *outStream, FILE *errStream) {
+    celix_bundle_context_t *ctx = handle;
+    celix_framework_t* fw = celix_bundleContext_getFramework(ctx);
+
+    char *save_ptr = NULL;
+    char *command = celix_utils_strdup(const_command);
+
+    strtok_r(command, OSGI_SHELL_COMMAND_SEPARATOR, &save_ptr);
+    char *path = strtok_r(NULL, OSGI_SHELL_COMMAND_SEPARATOR, &save_ptr);
+
+    bool written = false;
+    if (path == NULL) {
+        written = celix_framework_writeTrace(fw, outStream);
+    } else {
+        FILE* file = fopen(path, "w");
+        if (file == NULL) {
+            fprintf(errStream, "Cannot open file '%s'.\n", path);
+            free(command);
+            return false;
+        }
+        written = celix_framework_writeTrace(fw, file);
+        fclose(file);
+        if (written) {
+            fprintf(outStream, "Trace written to '%s'.\n", path);
+        }
+    }
+    if (!written) {
+        fprintf(errStream, "Framework trace is not enabled. Use the %s framework property to enable tracing.\n", CELIX_FRAMEWORK_TRACE);
+    }
+
+    free(command);
+    return written;
+}
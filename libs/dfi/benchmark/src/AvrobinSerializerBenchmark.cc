@@ -0,0 +1,223 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "avrobin_serializer.h"
+#include "dyn_type.h"
+
+/**
+ * Measures the avrobin (de)serialization of message types typically used with pubsub:
+ * a small struct with doubles, ints and strings and sequences of doubles and ints.
+ */
+namespace {
+    struct poi {
+        double lat;
+        double lon;
+        double alt;
+        int32_t id;
+        int32_t category;
+        char* name;
+        char* description;
+    };
+
+    template<typename T>
+    struct sequence {
+        uint32_t cap;
+        uint32_t len;
+        T* buf;
+    };
+
+    template<typename T>
+    struct sequence_msg {
+        sequence<T> values;
+    };
+
+    class AvrobinSerializerBenchmark {
+    public:
+        explicit AvrobinSerializerBenchmark(const char* descriptor) {
+            if (dynType_parseWithStr(descriptor, nullptr, nullptr, &type) != 0) {
+                std::cerr << "Error parsing descriptor " << descriptor << std::endl;
+                abort();
+            }
+        }
+
+        ~AvrobinSerializerBenchmark() {
+            dynType_destroy(type);
+        }
+
+        AvrobinSerializerBenchmark(AvrobinSerializerBenchmark&&) = delete;
+        AvrobinSerializerBenchmark& operator=(AvrobinSerializerBenchmark&&) = delete;
+        AvrobinSerializerBenchmark(const AvrobinSerializerBenchmark&) = delete;
+        AvrobinSerializerBenchmark& operator=(const AvrobinSerializerBenchmark&) = delete;
+
+        void serialize(benchmark::State& state, const void* msg) {
+            size_t totalBytes = 0;
+            for (auto _ : state) {
+                // This code gets timed
+                uint8_t* buffer = nullptr;
+                size_t len = 0;
+                if (avrobinSerializer_serialize(type, msg, &buffer, &len) != 0) {
+                    state.SkipWithError("Error serializing message");
+                    break;
+                }
+                totalBytes += len;
+                free(buffer);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(totalBytes));
+        }
+
+        void serializeInto(benchmark::State& state, const void* msg) {
+            std::vector<uint8_t> buffer(1024);
+            size_t totalBytes = 0;
+            for (auto _ : state) {
+                // This code gets timed
+                size_t len = 0;
+                if (avrobinSerializer_serializeInto(type, msg, buffer.data(), buffer.size(), &len) != 0) {
+                    buffer.resize(len); //note buffer too small, len is the needed size
+                    if (avrobinSerializer_serializeInto(type, msg, buffer.data(), buffer.size(), &len) != 0) {
+                        state.SkipWithError("Error serializing message");
+                        break;
+                    }
+                }
+                totalBytes += len;
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(totalBytes));
+        }
+
+        void deserialize(benchmark::State& state, const void* msg) {
+            uint8_t* buffer = nullptr;
+            size_t len = 0;
+            if (avrobinSerializer_serialize(type, msg, &buffer, &len) != 0) {
+                state.SkipWithError("Error serializing message");
+                return;
+            }
+            for (auto _ : state) {
+                // This code gets timed
+                void* out = nullptr;
+                if (avrobinSerializer_deserialize(type, buffer, len, &out) != 0) {
+                    state.SkipWithError("Error deserializing message");
+                    break;
+                }
+                dynType_free(type, out);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * len));
+            free(buffer);
+        }
+
+    private:
+        dyn_type* type{nullptr};
+    };
+
+    constexpr const char* POI_DESCRIPTOR = "{DDDIItt lat lon alt id category name description}";
+    constexpr const char* DOUBLE_SEQUENCE_DESCRIPTOR = "{[D values}";
+    constexpr const char* INT_SEQUENCE_DESCRIPTOR = "{[I values}";
+
+    poi createPoi() {
+        static char name[] = "Lighthouse";
+        static char description[] = "A lighthouse at the end of the pier, used as point of interest";
+        return poi{52.1, 5.2, 12.5, 42, 3, name, description};
+    }
+
+    template<typename T>
+    struct sequence_fixture {
+        explicit sequence_fixture(size_t len) : data(len) {
+            for (size_t i = 0; i < len; ++i) {
+                data[i] = static_cast<T>(i * 37 % 1000);
+            }
+            msg.values.cap = static_cast<uint32_t>(len);
+            msg.values.len = static_cast<uint32_t>(len);
+            msg.values.buf = data.data();
+        }
+
+        std::vector<T> data;
+        sequence_msg<T> msg{};
+    };
+}
+
+static void AvrobinSerializerBenchmark_serializePoi(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{POI_DESCRIPTOR};
+    auto msg = createPoi();
+    benchmark.serialize(state, &msg);
+}
+
+static void AvrobinSerializerBenchmark_serializeIntoPoi(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{POI_DESCRIPTOR};
+    auto msg = createPoi();
+    benchmark.serializeInto(state, &msg);
+}
+
+static void AvrobinSerializerBenchmark_deserializePoi(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{POI_DESCRIPTOR};
+    auto msg = createPoi();
+    benchmark.deserialize(state, &msg);
+}
+
+static void AvrobinSerializerBenchmark_serializeDoubleSequence(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{DOUBLE_SEQUENCE_DESCRIPTOR};
+    sequence_fixture<double> fixture{static_cast<size_t>(state.range(0))};
+    benchmark.serialize(state, &fixture.msg);
+}
+
+static void AvrobinSerializerBenchmark_serializeIntoDoubleSequence(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{DOUBLE_SEQUENCE_DESCRIPTOR};
+    sequence_fixture<double> fixture{static_cast<size_t>(state.range(0))};
+    benchmark.serializeInto(state, &fixture.msg);
+}
+
+static void AvrobinSerializerBenchmark_deserializeDoubleSequence(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{DOUBLE_SEQUENCE_DESCRIPTOR};
+    sequence_fixture<double> fixture{static_cast<size_t>(state.range(0))};
+    benchmark.deserialize(state, &fixture.msg);
+}
+
+static void AvrobinSerializerBenchmark_serializeIntSequence(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{INT_SEQUENCE_DESCRIPTOR};
+    sequence_fixture<int32_t> fixture{static_cast<size_t>(state.range(0))};
+    benchmark.serialize(state, &fixture.msg);
+}
+
+static void AvrobinSerializerBenchmark_serializeIntoIntSequence(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{INT_SEQUENCE_DESCRIPTOR};
+    sequence_fixture<int32_t> fixture{static_cast<size_t>(state.range(0))};
+    benchmark.serializeInto(state, &fixture.msg);
+}
+
+static void AvrobinSerializerBenchmark_deserializeIntSequence(benchmark::State& state) {
+    AvrobinSerializerBenchmark benchmark{INT_SEQUENCE_DESCRIPTOR};
+    sequence_fixture<int32_t> fixture{static_cast<size_t>(state.range(0))};
+    benchmark.deserialize(state, &fixture.msg);
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_serializePoi);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_serializeIntoPoi);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_deserializePoi);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_serializeDoubleSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_serializeIntoDoubleSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_deserializeDoubleSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_serializeIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_serializeIntoIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(AvrobinSerializerBenchmark_deserializeIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
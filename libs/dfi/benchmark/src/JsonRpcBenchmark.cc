@@ -0,0 +1,199 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "json_rpc.h"
+#include "dyn_interface.h"
+
+/**
+ * Measures the remote service call path of json_rpc: preparing a request, handling a request with jsonRpc_call
+ * (method lookup, argument deserialization, the call and the reply serialization) and handling the reply.
+ * The interface is generated with a configurable number of methods to show the cost of the method lookup.
+ */
+namespace {
+    int add(void* /*handle*/, double a, double b, double* result) {
+        *result = a + b;
+        return 0;
+    }
+
+    struct double_sequence {
+        uint32_t cap;
+        uint32_t len;
+        double* buf;
+    };
+
+    int sum(void* /*handle*/, double_sequence values, double* result) {
+        double total = 0.0;
+        for (uint32_t i = 0; i < values.len; ++i) {
+            total += values.buf[i];
+        }
+        *result = total;
+        return 0;
+    }
+
+    class JsonRpcBenchmark {
+    public:
+        /**
+         * Creates an interface with nrOfMethods add methods (add0(DD)D ... addN(DD)D) and a sum([D)D method.
+         * The sum method is the last method, so that a linear method lookup has to visit all methods.
+         */
+        explicit JsonRpcBenchmark(int nrOfMethods) {
+            std::string descriptor = ":header\ntype=interface\nname=benchmark\nversion=1.0.0\n:annotations\n:types\n:methods\n";
+            for (int i = 0; i < nrOfMethods; ++i) {
+                descriptor += "add" + std::to_string(i) + "(DD)D=add" + std::to_string(i) + "(#am=handle;PDD#am=pre;*D)N\n";
+            }
+            descriptor += "sum([D)D=sum(#am=handle;P[D#am=pre;*D)N\n";
+            FILE* stream = fmemopen((void*)descriptor.c_str(), descriptor.size(), "r");
+            if (stream == nullptr || dynInterface_parse(stream, &intf) != 0) {
+                std::cerr << "Error parsing interface descriptor" << std::endl;
+                abort();
+            }
+            fclose(stream);
+
+            //note the service layout is a handle followed by the function pointers in method index order
+            service.resize(nrOfMethods + 2);
+            service[0] = nullptr;
+            for (int i = 0; i < nrOfMethods; ++i) {
+                service[i + 1] = reinterpret_cast<void*>(add);
+            }
+            service[nrOfMethods + 1] = reinterpret_cast<void*>(sum);
+        }
+
+        ~JsonRpcBenchmark() {
+            dynInterface_destroy(intf);
+        }
+
+        JsonRpcBenchmark(JsonRpcBenchmark&&) = delete;
+        JsonRpcBenchmark& operator=(JsonRpcBenchmark&&) = delete;
+        JsonRpcBenchmark(const JsonRpcBenchmark&) = delete;
+        JsonRpcBenchmark& operator=(const JsonRpcBenchmark&) = delete;
+
+        void call(benchmark::State& state, const char* request) {
+            for (auto _ : state) {
+                // This code gets timed
+                char* reply = nullptr;
+                if (jsonRpc_call(intf, service.data(), request, &reply) != 0) {
+                    state.SkipWithError("Error calling method");
+                    break;
+                }
+                free(reply);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * strlen(request)));
+        }
+
+        void prepareRequest(benchmark::State& state, const char* methodId, void* args[]) {
+            dyn_function_type* func = findFunction(methodId);
+            size_t totalBytes = 0;
+            for (auto _ : state) {
+                // This code gets timed
+                char* request = nullptr;
+                if (func == nullptr || jsonRpc_prepareInvokeRequest(func, methodId, args, &request) != 0) {
+                    state.SkipWithError("Error preparing request");
+                    break;
+                }
+                totalBytes += strlen(request);
+                free(request);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(totalBytes));
+        }
+
+        /**
+         * Handles a reply for an add method, the result is the pre-allocated output argument at index 3.
+         */
+        void handleReply(benchmark::State& state, const char* methodId, const char* reply) {
+            dyn_function_type* func = findFunction(methodId);
+            double result = 0.0;
+            double* resultPtr = &result;
+            void* args[4] = {nullptr, nullptr, nullptr, &resultPtr};
+            for (auto _ : state) {
+                // This code gets timed
+                int rsErrno = 0;
+                if (func == nullptr || jsonRpc_handleReply(func, reply, args, &rsErrno) != 0) {
+                    state.SkipWithError("Error handling reply");
+                    break;
+                }
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * strlen(reply)));
+        }
+
+    private:
+        dyn_function_type* findFunction(const char* methodId) {
+            struct method_entry* method = nullptr;
+            return dynInterface_findMethod(intf, methodId, &method) == 0 ? method->dynFunc : nullptr;
+        }
+
+        dyn_interface_type* intf{nullptr};
+        std::vector<void*> service{};
+    };
+
+    std::string createSumRequest(size_t nrOfValues) {
+        std::string request = R"({"m":"sum([D)D","a":[[)";
+        for (size_t i = 0; i < nrOfValues; ++i) {
+            request += (i == 0 ? "" : ",") + std::to_string(static_cast<double>(i) + 0.5);
+        }
+        request += "]]}";
+        return request;
+    }
+}
+
+static void JsonRpcBenchmark_callAdd(benchmark::State& state) {
+    JsonRpcBenchmark benchmark{static_cast<int>(state.range(0))};
+    benchmark.call(state, R"({"m":"add0(DD)D","a":[1.0,2.0]})");
+}
+
+static void JsonRpcBenchmark_callLastMethod(benchmark::State& state) {
+    JsonRpcBenchmark benchmark{static_cast<int>(state.range(0))};
+    benchmark.call(state, R"({"m":"sum([D)D","a":[[1.0,2.0]]})");
+}
+
+static void JsonRpcBenchmark_callSum(benchmark::State& state) {
+    JsonRpcBenchmark benchmark{1};
+    auto request = createSumRequest(static_cast<size_t>(state.range(0)));
+    benchmark.call(state, request.c_str());
+}
+
+static void JsonRpcBenchmark_prepareAddRequest(benchmark::State& state) {
+    JsonRpcBenchmark benchmark{1};
+    double a = 1.0;
+    double b = 2.0;
+    void* args[4] = {nullptr, &a, &b, nullptr};
+    benchmark.prepareRequest(state, "add0(DD)D", args);
+}
+
+static void JsonRpcBenchmark_handleAddReply(benchmark::State& state) {
+    JsonRpcBenchmark benchmark{1};
+    benchmark.handleReply(state, "add0(DD)D", R"({"r":3.0})");
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(JsonRpcBenchmark_callAdd)->Arg(1)->Arg(64)->Arg(1024);
+CELIX_BENCHMARK(JsonRpcBenchmark_callLastMethod)->Arg(1)->Arg(64)->Arg(1024);
+CELIX_BENCHMARK(JsonRpcBenchmark_callSum)->Arg(16)->Arg(1024);
+CELIX_BENCHMARK(JsonRpcBenchmark_prepareAddRequest);
+CELIX_BENCHMARK(JsonRpcBenchmark_handleAddReply);
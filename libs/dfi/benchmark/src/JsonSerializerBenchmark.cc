@@ -0,0 +1,303 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "json_serializer.h"
+#include "dyn_type.h"
+
+/**
+ * Measures the streaming json (de)serialization against the jansson DOM based (de)serialization,
+ * for a small struct with doubles, ints and strings and for sequences of structs and ints.
+ */
+namespace {
+    struct poi {
+        double lat;
+        double lon;
+        double alt;
+        int32_t id;
+        int32_t category;
+        char* name;
+        char* description;
+    };
+
+    template<typename T>
+    struct sequence_msg {
+        uint32_t cap;
+        uint32_t len;
+        T* buf;
+    };
+
+    class JsonSerializerBenchmark {
+    public:
+        explicit JsonSerializerBenchmark(const char* descriptor) {
+            if (dynType_parseWithStr(descriptor, nullptr, nullptr, &type) != 0) {
+                std::cerr << "Error parsing descriptor " << descriptor << std::endl;
+                abort();
+            }
+        }
+
+        ~JsonSerializerBenchmark() {
+            dynType_destroy(type);
+        }
+
+        JsonSerializerBenchmark(JsonSerializerBenchmark&&) = delete;
+        JsonSerializerBenchmark& operator=(JsonSerializerBenchmark&&) = delete;
+        JsonSerializerBenchmark(const JsonSerializerBenchmark&) = delete;
+        JsonSerializerBenchmark& operator=(const JsonSerializerBenchmark&) = delete;
+
+        void serialize(benchmark::State& state, const void* msg) {
+            size_t totalBytes = 0;
+            for (auto _ : state) {
+                // This code gets timed
+                char* json = nullptr;
+                if (jsonSerializer_serialize(type, msg, &json) != 0) {
+                    state.SkipWithError("Error serializing message");
+                    break;
+                }
+                totalBytes += strlen(json);
+                free(json);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(totalBytes));
+        }
+
+        void serializeToBuffer(benchmark::State& state, const void* msg) {
+            char* buffer = nullptr;
+            size_t bufferSize = 0;
+            size_t totalBytes = 0;
+            for (auto _ : state) {
+                // This code gets timed
+                size_t len = 0;
+                if (jsonSerializer_serializeToBuffer(type, msg, &buffer, &bufferSize, &len) != 0) {
+                    state.SkipWithError("Error serializing message");
+                    break;
+                }
+                totalBytes += len;
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(totalBytes));
+            free(buffer);
+        }
+
+        void serializeDom(benchmark::State& state, const void* msg) {
+            size_t totalBytes = 0;
+            for (auto _ : state) {
+                // This code gets timed
+                json_t* root = nullptr;
+                if (jsonSerializer_serializeJson(type, msg, &root) != 0) {
+                    state.SkipWithError("Error serializing message");
+                    break;
+                }
+                char* json = json_dumps(root, JSON_COMPACT);
+                totalBytes += strlen(json);
+                free(json);
+                json_decref(root);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(totalBytes));
+        }
+
+        void deserialize(benchmark::State& state, const void* msg) {
+            char* json = nullptr;
+            if (jsonSerializer_serialize(type, msg, &json) != 0) {
+                state.SkipWithError("Error serializing message");
+                return;
+            }
+            size_t len = strlen(json);
+            for (auto _ : state) {
+                // This code gets timed
+                void* out = nullptr;
+                if (jsonSerializer_deserialize(type, json, len, &out) != 0) {
+                    state.SkipWithError("Error deserializing message");
+                    break;
+                }
+                dynType_free(type, out);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * len));
+            free(json);
+        }
+
+        void deserializeDom(benchmark::State& state, const void* msg) {
+            char* json = nullptr;
+            if (jsonSerializer_serialize(type, msg, &json) != 0) {
+                state.SkipWithError("Error serializing message");
+                return;
+            }
+            size_t len = strlen(json);
+            for (auto _ : state) {
+                // This code gets timed
+                json_error_t error;
+                json_t* root = json_loadb(json, len, JSON_DECODE_ANY, &error);
+                void* out = nullptr;
+                if (root == nullptr || jsonSerializer_deserializeJson(type, root, &out) != 0) {
+                    state.SkipWithError("Error deserializing message");
+                    json_decref(root);
+                    break;
+                }
+                dynType_free(type, out);
+                json_decref(root);
+            }
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * len));
+            free(json);
+        }
+
+    private:
+        dyn_type* type{nullptr};
+    };
+
+    constexpr const char* POI_DESCRIPTOR = "{DDDIItt lat lon alt id category name description}";
+    constexpr const char* POI_SEQUENCE_DESCRIPTOR = "{[{DDDIItt lat lon alt id category name description} values}";
+    constexpr const char* INT_SEQUENCE_DESCRIPTOR = "{[I values}";
+
+    poi createPoi() {
+        static char name[] = "Lighthouse";
+        static char description[] = "A lighthouse at the end of the pier, used as point of interest";
+        return poi{52.1, 5.2, 12.5, 42, 3, name, description};
+    }
+
+    template<typename T>
+    struct sequence_fixture {
+        sequence_fixture(size_t len, T item) : data(len, item) {
+            msg.cap = static_cast<uint32_t>(len);
+            msg.len = static_cast<uint32_t>(len);
+            msg.buf = data.data();
+        }
+
+        std::vector<T> data;
+        sequence_msg<T> msg{};
+    };
+
+    enum class Mode {
+        SERIALIZE,
+        SERIALIZE_TO_BUFFER,
+        SERIALIZE_DOM,
+        DESERIALIZE,
+        DESERIALIZE_DOM,
+    };
+
+    void run(benchmark::State& state, JsonSerializerBenchmark& benchmark, const void* msg, Mode mode) {
+        switch (mode) {
+            case Mode::SERIALIZE:
+                benchmark.serialize(state, msg);
+                break;
+            case Mode::SERIALIZE_TO_BUFFER:
+                benchmark.serializeToBuffer(state, msg);
+                break;
+            case Mode::SERIALIZE_DOM:
+                benchmark.serializeDom(state, msg);
+                break;
+            case Mode::DESERIALIZE:
+                benchmark.deserialize(state, msg);
+                break;
+            case Mode::DESERIALIZE_DOM:
+                benchmark.deserializeDom(state, msg);
+                break;
+        }
+    }
+
+    void runPoi(benchmark::State& state, Mode mode) {
+        JsonSerializerBenchmark benchmark{POI_DESCRIPTOR};
+        auto msg = createPoi();
+        run(state, benchmark, &msg, mode);
+    }
+
+    void runPoiSequence(benchmark::State& state, Mode mode) {
+        JsonSerializerBenchmark benchmark{POI_SEQUENCE_DESCRIPTOR};
+        sequence_fixture<poi> fixture{static_cast<size_t>(state.range(0)), createPoi()};
+        run(state, benchmark, &fixture.msg, mode);
+    }
+
+    void runIntSequence(benchmark::State& state, Mode mode) {
+        JsonSerializerBenchmark benchmark{INT_SEQUENCE_DESCRIPTOR};
+        sequence_fixture<int32_t> fixture{static_cast<size_t>(state.range(0)), 123456};
+        run(state, benchmark, &fixture.msg, mode);
+    }
+}
+
+static void JsonSerializerBenchmark_serializePoi(benchmark::State& state) {
+    runPoi(state, Mode::SERIALIZE);
+}
+
+static void JsonSerializerBenchmark_serializeToBufferPoi(benchmark::State& state) {
+    runPoi(state, Mode::SERIALIZE_TO_BUFFER);
+}
+
+static void JsonSerializerBenchmark_serializeDomPoi(benchmark::State& state) {
+    runPoi(state, Mode::SERIALIZE_DOM);
+}
+
+static void JsonSerializerBenchmark_deserializePoi(benchmark::State& state) {
+    runPoi(state, Mode::DESERIALIZE);
+}
+
+static void JsonSerializerBenchmark_deserializeDomPoi(benchmark::State& state) {
+    runPoi(state, Mode::DESERIALIZE_DOM);
+}
+
+static void JsonSerializerBenchmark_serializePoiSequence(benchmark::State& state) {
+    runPoiSequence(state, Mode::SERIALIZE);
+}
+
+static void JsonSerializerBenchmark_serializeDomPoiSequence(benchmark::State& state) {
+    runPoiSequence(state, Mode::SERIALIZE_DOM);
+}
+
+static void JsonSerializerBenchmark_deserializePoiSequence(benchmark::State& state) {
+    runPoiSequence(state, Mode::DESERIALIZE);
+}
+
+static void JsonSerializerBenchmark_deserializeDomPoiSequence(benchmark::State& state) {
+    runPoiSequence(state, Mode::DESERIALIZE_DOM);
+}
+
+static void JsonSerializerBenchmark_serializeIntSequence(benchmark::State& state) {
+    runIntSequence(state, Mode::SERIALIZE);
+}
+
+static void JsonSerializerBenchmark_serializeDomIntSequence(benchmark::State& state) {
+    runIntSequence(state, Mode::SERIALIZE_DOM);
+}
+
+static void JsonSerializerBenchmark_deserializeIntSequence(benchmark::State& state) {
+    runIntSequence(state, Mode::DESERIALIZE);
+}
+
+static void JsonSerializerBenchmark_deserializeDomIntSequence(benchmark::State& state) {
+    runIntSequence(state, Mode::DESERIALIZE_DOM);
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializePoi);
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializeToBufferPoi);
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializeDomPoi); //reference, jansson DOM
+CELIX_BENCHMARK(JsonSerializerBenchmark_deserializePoi);
+CELIX_BENCHMARK(JsonSerializerBenchmark_deserializeDomPoi); //reference, jansson DOM
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializePoiSequence)->Arg(16)->Arg(1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializeDomPoiSequence)->Arg(16)->Arg(1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_deserializePoiSequence)->Arg(16)->Arg(1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_deserializeDomPoiSequence)->Arg(16)->Arg(1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializeIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_serializeDomIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_deserializeIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
+CELIX_BENCHMARK(JsonSerializerBenchmark_deserializeDomIntSequence)->Arg(16)->Arg(1024)->Arg(64 * 1024);
@@ -20,6 +20,8 @@
 #include "gtest/gtest.h"
 
 #include <stdarg.h>
+#include <algorithm>
+#include <vector>
 
 
 extern "C" {
@@ -610,3 +612,112 @@ public:
 TEST_F(AvrobinSerializerTests, GeneralTests) {
     generalTests();
 }
+
+TEST_F(AvrobinSerializerTests, SerializeIntoBuffer) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{It a b}", nullptr, nullptr, &type));
+    struct {
+        int32_t a;
+        const char *b;
+    } val{-3, "hello"};
+
+    uint8_t *serdata = nullptr;
+    size_t serdatalen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(type, &val, &serdata, &serdatalen));
+    EXPECT_EQ(7, serdatalen); //varint -3 (1 byte) + string length (1 byte) + 5 chars
+
+    //too small buffer, the needed size is returned
+    uint8_t small[4];
+    size_t outlen = 0;
+    EXPECT_NE(0, avrobinSerializer_serializeInto(type, &val, small, sizeof(small), &outlen));
+    EXPECT_EQ(serdatalen, outlen);
+
+    uint8_t buffer[7];
+    outlen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serializeInto(type, &val, buffer, sizeof(buffer), &outlen));
+    ASSERT_EQ(serdatalen, outlen);
+    EXPECT_EQ(0, memcmp(serdata, buffer, outlen));
+
+    free(serdata);
+    dynType_destroy(type);
+}
+
+TEST_F(AvrobinSerializerTests, DeserializeIoVec) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{JDt a b c}", nullptr, nullptr, &type));
+    struct {
+        int64_t a;
+        double b;
+        const char *c;
+    } val{-123456789012LL, 1.5, "split over multiple iovecs"};
+
+    uint8_t *serdata = nullptr;
+    size_t serdatalen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(type, &val, &serdata, &serdatalen));
+
+    //every varint, double and string crosses an iovec boundary
+    std::vector<struct iovec> iovs{};
+    for (size_t i = 0; i < serdatalen; i += 3) {
+        iovs.push_back({serdata + i, std::min<size_t>(3, serdatalen - i)});
+        iovs.push_back({serdata + i, 0}); //empty iovecs are skipped
+    }
+    void *inst = nullptr;
+    ASSERT_EQ(0, avrobinSerializer_deserializeIoVec(type, iovs.data(), iovs.size(), &inst));
+    auto *result = static_cast<decltype(val)*>(inst);
+    EXPECT_EQ(val.a, result->a);
+    EXPECT_EQ(val.b, result->b);
+    EXPECT_STREQ(val.c, result->c);
+    dynType_free(type, inst);
+
+    //truncated input
+    struct iovec truncated{serdata, serdatalen - 1};
+    inst = nullptr;
+    EXPECT_NE(0, avrobinSerializer_deserializeIoVec(type, &truncated, 1, &inst));
+
+    free(serdata);
+    dynType_destroy(type);
+}
+
+TEST_F(AvrobinSerializerTests, Sequences) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{[D[b[J[t a b c d}", nullptr, nullptr, &type));
+    double doubles[] = {1.0, -2.5, 3.25};
+    uint8_t bytes[] = {0, 1, 127, 128, 255};
+    int64_t longs[] = {0, -1, INT64_MAX, INT64_MIN};
+    struct {
+        struct { uint32_t cap; uint32_t len; double *buf; } a;
+        struct { uint32_t cap; uint32_t len; uint8_t *buf; } b;
+        struct { uint32_t cap; uint32_t len; int64_t *buf; } c;
+        struct { uint32_t cap; uint32_t len; char **buf; } d;
+    } val{{3, 3, doubles}, {5, 5, bytes}, {4, 4, longs}, {0, 0, nullptr}};
+
+    uint8_t *serdata = nullptr;
+    size_t serdatalen = 0;
+    ASSERT_EQ(0, avrobinSerializer_serialize(type, &val, &serdata, &serdatalen));
+    EXPECT_EQ(0x06, serdata[0]); //block count 3 (zigzag)
+    EXPECT_EQ(0x00, serdata[serdatalen - 1]); //empty sequence, a single zero block count
+
+    void *inst = nullptr;
+    ASSERT_EQ(0, avrobinSerializer_deserialize(type, serdata, serdatalen, &inst));
+    auto *result = static_cast<decltype(val)*>(inst);
+    ASSERT_EQ(3, result->a.len);
+    EXPECT_EQ(0, memcmp(doubles, result->a.buf, sizeof(doubles)));
+    ASSERT_EQ(5, result->b.len);
+    EXPECT_EQ(0, memcmp(bytes, result->b.buf, sizeof(bytes)));
+    ASSERT_EQ(4, result->c.len);
+    EXPECT_EQ(0, memcmp(longs, result->c.buf, sizeof(longs)));
+    EXPECT_EQ(0, result->d.len);
+    dynType_free(type, inst);
+
+    //serialize into a too small buffer, the bulk paths must count the needed size
+    std::vector<uint8_t> buffer(serdatalen - 1);
+    size_t outlen = 0;
+    EXPECT_NE(0, avrobinSerializer_serializeInto(type, &val, buffer.data(), buffer.size(), &outlen));
+    EXPECT_EQ(serdatalen, outlen);
+    buffer.resize(serdatalen);
+    ASSERT_EQ(0, avrobinSerializer_serializeInto(type, &val, buffer.data(), buffer.size(), &outlen));
+    EXPECT_EQ(0, memcmp(serdata, buffer.data(), serdatalen));
+
+    free(serdata);
+    dynType_destroy(type);
+}
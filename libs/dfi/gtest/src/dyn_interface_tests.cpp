@@ -101,6 +101,14 @@ extern "C" {
         int count = dynInterface_nrOfMethods(dynIntf);
         ASSERT_EQ(4, count);
 
+        struct method_entry *method = NULL;
+        status = dynInterface_findMethod(dynIntf, "stats([D)LStatsResult;", &method);
+        ASSERT_EQ(0, status);
+        ASSERT_STREQ("stats", method->name);
+        ASSERT_EQ(3, method->index);
+        status = dynInterface_findMethod(dynIntf, "stats", &method);
+        ASSERT_TRUE(status != 0);
+
         dynInterface_destroy(dynIntf);
     }
 
@@ -116,6 +124,31 @@ extern "C" {
         dynInterface_destroy(dynIntf);
     }
 
+    static void testDuplicateMethodId(void) {
+        const char* descriptor = ":header\n"
+                "type=interface\n"
+                "name=calculator\n"
+                "version=1.0.0\n"
+                ":methods\n"
+                "add(DD)D=add(#am=handle;PDD#am=pre;*D)N\n"
+                "add(DD)D=sub(#am=handle;PDD#am=pre;*D)N\n";
+        dyn_interface_type *dynIntf = NULL;
+        FILE *desc = fmemopen((void*)descriptor, strlen(descriptor), "r");
+        assert(desc != NULL);
+        int status = dynInterface_parse(desc, &dynIntf);
+        ASSERT_EQ(0, status);
+        fclose(desc);
+
+        ASSERT_EQ(2, dynInterface_nrOfMethods(dynIntf));
+        struct method_entry *method = NULL;
+        status = dynInterface_findMethod(dynIntf, "add(DD)D", &method);
+        ASSERT_EQ(0, status);
+        ASSERT_STREQ("add", method->name); //first parsed method wins
+        ASSERT_EQ(0, method->index);
+
+        dynInterface_destroy(dynIntf);
+    }
+
     static void testInvalid(void) {
         int status = 0;
 
@@ -214,3 +247,6 @@ TEST_F(DynInterfaceTests, testInvalid) {
     testInvalid();
 }
 
+TEST_F(DynInterfaceTests, testDuplicateMethodId) {
+    testDuplicateMethodId();
+}
@@ -243,6 +243,95 @@ static void stdLog(void*, int level, const char *file, int line, const char *msg
         dynInterface_destroy(intf);
     }
 
+    void callTestArgumentsBeforeMethod(void) {
+        dyn_interface_type *intf = nullptr;
+        FILE *desc = fopen("descriptors/example1.descriptor", "r");
+        ASSERT_TRUE(desc != nullptr);
+        int rc = dynInterface_parse(desc, &intf);
+        ASSERT_EQ(0, rc);
+        fclose(desc);
+
+        char *result = nullptr;
+        tst_serv serv {nullptr, add, nullptr, nullptr, nullptr};
+
+        //note arguments are read after the method is known, unknown members and superfluous arguments are ignored
+        rc = jsonRpc_call(intf, &serv, R"({"a": [1.0, 2.0, "extra"], "x": {"y": [null]}, "m": "add(DD)D"})", &result);
+        ASSERT_EQ(0, rc);
+        ASSERT_STREQ(R"({"r":3.0})", result);
+
+        free(result);
+        dynInterface_destroy(intf);
+    }
+
+    void callTestInvalidRequest(void) {
+        dyn_interface_type *intf = nullptr;
+        FILE *desc = fopen("descriptors/example1.descriptor", "r");
+        ASSERT_TRUE(desc != nullptr);
+        int rc = dynInterface_parse(desc, &intf);
+        ASSERT_EQ(0, rc);
+        fclose(desc);
+
+        tst_serv serv {nullptr, add, nullptr, nullptr, nullptr};
+        const char *requests[] = {
+                R"({"m":"unknown(DD)D", "a": [1.0,2.0]})", //unknown method
+                R"({"a": [1.0,2.0]})", //no method
+                R"({"m":"add(DD)D", "a": [1.0]})", //missing argument
+                R"({"m":"add(DD)D"})", //no arguments
+                R"({"m":"add(DD)D", "a": [1.0,2.0])", //invalid json
+                R"({"m":"add(DD)D", "a": [1.0,2.0]} {})", //trailing input
+                R"({"m":"add(DD)D", "m":"add(DD)D", "a": [1.0,2.0]})", //duplicate method
+                R"(["add(DD)D", [1.0,2.0]])", //not an object
+        };
+        for (auto request : requests) {
+            char *result = nullptr;
+            rc = jsonRpc_call(intf, &serv, request, &result);
+            EXPECT_NE(0, rc) << request;
+            EXPECT_EQ(nullptr, result) << request;
+        }
+
+        dynInterface_destroy(intf);
+    }
+
+    void callTestPreparedRequest(void) {
+        dyn_interface_type *intf = nullptr;
+        FILE *desc = fopen("descriptors/example1.descriptor", "r");
+        ASSERT_TRUE(desc != nullptr);
+        int rc = dynInterface_parse(desc, &intf);
+        ASSERT_EQ(0, rc);
+        fclose(desc);
+
+        struct method_entry *method = nullptr;
+        rc = dynInterface_findMethod(intf, "add(DD)D", &method);
+        ASSERT_EQ(0, rc);
+
+        void *handle = nullptr;
+        double arg1 = 1.5;
+        double arg2 = 2.25;
+        void *args[4] = {&handle, &arg1, &arg2, nullptr};
+        char *request = nullptr;
+        rc = jsonRpc_prepareInvokeRequest(method->dynFunc, method->id, args, &request);
+        ASSERT_EQ(0, rc);
+        ASSERT_STREQ(R"({"m":"add(DD)D","a":[1.5,2.25]})", request);
+
+        char *result = nullptr;
+        tst_serv serv {nullptr, add, nullptr, nullptr, nullptr};
+        rc = jsonRpc_call(intf, &serv, request, &result);
+        ASSERT_EQ(0, rc);
+
+        double out = 0.0;
+        double *outPtr = &out;
+        args[3] = &outPtr;
+        int rsErrno = 0;
+        rc = jsonRpc_handleReply(method->dynFunc, result, args, &rsErrno);
+        ASSERT_EQ(0, rc);
+        ASSERT_EQ(0, rsErrno);
+        ASSERT_EQ(3.75, out);
+
+        free(result);
+        free(request);
+        dynInterface_destroy(intf);
+    }
+
     void handleTestOut(void) {
         dyn_interface_type *intf = nullptr;
         FILE *desc = fopen("descriptors/example1.descriptor", "r");
@@ -485,6 +574,18 @@ TEST_F(JsonRpcTests, callOut) {
     callTestOutput();
 }
 
+TEST_F(JsonRpcTests, callArgumentsBeforeMethod) {
+    callTestArgumentsBeforeMethod();
+}
+
+TEST_F(JsonRpcTests, callInvalidRequest) {
+    callTestInvalidRequest();
+}
+
+TEST_F(JsonRpcTests, callPreparedRequest) {
+    callTestPreparedRequest();
+}
+
 TEST_F(JsonRpcTests, handleOutSeq) {
     handleTestOutputSequence();
 }
@@ -25,6 +25,7 @@ extern "C" {
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 
 #include <ffi.h>
 
@@ -1437,3 +1438,206 @@ TEST_F(JsonSerializerTests, WriteTest3) {
     writeAvprTest3();
 }
 
+
+static void expectSameOutputAsDom(dyn_type *type, const void *input) {
+    json_t *root = nullptr;
+    ASSERT_EQ(0, jsonSerializer_serializeJson(type, input, &root));
+    char *expected = json_dumps(root, JSON_COMPACT);
+    json_decref(root);
+
+    char *result = nullptr;
+    ASSERT_EQ(0, jsonSerializer_serialize(type, input, &result));
+    ASSERT_TRUE(result != nullptr);
+    EXPECT_STREQ(expected, result);
+    free(expected);
+    free(result);
+}
+
+TEST_F(JsonSerializerTests, StreamingOutputSameAsDom) {
+    dyn_type *type = nullptr;
+
+    write_example1 ex1 {'A', -2, 3, -4, 5, 6, UINT64_MAX, 8.8f, 9.9, -10, true, 12};
+    ASSERT_EQ(0, dynType_parseWithStr(write_example1_descriptor, "ex1", nullptr, &type));
+    expectSameOutputAsDom(type, &ex1);
+    dynType_destroy(type);
+
+    struct {
+        double a, b, c, d, e, f, g;
+        float h;
+    } reals {0.1, 100.0, 1e20, 1e-5, -0.0, 1.5e300, NAN, 1e-7f};
+    ASSERT_EQ(0, dynType_parseWithStr("{DDDDDDDF a b c d e f g h}", nullptr, nullptr, &type));
+    expectSameOutputAsDom(type, &reals); //note the NaN is left out
+    dynType_destroy(type);
+
+    struct {
+        const char *a, *b, *c, *d;
+    } texts {"quote\" back\\slash/ \n\t\b\f\r \x01\x1f", "h\xc3\xa9llo \xe2\x82\xac \xf0\x9f\x98\x80", nullptr, "invalid \xc3\x28"};
+    ASSERT_EQ(0, dynType_parseWithStr("{tttt a b c d}", nullptr, nullptr, &type));
+    expectSameOutputAsDom(type, &texts); //note the NULL and invalid UTF-8 strings are left out
+    dynType_destroy(type);
+
+    example9 ex9 {1, const_cast<char*>("name"), RE_MAYBE};
+    ASSERT_EQ(0, dynType_parseWithStr(example9_descriptor, nullptr, nullptr, &type));
+    expectSameOutputAsDom(type, &ex9);
+    ex9.result = static_cast<ResultEnum>(7);
+    expectSameOutputAsDom(type, &ex9); //note an unknown enum value is left out
+    dynType_destroy(type);
+
+    const char *names[] = {"a", nullptr, "c"};
+    struct {
+        uint32_t cap;
+        uint32_t len;
+        const char **buf;
+    } seq {3, 3, names};
+    ASSERT_EQ(0, dynType_parseWithStr("[t", nullptr, nullptr, &type));
+    expectSameOutputAsDom(type, &seq); //note the NULL item is left out
+    seq.len = 0;
+    expectSameOutputAsDom(type, &seq);
+    dynType_destroy(type);
+
+    write_example2_sub sub1 {1, -2};
+    write_example2 ex2 {&sub1, {3, 4}};
+    ASSERT_EQ(0, dynType_parseWithStr(write_example2_descriptor, nullptr, nullptr, &type));
+    expectSameOutputAsDom(type, &ex2);
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, SerializeToReusableBuffer) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr(example1_descriptor, nullptr, nullptr, &type));
+    example1 ex {1.5, 2, 3, 4, 5.5f};
+
+    char *buffer = nullptr;
+    size_t bufferSize = 0;
+    size_t length = 0;
+    ASSERT_EQ(0, jsonSerializer_serializeToBuffer(type, &ex, &buffer, &bufferSize, &length));
+    ASSERT_TRUE(buffer != nullptr);
+    EXPECT_STREQ(R"({"a":1.5,"b":2,"c":3,"d":4,"e":5.5})", buffer);
+    EXPECT_EQ(strlen(buffer), length);
+    EXPECT_GT(bufferSize, length);
+
+    char *firstBuffer = buffer;
+    ex.b = 42;
+    ASSERT_EQ(0, jsonSerializer_serializeToBuffer(type, &ex, &buffer, &bufferSize, &length));
+    EXPECT_EQ(firstBuffer, buffer); //note reused
+    EXPECT_STREQ(R"({"a":1.5,"b":42,"c":3,"d":4,"e":5.5})", buffer);
+    EXPECT_EQ(strlen(buffer), length);
+    free(buffer);
+
+    //a too small buffer is reallocated
+    bufferSize = 4;
+    buffer = static_cast<char*>(malloc(bufferSize));
+    ASSERT_EQ(0, jsonSerializer_serializeToBuffer(type, &ex, &buffer, &bufferSize, &length));
+    EXPECT_STREQ(R"({"a":1.5,"b":42,"c":3,"d":4,"e":5.5})", buffer);
+    EXPECT_GT(bufferSize, length);
+    free(buffer);
+
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, ParseStrings) {
+    struct text_example {
+        char *a;
+        double b;
+        int64_t c;
+    };
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{tDJ a b c}", nullptr, nullptr, &type));
+
+    void *inst = nullptr;
+    const char *input = R"({"a":"é😀\n\"x\"\/","b":1.5e2,"c":-12})";
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), &inst));
+    auto ex = static_cast<text_example*>(inst);
+    EXPECT_STREQ("\xc3\xa9\xf0\x9f\x98\x80\n\"x\"/", ex->a);
+    EXPECT_EQ(150.0, ex->b);
+    EXPECT_EQ(-12, ex->c);
+    dynType_free(type, inst);
+
+    //duplicate members replace the earlier value and an integer is accepted for a real
+    input = R"( { "a" : "x", "b" : 3, "a" : "y" } )";
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), &inst));
+    ex = static_cast<text_example*>(inst);
+    EXPECT_STREQ("y", ex->a);
+    EXPECT_EQ(3.0, ex->b);
+    dynType_free(type, inst);
+
+    //the input does not need to be null terminated
+    input = R"({"a":"abc"}garbage)";
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(R"({"a":"abc"})"), &inst));
+    EXPECT_STREQ("abc", static_cast<text_example*>(inst)->a);
+    dynType_free(type, inst);
+
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, ParseNullPointer) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr(write_example2_descriptor, nullptr, nullptr, &type));
+    void *inst = nullptr;
+    const char *input = R"({"sub1":null,"sub2":{"c":1,"d":2}})";
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, input, strlen(input), &inst));
+    auto ex = static_cast<write_example2*>(inst);
+    EXPECT_EQ(nullptr, ex->sub1);
+    EXPECT_EQ(1, ex->c);
+    EXPECT_EQ(2, ex->d);
+    dynType_free(type, inst);
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, ParseInvalidInput) {
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr("{tDJ[I a b c d}", nullptr, nullptr, &type));
+
+    const char *invalidInputs[] = {
+            "",
+            R"({"a":"x"} x)",
+            R"({"x":1})",
+            R"({"a":"\u0000"})",
+            R"({"a":"\ud800"})",
+            R"({"a":"abc)",
+            R"({"a":"x" "c":1})",
+            R"({"a":"x",})",
+            R"({"c":9223372036854775808})",
+            R"({"c":01})",
+            R"({"b":1e999})",
+            R"({"b":1.})",
+            R"({"d":[1,2,)",
+            R"({"d":null})",
+            R"({"a":"x","d":[1,2,3],"b":tru})",
+    };
+    for (auto *input : invalidInputs) {
+        void *inst = nullptr;
+        EXPECT_NE(0, jsonSerializer_deserialize(type, input, strlen(input), &inst)) << input;
+        EXPECT_EQ(nullptr, inst);
+    }
+
+    dynType_destroy(type);
+}
+
+TEST_F(JsonSerializerTests, StreamingRoundTrip) {
+    write_example3_person p1 {"John", 33};
+    write_example3_person p2 {"P\xc3\xa9ter \"the\" great", 44};
+    write_example3 seq {2, 2, (write_example3_person **) calloc(2, sizeof(void *))};
+    seq.buf[0] = &p1;
+    seq.buf[1] = &p2;
+
+    dyn_type *type = nullptr;
+    ASSERT_EQ(0, dynType_parseWithStr(write_example3_descriptor, "ex3", nullptr, &type));
+    char *result = nullptr;
+    ASSERT_EQ(0, jsonSerializer_serialize(type, &seq, &result));
+
+    void *inst = nullptr;
+    ASSERT_EQ(0, jsonSerializer_deserialize(type, result, strlen(result), &inst));
+    auto out = static_cast<write_example3*>(inst);
+    ASSERT_EQ(2, out->len);
+    EXPECT_EQ(2, out->cap);
+    EXPECT_STREQ("John", out->buf[0]->name);
+    EXPECT_EQ(33, out->buf[0]->age);
+    EXPECT_STREQ(p2.name, out->buf[1]->name);
+    EXPECT_EQ(44, out->buf[1]->age);
+
+    dynType_free(type, inst);
+    free(result);
+    free(seq.buf);
+    dynType_destroy(type);
+}
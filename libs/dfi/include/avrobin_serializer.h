@@ -19,6 +19,8 @@
 #ifndef __AVROBIN_SERIALIZER_H_
 #define __AVROBIN_SERIALIZER_H_
 
+#include <sys/uio.h>
+
 #include "dfi_log_util.h"
 #include "dyn_type.h"
 #include "dyn_function.h"
@@ -33,8 +35,19 @@ DFI_SETUP_LOG_HEADER(avrobinSerializer);
 
 int avrobinSerializer_deserialize(dyn_type *type, const uint8_t *input, size_t inlen, void **result);
 
+/**
+ * Deserializes avrobin data which can be spread over multiple iovecs, without copying the input first.
+ */
+int avrobinSerializer_deserializeIoVec(dyn_type *type, const struct iovec *input, size_t inputIovLen, void **result);
+
 int avrobinSerializer_serialize(dyn_type *type, const void *input, uint8_t **output, size_t *outlen);
 
+/**
+ * Serializes into a caller provided buffer.
+ * If the buffer is too small, 1 is returned and outlen is set to the needed size (larger than bufferSize).
+ */
+int avrobinSerializer_serializeInto(dyn_type *type, const void *input, uint8_t *buffer, size_t bufferSize, size_t *outlen);
+
 int avrobinSerializer_generateSchema(dyn_type *type, char **output);
 
 int avrobinSerializer_saveFile(const char *filename, const char *schema, const uint8_t *serdata, size_t serdatalen);
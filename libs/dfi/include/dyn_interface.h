@@ -68,6 +68,12 @@ int dynInterface_getAnnotationEntry(dyn_interface_type *intf, const char *name,
 int dynInterface_methods(dyn_interface_type *intf, struct methods_head **list);
 int dynInterface_nrOfMethods(dyn_interface_type *intf);
 
+/**
+ * Finds the method entry for the provided method id (e.g. "add(DD)D") using the method index of the interface.
+ * @return 0 if found, 1 if the interface has no method with the provided id.
+ */
+int dynInterface_findMethod(dyn_interface_type *intf, const char *id, struct method_entry **entry);
+
 // Avpr parsing
 dyn_interface_type * dynInterface_parseAvprWithStr(const char * avpr);
 dyn_interface_type * dynInterface_parseAvpr(FILE * avprStream);
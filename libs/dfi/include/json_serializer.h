@@ -33,12 +33,38 @@ extern "C" {
 //logging
 DFI_SETUP_LOG_HEADER(jsonSerializer);
 
+/**
+ * Deserializes the json input into a newly allocated instance of the type.
+ * The input is read with a pull parser, which fills the instance without building a jansson DOM.
+ */
 int jsonSerializer_deserialize(dyn_type *type, const char *input, size_t length, void **result);
 int jsonSerializer_deserializeJson(dyn_type *type, json_t *input, void **result);
 
+/**
+ * Serializes the input to a newly allocated json string, which must be freed by the caller.
+ * The json is written directly from the input, without building a jansson DOM. The output is the same as
+ * json_dumps(JSON_COMPACT) of the json from jsonSerializer_serializeJson.
+ */
 int jsonSerializer_serialize(dyn_type *type, const void* input, char **output);
 int jsonSerializer_serializeJson(dyn_type *type, const void* input, json_t **out);
 
+/**
+ * Serializes the input to a null terminated json string in a reusable buffer.
+ *
+ * @param buffer In/out: the buffer to write to, or a pointer to NULL. The buffer is reallocated if too small and
+ *               remains owned by the caller, also if the serialization fails.
+ * @param bufferSize In/out: the size of the buffer.
+ * @param length Out: the length of the json string (excluding the terminating null character). Can be NULL.
+ */
+int jsonSerializer_serializeToBuffer(dyn_type *type, const void* input, char **buffer, size_t *bufferSize, size_t *length);
+
+/**
+ * Serializes the input to json in a caller provided buffer, without allocating. The json is not null terminated.
+ * If the buffer is too small, 1 is returned and length is set to the needed size (larger than bufferSize).
+ * If the serialization fails, 1 is returned and length is set to 0.
+ */
+int jsonSerializer_serializeInto(dyn_type *type, const void* input, char *buffer, size_t bufferSize, size_t *length);
+
 #ifdef __cplusplus
 }
 #endif
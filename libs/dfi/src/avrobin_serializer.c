@@ -25,36 +25,71 @@
 #include <jansson.h>
 
 #define MAX_VARINT_BUF_SIZE 10
+#define INITIAL_WRITE_BUFFER_SIZE 256
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define AVROBIN_LITTLE_ENDIAN_HOST 1 //avro float and double are little endian, so these can be copied as is
+#else
+#define AVROBIN_LITTLE_ENDIAN_HOST 0
+#endif
+
+/**
+ * Output buffer for serialization. The buffer is either owned and grown when needed or caller provided.
+ * If a caller provided buffer is too small, writing continues to only count the needed size.
+ */
+typedef struct avrobin_writer {
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+    bool growable;
+    bool overflow;
+} avrobin_writer_t;
+
+/**
+ * Input for deserialization, the current contiguous part and the remaining iovecs.
+ */
+typedef struct avrobin_reader {
+    const uint8_t *pos;
+    const uint8_t *end;
+    const struct iovec *iov;
+    size_t iovLen;
+} avrobin_reader_t;
 
 static int generate_sync(uint8_t **result);
 static int generate_record_name(char **result);
 
-static int avrobin_read_boolean(FILE *stream,bool *val);
-static int avrobin_read_int(FILE *stream,int32_t *val);
-static int avrobin_read_long(FILE *stream,int64_t *val);
-static int avrobin_read_float(FILE *stream,float *val);
-static int avrobin_read_double(FILE *stream,double *val);
-static int avrobin_read_string(FILE *stream,char **val);
-
-static int avrobin_write_boolean(FILE *stream,bool val);
-static int avrobin_write_int(FILE *stream,int32_t val);
-static int avrobin_write_long(FILE *stream,int64_t val);
-static int avrobin_write_float(FILE *stream,float val);
-static int avrobin_write_double(FILE *stream,double val);
-static int avrobin_write_string(FILE *stream,const char *val);
+static void avrobin_reader_init(avrobin_reader_t *reader, const struct iovec *input, size_t inputIovLen);
+
+static int avrobin_read_boolean(avrobin_reader_t *reader,bool *val);
+static int avrobin_read_int(avrobin_reader_t *reader,int32_t *val);
+static inline int avrobin_read_long(avrobin_reader_t *reader,int64_t *val);
+static int avrobin_read_float(avrobin_reader_t *reader,float *val);
+static int avrobin_read_double(avrobin_reader_t *reader,double *val);
+static int avrobin_read_string(avrobin_reader_t *reader,char **val);
+static int avrobin_read_bytes(avrobin_reader_t *reader, void *dst, size_t len);
+
+static int avrobin_write_boolean(avrobin_writer_t *writer,bool val);
+static int avrobin_write_int(avrobin_writer_t *writer,int32_t val);
+static inline int avrobin_write_long(avrobin_writer_t *writer,int64_t val);
+static int avrobin_write_float(avrobin_writer_t *writer,float val);
+static int avrobin_write_double(avrobin_writer_t *writer,double val);
+static int avrobin_write_string(avrobin_writer_t *writer,const char *val);
+static int avrobin_write_bytes(avrobin_writer_t *writer, const void *src, size_t len);
+static inline uint8_t* avrobin_writer_tryReserve(avrobin_writer_t *writer, size_t len);
+static inline size_t avrobin_encode_varint(uint8_t *dst, uint64_t uval);
 
 static int avrobin_schema_primitive(const char *tname, json_t **output);
 
-static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **result);
-static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, FILE *stream);
+static int avrobinSerializer_createType(dyn_type *type, avrobin_reader_t *reader, void **result);
+static int avrobinSerializer_parseAny(dyn_type *type, void *loc, avrobin_reader_t *reader);
+static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, avrobin_reader_t *reader);
+static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, avrobin_reader_t *reader);
+static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, avrobin_reader_t *reader);
 
-static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, FILE *stream);
-static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, FILE *stream);
+static int avrobinSerializer_writeAny(dyn_type *type, void *loc, avrobin_writer_t *writer);
+static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, avrobin_writer_t *writer);
+static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, avrobin_writer_t *writer);
+static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, avrobin_writer_t *writer);
 
 static int avrobinSerializer_generateAny(dyn_type *type, json_t **output);
 static int avrobinSerializer_generateComplex(dyn_type *type, json_t **output);
@@ -69,49 +104,69 @@ static uint32_t record_name_counter;
 DFI_SETUP_LOG(avrobinSerializer);
 
 int avrobinSerializer_deserialize(dyn_type *type, const uint8_t *input, size_t inlen, void **result) {
-    int status = OK;
-
-    FILE *stream = fmemopen((void*)input, inlen, "rb");
-
-    if (stream != NULL) {
-        status = avrobinSerializer_createType(type, stream, result);
+    struct iovec iov;
+    iov.iov_base = (void*)input;
+    iov.iov_len = inlen;
+    return avrobinSerializer_deserializeIoVec(type, &iov, 1, result);
+}
 
-        fclose(stream);
+int avrobinSerializer_deserializeIoVec(dyn_type *type, const struct iovec *input, size_t inputIovLen, void **result) {
+    avrobin_reader_t reader;
+    avrobin_reader_init(&reader, input, inputIovLen);
 
-        if (status != OK) {
-            LOG_ERROR("Error cannot deserialize avrobin.");
-        }
-    } else {
-        status = ERROR;
-        LOG_ERROR("Error initializing memory stream for reading. Length was %d.", inlen);
+    int status = avrobinSerializer_createType(type, &reader, result);
+    if (status != OK) {
+        LOG_ERROR("Error cannot deserialize avrobin.");
     }
-
     return status;
 }
 
 int avrobinSerializer_serialize(dyn_type *type, const void *input, uint8_t **output, size_t *outlen) {
     int status = OK;
 
-    FILE *stream = open_memstream((char**)output, outlen);
+    avrobin_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.growable = true;
+    writer.capacity = INITIAL_WRITE_BUFFER_SIZE;
+    writer.data = malloc(writer.capacity);
 
-    if (stream != NULL) {
-        status = avrobinSerializer_writeAny(type, (void*)input, stream);
-
-        fclose(stream);
-
-        if (status != OK) {
-            free(*output);
+    if (writer.data != NULL) {
+        status = avrobinSerializer_writeAny(type, (void*)input, &writer);
 
+        if (status == OK) {
+            *output = writer.data;
+            *outlen = writer.size;
+        } else {
+            free(writer.data);
             LOG_ERROR("Error cannot serialize avrobin.");
         }
     } else {
         status = ERROR;
-        LOG_ERROR("Error initializing memory stream for writing.");
+        LOG_ERROR("Error allocating buffer for writing.");
     }
 
     return status;
 }
 
+int avrobinSerializer_serializeInto(dyn_type *type, const void *input, uint8_t *buffer, size_t bufferSize, size_t *outlen) {
+    avrobin_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.data = buffer;
+    writer.capacity = bufferSize;
+
+    int status = avrobinSerializer_writeAny(type, (void*)input, &writer);
+    if (status == OK) {
+        *outlen = writer.size; //note if overflowed, this is the needed size
+        if (writer.overflow) {
+            status = ERROR;
+        }
+    } else {
+        *outlen = 0;
+        LOG_ERROR("Error cannot serialize avrobin.");
+    }
+    return status;
+}
+
 int avrobinSerializer_generateSchema(dyn_type *type, char **output) {
     int status = OK;
 
@@ -136,91 +191,65 @@ int avrobinSerializer_generateSchema(dyn_type *type, char **output) {
 int avrobinSerializer_saveFile(const char *filename, const char *schema, const uint8_t *serdata, size_t serdatalen) {
     int status = OK;
 
-    FILE *file = fopen(filename, "wb");
+    avrobin_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.growable = true;
 
-    if (file != NULL) {
-        if (status == OK) {
-            if (fputc('O', file) == EOF) {
-                status = ERROR;
-            }
-        }
-        if (status == OK) {
-            if (fputc('b', file) == EOF) {
-                status = ERROR;
-            }
-        }
-        if (status == OK) {
-            if (fputc('j', file) == EOF) {
+    uint8_t *sync = NULL;
+    status = generate_sync(&sync);
+
+    if (status == OK) {
+        static const uint8_t magic[4] = {'O', 'b', 'j', 1};
+        status = avrobin_write_bytes(&writer, magic, sizeof(magic));
+    }
+    if (status == OK) {
+        status = avrobin_write_long(&writer, 1);
+    }
+    if (status == OK) {
+        status = avrobin_write_string(&writer, "avro.schema");
+    }
+    if (status == OK) {
+        status = avrobin_write_string(&writer, schema);
+    }
+    if (status == OK) {
+        status = avrobin_write_long(&writer, 0);
+    }
+    if (status == OK) {
+        status = avrobin_write_bytes(&writer, sync, 16);
+    }
+    if (status == OK) {
+        status = avrobin_write_long(&writer, 1);
+    }
+    if (status == OK) {
+        status = avrobin_write_long(&writer, (int64_t)serdatalen);
+    }
+    if (status == OK) {
+        status = avrobin_write_bytes(&writer, serdata, serdatalen);
+    }
+    if (status == OK) {
+        status = avrobin_write_bytes(&writer, sync, 16);
+    }
+
+    if (status == OK) {
+        FILE *file = fopen(filename, "wb");
+        if (file != NULL) {
+            if (fwrite(writer.data, 1, writer.size, file) != writer.size) {
                 status = ERROR;
             }
-        }
-        if (status == OK) {
-            if (fputc(1, file) == EOF) {
+            if (fclose(file) != 0) {
                 status = ERROR;
             }
+        } else {
+            status = ERROR;
         }
-        if (status == OK) {
-            status = avrobin_write_long(file, 1);
-        }
-        if (status == OK) {
-            status = avrobin_write_string(file, "avro.schema");
-        }
-        if (status == OK) {
-            status = avrobin_write_string(file, schema);
-        }
-        if (status == OK) {
-            status = avrobin_write_long(file, 0);
-        }
-        if (status == OK) {
-            uint8_t *sync = NULL;
-            status = generate_sync(&sync);
-            if (status == OK) {
-                for (int i=0; i<16; i++) {
-                    if (status == OK) {
-                        if (fputc(sync[i], file) == EOF) {
-                            status = ERROR;
-                        }
-                    }
-                    if (status != OK) break;
-                }
-                if (status == OK) {
-                    status = avrobin_write_long(file, 1);
-                }
-                if (status == OK) {
-                    status = avrobin_write_long(file, serdatalen);
-                }
-                if (status == OK) {
-                    for (int i=0; i<serdatalen; i++) {
-                        if (status == OK) {
-                            if (fputc(serdata[i], file) == EOF) {
-                                status = ERROR;
-                            }
-                        }
-                        if (status != OK) break;
-                    }
-                }
-                for (int i=0; i<16; i++) {
-                    if (status == OK) {
-                        if (fputc(sync[i], file) == EOF) {
-                            status = ERROR;
-                        }
-                    }
-                    if (status != OK) break;
-                }
-
-                free(sync);
-            }
-        }
-
-        fclose(file);
-    } else {
-        status = ERROR;
     }
 
+    free(sync);
+    free(writer.data);
     return status;
 }
 
-static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **result) {
+static int avrobinSerializer_createType(dyn_type *type, avrobin_reader_t *reader, void **result) {
     int status = OK;
     void *inst = NULL;
 
@@ -228,7 +257,7 @@ static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **res
 
     if (status == OK) {
         assert(inst != NULL);
-        status = avrobinSerializer_parseAny(type, inst, stream);
+        status = avrobinSerializer_parseAny(type, inst, reader);
 
         if (status == OK) {
             *result = inst;
@@ -241,7 +270,7 @@ static int avrobinSerializer_createType(dyn_type *type, FILE *stream, void **res
     return status;
 }
 
-static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_parseAny(dyn_type *type, void *loc, avrobin_reader_t *reader) {
     int status = OK;
 
     dyn_type *subType = NULL;
@@ -270,118 +299,117 @@ static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream) {
     switch (c) {
         case 'Z' :
             z = loc;
-            status = avrobin_read_boolean(stream,&avro_boolean);
+            status = avrobin_read_boolean(reader,&avro_boolean);
             if (status == OK) {
                 *z = avro_boolean;
             }
             break;
         case 'F' :
             f = loc;
-            status = avrobin_read_float(stream,&avro_float);
+            status = avrobin_read_float(reader,&avro_float);
             if (status == OK) {
                 *f = avro_float;
             }
             break;
         case 'D' :
             d = loc;
-            status = avrobin_read_double(stream,&avro_double);
+            status = avrobin_read_double(reader,&avro_double);
             if (status == OK) {
                 *d = avro_double;
             }
             break;
         case 'N' :
             n = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *n = (int)avro_int;
             }
             break;
         case 'B' :
             b = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *b = (char)avro_int;
             }
             break;
         case 'S' :
             s = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *s = (int16_t)avro_int;
             }
             break;
         case 'I' :
             i = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *i = avro_int;
             }
             break;
         case 'J' :
             l = loc;
-            status = avrobin_read_long(stream,&avro_long);
+            status = avrobin_read_long(reader,&avro_long);
             if (status == OK) {
                 *l = avro_long;
             }
             break;
         case 'b' :
             ub = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *ub = (uint8_t)avro_int;
             }
             break;
         case 's' :
             us = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *us = (uint16_t)avro_int;
             }
             break;
         case 'i' :
             ui = loc;
-            status = avrobin_read_int(stream,&avro_int);
+            status = avrobin_read_int(reader,&avro_int);
             if (status == OK) {
                 *ui = (uint32_t)avro_int;
             }
             break;
         case 'j' :
             ul = loc;
-            status = avrobin_read_long(stream,&avro_long);
+            status = avrobin_read_long(reader,&avro_long);
             if (status == OK) {
                 *ul = (uint64_t)avro_long;
             }
             break;
         case 't' :
-            status = avrobin_read_string(stream,&avro_string);
+            status = avrobin_read_string(reader,&avro_string);
             if (status == OK) {
-                status = dynType_text_allocAndInit(type, loc, avro_string);
-                free(avro_string);
+                *(char**)loc = avro_string; //note same ownership as dynType_text_allocAndInit, without an extra copy
             }
             break;
         case '[' :
             if (status == OK) {
-                status = avrobinSerializer_parseSequence(type, loc, stream);
+                status = avrobinSerializer_parseSequence(type, loc, reader);
             }
             break;
         case '{' :
             if (status == OK) {
-                status = avrobinSerializer_parseComplex(type, loc, stream);
+                status = avrobinSerializer_parseComplex(type, loc, reader);
             }
             break;
         case '*' :
             status = dynType_typedPointer_getTypedType(type, &subType);
             if (status == OK) {
-                status = avrobinSerializer_createType(subType, stream, (void**)loc);
+                status = avrobinSerializer_createType(subType, reader, (void**)loc);
             }
             break;
         case 'E' :
             if (status == OK) {
-                status = avrobinSerializer_parseEnum(type, loc, stream);
+                status = avrobinSerializer_parseEnum(type, loc, reader);
             }
             break;
         case 'l':
-            status = avrobinSerializer_parseAny(type->ref.ref, loc, stream);
+            status = avrobinSerializer_parseAny(type->ref.ref, loc, reader);
             break;
         case 'P' :
             status = ERROR;
@@ -396,7 +424,7 @@ static int avrobinSerializer_parseAny(dyn_type *type, void *loc, FILE *stream) {
     return status;
 }
 
-static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, avrobin_reader_t *reader) {
     int status = OK;
 
     struct complex_type_entry *entry = NULL;
@@ -425,7 +453,7 @@ static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, FILE *strea
             }
 
             if (status == OK) {
-                status = avrobinSerializer_parseAny(subType, subLoc, stream);
+                status = avrobinSerializer_parseAny(subType, subLoc, reader);
             }
 
             if (status != OK) {
@@ -437,7 +465,86 @@ static int avrobinSerializer_parseComplex(dyn_type *type, void *loc, FILE *strea
     return status;
 }
 
-static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stream) {
+/**
+ * Returns whether the sequence items are encoded as their in memory representation (float and double on a
+ * little endian host).
+ */
+static bool avrobin_isRawItemType(dyn_type *itemType) {
+    char c = dynType_descriptorType(itemType);
+    return AVROBIN_LITTLE_ENDIAN_HOST && (c == 'F' || c == 'D');
+}
+
+static bool avrobin_isIntegerItemType(dyn_type *itemType) {
+    char c = dynType_descriptorType(itemType);
+    return c != '\0' && strchr("BSIJbsijN", c) != NULL;
+}
+
+static inline int64_t avrobin_integerItem(char descriptor, const void *buf, uint32_t index) {
+    switch (descriptor) {
+        case 'B' : return ((const char*)buf)[index];
+        case 'S' : return ((const int16_t*)buf)[index];
+        case 'I' : return ((const int32_t*)buf)[index];
+        case 'J' : return ((const int64_t*)buf)[index];
+        case 'b' : return (int32_t)((const uint8_t*)buf)[index];
+        case 's' : return (int32_t)((const uint16_t*)buf)[index];
+        case 'i' : return (int32_t)((const uint32_t*)buf)[index];
+        case 'j' : return (int64_t)((const uint64_t*)buf)[index];
+        default  : return ((const int*)buf)[index]; //N
+    }
+}
+
+/**
+ * Writes a sequence of integer items with a single reservation for the max encoded size.
+ * Returns false if the items are not integers or the writer cannot hold the max encoded size, in which case
+ * nothing is written.
+ */
+static bool avrobin_writeIntegerItems(avrobin_writer_t *writer, char descriptor, const void *buf, uint32_t len) {
+    if (strchr("BSIJbsijN", descriptor) == NULL || descriptor == '\0') {
+        return false;
+    }
+    uint8_t *dst = avrobin_writer_tryReserve(writer, (size_t)len * MAX_VARINT_BUF_SIZE);
+    if (dst == NULL) {
+        return false; //note the fallback writes (and counts) the exact size
+    }
+    size_t written = 0;
+    for (uint32_t i = 0; i < len; ++i) {
+        int64_t val = avrobin_integerItem(descriptor, buf, i);
+        written += avrobin_encode_varint(dst + written, ((uint64_t)val << 1) ^ (uint64_t)(val >> 63));
+    }
+    writer->size += written;
+    return true;
+}
+
+static inline void avrobin_setIntegerItem(char descriptor, void *buf, uint32_t index, int64_t val) {
+    switch (descriptor) {
+        case 'B' : ((char*)buf)[index] = (char)val; break;
+        case 'S' : ((int16_t*)buf)[index] = (int16_t)val; break;
+        case 'I' : ((int32_t*)buf)[index] = (int32_t)val; break;
+        case 'J' : ((int64_t*)buf)[index] = val; break;
+        case 'b' : ((uint8_t*)buf)[index] = (uint8_t)val; break;
+        case 's' : ((uint16_t*)buf)[index] = (uint16_t)val; break;
+        case 'i' : ((uint32_t*)buf)[index] = (uint32_t)val; break;
+        case 'j' : ((uint64_t*)buf)[index] = (uint64_t)val; break;
+        default  : ((int*)buf)[index] = (int)val; break; //N
+    }
+}
+
+/**
+ * Reads count integer items directly into the (already reserved) sequence buffer.
+ */
+static int avrobin_parseIntegerItems(avrobin_reader_t *reader, char descriptor, struct generic_sequence *seq, int64_t count) {
+    for (int64_t i = 0; i < count; ++i) {
+        int64_t val;
+        if (avrobin_read_long(reader, &val) != OK) {
+            return ERROR;
+        }
+        avrobin_setIntegerItem(descriptor, seq->buf, seq->len, val);
+        seq->len += 1;
+    }
+    return OK;
+}
+
+static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, avrobin_reader_t *reader) {
     /* Avro 1.8.1 Specification
      * Arrays
      * Arrays are encoded as a series of blocks. Each block consists of a long count value, followed by that many array items. A block with count zero indicates the end of the array. Each item is encoded per the array's item schema.
@@ -459,7 +566,7 @@ static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stre
     int64_t blockSize = 0;
 
     do {
-        status = avrobin_read_long(stream, &blockCount);
+        status = avrobin_read_long(reader, &blockCount);
         if (status != OK) {
             break;
         } else if (blockCount < 0) {
@@ -476,13 +583,30 @@ static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stre
             LOG_DEBUG("Parsing block count of %li", blockCount);
             cap += blockCount;
             dynType_sequence_reserve(type, loc, cap);
-            for (int64_t i = 0; i < blockCount; ++i) {
-                void* itemLoc = NULL;
-                status = dynType_sequence_increaseLengthAndReturnLastLoc(type, loc, &itemLoc);
-                if (status != OK) {
-                    break;
+            struct generic_sequence *seq = loc;
+            if (seq->cap < cap) {
+                status = ERROR;
+                break;
+            }
+            if (avrobin_isRawItemType(itemType)) {
+                //note float and double items are stored as is, so the whole block can be copied
+                status = avrobin_read_bytes(reader, (uint8_t*)seq->buf + seq->len * itemSize, (size_t)blockCount * itemSize);
+                if (status == OK) {
+                    seq->len += (uint32_t)blockCount;
+                }
+            } else if (avrobin_isIntegerItemType(itemType)) {
+                status = avrobin_parseIntegerItems(reader, dynType_descriptorType(itemType), seq, blockCount);
+            } else {
+                for (int64_t i = 0; i < blockCount; ++i) {
+                    void* itemLoc = NULL;
+                    status = dynType_sequence_increaseLengthAndReturnLastLoc(type, loc, &itemLoc);
+                    if (status == OK) {
+                        status = avrobinSerializer_parseAny(itemType, itemLoc, reader);
+                    }
+                    if (status != OK) {
+                        break;
+                    }
                 }
-                avrobinSerializer_parseAny(itemType, itemLoc, stream);
             }
             if (status != OK) {
                 break;
@@ -496,9 +620,9 @@ static int avrobinSerializer_parseSequence(dyn_type *type, void *loc, FILE *stre
     return status;
 }
 
-static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, avrobin_reader_t *reader) {
     int32_t index;
-    if (avrobin_read_int(stream, &index) != OK) {
+    if (avrobin_read_int(reader, &index) != OK) {
         return ERROR;
     }
     if (index < 0) {
@@ -519,7 +643,7 @@ static int avrobinSerializer_parseEnum(dyn_type *type, void *loc, FILE *stream)
     return ERROR;
 }
 
-static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeAny(dyn_type *type, void *loc, avrobin_writer_t *writer) {
     int status = OK;
 
     int descriptor = dynType_descriptorType(type);
@@ -541,72 +665,72 @@ static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream) {
     switch (descriptor) {
         case 'Z' :
             z = loc;
-            status = avrobin_write_boolean(stream,*z);
+            status = avrobin_write_boolean(writer,*z);
             break;
         case 'B' :
             b = loc;
-            status = avrobin_write_int(stream,(int32_t)*b);
+            status = avrobin_write_int(writer,(int32_t)*b);
             break;
         case 'S' :
             s = loc;
-            status = avrobin_write_int(stream,(int32_t)*s);
+            status = avrobin_write_int(writer,(int32_t)*s);
             break;
         case 'I' :
             i = loc;
-            status = avrobin_write_int(stream,*i);
+            status = avrobin_write_int(writer,*i);
             break;
         case 'J' :
             l = loc;
-            status = avrobin_write_long(stream,*l);
+            status = avrobin_write_long(writer,*l);
             break;
         case 'b' :
             ub = loc;
-            status = avrobin_write_int(stream,(int32_t)*ub);
+            status = avrobin_write_int(writer,(int32_t)*ub);
             break;
         case 's' :
             us = loc;
-            status = avrobin_write_int(stream,(int32_t)*us);
+            status = avrobin_write_int(writer,(int32_t)*us);
             break;
         case 'i' :
             ui = loc;
-            status = avrobin_write_int(stream,(int32_t)*ui);
+            status = avrobin_write_int(writer,(int32_t)*ui);
             break;
         case 'j' :
             ul = loc;
-            status = avrobin_write_long(stream,(int64_t)*ul);
+            status = avrobin_write_long(writer,(int64_t)*ul);
             break;
         case 'N' :
             n = loc;
-            status = avrobin_write_int(stream,(int32_t)*n);
+            status = avrobin_write_int(writer,(int32_t)*n);
             break;
         case 'F' :
             f = loc;
-            status = avrobin_write_float(stream,*f);
+            status = avrobin_write_float(writer,*f);
             break;
         case 'D' :
             d = loc;
-            status = avrobin_write_double(stream,*d);
+            status = avrobin_write_double(writer,*d);
             break;
         case 't' :
-            status = avrobin_write_string(stream,*(const char**)loc);
+            status = avrobin_write_string(writer,*(const char**)loc);
             break;
         case '*' :
             status = dynType_typedPointer_getTypedType(type, &subType);
             if (status == OK) {
-                status = avrobinSerializer_writeAny(subType, *(void**)loc, stream);
+                status = avrobinSerializer_writeAny(subType, *(void**)loc, writer);
             }
             break;
         case '{' :
-            status = avrobinSerializer_writeComplex(type, loc, stream);
+            status = avrobinSerializer_writeComplex(type, loc, writer);
             break;
         case '[' :
-            status = avrobinSerializer_writeSequence(type, loc, stream);
+            status = avrobinSerializer_writeSequence(type, loc, writer);
             break;
         case 'E' :
-            status = avrobinSerializer_writeEnum(type, loc, stream);
+            status = avrobinSerializer_writeEnum(type, loc, writer);
             break;
         case 'l':
-            status = avrobinSerializer_writeAny(type->ref.ref, loc, stream);
+            status = avrobinSerializer_writeAny(type->ref.ref, loc, writer);
             break;
         case 'P' :
             status = ERROR;
@@ -621,7 +745,7 @@ static int avrobinSerializer_writeAny(dyn_type *type, void *loc, FILE *stream) {
     return status;
 }
 
-static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, avrobin_writer_t *writer) {
     int status = OK;
 
     struct complex_type_entry *entry = NULL;
@@ -650,7 +774,7 @@ static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, FILE *strea
             }
 
             if (status == OK) {
-                status = avrobinSerializer_writeAny(subType, subLoc, stream);
+                status = avrobinSerializer_writeAny(subType, subLoc, writer);
             }
 
             if (status != OK) {
@@ -662,27 +786,38 @@ static int avrobinSerializer_writeComplex(dyn_type *type, void *loc, FILE *strea
     return status;
 }
 
-static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, avrobin_writer_t *writer) {
     uint32_t arrayLen = dynType_sequence_length(loc);
 
     dyn_type *itemType = dynType_sequence_itemType(type);
     void *itemLoc = NULL;
 
-    if (avrobin_write_long(stream, arrayLen) != OK) {
-        LOG_ERROR("Failed to write array block count.");
-        return ERROR;
-    }
-
-    for (int i=0; i<arrayLen; i++) {
-        if (dynType_sequence_locForIndex(type, loc, i, &itemLoc)) {
+    if (arrayLen > 0) {
+        if (avrobin_write_long(writer, arrayLen) != OK) {
+            LOG_ERROR("Failed to write array block count.");
             return ERROR;
         }
-        if (avrobinSerializer_writeAny(itemType, itemLoc, stream) != OK) {
-            return ERROR;
+
+        struct generic_sequence *seq = loc;
+        if (avrobin_isRawItemType(itemType)) {
+            //note float and double items are encoded as is, so the whole block can be copied
+            if (avrobin_write_bytes(writer, seq->buf, (size_t)arrayLen * dynType_size(itemType)) != OK) {
+                return ERROR;
+            }
+        } else if (!avrobin_writeIntegerItems(writer, dynType_descriptorType(itemType), seq->buf, arrayLen)) {
+            for (int i=0; i<arrayLen; i++) {
+                if (dynType_sequence_locForIndex(type, loc, i, &itemLoc)) {
+                    return ERROR;
+                }
+                if (avrobinSerializer_writeAny(itemType, itemLoc, writer) != OK) {
+                    return ERROR;
+                }
+            }
         }
     }
 
-    if (avrobin_write_long(stream, 0) != OK) {
+    //note a single zero count for an empty array, a second zero would be read as the next field
+    if (avrobin_write_long(writer, 0) != OK) {
         LOG_ERROR("Failed to write array block count.");
         return ERROR;
     }
@@ -690,7 +825,7 @@ static int avrobinSerializer_writeSequence(dyn_type *type, void *loc, FILE *stre
     return OK;
 }
 
-static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, FILE *stream) {
+static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, avrobin_writer_t *writer) {
     char enum_value_str[16];
     int rc = snprintf(enum_value_str, sizeof(enum_value_str), "%d", *(int32_t*)loc);
     if (rc >= sizeof(enum_value_str) || rc < 0) {
@@ -702,7 +837,7 @@ static int avrobinSerializer_writeEnum(dyn_type *type, void *loc, FILE *stream)
 
     TAILQ_FOREACH(entry, &type->metaProperties, entries) {
         if (0 == strcmp(enum_value_str, entry->value)) {
-            return avrobin_write_int(stream, index);
+            return avrobin_write_int(writer, index);
         }
         index++;
     }
@@ -1119,66 +1254,125 @@ static int generate_record_name(char **result) {
     return OK;
 }
 
-static int avrobin_read_boolean(FILE *stream,bool *val) {
-    int c = fgetc(stream);
-    if (c == EOF) {
-        LOG_ERROR("Unexpected end of file.");
+static void avrobin_reader_init(avrobin_reader_t *reader, const struct iovec *input, size_t inputIovLen) {
+    reader->pos = NULL;
+    reader->end = NULL;
+    reader->iov = input;
+    reader->iovLen = inputIovLen;
+}
+
+/**
+ * Moves the reader to the next non empty iovec. Returns false if there is no more input.
+ */
+static bool avrobin_reader_next(avrobin_reader_t *reader) {
+    while (reader->iovLen > 0) {
+        const struct iovec *iov = reader->iov;
+        reader->iov += 1;
+        reader->iovLen -= 1;
+        if (iov->iov_len > 0) {
+            reader->pos = iov->iov_base;
+            reader->end = reader->pos + iov->iov_len;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int avrobin_read_byte(avrobin_reader_t *reader, uint8_t *val) {
+    if (reader->pos == reader->end && !avrobin_reader_next(reader)) {
+        LOG_ERROR("Unexpected end of input.");
+        return ERROR;
+    }
+    *val = *reader->pos++;
+    return OK;
+}
+
+static int avrobin_read_bytes(avrobin_reader_t *reader, void *dst, size_t len) {
+    uint8_t *out = dst;
+    while (len > 0) {
+        if (reader->pos == reader->end && !avrobin_reader_next(reader)) {
+            LOG_ERROR("Unexpected end of input.");
+            return ERROR;
+        }
+        size_t available = (size_t)(reader->end - reader->pos);
+        size_t n = available < len ? available : len;
+        memcpy(out, reader->pos, n);
+        reader->pos += n;
+        out += n;
+        len -= n;
+    }
+    return OK;
+}
+
+static int avrobin_read_boolean(avrobin_reader_t *reader,bool *val) {
+    uint8_t c;
+    if (avrobin_read_byte(reader, &c) != OK) {
         return ERROR;
     }
     if (c!=0 && c!=1) {
         LOG_ERROR("Unexpected value for boolean.");
         return ERROR;
     }
-    if (c == 0) {
-        *val = false;
-    } else {
-        *val = true;
-    }
+    *val = c == 1;
     return OK;
 }
 
-static int avrobin_read_int(FILE *stream,int32_t *val) {
+static int avrobin_read_int(avrobin_reader_t *reader,int32_t *val) {
     int64_t lval;
-    int status = avrobin_read_long(stream,&lval);
+    int status = avrobin_read_long(reader,&lval);
     //TODO Do range check.
     *val = (int32_t)lval;
     return status;
 }
 
-static int avrobin_read_long(FILE *stream,int64_t *val) {
+static int avrobin_read_varint_slow(avrobin_reader_t *reader, uint64_t *val) {
     uint64_t uval = 0;
     uint8_t b;
-    int c;
     int offset = 0;
     do {
         if (offset == MAX_VARINT_BUF_SIZE) {
             LOG_ERROR("Varint too long.");
             return ERROR;
         }
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
+        if (avrobin_read_byte(reader, &b) != OK) {
             return ERROR;
         }
-        b = (uint8_t)c;
         uval |= (uint64_t) (b & 0x7F) << (7 * offset);
         ++offset;
     }
     while (b & 0x80);
-    *val = ((uval >> 1) ^ -(uval & 1));
+    *val = uval;
     return OK;
 }
 
-static int avrobin_read_float(FILE *stream,float *val) {
+static inline int avrobin_read_long(avrobin_reader_t *reader,int64_t *val) {
+    uint64_t uval = 0;
+    if (reader->end - reader->pos >= MAX_VARINT_BUF_SIZE) {
+        //fast path, the max varint size is available in the current buffer
+        const uint8_t *p = reader->pos;
+        uint8_t b;
+        int offset = 0;
+        do {
+            if (offset == MAX_VARINT_BUF_SIZE) {
+                LOG_ERROR("Varint too long.");
+                return ERROR;
+            }
+            b = p[offset];
+            uval |= (uint64_t) (b & 0x7F) << (7 * offset);
+            ++offset;
+        } while (b & 0x80);
+        reader->pos += offset;
+    } else if (avrobin_read_varint_slow(reader, &uval) != OK) {
+        return ERROR;
+    }
+    *val = (int64_t)((uval >> 1) ^ -(uval & 1));
+    return OK;
+}
+
+static int avrobin_read_float(avrobin_reader_t *reader,float *val) {
     uint8_t b[4];
-    int c;
-    for (int i=0;i<4;i++) {
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
-            return ERROR;
-        }
-        b[i] = (uint8_t)c;
+    if (avrobin_read_bytes(reader, b, sizeof(b)) != OK) {
+        return ERROR;
     }
     union {
         float f;
@@ -1193,16 +1387,10 @@ static int avrobin_read_float(FILE *stream,float *val) {
     return OK;
 }
 
-static int avrobin_read_double(FILE *stream,double *val) {
+static int avrobin_read_double(avrobin_reader_t *reader,double *val) {
     uint8_t b[8];
-    int c;
-    for (int i=0;i<8;i++) {
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
-            return ERROR;
-        }
-        b[i] = (uint8_t)c;
+    if (avrobin_read_bytes(reader, b, sizeof(b)) != OK) {
+        return ERROR;
     }
     union {
         double d;
@@ -1221,9 +1409,9 @@ static int avrobin_read_double(FILE *stream,double *val) {
     return OK;
 }
 
-static int avrobin_read_string(FILE *stream,char **val) {
+static int avrobin_read_string(avrobin_reader_t *reader,char **val) {
     int64_t len;
-    if (avrobin_read_long(stream,&len) != OK) {
+    if (avrobin_read_long(reader,&len) != OK) {
         LOG_ERROR("Failed to read string length.");
         return ERROR;
     }
@@ -1236,58 +1424,102 @@ static int avrobin_read_string(FILE *stream,char **val) {
         LOG_ERROR("Failed to allocate memory for avro string.");
         return ERROR;
     }
-    int c;
-    for (int64_t i=0;i<len;i++) {
-        c = fgetc(stream);
-        if (c == EOF) {
-            LOG_ERROR("Unexpected end of file.");
-            free(*val);
-            return ERROR;
-        }
-        (*val)[i] = (char)c;
+    if (avrobin_read_bytes(reader, *val, (size_t)len) != OK) {
+        free(*val);
+        return ERROR;
     }
     (*val)[len] = '\0';
     return OK;
 }
 
-static int avrobin_write_boolean(FILE *stream,bool val) {
-    int r;
-    if (val) {
-        r = fputc(1, stream);
-    } else {
-        r = fputc(0, stream);
+/**
+ * Grows the writer buffer so that len bytes can be written. For a caller provided buffer, this marks the
+ * writer as overflowed and returns NULL.
+ */
+static uint8_t* avrobin_writer_grow(avrobin_writer_t *writer, size_t len) {
+    if (!writer->growable) {
+        writer->overflow = true;
+        return NULL;
+    }
+    size_t newCapacity = writer->capacity == 0 ? INITIAL_WRITE_BUFFER_SIZE : writer->capacity * 2;
+    while (newCapacity < writer->size + len) {
+        newCapacity *= 2;
+    }
+    uint8_t *data = realloc(writer->data, newCapacity);
+    if (data == NULL) {
+        LOG_ERROR("Failed to allocate memory for avrobin output.");
+        return NULL;
+    }
+    writer->data = data;
+    writer->capacity = newCapacity;
+    return writer->data + writer->size;
+}
+
+/**
+ * Returns the location to write len bytes to or NULL if the writer cannot hold len more bytes.
+ */
+static inline uint8_t* avrobin_writer_reserve(avrobin_writer_t *writer, size_t len) {
+    if (writer->size + len <= writer->capacity) {
+        return writer->data + writer->size;
+    }
+    return avrobin_writer_grow(writer, len);
+}
+
+/**
+ * Like avrobin_writer_reserve, but a caller provided buffer which is too small is not marked as overflowed.
+ * Used to reserve an upper bound of the size to write.
+ */
+static inline uint8_t* avrobin_writer_tryReserve(avrobin_writer_t *writer, size_t len) {
+    if (writer->size + len <= writer->capacity) {
+        return writer->data + writer->size;
     }
-    if (r == EOF) {
-        LOG_ERROR("Write error.");
+    return writer->growable ? avrobin_writer_grow(writer, len) : NULL;
+}
+
+static int avrobin_write_bytes(avrobin_writer_t *writer, const void *src, size_t len) {
+    uint8_t *dst = avrobin_writer_reserve(writer, len);
+    if (dst != NULL) {
+        memcpy(dst, src, len);
+    } else if (!writer->overflow) {
         return ERROR;
     }
+    writer->size += len;
     return OK;
 }
 
-static int avrobin_write_int(FILE *stream,int32_t val) {
+static inline size_t avrobin_encode_varint(uint8_t *dst, uint64_t uval) {
+    size_t n = 0;
+    while (uval & ~0x7FULL) {
+        dst[n++] = (uint8_t)((uval & 0x7F) | 0x80);
+        uval >>= 7;
+    }
+    dst[n++] = (uint8_t)uval;
+    return n;
+}
+
+static int avrobin_write_boolean(avrobin_writer_t *writer,bool val) {
+    uint8_t b = val ? 1 : 0;
+    return avrobin_write_bytes(writer, &b, 1);
+}
+
+static int avrobin_write_int(avrobin_writer_t *writer,int32_t val) {
     int64_t lval = val;
-    return avrobin_write_long(stream,lval);
+    return avrobin_write_long(writer,lval);
 }
 
-static int avrobin_write_long(FILE *stream,int64_t val) {
-    uint64_t uval = (val << 1) ^ (val >> 63);
-    uint8_t b[MAX_VARINT_BUF_SIZE];
-    int bytes_written = 0;
-    while (uval & ~0x7F) {
-        b[bytes_written++] = (uint8_t)((uval & 0x7F) | 0x80);
-        uval >>= 7;
+static inline int avrobin_write_long(avrobin_writer_t *writer,int64_t val) {
+    uint64_t uval = ((uint64_t)val << 1) ^ (uint64_t)(val >> 63);
+    uint8_t *dst = avrobin_writer_tryReserve(writer, MAX_VARINT_BUF_SIZE);
+    if (dst != NULL) {
+        writer->size += avrobin_encode_varint(dst, uval);
+        return OK;
     }
-    b[bytes_written++] = (uint8_t)uval;
-    for (int i=0;i<bytes_written;i++) {
-        if (fputc(b[i],stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    //note not enough room for the max varint size, write the exact encoded size
+    uint8_t b[MAX_VARINT_BUF_SIZE];
+    return avrobin_write_bytes(writer, b, avrobin_encode_varint(b, uval));
 }
 
-static int avrobin_write_float(FILE *stream,float val) {
+static int avrobin_write_float(avrobin_writer_t *writer,float val) {
     uint8_t b[4];
     union {
         float f;
@@ -1298,16 +1530,10 @@ static int avrobin_write_float(FILE *stream,float val) {
     b[1] = (uint8_t)((v.i & 0x0000FF00) >> 8);
     b[2] = (uint8_t)((v.i & 0x00FF0000) >> 16);
     b[3] = (uint8_t)((v.i & 0xFF000000) >> 24);
-    for (int i=0;i<4;i++) {
-        if (fputc(b[i],stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, b, sizeof(b));
 }
 
-static int avrobin_write_double(FILE *stream,double val) {
+static int avrobin_write_double(avrobin_writer_t *writer,double val) {
     uint8_t b[8];
     union {
         double d;
@@ -1322,29 +1548,17 @@ static int avrobin_write_double(FILE *stream,double val) {
     b[5] = (uint8_t)((v.i & 0x0000FF0000000000) >> 40);
     b[6] = (uint8_t)((v.i & 0x00FF000000000000) >> 48);
     b[7] = (uint8_t)((v.i & 0xFF00000000000000) >> 56);
-    for (int i=0;i<8;i++) {
-        if (fputc(b[i],stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, b, sizeof(b));
 }
 
-static int avrobin_write_string(FILE *stream,const char *val) {
+static int avrobin_write_string(avrobin_writer_t *writer,const char *val) {
     assert(val != NULL);
     size_t len = strlen(val);
-    if (avrobin_write_long(stream, (int64_t)len) != OK) {
+    if (avrobin_write_long(writer, (int64_t)len) != OK) {
         LOG_ERROR("Failed to write string length.");
         return ERROR;
     }
-    for (size_t i=0;i<len;i++) {
-        if (fputc((unsigned char)(val[i]),stream) == EOF) {
-            LOG_ERROR("Write error.");
-            return ERROR;
-        }
-    }
-    return OK;
+    return avrobin_write_bytes(writer, val, len);
 }
 
 static int avrobin_schema_primitive(const char *tname, json_t **output) {
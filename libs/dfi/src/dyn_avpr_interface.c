@@ -103,6 +103,7 @@ dyn_interface_type * dynInterface_parseAvpr(FILE * avprStream) {
     valid = valid && dynAvprInterface_createMethods(intf, root, parent_ns);
 
     valid = valid && 0 == dynInterface_checkInterface(intf);
+    valid = valid && 0 == dynInterface_buildMethodIndex(intf);
 
     json_decref(root);
     if (valid) {
@@ -71,6 +71,10 @@ int dynInterface_parse(FILE *descriptor, dyn_interface_type **out) {
             status = dynInterface_checkInterface(intf);
         }
 
+        if (status == OK) {
+            status = dynInterface_buildMethodIndex(intf);
+        }
+
         if (status == OK) { /* We are sure that version field is present in the header */
         	char* version = NULL;
             dynInterface_getVersionString(intf,&version);
@@ -348,6 +352,7 @@ void dynInterface_destroy(dyn_interface_type *intf) {
         dynCommon_clearNamValHead(&intf->header);
         dynCommon_clearNamValHead(&intf->annotations);
 
+        celix_stringHashMap_destroy(intf->methodIndex);
         struct method_entry *mInfo = TAILQ_FIRST(&intf->methods);
         while (mInfo != NULL) {
             struct method_entry *mTmp = mInfo;
@@ -430,6 +435,35 @@ int dynInterface_methods(dyn_interface_type *intf, struct methods_head **list) {
     return status;
 }
 
+int dynInterface_buildMethodIndex(dyn_interface_type *intf) {
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.storeKeysWeakly = true; //note keys are owned by the method entries
+    intf->methodIndex = celix_stringHashMap_createWithOptions(&opts);
+    if (intf->methodIndex == NULL) {
+        LOG_ERROR("Error allocating memory for method index");
+        return ERROR;
+    }
+    struct method_entry *entry = NULL;
+    TAILQ_FOREACH(entry, &intf->methods, entries) {
+        if (celix_stringHashMap_hasKey(intf->methodIndex, entry->id)) {
+            //note keep the first parsed method, as the previous linear search did
+            LOG_WARNING("Duplicate method id '%s', using the first parsed method", entry->id);
+        } else {
+            celix_stringHashMap_put(intf->methodIndex, entry->id, entry);
+        }
+    }
+    return OK;
+}
+
+int dynInterface_findMethod(dyn_interface_type *intf, const char *id, struct method_entry **entry) {
+    struct method_entry *found = intf->methodIndex != NULL ? celix_stringHashMap_get(intf->methodIndex, id) : NULL;
+    if (found == NULL) {
+        return ERROR;
+    }
+    *entry = found;
+    return OK;
+}
+
 int dynInterface_nrOfMethods(dyn_interface_type *intf) {
     int count = 0;
     struct method_entry *entry = NULL;
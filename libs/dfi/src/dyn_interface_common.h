@@ -27,6 +27,7 @@
 #include <ffi.h>
 
 #include "dyn_common.h"
+#include "celix_string_hash_map.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,9 +38,15 @@ struct _dyn_interface_type {
     struct namvals_head annotations;
     struct types_head types;
     struct methods_head methods;
+    celix_string_hash_map_t* methodIndex; //key = method id, value = struct method_entry*
     celix_version_t* version;
 };
 
+/**
+ * Builds the index from method id to method entry. Called when all methods of the interface are parsed.
+ */
+int dynInterface_buildMethodIndex(dyn_interface_type *intf);
+
 #ifdef __cplusplus
 }
 #endif
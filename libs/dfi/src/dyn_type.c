@@ -71,17 +71,10 @@ static void dynType_printSimpleType(dyn_type *type, FILE *stream);
 static int dynType_parseText(FILE *stream, dyn_type *type);
 static int dynType_parseEnum(FILE *stream, dyn_type *type);
 void dynType_freeComplexType(dyn_type *type, void *loc);
-void dynType_deepFree(dyn_type *type, void *loc, bool alsoDeleteSelf);
 void dynType_freeSequenceType(dyn_type *type, void *seqLoc);
 
 static int dynType_parseMetaInfo(FILE *stream, dyn_type *type);
 
-struct generic_sequence {
-    uint32_t cap;
-    uint32_t len;
-    void *buf;
-};
-
 int dynType_parse(FILE *descriptorStream, const char *name, struct types_head *refTypes, dyn_type **type) {
     return dynType_parseWithStream(descriptorStream, name, NULL, refTypes, type);
 }
@@ -61,9 +61,22 @@ struct _dyn_type {
     };
 };
 
+/**
+ * Memory layout of a sequence instance (descriptor '[').
+ */
+struct generic_sequence {
+    uint32_t cap;
+    uint32_t len;
+    void *buf;
+};
+
 dyn_type * dynType_findType(dyn_type *type, char *name);
 ffi_type * dynType_ffiType(dyn_type * type);
 void dynType_prepCif(ffi_type *type);
+/**
+ * Frees the memory referenced by the instance at loc and, if alsoDeleteSelf, the instance itself.
+ */
+void dynType_deepFree(dyn_type *type, void *loc, bool alsoDeleteSelf);
 
 #ifdef __cplusplus
 }
@@ -24,9 +24,13 @@
 #include <jansson.h>
 #include <assert.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ffi.h>
 #include "dyn_type_common.h"
+#include "json_serializer_common.h"
+
+#define METHOD_ID_BUFFER_SIZE 256
 
 static int OK = 0;
 static int ERROR = 1;
@@ -40,45 +44,170 @@ struct generic_service_layout {
 	gen_func_type methods[];
 };
 
-int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, char **out) {
+/**
+ * Reads the method id string and looks up the method entry in the method index of the interface.
+ */
+static int jsonRpc_readMethod(dyn_interface_type *intf, json_serializer_reader_t *reader, struct method_entry **method) {
+	const char *str = NULL;
+	size_t len = 0;
+	char *decoded = NULL;
+	int status = jsonReader_readString(reader, &str, &len, &decoded);
+
+	char buffer[METHOD_ID_BUFFER_SIZE];
+	char *id = decoded;
+	if (status == OK && id == NULL) {
+		//note the id references the request, copy it to get a null terminated string
+		id = len < sizeof(buffer) ? buffer : malloc(len + 1);
+		if (id != NULL) {
+			memcpy(id, str, len);
+			id[len] = '\0';
+		} else {
+			status = ERROR;
+			LOG_ERROR("Cannot allocate memory for method id");
+		}
+	}
+
+	if (status == OK) {
+		LOG_DEBUG("Looking for method %s\n", id);
+		if (dynInterface_findMethod(intf, id, method) != OK) {
+			status = ERROR;
+			LOG_ERROR("Cannot find method with sig '%s'", id);
+		}
+	}
+
+	if (id != buffer) {
+		free(id);
+	}
+	return status;
+}
+
+/**
+ * Reads the members of the request object. If the method is known when the arguments member is reached, the reader
+ * is left at the arguments value, so that the arguments can be read directly into the argument memory.
+ * Otherwise the position of the arguments is remembered, the arguments are skipped and read after the method is known.
+ */
+static int jsonRpc_readMembers(dyn_interface_type *intf, json_serializer_reader_t *reader, int *nrOfMembers,
+							   struct method_entry **method, const char **arguments, bool *atArguments) {
 	int status = OK;
+	*atArguments = false;
+	while (status == OK && jsonReader_peek(reader) != '}') {
+		if (*nrOfMembers > 0) {
+			status = jsonReader_expect(reader, ',');
+		}
+		*nrOfMembers += 1;
 
-	dyn_type* returnType = NULL;
+		const char *key = NULL;
+		size_t keyLen = 0;
+		char *decoded = NULL;
+		if (status == OK) {
+			status = jsonReader_readString(reader, &key, &keyLen, &decoded);
+		}
+		if (status == OK) {
+			status = jsonReader_expect(reader, ':');
+		}
 
-	LOG_DEBUG("Parsing data: %s\n", request);
-	json_error_t error;
-	json_t *js_request = json_loads(request, 0, &error);
-	json_t *arguments = NULL;
-	const char *sig;
-	if (js_request) {
-		if (json_unpack(js_request, "{s:s}", "m", &sig) != 0) {
-			LOG_ERROR("Got json error '%s'\n", error.text);
+		if (status != OK) {
+			//nop
+		} else if (keyLen == 1 && key[0] == 'm') {
+			if (*method != NULL) {
+				status = ERROR;
+				jsonReader_error(reader, "duplicate method id");
+			} else {
+				status = jsonRpc_readMethod(intf, reader, method);
+			}
+		} else if (keyLen == 1 && key[0] == 'a') {
+			jsonReader_peek(reader);
+			*arguments = reader->pos;
+			if (*method != NULL) {
+				*atArguments = true;
+				free(decoded);
+				break;
+			}
+			status = jsonReader_skipValue(reader);
 		} else {
-			arguments = json_object_get(js_request, "a");
+			status = jsonReader_skipValue(reader);
 		}
-	} else {
-		LOG_ERROR("Got json error '%s' for '%s'\n", error.text, request);
-		return 0;
+		free(decoded);
 	}
+	return status;
+}
 
-	LOG_DEBUG("Looking for method %s\n", sig);
-	struct methods_head *methods = NULL;
-	dynInterface_methods(intf, &methods);
-	struct method_entry *entry = NULL;
-	struct method_entry *method = NULL;
-	TAILQ_FOREACH(entry, methods, entries) {
-		if (strcmp(sig, entry->id) == 0) {
-			method = entry;
-			break;
+/**
+ * Reads the standard (input) arguments from the arguments array. Superfluous array items are ignored.
+ */
+static int jsonRpc_readArguments(dyn_function_type *func, json_serializer_reader_t *reader, void *args[]) {
+	int status = jsonReader_expect(reader, '[');
+	int nrOfArgs = dynFunction_nrOfArguments(func);
+	int nrOfItems = 0;
+	for (int i = 0; i < nrOfArgs && status == OK; ++i) {
+		if (dynFunction_argumentMetaForIndex(func, i) != DYN_FUNCTION_ARGUMENT_META__STD) {
+			continue;
+		}
+		if (nrOfItems++ > 0) {
+			status = jsonReader_expect(reader, ',');
+		}
+		if (status == OK && jsonReader_peek(reader) == ']') {
+			status = ERROR;
+			jsonReader_error(reader, "missing argument");
+		}
+		if (status == OK) {
+			status = jsonSerializer_readType(dynFunction_argumentTypeForIndex(func, i), reader, &args[i]);
+		}
+	}
+	while (status == OK && jsonReader_peek(reader) != ']') {
+		if (nrOfItems++ > 0) {
+			status = jsonReader_expect(reader, ',');
+		}
+		if (status == OK) {
+			status = jsonReader_skipValue(reader);
 		}
 	}
+	if (status == OK) {
+		status = jsonReader_expect(reader, ']');
+	}
+	return status;
+}
+
+/**
+ * Writes the result member, a result of a previous output argument is overwritten.
+ * A value left out by the serializer (e.g. a NULL string) results in no result member.
+ */
+static int jsonRpc_writeResult(json_serializer_writer_t *writer, size_t resultMark, dyn_type *type, void *input) {
+	writer->size = resultMark;
+	int status = jsonWriter_write(writer, "\"r\":", 4);
+	size_t valueMark = writer->size;
+	if (status == OK) {
+		status = jsonSerializer_streamAny(type, input, writer);
+	}
+	if (status == OK && writer->size == valueMark) {
+		writer->size = resultMark;
+	}
+	return status;
+}
+
+int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, char **out) {
+	int status = OK;
 
-	if (method == NULL) {
+	LOG_DEBUG("Parsing data: %s\n", request);
+	json_serializer_reader_t reader;
+	jsonReader_init(&reader, request, strlen(request));
+
+	struct method_entry *method = NULL;
+	const char *arguments = NULL;
+	bool atArguments = false;
+	int nrOfMembers = 0;
+	status = jsonReader_expect(&reader, '{');
+	if (status == OK) {
+		status = jsonRpc_readMembers(intf, &reader, &nrOfMembers, &method, &arguments, &atArguments);
+	}
+	if (status == OK && method == NULL) {
 		status = ERROR;
-		LOG_ERROR("Cannot find method with sig '%s'", sig);
+		LOG_ERROR("No method id in request '%s'", request);
 	}
-	else if (status == OK) {
-		LOG_DEBUG("RSA: found method '%s'\n", entry->id);
+
+	dyn_type* returnType = NULL;
+	if (status == OK) {
+		LOG_DEBUG("RSA: found method '%s'\n", method->id);
 		returnType = dynFunction_returnType(method->dynFunc);
 	}
 
@@ -93,30 +222,49 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 	dyn_function_type *func = NULL;
 	int nrOfArgs = 0;
 	if (status == OK) {
-		nrOfArgs = dynFunction_nrOfArguments(entry->dynFunc);
-		func = entry->dynFunc;
+		nrOfArgs = dynFunction_nrOfArguments(method->dynFunc);
+		func = method->dynFunc;
 	}
 
-	void *args[nrOfArgs];
-
-	json_t *value = NULL;
+	void *args[nrOfArgs > 0 ? nrOfArgs : 1];
+	memset(args, 0, sizeof(args));
 
 	int i;
-	int index = 0;
-
 	void *ptr = NULL;
 	void *ptrToPtr = &ptr;
 
-	//setup and deserialize input
-	for (i = 0; i < nrOfArgs; ++i) {
+	//deserialize input directly from the request
+	if (status == OK && atArguments) {
+		status = jsonRpc_readArguments(func, &reader, args);
+		if (status == OK) {
+			status = jsonRpc_readMembers(intf, &reader, &nrOfMembers, &method, &arguments, &atArguments);
+		}
+	} else if (status == OK && arguments != NULL) {
+		json_serializer_reader_t argReader;
+		jsonReader_init(&argReader, arguments, (size_t)(reader.end - arguments));
+		status = jsonRpc_readArguments(func, &argReader, args);
+	} else if (status == OK) {
+		for (i = 0; i < nrOfArgs; ++i) {
+			if (dynFunction_argumentMetaForIndex(func, i) == DYN_FUNCTION_ARGUMENT_META__STD) {
+				status = ERROR;
+				LOG_ERROR("No arguments in request '%s'", request);
+				break;
+			}
+		}
+	}
+	if (status == OK) {
+		status = jsonReader_expect(&reader, '}');
+	}
+	if (status == OK && jsonReader_peek(&reader) != EOF) {
+		status = ERROR;
+		jsonReader_error(&reader, "end of input expected");
+	}
+
+	//setup output and handle arguments
+	for (i = 0; i < nrOfArgs && status == OK; ++i) {
 		dyn_type *argType = dynFunction_argumentTypeForIndex(func, i);
 		enum dyn_function_argument_meta  meta = dynFunction_argumentMetaForIndex(func, i);
-		if (meta == DYN_FUNCTION_ARGUMENT_META__STD) {
-			value = json_array_get(arguments, index++);
-			void *outPtr = NULL;
-            status = jsonSerializer_deserializeJson(argType, value, &outPtr);
-            args[i] = outPtr;
-		} else if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
+		if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
 		    void **instPtr = calloc(1, sizeof(void*));
 		    void *inst = NULL;
 		    dyn_type *subType = NULL;
@@ -129,12 +277,7 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 		} else if (meta == DYN_FUNCTION_ARGUMENT_META__HANDLE) {
 			args[i] = &handle;
 		}
-
-		if (status != OK) {
-			break;
-		}
 	}
-	json_decref(js_request);
 
 	if (status == OK) {
 		if (dynType_descriptorType(returnType) != 'N') {
@@ -156,7 +299,6 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 	}
 
     //free input args
-	json_t *jsonResult = NULL;
 	for(i = 0; i < nrOfArgs; ++i) {
 		dyn_type *argType = dynFunction_argumentTypeForIndex(func, i);
 		enum dyn_function_argument_meta meta = dynFunction_argumentMetaForIndex(func, i);
@@ -177,12 +319,18 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 	}
 
 	//serialize and free output
+	json_serializer_writer_t writer = {NULL, 0, 0};
+	int serializeStatus = status;
+	if (serializeStatus == OK) {
+		serializeStatus = jsonWriter_putc(&writer, '{');
+	}
+	size_t resultMark = writer.size;
 	for (i = 0; i < nrOfArgs; i += 1) {
 		dyn_type *argType = dynFunction_argumentTypeForIndex(func, i);
 		enum dyn_function_argument_meta  meta = dynFunction_argumentMetaForIndex(func, i);
-		if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT) {
-			if (funcCallStatus == 0 && status == OK) {
-				status = jsonSerializer_serializeJson(argType, args[i], &jsonResult);
+		if (meta == DYN_FUNCTION_ARGUMENT_META__PRE_ALLOCATED_OUTPUT && args[i] != NULL) {
+			if (funcCallStatus == 0 && serializeStatus == OK) {
+				serializeStatus = jsonRpc_writeResult(&writer, resultMark, argType, args[i]);
 			}
 			dyn_type *subType = NULL;
 			dynType_typedPointer_getTypedType(argType, &subType);
@@ -192,61 +340,54 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 		} else if (meta == DYN_FUNCTION_ARGUMENT_META__OUTPUT) {
 			if (funcCallStatus == 0 && ptr != NULL) {
 				dyn_type *typedType = NULL;
-				if (status == OK) {
-					status = dynType_typedPointer_getTypedType(argType, &typedType);
-				}
-				if (status == OK && dynType_descriptorType(typedType) == 't') {
-					status = jsonSerializer_serializeJson(typedType, (void*) &ptr, &jsonResult);
+				int rc = dynType_typedPointer_getTypedType(argType, &typedType);
+				if (rc == OK && dynType_descriptorType(typedType) == 't') {
+					if (serializeStatus == OK) {
+						serializeStatus = jsonRpc_writeResult(&writer, resultMark, typedType, (void*) &ptr);
+					}
 					free(ptr);
 				} else {
 					dyn_type *typedTypedType = NULL;
-					if (status == OK) {
-						status = dynType_typedPointer_getTypedType(typedType, &typedTypedType);
+					if (rc == OK) {
+						rc = dynType_typedPointer_getTypedType(typedType, &typedTypedType);
 					}
-
-					if(status == OK){
-						status = jsonSerializer_serializeJson(typedTypedType, ptr, &jsonResult);
+					if (rc == OK && serializeStatus == OK) {
+						serializeStatus = jsonRpc_writeResult(&writer, resultMark, typedTypedType, ptr);
 					}
-
-					if (status == OK) {
+					if (rc == OK) {
 						dynType_free(typedTypedType, ptr);
+					} else {
+						serializeStatus = ERROR;
 					}
 				}
-
+				ptr = NULL;
 			} else {
 				LOG_DEBUG("Output ptr is null");
 			}
 		}
-
-		if (status != OK) {
-			break;
-		}
 	}
 
-	char *response = NULL;
-	if (status == OK) {
+	if (serializeStatus == OK) {
 		LOG_DEBUG("creating payload\n");
-		json_t *payload = json_object();
-		if (funcCallStatus == 0) {
-			if (jsonResult == NULL) {
-				//ignore -> no result
-			} else {
-				LOG_DEBUG("Setting result payload");
-                json_object_set_new_nocheck(payload, "r", jsonResult);
-			}
-		} else {
+		if (funcCallStatus != 0) {
 			LOG_DEBUG("Setting error payload");
-            json_object_set_new_nocheck(payload, "e", json_integer(funcCallStatus));
+			writer.size = resultMark;
+			serializeStatus = jsonWriter_write(&writer, "\"e\":", 4);
+			if (serializeStatus == OK) {
+				serializeStatus = jsonWriter_writeInteger(&writer, funcCallStatus);
+			}
+		}
+		if (serializeStatus == OK) {
+			serializeStatus = jsonWriter_write(&writer, "}", 2); //note including the terminating '\0'
 		}
-		response = json_dumps(payload, JSON_DECODE_ANY);
-		json_decref(payload);
-		LOG_DEBUG("status ptr is %p. response is '%s'\n", status, response);
 	}
+	status = serializeStatus;
 
 	if (status == OK) {
-		*out = response;
+		LOG_DEBUG("response is '%s'\n", writer.data);
+		*out = writer.data;
 	} else {
-		free(response);
+		free(writer.data);
 	}
 
 	return status;
@@ -255,23 +396,31 @@ int jsonRpc_call(dyn_interface_type *intf, void *service, const char *request, c
 int jsonRpc_prepareInvokeRequest(dyn_function_type *func, const char *id, void *args[], char **out) {
 	int status = OK;
 
-
 	LOG_DEBUG("Calling remote function '%s'\n", id);
-	json_t *invoke = json_object();
-    json_object_set_new_nocheck(invoke, "m", json_string(id));
-
-	json_t *arguments = json_array();
-    json_object_set_new_nocheck(invoke, "a", arguments);
+	json_serializer_writer_t writer = {NULL, 0, 0};
+	status = jsonWriter_write(&writer, "{\"m\":", 5);
+	if (status == OK) {
+		status = jsonWriter_writeString(&writer, id);
+	}
+	if (status == OK) {
+		status = jsonWriter_write(&writer, ",\"a\":[", 6);
+	}
 
 	int i;
 	int nrOfArgs = dynFunction_nrOfArguments(func);
-	for (i = 0; i < nrOfArgs; i +=1) {
+	int nrOfItems = 0;
+	for (i = 0; i < nrOfArgs && status == OK; i +=1) {
 		dyn_type *type = dynFunction_argumentTypeForIndex(func, i);
 		enum dyn_function_argument_meta  meta = dynFunction_argumentMetaForIndex(func, i);
 		if (meta == DYN_FUNCTION_ARGUMENT_META__STD) {
-			json_t *val = NULL;
-
-			int rc = jsonSerializer_serializeJson(type, args[i], &val);
+			if (nrOfItems++ > 0) {
+				status = jsonWriter_putc(&writer, ',');
+			}
+			size_t mark = writer.size;
+			int rc = status == OK ? jsonSerializer_streamAny(type, args[i], &writer) : ERROR;
+			if (rc == OK && writer.size == mark) {
+				rc = jsonWriter_write(&writer, "null", 4); //note keep the position of the other arguments
+			}
 
             if (dynType_descriptorType(type) == 't') {
                 const char *metaArgument = dynType_getMetaInfo(type, "const");
@@ -283,22 +432,22 @@ int jsonRpc_prepareInvokeRequest(dyn_function_type *func, const char *id, void *
                 }
             }
 
-			if (rc == 0) {
-				json_array_append_new(arguments, val);
-			} else {
+			if (rc != 0) {
 				status = ERROR;
-				break;
 			}
 		} else {
 			//skip handle / output types
 		}
 	}
 
-	char *invokeStr = json_dumps(invoke, JSON_DECODE_ANY);
-	json_decref(invoke);
+	if (status == OK) {
+		status = jsonWriter_write(&writer, "]}", 3); //note including the terminating '\0'
+	}
 
 	if (status == OK) {
-		*out = invokeStr;
+		*out = writer.data;
+	} else {
+		free(writer.data);
 	}
 
 	return status;
@@ -18,15 +18,26 @@
  */
 
 #include "json_serializer.h"
+#include "json_serializer_common.h"
 #include "dyn_type.h"
 #include "dyn_type_common.h"
 #include "dyn_interface.h"
 
 #include <jansson.h>
 #include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <locale.h>
+#include <math.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#define INITIAL_WRITE_BUFFER_SIZE 256
+#define INITIAL_SEQUENCE_CAPACITY 8
+#define JSON_SERIALIZER_MAX_DEPTH 2048 //same as the jansson parser
+
 static int jsonSerializer_createType(dyn_type *type, json_t *object, void **result);
 static int jsonSerializer_parseObject(dyn_type *type, json_t *object, void *inst);
 static int jsonSerializer_parseObjectMember(dyn_type *type, const char *name, json_t *val, void *inst);
@@ -39,6 +50,22 @@ static int jsonSerializer_writeComplex(dyn_type *type, void *input, json_t **val
 static int jsonSerializer_writeSequence(dyn_type *type, void *input, json_t **out);
 static int jsonSerializer_writeEnum(dyn_type *type, int32_t enum_value, json_t **out);
 
+static size_t jsonSerializer_utf8SequenceLength(const unsigned char *s, size_t len);
+static size_t jsonSerializer_utf8Encode(uint32_t codepoint, char *out);
+
+static int jsonWriter_writeReal(json_serializer_writer_t *writer, double val);
+
+static int jsonSerializer_streamComplex(dyn_type *type, void *input, json_serializer_writer_t *writer);
+static int jsonSerializer_streamSequence(dyn_type *type, void *input, json_serializer_writer_t *writer);
+static int jsonSerializer_streamEnum(dyn_type *type, int32_t enum_value, json_serializer_writer_t *writer);
+
+static int jsonReader_readLiteral(json_serializer_reader_t *reader, const char *literal);
+static int jsonReader_readNumber(json_serializer_reader_t *reader, bool *isReal, int64_t *intVal, double *realVal);
+
+static int jsonSerializer_readAny(dyn_type *type, void *loc, json_serializer_reader_t *reader);
+static int jsonSerializer_readObject(dyn_type *type, void *inst, json_serializer_reader_t *reader);
+static int jsonSerializer_readSequence(dyn_type *type, void *seqLoc, json_serializer_reader_t *reader);
+
 
 static int OK = 0;
 static int ERROR = 1;
@@ -47,21 +74,20 @@ DFI_SETUP_LOG(jsonSerializer);
 
 int jsonSerializer_deserialize(dyn_type *type, const char *input, size_t length, void **result) {
     assert(dynType_type(type) == DYN_TYPE_COMPLEX || dynType_type(type) == DYN_TYPE_SEQUENCE);
-    int status = 0;
 
-    json_error_t error;
-    json_t *root = json_loadb(input, length, JSON_DECODE_ANY, &error);
+    json_serializer_reader_t reader;
+    jsonReader_init(&reader, input, length);
 
-    if (root != NULL) {
-        status = jsonSerializer_deserializeJson(type, root, result);
-        json_decref(root);
-    } else {
+    int status = jsonSerializer_readType(type, &reader, result);
+    if (status == OK && jsonReader_peek(&reader) != EOF) {
+        jsonReader_error(&reader, "end of input expected");
+        dynType_free(type, *result);
+        *result = NULL;
         status = ERROR;
-        LOG_ERROR("Error parsing json input '%s'. Error is: %s\n", input, error.text);
     }
 
     if (status != OK) {
-        LOG_ERROR("Error cannot deserialize json. Input is '%s'\n", input);
+        LOG_ERROR("Error cannot deserialize json. Input is '%.*s'\n", (int)length, input);
     }
     return status;
 }
@@ -308,16 +334,14 @@ static int jsonSerializer_parseSequence(dyn_type *seq, json_t *array, void *seqL
 }
 
 int jsonSerializer_serialize(dyn_type *type, const void* input, char **output) {
-    int status = OK;
-
-    json_t *root = NULL;
-    status = jsonSerializer_serializeJson(type, input, &root);
-
+    char *buffer = NULL;
+    size_t bufferSize = 0;
+    int status = jsonSerializer_serializeToBuffer(type, input, &buffer, &bufferSize, NULL);
     if (status == OK) {
-        *output = json_dumps(root, JSON_COMPACT);
-        json_decref(root);
+        *output = buffer;
+    } else {
+        free(buffer);
     }
-
     return status;
 }
 
@@ -546,3 +570,1183 @@ static int jsonSerializer_writeEnum(dyn_type *type, int32_t enum_value, json_t *
     LOG_ERROR("Could not find Enum value %s in enum type", enum_value_str);
     return ERROR;
 }
+
+/**
+ * Returns the length of the valid UTF-8 sequence at the start of s (at most len bytes) or 0 if the sequence is
+ * invalid. Uses the same rules as jansson: no overlong encodings, surrogates or code points above U+10FFFF.
+ */
+static size_t jsonSerializer_utf8SequenceLength(const unsigned char *s, size_t len) {
+    unsigned char c = s[0];
+    size_t n;
+    uint32_t codepoint;
+    if (c < 0x80) {
+        return 1;
+    } else if (c < 0xC2) {
+        return 0; //continuation byte or overlong 2 byte sequence
+    } else if (c < 0xE0) {
+        n = 2;
+        codepoint = c & 0x1Fu;
+    } else if (c < 0xF0) {
+        n = 3;
+        codepoint = c & 0x0Fu;
+    } else if (c < 0xF5) {
+        n = 4;
+        codepoint = c & 0x07u;
+    } else {
+        return 0;
+    }
+    if (n > len) {
+        return 0;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        if ((s[i] & 0xC0u) != 0x80u) {
+            return 0;
+        }
+        codepoint = (codepoint << 6) | (s[i] & 0x3Fu);
+    }
+    if ((n == 3 && codepoint < 0x800) || (n == 4 && codepoint < 0x10000) ||
+        (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF) {
+        return 0;
+    }
+    return n;
+}
+
+static size_t jsonSerializer_utf8Encode(uint32_t codepoint, char *out) {
+    if (codepoint < 0x80) {
+        out[0] = (char)codepoint;
+        return 1;
+    } else if (codepoint < 0x800) {
+        out[0] = (char)(0xC0 | (codepoint >> 6));
+        out[1] = (char)(0x80 | (codepoint & 0x3F));
+        return 2;
+    } else if (codepoint < 0x10000) {
+        out[0] = (char)(0xE0 | (codepoint >> 12));
+        out[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (codepoint >> 18));
+    out[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+/********** streaming writer **********/
+
+int jsonSerializer_serializeToBuffer(dyn_type *type, const void* input, char **buffer, size_t *bufferSize, size_t *length) {
+    json_serializer_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.data = *buffer;
+    writer.capacity = *buffer != NULL ? *bufferSize : 0;
+
+    int status = jsonSerializer_streamAny(type, (void*)input, &writer);
+    if (status == OK) {
+        status = jsonWriter_putc(&writer, '\0');
+    }
+
+    //note also on error, the (possibly grown) buffer is owned by the caller
+    *buffer = writer.data;
+    *bufferSize = writer.capacity;
+    if (status == OK && length != NULL) {
+        *length = writer.size - 1;
+    }
+    return status;
+}
+
+int jsonSerializer_serializeInto(dyn_type *type, const void* input, char *buffer, size_t bufferSize, size_t *length) {
+    json_serializer_writer_t writer;
+    memset(&writer, 0, sizeof(writer));
+    writer.data = buffer;
+    writer.capacity = bufferSize;
+    writer.fixed = true;
+
+    int status = jsonSerializer_streamAny(type, (void*)input, &writer);
+    *length = status == OK ? writer.size : 0;
+    if (status != OK && writer.overflow) {
+        //determine the needed size, so that the caller can retry with a large enough buffer
+        char *grown = NULL;
+        size_t grownSize = 0;
+        size_t neededLength = 0;
+        if (jsonSerializer_serializeToBuffer(type, input, &grown, &grownSize, &neededLength) == OK) {
+            *length = neededLength;
+        }
+        free(grown);
+    }
+    return status;
+}
+
+int jsonWriter_reserve(json_serializer_writer_t *writer, size_t len) {
+    if (writer->size + len <= writer->capacity) {
+        return OK;
+    }
+    if (writer->fixed) {
+        writer->overflow = true;
+        return ERROR;
+    }
+    size_t newCapacity = writer->capacity == 0 ? INITIAL_WRITE_BUFFER_SIZE : writer->capacity;
+    while (newCapacity < writer->size + len) {
+        newCapacity *= 2;
+    }
+    char *newData = realloc(writer->data, newCapacity);
+    if (newData == NULL) {
+        LOG_ERROR("Cannot allocate memory for json output of %zu bytes", newCapacity);
+        return ERROR;
+    }
+    writer->data = newData;
+    writer->capacity = newCapacity;
+    return OK;
+}
+
+int jsonWriter_writeInteger(json_serializer_writer_t *writer, int64_t val) {
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    uint64_t uval = val < 0 ? 0 - (uint64_t)val : (uint64_t)val;
+    do {
+        *--p = (char)('0' + uval % 10);
+        uval /= 10;
+    } while (uval != 0);
+    if (val < 0) {
+        *--p = '-';
+    }
+    return jsonWriter_write(writer, p, (size_t)(buf + sizeof(buf) - p));
+}
+
+/**
+ * Writes a real the same way as jansson (json_dumps) does: 17 significant digits, at least a '.' or exponent and
+ * no '+' or leading zeros in the exponent.
+ * NaN and infinity cannot be represented and are left out, as json_real does not create a value for them.
+ */
+static int jsonWriter_writeReal(json_serializer_writer_t *writer, double val) {
+    if (!isfinite(val)) {
+        LOG_WARNING("Cannot serialize NaN or infinite real. ignoring");
+        return OK;
+    }
+    char buf[64];
+    int rc = snprintf(buf, sizeof(buf), "%.17g", val);
+    if (rc < 0 || rc >= (int)sizeof(buf) - 2) {
+        LOG_ERROR("Cannot format real");
+        return ERROR;
+    }
+    size_t len = (size_t)rc;
+
+    const char *point = localeconv()->decimal_point;
+    if (*point != '.') {
+        char *pos = strchr(buf, *point);
+        if (pos != NULL) {
+            *pos = '.';
+        }
+    }
+
+    if (strchr(buf, '.') == NULL && strchr(buf, 'e') == NULL) {
+        buf[len++] = '.';
+        buf[len++] = '0';
+        buf[len] = '\0';
+    }
+
+    char *start = strchr(buf, 'e');
+    if (start != NULL) {
+        start++;
+        char *end = start + 1;
+        if (*start == '-') {
+            start++;
+        }
+        while (*end == '0') {
+            end++;
+        }
+        if (end != start) {
+            memmove(start, end, len - (size_t)(end - buf) + 1);
+            len -= (size_t)(end - start);
+        }
+    }
+    return jsonWriter_write(writer, buf, len);
+}
+
+/**
+ * Writes a quoted and escaped string. Like json_string, an invalid UTF-8 string is left out.
+ */
+int jsonWriter_writeString(json_serializer_writer_t *writer, const char *str) {
+    static const char hex[] = "0123456789ABCDEF";
+    size_t start = writer->size;
+    const unsigned char *s = (const unsigned char *)str;
+    size_t remaining = strlen(str);
+
+    int status = jsonWriter_putc(writer, '"');
+    while (status == OK && remaining > 0) {
+        //copy the run of characters which need no escaping at once
+        size_t run = 0;
+        while (run < remaining && s[run] >= 0x20 && s[run] < 0x80 && s[run] != '"' && s[run] != '\\') {
+            run++;
+        }
+        if (run > 0) {
+            status = jsonWriter_write(writer, (const char *)s, run);
+            s += run;
+            remaining -= run;
+            continue;
+        }
+
+        unsigned char c = *s;
+        if (c >= 0x80) {
+            size_t n = jsonSerializer_utf8SequenceLength(s, remaining);
+            if (n == 0) {
+                LOG_WARNING("Cannot serialize invalid UTF-8 string. ignoring");
+                writer->size = start;
+                return OK;
+            }
+            status = jsonWriter_write(writer, (const char *)s, n);
+            s += n;
+            remaining -= n;
+            continue;
+        }
+
+        char escaped[6] = {'\\', 0, 0, 0, 0, 0};
+        size_t escapedLen = 2;
+        switch (c) {
+            case '"':  escaped[1] = '"'; break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\b': escaped[1] = 'b'; break;
+            case '\f': escaped[1] = 'f'; break;
+            case '\n': escaped[1] = 'n'; break;
+            case '\r': escaped[1] = 'r'; break;
+            case '\t': escaped[1] = 't'; break;
+            default:
+                escaped[1] = 'u';
+                escaped[2] = '0';
+                escaped[3] = '0';
+                escaped[4] = hex[c >> 4];
+                escaped[5] = hex[c & 0xF];
+                escapedLen = 6;
+                break;
+        }
+        status = jsonWriter_write(writer, escaped, escapedLen);
+        s += 1;
+        remaining -= 1;
+    }
+    if (status == OK) {
+        status = jsonWriter_putc(writer, '"');
+    }
+    return status;
+}
+
+int jsonSerializer_streamAny(dyn_type *type, void *input, json_serializer_writer_t *writer) {
+    int status = OK;
+    dyn_type *subType = NULL;
+    void *ptr = NULL;
+
+    switch (dynType_descriptorType(type)) {
+        case 'Z' :
+            status = *(bool*)input ? jsonWriter_write(writer, "true", 4) : jsonWriter_write(writer, "false", 5);
+            break;
+        case 'B' :
+            status = jsonWriter_writeInteger(writer, *(char*)input);
+            break;
+        case 'S' :
+            status = jsonWriter_writeInteger(writer, *(int16_t*)input);
+            break;
+        case 'I' :
+            status = jsonWriter_writeInteger(writer, *(int32_t*)input);
+            break;
+        case 'J' :
+            status = jsonWriter_writeInteger(writer, *(int64_t*)input);
+            break;
+        case 'b' :
+            status = jsonWriter_writeInteger(writer, *(uint8_t*)input);
+            break;
+        case 's' :
+            status = jsonWriter_writeInteger(writer, *(uint16_t*)input);
+            break;
+        case 'i' :
+            status = jsonWriter_writeInteger(writer, *(uint32_t*)input);
+            break;
+        case 'j' :
+            status = jsonWriter_writeInteger(writer, (int64_t)*(uint64_t*)input); //note same as the json_int_t cast
+            break;
+        case 'N' :
+            status = jsonWriter_writeInteger(writer, *(int*)input);
+            break;
+        case 'F' :
+            status = jsonWriter_writeReal(writer, *(float*)input);
+            break;
+        case 'D' :
+            status = jsonWriter_writeReal(writer, *(double*)input);
+            break;
+        case 't' :
+            if (*(const char**)input != NULL) {
+                status = jsonWriter_writeString(writer, *(const char**)input);
+            }
+            break;
+        case 'E':
+            status = jsonSerializer_streamEnum(type, *(int32_t*)input, writer);
+            break;
+        case '*' :
+            status = dynType_typedPointer_getTypedType(type, &subType);
+            ptr = *(void**)input;
+            if (status == OK && ptr == NULL) {
+                status = jsonWriter_write(writer, "null", 4);
+            } else if (status == OK) {
+                status = jsonSerializer_streamAny(subType, ptr, writer);
+            }
+            break;
+        case '{' :
+            status = jsonSerializer_streamComplex(type, input, writer);
+            break;
+        case '[' :
+            status = jsonSerializer_streamSequence(type, input, writer);
+            break;
+        case 'P' :
+            LOG_WARNING("Untyped pointer not supported for serialization. ignoring");
+            break;
+        case 'l':
+            status = jsonSerializer_streamAny(type->ref.ref, input, writer);
+            break;
+        default :
+            LOG_ERROR("Unsupported descriptor '%c'", dynType_descriptorType(type));
+            status = ERROR;
+            break;
+    }
+
+    return status;
+}
+
+static int jsonSerializer_streamSequence(dyn_type *type, void *input, json_serializer_writer_t *writer) {
+    assert(dynType_type(type) == DYN_TYPE_SEQUENCE);
+    dyn_type *itemType = dynType_sequence_itemType(type);
+    size_t itemSize = dynType_size(itemType);
+    struct generic_sequence *seq = input;
+
+    int status = jsonWriter_putc(writer, '[');
+    bool first = true;
+    for (uint32_t i = 0; status == OK && i < seq->len; ++i) {
+        size_t mark = writer->size;
+        if (!first) {
+            status = jsonWriter_putc(writer, ',');
+        }
+        size_t valueStart = writer->size;
+        if (status == OK) {
+            status = jsonSerializer_streamAny(itemType, (char*)seq->buf + i * itemSize, writer);
+        }
+        if (status == OK && writer->size == valueStart) {
+            writer->size = mark; //note item left out
+        } else {
+            first = false;
+        }
+    }
+    if (status == OK) {
+        status = jsonWriter_putc(writer, ']');
+    }
+    return status;
+}
+
+static int jsonSerializer_streamComplex(dyn_type *type, void *input, json_serializer_writer_t *writer) {
+    assert(dynType_type(type) == DYN_TYPE_COMPLEX);
+    struct complex_type_entry *entry = NULL;
+    struct complex_type_entries_head *entries = NULL;
+    int index = 0;
+
+    int status = dynType_complex_entries(type, &entries);
+    if (status == OK) {
+        status = jsonWriter_putc(writer, '{');
+    }
+    bool first = true;
+    if (status == OK) {
+        TAILQ_FOREACH(entry, entries, entries) {
+            void *subLoc = NULL;
+            dyn_type *subType = NULL;
+            size_t mark = writer->size;
+            if (!first) {
+                status = jsonWriter_putc(writer, ',');
+            }
+            if (status == OK) {
+                status = jsonWriter_writeString(writer, entry->name);
+            }
+            if (status == OK) {
+                status = jsonWriter_putc(writer, ':');
+            }
+            if (status == OK) {
+                status = dynType_complex_valLocAt(type, index, input, &subLoc);
+            }
+            if (status == OK) {
+                status = dynType_complex_dynTypeAt(type, index, &subType);
+            }
+            size_t valueStart = writer->size;
+            if (status == OK) {
+                status = jsonSerializer_streamAny(subType, subLoc, writer);
+            }
+            if (status != OK) {
+                break;
+            }
+            if (writer->size == valueStart) {
+                writer->size = mark; //note member left out
+            } else {
+                first = false;
+            }
+            index += 1;
+        }
+    }
+    if (status == OK) {
+        status = jsonWriter_putc(writer, '}');
+    }
+    return status;
+}
+
+static int jsonSerializer_streamEnum(dyn_type *type, int32_t enum_value, json_serializer_writer_t *writer) {
+    struct meta_entry * entry;
+
+    // Convert to string
+    char enum_value_str[32];
+    snprintf(enum_value_str, 32, "%d", enum_value);
+
+    // Lookup in meta-information
+    TAILQ_FOREACH(entry, &type->metaProperties, entries) {
+        if (0 == strcmp(enum_value_str, entry->value)) {
+            return jsonWriter_writeString(writer, entry->name);
+        }
+    }
+
+    //note an unknown enum value is left out and not an error, same as for the DOM based serializer
+    LOG_ERROR("Could not find Enum value %s in enum type", enum_value_str);
+    return OK;
+}
+
+/********** pull reader **********/
+
+void jsonReader_init(json_serializer_reader_t *reader, const char *input, size_t length) {
+    reader->start = input;
+    reader->pos = input;
+    reader->end = input + length;
+    reader->depth = 0;
+}
+
+void jsonReader_error(json_serializer_reader_t *reader, const char *msg) {
+    LOG_ERROR("Error parsing json input at position %zu: %s", (size_t)(reader->pos - reader->start), msg);
+}
+
+int jsonReader_expect(json_serializer_reader_t *reader, char c) {
+    if (jsonReader_peek(reader) != (unsigned char)c) {
+        char msg[32];
+        snprintf(msg, sizeof(msg), "expected '%c'", c);
+        jsonReader_error(reader, msg);
+        return ERROR;
+    }
+    reader->pos++;
+    return OK;
+}
+
+static int jsonReader_readLiteral(json_serializer_reader_t *reader, const char *literal) {
+    size_t len = strlen(literal);
+    jsonReader_peek(reader);
+    if ((size_t)(reader->end - reader->pos) < len || memcmp(reader->pos, literal, len) != 0) {
+        jsonReader_error(reader, "invalid token");
+        return ERROR;
+    }
+    reader->pos += len;
+    return OK;
+}
+
+static int jsonReader_enter(json_serializer_reader_t *reader) {
+    if (++reader->depth > JSON_SERIALIZER_MAX_DEPTH) {
+        jsonReader_error(reader, "maximum parsing depth reached");
+        return ERROR;
+    }
+    return OK;
+}
+
+static int jsonReader_hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static int jsonReader_readUnicodeEscape(json_serializer_reader_t *reader, const char *p, uint32_t *out) {
+    if (reader->end - p < 4) {
+        return ERROR;
+    }
+    uint32_t val = 0;
+    for (int i = 0; i < 4; ++i) {
+        int h = jsonReader_hexValue(p[i]);
+        if (h < 0) {
+            return ERROR;
+        }
+        val = (val << 4) | (uint32_t)h;
+    }
+    *out = val;
+    return OK;
+}
+
+/**
+ * Decodes the escaped string between start and end (exclusive the quotes) in a newly allocated string.
+ */
+static int jsonReader_decodeString(json_serializer_reader_t *reader, const char *start, const char *end, char **decoded) {
+    //note a decoded string is never longer than the escaped string
+    char *out = malloc((size_t)(end - start) + 1);
+    if (out == NULL) {
+        LOG_ERROR("Cannot allocate memory for string");
+        return ERROR;
+    }
+    size_t len = 0;
+    const char *p = start;
+    while (p < end) {
+        if (*p != '\\') {
+            out[len++] = *p++;
+            continue;
+        }
+        p++; //note the escape is complete, checked by jsonReader_readString
+        char c = *p++;
+        switch (c) {
+            case '"':  out[len++] = '"'; break;
+            case '\\': out[len++] = '\\'; break;
+            case '/':  out[len++] = '/'; break;
+            case 'b':  out[len++] = '\b'; break;
+            case 'f':  out[len++] = '\f'; break;
+            case 'n':  out[len++] = '\n'; break;
+            case 'r':  out[len++] = '\r'; break;
+            case 't':  out[len++] = '\t'; break;
+            default: { //'u'
+                uint32_t codepoint = 0;
+                uint32_t low = 0;
+                const char *error = NULL;
+                if (jsonReader_readUnicodeEscape(reader, p, &codepoint) != OK) {
+                    error = "invalid escape";
+                } else if (codepoint == 0) {
+                    error = "\\u0000 is not allowed";
+                } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    error = "invalid Unicode, unpaired low surrogate";
+                } else if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    p += 4;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' ||
+                        jsonReader_readUnicodeEscape(reader, p + 2, &low) != OK || low < 0xDC00 || low > 0xDFFF) {
+                        error = "invalid Unicode, unpaired high surrogate";
+                    } else {
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                        p += 2; //note the 4 hex digits of the low surrogate are skipped below
+                    }
+                }
+                if (error != NULL) {
+                    reader->pos = p;
+                    jsonReader_error(reader, error);
+                    free(out);
+                    return ERROR;
+                }
+                p += 4;
+                len += jsonSerializer_utf8Encode(codepoint, out + len);
+                break;
+            }
+        }
+    }
+    out[len] = '\0';
+    *decoded = out;
+    return OK;
+}
+
+/**
+ * Reads a string token. Without escape sequences the string is referenced in the input (*decoded is NULL),
+ * otherwise the string is decoded in *decoded, which must be freed by the caller.
+ */
+int jsonReader_readString(json_serializer_reader_t *reader, const char **str, size_t *len, char **decoded) {
+    *decoded = NULL;
+    if (jsonReader_expect(reader, '"') != OK) {
+        return ERROR;
+    }
+    const char *start = reader->pos;
+    const char *p = start;
+    bool escaped = false;
+    while (true) {
+        if (p >= reader->end) {
+            reader->pos = p;
+            jsonReader_error(reader, "premature end of input, unterminated string");
+            return ERROR;
+        }
+        unsigned char c = (unsigned char)*p;
+        if (c == '"') {
+            break;
+        } else if (c == '\\') {
+            escaped = true;
+            if (p + 1 >= reader->end || strchr("\"\\/bfnrtu", p[1]) == NULL || p[1] == '\0') {
+                reader->pos = p;
+                jsonReader_error(reader, "invalid escape");
+                return ERROR;
+            }
+            p += 2;
+        } else if (c < 0x20) {
+            reader->pos = p;
+            jsonReader_error(reader, "control character in string");
+            return ERROR;
+        } else if (c >= 0x80) {
+            size_t n = jsonSerializer_utf8SequenceLength((const unsigned char *)p, (size_t)(reader->end - p));
+            if (n == 0) {
+                reader->pos = p;
+                jsonReader_error(reader, "invalid UTF-8 in string");
+                return ERROR;
+            }
+            p += n;
+        } else {
+            p++;
+        }
+    }
+    reader->pos = p + 1;
+
+    if (escaped) {
+        if (jsonReader_decodeString(reader, start, p, decoded) != OK) {
+            return ERROR;
+        }
+        *str = *decoded;
+        *len = strlen(*decoded);
+    } else {
+        *str = start;
+        *len = (size_t)(p - start);
+    }
+    return OK;
+}
+
+/**
+ * Reads a number token. Like jansson, a number with a fraction or exponent is a real and otherwise an integer.
+ */
+static int jsonReader_readNumber(json_serializer_reader_t *reader, bool *isReal, int64_t *intVal, double *realVal) {
+    jsonReader_peek(reader);
+    const char *start = reader->pos;
+    const char *p = start;
+    const char *end = reader->end;
+    bool negative = false;
+    *isReal = false;
+
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p < end && *p == '0') {
+        p++;
+    } else if (p < end && *p >= '1' && *p <= '9') {
+        while (p < end && isdigit((unsigned char)*p)) {
+            p++;
+        }
+    } else {
+        jsonReader_error(reader, "invalid number");
+        return ERROR;
+    }
+    const char *intEnd = p;
+    if (p < end && *p == '.') {
+        *isReal = true;
+        p++;
+        if (p >= end || !isdigit((unsigned char)*p)) {
+            jsonReader_error(reader, "invalid number");
+            return ERROR;
+        }
+        while (p < end && isdigit((unsigned char)*p)) {
+            p++;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        *isReal = true;
+        p++;
+        if (p < end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p >= end || !isdigit((unsigned char)*p)) {
+            jsonReader_error(reader, "invalid number");
+            return ERROR;
+        }
+        while (p < end && isdigit((unsigned char)*p)) {
+            p++;
+        }
+    }
+
+    if (!*isReal) {
+        uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+        uint64_t val = 0;
+        for (const char *d = negative ? start + 1 : start; d < intEnd; ++d) {
+            uint64_t digit = (uint64_t)(*d - '0');
+            if (val > (limit - digit) / 10) {
+                jsonReader_error(reader, negative ? "too big negative integer" : "too big integer");
+                return ERROR;
+            }
+            val = val * 10 + digit;
+        }
+        *intVal = negative ? (int64_t)(0 - val) : (int64_t)val;
+    } else {
+        //note strtod needs a terminated string in the locale of the process
+        char buf[64];
+        size_t len = (size_t)(p - start);
+        char *copy = len < sizeof(buf) ? buf : malloc(len + 1);
+        if (copy == NULL) {
+            LOG_ERROR("Cannot allocate memory for number");
+            return ERROR;
+        }
+        memcpy(copy, start, len);
+        copy[len] = '\0';
+        const char *point = localeconv()->decimal_point;
+        if (*point != '.') {
+            char *pos = strchr(copy, '.');
+            if (pos != NULL) {
+                *pos = *point;
+            }
+        }
+        errno = 0;
+        double val = strtod(copy, NULL);
+        bool overflow = (val == HUGE_VAL || val == -HUGE_VAL) && errno == ERANGE;
+        if (copy != buf) {
+            free(copy);
+        }
+        if (overflow) {
+            jsonReader_error(reader, "real number overflow");
+            return ERROR;
+        }
+        *realVal = val;
+    }
+    reader->pos = p;
+    return OK;
+}
+
+/**
+ * Skips the members of an object or the items of an array, including the closing bracket.
+ */
+static int jsonReader_skipContainer(json_serializer_reader_t *reader, bool isObject) {
+    const char close = isObject ? '}' : ']';
+    int status = jsonReader_enter(reader);
+    if (status == OK) {
+        status = jsonReader_expect(reader, isObject ? '{' : '[');
+    }
+    if (status == OK && jsonReader_peek(reader) == close) {
+        reader->pos++;
+        reader->depth--;
+        return OK;
+    }
+    while (status == OK) {
+        if (isObject) {
+            const char *str;
+            size_t len;
+            char *decoded = NULL;
+            status = jsonReader_readString(reader, &str, &len, &decoded);
+            free(decoded);
+            if (status == OK) {
+                status = jsonReader_expect(reader, ':');
+            }
+        }
+        if (status == OK) {
+            status = jsonReader_skipValue(reader);
+        }
+        if (status == OK) {
+            int next = jsonReader_peek(reader);
+            if (next == close) {
+                reader->pos++;
+                break;
+            } else if (next == ',') {
+                reader->pos++;
+            } else {
+                jsonReader_error(reader, isObject ? "expected ',' or '}'" : "expected ',' or ']'");
+                status = ERROR;
+            }
+        }
+    }
+    reader->depth--;
+    return status;
+}
+
+/**
+ * Skips a (valid) json value.
+ */
+int jsonReader_skipValue(json_serializer_reader_t *reader) {
+    int status = OK;
+    const char *str;
+    size_t len;
+    char *decoded = NULL;
+    bool isReal;
+    int64_t intVal;
+    double realVal;
+
+    int c = jsonReader_peek(reader);
+    switch (c) {
+        case '{':
+        case '[':
+            status = jsonReader_skipContainer(reader, c == '{');
+            break;
+        case '"':
+            status = jsonReader_readString(reader, &str, &len, &decoded);
+            free(decoded);
+            break;
+        case 't':
+            status = jsonReader_readLiteral(reader, "true");
+            break;
+        case 'f':
+            status = jsonReader_readLiteral(reader, "false");
+            break;
+        case 'n':
+            status = jsonReader_readLiteral(reader, "null");
+            break;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                status = jsonReader_readNumber(reader, &isReal, &intVal, &realVal);
+            } else {
+                jsonReader_error(reader, c == EOF ? "premature end of input" : "invalid token");
+                status = ERROR;
+            }
+            break;
+    }
+    return status;
+}
+
+/**
+ * Reads an integer value. Like json_integer_value, any other json value results in 0.
+ */
+static int jsonReader_readInteger(json_serializer_reader_t *reader, int64_t *out) {
+    int c = jsonReader_peek(reader);
+    *out = 0;
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        bool isReal;
+        double realVal;
+        int64_t val = 0;
+        int status = jsonReader_readNumber(reader, &isReal, &val, &realVal);
+        if (status == OK && !isReal) {
+            *out = val;
+        }
+        return status;
+    }
+    return jsonReader_skipValue(reader);
+}
+
+/**
+ * Reads a real value, an integer value is converted. Any other json value results in 0.
+ */
+static int jsonReader_readReal(json_serializer_reader_t *reader, double *out) {
+    int c = jsonReader_peek(reader);
+    *out = 0.0;
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        bool isReal;
+        double val = 0.0;
+        int64_t intVal = 0;
+        int status = jsonReader_readNumber(reader, &isReal, &intVal, &val);
+        if (status == OK) {
+            *out = isReal ? val : (double)intVal;
+        }
+        return status;
+    }
+    return jsonReader_skipValue(reader);
+}
+
+int jsonSerializer_readType(dyn_type *type, json_serializer_reader_t *reader, void **result) {
+    int status = OK;
+    void *inst = NULL;
+    const char *str;
+    size_t len;
+    char *decoded = NULL;
+
+    if (dynType_descriptorType(type) == 't') {
+        if (jsonReader_peek(reader) == '"') {
+            //note a deserialized C string is a sequence of memory for the actual string and a
+            //pointer to that sequence. That pointer also needs to reside in the memory (heap).
+            status = jsonReader_readString(reader, &str, &len, &decoded);
+            if (status == OK) {
+                inst = calloc(1, sizeof(char*));
+                *((char**)inst) = decoded != NULL ? decoded : strndup(str, len);
+            }
+        } else {
+            status = ERROR;
+            jsonReader_error(reader, "expected json string");
+        }
+    } else {
+        status = dynType_alloc(type, &inst);
+
+        if (status == OK) {
+            assert(inst != NULL);
+            status = jsonSerializer_readAny(type, inst, reader);
+        }
+    }
+
+    if (status == OK) {
+        *result = inst;
+    } else {
+        *result = NULL;
+        dynType_free(type, inst);
+    }
+
+    return status;
+}
+
+static int jsonSerializer_readEnum(dyn_type *type, json_serializer_reader_t *reader, int32_t *out) {
+    const char *name;
+    size_t len;
+    char *decoded = NULL;
+    struct meta_entry * entry;
+
+    int status = jsonReader_readString(reader, &name, &len, &decoded);
+    if (status == OK) {
+        status = ERROR;
+        TAILQ_FOREACH(entry, &type->metaProperties, entries) {
+            if (strlen(entry->name) == len && memcmp(name, entry->name, len) == 0) {
+                *out = atoi(entry->value);
+                status = OK;
+                break;
+            }
+        }
+        if (status != OK) {
+            LOG_ERROR("Could not find Enum value %.*s in enum type", (int)len, name);
+        }
+    }
+    free(decoded);
+    return status;
+}
+
+static int jsonSerializer_readAny(dyn_type *type, void *loc, json_serializer_reader_t *reader) {
+    int status = OK;
+    dyn_type *subType = NULL;
+    int64_t intVal = 0;
+    double realVal = 0.0;
+    const char *str;
+    size_t len;
+    char *decoded = NULL;
+
+    int c = jsonReader_peek(reader);
+    switch (dynType_descriptorType(type)) {
+        case 'Z' :
+            //note like json_is_true, anything other than true is false
+            *(bool*)loc = c == 't';
+            status = jsonReader_skipValue(reader);
+            break;
+        case 'F' :
+            status = jsonReader_readReal(reader, &realVal);
+            *(float*)loc = (float)realVal;
+            break;
+        case 'D' :
+            status = jsonReader_readReal(reader, &realVal);
+            *(double*)loc = realVal;
+            break;
+        case 'N' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(int*)loc = (int)intVal;
+            break;
+        case 'B' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(char*)loc = (char)intVal;
+            break;
+        case 'S' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(int16_t*)loc = (int16_t)intVal;
+            break;
+        case 'I' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(int32_t*)loc = (int32_t)intVal;
+            break;
+        case 'J' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(int64_t*)loc = intVal;
+            break;
+        case 'b' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(uint8_t*)loc = (uint8_t)intVal;
+            break;
+        case 's' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(uint16_t*)loc = (uint16_t)intVal;
+            break;
+        case 'i' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(uint32_t*)loc = (uint32_t)intVal;
+            break;
+        case 'j' :
+            status = jsonReader_readInteger(reader, &intVal);
+            *(uint64_t*)loc = (uint64_t)intVal;
+            break;
+        case 'E' :
+            if (c == 'n') {
+                status = jsonReader_readLiteral(reader, "null");
+            } else if (c == '"') {
+                status = jsonSerializer_readEnum(type, reader, loc);
+            } else {
+                status = ERROR;
+                jsonReader_error(reader, "expected json string for enum type");
+            }
+            break;
+        case 't' :
+            if (c == 'n') {
+                status = jsonReader_readLiteral(reader, "null");
+            } else if (c == '"') {
+                status = jsonReader_readString(reader, &str, &len, &decoded);
+                if (status == OK) {
+                    *(char**)loc = decoded != NULL ? decoded : strndup(str, len);
+                }
+            } else {
+                status = ERROR;
+                jsonReader_error(reader, "expected json string");
+            }
+            break;
+        case '[' :
+            if (c == '[') {
+                status = jsonSerializer_readSequence(type, loc, reader);
+            } else {
+                status = ERROR;
+                jsonReader_error(reader, "expected json array");
+            }
+            break;
+        case '{' :
+            //note like for the DOM based parser, a non object value is ignored
+            status = c == '{' ? jsonSerializer_readObject(type, loc, reader) : jsonReader_skipValue(reader);
+            break;
+        case '*' :
+            if (c == 'n') {
+                status = jsonReader_readLiteral(reader, "null");
+            } else {
+                status = dynType_typedPointer_getTypedType(type, &subType);
+                if (status == OK) {
+                    status = jsonSerializer_readType(subType, reader, (void **) loc);
+                }
+            }
+            break;
+        case 'P' :
+            status = ERROR;
+            LOG_WARNING("Untyped pointer are not supported for serialization");
+            break;
+        case 'l':
+            status = jsonSerializer_readAny(type->ref.ref, loc, reader);
+            break;
+        default :
+            status = ERROR;
+            LOG_ERROR("Error provided type '%c' not supported for JSON\n", dynType_descriptorType(type));
+            break;
+    }
+
+    return status;
+}
+
+static int jsonSerializer_readObject(dyn_type *type, void *inst, json_serializer_reader_t *reader) {
+    assert(dynType_type(type) == DYN_TYPE_COMPLEX);
+    struct complex_type_entries_head *entries = NULL;
+    int status = dynType_complex_entries(type, &entries);
+    if (status == OK) {
+        status = jsonReader_enter(reader);
+    }
+    if (status == OK) {
+        status = jsonReader_expect(reader, '{');
+    }
+    if (status == OK && jsonReader_peek(reader) == '}') {
+        reader->pos++;
+        reader->depth--;
+        return OK;
+    }
+
+    while (status == OK) {
+        const char *name;
+        size_t len;
+        char *decoded = NULL;
+        status = jsonReader_readString(reader, &name, &len, &decoded);
+        if (status != OK) {
+            break;
+        }
+
+        int index = 0;
+        struct complex_type_entry *entry = NULL;
+        TAILQ_FOREACH(entry, entries, entries) {
+            if (strlen(entry->name) == len && memcmp(name, entry->name, len) == 0) {
+                break;
+            }
+            index += 1;
+        }
+        if (entry == NULL) {
+            LOG_ERROR("Cannot find index for member '%.*s'", (int)len, name);
+            status = ERROR;
+        }
+        free(decoded);
+
+        void *valp = NULL;
+        dyn_type *valType = NULL;
+        if (status == OK) {
+            status = jsonReader_expect(reader, ':');
+        }
+        if (status == OK) {
+            status = dynType_complex_valLocAt(type, index, inst, &valp);
+        }
+        if (status == OK) {
+            status = dynType_complex_dynTypeAt(type, index, &valType);
+        }
+        if (status == OK && dynType_type(valType) != DYN_TYPE_SIMPLE) {
+            //note a duplicate member replaces the earlier value
+            dynType_deepFree(valType, valp, false);
+            memset(valp, 0, dynType_size(valType));
+        }
+        if (status == OK) {
+            status = jsonSerializer_readAny(valType, valp, reader);
+        }
+        if (status == OK) {
+            int next = jsonReader_peek(reader);
+            if (next == '}') {
+                reader->pos++;
+                break;
+            } else if (next == ',') {
+                reader->pos++;
+            } else {
+                jsonReader_error(reader, "expected ',' or '}'");
+                status = ERROR;
+            }
+        }
+    }
+    reader->depth--;
+    return status;
+}
+
+/**
+ * Shrinks the capacity to the length, so that a deserialized sequence has the same capacity as the nr of items.
+ */
+static int jsonSerializer_shrinkSequence(struct generic_sequence *seq, size_t itemSize) {
+    if (seq->cap > seq->len) {
+        void *buf = realloc(seq->buf, seq->len * itemSize);
+        if (buf == NULL) {
+            LOG_ERROR("Error allocating memory for buf");
+            return ERROR;
+        }
+        seq->buf = buf;
+        seq->cap = seq->len;
+    }
+    return OK;
+}
+
+static int jsonSerializer_readSequence(dyn_type *type, void *seqLoc, json_serializer_reader_t *reader) {
+    assert(dynType_type(type) == DYN_TYPE_SEQUENCE);
+    dyn_type *itemType = dynType_sequence_itemType(type);
+    size_t itemSize = dynType_size(itemType);
+    struct generic_sequence *seq = seqLoc;
+
+    dynType_sequence_init(type, seqLoc);
+    int status = jsonReader_enter(reader);
+    if (status == OK) {
+        status = jsonReader_expect(reader, '[');
+    }
+    if (status == OK && jsonReader_peek(reader) == ']') {
+        reader->pos++;
+        reader->depth--;
+        return OK;
+    }
+
+    while (status == OK) {
+        if (seq->len == seq->cap) {
+            //note the nr of items is not known upfront, so the capacity grows exponentially
+            uint32_t cap = seq->cap == 0 ? INITIAL_SEQUENCE_CAPACITY : seq->cap * 2;
+            dynType_sequence_reserve(type, seqLoc, cap);
+            if (seq->cap < cap) {
+                status = ERROR;
+                break;
+            }
+        }
+        void *itemLoc = (char*)seq->buf + seq->len * itemSize;
+        memset(itemLoc, 0, itemSize);
+        seq->len += 1;
+        status = jsonSerializer_readAny(itemType, itemLoc, reader);
+        if (status == OK) {
+            int next = jsonReader_peek(reader);
+            if (next == ']') {
+                reader->pos++;
+                status = jsonSerializer_shrinkSequence(seq, itemSize);
+                break;
+            } else if (next == ',') {
+                reader->pos++;
+            } else {
+                jsonReader_error(reader, "expected ',' or ']'");
+                status = ERROR;
+            }
+        }
+    }
+    reader->depth--;
+    return status;
+}
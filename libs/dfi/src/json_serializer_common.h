@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef _JSON_SERIALIZER_COMMON_H_
+#define _JSON_SERIALIZER_COMMON_H_
+
+#include "dyn_type.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Output buffer of the streaming writer. The buffer is either owned and grown when needed or caller provided
+ * (fixed), in which case writing beyond the capacity fails and sets overflow.
+ */
+typedef struct json_serializer_writer {
+    char *data;
+    size_t size;
+    size_t capacity;
+    bool fixed;
+    bool overflow;
+} json_serializer_writer_t;
+
+/**
+ * Pull reader, reads the json tokens directly from the input when the dyn_type memory is filled.
+ */
+typedef struct json_serializer_reader {
+    const char *start;
+    const char *pos;
+    const char *end;
+    int depth;
+} json_serializer_reader_t;
+
+int jsonWriter_reserve(json_serializer_writer_t *writer, size_t len);
+int jsonWriter_writeInteger(json_serializer_writer_t *writer, int64_t val);
+int jsonWriter_writeString(json_serializer_writer_t *writer, const char *str);
+
+/**
+ * Writes the value at input. A value which the DOM based serializer leaves out (e.g. a NULL string) is not written,
+ * the caller detects this by an unchanged writer size.
+ */
+int jsonSerializer_streamAny(dyn_type *type, void *input, json_serializer_writer_t *writer);
+
+static inline int jsonWriter_putc(json_serializer_writer_t *writer, char c) {
+    if (writer->size == writer->capacity && jsonWriter_reserve(writer, 1) != 0) {
+        return 1;
+    }
+    writer->data[writer->size++] = c;
+    return 0;
+}
+
+static inline int jsonWriter_write(json_serializer_writer_t *writer, const char *src, size_t len) {
+    if (jsonWriter_reserve(writer, len) != 0) {
+        return 1;
+    }
+    memcpy(writer->data + writer->size, src, len);
+    writer->size += len;
+    return 0;
+}
+
+void jsonReader_init(json_serializer_reader_t *reader, const char *input, size_t length);
+void jsonReader_error(json_serializer_reader_t *reader, const char *msg);
+int jsonReader_expect(json_serializer_reader_t *reader, char c);
+
+int jsonReader_readString(json_serializer_reader_t *reader, const char **str, size_t *len, char **decoded);
+int jsonReader_skipValue(json_serializer_reader_t *reader);
+
+/**
+ * Allocates and reads the value for type, the result is freed with dynType_free.
+ */
+int jsonSerializer_readType(dyn_type *type, json_serializer_reader_t *reader, void **result);
+
+/**
+ * Skips whitespace and returns the next character, or EOF at the end of the input.
+ */
+static inline int jsonReader_peek(json_serializer_reader_t *reader) {
+    while (reader->pos < reader->end) {
+        char c = *reader->pos;
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return (unsigned char)c;
+        }
+        reader->pos++;
+    }
+    return EOF;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -35,35 +35,49 @@ public:
 /**
  * Benchmark to measure to lookup/track services in Celix framework already containing more
  * or less registered services.
+ *
+ * Optionally the registered services can be registered with a different service name (other services) to
+ * measure the effect of the service registry service name index and the "key" property can be indexed
+ * to measure the effect of the service registry attribute indexes.
  */
 class LookupServicesBenchmark {
 public:
-    explicit LookupServicesBenchmark(int64_t _nrOfServiceRegistrations) : nrOfServiceRegistrations{_nrOfServiceRegistrations}, fw{createFw()} {
+    explicit LookupServicesBenchmark(int64_t _nrOfServiceRegistrations, bool indexKeyAttribute = false, bool registerAsOtherService = false) :
+            nrOfServiceRegistrations{_nrOfServiceRegistrations}, fw{createFw(indexKeyAttribute)} {
         auto ctx = fw->getFrameworkBundleContext();
         for (int i = 0; i < nrOfServiceRegistrations; ++i) {
-            auto reg = ctx->registerService<IService>(std::make_shared<ServiceImpl>(), IService::NAME)
+            auto reg = ctx->registerService<IService>(std::make_shared<ServiceImpl>(), registerAsOtherService ? OTHER_SERVICE_NAME : IService::NAME)
                     .addProperty("key", std::string{"value"} + std::to_string(i))
                     .build();
             registrations.emplace_back(std::move(reg));
         }
+        if (registerAsOtherService) {
+            auto reg = ctx->registerService<IService>(std::make_shared<ServiceImpl>(), IService::NAME)
+                    .addProperty("key", std::string{"value"} + std::to_string(nrOfServiceRegistrations / 2))
+                    .build();
+            registrations.emplace_back(std::move(reg));
+        }
         ctx->waitForEvents();
     }
 
-    static std::shared_ptr<celix::Framework> createFw() {
+    static std::shared_ptr<celix::Framework> createFw(bool indexKeyAttribute) {
         celix::Properties config{};
         config.set(celix::FRAMEWORK_STATIC_EVENT_QUEUE_SIZE, 1024*10);
+        config.set(celix::FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES, indexKeyAttribute ? "service.id,key" : "service.id");
         config.set("CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "error");
         return celix::createFramework(config);
     }
 
+    static constexpr const char * const OTHER_SERVICE_NAME = "IOtherService";
+
     const int64_t nrOfServiceRegistrations;
     const std::shared_ptr<celix::Framework> fw;
 
     std::vector<std::shared_ptr<celix::ServiceRegistration>> registrations{};
 };
 
-static void findSingleService(benchmark::State& state, bool cTest, bool useFilter) {
-    LookupServicesBenchmark benchmark{state.range(0)};
+static void findSingleService(benchmark::State& state, bool cTest, bool useFilter, bool indexKeyAttribute = false, bool registerAsOtherService = false) {
+    LookupServicesBenchmark benchmark{state.range(0), indexKeyAttribute, registerAsOtherService};
     auto ctx = benchmark.fw->getFrameworkBundleContext();
     auto* cCtx = ctx->getCBundleContext();
 
@@ -155,6 +169,22 @@ static void LookupServicesBenchmark_cxxFindServiceWithFilter(benchmark::State& s
     findSingleService(state, false, true);
 }
 
+static void LookupServicesBenchmark_cFindServiceWithIndexedFilter(benchmark::State& state) {
+    findSingleService(state, true, true, true);
+}
+
+static void LookupServicesBenchmark_cxxFindServiceWithIndexedFilter(benchmark::State& state) {
+    findSingleService(state, false, true, true);
+}
+
+static void LookupServicesBenchmark_cFindSingleServiceAmongOtherServices(benchmark::State& state) {
+    findSingleService(state, true, false, false, true);
+}
+
+static void LookupServicesBenchmark_cFindServiceWithFilterAmongOtherServices(benchmark::State& state) {
+    findSingleService(state, true, true, false, true);
+}
+
 static void LookupServicesBenchmark_cCreateDestroyTracker(benchmark::State& state) {
     createDestroyServiceTracker(state, true);
 }
@@ -172,5 +202,11 @@ CELIX_BENCHMARK(LookupServicesBenchmark_cxxFindSingleService)->RangeMultiplier(1
 CELIX_BENCHMARK(LookupServicesBenchmark_cFindServiceWithFilter)->RangeMultiplier(10)->Range(1, 10000);
 CELIX_BENCHMARK(LookupServicesBenchmark_cxxFindServiceWithFilter)->RangeMultiplier(10)->Range(1, 10000);
 
+CELIX_BENCHMARK(LookupServicesBenchmark_cFindServiceWithIndexedFilter)->RangeMultiplier(10)->Range(1, 100000);
+CELIX_BENCHMARK(LookupServicesBenchmark_cxxFindServiceWithIndexedFilter)->RangeMultiplier(10)->Range(1, 100000);
+
+CELIX_BENCHMARK(LookupServicesBenchmark_cFindSingleServiceAmongOtherServices)->RangeMultiplier(10)->Range(1, 100000);
+CELIX_BENCHMARK(LookupServicesBenchmark_cFindServiceWithFilterAmongOtherServices)->RangeMultiplier(10)->Range(1, 100000);
+
 CELIX_BENCHMARK(LookupServicesBenchmark_cCreateDestroyTracker)->RangeMultiplier(10)->Range(1, 1000);
 CELIX_BENCHMARK(LookupServicesBenchmark_cxxCreateDestroyTracker)->RangeMultiplier(10)->Range(1, 1000);
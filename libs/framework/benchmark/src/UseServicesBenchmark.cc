@@ -0,0 +1,120 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include "celix/FrameworkFactory.h"
+#include "celix_bundle_context.h"
+
+namespace {
+    struct UseServicesBenchmarkService {
+        static constexpr const char * const NAME = "UseServicesBenchmarkService";
+        int value{42};
+    };
+}
+
+/**
+ * Benchmark to measure the overhead of the celix_bundleContext_useService* calls for the default (event loop),
+ * direct (CELIX_SERVICE_USE_DIRECT) and cached (CELIX_SERVICE_USE_CACHED) use variants.
+ */
+class UseServicesBenchmark {
+public:
+    explicit UseServicesBenchmark(int64_t nrOfServiceRegistrations) : fw{createFw()} {
+        auto ctx = fw->getFrameworkBundleContext();
+        for (int i = 0; i < nrOfServiceRegistrations; ++i) {
+            auto reg = ctx->registerService<UseServicesBenchmarkService>(std::make_shared<UseServicesBenchmarkService>(), UseServicesBenchmarkService::NAME)
+                    .build();
+            registrations.emplace_back(std::move(reg));
+        }
+        ctx->waitForEvents();
+    }
+
+    static std::shared_ptr<celix::Framework> createFw() {
+        celix::Properties config{};
+        config.set(celix::FRAMEWORK_STATIC_EVENT_QUEUE_SIZE, 1024*10);
+        config.set("CELIX_LOGGING_DEFAULT_ACTIVE_LOG_LEVEL", "error");
+        return celix::createFramework(config);
+    }
+
+    static void use(void* handle, void* svc) {
+        auto* count = static_cast<int64_t*>(handle);
+        *count += static_cast<UseServicesBenchmarkService*>(svc)->value;
+    }
+
+    const std::shared_ptr<celix::Framework> fw;
+    std::vector<std::shared_ptr<celix::ServiceRegistration>> registrations{};
+};
+
+static void useService(benchmark::State& state, int flags, bool useAllServices) {
+    UseServicesBenchmark benchmark{state.range(0)};
+    auto* cCtx = benchmark.fw->getFrameworkBundleContext()->getCBundleContext();
+
+    int64_t count = 0;
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = UseServicesBenchmarkService::NAME;
+    opts.callbackHandle = &count;
+    opts.use = UseServicesBenchmark::use;
+    opts.flags = flags;
+
+    for (auto _ : state) {
+        // This code gets timed
+        if (useAllServices) {
+            size_t nrCalled = celix_bundleContext_useServicesWithOptions(cCtx, &opts);
+            if (nrCalled != (size_t)state.range(0)) {
+                state.SkipWithError("not all services called");
+            }
+        } else {
+            bool called = celix_bundleContext_useServiceWithOptions(cCtx, &opts);
+            if (!called) {
+                state.SkipWithError("service not called");
+            }
+        }
+    }
+    benchmark::DoNotOptimize(count);
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void UseServicesBenchmark_useService(benchmark::State& state) {
+    useService(state, 0, false);
+}
+
+static void UseServicesBenchmark_useServiceDirect(benchmark::State& state) {
+    useService(state, CELIX_SERVICE_USE_DIRECT, false);
+}
+
+static void UseServicesBenchmark_useServiceCached(benchmark::State& state) {
+    useService(state, CELIX_SERVICE_USE_CACHED, false);
+}
+
+static void UseServicesBenchmark_useServices(benchmark::State& state) {
+    useService(state, 0, true);
+}
+
+static void UseServicesBenchmark_useServicesCached(benchmark::State& state) {
+    useService(state, CELIX_SERVICE_USE_CACHED, true);
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(UseServicesBenchmark_useService)->RangeMultiplier(10)->Range(1, 1000);
+CELIX_BENCHMARK(UseServicesBenchmark_useServiceDirect)->RangeMultiplier(10)->Range(1, 1000);
+CELIX_BENCHMARK(UseServicesBenchmark_useServiceCached)->RangeMultiplier(10)->Range(1, 1000);
+
+CELIX_BENCHMARK(UseServicesBenchmark_useServices)->RangeMultiplier(10)->Range(1, 1000);
+CELIX_BENCHMARK(UseServicesBenchmark_useServicesCached)->RangeMultiplier(10)->Range(1, 1000);
@@ -20,12 +20,15 @@
 #include <gtest/gtest.h>
 
 #include <dirent.h>
+#include <sys/stat.h>
 
 #include "celix/FrameworkFactory.h"
 #include "celix/FrameworkUtils.h"
 
 #include "celix_framework_utils_private.h"
 #include "celix_file_utils.h"
+#include "celix_constants.h"
+#include "celix_bundle.h"
 
 /**
  * Tests for the C and C++ framework utils functions which can be found in
@@ -157,3 +160,89 @@ TEST_F(CelixFrameworkUtilsTestSuite, installBundleSet) {
     ids = framework->getFrameworkBundleContext()->listBundleIds();
     EXPECT_EQ(3, ids.size());
 }
+
+TEST_F(CelixFrameworkUtilsTestSuite, testHashBundle) {
+    char* hash1 = nullptr;
+    auto status = celix_framework_utils_hashBundle(framework->getCFramework(), "non-existing.zip", &hash1);
+    EXPECT_NE(status, CELIX_SUCCESS);
+    EXPECT_EQ(hash1, nullptr);
+
+    status = celix_framework_utils_hashBundle(framework->getCFramework(), SIMPLE_TEST_BUNDLE1_LOCATION, &hash1);
+    ASSERT_EQ(status, CELIX_SUCCESS);
+    EXPECT_EQ(strlen(hash1), 32);
+
+    //same content -> same hash, independent of the url
+    char* hash2 = nullptr;
+    auto url = std::string{"file://"} + SIMPLE_TEST_BUNDLE1_LOCATION;
+    status = celix_framework_utils_hashBundle(framework->getCFramework(), url.c_str(), &hash2);
+    ASSERT_EQ(status, CELIX_SUCCESS);
+    EXPECT_STREQ(hash1, hash2);
+    free(hash2);
+
+    //embedded bundle
+    status = celix_framework_utils_hashBundle(framework->getCFramework(), "embedded://simple_test_bundle1", &hash2);
+    ASSERT_EQ(status, CELIX_SUCCESS);
+    EXPECT_EQ(strlen(hash2), 32);
+    free(hash2);
+
+    //different content -> different hash
+    status = celix_framework_utils_hashBundle(framework->getCFramework(), SIMPLE_TEST_BUNDLE2_LOCATION, &hash2);
+    ASSERT_EQ(status, CELIX_SUCCESS);
+    EXPECT_STRNE(hash1, hash2);
+    free(hash2);
+    free(hash1);
+}
+
+static std::string bundleEntry(const std::shared_ptr<celix::Framework>& fw, long bndId, const char* path) {
+    std::pair<std::string, const char*> data{{}, path};
+    celix_framework_useBundle(fw->getCFramework(), false, bndId, &data, [](void* handle, const celix_bundle_t* bnd) {
+        auto* d = static_cast<std::pair<std::string, const char*>*>(handle);
+        char* entry = celix_bundle_getEntry(bnd, d->second);
+        d->first = entry != nullptr ? entry : "";
+        free(entry);
+    });
+    return data.first;
+}
+
+TEST_F(CelixFrameworkUtilsTestSuite, testSharedBundleCacheDir) {
+    const char* sharedDir = "sharedBundleCacheTestDir";
+    celix_utils_deleteDirectory(sharedDir, nullptr);
+
+    celix::Properties config{};
+    config.set(CELIX_FRAMEWORK_BUNDLE_CACHE_SHARED_DIR, sharedDir);
+    config.set(CELIX_FRAMEWORK_STORAGE_USE_TMP_DIR, true);
+    auto fw1 = celix::createFramework(config);
+    auto fw2 = celix::createFramework(config);
+
+    char* hash = nullptr;
+    ASSERT_EQ(celix_framework_utils_hashBundle(fw1->getCFramework(), SIMPLE_TEST_BUNDLE1_LOCATION, &hash), CELIX_SUCCESS);
+    auto expectedManifest = std::string{sharedDir} + "/" + hash + "/META-INF/MANIFEST.MF";
+    free(hash);
+
+    //bundle is extracted once in the shared dir and used by both frameworks
+    long bndId1 = fw1->getFrameworkBundleContext()->installBundle(SIMPLE_TEST_BUNDLE1_LOCATION);
+    ASSERT_GE(bndId1, 0);
+    EXPECT_EQ(bundleEntry(fw1, bndId1, "META-INF/MANIFEST.MF"), expectedManifest);
+    struct stat st1{};
+    ASSERT_EQ(stat(expectedManifest.c_str(), &st1), 0);
+
+    long bndId2 = fw2->getFrameworkBundleContext()->installBundle(SIMPLE_TEST_BUNDLE1_LOCATION);
+    ASSERT_GE(bndId2, 0);
+    EXPECT_EQ(bundleEntry(fw2, bndId2, "META-INF/MANIFEST.MF"), expectedManifest);
+    struct stat st2{};
+    ASSERT_EQ(stat(expectedManifest.c_str(), &st2), 0);
+    EXPECT_EQ(st1.st_ino, st2.st_ino); //not re-extracted
+
+    //bundle libraries are loaded from the shared extracted bundle
+    long cxxBndId = fw1->getFrameworkBundleContext()->installBundle(SIMPLE_CXX_BUNDLE_LOC, true);
+    ASSERT_GE(cxxBndId, 0);
+    EXPECT_TRUE(celix_framework_isBundleActive(fw1->getCFramework(), cxxBndId));
+
+    //uninstalling the bundle does not remove the shared extracted bundle
+    fw1->getFrameworkBundleContext()->uninstallBundle(bndId1);
+    EXPECT_TRUE(celix_utils_fileExists(expectedManifest.c_str()));
+
+    fw1.reset();
+    fw2.reset();
+    celix_utils_deleteDirectory(sharedDir, nullptr);
+}
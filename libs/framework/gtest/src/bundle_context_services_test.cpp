@@ -27,11 +27,13 @@
 #include <condition_variable>
 #include <string.h>
 #include <future>
+#include <atomic>
 
 #include "celix_api.h"
 #include "celix_framework_factory.h"
 #include "celix_service_factory.h"
 #include "service_tracker_private.h"
+#include "bundle_context_private.h"
 
 class CelixBundleContextServicesTests : public ::testing::Test {
 public:
@@ -286,6 +288,49 @@ TEST_F(CelixBundleContextServicesTests, registerServiceAsync) {
     ASSERT_LT(celix_bundleContext_findService(ctx, calcName), 0L);
 };
 
+TEST_F(CelixBundleContextServicesTests, unregisterServiceInSameEventBatchAsAsyncRegistration) {
+    //Given a blocked event loop
+    std::promise<void> blockPromise{};
+    auto blockFuture = blockPromise.get_future();
+    celix_framework_fireGenericEvent(fw, -1, -1, "block", static_cast<void*>(&blockFuture), [](void* data) {
+        static_cast<std::future<void>*>(data)->wait();
+    }, nullptr, nullptr);
+
+    //When a service is registered async and unregistered - on the event loop - in an event queued after the
+    //registration, so that both events are handled in the same event batch
+    struct calc {
+        int (*calc)(int);
+    };
+    const char *calcName = "calc";
+    calc svc;
+    svc.calc = [](int n) -> int {
+        return n * 42;
+    };
+    long svcId = celix_bundleContext_registerServiceAsync(ctx, &svc, calcName, nullptr);
+    ASSERT_TRUE(svcId >= 0);
+
+    struct unregister_data {
+        celix_bundle_context_t* ctx;
+        long svcId;
+        std::promise<void> done{};
+    };
+    unregister_data data{ctx, svcId};
+    auto doneFuture = data.done.get_future();
+    celix_framework_fireGenericEvent(fw, -1, -1, "unregister", static_cast<void*>(&data), [](void* d) {
+        auto* ud = static_cast<unregister_data*>(d);
+        celix_bundleContext_unregisterService(ud->ctx, ud->svcId);
+    }, static_cast<void*>(&data), [](void* d) {
+        static_cast<unregister_data*>(d)->done.set_value();
+    });
+
+    //Then the already handled registration is not cancelled, but the service is unregistered.
+    //Note not using celix_framework_waitForEmptyEventQueue, because waiters cause early removal of handled events.
+    blockPromise.set_value();
+    ASSERT_EQ(std::future_status::ready, doneFuture.wait_for(std::chrono::seconds{5}));
+    EXPECT_LT(celix_bundleContext_findService(ctx, calcName), 0L);
+    celix_framework_waitForEmptyEventQueue(fw);
+}
+
 TEST_F(CelixBundleContextServicesTests, incorrectUnregisterCalls) {
     celix_bundleContext_unregisterService(ctx, 1);
     celix_bundleContext_unregisterService(ctx, 2);
@@ -1308,6 +1353,51 @@ TEST_F(CelixBundleContextServicesTests, findServicesTest) {
     celix_bundleContext_unregisterService(ctx, svcId2);
 }
 
+TEST_F(CelixBundleContextServicesTests, findServicesWithIndexedAttributesTest) {
+    //note service.id is indexed by default
+    long svcId1 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    long svcId2 = celix_bundleContext_registerService(ctx, (void*)0x100, "example", nullptr);
+    celix_properties_t* props = celix_properties_create();
+    celix_properties_set(props, CELIX_FRAMEWORK_SERVICE_NAME, "example"); //objectClass property differs from the service name
+    long svcId3 = celix_bundleContext_registerService(ctx, (void*)0x100, "other", props);
+
+    celix_service_filter_options_t opts{};
+    opts.serviceName = "example";
+    celix_array_list_t* list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    EXPECT_EQ(3, celix_arrayList_size(list)); //note filter is on objectClass
+    celix_arrayList_destroy(list);
+
+    char filter[64];
+    snprintf(filter, sizeof(filter), "(service.id=%li)", svcId2);
+    opts.filter = filter;
+    long foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    EXPECT_EQ(foundId, svcId2);
+
+    snprintf(filter, sizeof(filter), "(|(service.id=%li)(service.id=%li))", svcId1, svcId3);
+    list = celix_bundleContext_findServicesWithOptions(ctx, &opts);
+    EXPECT_EQ(2, celix_arrayList_size(list));
+    celix_arrayList_destroy(list);
+
+    snprintf(filter, sizeof(filter), "(&(service.id=%li)(service.id=%li))", svcId1, svcId3);
+    foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    EXPECT_EQ(-1L, foundId);
+
+    opts.serviceName = "other";
+    opts.filter = nullptr;
+    foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    EXPECT_EQ(-1L, foundId); //objectClass is "example"
+
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    opts.serviceName = "example";
+    snprintf(filter, sizeof(filter), "(service.id=%li)", svcId2);
+    opts.filter = filter;
+    foundId = celix_bundleContext_findServiceWithOptions(ctx, &opts);
+    EXPECT_EQ(-1L, foundId);
+
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId3);
+}
+
 TEST_F(CelixBundleContextServicesTests, trackServiceTrackerTest) {
 
     int count = 0;
@@ -1466,6 +1556,70 @@ TEST_F(CelixBundleContextServicesTests, UseServiceOnDemandDirectlyWithAsyncRegis
     celix_bundleContext_stopTracker(ctx, trkId);
 }
 
+TEST_F(CelixBundleContextServicesTests, UseServiceWithCachedTrackerTest) {
+    int count = 0;
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = "test";
+    opts.callbackHandle = &count;
+    opts.use = [](void *handle, void *) {
+        auto* c = static_cast<int*>(handle);
+        *c += 1;
+    };
+    opts.flags = CELIX_SERVICE_USE_CACHED;
+
+    bool called = celix_bundleContext_useServiceWithOptions(ctx, &opts);
+    EXPECT_FALSE(called); //service not available
+
+    void* svc = (void*)0x42;
+    long svcId1 = celix_bundleContext_registerService(ctx, svc, "test", nullptr);
+    long svcId2 = celix_bundleContext_registerService(ctx, svc, "test", nullptr);
+
+    //note cached tracker is reused, but should also track the newly registered services
+    called = celix_bundleContext_useServiceWithOptions(ctx, &opts);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(1, count);
+
+    size_t nrCalled = celix_bundleContext_useServicesWithOptions(ctx, &opts);
+    EXPECT_EQ(2, nrCalled);
+    EXPECT_EQ(3, count);
+
+    celix_bundleContext_unregisterService(ctx, svcId1);
+    celix_bundleContext_unregisterService(ctx, svcId2);
+    called = celix_bundleContext_useServiceWithOptions(ctx, &opts);
+    EXPECT_FALSE(called);
+    EXPECT_EQ(3, count);
+
+    //more filters than cache entries, should still work
+    long svcId3 = celix_bundleContext_registerService(ctx, svc, "test", nullptr);
+    for (int i = 0; i < 2 * CELIX_BUNDLE_CONTEXT_MAX_CACHED_USE_TRACKERS; ++i) {
+        std::string filter = std::string{"(!(key="} + std::to_string(i) + "))";
+        opts.filter.filter = filter.c_str();
+        called = celix_bundleContext_useServiceWithOptions(ctx, &opts);
+        EXPECT_TRUE(called);
+    }
+    celix_bundleContext_unregisterService(ctx, svcId3);
+}
+
+TEST_F(CelixBundleContextServicesTests, UseServiceWithCachedTrackerAndTimeoutTest) {
+    void* svc = (void*)0x42;
+    std::atomic<long> svcId{-1L};
+    std::thread registerThread{[&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        svcId = celix_bundleContext_registerService(ctx, svc, "test", nullptr);
+    }};
+
+    celix_service_use_options_t opts{};
+    opts.filter.serviceName = "test";
+    opts.waitTimeoutInSeconds = 5;
+    opts.use = [](void *, void *) {/*nop*/};
+    opts.flags = CELIX_SERVICE_USE_CACHED;
+    bool called = celix_bundleContext_useServiceWithOptions(ctx, &opts);
+    EXPECT_TRUE(called);
+
+    registerThread.join();
+    celix_bundleContext_unregisterService(ctx, svcId);
+}
+
 TEST_F(CelixBundleContextServicesTests, UseServicesOnDemandDirectlyWithAsyncRegisterTest) {
     //NOTE that even though service are registered async, they should be found by a useService call.
 
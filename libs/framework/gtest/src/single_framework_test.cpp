@@ -21,11 +21,18 @@
 #include <atomic>
 #include <chrono>
 #include <thread>
+#include <future>
+#include <vector>
 
 #include "celix_launcher.h"
 #include "celix_framework_factory.h"
 #include "celix_framework.h"
+#include "celix_bundle_context.h"
+#include "celix_dependency_manager.h"
+#include "celix_dm_component.h"
 #include "framework.h"
+#include "framework_private.h"
+#include "celix_constants.h"
 
 
 class CelixFramework : public ::testing::Test {
@@ -154,6 +161,202 @@ TEST_F(FrameworkFactory, testFactoryCreate) {
     celix_frameworkFactory_destroyFramework(fw);
 }
 
+TEST_F(FrameworkFactory, testEventQueueOverflow) {
+    //Given a framework with a small static event queue
+    auto* config = celix_properties_create();
+    celix_properties_setLong(config, CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE, 4);
+    framework_t* fw = celix_frameworkFactory_createFramework(config);
+    ASSERT_TRUE(fw != nullptr);
+
+    //When the event thread is blocked and more events are fired than fit in the static event queue
+    std::promise<void> blockPromise{};
+    auto blockFuture = blockPromise.get_future();
+    celix_framework_fireGenericEvent(fw, -1, -1, "block", static_cast<void*>(&blockFuture), [](void* data) {
+        static_cast<std::future<void>*>(data)->wait();
+    }, nullptr, nullptr);
+
+    struct callback_data {
+        std::vector<int> handled{};
+        int next{0};
+    };
+    callback_data cbData{};
+    const int nrOfEvents = 5 * CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE + 3;
+    for (int i = 0; i < nrOfEvents; ++i) {
+        celix_framework_fireGenericEvent(fw, -1, -1, "test", static_cast<void*>(&cbData), [](void* data) {
+            auto* d = static_cast<callback_data*>(data);
+            d->handled.push_back(d->next++);
+        }, nullptr, nullptr);
+    }
+    EXPECT_EQ(nrOfEvents + 1, __atomic_load_n(&fw->dispatcher.stats.queueDepth, __ATOMIC_RELAXED));
+
+    //Then all events are handled in order after the event thread is unblocked
+    blockPromise.set_value();
+    celix_framework_waitForEmptyEventQueue(fw);
+    ASSERT_EQ(nrOfEvents, cbData.handled.size());
+    for (int i = 0; i < nrOfEvents; ++i) {
+        EXPECT_EQ(i, cbData.handled[i]);
+    }
+
+    //And the event queue stats reflect the overflow
+    EXPECT_EQ(0, __atomic_load_n(&fw->dispatcher.stats.queueDepth, __ATOMIC_RELAXED));
+    EXPECT_GE(__atomic_load_n(&fw->dispatcher.stats.queueHighWaterMark, __ATOMIC_RELAXED), nrOfEvents + 1);
+    EXPECT_GT(__atomic_load_n(&fw->dispatcher.stats.nbBatches, __ATOMIC_RELAXED), 0);
+
+    celix_frameworkFactory_destroyFramework(fw);
+}
+
+TEST_F(FrameworkFactory, testShardedEventThreads) {
+    //Given a framework with 4 event threads and an installed bundle which is not handled by event thread 0
+    const int nrOfEventThreads = 4;
+    auto* config = celix_properties_create();
+    celix_properties_setLong(config, CELIX_FRAMEWORK_EVENT_THREADS, nrOfEventThreads);
+    framework_t* fw = celix_frameworkFactory_createFramework(config);
+    ASSERT_TRUE(fw != nullptr);
+    long bndId = celix_framework_installBundle(fw, SIMPLE_TEST_BUNDLE1_LOCATION, false);
+    ASSERT_GT(bndId, 0);
+    ASSERT_NE(0, bndId % nrOfEventThreads);
+    celix_framework_waitForEmptyEventQueue(fw);
+
+    //When event thread 0 is blocked
+    std::promise<void> blockPromise{};
+    auto blockFuture = blockPromise.get_future();
+    celix_framework_fireGenericEvent(fw, -1, -1, "block", static_cast<void*>(&blockFuture), [](void* data) {
+        static_cast<std::future<void>*>(data)->wait();
+    }, nullptr, nullptr);
+
+    //Then events for the bundle are still handled, in order and on an event thread
+    struct callback_data {
+        framework_t* fw{nullptr};
+        std::vector<int> handled{};
+        int next{0};
+        bool onEventLoop{true};
+    };
+    callback_data cbData{};
+    cbData.fw = fw;
+    const int nrOfEvents = 10;
+    long lastEventId = -1;
+    for (int i = 0; i < nrOfEvents; ++i) {
+        lastEventId = celix_framework_fireGenericEvent(fw, -1, bndId, "test", static_cast<void*>(&cbData), [](void* data) {
+            auto* d = static_cast<callback_data*>(data);
+            d->onEventLoop = d->onEventLoop && celix_framework_isCurrentThreadTheEventLoop(d->fw);
+            d->handled.push_back(d->next++);
+        }, nullptr, nullptr);
+    }
+    celix_framework_waitForGenericEvent(fw, lastEventId);
+    ASSERT_EQ(nrOfEvents, cbData.handled.size());
+    for (int i = 0; i < nrOfEvents; ++i) {
+        EXPECT_EQ(i, cbData.handled[i]);
+    }
+    EXPECT_TRUE(cbData.onEventLoop);
+
+    //And the event thread stats reflect the blocked event thread
+    celix_framework_event_thread_stats_t stats[nrOfEventThreads];
+    ASSERT_EQ(nrOfEventThreads, celix_framework_getEventThreadStats(fw, stats, nrOfEventThreads));
+    EXPECT_EQ(1, stats[0].queueDepth);
+    EXPECT_EQ(0, stats[bndId % nrOfEventThreads].queueDepth);
+    EXPECT_GE(stats[bndId % nrOfEventThreads].nbHandledEvents, nrOfEvents);
+    EXPECT_GE(stats[bndId % nrOfEventThreads].maxCallbackTime, stats[bndId % nrOfEventThreads].avgCallbackTime);
+
+    //When event thread 0 is unblocked, waiting for an empty event queue waits for all event threads
+    blockPromise.set_value();
+    celix_framework_waitForEmptyEventQueue(fw);
+    ASSERT_EQ(nrOfEventThreads, celix_framework_getEventThreadStats(fw, stats, nrOfEventThreads));
+    for (const auto& stat : stats) {
+        EXPECT_EQ(0, stat.queueDepth);
+    }
+    EXPECT_GE(stats[0].maxCallbackTime, stats[0].avgCallbackTime);
+    EXPECT_EQ(0, __atomic_load_n(&fw->dispatcher.stats.queueDepth, __ATOMIC_RELAXED));
+
+    celix_frameworkFactory_destroyFramework(fw);
+}
+
+TEST_F(FrameworkFactory, testServiceEventsOfBundlesOnDifferentShards) {
+    //Given a framework with 4 event threads and 3 started bundles handled by different event threads
+    const int nrOfEventThreads = 4;
+    auto* config = celix_properties_create();
+    celix_properties_setLong(config, CELIX_FRAMEWORK_EVENT_THREADS, nrOfEventThreads);
+    framework_t* fw = celix_frameworkFactory_createFramework(config);
+    ASSERT_TRUE(fw != nullptr);
+    std::vector<celix_bundle_context_t*> ctxs{};
+    for (const char* location : {SIMPLE_TEST_BUNDLE1_LOCATION, SIMPLE_TEST_BUNDLE2_LOCATION, SIMPLE_TEST_BUNDLE3_LOCATION}) {
+        long bndId = celix_framework_installBundle(fw, location, true);
+        ASSERT_GT(bndId, 0);
+        for (auto* ctx : ctxs) {
+            ASSERT_NE(celix_bundleContext_getBundleId(ctx) % nrOfEventThreads, bndId % nrOfEventThreads);
+        }
+        celix_bundle_context_t* ctx = nullptr;
+        bool called = celix_framework_useBundle(fw, true, bndId, static_cast<void*>(&ctx), [](void* handle, const celix_bundle_t* bnd) {
+            bundle_getContext(bnd, static_cast<celix_bundle_context_t**>(handle));
+        });
+        ASSERT_TRUE(called);
+        ASSERT_TRUE(ctx != nullptr);
+        ctxs.push_back(ctx);
+    }
+
+    //And a service tracker in the framework bundle which records the concurrent calls of its callbacks
+    struct callback_data {
+        std::atomic<int> active{0};
+        std::atomic<int> maxActive{0};
+        std::atomic<int> added{0};
+        std::atomic<int> removed{0};
+
+        void track(std::atomic<int>& count) {
+            int nrActive = ++active;
+            int max = maxActive.load();
+            while (nrActive > max && !maxActive.compare_exchange_weak(max, nrActive)) {
+                //retry with the updated max
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+            count += 1;
+            --active;
+        }
+    };
+    callback_data cbData{};
+    celix_service_tracking_options_t opts{};
+    opts.filter.serviceName = "sharded_test_service";
+    opts.callbackHandle = static_cast<void*>(&cbData);
+    opts.add = [](void* handle, void*) {
+        auto* d = static_cast<callback_data*>(handle);
+        d->track(d->added);
+    };
+    opts.remove = [](void* handle, void*) {
+        auto* d = static_cast<callback_data*>(handle);
+        d->track(d->removed);
+    };
+    auto* fwCtx = celix_framework_getFrameworkContext(fw);
+    long trkId = celix_bundleContext_trackServicesWithOptions(fwCtx, &opts);
+    ASSERT_GE(trkId, 0);
+    celix_framework_waitForEmptyEventQueue(fw);
+
+    //When every bundle concurrently registers and unregisters services async
+    const int nrOfServices = 50;
+    void* dummySvc = (void*)0x42;
+    std::vector<std::thread> threads{};
+    for (auto* ctx : ctxs) {
+        threads.emplace_back([ctx, dummySvc] {
+            std::vector<long> svcIds{};
+            for (int i = 0; i < nrOfServices; ++i) {
+                svcIds.push_back(celix_bundleContext_registerServiceAsync(ctx, dummySvc, "sharded_test_service", nullptr));
+            }
+            for (long svcId : svcIds) {
+                celix_bundleContext_unregisterServiceAsync(ctx, svcId, nullptr, nullptr);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    celix_framework_waitForEmptyEventQueue(fw);
+
+    //Then all service events are delivered to the tracker and its callbacks are never called concurrently
+    EXPECT_EQ(nrOfServices * (int)ctxs.size(), cbData.added.load());
+    EXPECT_EQ(nrOfServices * (int)ctxs.size(), cbData.removed.load());
+    EXPECT_EQ(1, cbData.maxActive.load());
+
+    celix_bundleContext_stopTracker(fwCtx, trkId);
+    celix_frameworkFactory_destroyFramework(fw);
+}
+
 TEST_F(FrameworkFactory, testFactoryCreateAndToManyStartAndStops) {
     framework_t* fw = celix_frameworkFactory_createFramework(nullptr);
     ASSERT_TRUE(fw != nullptr);
@@ -272,3 +475,192 @@ TEST_F(CelixFramework, testLaunchFrameworkWithConfig) {
     framework_destroy(fw);
 }
 
+TEST_F(CelixFramework, testLaunchFrameworkWithConfigAndConcurrentInstall) {
+    /* Rule: When a Celix framework is started with a config for auto starting bundles and multiple auto install threads,
+     * the specified bundle are installed concurrently, but with the same bundle ids as a sequential install.
+     */
+
+    auto* config = celix_properties_load(INSTALL_AND_START_BUNDLES_CONFIG_PROPERTIES_FILE);
+    ASSERT_TRUE(config != nullptr);
+    celix_properties_setLong(config, CELIX_FRAMEWORK_AUTO_INSTALL_THREADS, 4);
+
+    framework_t* fw = celix_frameworkFactory_createFramework(config);
+    ASSERT_TRUE(fw != nullptr);
+
+    auto* startedBundleIds = celix_framework_listBundles(fw);
+    auto* installedBundleIds = celix_framework_listInstalledBundles(fw);
+    EXPECT_EQ(celix_arrayList_size(startedBundleIds), 3);
+    EXPECT_EQ(celix_arrayList_size(installedBundleIds), 5);
+    celix_arrayList_destroy(startedBundleIds);
+    celix_arrayList_destroy(installedBundleIds);
+
+    const char* expectedLocations[] = {SIMPLE_TEST_BUNDLE1_LOCATION, SIMPLE_TEST_BUNDLE2_LOCATION, SIMPLE_TEST_BUNDLE3_LOCATION};
+    for (long bndId = 1; bndId <= 3; ++bndId) {
+        std::string location{};
+        bool called = celix_framework_useBundle(fw, true, bndId, &location, [](void* handle, const celix_bundle_t* bnd) {
+            const char* loc = nullptr;
+            bundle_getBundleLocation((celix_bundle_t*)bnd, &loc);
+            *static_cast<std::string*>(handle) = loc;
+        });
+        EXPECT_TRUE(called);
+        EXPECT_EQ(location, expectedLocations[bndId - 1]);
+    }
+
+    framework_stop(fw);
+    framework_waitForStop(fw);
+    framework_destroy(fw);
+}
+
+TEST_F(CelixFramework, testLaunchFrameworkWithConcurrentAutoStart) {
+    /* Rule: When a Celix framework is started with multiple auto start threads, the bundles of a auto start level are
+     * started concurrently, but a bundle is only started after the bundles in its Start-After manifest header.
+     * The framework started event is fired after all auto start bundles are started.
+     *
+     * Note start_after_test_bundle1 and start_after_test_bundle2 fail to start if the service of the bundle they
+     * should start after is not yet registered. The bundles are configured in the reverse order, mixed with
+     * independent bundles.
+     */
+    auto* config = celix_properties_create();
+    celix_properties_set(config, "CELIX_AUTO_START_1",
+                         START_AFTER_TEST_BUNDLE1_LOC " " SIMPLE_TEST_BUNDLE1_LOCATION " " START_AFTER_TEST_BUNDLE2_LOC " "
+                         SIMPLE_TEST_BUNDLE2_LOCATION " " START_AFTER_TEST_BUNDLE3_LOC " " SIMPLE_TEST_BUNDLE3_LOCATION);
+    celix_properties_setLong(config, CELIX_FRAMEWORK_AUTO_START_THREADS, 4);
+    celix_properties_setDouble(config, CELIX_FRAMEWORK_AUTO_START_TIMEOUT, 0.01); //note only reported
+
+    framework_t* fw = nullptr;
+    ASSERT_EQ(CELIX_SUCCESS, framework_create(&fw, config));
+
+    struct started_data {
+        framework_t* fw;
+        std::promise<int> nrOfActiveBundles;
+    };
+    started_data data{fw, {}};
+    auto nrOfActiveBundlesAtStarted = data.nrOfActiveBundles.get_future();
+    framework_listener_t listener{};
+    listener.handle = &data;
+    listener.frameworkEvent = [](void* l, framework_event_t* event) -> celix_status_t {
+        //note the framework listener is called with the listener, not the listener handle
+        auto* d = static_cast<started_data*>(static_cast<framework_listener_t*>(l)->handle);
+        if (event->type == OSGI_FRAMEWORK_EVENT_STARTED) {
+            auto* activeBundleIds = celix_framework_listBundles(d->fw);
+            d->nrOfActiveBundles.set_value(celix_arrayList_size(activeBundleIds));
+            celix_arrayList_destroy(activeBundleIds);
+        }
+        return CELIX_SUCCESS;
+    };
+    bundleContext_addFrameworkListener(celix_framework_getFrameworkContext(fw), &listener);
+    ASSERT_EQ(CELIX_SUCCESS, framework_start(fw));
+
+    ASSERT_EQ(std::future_status::ready, nrOfActiveBundlesAtStarted.wait_for(std::chrono::seconds{10}));
+    EXPECT_EQ(nrOfActiveBundlesAtStarted.get(), 6);
+
+    auto* installedBundleIds = celix_framework_listInstalledBundles(fw);
+    EXPECT_EQ(celix_arrayList_size(installedBundleIds), 6);
+    for (int i = 0; i < celix_arrayList_size(installedBundleIds); ++i) {
+        long bndId = celix_arrayList_getLong(installedBundleIds, i);
+        EXPECT_TRUE(celix_framework_isBundleActive(fw, bndId)) << "bundle " << bndId << " is not active";
+    }
+    celix_arrayList_destroy(installedBundleIds);
+
+    auto* ctx = celix_framework_getFrameworkContext(fw);
+    EXPECT_GE(celix_bundleContext_findService(ctx, "start_after_test_bundle1"), 0);
+    EXPECT_GE(celix_bundleContext_findService(ctx, "start_after_test_bundle2"), 0);
+    EXPECT_GE(celix_bundleContext_findService(ctx, "start_after_test_bundle3"), 0);
+
+    bundleContext_removeFrameworkListener(ctx, &listener);
+    framework_stop(fw);
+    framework_waitForStop(fw);
+    framework_destroy(fw);
+}
+
+TEST_F(CelixFramework, testFrameworkTrace) {
+    /* Rule: When a Celix framework is started with tracing enabled, the bundle install, library loading, activator
+     * create/start, component lifecycle and service registration spans are recorded and can be written as Chrome
+     * trace event JSON.
+     */
+    const char* traceFile = "celix_framework_trace_test.json";
+    remove(traceFile);
+    auto* config = celix_properties_create();
+    celix_properties_set(config, "CELIX_AUTO_START_1", SIMPLE_CXX_BUNDLE_LOC);
+    celix_properties_set(config, CELIX_FRAMEWORK_TRACE_FILE, traceFile);
+
+    framework_t* fw = celix_frameworkFactory_createFramework(config);
+    ASSERT_TRUE(fw != nullptr);
+    int dummySvc = 0;
+    auto* ctx = celix_framework_getFrameworkContext(fw);
+    auto* mng = celix_bundleContext_getDependencyManager(ctx);
+    auto* cmp = celix_dmComponent_create(ctx, "TraceTestCmp");
+    celix_dmComponent_addInterface(cmp, "TraceTestService", nullptr, &dummySvc, nullptr);
+    celix_dependencyManager_add(mng, cmp);
+
+    char* buf = nullptr;
+    size_t bufLen = 0;
+    FILE* stream = open_memstream(&buf, &bufLen);
+    EXPECT_TRUE(celix_framework_writeTrace(fw, stream));
+    fclose(stream);
+    std::string trace{buf};
+    free(buf);
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+    EXPECT_NE(trace.find("\"name\":\"install\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"extract\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"dlopen\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"activator start\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"component start\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"register service\""), std::string::npos);
+    EXPECT_NE(trace.find("\"detail\":\"TraceTestService\""), std::string::npos);
+    EXPECT_NE(trace.find("\"detail\":\"TraceTestCmp\""), std::string::npos);
+    celix_dependencyManager_remove(mng, cmp);
+
+    //trace file is written after the framework is started
+    FILE* file = fopen(traceFile, "r");
+    ASSERT_TRUE(file != nullptr);
+    fclose(file);
+    remove(traceFile);
+
+    framework_stop(fw);
+    framework_waitForStop(fw);
+    framework_destroy(fw);
+}
+
+TEST_F(CelixFramework, testFrameworkTraceFileFromEnvironment) {
+    /* Rule: When the trace file is configured with an environment variable, tracing is enabled and the trace file
+     * is written after the framework is started, the same as for a trace file in the framework config.
+     */
+    const char* traceFile = "celix_framework_env_trace_test.json";
+    remove(traceFile);
+    setenv(CELIX_FRAMEWORK_TRACE_FILE, traceFile, 1);
+    auto* config = celix_properties_create();
+    celix_properties_set(config, "CELIX_AUTO_START_1", SIMPLE_CXX_BUNDLE_LOC);
+    framework_t* fw = celix_frameworkFactory_createFramework(config);
+    unsetenv(CELIX_FRAMEWORK_TRACE_FILE);
+    ASSERT_TRUE(fw != nullptr);
+
+    std::string trace{};
+    FILE* file = fopen(traceFile, "r");
+    ASSERT_TRUE(file != nullptr);
+    char buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+        trace.append(buf, n);
+    }
+    fclose(file);
+    remove(traceFile);
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+    EXPECT_NE(trace.find("\"name\":\"install\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"activator start\""), std::string::npos);
+
+    framework_stop(fw);
+    framework_waitForStop(fw);
+    framework_destroy(fw);
+}
+
+TEST_F(CelixFramework, testFrameworkTraceDisabled) {
+    //note tracing is disabled by default
+    char* buf = nullptr;
+    size_t bufLen = 0;
+    FILE* stream = open_memstream(&buf, &bufLen);
+    EXPECT_FALSE(celix_framework_writeTrace(framework.get(), stream));
+    fclose(stream);
+    free(buf);
+}
+
@@ -138,6 +138,18 @@ namespace celix {
      */
     constexpr const char * const FRAMEWORK_STATIC_EVENT_QUEUE_SIZE = CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE;
 
+    /**
+     * @brief Celix framework environment property (named "CELIX_FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES") which
+     * configures, as a comma separated list, the service property keys for which the service registry keeps an
+     * equality index.
+     *
+     * The service registry always indexes services on service name. For filters which contain a mandatory equals
+     * for an indexed attribute only the services in the index are matched against the filter.
+     *
+     * Default is "service.id".
+     */
+    constexpr const char * const FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES = CELIX_FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES;
+
     /**
      * @brief Celix framework environment property (named "CELIX_AUTO_START_0") which specified a (ordered) space
      * separated set of bundles to load and auto start when the Celix framework is started.
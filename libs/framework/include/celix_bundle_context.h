@@ -784,6 +784,16 @@ typedef struct celix_service_use_options {
      * Note that it has no effect in indirect mode, in which case "service on demand" is supported.
      */
 #define CELIX_SERVICE_USE_SOD                 (2)
+    /**
+     * @brief Use a shared service tracker, which is cached in the bundle context, instead of creating and destroying
+     * a service tracker for every use call.
+     *
+     * The first use call for a service name, version range and filter combination opens a service tracker, which is
+     * kept open and reused by subsequent use calls - with the same combination - until the bundle is stopped or the
+     * cache is full. Callbacks are called from the caller thread (as with CELIX_SERVICE_USE_DIRECT).
+     * This avoids the event loop round trips of the default use call and is intended for frequently called use calls.
+     */
+#define CELIX_SERVICE_USE_CACHED              (4)
     int flags CELIX_OPTS_INIT;
 } celix_service_use_options_t;
 
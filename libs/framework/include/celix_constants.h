@@ -157,6 +157,15 @@ extern "C" {
 #define OSGI_FRAMEWORK_EXPORT_LIBRARY CELIX_FRAMEWORK_EXPORT_LIBRARY
 #define OSGI_FRAMEWORK_IMPORT_LIBRARY CELIX_FRAMEWORK_IMPORT_LIBRARY
 
+/**
+ * @brief Manifest header (named "Start-After") with a comma separated list of bundle symbolic names.
+ *
+ * When bundles are auto started concurrently (see CELIX_FRAMEWORK_AUTO_START_THREADS), a bundle is only started after
+ * the bundles with the listed symbolic names - and configured in the same CELIX_AUTO_START_n level - are started.
+ * Bundles in lower CELIX_AUTO_START_n levels are always started first.
+ */
+#define CELIX_FRAMEWORK_BUNDLE_START_AFTER "Start-After"
+
 /**
  * @brief Celix framework environment property (named "org.osgi.framework.storage") specifying the cache
  * directory used for the bundle caches.
@@ -173,6 +182,22 @@ extern "C" {
 #define OSGI_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_NAME CELIX_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_NAME
 #define OSGI_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_DEFAULT CELIX_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_DEFAULT
 
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_BUNDLE_CACHE_SHARED_DIR") specifying a
+ * directory where extracted bundles are stored keyed by the content hash of the bundle zip.
+ *
+ * If configured, a bundle is only extracted if no extracted bundle with the same content hash exists in the shared
+ * directory. The extracted bundle directories are treated as read-only and shared between bundle revisions,
+ * framework instances and framework restarts; the framework bundle cache (see CELIX_FRAMEWORK_FRAMEWORK_STORAGE)
+ * then only contains the per framework instance bundle state. The shared directory is never cleaned by the framework.
+ *
+ * @note Frameworks in the same process using the same shared directory will load the same bundle libraries (same
+ * library path), so the bundle libraries are loaded once instead of once per framework.
+ *
+ * If not specified, bundles are extracted in the framework bundle cache.
+ */
+#define CELIX_FRAMEWORK_BUNDLE_CACHE_SHARED_DIR "CELIX_FRAMEWORK_BUNDLE_CACHE_SHARED_DIR"
+
 /**
  * @brief Celix framework environment property (named "org.osgi.framework.uuid") specifying the UUID for the
  * framework UUID.
@@ -231,6 +256,94 @@ extern "C" {
  */
 #define CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE "CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE"
 
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_EVENT_THREADS") which configures the number
+ * of event threads used by the Celix framework.
+ *
+ * Events are sharded on the bundle id of the event (bundle id modulo the number of event threads), so the events
+ * of a single bundle are still handled in order, but generic events of bundles on different event threads can be
+ * handled concurrently.
+ * Events without a bundle (e.g. framework events) are handled by the event thread of the framework bundle.
+ * Service, bundle and framework events are delivered to the listeners of all bundles and are therefore not handled
+ * concurrently with events of other event threads.
+ * Every event thread has its own static event queue of size CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE.
+ *
+ * Default is CELIX_FRAMEWORK_DEFAULT_EVENT_THREADS which is 1, but can be override with a compiler define (same name).
+ */
+#define CELIX_FRAMEWORK_EVENT_THREADS "CELIX_FRAMEWORK_EVENT_THREADS"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES") which
+ * configures, as a comma separated list, the service property keys for which the service registry keeps an
+ * equality index.
+ *
+ * The service registry always indexes services on service name (objectClass). For filters which contain a
+ * mandatory equals for an indexed attribute (e.g. "(&(objectClass=Foo)(key=value))" with "key" indexed) only the
+ * services in the index are matched against the filter instead of all registered services.
+ *
+ * Default is CELIX_FRAMEWORK_DEFAULT_SERVICE_REGISTRY_INDEXED_ATTRIBUTES which is "service.id", but can be override
+ * with a compiler define (same name).
+ */
+#define CELIX_FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES "CELIX_FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_AUTO_INSTALL_THREADS") which configures the
+ * number of threads used to install the bundles of a CELIX_AUTO_START_n or CELIX_AUTO_INSTALL set.
+ *
+ * Installing a bundle extracts the bundle into the bundle cache and creates the bundle archive and revision.
+ * If more than 1 thread is configured, this is done concurrently for all bundles in a set. The bundles are then added
+ * to the framework and started in the configured order, so the bundle ids, installed events and start order are the
+ * same as with a sequential install.
+ *
+ * Default is CELIX_FRAMEWORK_DEFAULT_AUTO_INSTALL_THREADS which is 1 (sequential install), but can be override with a
+ * compiler define (same name).
+ */
+#define CELIX_FRAMEWORK_AUTO_INSTALL_THREADS "CELIX_FRAMEWORK_AUTO_INSTALL_THREADS"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_TRACE") which configures whether the framework
+ * records a trace of the bundle installs, bundle extractions, library loading, bundle activator create/start,
+ * dependency manager component lifecycle callbacks and service registrations.
+ *
+ * The trace can be written as Chrome trace event JSON using celix_framework_writeTrace or the celix::trace shell
+ * command.
+ *
+ * Default is CELIX_FRAMEWORK_DEFAULT_TRACE which is false, but can be override with a compiler define (same name).
+ */
+#define CELIX_FRAMEWORK_TRACE "CELIX_FRAMEWORK_TRACE"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_TRACE_FILE") which configures a file to write the
+ * framework trace to, after the framework is started and the configured bundles are installed and started.
+ *
+ * If configured, tracing is enabled (see CELIX_FRAMEWORK_TRACE).
+ */
+#define CELIX_FRAMEWORK_TRACE_FILE "CELIX_FRAMEWORK_TRACE_FILE"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_AUTO_START_THREADS") which configures the
+ * number of threads used to start the bundles of a CELIX_AUTO_START_n level.
+ *
+ * If more than 1 thread is configured, the bundles of a CELIX_AUTO_START_n level are started concurrently, respecting
+ * the CELIX_FRAMEWORK_BUNDLE_START_AFTER manifest header of the bundles. The levels are still started in order and
+ * the framework started event is fired after all auto start bundles are started.
+ *
+ * Default is CELIX_FRAMEWORK_DEFAULT_AUTO_START_THREADS which is 1 (sequential start in the configured order), but
+ * can be override with a compiler define (same name).
+ */
+#define CELIX_FRAMEWORK_AUTO_START_THREADS "CELIX_FRAMEWORK_AUTO_START_THREADS"
+
+/**
+ * @brief Celix framework environment property (named "CELIX_FRAMEWORK_AUTO_START_TIMEOUT") which configures the
+ * time in seconds after which a concurrently auto started bundle, which is still starting, is reported.
+ *
+ * The timeout is only reported (logged as a warning), the start of the bundle is not interrupted.
+ *
+ * Default is CELIX_FRAMEWORK_DEFAULT_AUTO_START_TIMEOUT which is 10 seconds, but can be override with a compiler
+ * define (same name).
+ */
+#define CELIX_FRAMEWORK_AUTO_START_TIMEOUT "CELIX_FRAMEWORK_AUTO_START_TIMEOUT"
+
 /**
  * @brief Celix framework environment property (named "CELIX_AUTO_START_0") which specified a (ordered) space
  * separated set of bundles to load and auto start when the Celix framework is started.
@@ -26,6 +26,7 @@
 #include "celix_log_level.h"
 #include "celix_array_list.h"
 #include <stdarg.h>
+#include <stdio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -207,6 +208,8 @@ celix_array_list_t* celix_framework_listInstalledBundles(celix_framework_t* fram
  * The Celix framework has an event queue which (among others) handles bundle events.
  * This function can be used to ensure that all queue event are handled, mainly useful
  * for testing.
+ * If multiple event threads are configured (CELIX_FRAMEWORK_EVENT_THREADS), this waits until the event queues
+ * of all event threads are empty.
  *
  * @param fw The Celix Framework
  */
@@ -269,6 +272,43 @@ void celix_framework_waitForGenericEvent(celix_framework_t *fw, long eventId);
  */
 void celix_framework_waitForStop(celix_framework_t *framework);
 
+/**
+ * @brief Writes the recorded framework trace as Chrome trace event JSON to the provided stream.
+ *
+ * The trace contains spans - with timestamps in microseconds and thread ids - for bundle installs, bundle
+ * extractions, library loading, bundle activator create/start, dependency manager component lifecycle callbacks and
+ * service registrations. The JSON can be viewed with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is enabled with the CELIX_FRAMEWORK_TRACE or CELIX_FRAMEWORK_TRACE_FILE framework property.
+ *
+ * @return true if tracing is enabled and the trace is written.
+ */
+bool celix_framework_writeTrace(celix_framework_t* fw, FILE* stream);
+
+/**
+ * @brief Statistics of a framework event thread.
+ */
+typedef struct celix_framework_event_thread_stats {
+    int queueDepth;             /**< Current number of queued events for the event thread. */
+    int queueHighWaterMark;     /**< Highest number of queued events for the event thread. */
+    long nbHandledEvents;       /**< Number of events handled by the event thread. */
+    long nbBatches;             /**< Number of event batches handled by the event thread. */
+    double avgCallbackTime;     /**< Average time in seconds spent handling a single event. */
+    double maxCallbackTime;     /**< Max time in seconds spent handling a single event. */
+} celix_framework_event_thread_stats_t;
+
+/**
+ * @brief Fills the provided stats array with (max nrOfStats) statistics of the framework event threads.
+ *
+ * The number of event threads is configured with the CELIX_FRAMEWORK_EVENT_THREADS framework property.
+ *
+ * @param fw The framework.
+ * @param stats The array to fill, can be NULL.
+ * @param nrOfStats The size of the stats array.
+ * @return The number of framework event threads.
+ */
+size_t celix_framework_getEventThreadStats(celix_framework_t* fw, celix_framework_event_thread_stats_t* stats, size_t nrOfStats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,6 +48,7 @@ static void bundleContext_cleanupBundleTrackers(bundle_context_t *ct);
 static void bundleContext_cleanupServiceTrackers(bundle_context_t *ctx);
 static void bundleContext_cleanupServiceTrackerTrackers(bundle_context_t *ctx);
 static void bundleContext_cleanupServiceRegistration(bundle_context_t* ctx);
+static void bundleContext_cleanupUseTrackers(bundle_context_t* ctx);
 static long celix_bundleContext_trackServicesWithOptionsInternal(celix_bundle_context_t *ctx, const celix_service_tracking_options_t *opts, bool async);
 
 celix_status_t bundleContext_create(framework_pt framework, celix_framework_logger_t*  logger, bundle_pt bundle, bundle_context_pt *bundle_context) {
@@ -72,6 +73,8 @@ celix_status_t bundleContext_create(framework_pt framework, celix_framework_logg
             context->serviceTrackers = hashMap_create(NULL,NULL,NULL,NULL);
             context->metaTrackers =  hashMap_create(NULL,NULL,NULL,NULL);
             context->stoppingTrackerEventIds = hashMap_create(NULL,NULL,NULL,NULL);
+            context->useTrackers = celix_stringHashMap_create();
+            celixThreadCondition_init(&context->useTrackersCond, NULL);
             context->nextTrackerId = 1L;
 
             *bundle_context = context;
@@ -98,6 +101,9 @@ celix_status_t bundleContext_destroy(bundle_context_pt context) {
     assert(celix_arrayList_size(context->svcRegistrations) == 0);
     celix_arrayList_destroy(context->svcRegistrations);
     hashMap_destroy(context->stoppingTrackerEventIds, false, false);
+    assert(celix_stringHashMap_size(context->useTrackers) == 0);
+    celix_stringHashMap_destroy(context->useTrackers);
+    celixThreadCondition_destroy(&context->useTrackersCond);
 
     celixThreadMutex_destroy(&context->mutex);
 
@@ -117,6 +123,7 @@ void celix_bundleContext_cleanup(celix_bundle_context_t *ctx) {
     bundleContext_cleanupBundleTrackers(ctx);
     bundleContext_cleanupServiceTrackers(ctx);
     bundleContext_cleanupServiceTrackerTrackers(ctx);
+    bundleContext_cleanupUseTrackers(ctx);
     bundleContext_cleanupServiceRegistration(ctx);
 }
 
@@ -1185,6 +1192,168 @@ static void celix_bundleContext_useServiceWithOptions_2_UseServiceTracker(void *
     d->called = celix_serviceTracker_useHighestRankingService(d->svcTracker, d->opts->filter.serviceName, 0, d->opts->callbackHandle, d->opts->use, d->opts->useWithProperties, d->opts->useWithOwner);
 }
 
+static celix_service_tracker_t* celix_bundleContext_createUseTracker(celix_bundle_context_t *ctx, const celix_service_use_options_t *opts) {
+    celix_bundle_context_use_service_data_t data = {0};
+    data.ctx = ctx;
+    data.opts = opts;
+    if (celix_framework_isCurrentThreadTheEventLoop(ctx->framework)) {
+        celix_bundleContext_useServiceWithOptions_1_CreateServiceTracker(&data);
+    } else {
+        long eventId = celix_framework_fireGenericEvent(ctx->framework, -1, celix_bundle_getId(ctx->bundle), "create cached use service tracker", &data, celix_bundleContext_useServiceWithOptions_1_CreateServiceTracker, NULL, NULL);
+        celix_framework_waitForGenericEvent(ctx->framework, eventId);
+    }
+    return data.svcTracker;
+}
+
+static void celix_bundleContext_destroyUseTrackerEntry(celix_bundle_context_t *ctx, celix_bundle_context_use_tracker_entry_t *entry) {
+    if (celix_framework_isCurrentThreadTheEventLoop(ctx->framework)) {
+        celix_serviceTracker_destroy(entry->tracker);
+    } else {
+        long eventId = celix_framework_fireGenericEvent(ctx->framework, -1, celix_bundle_getId(ctx->bundle), "close cached use service tracker", entry->tracker, (void *)celix_serviceTracker_destroy, NULL, NULL);
+        celix_framework_waitForGenericEvent(ctx->framework, eventId);
+    }
+    free(entry->key);
+    free(entry);
+}
+
+/**
+ * Returns the use tracker cache key for the service name, version range and filter of the provided use options,
+ * or NULL if the key could not be created.
+ */
+static char* celix_bundleContext_createUseTrackerKey(celix_bundle_context_t *ctx, const celix_service_use_options_t *opts) {
+    char* key = NULL;
+    int rc = asprintf(&key, "%s|%s|%s", opts->filter.serviceName,
+             opts->filter.versionRange == NULL ? "" : opts->filter.versionRange,
+             opts->filter.filter == NULL ? "" : opts->filter.filter);
+    if (rc < 0) {
+        fw_log(ctx->framework->logger, CELIX_LOG_LEVEL_WARNING, "Cannot create use tracker key for service %s, using the service without a cached use tracker", opts->filter.serviceName);
+        return NULL;
+    }
+    return key;
+}
+
+/**
+ * Returns a cached use tracker entry - with an increased use count - for the provided key and use options.
+ * Creates and caches a new use tracker if needed. Takes ownership of the key.
+ * If the cache is full and all cached use trackers are in use, an uncached use tracker entry is returned.
+ */
+static celix_bundle_context_use_tracker_entry_t* celix_bundleContext_retainUseTracker(celix_bundle_context_t *ctx, char *key, const celix_service_use_options_t *opts) {
+    celixThreadMutex_lock(&ctx->mutex);
+    celix_bundle_context_use_tracker_entry_t* entry = celix_stringHashMap_get(ctx->useTrackers, key);
+    if (entry != NULL) {
+        entry->useCount += 1;
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+    if (entry != NULL) {
+        free(key);
+        return entry;
+    }
+
+    celix_service_tracker_t* tracker = celix_bundleContext_createUseTracker(ctx, opts);
+    if (tracker == NULL) {
+        free(key);
+        return NULL;
+    }
+
+    celix_bundle_context_use_tracker_entry_t* newEntry = calloc(1, sizeof(*newEntry));
+    newEntry->key = key;
+    newEntry->tracker = tracker;
+    newEntry->useCount = 1;
+    celix_bundle_context_use_tracker_entry_t* evicted = NULL;
+
+    celixThreadMutex_lock(&ctx->mutex);
+    entry = celix_stringHashMap_get(ctx->useTrackers, key);
+    if (entry != NULL) {
+        //use tracker created concurrently, use that one
+        entry->useCount += 1;
+    } else {
+        entry = newEntry;
+        newEntry = NULL;
+        if (celix_stringHashMap_size(ctx->useTrackers) >= CELIX_BUNDLE_CONTEXT_MAX_CACHED_USE_TRACKERS) {
+            CELIX_STRING_HASH_MAP_ITERATE(ctx->useTrackers, iter) {
+                celix_bundle_context_use_tracker_entry_t* visit = iter.value.ptrValue;
+                if (visit->useCount == 0) {
+                    evicted = visit;
+                    break;
+                }
+            }
+            if (evicted != NULL) {
+                celix_stringHashMap_remove(ctx->useTrackers, evicted->key);
+            }
+        }
+        if (celix_stringHashMap_size(ctx->useTrackers) < CELIX_BUNDLE_CONTEXT_MAX_CACHED_USE_TRACKERS) {
+            entry->cached = true;
+            celix_stringHashMap_put(ctx->useTrackers, entry->key, entry);
+        }
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+
+    if (newEntry != NULL) {
+        celix_bundleContext_destroyUseTrackerEntry(ctx, newEntry);
+    }
+    if (evicted != NULL) {
+        celix_bundleContext_destroyUseTrackerEntry(ctx, evicted);
+    }
+    return entry;
+}
+
+static void celix_bundleContext_releaseUseTracker(celix_bundle_context_t *ctx, celix_bundle_context_use_tracker_entry_t *entry) {
+    celixThreadMutex_lock(&ctx->mutex);
+    entry->useCount -= 1;
+    bool destroy = !entry->cached && entry->useCount == 0;
+    celixThreadCondition_broadcast(&ctx->useTrackersCond);
+    celixThreadMutex_unlock(&ctx->mutex);
+    if (destroy) {
+        celix_bundleContext_destroyUseTrackerEntry(ctx, entry);
+    }
+}
+
+static bool celix_bundleContext_useServicesWithCachedTracker(celix_bundle_context_t *ctx, char *key, const celix_service_use_options_t *opts, bool useSingleService, size_t *countOut) {
+    bool called = false;
+    size_t count = 0;
+    celix_bundle_context_use_tracker_entry_t* entry = celix_bundleContext_retainUseTracker(ctx, key, opts);
+    if (entry != NULL) {
+        bool onEventLoop = celix_framework_isCurrentThreadTheEventLoop(ctx->framework);
+        if (!onEventLoop && (opts->flags & CELIX_SERVICE_USE_SOD)) {
+            celix_framework_waitUntilNoPendingRegistration(ctx->framework);
+        }
+        if (useSingleService) {
+            // Ignore timeout on the event loop: blocking the event loop prevents any progress to be made
+            called = celix_serviceTracker_useHighestRankingService(entry->tracker, NULL, onEventLoop ? 0 : opts->waitTimeoutInSeconds, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
+            count = called ? 1 : 0;
+        } else {
+            count = celix_serviceTracker_useServices(entry->tracker, opts->filter.serviceName, opts->callbackHandle, opts->use, opts->useWithProperties, opts->useWithOwner);
+            called = count > 0;
+        }
+        celix_bundleContext_releaseUseTracker(ctx, entry);
+    }
+    if (countOut != NULL) {
+        *countOut = count;
+    }
+    return called;
+}
+
+static void bundleContext_cleanupUseTrackers(bundle_context_t* ctx) {
+    celix_array_list_t* entries = celix_arrayList_create();
+    celixThreadMutex_lock(&ctx->mutex);
+    CELIX_STRING_HASH_MAP_ITERATE(ctx->useTrackers, iter) {
+        celix_arrayList_add(entries, iter.value.ptrValue);
+    }
+    celix_stringHashMap_clear(ctx->useTrackers);
+    for (int i = 0; i < celix_arrayList_size(entries); ++i) {
+        celix_bundle_context_use_tracker_entry_t* entry = celix_arrayList_get(entries, i);
+        while (entry->useCount > 0) {
+            celixThreadCondition_wait(&ctx->useTrackersCond, &ctx->mutex);
+        }
+    }
+    celixThreadMutex_unlock(&ctx->mutex);
+
+    for (int i = 0; i < celix_arrayList_size(entries); ++i) {
+        celix_bundleContext_destroyUseTrackerEntry(ctx, celix_arrayList_get(entries, i));
+    }
+    celix_arrayList_destroy(entries);
+}
+
 bool celix_bundleContext_useServiceWithOptions(
         celix_bundle_context_t *ctx,
         const celix_service_use_options_t *opts) {
@@ -1192,6 +1361,11 @@ bool celix_bundleContext_useServiceWithOptions(
         return false;
     }
 
+    char* key = (opts->flags & CELIX_SERVICE_USE_CACHED) ? celix_bundleContext_createUseTrackerKey(ctx, opts) : NULL;
+    if (key != NULL) {
+        return celix_bundleContext_useServicesWithCachedTracker(ctx, key, opts, true, NULL);
+    }
+
     celix_bundle_context_use_service_data_t data = {0};
     data.ctx = ctx;
     data.opts = opts;
@@ -1229,7 +1403,9 @@ bool celix_bundleContext_useServiceWithOptions(
 
             useServiceIsDone = timeoutNotUsed || timeoutExpired || called;
             if (!useServiceIsDone) {
-                usleep(10);
+                //wait - outside the event loop - until the tracker has a matching service or the timeout is expired
+                double remaining = opts->waitTimeoutInSeconds - celix_elapsedtime(CLOCK_MONOTONIC, startTime);
+                celix_serviceTracker_useHighestRankingService(data.svcTracker, opts->filter.serviceName, remaining, NULL, NULL, NULL, NULL);
             }
         } while (!useServiceIsDone);
     }
@@ -1252,6 +1428,13 @@ size_t celix_bundleContext_useServicesWithOptions(
         return 0;
     }
 
+    char* key = (opts->flags & CELIX_SERVICE_USE_CACHED) ? celix_bundleContext_createUseTrackerKey(ctx, opts) : NULL;
+    if (key != NULL) {
+        size_t count = 0;
+        celix_bundleContext_useServicesWithCachedTracker(ctx, key, opts, false, &count);
+        return count;
+    }
+
     celix_bundle_context_use_service_data_t data = {0};
     data.ctx = ctx;
     data.opts = opts;
@@ -26,6 +26,11 @@
 #include "celix_bundle_context.h"
 #include "listener_hook_service.h"
 #include "service_tracker.h"
+#include "celix_string_hash_map.h"
+
+#ifndef CELIX_BUNDLE_CONTEXT_MAX_CACHED_USE_TRACKERS
+#define CELIX_BUNDLE_CONTEXT_MAX_CACHED_USE_TRACKERS 32
+#endif
 
 typedef struct celix_bundle_context_bundle_tracker_entry {
 	celix_bundle_context_t *ctx;
@@ -70,6 +75,17 @@ typedef struct celix_bundle_context_service_tracker_tracker_entry {
     long createEventId;
 } celix_bundle_context_service_tracker_tracker_entry_t;
 
+/**
+ * A shared service tracker used for celix_bundleContext_useService(s)WithOptions calls with the
+ * CELIX_SERVICE_USE_CACHED flag.
+ */
+typedef struct celix_bundle_context_use_tracker_entry {
+    char* key; //service name, version range and filter
+    celix_service_tracker_t* tracker;
+    bool cached; //false if the cache was full when the entry was created
+    size_t useCount; //protected by ctx->mutex
+} celix_bundle_context_use_tracker_entry_t;
+
 struct celix_bundle_context {
 	celix_framework_t *framework;
 	celix_bundle_t *bundle;
@@ -82,6 +98,8 @@ struct celix_bundle_context {
 	hash_map_t *serviceTrackers; //key = trackerId, value = celix_bundle_context_service_tracker_entry_t*
 	hash_map_t *metaTrackers; //key = trackerId, value = celix_bundle_context_service_tracker_tracker_entry_t*
     hash_map_t *stoppingTrackerEventIds; //key = trackerId, value = eventId for stopping the tracker. Note id are only present if the stop tracking is queued.
+    celix_string_hash_map_t* useTrackers; //key = use tracker key, value = celix_bundle_context_use_tracker_entry_t*
+    celix_thread_cond_t useTrackersCond; //signaled when the use count of a use tracker entry is decreased
 };
 
 
@@ -27,6 +27,7 @@
 #include "celix_framework.h"
 #include "bundle_revision_private.h"
 #include "celix_framework_utils_private.h"
+#include "celix_bundle_cache.h"
 
 celix_status_t bundleRevision_create(celix_framework_t* fw, const char *root, const char *location, long revisionNr, const char *inputFile, bundle_revision_pt *bundle_revision) {
     assert(inputFile == NULL); //the inputFile arg is deprecated and should always be NULL"
@@ -42,11 +43,12 @@ celix_status_t bundleRevision_create(celix_framework_t* fw, const char *root, co
             free(revision);
             status = CELIX_FILE_IO_EXCEPTION;
         } else {
-            status = celix_framework_utils_extractBundle(fw, location, root);
+            char* bundleRoot = NULL;
+            status = celix_bundleCache_extractBundle(fw, location, root, &bundleRoot);
             status = CELIX_DO_IF(status, arrayList_create(&(revision->libraryHandles)));
             if (status == CELIX_SUCCESS) {
                 revision->revisionNr = revisionNr;
-                revision->root = strdup(root);
+                revision->root = bundleRoot;
                 revision->location = strdup(location);
 
                 *bundle_revision = revision;
@@ -56,6 +58,7 @@ celix_status_t bundleRevision_create(celix_framework_t* fw, const char *root, co
 				status = manifest_createFromFile(manifest, &revision->manifest);
             }
             else {
+                free(bundleRoot);
             	free(revision);
             }
 
@@ -35,7 +35,9 @@
  *  parameter can be used to point to the actual data. In the OSGi specification this is the inputstream.
  *
  * @param fw The Celix framework where to create the bundle revision.
- * @param root The root for this revision in which the bundle is extracted and state is stored.
+ * @param root The per framework instance dir for this revision in which the revision state is stored and - if no
+ *             shared bundle cache dir is configured - the bundle is extracted.
+ *             The dir with the extracted bundle is available as the revision root.
  * @param location The location associated with the revision
  * @param revisionNr The number of the revision
  * @param inputFile The (optional) location of the file to use as input for this revision
@@ -26,6 +26,7 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <sys/errno.h>
+#include <unistd.h>
 
 #include "celix_constants.h"
 #include "celix_log.h"
@@ -35,6 +36,7 @@
 #include "celix_bundle_context.h"
 #include "framework_private.h"
 #include "bundle_archive_private.h"
+#include "celix_framework_utils_private.h"
 
 #define FW_LOG(level, ...) \
     celix_framework_log(cache->fw->logger, (level), __FUNCTION__ , __FILE__, __LINE__, __VA_ARGS__)
@@ -42,6 +44,7 @@
 struct celix_bundle_cache {
     celix_framework_t* fw;
     char* cacheDir;
+    char* sharedDir; //optional dir with extracted bundles keyed by content hash, shared between framework instances
     bool deleteOnDestroy;
 };
 
@@ -77,6 +80,11 @@ celix_status_t celix_bundleCache_create(celix_framework_t* fw, celix_bundle_cach
         cache->deleteOnDestroy = false;
     }
 
+    const char* sharedDir = celix_bundleContext_getProperty(fwCtx, CELIX_FRAMEWORK_BUNDLE_CACHE_SHARED_DIR, NULL);
+    if (!celix_utils_isStringNullOrEmpty(sharedDir)) {
+        cache->sharedDir = celix_utils_strdup(sharedDir);
+    }
+
     *out = cache;
 	return CELIX_SUCCESS;
 }
@@ -87,6 +95,7 @@ celix_status_t celix_bundleCache_destroy(celix_bundle_cache_t* cache) {
         status = celix_bundleCache_delete(cache);
 	}
 	free(cache->cacheDir);
+	free(cache->sharedDir);
 	free(cache);
 	return status;
 }
@@ -192,3 +201,124 @@ celix_status_t celix_bundleCache_createArchive(celix_framework_t* fw, long id, c
 
 	return status;
 }
+
+static char* celix_bundleCache_readRevisionHash(const char* revisionDir) {
+    char path[512];
+    char hash[64];
+    char* result = NULL;
+    snprintf(path, sizeof(path), "%s/revision.hash", revisionDir);
+    FILE* file = fopen(path, "r");
+    if (file != NULL) {
+        if (fgets(hash, sizeof(hash), file) != NULL) {
+            result = celix_utils_strdup(hash);
+        }
+        fclose(file);
+    }
+    return result;
+}
+
+static celix_status_t celix_bundleCache_writeRevisionHash(const char* revisionDir, const char* hash) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/revision.hash", revisionDir);
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        return CELIX_FILE_IO_EXCEPTION;
+    }
+    fprintf(file, "%s", hash);
+    fclose(file);
+    return CELIX_SUCCESS;
+}
+
+/**
+ * @brief Extracts the bundle in the revision dir, unless the revision dir already contains the extracted bundle
+ * with the same content hash (e.g. when reloading a not cleaned cache).
+ */
+static celix_status_t celix_bundleCache_extractInRevisionDir(celix_bundle_cache_t* cache, const char* location, const char* hash, const char* revisionDir) {
+    char manifest[512];
+    snprintf(manifest, sizeof(manifest), "%s/META-INF/MANIFEST.MF", revisionDir);
+    char* storedHash = celix_bundleCache_readRevisionHash(revisionDir);
+    bool upToDate = storedHash != NULL && strcmp(storedHash, hash) == 0 && celix_utils_fileExists(manifest);
+    free(storedHash);
+    if (upToDate) {
+        FW_LOG(CELIX_LOG_LEVEL_TRACE, "Bundle `%s` with hash %s already extracted in `%s`", location, hash, revisionDir);
+        return CELIX_SUCCESS;
+    }
+    return celix_framework_utils_extractBundle(cache->fw, location, revisionDir);
+}
+
+/**
+ * @brief Extracts the bundle in the shared dir, unless the bundle with the same content hash is already extracted
+ * by this or another framework instance.
+ *
+ * The bundle is extracted in a tmp dir and then renamed to <sharedDir>/<hash>, so a shared bundle dir is always
+ * complete and concurrent framework instances can safely extract the same bundle.
+ */
+static celix_status_t celix_bundleCache_extractInSharedDir(celix_bundle_cache_t* cache, const char* location, const char* hash, char** bundleRootOut) {
+    char* root = NULL;
+    char* tmpDir = NULL;
+    asprintf(&root, "%s/%s", cache->sharedDir, hash);
+    if (celix_utils_directoryExists(root)) {
+        FW_LOG(CELIX_LOG_LEVEL_TRACE, "Using shared extracted bundle `%s` for bundle `%s`", root, location);
+        *bundleRootOut = root;
+        return CELIX_SUCCESS;
+    }
+
+    const char* err = NULL;
+    celix_status_t status = celix_utils_createDirectory(cache->sharedDir, false, &err);
+    if (status == CELIX_SUCCESS) {
+        asprintf(&tmpDir, "%s/.%s.XXXXXX", cache->sharedDir, hash);
+        if (mkdtemp(tmpDir) == NULL) {
+            err = strerror(errno);
+            free(tmpDir);
+            tmpDir = NULL;
+            status = CELIX_FILE_IO_EXCEPTION;
+        } else {
+            chmod(tmpDir, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+        }
+    }
+    status = CELIX_DO_IF(status, celix_framework_utils_extractBundle(cache->fw, location, tmpDir));
+    if (status == CELIX_SUCCESS && rename(tmpDir, root) != 0) {
+        if (errno == EEXIST || errno == ENOTEMPTY) {
+            //note extracted in the meantime by another framework instance
+            celix_utils_deleteDirectory(tmpDir, NULL);
+        } else {
+            err = strerror(errno);
+            status = CELIX_FILE_IO_EXCEPTION;
+        }
+    }
+    if (status != CELIX_SUCCESS && tmpDir != NULL) {
+        celix_utils_deleteDirectory(tmpDir, NULL);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        *bundleRootOut = root;
+    } else {
+        FW_LOG(CELIX_LOG_LEVEL_ERROR, "Cannot extract bundle `%s` to shared bundle cache dir `%s`: %s", location, cache->sharedDir, err != NULL ? err : "extract error");
+        free(root);
+    }
+    free(tmpDir);
+    return status;
+}
+
+celix_status_t celix_bundleCache_extractBundle(celix_framework_t* fw, const char* location, const char* revisionDir, char** bundleRootOut) {
+    celix_bundle_cache_t* cache = fw->cache;
+    *bundleRootOut = NULL;
+    struct timespec extractStart = celix_gettime(CLOCK_MONOTONIC);
+
+    char* hash = NULL;
+    celix_status_t status = celix_framework_utils_hashBundle(fw, location, &hash);
+    if (status == CELIX_SUCCESS && cache->sharedDir != NULL) {
+        status = celix_bundleCache_extractInSharedDir(cache, location, hash, bundleRootOut);
+    } else if (status == CELIX_SUCCESS) {
+        status = celix_bundleCache_extractInRevisionDir(cache, location, hash, revisionDir);
+        *bundleRootOut = status == CELIX_SUCCESS ? celix_utils_strdup(revisionDir) : NULL;
+    }
+    status = CELIX_DO_IF(status, celix_bundleCache_writeRevisionHash(revisionDir, hash));
+    if (status != CELIX_SUCCESS) {
+        free(*bundleRootOut);
+        *bundleRootOut = NULL;
+    }
+    free(hash);
+    celix_framework_traceSpan(fw, "bundle", "extract", -1, location, extractStart);
+    return status;
+}
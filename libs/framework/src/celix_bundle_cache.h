@@ -91,6 +91,27 @@ celix_status_t
 celix_bundleCache_createArchive(celix_framework_t *fw, long id, const char *location, const char *inputFile,
                                 bundle_archive_pt *archive);
 
+/**
+ * @brief Extracts the bundle for the provided location, if needed, and returns the dir containing the extracted bundle.
+ *
+ * Whether a bundle needs to be extracted is decided using a content hash of the bundle zip, which is stored in the
+ * revision dir (revision.hash).
+ * If the CELIX_FRAMEWORK_BUNDLE_CACHE_SHARED_DIR is configured, the bundle is extracted (once) to
+ * <sharedDir>/<hash> and that read-only dir is shared between revisions, framework instances and restarts.
+ * Otherwise the bundle is extracted in the revision dir, unless the revision dir already contains the bundle with
+ * the same content hash.
+ *
+ * @param fw The Celix framework.
+ * @param location The bundle location.
+ * @param revisionDir The (existing) per framework instance revision dir, used to store the revision state.
+ * @param[out] bundleRootOut The dir containing the extracted bundle. Caller is owner.
+ * @return Status code indication failure or success:
+ * 		- CELIX_SUCCESS when no errors are encountered.
+ * 		- CELIX_ILLEGAL_ARGUMENT If the bundle location is invalid.
+ * 		- CELIX_FILE_IO_EXCEPTION If the bundle cannot be hashed or extracted.
+ */
+celix_status_t celix_bundleCache_extractBundle(celix_framework_t* fw, const char* location, const char* revisionDir, char** bundleRootOut);
+
 /**
  * @brief Deletes the entire bundle cache.
  *
@@ -0,0 +1,178 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "celix_framework_trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "celix_threads.h"
+#include "celix_utils.h"
+#include "framework_private.h"
+
+typedef struct celix_framework_trace_event {
+    const char* category;
+    const char* name;
+    char* detail; //nullable
+    long bndId;
+    long tid;
+    double ts; //in microseconds, relative to the trace creation time
+    double dur; //in microseconds
+} celix_framework_trace_event_t;
+
+struct celix_framework_trace {
+    struct timespec created;
+    size_t maxEvents;
+
+    celix_thread_mutex_t mutex; //protects below
+    celix_framework_trace_event_t* events;
+    size_t size;
+    size_t cap;
+    size_t dropped;
+};
+
+static long g_nextTraceTid = 1; //atomic
+static __thread long g_traceTid = 0;
+
+/**
+ * @brief Returns a small (per process) unique id for the calling thread, assigned on first use.
+ */
+static long celix_frameworkTrace_tid(void) {
+    if (g_traceTid == 0) {
+        g_traceTid = __atomic_fetch_add(&g_nextTraceTid, 1, __ATOMIC_RELAXED);
+    }
+    return g_traceTid;
+}
+
+static double celix_frameworkTrace_toMicros(const struct timespec* from, const struct timespec* to) {
+    return (double)(to->tv_sec - from->tv_sec) * 1000000.0 + (double)(to->tv_nsec - from->tv_nsec) / 1000.0;
+}
+
+celix_framework_trace_t* celix_frameworkTrace_create(size_t maxEvents) {
+    celix_framework_trace_t* trace = calloc(1, sizeof(*trace));
+    trace->created = celix_gettime(CLOCK_MONOTONIC);
+    trace->maxEvents = maxEvents;
+    celixThreadMutex_create(&trace->mutex, NULL);
+    return trace;
+}
+
+void celix_frameworkTrace_destroy(celix_framework_trace_t* trace) {
+    if (trace != NULL) {
+        for (size_t i = 0; i < trace->size; ++i) {
+            free(trace->events[i].detail);
+        }
+        free(trace->events);
+        celixThreadMutex_destroy(&trace->mutex);
+        free(trace);
+    }
+}
+
+bool celix_framework_isTraceEnabled(celix_framework_t* fw) {
+    return fw != NULL && fw->trace != NULL;
+}
+
+void celix_framework_traceSpan(celix_framework_t* fw, const char* category, const char* name, long bndId, const char* detail, struct timespec start) {
+    if (!celix_framework_isTraceEnabled(fw)) {
+        return;
+    }
+    celix_framework_trace_t* trace = fw->trace;
+    struct timespec end = celix_gettime(CLOCK_MONOTONIC);
+    celix_framework_trace_event_t event;
+    event.category = category;
+    event.name = name;
+    event.detail = NULL;
+    event.bndId = bndId;
+    event.tid = celix_frameworkTrace_tid();
+    event.ts = celix_frameworkTrace_toMicros(&trace->created, &start);
+    event.dur = celix_frameworkTrace_toMicros(&start, &end);
+
+    celixThreadMutex_lock(&trace->mutex);
+    if (trace->size >= trace->maxEvents) {
+        trace->dropped += 1;
+        celixThreadMutex_unlock(&trace->mutex);
+        return;
+    }
+    if (trace->size == trace->cap) {
+        size_t newCap = trace->cap == 0 ? 256 : trace->cap * 2;
+        celix_framework_trace_event_t* newEvents = realloc(trace->events, newCap * sizeof(*newEvents));
+        if (newEvents == NULL) {
+            trace->dropped += 1;
+            celixThreadMutex_unlock(&trace->mutex);
+            return;
+        }
+        trace->events = newEvents;
+        trace->cap = newCap;
+    }
+    event.detail = detail == NULL ? NULL : celix_utils_strdup(detail);
+    trace->events[trace->size++] = event;
+    celixThreadMutex_unlock(&trace->mutex);
+}
+
+static void celix_frameworkTrace_writeString(FILE* stream, const char* str) {
+    fputc('"', stream);
+    for (const char* c = str; *c != '\0'; ++c) {
+        switch (*c) {
+            case '"':
+                fputs("\\\"", stream);
+                break;
+            case '\\':
+                fputs("\\\\", stream);
+                break;
+            case '\n':
+                fputs("\\n", stream);
+                break;
+            case '\t':
+                fputs("\\t", stream);
+                break;
+            default:
+                if ((unsigned char)*c < 0x20) {
+                    fprintf(stream, "\\u%04x", (unsigned char)*c);
+                } else {
+                    fputc(*c, stream);
+                }
+                break;
+        }
+    }
+    fputc('"', stream);
+}
+
+celix_status_t celix_frameworkTrace_write(celix_framework_trace_t* trace, FILE* stream) {
+    int pid = (int)getpid();
+    celixThreadMutex_lock(&trace->mutex);
+    fprintf(stream, "{\"traceEvents\":[\n");
+    fprintf(stream, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%i,\"tid\":0,\"args\":{\"name\":\"celix\"}}", pid);
+    for (size_t i = 0; i < trace->size; ++i) {
+        celix_framework_trace_event_t* event = &trace->events[i];
+        fprintf(stream, ",\n{\"name\":");
+        celix_frameworkTrace_writeString(stream, event->name);
+        fprintf(stream, ",\"cat\":");
+        celix_frameworkTrace_writeString(stream, event->category);
+        fprintf(stream, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%i,\"tid\":%li,\"args\":{\"bnd.id\":%li",
+                event->ts, event->dur, pid, event->tid, event->bndId);
+        if (event->detail != NULL) {
+            fprintf(stream, ",\"detail\":");
+            celix_frameworkTrace_writeString(stream, event->detail);
+        }
+        fprintf(stream, "}}");
+    }
+    fprintf(stream, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":%zu}}\n", trace->dropped);
+    celixThreadMutex_unlock(&trace->mutex);
+    return ferror(stream) ? CELIX_FILE_IO_EXCEPTION : CELIX_SUCCESS;
+}
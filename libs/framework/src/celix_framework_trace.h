@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_FRAMEWORK_TRACE_H_
+#define CELIX_FRAMEWORK_TRACE_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "celix_types.h"
+#include "celix_errno.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A framework trace, which records spans (name, start and duration) with monotonic timestamps and thread ids
+ * for the framework startup phases: bundle install and extraction, library loading, activator create/start,
+ * dependency manager component lifecycle callbacks and service registrations.
+ */
+typedef struct celix_framework_trace celix_framework_trace_t; //opaque
+
+/**
+ * @brief Creates a framework trace. The trace timestamps are relative to the creation time.
+ * @param maxEvents The max number of spans to record. Additional spans are dropped.
+ */
+celix_framework_trace_t* celix_frameworkTrace_create(size_t maxEvents);
+
+void celix_frameworkTrace_destroy(celix_framework_trace_t* trace);
+
+/**
+ * @brief Writes the recorded spans as Chrome trace event JSON (chrome://tracing or https://ui.perfetto.dev).
+ */
+celix_status_t celix_frameworkTrace_write(celix_framework_trace_t* trace, FILE* stream);
+
+/**
+ * @brief Returns whether tracing is enabled for the provided framework.
+ *
+ * Can be used to prevent preparing span details if tracing is disabled.
+ */
+bool celix_framework_isTraceEnabled(celix_framework_t* fw);
+
+/**
+ * @brief Records a span - from start till now - for the calling thread, if tracing is enabled for the framework.
+ *
+ * @param fw The framework. If NULL or if tracing is disabled, this function is a no-op.
+ * @param category The span category (e.g. "bundle", "component" or "service"). Must be a string literal.
+ * @param name The span name. Must be a string literal.
+ * @param bndId The bundle id of the span, or -1 if not applicable.
+ * @param detail Optional span detail (e.g. the bundle location or service name). Will be copied.
+ * @param start The start of the span, retrieved with celix_gettime(CLOCK_MONOTONIC).
+ */
+void celix_framework_traceSpan(celix_framework_t* fw, const char* category, const char* name, long bndId, const char* detail, struct timespec start);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELIX_FRAMEWORK_TRACE_H_ */
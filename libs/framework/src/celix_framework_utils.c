@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <dlfcn.h>
 #include <assert.h>
+#include <stdint.h>
 
 #include "bundle_archive.h"
 #include "celix_constants.h"
@@ -193,6 +194,88 @@ celix_status_t celix_framework_utils_extractBundle(celix_framework_t *fw, const
     return extracted ? CELIX_SUCCESS : CELIX_FILE_IO_EXCEPTION;
 }
 
+#define CELIX_FRAMEWORK_UTILS_HASH_READ_BUFFER_SIZE (64 * 1024)
+
+/* 128 bit FNV-1a, see http://www.isthe.com/chongo/tech/comp/fnv/ */
+#define FNV128_OFFSET_BASIS ((((unsigned __int128)0x6c62272e07bb0142ULL) << 64) | 0x62b821756295c58dULL)
+#define FNV128_PRIME ((((unsigned __int128)0x0000000001000000ULL) << 64) | 0x000000000000013BULL)
+
+static unsigned __int128 hashBytes(unsigned __int128 hash, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= data[i];
+        hash *= FNV128_PRIME;
+    }
+    return hash;
+}
+
+static bool hashBundlePath(celix_framework_t *fw, const char* bundlePath, unsigned __int128* hash) {
+    char* resolvedPath = resolveFileBundleUrl(fw, bundlePath, false);
+    FILE* file = resolvedPath != NULL ? fopen(resolvedPath, "r") : NULL;
+    if (file == NULL) {
+        FW_LOG(CELIX_LOG_LEVEL_ERROR, "Cannot open bundle `%s` to calculate the content hash", bundlePath);
+        free(resolvedPath);
+        return false;
+    }
+    uint8_t* buf = malloc(CELIX_FRAMEWORK_UTILS_HASH_READ_BUFFER_SIZE);
+    size_t read = buf != NULL ? fread(buf, 1, CELIX_FRAMEWORK_UTILS_HASH_READ_BUFFER_SIZE, file) : 0;
+    while (read > 0) {
+        *hash = hashBytes(*hash, buf, read);
+        read = fread(buf, 1, CELIX_FRAMEWORK_UTILS_HASH_READ_BUFFER_SIZE, file);
+    }
+    bool hashed = buf != NULL && ferror(file) == 0;
+    free(buf);
+    fclose(file);
+    free(resolvedPath);
+    return hashed;
+}
+
+static bool hashBundleEmbedded(celix_framework_t *fw, const char* embeddedBundle, unsigned __int128* hash) {
+    char* startSymbol = NULL;
+    char* endSymbol = NULL;
+    asprintf(&startSymbol, "%s%s%s", EMBEDDED_BUNDLE_PREFIX, embeddedBundle, EMBEDDED_BUNDLE_START_POSTFIX);
+    asprintf(&endSymbol, "%s%s%s", EMBEDDED_BUNDLE_PREFIX, embeddedBundle, EMBEDDED_BUNDLE_END_POSTFIX);
+
+    void* main = dlopen(NULL, RTLD_NOW);
+    const uint8_t* start = dlsym(main, startSymbol);
+    const uint8_t* end = dlsym(main, endSymbol);
+    dlclose(main);
+    free(startSymbol);
+    free(endSymbol);
+
+    if (start == NULL || end == NULL) {
+        FW_LOG(CELIX_LOG_LEVEL_ERROR, "Cannot calculate the content hash for embedded bundle `%s`, bundle symbols not found", embeddedBundle);
+        return false;
+    }
+    *hash = hashBytes(*hash, start, end - start);
+    return true;
+}
+
+celix_status_t celix_framework_utils_hashBundle(celix_framework_t *fw, const char *bundleURL, char** hashOut) {
+    *hashOut = NULL;
+    if (!celix_framework_utils_isBundleUrlValid(fw, bundleURL, false)) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+    char* trimmedUrl = celix_utils_trim(bundleURL);
+
+    bool hashed;
+    unsigned __int128 hash = FNV128_OFFSET_BASIS;
+    int fileSchemeLen = strlen(FILE_URL_SCHEME);
+    int embeddedSchemeLen = strlen(EMBEDDED_URL_SCHEME);
+    if (strncasecmp(FILE_URL_SCHEME, trimmedUrl, fileSchemeLen) == 0) {
+        hashed = hashBundlePath(fw, trimmedUrl+fileSchemeLen, &hash);
+    } else if (strncasecmp(EMBEDDED_URL_SCHEME, trimmedUrl, embeddedSchemeLen) == 0) {
+        hashed = hashBundleEmbedded(fw, trimmedUrl+embeddedSchemeLen, &hash);
+    } else {
+        hashed = hashBundlePath(fw, trimmedUrl, &hash);
+    }
+    free(trimmedUrl);
+
+    if (hashed) {
+        asprintf(hashOut, "%016llx%016llx", (unsigned long long)(hash >> 64), (unsigned long long)hash);
+    }
+    return *hashOut != NULL ? CELIX_SUCCESS : CELIX_FILE_IO_EXCEPTION;
+}
+
 bool celix_framework_utils_isBundleUrlValid(celix_framework_t *fw, const char *bundleURL, bool silent) {
     char* trimmedUrl = celix_utils_trim(bundleURL);
 
@@ -41,6 +41,20 @@ extern "C" {
  */
 celix_status_t celix_framework_utils_extractBundle(celix_framework_t *fw, const char *bundleURL,  const char* extractPath);
 
+/**
+ * @brief Calculates a content hash of the bundle zip for the provided bundle url.
+ *
+ * The hash is a 128 bit FNV-1a hash of the bundle zip content as a 32 character hex string and can be used to
+ * check whether an extracted bundle is still up to date, independent of file modification times.
+ *
+ * @param fw Optional Celix framework (used for logging).
+ *           If NULL the result of celix_frameworkLogger_globalLogger() will be used for logging.
+ * @param bundleURL The bundle url. Same format as for celix_framework_utils_extractBundle.
+ * @param[out] hashOut The content hash. Caller is owner.
+ * @return CELIX_SUCCESS if the hash is calculated.
+ */
+celix_status_t celix_framework_utils_hashBundle(celix_framework_t *fw, const char *bundleURL, char** hashOut);
+
 /**
  * @brief Checks whether the provided bundle url is valid.
  *
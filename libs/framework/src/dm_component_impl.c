@@ -28,6 +28,7 @@
 #include "celix_filter.h"
 #include "dm_component_impl.h"
 #include "celix_framework.h"
+#include "celix_framework_trace.h"
 
 static const char * const CELIX_DM_PRINT_OK_COLOR = "\033[92m";
 static const char * const CELIX_DM_PRINT_WARNING_COLOR = "\033[93m";
@@ -813,17 +814,21 @@ static bool celix_dmComponent_performTransition(celix_dm_component_t *component,
     celix_dmComponent_logTransition(component, currentState, desiredState);
 
     celix_status_t status = CELIX_SUCCESS;
+    const char* traceName = NULL; //set for transitions calling a component lifecycle callback
+    struct timespec transitionStart = celix_gettime(CLOCK_MONOTONIC);
     if (currentState == CELIX_DM_CMP_STATE_INACTIVE && desiredState == CELIX_DM_CMP_STATE_WAITING_FOR_REQUIRED) {
         celix_dmComponent_enableDependencies(component);
     } else if (currentState == CELIX_DM_CMP_STATE_WAITING_FOR_REQUIRED && desiredState == CELIX_DM_CMP_STATE_INITIALIZING) {
         //nop
     } else if (currentState == CELIX_DM_CMP_STATE_INITIALIZING && desiredState == CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED) {
+        traceName = "component init";
         if (component->callbackInit) {
             status = component->callbackInit(component->implementation);
         }
     } else if (currentState == CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED && desiredState == CELIX_DM_CMP_STATE_DEINITIALIZING) {
         //nop
     } else if (currentState == CELIX_DM_CMP_STATE_DEINITIALIZING && desiredState == CELIX_DM_CMP_STATE_INACTIVE) {
+        traceName = "component deinit";
         if (component->callbackDeinit) {
             status = component->callbackDeinit(component->implementation);
         }
@@ -831,6 +836,7 @@ static bool celix_dmComponent_performTransition(celix_dm_component_t *component,
     } else if (currentState == CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED && desiredState == CELIX_DM_CMP_STATE_STARTING) {
         //nop
     } else if (currentState == CELIX_DM_CMP_STATE_STARTING && desiredState == CELIX_DM_CMP_STATE_TRACKING_OPTIONAL) {
+        traceName = "component start";
         if (component->callbackStart) {
         	status = component->callbackStart(component->implementation);
         }
@@ -841,6 +847,7 @@ static bool celix_dmComponent_performTransition(celix_dm_component_t *component,
     } else if (currentState == CELIX_DM_CMP_STATE_TRACKING_OPTIONAL && desiredState == CELIX_DM_CMP_STATE_STOPPING) {
         //nop
     } else if (currentState == CELIX_DM_CMP_STATE_STOPPING && desiredState == CELIX_DM_CMP_STATE_INITIALIZED_AND_WAITING_FOR_REQUIRED) {
+        traceName = "component stop";
         celix_dmComponent_unregisterServices(component, false);
         if (component->callbackStop) {
         	status = component->callbackStop(component->implementation);
@@ -851,6 +858,11 @@ static bool celix_dmComponent_performTransition(celix_dm_component_t *component,
         assert(false); //should not be reached.
     }
 
+    if (traceName != NULL) {
+        celix_framework_t* fw = celix_bundleContext_getFramework(component->context);
+        celix_framework_traceSpan(fw, "component", traceName, celix_bundle_getId(celix_bundleContext_getBundle(component->context)), component->name, transitionStart);
+    }
+
     bool transition = true;
     if (status != CELIX_SUCCESS) {
         celix_bundleContext_log(component->context, CELIX_LOG_LEVEL_ERROR,
@@ -1064,9 +1076,8 @@ static void celix_dmComponent_printFullInfo(FILE *out, bool colors, celix_dm_com
         dm_interface_info_pt intfInfo = celix_arrayList_get(compInfo->interfaces, interfCnt);
         fprintf(out, "   |- %sInterface %i: %s%s\n", startColors, (interfCnt+1), intfInfo->name, endColors);
 
-        hash_map_iterator_t iter = hashMapIterator_construct((hash_map_pt) intfInfo->properties);
-        char *key = NULL;
-        while ((key = hashMapIterator_nextKey(&iter)) != NULL) {
+        const char *key = NULL;
+        CELIX_PROPERTIES_FOR_EACH(intfInfo->properties, key) {
             fprintf(out, "      | %15s = %s\n", key, celix_properties_get(intfInfo->properties, key, "!ERROR!"));
         }
     }
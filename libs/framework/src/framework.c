@@ -20,10 +20,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <stdbool.h>
 #include <uuid/uuid.h>
 #include <assert.h>
+#include <errno.h>
 #include <celix_log_utils.h>
 
 #include "celix_dependency_manager.h"
@@ -41,6 +43,7 @@
 #include "celix_log_constants.h"
 #include "celix_framework_utils_private.h"
 #include "bundle_archive_private.h"
+#include "celix_framework_trace.h"
 
 typedef celix_status_t (*create_function_fp)(bundle_context_t *context, void **userData);
 typedef celix_status_t (*start_function_fp)(void *userData, bundle_context_t *context);
@@ -156,7 +159,7 @@ celix_status_t fw_populateDependentGraph(framework_pt framework, bundle_pt expor
 
 void fw_fireBundleEvent(framework_pt framework, bundle_event_type_e, celix_framework_bundle_entry_t* entry);
 void fw_fireFrameworkEvent(framework_pt framework, framework_event_type_e eventType, celix_status_t errorCode);
-static void *fw_eventDispatcher(void *fw);
+static void *fw_eventDispatcher(void *data);
 
 celix_status_t fw_invokeBundleListener(framework_pt framework, bundle_listener_pt listener, bundle_event_pt event, bundle_pt bundle);
 celix_status_t fw_invokeFrameworkListener(framework_pt framework, framework_listener_pt listener, framework_event_pt event, bundle_pt bundle);
@@ -170,9 +173,12 @@ static celix_status_t frameworkActivator_stop(void * userData, bundle_context_t
 static celix_status_t frameworkActivator_destroy(void * userData, bundle_context_t *context);
 
 static void framework_autoStartConfiguredBundles(celix_framework_t *fw);
+static bool framework_isTraceConfigured(celix_framework_t* fw);
+static void framework_writeTraceFile(celix_framework_t* fw, const char* path);
 static void framework_autoInstallConfiguredBundles(celix_framework_t *fw);
-static void framework_autoInstallConfiguredBundlesForList(celix_framework_t *fw, const char *autoStart, celix_array_list_t *installedBundles);
+static void framework_autoInstallConfiguredBundlesForList(celix_framework_t *fw, const char* setName, const char *autoStart, celix_array_list_t *installedBundles);
 static void framework_autoStartConfiguredBundlesForList(celix_framework_t* fw, const celix_array_list_t *installedBundles);
+static void framework_autoStartConfiguredBundlesConcurrently(celix_framework_t* fw, const celix_array_list_t *installedBundles, int begin, int end, int nrOfThreads, double timeout);
 static void celix_framework_addToEventQueue(celix_framework_t *fw, const celix_framework_event_t* event);
 
 struct fw_bundleListener {
@@ -243,9 +249,22 @@ celix_status_t framework_create(framework_pt *out, celix_properties_t* config) {
     framework->configurationMap = config;
     framework->bundleListeners = celix_arrayList_create();
     framework->frameworkListeners = celix_arrayList_create();
-    framework->dispatcher.eventQueueCap = (int)celix_properties_getAsLong(config, CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE, CELIX_FRAMEWORK_DEFAULT_STATIC_EVENT_QUEUE_SIZE);
-    framework->dispatcher.eventQueue = malloc(sizeof(celix_framework_event_t) * framework->dispatcher.eventQueueCap);
-    framework->dispatcher.dynamicEventQueue = celix_arrayList_create();
+    int eventQueueCap = (int)celix_properties_getAsLong(config, CELIX_FRAMEWORK_STATIC_EVENT_QUEUE_SIZE, CELIX_FRAMEWORK_DEFAULT_STATIC_EVENT_QUEUE_SIZE);
+    int nrOfShards = (int)celix_properties_getAsLong(config, CELIX_FRAMEWORK_EVENT_THREADS, CELIX_FRAMEWORK_DEFAULT_EVENT_THREADS);
+    framework->dispatcher.nrOfShards = nrOfShards < 1 ? 1 : nrOfShards;
+    framework->dispatcher.shards = calloc(framework->dispatcher.nrOfShards, sizeof(celix_framework_event_shard_t));
+    for (int i = 0; i < framework->dispatcher.nrOfShards; ++i) {
+        celix_framework_event_shard_t* shard = &framework->dispatcher.shards[i];
+        shard->fw = framework;
+        shard->index = i;
+        celixThreadCondition_init(&shard->cond, NULL);
+        celixThreadMutex_create(&shard->handlingMutex, NULL);
+        shard->eventQueueCap = eventQueueCap;
+        shard->eventQueue = malloc(sizeof(celix_framework_event_t) * eventQueueCap);
+    }
+    if (framework_isTraceConfigured(framework)) {
+        framework->trace = celix_frameworkTrace_create(CELIX_FRAMEWORK_TRACE_MAX_EVENTS);
+    }
 
     //create and store framework uuid
     char uuid[37];
@@ -328,7 +347,7 @@ celix_status_t framework_destroy(framework_pt framework) {
             const char *bndName = celix_bundle_getSymbolicName(bnd);
             fw_log(framework->logger, CELIX_LOG_LEVEL_FATAL, "Cannot destroy framework. The use count of bundle %s (bnd id %li) is not 0, but %zu.", bndName, entry->bndId, count);
             celixThreadMutex_lock(&framework->dispatcher.mutex);
-            int nrOfRequests = framework->dispatcher.eventQueueSize + celix_arrayList_size(framework->dispatcher.dynamicEventQueue);
+            int nrOfRequests = framework->dispatcher.queueSize;
             celixThreadMutex_unlock(&framework->dispatcher.mutex);
             fw_log(framework->logger, CELIX_LOG_LEVEL_WARNING, "nr of request left: %i (should be 0).", nrOfRequests);
         }
@@ -380,8 +399,22 @@ celix_status_t framework_destroy(framework_pt framework) {
         arrayList_destroy(framework->frameworkListeners);
     }
 
-    assert(celix_arrayList_size(framework->dispatcher.dynamicEventQueue) == 0);
-    celix_arrayList_destroy(framework->dispatcher.dynamicEventQueue);
+    assert(framework->dispatcher.queueSize == 0);
+    fw_log(framework->logger, CELIX_LOG_LEVEL_DEBUG, "Event queue high water mark was %i, handled %li event batches.",
+           framework->dispatcher.stats.queueHighWaterMark, framework->dispatcher.stats.nbBatches);
+    for (int i = 0; i < framework->dispatcher.nrOfShards; ++i) {
+        celix_framework_event_shard_t* shard = &framework->dispatcher.shards[i];
+        if (framework->dispatcher.nrOfShards > 1) {
+            fw_log(framework->logger, CELIX_LOG_LEVEL_DEBUG,
+                   "Event thread %i: queue high water mark was %i, handled %li events in %li event batches, max callback time %f seconds.",
+                   i, shard->stats.queueHighWaterMark, shard->stats.nbHandled, shard->stats.nbBatches, shard->stats.maxCallbackTime);
+        }
+        free(shard->dynamicEventQueue.head);
+        free(shard->eventQueue);
+        celixThreadCondition_destroy(&shard->cond);
+        celixThreadMutex_destroy(&shard->handlingMutex);
+    }
+    free(framework->dispatcher.shards);
 
     celix_bundleCache_destroy(framework->cache);
 
@@ -393,10 +426,10 @@ celix_status_t framework_destroy(framework_pt framework) {
 	celixThreadCondition_destroy(&framework->shutdown.cond);
 
     celix_frameworkLogger_destroy(framework->logger);
+    celix_frameworkTrace_destroy(framework->trace);
 
     properties_destroy(framework->configurationMap);
 
-    free(framework->dispatcher.eventQueue);
     free(framework);
 
 	return status;
@@ -414,8 +447,17 @@ celix_status_t fw_init(framework_pt framework) {
     celixThreadMutex_unlock(&framework->shutdown.mutex);
 
 
-	celixThread_create(&framework->dispatcher.thread, NULL, fw_eventDispatcher, framework);
-	celixThread_setName(&framework->dispatcher.thread, "CelixEvent");
+    for (int i = 0; i < framework->dispatcher.nrOfShards; ++i) {
+        celix_framework_event_shard_t* shard = &framework->dispatcher.shards[i];
+        celixThread_create(&shard->thread, NULL, fw_eventDispatcher, shard);
+        if (i == 0) {
+            celixThread_setName(&shard->thread, "CelixEvent");
+        } else {
+            char name[16];
+            snprintf(name, sizeof(name), "CelixEvent-%i", i);
+            celixThread_setName(&shard->thread, name);
+        }
+    }
 
     bool cleanCache = celix_properties_getAsBool(framework->configurationMap, OSGI_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_NAME, OSGI_FRAMEWORK_FRAMEWORK_STORAGE_CLEAN_DEFAULT);
     if (cleanCache) {
@@ -507,8 +549,6 @@ celix_status_t framework_start(framework_pt framework) {
 	CELIX_DO_IF(status, fw_fireBundleEvent(framework, OSGI_FRAMEWORK_BUNDLE_EVENT_STARTED, entry));
     celix_framework_bundleEntry_decreaseUseCount(entry);
 
-	CELIX_DO_IF(status, fw_fireFrameworkEvent(framework, OSGI_FRAMEWORK_EVENT_STARTED, framework->bundleId));
-
 	if (status != CELIX_SUCCESS) {
        status = CELIX_BUNDLE_EXCEPTION;
        fw_logCode(framework->logger, CELIX_LOG_LEVEL_ERROR, status, "Could not start framework");
@@ -518,6 +558,15 @@ celix_status_t framework_start(framework_pt framework) {
     framework_autoStartConfiguredBundles(framework);
     framework_autoInstallConfiguredBundles(framework);
 
+    //note fired after the auto start, so that the framework started event is fired after all bundles are started.
+    CELIX_DO_IF(status, fw_fireFrameworkEvent(framework, OSGI_FRAMEWORK_EVENT_STARTED, framework->bundleId));
+
+    const char* traceFile = NULL;
+    fw_getProperty(framework, CELIX_FRAMEWORK_TRACE_FILE, NULL, &traceFile);
+    if (traceFile != NULL) {
+        framework_writeTraceFile(framework, traceFile);
+    }
+
 	if (status == CELIX_SUCCESS) {
         fw_log(framework->logger, CELIX_LOG_LEVEL_INFO, "Celix framework started");
         fw_log(framework->logger, CELIX_LOG_LEVEL_TRACE, "Celix framework started with uuid %s", celix_framework_getUUID(framework));
@@ -526,22 +575,81 @@ celix_status_t framework_start(framework_pt framework) {
 	return status;
 }
 
+/**
+ * Returns whether tracing is configured. Uses the same lookup as the bundle context properties (an environment variable
+ * overrides the config), because the configuration is not yet available through the framework bundle context.
+ */
+static bool framework_isTraceConfigured(celix_framework_t* fw) {
+    const char* traceFile = NULL;
+    fw_getProperty(fw, CELIX_FRAMEWORK_TRACE_FILE, NULL, &traceFile);
+    if (traceFile != NULL) {
+        return true;
+    }
+    const char* trace = NULL;
+    fw_getProperty(fw, CELIX_FRAMEWORK_TRACE, NULL, &trace);
+    bool enabled = CELIX_FRAMEWORK_DEFAULT_TRACE;
+    if (trace != NULL) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%s", trace);
+        char* trimmed = utils_stringTrim(buf);
+        if (strncasecmp("true", trimmed, strlen("true")) == 0) {
+            enabled = true;
+        } else if (strncasecmp("false", trimmed, strlen("false")) == 0) {
+            enabled = false;
+        }
+    }
+    return enabled;
+}
+
+static void framework_writeTraceFile(celix_framework_t* fw, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        fw_log(fw->logger, CELIX_LOG_LEVEL_ERROR, "Cannot open trace file %s: %s", path, strerror(errno));
+        return;
+    }
+    bool written = celix_framework_writeTrace(fw, file);
+    fclose(file);
+    if (written) {
+        fw_log(fw->logger, CELIX_LOG_LEVEL_INFO, "Framework startup trace written to %s", path);
+    }
+}
+
 static void framework_autoStartConfiguredBundles(celix_framework_t* fw) {
     bundle_context_t *fwCtx = framework_getContext(fw);
     const char* cosgiKeys[] = {"cosgi.auto.start.0","cosgi.auto.start.1","cosgi.auto.start.2","cosgi.auto.start.3","cosgi.auto.start.4","cosgi.auto.start.5","cosgi.auto.start.6"};
     const char* celixKeys[] = {CELIX_AUTO_START_0, CELIX_AUTO_START_1, CELIX_AUTO_START_2, CELIX_AUTO_START_3, CELIX_AUTO_START_4, CELIX_AUTO_START_5, CELIX_AUTO_START_6};
     celix_array_list_t *installedBundles = celix_arrayList_create();
+    struct timespec installStart = celix_gettime(CLOCK_MONOTONIC);
     size_t len = 7;
+    int levelEnd[7]; //end index (exclusive) of the installed bundles of a level
     for (int i = 0; i < len; ++i) {
         const char *autoStart = celix_bundleContext_getProperty(fwCtx, celixKeys[i], NULL);
         if (autoStart == NULL) {
             autoStart = celix_bundleContext_getProperty(fwCtx, cosgiKeys[i], NULL);
         }
         if (autoStart != NULL) {
-            framework_autoInstallConfiguredBundlesForList(fw, autoStart, installedBundles);
+            framework_autoInstallConfiguredBundlesForList(fw, celixKeys[i], autoStart, installedBundles);
+        }
+        levelEnd[i] = celix_arrayList_size(installedBundles);
+    }
+    double installTime = celix_elapsedtime(CLOCK_MONOTONIC, installStart);
+    struct timespec startStart = celix_gettime(CLOCK_MONOTONIC);
+    long nrOfThreads = celix_bundleContext_getPropertyAsLong(fwCtx, CELIX_FRAMEWORK_AUTO_START_THREADS, CELIX_FRAMEWORK_DEFAULT_AUTO_START_THREADS);
+    if (nrOfThreads > 1) {
+        double timeout = celix_bundleContext_getPropertyAsDouble(fwCtx, CELIX_FRAMEWORK_AUTO_START_TIMEOUT, CELIX_FRAMEWORK_DEFAULT_AUTO_START_TIMEOUT);
+        int begin = 0;
+        for (int i = 0; i < len; ++i) {
+            framework_autoStartConfiguredBundlesConcurrently(fw, installedBundles, begin, levelEnd[i], (int)nrOfThreads, timeout);
+            begin = levelEnd[i];
         }
+    } else {
+        framework_autoStartConfiguredBundlesForList(fw, installedBundles);
+    }
+    double startTime = celix_elapsedtime(CLOCK_MONOTONIC, startStart);
+    if (celix_arrayList_size(installedBundles) > 0) {
+        fw_log(fw->logger, CELIX_LOG_LEVEL_INFO, "Auto started %i bundles in %.3f ms (install: %.3f ms, start: %.3f ms)",
+               celix_arrayList_size(installedBundles), (installTime + startTime) * 1000.0, installTime * 1000.0, startTime * 1000.0);
     }
-    framework_autoStartConfiguredBundlesForList(fw, installedBundles);
     celix_arrayList_destroy(installedBundles);
 }
 
@@ -549,33 +657,142 @@ static void framework_autoInstallConfiguredBundles(celix_framework_t* fw) {
     bundle_context_t *fwCtx = framework_getContext(fw);
     const char* autoInstall = celix_bundleContext_getProperty(fwCtx, CELIX_AUTO_INSTALL, NULL);
     if (autoInstall != NULL) {
-        framework_autoInstallConfiguredBundlesForList(fw, autoInstall, NULL);
+        framework_autoInstallConfiguredBundlesForList(fw, CELIX_AUTO_INSTALL, autoInstall, NULL);
+    }
+}
+
+/**
+ * @brief Auto install entry. If the bundle id is >= 0, the archive for the bundle is created by a auto install
+ * worker thread.
+ */
+typedef struct celix_framework_auto_install_entry {
+    const char* location;
+    long bndId;
+    bundle_archive_t* archive;
+    celix_status_t status;
+} celix_framework_auto_install_entry_t;
+
+typedef struct celix_framework_auto_install_job {
+    celix_framework_t* fw;
+    celix_framework_auto_install_entry_t* entries;
+    size_t nrOfEntries;
+    size_t nextEntry; //atomic
+} celix_framework_auto_install_job_t;
+
+static void* framework_autoInstallWorker(void* data) {
+    celix_framework_auto_install_job_t* job = data;
+    size_t i = __atomic_fetch_add(&job->nextEntry, 1, __ATOMIC_RELAXED);
+    while (i < job->nrOfEntries) {
+        celix_framework_auto_install_entry_t* entry = &job->entries[i];
+        if (entry->bndId >= 0) {
+            entry->status = celix_bundleCache_createArchive(job->fw, entry->bndId, entry->location, NULL, &entry->archive);
+        }
+        i = __atomic_fetch_add(&job->nextEntry, 1, __ATOMIC_RELAXED);
     }
+    return NULL;
 }
 
+/**
+ * @brief Creates the bundle archives - i.e. extracts the bundles into the bundle cache and creates the bundle
+ * revisions - for the provided entries using (at most) nrOfThreads threads.
+ *
+ * The bundle ids are assigned upfront in the order of the entries, so that the bundle ids are the same as with a
+ * sequential install. Bundles which are already installed, have an invalid location or are listed twice are
+ * skipped and installed sequentially afterwards.
+ */
+static void framework_autoInstallCreateArchives(celix_framework_t* fw, celix_framework_auto_install_entry_t* entries, size_t nrOfEntries, long nrOfThreads) {
+    size_t nrOfArchives = 0;
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_framework_auto_install_entry_t* entry = &entries[i];
+        bool skip = !celix_framework_utils_isBundleUrlValid(fw, entry->location, true) || framework_getBundle(fw, entry->location) != NULL;
+        for (size_t k = 0; !skip && k < i; ++k) {
+            skip = strcmp(entries[k].location, entry->location) == 0;
+        }
+        if (!skip) {
+            entry->bndId = framework_getNextBundleId(fw);
+            nrOfArchives += 1;
+        }
+    }
+
+    celix_framework_auto_install_job_t job = {fw, entries, nrOfEntries, 0};
+    size_t nrOfWorkers = nrOfArchives < (size_t)nrOfThreads ? nrOfArchives : (size_t)nrOfThreads;
+    celix_thread_t workers[nrOfWorkers > 0 ? nrOfWorkers : 1];
+    size_t nrOfStartedWorkers = 0;
+    for (size_t i = 0; i < nrOfWorkers; ++i) {
+        if (celixThread_create(&workers[nrOfStartedWorkers], NULL, framework_autoInstallWorker, &job) == CELIX_SUCCESS) {
+            celixThread_setName(&workers[nrOfStartedWorkers], "CelixInstall");
+            nrOfStartedWorkers += 1;
+        }
+    }
+    framework_autoInstallWorker(&job); //note also handles the entries if no worker could be started
+    for (size_t i = 0; i < nrOfStartedWorkers; ++i) {
+        celixThread_join(workers[i], NULL);
+    }
+}
 
-static void framework_autoInstallConfiguredBundlesForList(celix_framework_t* fw, const char *autoStartIn, celix_array_list_t *installedBundles) {
+static void framework_autoInstallConfiguredBundlesForList(celix_framework_t* fw, const char* setName, const char *autoStartIn, celix_array_list_t *installedBundles) {
     bundle_context_t *fwCtx = framework_getContext(fw);
     char delims[] = " ";
     char *save_ptr = NULL;
     char *autoStart = celix_utils_strdup(autoStartIn);
+    if (autoStart == NULL) {
+        return;
+    }
 
-    if (autoStart != NULL) {
-        char *location = strtok_r(autoStart, delims, &save_ptr);
-        while (location != NULL) {
-            //first install
-            bundle_t *bnd = NULL;
-            celix_status_t  rc = bundleContext_installBundle(fwCtx, location, &bnd);
-            if (rc == CELIX_SUCCESS) {
-                if (installedBundles != NULL) {
-                    celix_arrayList_add(installedBundles, bnd);
-                }
-            } else {
-                printf("Could not install bundle '%s'\n", location);
+    celix_array_list_t* locations = celix_arrayList_create();
+    for (char *location = strtok_r(autoStart, delims, &save_ptr); location != NULL; location = strtok_r(NULL, delims, &save_ptr)) {
+        celix_arrayList_add(locations, location);
+    }
+    size_t nrOfEntries = celix_arrayList_size(locations);
+    celix_framework_auto_install_entry_t* entries = calloc(nrOfEntries > 0 ? nrOfEntries : 1, sizeof(*entries));
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        entries[i].location = celix_arrayList_get(locations, (int)i);
+        entries[i].bndId = -1L;
+    }
+    celix_arrayList_destroy(locations);
+
+    struct timespec start = celix_gettime(CLOCK_MONOTONIC);
+    long nrOfThreads = celix_bundleContext_getPropertyAsLong(fwCtx, CELIX_FRAMEWORK_AUTO_INSTALL_THREADS, CELIX_FRAMEWORK_DEFAULT_AUTO_INSTALL_THREADS);
+    if (nrOfThreads > 1 && nrOfEntries > 1) {
+        framework_autoInstallCreateArchives(fw, entries, nrOfEntries, nrOfThreads);
+    }
+    double createArchivesTime = celix_elapsedtime(CLOCK_MONOTONIC, start);
+
+    //install (add to the framework) in the configured order
+    for (size_t i = 0; i < nrOfEntries; ++i) {
+        celix_framework_auto_install_entry_t* entry = &entries[i];
+        bundle_t *bnd = NULL;
+        celix_status_t rc;
+        if (entry->archive != NULL) {
+            rc = fw_installBundle2(fw, &bnd, entry->bndId, entry->location, NULL, entry->archive);
+            bundle_archive_t* bndArchive = NULL;
+            if (rc == CELIX_SUCCESS && bundle_getArchive(bnd, &bndArchive) == CELIX_SUCCESS && bndArchive != entry->archive) {
+                //bundle was installed in the meantime, archive not used
+                bundleArchive_closeAndDelete(entry->archive);
+                bundleArchive_destroy(entry->archive);
+            } else if (rc == CELIX_FRAMEWORK_SHUTDOWN) {
+                bundleArchive_closeAndDelete(entry->archive);
+                bundleArchive_destroy(entry->archive);
+            }
+        } else if (entry->bndId >= 0) {
+            rc = entry->status;
+            fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, rc, "Could not install bundle");
+        } else {
+            rc = bundleContext_installBundle(fwCtx, entry->location, &bnd);
+        }
+        if (rc == CELIX_SUCCESS) {
+            if (installedBundles != NULL) {
+                celix_arrayList_add(installedBundles, bnd);
             }
-            location = strtok_r(NULL, delims, &save_ptr);
+        } else {
+            printf("Could not install bundle '%s'\n", entry->location);
         }
     }
+    double installTime = celix_elapsedtime(CLOCK_MONOTONIC, start);
+    fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG, "Installed %zu bundles of %s in %.3f ms (create archives with %li threads: %.3f ms, add bundles: %.3f ms)",
+           nrOfEntries, setName, installTime * 1000.0, nrOfThreads > 1 ? nrOfThreads : 1L, createArchivesTime * 1000.0, (installTime - createArchivesTime) * 1000.0);
+
+    free(entries);
     free(autoStart);
 }
 
@@ -596,6 +813,243 @@ static void framework_autoStartConfiguredBundlesForList(celix_framework_t* fw, c
     }
 }
 
+typedef enum celix_framework_auto_start_state {
+    CELIX_FRAMEWORK_AUTO_START_PENDING,
+    CELIX_FRAMEWORK_AUTO_START_STARTING,
+    CELIX_FRAMEWORK_AUTO_START_DONE
+} celix_framework_auto_start_state_e;
+
+/**
+ * @brief Auto start entry. An entry is started after all its start after entries are done.
+ */
+typedef struct celix_framework_auto_start_entry {
+    bundle_t* bnd;
+    long bndId;
+    celix_array_list_t* startAfter; //entries (celix_framework_auto_start_entry_t*) to start before this entry
+    celix_framework_auto_start_state_e state;
+    struct timespec startTime;
+    bool timeoutReported;
+} celix_framework_auto_start_entry_t;
+
+typedef struct celix_framework_auto_start_job {
+    celix_framework_t* fw;
+    double timeout;
+    celix_framework_auto_start_entry_t* entries;
+    size_t nrOfEntries;
+
+    celix_thread_mutex_t mutex; //protects below and the state, startTime and timeoutReported of the entries
+    celix_thread_cond_t cond;
+    size_t nrOfStarting;
+    size_t nrOfDone;
+} celix_framework_auto_start_job_t;
+
+/**
+ * @brief Resolves a installed bundle, so that the - not thread safe - resolver is not used by the auto start workers.
+ */
+static celix_status_t framework_autoStartResolveBundle(celix_framework_t* fw, bundle_t* bnd) {
+    celix_status_t status = CELIX_SUCCESS;
+    if (celix_bundle_getState(bnd) == CELIX_BUNDLE_STATE_INSTALLED) {
+        module_pt module = NULL;
+        bundle_getCurrentModule(bnd, &module);
+        if (!module_isResolved(module)) {
+            linked_list_pt wires = resolver_resolve(module);
+            status = wires == NULL ? CELIX_BUNDLE_EXCEPTION : framework_markResolvedModules(fw, wires);
+        }
+    }
+    return status;
+}
+
+/**
+ * @brief Adds the entries matching the symbolic names of the start after manifest header of the entry.
+ * Symbolic names not configured in the same level are ignored.
+ */
+static void framework_autoStartParseStartAfter(celix_framework_auto_start_job_t* job, celix_framework_auto_start_entry_t* entry) {
+    const char* startAfter = celix_bundle_getManifestValue(entry->bnd, CELIX_FRAMEWORK_BUNDLE_START_AFTER);
+    if (startAfter == NULL) {
+        return;
+    }
+    char* copy = celix_utils_strdup(startAfter);
+    char* savePtr = NULL;
+    for (char* token = strtok_r(copy, ",", &savePtr); token != NULL; token = strtok_r(NULL, ",", &savePtr)) {
+        char* name = celix_utils_trim(token);
+        bool found = false;
+        for (size_t i = 0; i < job->nrOfEntries; ++i) {
+            celix_framework_auto_start_entry_t* other = &job->entries[i];
+            if (other != entry && celix_utils_stringEquals(celix_bundle_getSymbolicName(other->bnd), name)) {
+                celix_arrayList_add(entry->startAfter, other);
+                found = true;
+            }
+        }
+        if (!found) {
+            fw_log(job->fw->logger, CELIX_LOG_LEVEL_DEBUG, "Ignoring start after %s for bundle %s, because %s is not auto started in the same level",
+                   name, celix_bundle_getSymbolicName(entry->bnd), name);
+        }
+        free(name);
+    }
+    free(copy);
+}
+
+/**
+ * @brief Returns the next entry to start or NULL if no entry can be started (yet). Should be called with the job mutex
+ * locked.
+ *
+ * If there are pending entries, but no entry can be started and no entry is starting, the start after headers contain
+ * a cycle. In that case the first pending entry is returned.
+ */
+static celix_framework_auto_start_entry_t* framework_autoStartNextEntry(celix_framework_auto_start_job_t* job) {
+    celix_framework_auto_start_entry_t* firstPending = NULL;
+    for (size_t i = 0; i < job->nrOfEntries; ++i) {
+        celix_framework_auto_start_entry_t* entry = &job->entries[i];
+        if (entry->state != CELIX_FRAMEWORK_AUTO_START_PENDING) {
+            continue;
+        }
+        if (firstPending == NULL) {
+            firstPending = entry;
+        }
+        bool ready = true;
+        for (int k = 0; ready && k < celix_arrayList_size(entry->startAfter); ++k) {
+            celix_framework_auto_start_entry_t* dep = celix_arrayList_get(entry->startAfter, k);
+            ready = dep->state == CELIX_FRAMEWORK_AUTO_START_DONE;
+        }
+        if (ready) {
+            return entry;
+        }
+    }
+    if (firstPending != NULL && job->nrOfStarting == 0) {
+        fw_log(job->fw->logger, CELIX_LOG_LEVEL_WARNING, "Cycle in the %s manifest headers, starting bundle %s (bnd id = %li) anyway",
+               CELIX_FRAMEWORK_BUNDLE_START_AFTER, celix_bundle_getSymbolicName(firstPending->bnd), firstPending->bndId);
+        return firstPending;
+    }
+    return NULL;
+}
+
+static void* framework_autoStartWorker(void* data) {
+    celix_framework_auto_start_job_t* job = data;
+    celixThreadMutex_lock(&job->mutex);
+    while (job->nrOfDone + job->nrOfStarting < job->nrOfEntries) {
+        celix_framework_auto_start_entry_t* entry = framework_autoStartNextEntry(job);
+        if (entry == NULL) {
+            celixThreadCondition_wait(&job->cond, &job->mutex);
+            continue;
+        }
+        entry->state = CELIX_FRAMEWORK_AUTO_START_STARTING;
+        entry->startTime = celix_gettime(CLOCK_MONOTONIC);
+        job->nrOfStarting += 1;
+        celixThreadMutex_unlock(&job->mutex);
+
+        if (celix_bundle_getState(entry->bnd) != OSGI_FRAMEWORK_BUNDLE_ACTIVE) {
+            bool started = celix_framework_startBundle(job->fw, entry->bndId);
+            if (!started) {
+                fw_log(job->fw->logger, CELIX_LOG_LEVEL_ERROR, "Could not start bundle %s (bnd id = %li)\n", entry->bnd->symbolicName, entry->bndId);
+            }
+        } else {
+            fw_log(job->fw->logger, CELIX_LOG_LEVEL_TRACE, "Cannot start bundle %s (bnd id = %li), because it is already started\n", entry->bnd->symbolicName, entry->bndId);
+        }
+        double elapsed = celix_elapsedtime(CLOCK_MONOTONIC, entry->startTime);
+
+        celixThreadMutex_lock(&job->mutex);
+        if (elapsed > job->timeout) {
+            fw_log(job->fw->logger, entry->timeoutReported ? CELIX_LOG_LEVEL_INFO : CELIX_LOG_LEVEL_WARNING, "Starting bundle %s (bnd id = %li) took %.3f s, which exceeds the auto start timeout of %.3f s",
+                   entry->bnd->symbolicName, entry->bndId, elapsed, job->timeout);
+        }
+        entry->state = CELIX_FRAMEWORK_AUTO_START_DONE;
+        job->nrOfStarting -= 1;
+        job->nrOfDone += 1;
+        celixThreadCondition_broadcast(&job->cond);
+    }
+    celixThreadMutex_unlock(&job->mutex);
+    return NULL;
+}
+
+/**
+ * @brief Starts the installed bundles in the range [begin, end) - i.e. the bundles of a single auto start level - using
+ * (at most) nrOfThreads worker threads.
+ *
+ * The bundles are first resolved on the calling thread, because the resolver is not thread safe. The calling thread
+ * then waits until all bundles are started and reports bundles which are still starting after the timeout.
+ */
+static void framework_autoStartConfiguredBundlesConcurrently(celix_framework_t* fw, const celix_array_list_t *installedBundles, int begin, int end, int nrOfThreads, double timeout) {
+    assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
+    if (begin >= end) {
+        return;
+    }
+
+    celix_framework_auto_start_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.fw = fw;
+    job.timeout = timeout;
+    job.entries = calloc(end - begin, sizeof(*job.entries));
+    for (int i = begin; i < end; ++i) {
+        bundle_t* bnd = celix_arrayList_get(installedBundles, i);
+        long bndId = celix_bundle_getId(bnd);
+        bool duplicate = false;
+        for (size_t k = 0; !duplicate && k < job.nrOfEntries; ++k) {
+            duplicate = job.entries[k].bndId == bndId;
+        }
+        if (duplicate) {
+            continue;
+        }
+        celix_status_t status = framework_autoStartResolveBundle(fw, bnd);
+        if (status != CELIX_SUCCESS) {
+            fw_logCode(fw->logger, CELIX_LOG_LEVEL_ERROR, status, "Could not resolve bundle %s (bnd id = %li)", bnd->symbolicName, bndId);
+            continue;
+        }
+        celix_framework_auto_start_entry_t* entry = &job.entries[job.nrOfEntries++];
+        entry->bnd = bnd;
+        entry->bndId = bndId;
+        entry->startAfter = celix_arrayList_create();
+        entry->state = CELIX_FRAMEWORK_AUTO_START_PENDING;
+    }
+    for (size_t i = 0; i < job.nrOfEntries; ++i) {
+        framework_autoStartParseStartAfter(&job, &job.entries[i]);
+    }
+
+    celixThreadMutex_create(&job.mutex, NULL);
+    celixThreadCondition_init(&job.cond, NULL);
+    size_t nrOfWorkers = job.nrOfEntries < (size_t)nrOfThreads ? job.nrOfEntries : (size_t)nrOfThreads;
+    celix_thread_t* workers = calloc(nrOfWorkers, sizeof(*workers));
+    for (size_t i = 0; i < nrOfWorkers; ++i) {
+        celixThread_create(&workers[i], NULL, framework_autoStartWorker, &job);
+        celixThread_setName(&workers[i], "CelixAutoStart");
+    }
+
+    celixThreadMutex_lock(&job.mutex);
+    while (job.nrOfDone < job.nrOfEntries) {
+        double wait = timeout > 0 ? timeout : 1.0;
+        for (size_t i = 0; i < job.nrOfEntries; ++i) {
+            celix_framework_auto_start_entry_t* entry = &job.entries[i];
+            if (entry->state != CELIX_FRAMEWORK_AUTO_START_STARTING || entry->timeoutReported) {
+                continue;
+            }
+            double elapsed = celix_elapsedtime(CLOCK_MONOTONIC, entry->startTime);
+            if (elapsed >= timeout) {
+                fw_log(fw->logger, CELIX_LOG_LEVEL_WARNING, "Bundle %s (bnd id = %li) is still starting after %.3f s",
+                       entry->bnd->symbolicName, entry->bndId, elapsed);
+                entry->timeoutReported = true;
+            } else if (timeout - elapsed < wait) {
+                wait = timeout - elapsed;
+            }
+        }
+        long seconds = (long)wait;
+        long nanoseconds = (long)((wait - (double)seconds) * 1000000000.0);
+        celixThreadCondition_timedwaitRelative(&job.cond, &job.mutex, seconds, nanoseconds);
+    }
+    celixThreadMutex_unlock(&job.mutex);
+
+    for (size_t i = 0; i < nrOfWorkers; ++i) {
+        celixThread_join(workers[i], NULL);
+    }
+    fw_log(fw->logger, CELIX_LOG_LEVEL_DEBUG, "Started %zu bundles using %zu threads", job.nrOfEntries, nrOfWorkers);
+
+    free(workers);
+    celixThreadCondition_destroy(&job.cond);
+    celixThreadMutex_destroy(&job.mutex);
+    for (size_t i = 0; i < job.nrOfEntries; ++i) {
+        celix_arrayList_destroy(job.entries[i].startAfter);
+    }
+    free(job.entries);
+}
+
 celix_status_t framework_stop(framework_pt framework) {
     bool stopped = celix_framework_stopBundle(framework, CELIX_FRAMEWORK_BUNDLE_ID);
     return stopped ? CELIX_SUCCESS : CELIX_ILLEGAL_STATE;
@@ -638,6 +1092,7 @@ celix_status_t fw_installBundle2(framework_pt framework, bundle_pt * bundle, lon
     if (!valid) {
         return CELIX_FILE_IO_EXCEPTION;
     }
+    struct timespec installStart = celix_gettime(CLOCK_MONOTONIC);
 
     //increase use count of framework bundle to prevent a stop.
     celix_framework_bundle_entry_t *entry = celix_framework_bundleEntry_getBundleEntryAndIncreaseUseCount(framework,
@@ -685,6 +1140,7 @@ celix_status_t fw_installBundle2(framework_pt framework, bundle_pt * bundle, lon
             celixThreadMutex_unlock(&framework->installedBundles.mutex);
             fw_fireBundleEvent(framework, OSGI_FRAMEWORK_BUNDLE_EVENT_INSTALLED, bEntry);
             celix_framework_bundleEntry_decreaseUseCount(bEntry);
+            celix_framework_traceSpan(framework, "bundle", "install", bndId, bndLoc, installStart);
         } else {
             status = CELIX_BUNDLE_EXCEPTION;
             status = CELIX_DO_IF(status, bundleArchive_closeAndDelete(archive));
@@ -1370,12 +1826,17 @@ static void* framework_shutdown(void *framework) {
         celix_framework_bundleEntry_decreaseUseCount(fwEntry);
     }
 
-    //join dispatcher thread
+    //join dispatcher threads
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     fw->dispatcher.active = false;
+    for (int i = 0; i < fw->dispatcher.nrOfShards; ++i) {
+        celixThreadCondition_broadcast(&fw->dispatcher.shards[i].cond);
+    }
     celixThreadCondition_broadcast(&fw->dispatcher.cond);
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
-    celixThread_join(fw->dispatcher.thread, NULL);
+    for (int i = 0; i < fw->dispatcher.nrOfShards; ++i) {
+        celixThread_join(fw->dispatcher.shards[i].thread, NULL);
+    }
     fw_log(fw->logger, CELIX_LOG_LEVEL_TRACE, "Joined event loop thread for framework %s", celix_framework_getUUID(framework));
 
 
@@ -1442,33 +1903,139 @@ void fw_fireFrameworkEvent(framework_pt framework, framework_event_type_e eventT
     celix_framework_addToEventQueue(framework, &event);
 }
 
+/**
+ * Returns the event shard for the event. Events are sharded on bundle id, events without a bundle are handled by
+ * the event shard of the framework bundle.
+ * Note that the bundle id is the source of the event and not always the target, see fw_lockEventTargets.
+ */
+static celix_framework_event_shard_t* celix_framework_getEventShard(celix_framework_t* fw, const celix_framework_event_t* event) {
+    long bndId = event->bndEntry != NULL ? event->bndEntry->bndId : CELIX_FRAMEWORK_BUNDLE_ID;
+    return &fw->dispatcher.shards[bndId % fw->dispatcher.nrOfShards];
+}
+
+/**
+ * Adds an event to the dynamic (segmented) event queue of a shard. Should be called with the dispatcher mutex locked.
+ */
+static void celix_framework_addToDynamicEventQueue(celix_framework_event_shard_t* shard, const celix_framework_event_t* event) {
+    if (shard->dynamicEventQueue.tail == NULL) {
+        shard->dynamicEventQueue.tail = malloc(sizeof(celix_framework_event_segment_t));
+        shard->dynamicEventQueue.tail->next = NULL;
+        shard->dynamicEventQueue.head = shard->dynamicEventQueue.tail;
+        shard->dynamicEventQueue.headIndex = 0;
+        shard->dynamicEventQueue.tailIndex = 0;
+    } else if (shard->dynamicEventQueue.tailIndex == CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE) {
+        celix_framework_event_segment_t* segment = malloc(sizeof(*segment));
+        segment->next = NULL;
+        shard->dynamicEventQueue.tail->next = segment;
+        shard->dynamicEventQueue.tail = segment;
+        shard->dynamicEventQueue.tailIndex = 0;
+    }
+    shard->dynamicEventQueue.tail->events[shard->dynamicEventQueue.tailIndex++] = *event; //shallow copy
+    shard->dynamicEventQueue.size += 1;
+}
+
 static void celix_framework_addToEventQueue(celix_framework_t *fw, const celix_framework_event_t* event) {
     celixThreadMutex_lock(&fw->dispatcher.mutex);
+    celix_framework_event_shard_t* shard = celix_framework_getEventShard(fw, event);
+    bool wasEmpty = shard->eventQueueSize == 0 && shard->dynamicEventQueue.size == 0;
     //try to add to static queue
-    if (celix_arrayList_size(fw->dispatcher.dynamicEventQueue) > 0) { //always to dynamic queue if not empty (to ensure order)
-        celix_framework_event_t *e = malloc(sizeof(*e));
-        *e = *event; //shallow copy
-        celix_arrayList_add(fw->dispatcher.dynamicEventQueue, e);
-        if (celix_arrayList_size(fw->dispatcher.dynamicEventQueue) % 100 == 0) {
-            fw_log(fw->logger, CELIX_LOG_LEVEL_WARNING, "dynamic event queue size is %i. Is there a bundle blocking on the event loop thread?", celix_arrayList_size(fw->dispatcher.dynamicEventQueue));
-        }
-    } else if (fw->dispatcher.eventQueueSize < fw->dispatcher.eventQueueCap) {
-        size_t index = (fw->dispatcher.eventQueueFirstEntry + fw->dispatcher.eventQueueSize) %
-                       fw->dispatcher.eventQueueCap;
-        fw->dispatcher.eventQueue[index] = *event; //shallow copy
-        fw->dispatcher.eventQueueSize += 1;
+    if (shard->dynamicEventQueue.size > 0) { //always to dynamic queue if not empty (to ensure order)
+        celix_framework_addToDynamicEventQueue(shard, event);
+        if (shard->dynamicEventQueue.size % 100 == 0) {
+            fw_log(fw->logger, CELIX_LOG_LEVEL_WARNING, "dynamic event queue size of event thread %i is %i. Is there a bundle blocking on the event loop thread?", shard->index, shard->dynamicEventQueue.size);
+        }
+    } else if (shard->eventQueueSize < shard->eventQueueCap) {
+        size_t index = (shard->eventQueueFirstEntry + shard->eventQueueSize) % shard->eventQueueCap;
+        shard->eventQueue[index] = *event; //shallow copy
+        shard->eventQueueSize += 1;
     } else {
         //static queue is full, dynamics queue is empty. Add first entry to dynamic queue
         fw_log(fw->logger, CELIX_LOG_LEVEL_WARNING,
-               "Static event queue for celix framework is full, falling back to dynamic allocated events. Increase static event queue size, current size is %i", fw->dispatcher.eventQueueCap);
-        celix_framework_event_t *e = malloc(sizeof(*e));
-        *e = *event; //shallow copy
-        celix_arrayList_add(fw->dispatcher.dynamicEventQueue, e);
+               "Static event queue for celix framework is full, falling back to dynamic allocated events. Increase static event queue size, current size is %i", shard->eventQueueCap);
+        celix_framework_addToDynamicEventQueue(shard, event);
+    }
+    int shardDepth = shard->eventQueueSize + shard->dynamicEventQueue.size;
+    shard->stats.queueDepth = shardDepth;
+    if (shardDepth > shard->stats.queueHighWaterMark) {
+        shard->stats.queueHighWaterMark = shardDepth;
+    }
+    int depth = ++fw->dispatcher.queueSize;
+    __atomic_store_n(&fw->dispatcher.stats.queueDepth, depth, __ATOMIC_RELAXED);
+    if (depth > fw->dispatcher.stats.queueHighWaterMark) {
+        __atomic_store_n(&fw->dispatcher.stats.queueHighWaterMark, depth, __ATOMIC_RELAXED);
+    }
+    if (wasEmpty) {
+        //only the shard event thread waits for a non-empty shard queue
+        celixThreadCondition_broadcast(&shard->cond);
     }
-    celixThreadCondition_broadcast(&fw->dispatcher.cond);
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
 
+/**
+ * Returns the first queued event for which matches returns true or NULL if no such event is queued.
+ * Should be called with the dispatcher mutex locked.
+ * Note that events which are being handled by an event thread are still queued, but events which are already
+ * handled - and waiting for the end of the event batch to be removed - are skipped.
+ */
+static celix_framework_event_t* celix_framework_findQueuedEvent(celix_framework_t* fw, bool (*matches)(const celix_framework_event_t* e, long id), long id) {
+    for (int s = 0; s < fw->dispatcher.nrOfShards; ++s) {
+        celix_framework_event_shard_t* shard = &fw->dispatcher.shards[s];
+        for (int i = 0; i < shard->eventQueueSize; ++i) {
+            int index = (shard->eventQueueFirstEntry + i) % shard->eventQueueCap;
+            celix_framework_event_t* e = &shard->eventQueue[index];
+            if (!__atomic_load_n(&e->handled, __ATOMIC_ACQUIRE) && matches(e, id)) {
+                return e;
+            }
+        }
+        int index = shard->dynamicEventQueue.headIndex;
+        for (celix_framework_event_segment_t* segment = shard->dynamicEventQueue.head; segment != NULL; segment = segment->next) {
+            int end = segment->next == NULL ? shard->dynamicEventQueue.tailIndex : CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE;
+            for (; index < end; ++index) {
+                celix_framework_event_t* e = &segment->events[index];
+                if (!__atomic_load_n(&e->handled, __ATOMIC_ACQUIRE) && matches(e, id)) {
+                    return e;
+                }
+            }
+            index = 0;
+        }
+    }
+    return NULL;
+}
+
+static bool celix_framework_isRegisterEventForSvcId(const celix_framework_event_t* e, long svcId) {
+    return e->type == CELIX_REGISTER_SERVICE_EVENT && e->registerServiceId == svcId;
+}
+
+static bool celix_framework_isUnregisterEventForSvcId(const celix_framework_event_t* e, long svcId) {
+    return e->type == CELIX_UNREGISTER_SERVICE_EVENT && e->unregisterServiceId == svcId;
+}
+
+static bool celix_framework_isRegistrationEventForBndId(const celix_framework_event_t* e, long bndId) {
+    return (e->type == CELIX_REGISTER_SERVICE_EVENT || e->type == CELIX_UNREGISTER_SERVICE_EVENT) && e->bndEntry->bndId == bndId;
+}
+
+static bool celix_framework_isEventForBndId(const celix_framework_event_t* e, long bndId) {
+    return e->bndEntry != NULL && e->bndEntry->bndId == bndId;
+}
+
+static bool celix_framework_isGenericEventForEventId(const celix_framework_event_t* e, long eventId) {
+    return e->type == CELIX_GENERIC_EVENT && e->genericEventId == eventId;
+}
+
+/**
+ * Waits until an event thread has handled events. Should be called with the dispatcher mutex locked.
+ * The event threads only broadcast after handling an event if there are waiters.
+ */
+static void celix_framework_waitForHandledEvents(celix_framework_t* fw, long waitTimeInSeconds) {
+    __atomic_add_fetch(&fw->dispatcher.nbWaiters, 1, __ATOMIC_SEQ_CST);
+    if (waitTimeInSeconds > 0) {
+        celixThreadCondition_timedwaitRelative(&fw->dispatcher.cond, &fw->dispatcher.mutex, waitTimeInSeconds, 0);
+    } else {
+        celixThreadCondition_wait(&fw->dispatcher.cond, &fw->dispatcher.mutex);
+    }
+    __atomic_sub_fetch(&fw->dispatcher.nbWaiters, 1, __ATOMIC_SEQ_CST);
+}
+
 static void fw_handleEventRequest(celix_framework_t *framework, celix_framework_event_t* event) {
     if (event->type == CELIX_BUNDLE_EVENT_TYPE) {
         celix_array_list_t *localListeners = celix_arrayList_create();
@@ -1538,71 +2105,164 @@ static void fw_handleEventRequest(celix_framework_t *framework, celix_framework_
     }
 }
 
-static inline celix_framework_event_t* fw_topEventFromQueue(celix_framework_t* fw) {
-    celix_framework_event_t* e = NULL;
-    celixThreadMutex_lock(&fw->dispatcher.mutex);
-    if (fw->dispatcher.eventQueueSize > 0) {
-        e = &fw->dispatcher.eventQueue[fw->dispatcher.eventQueueFirstEntry];
-    } else if (celix_arrayList_size(fw->dispatcher.dynamicEventQueue) > 0) {
-        e = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, 0);
+/**
+ * Fills the batch with (max nrOfEvents) pointers to the first queued events of the shard and returns the number of
+ * events in the batch. The events stay queued - and at the same location - until they are removed with
+ * fw_removeEventsFromQueue.
+ */
+static int fw_peekEventsFromQueue(celix_framework_event_shard_t* shard, celix_framework_event_t** batch, int nrOfEvents) {
+    int count = 0;
+    celixThreadMutex_lock(&shard->fw->dispatcher.mutex);
+    for (int i = 0; count < nrOfEvents && i < shard->eventQueueSize; ++i) {
+        int index = (shard->eventQueueFirstEntry + i) % shard->eventQueueCap;
+        batch[count++] = &shard->eventQueue[index];
     }
-    celixThreadMutex_unlock(&fw->dispatcher.mutex);
-    return e;
+    int index = shard->dynamicEventQueue.headIndex;
+    for (celix_framework_event_segment_t* segment = shard->dynamicEventQueue.head; count < nrOfEvents && segment != NULL; segment = segment->next) {
+        int end = segment->next == NULL ? shard->dynamicEventQueue.tailIndex : CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE;
+        for (; count < nrOfEvents && index < end; ++index) {
+            batch[count++] = &segment->events[index];
+        }
+        index = 0;
+    }
+    celixThreadMutex_unlock(&shard->fw->dispatcher.mutex);
+    return count;
 }
 
-static inline bool fw_removeTopEventFromQueue(celix_framework_t* fw) {
-    bool dynamicallyAllocated = false;
-    celixThreadMutex_lock(&fw->dispatcher.mutex);
-    if (fw->dispatcher.eventQueueSize > 0) {
-        fw->dispatcher.eventQueueFirstEntry = (fw->dispatcher.eventQueueFirstEntry+1) % fw->dispatcher.eventQueueCap;
-        fw->dispatcher.eventQueueSize -= 1;
-    } else if (celix_arrayList_size(fw->dispatcher.dynamicEventQueue) > 0) {
-        celix_arrayList_removeAt(fw->dispatcher.dynamicEventQueue, 0);
-        dynamicallyAllocated = true;
+/**
+ * Removes the first nrOfEvents events from the shard queue and broadcast the dispatcher condition if there are
+ * waiters or if all queues became empty. Should be called with the dispatcher mutex locked.
+ */
+static void fw_removeEventsFromQueue(celix_framework_event_shard_t* shard, int nrOfEvents) {
+    celix_framework_t* fw = shard->fw;
+    for (int i = 0; i < nrOfEvents; ++i) {
+        if (shard->eventQueueSize > 0) {
+            shard->eventQueueFirstEntry = (shard->eventQueueFirstEntry+1) % shard->eventQueueCap;
+            shard->eventQueueSize -= 1;
+        } else if (shard->dynamicEventQueue.size > 0) {
+            shard->dynamicEventQueue.headIndex += 1;
+            shard->dynamicEventQueue.size -= 1;
+            if (shard->dynamicEventQueue.size == 0) {
+                //reuse the remaining segment
+                shard->dynamicEventQueue.headIndex = 0;
+                shard->dynamicEventQueue.tailIndex = 0;
+            } else if (shard->dynamicEventQueue.headIndex == CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE) {
+                celix_framework_event_segment_t* segment = shard->dynamicEventQueue.head;
+                shard->dynamicEventQueue.head = segment->next;
+                shard->dynamicEventQueue.headIndex = 0;
+                free(segment);
+            }
+        }
+    }
+    shard->stats.queueDepth = shard->eventQueueSize + shard->dynamicEventQueue.size;
+    fw->dispatcher.queueSize -= nrOfEvents;
+    int depth = fw->dispatcher.queueSize;
+    __atomic_store_n(&fw->dispatcher.stats.queueDepth, depth, __ATOMIC_RELAXED);
+    if (depth == 0 || __atomic_load_n(&fw->dispatcher.nbWaiters, __ATOMIC_SEQ_CST) > 0) {
+        celixThreadCondition_broadcast(&fw->dispatcher.cond);
     }
-    celixThreadMutex_unlock(&fw->dispatcher.mutex);
-    return dynamicallyAllocated;
 }
 
+/**
+ * Returns whether the event targets the listeners of all bundles (service, bundle and framework events) instead of
+ * only the bundle of the event (generic events).
+ */
+static bool fw_isBroadcastEvent(const celix_framework_event_t* event) {
+    return event->type != CELIX_GENERIC_EVENT;
+}
 
-static inline void fw_handleEvents(celix_framework_t* framework) {
+/**
+ * Locks the handling mutex of the shards targeted by the event, so that the callbacks of a bundle are not called
+ * concurrently from different event threads.
+ * Generic events only target the bundle of the event and lock the own shard, so a slow generic event of a bundle
+ * does not delay the events of bundles on other shards. Service, bundle and framework events are delivered to the
+ * listeners of all bundles and lock all shards, in shard order to prevent deadlocks.
+ */
+static void fw_lockEventTargets(celix_framework_event_shard_t* shard, const celix_framework_event_t* event) {
+    if (fw_isBroadcastEvent(event)) {
+        for (int i = 0; i < shard->fw->dispatcher.nrOfShards; ++i) {
+            celixThreadMutex_lock(&shard->fw->dispatcher.shards[i].handlingMutex);
+        }
+    } else {
+        celixThreadMutex_lock(&shard->handlingMutex);
+    }
+}
+
+static void fw_unlockEventTargets(celix_framework_event_shard_t* shard, const celix_framework_event_t* event) {
+    if (fw_isBroadcastEvent(event)) {
+        for (int i = shard->fw->dispatcher.nrOfShards - 1; i >= 0; --i) {
+            celixThreadMutex_unlock(&shard->fw->dispatcher.shards[i].handlingMutex);
+        }
+    } else {
+        celixThreadMutex_unlock(&shard->handlingMutex);
+    }
+}
+
+static inline void fw_handleEvents(celix_framework_event_shard_t* shard) {
+    celix_framework_t* framework = shard->fw;
     celixThreadMutex_lock(&framework->dispatcher.mutex);
-    int size = framework->dispatcher.eventQueueSize + celix_arrayList_size(framework->dispatcher.dynamicEventQueue);
+    int size = shard->eventQueueSize + shard->dynamicEventQueue.size;
     if (size == 0 && framework->dispatcher.active) {
-        celixThreadCondition_timedwaitRelative(&framework->dispatcher.cond, &framework->dispatcher.mutex, 1, 0);
+        celixThreadCondition_timedwaitRelative(&shard->cond, &framework->dispatcher.mutex, 1, 0);
     }
-    size = framework->dispatcher.eventQueueSize + celix_arrayList_size(framework->dispatcher.dynamicEventQueue);
     celixThreadMutex_unlock(&framework->dispatcher.mutex);
 
-    while (size > 0) {
-        celix_framework_event_t* topEvent = fw_topEventFromQueue(framework);
-        fw_handleEventRequest(framework, topEvent);
-        bool dynamiclyAllocatedEvent = fw_removeTopEventFromQueue(framework);
-
-        if (topEvent->bndEntry != NULL) {
-            celix_framework_bundleEntry_decreaseUseCount(topEvent->bndEntry);
-        }
-        free(topEvent->serviceName);
-        if (dynamiclyAllocatedEvent) {
-            free(topEvent);
+    celix_framework_event_t* batch[CELIX_FRAMEWORK_EVENT_BATCH_SIZE];
+    int batchSize = fw_peekEventsFromQueue(shard, batch, CELIX_FRAMEWORK_EVENT_BATCH_SIZE);
+    while (batchSize > 0) {
+        int nrRemoved = 0;
+        double batchCallbackTime = 0.0;
+        double maxCallbackTime = 0.0;
+        for (int i = 0; i < batchSize; ++i) {
+            celix_framework_event_t* event = batch[i];
+            fw_lockEventTargets(shard, event);
+            struct timespec start = celix_gettime(CLOCK_MONOTONIC);
+            fw_handleEventRequest(framework, event);
+            double callbackTime = celix_elapsedtime(CLOCK_MONOTONIC, start);
+            fw_unlockEventTargets(shard, event);
+            batchCallbackTime += callbackTime;
+            if (callbackTime > maxCallbackTime) {
+                maxCallbackTime = callbackTime;
+            }
+            if (event->bndEntry != NULL) {
+                celix_framework_bundleEntry_decreaseUseCount(event->bndEntry);
+            }
+            free(event->serviceName);
+            __atomic_store_n(&event->handled, true, __ATOMIC_RELEASE);
+
+            if (__atomic_load_n(&framework->dispatcher.nbWaiters, __ATOMIC_SEQ_CST) > 0) {
+                //someone is waiting on a (possible) handled event, remove handled events now.
+                celixThreadMutex_lock(&framework->dispatcher.mutex);
+                fw_removeEventsFromQueue(shard, i + 1 - nrRemoved);
+                celixThreadMutex_unlock(&framework->dispatcher.mutex);
+                nrRemoved = i + 1;
+            }
         }
-
         celixThreadMutex_lock(&framework->dispatcher.mutex);
-        size = framework->dispatcher.eventQueueSize + celix_arrayList_size(framework->dispatcher.dynamicEventQueue);
-        celixThreadCondition_broadcast(&framework->dispatcher.cond);
+        fw_removeEventsFromQueue(shard, batchSize - nrRemoved);
+        framework->dispatcher.stats.nbBatches += 1;
+        shard->stats.nbBatches += 1;
+        shard->stats.nbHandled += batchSize;
+        shard->stats.totalCallbackTime += batchCallbackTime;
+        if (maxCallbackTime > shard->stats.maxCallbackTime) {
+            shard->stats.maxCallbackTime = maxCallbackTime;
+        }
         celixThreadMutex_unlock(&framework->dispatcher.mutex);
+
+        batchSize = fw_peekEventsFromQueue(shard, batch, CELIX_FRAMEWORK_EVENT_BATCH_SIZE);
     }
 }
 
-static void *fw_eventDispatcher(void *fw) {
-    framework_pt framework = (framework_pt) fw;
+static void *fw_eventDispatcher(void *data) {
+    celix_framework_event_shard_t* shard = data;
+    framework_pt framework = shard->fw;
 
     celixThreadMutex_lock(&framework->dispatcher.mutex);
     bool active = framework->dispatcher.active;
     celixThreadMutex_unlock(&framework->dispatcher.mutex);
 
     while (active) {
-        fw_handleEvents(framework);
+        fw_handleEvents(shard);
         celixThreadMutex_lock(&framework->dispatcher.mutex);
         active = framework->dispatcher.active;
         celixThreadMutex_unlock(&framework->dispatcher.mutex);
@@ -1610,10 +2270,10 @@ static void *fw_eventDispatcher(void *fw) {
 
     //not active any more, last run for possible request left overs
     celixThreadMutex_lock(&framework->dispatcher.mutex);
-    bool needLastRun = framework->dispatcher.eventQueueSize > 0 || celix_arrayList_size(framework->dispatcher.dynamicEventQueue) > 0;
+    bool needLastRun = shard->eventQueueSize > 0 || shard->dynamicEventQueue.size > 0;
     celixThreadMutex_unlock(&framework->dispatcher.mutex);
     if (needLastRun) {
-        fw_handleEvents(framework);
+        fw_handleEvents(shard);
     }
 
     celixThread_exit(NULL);
@@ -1783,29 +2443,36 @@ static celix_status_t framework_loadLibrary(framework_pt framework, const char *
 #endif
 
     char libraryPath[256];
-    long refreshCount = 0;
-    const char *archiveRoot = NULL;
-    long revisionNumber = 0;
+    bundle_revision_pt currentRevision = NULL;
+    const char *revisionRoot = NULL;
 
-    status = CELIX_DO_IF(status, bundleArchive_getRefreshCount(archive, &refreshCount));
-    status = CELIX_DO_IF(status, bundleArchive_getArchiveRoot(archive, &archiveRoot));
-    status = CELIX_DO_IF(status, bundleArchive_getCurrentRevisionNumber(archive, &revisionNumber));
+    //note the revision root is the dir where the bundle is extracted, this can be a shared bundle cache dir
+    status = CELIX_DO_IF(status, bundleArchive_getCurrentRevision(archive, &currentRevision));
+    status = CELIX_DO_IF(status, bundleRevision_getRoot(currentRevision, &revisionRoot));
 
     memset(libraryPath, 0, 256);
     int written = 0;
-    if (strncmp("lib", library, 3) == 0) {
-        written = snprintf(libraryPath, 256, "%s/version%ld.%ld/%s", archiveRoot, refreshCount, revisionNumber, library);
-    } else {
-        written = snprintf(libraryPath, 256, "%s/version%ld.%ld/%s%s%s", archiveRoot, refreshCount, revisionNumber, library_prefix, library, library_extension);
+    if (status == CELIX_SUCCESS && strncmp("lib", library, 3) == 0) {
+        written = snprintf(libraryPath, 256, "%s/%s", revisionRoot, library);
+    } else if (status == CELIX_SUCCESS) {
+        written = snprintf(libraryPath, 256, "%s/%s%s%s", revisionRoot, library_prefix, library, library_extension);
     }
 
-    if (written >= 256) {
+    if (status != CELIX_SUCCESS) {
+        error = "cannot find bundle revision root";
+    } else if (written >= 256) {
         error = "library path is too long";
         status = CELIX_FRAMEWORK_EXCEPTION;
     } else {
         celix_bundle_context_t *fwCtx = NULL;
         bundle_getContext(framework->bundle, &fwCtx);
+        struct timespec loadStart = celix_gettime(CLOCK_MONOTONIC);
         *handle = celix_libloader_open(fwCtx, libraryPath);
+        if (celix_framework_isTraceEnabled(framework)) {
+            long bndId = -1;
+            bundleArchive_getId(archive, &bndId);
+            celix_framework_traceSpan(framework, "bundle", "dlopen", bndId, libraryPath, loadStart);
+        }
         if (*handle == NULL) {
             error = celix_libloader_getLastError();
             status =  CELIX_BUNDLE_EXCEPTION;
@@ -1974,27 +2641,13 @@ void celix_framework_unregisterAsync(celix_framework_t* fw, celix_bundle_t* bnd,
  * @returns true if a service registration is cancelled.
  */
 static bool celix_framework_cancelServiceRegistrationIfPending(celix_framework_t* fw, celix_bundle_t* bnd, long serviceId) {
-    bool cancelled = false;
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    for (int i = 0; i < celix_arrayList_size(fw->dispatcher.dynamicEventQueue); ++i) {
-        celix_framework_event_t *event = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, i);
-        if (event->type == CELIX_REGISTER_SERVICE_EVENT && event->registerServiceId == serviceId) {
-            event->cancelled = true;
-            cancelled = true;
-            break;
-        }
-    }
-    for (size_t i = 0; i < fw->dispatcher.eventQueueSize; ++i) {
-        size_t index = (fw->dispatcher.eventQueueFirstEntry + i) % fw->dispatcher.eventQueueCap;
-        celix_framework_event_t *event = &fw->dispatcher.eventQueue[index];
-        if (event->type == CELIX_REGISTER_SERVICE_EVENT && event->registerServiceId == serviceId) {
-            event->cancelled = true;
-            cancelled = true;
-            break;
-        }
+    celix_framework_event_t* event = celix_framework_findQueuedEvent(fw, celix_framework_isRegisterEventForSvcId, serviceId);
+    if (event != NULL) {
+        event->cancelled = true;
     }
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
-    return cancelled;
+    return event != NULL;
 }
 
 void celix_framework_unregister(celix_framework_t* fw, celix_bundle_t* bnd, long serviceId) {
@@ -2007,29 +2660,9 @@ void celix_framework_waitForAsyncRegistration(framework_t *fw, long svcId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    bool registrationsInProgress = true;
-    while (registrationsInProgress) {
-        registrationsInProgress = false;
-        for (int i = 0; i < fw->dispatcher.eventQueueSize; ++i) {
-            int index = (fw->dispatcher.eventQueueFirstEntry + i) % fw->dispatcher.eventQueueCap;
-            celix_framework_event_t* e = &fw->dispatcher.eventQueue[index];
-            if (e->type == CELIX_REGISTER_SERVICE_EVENT && e->registerServiceId == svcId) {
-                registrationsInProgress = true;
-                break;
-            }
-        }
-        for (int i = 0; !registrationsInProgress && i < celix_arrayList_size(fw->dispatcher.dynamicEventQueue); ++i) {
-            celix_framework_event_t* e = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, i);
-            if (e->type == CELIX_REGISTER_SERVICE_EVENT && e->registerServiceId == svcId) {
-                registrationsInProgress = true;
-                break;
-            }
-        }
-        if (registrationsInProgress) {
-            celixThreadCondition_timedwaitRelative(&fw->dispatcher.cond, &fw->dispatcher.mutex, 5, 0);
-        }
+    while (celix_framework_findQueuedEvent(fw, celix_framework_isRegisterEventForSvcId, svcId) != NULL) {
+        celix_framework_waitForHandledEvents(fw, 5);
     }
-
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
 
@@ -2037,29 +2670,9 @@ void celix_framework_waitForAsyncUnregistration(framework_t *fw, long svcId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    bool registrationsInProgress = true;
-    while (registrationsInProgress) {
-        registrationsInProgress = false;
-        for (int i = 0; i < fw->dispatcher.eventQueueSize; ++i) {
-            int index = (fw->dispatcher.eventQueueFirstEntry + i) % fw->dispatcher.eventQueueCap;
-            celix_framework_event_t* e = &fw->dispatcher.eventQueue[index];
-            if (e->type == CELIX_UNREGISTER_SERVICE_EVENT && e->unregisterServiceId == svcId) {
-                registrationsInProgress = true;
-                break;
-            }
-        }
-        for (int i = 0; !registrationsInProgress && i < celix_arrayList_size(fw->dispatcher.dynamicEventQueue); ++i) {
-            celix_framework_event_t* e = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, i);
-            if (e->type == CELIX_UNREGISTER_SERVICE_EVENT && e->unregisterServiceId == svcId) {
-                registrationsInProgress = true;
-                break;
-            }
-        }
-        if (registrationsInProgress) {
-            celixThreadCondition_timedwaitRelative(&fw->dispatcher.cond, &fw->dispatcher.mutex, 5, 0);
-        }
+    while (celix_framework_findQueuedEvent(fw, celix_framework_isUnregisterEventForSvcId, svcId) != NULL) {
+        celix_framework_waitForHandledEvents(fw, 5);
     }
-
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
 
@@ -2067,34 +2680,36 @@ void celix_framework_waitForAsyncRegistrations(framework_t *fw, long bndId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    bool registrationsInProgress = true;
-    while (registrationsInProgress) {
-        registrationsInProgress = false;
-        for (int i = 0; i < fw->dispatcher.eventQueueSize; ++i) {
-            int index = (fw->dispatcher.eventQueueFirstEntry + i) % fw->dispatcher.eventQueueCap;
-            celix_framework_event_t* e = &fw->dispatcher.eventQueue[index];
-            if ((e->type == CELIX_REGISTER_SERVICE_EVENT || e->type == CELIX_UNREGISTER_SERVICE_EVENT) && e->bndEntry->bndId == bndId) {
-                registrationsInProgress = true;
-                break;
-            }
-        }
-        for (int i = 0; i < !registrationsInProgress && celix_arrayList_size(fw->dispatcher.dynamicEventQueue); ++i) {
-            celix_framework_event_t* e = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, i);
-            if ((e->type == CELIX_REGISTER_SERVICE_EVENT || e->type == CELIX_UNREGISTER_SERVICE_EVENT) && e->bndEntry->bndId == bndId) {
-                registrationsInProgress = true;
-                break;
-            }
-        }
-        if (registrationsInProgress) {
-            celixThreadCondition_timedwaitRelative(&fw->dispatcher.cond, &fw->dispatcher.mutex, 5, 0);
-        }
+    while (celix_framework_findQueuedEvent(fw, celix_framework_isRegistrationEventForBndId, bndId) != NULL) {
+        celix_framework_waitForHandledEvents(fw, 5);
     }
-
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
 
 bool celix_framework_isCurrentThreadTheEventLoop(framework_t* fw) {
-    return celixThread_equals(celixThread_self(), fw->dispatcher.thread);
+    celix_thread_t self = celixThread_self();
+    for (int i = 0; i < fw->dispatcher.nrOfShards; ++i) {
+        if (celixThread_equals(self, fw->dispatcher.shards[i].thread)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t celix_framework_getEventThreadStats(celix_framework_t* fw, celix_framework_event_thread_stats_t* stats, size_t nrOfStats) {
+    celixThreadMutex_lock(&fw->dispatcher.mutex);
+    for (size_t i = 0; stats != NULL && i < nrOfStats && i < (size_t)fw->dispatcher.nrOfShards; ++i) {
+        celix_framework_event_shard_t* shard = &fw->dispatcher.shards[i];
+        stats[i].queueDepth = shard->stats.queueDepth;
+        stats[i].queueHighWaterMark = shard->stats.queueHighWaterMark;
+        stats[i].nbHandledEvents = shard->stats.nbHandled;
+        stats[i].nbBatches = shard->stats.nbBatches;
+        stats[i].avgCallbackTime = shard->stats.nbHandled > 0 ? shard->stats.totalCallbackTime / (double)shard->stats.nbHandled : 0.0;
+        stats[i].maxCallbackTime = shard->stats.maxCallbackTime;
+    }
+    size_t nrOfShards = (size_t)fw->dispatcher.nrOfShards;
+    celixThreadMutex_unlock(&fw->dispatcher.mutex);
+    return nrOfShards;
 }
 
 const char* celix_framework_getUUID(const celix_framework_t *fw) {
@@ -2539,7 +3154,9 @@ celix_status_t celix_framework_startBundleEntry(celix_framework_t* framework, ce
 
                     if (status == CELIX_SUCCESS) {
                         if (create != NULL) {
+                            struct timespec createStart = celix_gettime(CLOCK_MONOTONIC);
                             status = CELIX_DO_IF(status, create(context, &userData));
+                            celix_framework_traceSpan(framework, "bundle", "activator create", bndEntry->bndId, name, createStart);
                             if (status == CELIX_SUCCESS) {
                                 activator->userData = userData;
                             }
@@ -2547,7 +3164,9 @@ celix_status_t celix_framework_startBundleEntry(celix_framework_t* framework, ce
                     }
                     if (status == CELIX_SUCCESS) {
                         if (start != NULL) {
+                            struct timespec startStart = celix_gettime(CLOCK_MONOTONIC);
                             status = CELIX_DO_IF(status, start(userData, context));
+                            celix_framework_traceSpan(framework, "bundle", "activator start", bndEntry->bndId, name, startStart);
                         }
                     }
 
@@ -2618,8 +3237,8 @@ void celix_framework_waitForEmptyEventQueue(celix_framework_t *fw) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    while (fw->dispatcher.eventQueueSize > 0 || celix_arrayList_size(fw->dispatcher.dynamicEventQueue) > 0) {
-        celixThreadCondition_wait(&fw->dispatcher.cond, &fw->dispatcher.mutex);
+    while (fw->dispatcher.queueSize > 0) {
+        celix_framework_waitForHandledEvents(fw, 0);
     }
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
@@ -2628,27 +3247,8 @@ void celix_framework_waitUntilNoEventsForBnd(celix_framework_t* fw, long bndId)
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    bool eventInProgress = true;
-    while (eventInProgress) {
-        eventInProgress = false;
-        for (int i = 0; i < fw->dispatcher.eventQueueSize; ++i) {
-            int index = (fw->dispatcher.eventQueueFirstEntry + i) % fw->dispatcher.eventQueueCap;
-            celix_framework_event_t* e = &fw->dispatcher.eventQueue[index];
-            if (e->bndEntry != NULL && e->bndEntry->bndId == bndId) {
-                eventInProgress = true;
-                break;
-            }
-        }
-        for (int i = 0; !eventInProgress && i < celix_arrayList_size(fw->dispatcher.dynamicEventQueue); ++i) {
-            celix_framework_event_t* e = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, i);
-            if (e->bndEntry != NULL && e->bndEntry->bndId == bndId) {
-                eventInProgress = true;
-                break;
-            }
-        }
-        if (eventInProgress) {
-            celixThreadCondition_timedwaitRelative(&fw->dispatcher.cond, &fw->dispatcher.mutex, 5, 0);
-        }
+    while (celix_framework_findQueuedEvent(fw, celix_framework_isEventForBndId, bndId) != NULL) {
+        celix_framework_waitForHandledEvents(fw, 5);
     }
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
@@ -2658,7 +3258,7 @@ void celix_framework_waitUntilNoPendingRegistration(celix_framework_t* fw)
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
     celixThreadMutex_lock(&fw->dispatcher.mutex);
     while (__atomic_load_n(&fw->dispatcher.stats.nbRegister, __ATOMIC_RELAXED) > 0) {
-        celixThreadCondition_wait(&fw->dispatcher.cond, &fw->dispatcher.mutex);
+        celix_framework_waitForHandledEvents(fw, 0);
     }
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
@@ -2705,31 +3305,19 @@ void celix_framework_waitForGenericEvent(framework_t *fw, long eventId) {
     assert(!celix_framework_isCurrentThreadTheEventLoop(fw));
 
     celixThreadMutex_lock(&fw->dispatcher.mutex);
-    bool eventInProgress = true;
-    while (eventInProgress) {
-        eventInProgress = false;
-        for (int i = 0; i < fw->dispatcher.eventQueueSize; ++i) {
-            int index = (fw->dispatcher.eventQueueFirstEntry + i) % fw->dispatcher.eventQueueCap;
-            celix_framework_event_t* e = &fw->dispatcher.eventQueue[index];
-            if (e->type == CELIX_GENERIC_EVENT && e->genericEventId == eventId) {
-                eventInProgress = true;
-                break;
-            }
-        }
-        for (int i = 0; !eventInProgress && i < celix_arrayList_size(fw->dispatcher.dynamicEventQueue); ++i) {
-            celix_framework_event_t* e = celix_arrayList_get(fw->dispatcher.dynamicEventQueue, i);
-            if (e->type == CELIX_GENERIC_EVENT && e->genericEventId == eventId) {
-                eventInProgress = true;
-                break;
-            }
-        }
-        if (eventInProgress) {
-            celixThreadCondition_timedwaitRelative(&fw->dispatcher.cond, &fw->dispatcher.mutex, 5, 0);
-        }
+    while (celix_framework_findQueuedEvent(fw, celix_framework_isGenericEventForEventId, eventId) != NULL) {
+        celix_framework_waitForHandledEvents(fw, 5);
     }
     celixThreadMutex_unlock(&fw->dispatcher.mutex);
 }
 
+bool celix_framework_writeTrace(celix_framework_t* fw, FILE* stream) {
+    if (!celix_framework_isTraceEnabled(fw)) {
+        return false;
+    }
+    return celix_frameworkTrace_write(fw->trace, stream) == CELIX_SUCCESS;
+}
+
 void celix_framework_waitForStop(celix_framework_t *framework) {
     celixThreadMutex_lock(&framework->shutdown.mutex);
     while (!framework->shutdown.done) {
@@ -39,12 +39,49 @@
 #include "celix_log.h"
 
 #include "celix_threads.h"
+#include "celix_framework_trace.h"
 #include "service_registry.h"
 
 #ifndef CELIX_FRAMEWORK_DEFAULT_STATIC_EVENT_QUEUE_SIZE
 #define CELIX_FRAMEWORK_DEFAULT_STATIC_EVENT_QUEUE_SIZE 1024
 #endif
 
+#ifndef CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE
+#define CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE 64
+#endif
+
+#ifndef CELIX_FRAMEWORK_DEFAULT_EVENT_THREADS
+#define CELIX_FRAMEWORK_DEFAULT_EVENT_THREADS 1
+#endif
+
+#ifndef CELIX_FRAMEWORK_EVENT_BATCH_SIZE
+#define CELIX_FRAMEWORK_EVENT_BATCH_SIZE 16
+#endif
+
+#ifndef CELIX_FRAMEWORK_DEFAULT_SERVICE_REGISTRY_INDEXED_ATTRIBUTES
+#define CELIX_FRAMEWORK_DEFAULT_SERVICE_REGISTRY_INDEXED_ATTRIBUTES "service.id"
+#endif
+
+#ifndef CELIX_FRAMEWORK_DEFAULT_AUTO_INSTALL_THREADS
+#define CELIX_FRAMEWORK_DEFAULT_AUTO_INSTALL_THREADS 1
+#endif
+
+#ifndef CELIX_FRAMEWORK_DEFAULT_TRACE
+#define CELIX_FRAMEWORK_DEFAULT_TRACE false
+#endif
+
+#ifndef CELIX_FRAMEWORK_TRACE_MAX_EVENTS
+#define CELIX_FRAMEWORK_TRACE_MAX_EVENTS 100000
+#endif
+
+#ifndef CELIX_FRAMEWORK_DEFAULT_AUTO_START_THREADS
+#define CELIX_FRAMEWORK_DEFAULT_AUTO_START_THREADS 1
+#endif
+
+#ifndef CELIX_FRAMEWORK_DEFAULT_AUTO_START_TIMEOUT
+#define CELIX_FRAMEWORK_DEFAULT_AUTO_START_TIMEOUT 10.0
+#endif
+
 typedef struct celix_framework_bundle_entry {
     celix_bundle_t *bnd;
     long bndId;
@@ -67,6 +104,7 @@ typedef enum celix_framework_event_type celix_framework_event_type_e;
 struct celix_framework_event {
     celix_framework_event_type_e type;
     celix_framework_bundle_entry_t* bndEntry;
+    bool handled; //NOTE atomic. Handled events stay queued until the end of the event batch.
 
     void *doneData;
     void (*doneCallback)(void*);
@@ -103,6 +141,47 @@ struct celix_framework_event {
 
 typedef struct celix_framework_event celix_framework_event_t;
 
+/**
+ * A segment of the dynamic event queue. The dynamic event queue is a linked list of fixed size segments, so that
+ * adding and removing events is O(1) and events do not move while they are queued.
+ */
+typedef struct celix_framework_event_segment {
+    struct celix_framework_event_segment* next;
+    celix_framework_event_t events[CELIX_FRAMEWORK_DYNAMIC_EVENT_QUEUE_SEGMENT_SIZE];
+} celix_framework_event_segment_t;
+
+/**
+ * A event dispatcher shard with its own event queue and event thread. Events are sharded on the bundle id of the
+ * event, so that the events of a bundle are handled in order by a single event thread.
+ * Note that the queue and stats of a shard are protected by the dispatcher mutex.
+ */
+typedef struct celix_framework_event_shard {
+    celix_framework_t* fw;
+    int index;
+    celix_thread_t thread;
+    celix_thread_cond_t cond; //signals the shard event thread that the event queue is not empty (or not active)
+    celix_thread_mutex_t handlingMutex; //held while handling an event targeting the bundles of the shard
+    celix_framework_event_t* eventQueue; //ring buffer
+    int eventQueueCap;
+    int eventQueueSize;
+    int eventQueueFirstEntry;
+    struct {
+        celix_framework_event_segment_t* head; //events are removed from the head segment
+        celix_framework_event_segment_t* tail; //events are added to the tail segment
+        int headIndex; //index of the first event in the head segment
+        int tailIndex; //index of the next free event in the tail segment
+        int size;
+    } dynamicEventQueue; //Used when the eventQueue is full
+    struct {
+        int queueDepth; // number of events in the static and dynamic event queue of the shard
+        int queueHighWaterMark; // highest number of events in the static and dynamic event queue of the shard
+        long nbBatches; // number of event batches handled by the shard event thread
+        long nbHandled; // number of events handled by the shard event thread
+        double totalCallbackTime; // total time in seconds spent handling events
+        double maxCallbackTime; // max time in seconds spent handling a single event
+    } stats;
+} celix_framework_event_shard_t;
+
 enum celix_bundle_lifecycle_command {
     CELIX_BUNDLE_LIFECYCLE_START,
     CELIX_BUNDLE_LIFECYCLE_STOP,
@@ -153,21 +232,22 @@ struct celix_framework {
 
 
     struct {
-        celix_thread_cond_t cond;
-        celix_thread_t thread;
-        celix_thread_mutex_t mutex; //protects below
+        celix_thread_cond_t cond; //signals waiters that events are handled
+        celix_thread_mutex_t mutex; //protects below and the shards
         bool active;
-        celix_framework_event_t* eventQueue; //ring buffer
-        int eventQueueCap;
-        int eventQueueSize;
-        int eventQueueFirstEntry;
-        celix_array_list_t *dynamicEventQueue; //entry = celix_framework_event_t*. Used when the eventQueue is full
+        celix_framework_event_shard_t* shards;
+        int nrOfShards;
+        int queueSize; //total number of queued events in all shards
+        int nbWaiters; //NOTE atomic. Number of threads waiting on cond for events to be handled
         struct {
             int nbFramework; // number of pending framework events
             int nbBundle; // number of pending bundle events
             int nbRegister; // number of pending registration
             int nbUnregister; // number of pending async de-registration
             int nbEvent; // number of pending generic events
+            int queueDepth; // number of events in the static and dynamic event queues of all shards
+            int queueHighWaterMark; // highest number of events in the static and dynamic event queues of all shards
+            long nbBatches; // number of event batches handled by the event threads
         } stats;
     } dispatcher;
 
@@ -179,6 +259,8 @@ struct celix_framework {
         celix_thread_mutex_t mutex; //protects below
         celix_array_list_t* bundleLifecycleHandlers; //entry = celix_framework_bundle_lifecycle_handler_t*
     } bundleLifecycleHandling;
+
+    celix_framework_trace_t* trace; //NULL if tracing is disabled
 };
 
 FRAMEWORK_EXPORT celix_status_t fw_getProperty(framework_pt framework, const char* name, const char* defaultValue, const char** value);
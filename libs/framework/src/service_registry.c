@@ -54,6 +54,12 @@ static void celix_increasePendingRegisteredEvent(celix_service_registry_t *regis
 static void celix_decreasePendingRegisteredEvent(celix_service_registry_t *registry, long svcId);
 static void celix_waitForPendingRegisteredEvents(celix_service_registry_t *registry, long svcId);
 
+static void celix_serviceRegistry_createAttributeIndexes(celix_service_registry_t *registry);
+static void celix_serviceRegistry_indexRegistration(celix_service_registry_t *registry, service_registration_t *reg);
+static void celix_serviceRegistry_removeRegistrationFromIndexes(celix_service_registry_t *registry, service_registration_t *reg);
+static const celix_array_list_t* celix_serviceRegistry_findCandidates(celix_service_registry_t *registry, const char *serviceName, const celix_filter_t *filter, bool *indexed);
+static void celix_serviceRegistry_collectMatchingRegistrations(celix_service_registry_t *registry, const char *serviceName, const celix_filter_t *filter, celix_array_list_t *out);
+
 celix_service_registry_t* celix_serviceRegistry_create(framework_pt framework) {
     celix_service_registry_t* reg = calloc(1, sizeof(*reg));
 
@@ -66,6 +72,7 @@ celix_service_registry_t* celix_serviceRegistry_create(framework_pt framework) {
     reg->framework = framework;
     reg->nextServiceId = 1L;
     reg->serviceReferences = hashMap_create(NULL, NULL, NULL, NULL);
+    celix_serviceRegistry_createAttributeIndexes(reg);
 
     reg->listenerHooks = celix_arrayList_create();
     reg->serviceListeners = celix_arrayList_create();
@@ -122,6 +129,10 @@ void celix_serviceRegistry_destroy(celix_service_registry_t* registry) {
     }
     hashMap_destroy(registry->serviceReferences, false, false);
 
+    //destroy indexes
+    celix_stringHashMap_destroy(registry->servicesByName);
+    celix_stringHashMap_destroy(registry->attributeIndexes);
+
     //destroy listener hooks
     size = celix_arrayList_size(registry->listenerHooks);
     for (int i = 0; i < celix_arrayList_size(registry->listenerHooks); ++i) {
@@ -177,6 +188,7 @@ celix_status_t serviceRegistry_registerServiceFactory(service_registry_pt regist
 
 static celix_status_t serviceRegistry_registerServiceInternal(service_registry_pt registry, bundle_pt bundle, const char* serviceName, const void * serviceObject, properties_pt dictionary, long reservedId, enum celix_service_type svcType, service_registration_pt *registration) {
     array_list_pt regs;
+    struct timespec registerStart = celix_gettime(CLOCK_MONOTONIC);
     long svcId = reservedId > 0 ? reservedId : celix_serviceRegistry_nextSvcId(registry);
 
     celix_properties_setLong(dictionary, CELIX_FRAMEWORK_SERVICE_BUNDLE_ID, celix_bundle_getId(bundle));
@@ -206,6 +218,7 @@ static celix_status_t serviceRegistry_registerServiceInternal(service_registry_p
         hashMap_put(registry->serviceRegistrations, bundle, regs);
     }
 	arrayList_add(regs, *registration);
+    celix_serviceRegistry_indexRegistration(registry, *registration);
 
     //update pending register event
     celix_increasePendingRegisteredEvent(registry, svcId);
@@ -221,6 +234,7 @@ static celix_status_t serviceRegistry_registerServiceInternal(service_registry_p
     //update pending register event count
     celix_decreasePendingRegisteredEvent(registry, svcId);
 
+    celix_framework_traceSpan(registry->framework, "service", "register service", celix_bundle_getId(bundle), serviceName, registerStart);
 	return CELIX_SUCCESS;
 }
 
@@ -248,6 +262,7 @@ static celix_status_t serviceRegistry_unregisterService(service_registry_pt regi
             celix_arrayList_destroy(regs);
             hashMap_remove(registry->serviceRegistrations, bundle);
         }
+        celix_serviceRegistry_removeRegistrationFromIndexes(registry, registration);
 	}
 	celixThreadRwlock_unlock(&registry->lock);
 
@@ -324,53 +339,18 @@ static celix_status_t serviceRegistry_getServiceReference_internal(service_regis
 
 celix_status_t serviceRegistry_getServiceReferences(service_registry_pt registry, bundle_pt owner, const char *serviceName, filter_pt filter, array_list_pt *out) {
 	celix_status_t status;
-	hash_map_iterator_pt iterator;
     array_list_pt references = NULL;
 	array_list_pt matchingRegistrations = NULL;
-    bool matchResult;
 
     status = arrayList_create(&references);
     status = CELIX_DO_IF(status, arrayList_create(&matchingRegistrations));
 
     celixThreadRwlock_readLock(&registry->lock);
-	iterator = hashMapIterator_create(registry->serviceRegistrations);
-	while (status == CELIX_SUCCESS && hashMapIterator_hasNext(iterator)) {
-		array_list_pt regs = (array_list_pt) hashMapIterator_nextValue(iterator);
-		unsigned int regIdx;
-		for (regIdx = 0; (regs != NULL) && regIdx < arrayList_size(regs); regIdx++) {
-			service_registration_pt registration = (service_registration_pt) arrayList_get(regs, regIdx);
-			properties_pt props = NULL;
-
-			status = serviceRegistration_getProperties(registration, &props);
-			if (status == CELIX_SUCCESS) {
-				bool matched = false;
-				matchResult = false;
-				if (filter != NULL) {
-					filter_match(filter, props, &matchResult);
-				}
-				if ((serviceName == NULL) && ((filter == NULL) || matchResult)) {
-					matched = true;
-				} else if (serviceName != NULL) {
-					const char *className = NULL;
-					matchResult = false;
-					serviceRegistration_getServiceName(registration, &className);
-					if (filter != NULL) {
-						filter_match(filter, props, &matchResult);
-					}
-					if ((strcmp(className, serviceName) == 0) && ((filter == NULL) || matchResult)) {
-						matched = true;
-					}
-				}
-				if (matched) {
-                    // assert(serviceRegistration_isValid(registration));
-                    serviceRegistration_retain(registration);
-                    arrayList_add(matchingRegistrations, registration);
-				}
-			}
-		}
-	}
+    celix_serviceRegistry_collectMatchingRegistrations(registry, serviceName, filter, matchingRegistrations);
+    for (int i = 0; i < celix_arrayList_size(matchingRegistrations); ++i) {
+        serviceRegistration_retain(celix_arrayList_get(matchingRegistrations, i));
+    }
     celixThreadRwlock_unlock(&registry->lock);
-	hashMapIterator_destroy(iterator);
 
     if (status == CELIX_SUCCESS) {
         unsigned int i;
@@ -890,18 +870,7 @@ celix_array_list_t* celix_serviceRegisrty_findServices(
 
     celixThreadRwlock_readLock(&registry->lock);
 
-    hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceRegistrations);
-    while (hashMapIterator_hasNext(&iter)) {
-        celix_array_list_t *regs = hashMapIterator_nextValue(&iter);
-        for (int i = 0; i < celix_arrayList_size(regs); ++i) {
-            service_registration_t *reg = celix_arrayList_get(regs, i);
-            celix_properties_t* svcProps = NULL;
-            serviceRegistration_getProperties(reg, &svcProps);
-            if (svcProps != NULL && celix_filter_match(filter, svcProps)) {
-                celix_arrayList_add(matchedRegistrations, reg);
-            }
-        }
-    }
+    celix_serviceRegistry_collectMatchingRegistrations(registry, NULL, filter, matchedRegistrations);
 
     //sort matched registration and add the svc id to the result list.
     if (celix_arrayList_size(matchedRegistrations) > 1) {
@@ -999,24 +968,19 @@ celix_status_t celix_serviceRegistry_addServiceListener(celix_service_registry_t
     celix_arrayList_add(registry->serviceListeners, entry); //use count 1
 
     //find already registered services
-    hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceRegistrations);
-    while (hashMapIterator_hasNext(&iter)) {
-        celix_array_list_t *regs = (array_list_pt) hashMapIterator_nextValue(&iter);
-        for (int regIdx = 0; (regs != NULL) && regIdx < celix_arrayList_size(regs); ++regIdx) {
-            service_registration_pt registration = celix_arrayList_get(regs, regIdx);
-            properties_pt props = NULL;
-            serviceRegistration_getProperties(registration, &props);
-            if (celix_filter_match(filter, props)) {
-                long svcId = serviceRegistration_getServiceId(registration);
-                service_reference_pt ref = NULL;
-                serviceRegistry_getServiceReference_internal(registry, bundle, registration, &ref);
-                celix_arrayList_add(references, ref);
-                //update pending register event count
-                celix_increasePendingRegisteredEvent(registry, svcId);
-            }
-        }
+    celix_array_list_t *matchedRegistrations = celix_arrayList_create();
+    celix_serviceRegistry_collectMatchingRegistrations(registry, NULL, filter, matchedRegistrations);
+    for (int i = 0; i < celix_arrayList_size(matchedRegistrations); ++i) {
+        service_registration_pt registration = celix_arrayList_get(matchedRegistrations, i);
+        long svcId = serviceRegistration_getServiceId(registration);
+        service_reference_pt ref = NULL;
+        serviceRegistry_getServiceReference_internal(registry, bundle, registration, &ref);
+        celix_arrayList_add(references, ref);
+        //update pending register event count
+        celix_increasePendingRegisteredEvent(registry, svcId);
     }
     celixThreadRwlock_unlock(&registry->lock);
+    celix_arrayList_destroy(matchedRegistrations);
 
     //NOTE there is a race condition with serviceRegistry_registerServiceInternal, as result
     //a REGISTERED event can be triggered twice instead of once. The service tracker can deal with this.
@@ -1202,3 +1166,208 @@ void celix_serviceRegistry_unregisterService(celix_service_registry_t* registry,
         fw_log(registry->framework->logger, CELIX_LOG_LEVEL_ERROR, "Cannot unregister service for service id %li. This id is not present or owned by the provided bundle (bnd id %li)", serviceId, celix_bundle_getId(bnd));
     }
 }
+
+static void celix_serviceRegistry_destroyIndexEntry(void *list) {
+    celix_arrayList_destroy(list);
+}
+
+static void celix_serviceRegistry_destroyValueIndex(void *valueIndex) {
+    celix_stringHashMap_destroy(valueIndex);
+}
+
+static celix_string_hash_map_t* celix_serviceRegistry_createIndex() {
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = celix_serviceRegistry_destroyIndexEntry;
+    return celix_stringHashMap_createWithOptions(&opts);
+}
+
+static void celix_serviceRegistry_createAttributeIndexes(celix_service_registry_t *registry) {
+    registry->servicesByName = celix_serviceRegistry_createIndex();
+
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = celix_serviceRegistry_destroyValueIndex;
+    registry->attributeIndexes = celix_stringHashMap_createWithOptions(&opts);
+
+    const char* attributes = registry->framework != NULL ?
+            celix_properties_get(registry->framework->configurationMap, CELIX_FRAMEWORK_SERVICE_REGISTRY_INDEXED_ATTRIBUTES, CELIX_FRAMEWORK_DEFAULT_SERVICE_REGISTRY_INDEXED_ATTRIBUTES) :
+            CELIX_FRAMEWORK_DEFAULT_SERVICE_REGISTRY_INDEXED_ATTRIBUTES;
+    char* attrs = celix_utils_strdup(attributes);
+    char* savePtr = NULL;
+    for (char* token = strtok_r(attrs, ",", &savePtr); token != NULL; token = strtok_r(NULL, ",", &savePtr)) {
+        char* attr = celix_utils_trim(token);
+        if (!celix_utils_isStringNullOrEmpty(attr) && !celix_utils_stringEquals(attr, OSGI_FRAMEWORK_OBJECTCLASS) &&
+                !celix_stringHashMap_hasKey(registry->attributeIndexes, attr)) {
+            celix_stringHashMap_put(registry->attributeIndexes, attr, celix_serviceRegistry_createIndex());
+        }
+        free(attr);
+    }
+    free(attrs);
+}
+
+static void celix_serviceRegistry_addToIndex(celix_string_hash_map_t *index, const char *key, service_registration_t *reg) {
+    celix_array_list_t* regs = celix_stringHashMap_get(index, key);
+    if (regs == NULL) {
+        regs = celix_arrayList_create();
+        celix_stringHashMap_put(index, key, regs);
+    }
+    celix_arrayList_add(regs, reg);
+}
+
+static void celix_serviceRegistry_removeFromIndex(celix_string_hash_map_t *index, const char *key, service_registration_t *reg) {
+    celix_array_list_t* regs = celix_stringHashMap_get(index, key);
+    if (regs != NULL) {
+        celix_arrayList_remove(regs, reg);
+        if (celix_arrayList_size(regs) == 0) {
+            celix_stringHashMap_remove(index, key); //note also destroys the list
+        }
+    }
+}
+
+/**
+ * Adds the registration to the service name index and to the configured attribute indexes.
+ * A registration is indexed on its service name and, if the objectClass property differs from the service name,
+ * also on its objectClass property. Lookups on the service name index must therefore always recheck the
+ * service name and/or filter.
+ * Note should be called with the registry write lock taken.
+ */
+static void celix_serviceRegistry_indexRegistration(celix_service_registry_t *registry, service_registration_t *reg) {
+    celix_properties_t* props = NULL;
+    serviceRegistration_getProperties(reg, &props);
+
+    celix_serviceRegistry_addToIndex(registry->servicesByName, reg->className, reg);
+    const char* objectClass = celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, NULL);
+    if (objectClass != NULL && !celix_utils_stringEquals(objectClass, reg->className)) {
+        celix_serviceRegistry_addToIndex(registry->servicesByName, objectClass, reg);
+    }
+
+    CELIX_STRING_HASH_MAP_ITERATE(registry->attributeIndexes, iter) {
+        const char* val = celix_properties_get(props, iter.key, NULL);
+        if (val != NULL) {
+            celix_serviceRegistry_addToIndex(iter.value.ptrValue, val, reg);
+        }
+    }
+}
+
+/**
+ * Removes the registration from the indexes.
+ * Note should be called with the registry write lock taken.
+ */
+static void celix_serviceRegistry_removeRegistrationFromIndexes(celix_service_registry_t *registry, service_registration_t *reg) {
+    celix_properties_t* props = NULL;
+    serviceRegistration_getProperties(reg, &props);
+
+    celix_serviceRegistry_removeFromIndex(registry->servicesByName, reg->className, reg);
+    const char* objectClass = celix_properties_get(props, OSGI_FRAMEWORK_OBJECTCLASS, NULL);
+    if (objectClass != NULL && !celix_utils_stringEquals(objectClass, reg->className)) {
+        celix_serviceRegistry_removeFromIndex(registry->servicesByName, objectClass, reg);
+    }
+
+    CELIX_STRING_HASH_MAP_ITERATE(registry->attributeIndexes, iter) {
+        const char* val = celix_properties_get(props, iter.key, NULL);
+        if (val != NULL) {
+            celix_serviceRegistry_removeFromIndex(iter.value.ptrValue, val, reg);
+        }
+    }
+}
+
+/**
+ * Returns the value of a mandatory equals value attribute for the provided filter, by only following AND
+ * operands. Returns NULL if no such attribute value is found.
+ */
+static const char* celix_serviceRegistry_findMandatoryEqualsValue(const celix_filter_t *filter, const char *attribute) {
+    if (filter->operand == CELIX_FILTER_OPERAND_EQUAL) {
+        return celix_utils_stringEquals(filter->attribute, attribute) ? filter->value : NULL;
+    } else if (filter->operand == CELIX_FILTER_OPERAND_AND) {
+        for (int i = 0; i < celix_arrayList_size(filter->children); ++i) {
+            const char* val = celix_serviceRegistry_findMandatoryEqualsValue(celix_arrayList_get(filter->children, i), attribute);
+            if (val != NULL) {
+                return val;
+            }
+        }
+    }
+    return NULL;
+}
+
+static const char* celix_serviceRegistry_indexValueForFilter(const celix_filter_t *filter, const char *attribute) {
+    if (filter != NULL && celix_filter_hasMandatoryEqualsValueAttribute(filter, attribute)) {
+        return celix_serviceRegistry_findMandatoryEqualsValue(filter, attribute);
+    }
+    return NULL;
+}
+
+/**
+ * Find the smallest list of candidate registrations for the provided service name and filter using the service name
+ * and attribute indexes.
+ *
+ * If no index can be used, indexed will be set to false and all registrations should be considered candidates.
+ * If an index can be used, indexed will be set to true and the returned list (NULL if there are no candidates)
+ * contains a superset of the matching registrations.
+ * Note should be called with the registry (read) lock taken.
+ */
+static const celix_array_list_t* celix_serviceRegistry_findCandidates(celix_service_registry_t *registry, const char *serviceName, const celix_filter_t *filter, bool *indexed) {
+    const celix_array_list_t* candidates = NULL;
+    *indexed = false;
+
+    const char* name = serviceName != NULL ? serviceName : celix_serviceRegistry_indexValueForFilter(filter, OSGI_FRAMEWORK_OBJECTCLASS);
+    if (name != NULL) {
+        *indexed = true;
+        candidates = celix_stringHashMap_get(registry->servicesByName, name);
+        if (candidates == NULL) {
+            return NULL;
+        }
+    }
+
+    if (filter != NULL) {
+        CELIX_STRING_HASH_MAP_ITERATE(registry->attributeIndexes, iter) {
+            const char* val = celix_serviceRegistry_indexValueForFilter(filter, iter.key);
+            if (val != NULL) {
+                const celix_array_list_t* regs = celix_stringHashMap_get(iter.value.ptrValue, val);
+                *indexed = true;
+                if (regs == NULL) {
+                    return NULL;
+                } else if (candidates == NULL || celix_arrayList_size(regs) < celix_arrayList_size(candidates)) {
+                    candidates = regs;
+                }
+            }
+        }
+    }
+
+    return candidates;
+}
+
+static bool celix_serviceRegistry_registrationMatches(service_registration_t *reg, const char *serviceName, const celix_filter_t *filter) {
+    if (serviceName != NULL && !celix_utils_stringEquals(reg->className, serviceName)) {
+        return false;
+    }
+    celix_properties_t* props = NULL;
+    serviceRegistration_getProperties(reg, &props);
+    return props != NULL && celix_filter_match(filter, props);
+}
+
+/**
+ * Adds all registrations matching the (optional) service name and (optional) filter to the out list.
+ * Note should be called with the registry (read) lock taken.
+ */
+static void celix_serviceRegistry_collectMatchingRegistrations(celix_service_registry_t *registry, const char *serviceName, const celix_filter_t *filter, celix_array_list_t *out) {
+    bool indexed;
+    const celix_array_list_t* candidates = celix_serviceRegistry_findCandidates(registry, serviceName, filter, &indexed);
+    if (indexed) {
+        for (int i = 0; candidates != NULL && i < celix_arrayList_size(candidates); ++i) {
+            service_registration_t* reg = celix_arrayList_get(candidates, i);
+            if (celix_serviceRegistry_registrationMatches(reg, serviceName, filter)) {
+                celix_arrayList_add(out, reg);
+            }
+        }
+    } else {
+        hash_map_iterator_t iter = hashMapIterator_construct(registry->serviceRegistrations);
+        while (hashMapIterator_hasNext(&iter)) {
+            celix_array_list_t *regs = hashMapIterator_nextValue(&iter);
+            for (int i = 0; i < celix_arrayList_size(regs); ++i) {
+                service_registration_t* reg = celix_arrayList_get(regs, i);
+                if (celix_serviceRegistry_registrationMatches(reg, serviceName, filter)) {
+                    celix_arrayList_add(out, reg);
+                }
+            }
+        }
+    }
+}
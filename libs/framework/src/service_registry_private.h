@@ -31,6 +31,7 @@
 #include "service_registry.h"
 #include "listener_hook_service.h"
 #include "service_reference.h"
+#include "celix_string_hash_map.h"
 
 #define CELIX_SERVICE_REGISTRY_STATIC_EVENT_QUEUE_SIZE  64
 
@@ -62,6 +63,15 @@ struct celix_serviceRegistry {
 	hash_map_t *serviceRegistrations; //key = bundle (reg owner), value = list ( registration )
 	hash_map_t *serviceReferences; //key = bundle, value = map (key = serviceId, value = reference)
 
+	/**
+	 * Secondary indexes on the registered services, used to limit the number of registrations which needs to be
+	 * matched against a filter.
+	 * The servicesByName index contains all registrations. The attribute indexes only contain registrations which
+	 * have the indexed attribute.
+	 */
+	celix_string_hash_map_t* servicesByName; //key = service name, value = celix_array_list_t* (service_registration_t*)
+	celix_string_hash_map_t* attributeIndexes; //key = attribute name, value = celix_string_hash_map_t* (key = attribute value, value = celix_array_list_t* (service_registration_t*))
+
 	long nextServiceId;
 
 	celix_array_list_t *listenerHooks; //celix_service_registry_listener_hook_entry_t*
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+
+#include "celix_properties.h"
+#include "celix_filter.h"
+
+class FilterBenchmark {
+public:
+    explicit FilterBenchmark(int64_t nrOfExtraEntries, const char* filterStr) : filter{celix_filter_create(filterStr)} {
+        celix_properties_set(props, "objectClass", "example.Service");
+        celix_properties_setLong(props, "service.ranking", 10);
+        celix_properties_set(props, "service.version", "1.4.0");
+        celix_properties_set(props, "lang", "cxx");
+        celix_properties_set(props, "name", "example.service.impl");
+        for (int64_t i = 0; i < nrOfExtraEntries; ++i) {
+            std::string key = "extra.entry." + std::to_string(i);
+            celix_properties_setLong(props, key.c_str(), i);
+        }
+        compiledProgram = filter->program;
+    }
+
+    ~FilterBenchmark() {
+        filter->program = compiledProgram;
+        celix_filter_destroy(filter);
+        celix_properties_destroy(props);
+    }
+
+    FilterBenchmark(FilterBenchmark&&) = delete;
+    FilterBenchmark& operator=(FilterBenchmark&&) = delete;
+    FilterBenchmark(const FilterBenchmark&) = delete;
+    FilterBenchmark& operator=(const FilterBenchmark&) = delete;
+
+    /**
+     * Removes the compiled program from the filter, so that celix_filter_match falls back to walking the filter tree.
+     */
+    void useFilterTree() {
+        filter->program = nullptr;
+    }
+
+    celix_filter_t* const filter;
+    celix_properties_t* const props{celix_properties_create()};
+    struct celix_filter_program* compiledProgram{nullptr};
+};
+
+static constexpr const char* const SIMPLE_FILTER = "(objectClass=example.Service)";
+static constexpr const char* const COMPLEX_FILTER = "(&(name=example.*)(|(lang=c)(lang=cxx))(service.ranking>=5)(service.version>=1.2.0)(objectClass=example.Service))";
+
+static void matchFilter(benchmark::State& state, FilterBenchmark& benchmark) {
+    for (auto _ : state) {
+        // This code gets timed
+        bool match = celix_filter_match(benchmark.filter, benchmark.props);
+        if (!match) {
+            std::cerr << "Expected a filter match for " << celix_filter_getFilterString(benchmark.filter) << std::endl;
+            abort();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void FilterBenchmark_matchSimpleFilterCompiled(benchmark::State& state) {
+    FilterBenchmark benchmark{state.range(0), SIMPLE_FILTER};
+    matchFilter(state, benchmark);
+}
+
+static void FilterBenchmark_matchSimpleFilterTree(benchmark::State& state) {
+    FilterBenchmark benchmark{state.range(0), SIMPLE_FILTER};
+    benchmark.useFilterTree();
+    matchFilter(state, benchmark);
+}
+
+static void FilterBenchmark_matchComplexFilterCompiled(benchmark::State& state) {
+    FilterBenchmark benchmark{state.range(0), COMPLEX_FILTER};
+    matchFilter(state, benchmark);
+}
+
+static void FilterBenchmark_matchComplexFilterTree(benchmark::State& state) {
+    FilterBenchmark benchmark{state.range(0), COMPLEX_FILTER};
+    benchmark.useFilterTree();
+    matchFilter(state, benchmark);
+}
+
+static void FilterBenchmark_createFilter(benchmark::State& state) {
+    for (auto _ : state) {
+        // This code gets timed
+        celix_filter_t* filter = celix_filter_create(COMPLEX_FILTER);
+        celix_filter_destroy(filter);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+#define CELIX_BENCHMARK(name) \
+    BENCHMARK(name)->MeasureProcessCPUTime()->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+CELIX_BENCHMARK(FilterBenchmark_matchSimpleFilterCompiled)->RangeMultiplier(10)->Range(10, 1000);
+CELIX_BENCHMARK(FilterBenchmark_matchSimpleFilterTree)->RangeMultiplier(10)->Range(10, 1000); //reference
+CELIX_BENCHMARK(FilterBenchmark_matchComplexFilterCompiled)->RangeMultiplier(10)->Range(10, 1000);
+CELIX_BENCHMARK(FilterBenchmark_matchComplexFilterTree)->RangeMultiplier(10)->Range(10, 1000); //reference
+CELIX_BENCHMARK(FilterBenchmark_createFilter);
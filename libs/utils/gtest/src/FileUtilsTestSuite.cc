@@ -19,6 +19,11 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "celix_file_utils.h"
 #include "celix_properties.h"
 
@@ -83,6 +88,31 @@ TEST_F(FileUtilsTestSuite, CreateAndDeleteDirectory) {
     EXPECT_EQ(status, CELIX_SUCCESS);
 }
 
+TEST_F(FileUtilsTestSuite, CreateDirectoryConcurrently) {
+    const char* root = "celix_file_utils_test/concurrent";
+    celix_utils_deleteDirectory(root, nullptr);
+
+    //Concurrently creating the same new directory (and parents) succeeds for every caller when using failIfPresent=false.
+    std::vector<std::thread> threads{};
+    std::atomic<int> nrOfFailures{0};
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&nrOfFailures, root] {
+            for (int j = 0; j < 200; ++j) {
+                std::string dir = std::string{root} + "/" + std::to_string(j) + "/a/b/c";
+                if (celix_utils_createDirectory(dir.c_str(), false, nullptr) != CELIX_SUCCESS) {
+                    nrOfFailures++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(nrOfFailures.load(), 0);
+    EXPECT_TRUE(celix_utils_directoryExists("celix_file_utils_test/concurrent/199/a/b/c"));
+    EXPECT_EQ(celix_utils_deleteDirectory(root, nullptr), CELIX_SUCCESS);
+}
+
 TEST_F(FileUtilsTestSuite, ExtractZipFileTest) {
     std::cout << "Using test zip location " << TEST_ZIP_LOCATION << std::endl;
     const char* extractLocation = "extract_location";
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "celix_properties.h"
+#include "celix_filter.h"
+
+class FilterTestSuite : public ::testing::Test {
+public:
+    FilterTestSuite() {
+        celix_properties_set(props, "objectClass", "example.Service");
+        celix_properties_setLong(props, "service.ranking", 10);
+        celix_properties_set(props, "service.version", "1.10.0");
+        celix_properties_set(props, "lang", "cxx");
+        celix_properties_set(props, "name", "example.service.impl");
+        celix_properties_set(props, "empty", "");
+    }
+
+    ~FilterTestSuite() override {
+        celix_properties_destroy(props);
+    }
+
+    FilterTestSuite(FilterTestSuite&&) = delete;
+    FilterTestSuite& operator=(FilterTestSuite&&) = delete;
+    FilterTestSuite(const FilterTestSuite&) = delete;
+    FilterTestSuite& operator=(const FilterTestSuite&) = delete;
+
+    /**
+     * Matches the filter using the compiled program and using the filter tree and checks that both results are equal.
+     */
+    bool match(const char* filterStr) {
+        celix_filter_t* filter = celix_filter_create(filterStr);
+        EXPECT_NE(filter, nullptr);
+        if (filter == nullptr) {
+            return false;
+        }
+        EXPECT_NE(filter->program, nullptr);
+        bool compiledResult = celix_filter_match(filter, props);
+        auto* program = filter->program;
+        filter->program = nullptr;
+        bool treeResult = celix_filter_match(filter, props);
+        filter->program = program;
+        celix_filter_destroy(filter);
+        EXPECT_EQ(compiledResult, treeResult) << "Compiled and tree result differ for filter " << filterStr;
+        return compiledResult;
+    }
+
+    celix_properties_t* props{celix_properties_create()};
+};
+
+TEST_F(FilterTestSuite, CompiledLeafOperandsTest) {
+    EXPECT_TRUE(match("(objectClass=example.Service)"));
+    EXPECT_FALSE(match("(objectClass=other.Service)"));
+    EXPECT_FALSE(match("(missing=value)"));
+    EXPECT_TRUE(match("(lang=*)"));
+    EXPECT_FALSE(match("(missing=*)"));
+    EXPECT_TRUE(match("(lang~=cxx)"));
+    EXPECT_TRUE(match("(name=example.*)"));
+    EXPECT_TRUE(match("(name=*impl)"));
+    EXPECT_TRUE(match("(name=*service*)"));
+    EXPECT_FALSE(match("(name=other*)"));
+}
+
+TEST_F(FilterTestSuite, CompiledOrderingOperandsTest) {
+    EXPECT_TRUE(match("(service.ranking>5)"));
+    EXPECT_TRUE(match("(service.ranking>=10)"));
+    EXPECT_FALSE(match("(service.ranking<10)"));
+    EXPECT_TRUE(match("(service.ranking<=10.0)"));
+    EXPECT_TRUE(match("(service.version>1.9.0)"));
+    EXPECT_FALSE(match("(service.version<1.2)"));
+    EXPECT_TRUE(match("(lang>c)")); //string compare
+    EXPECT_FALSE(match("(missing>1)"));
+}
+
+TEST_F(FilterTestSuite, CompiledCompositeOperandsTest) {
+    EXPECT_TRUE(match("(&(objectClass=example.Service)(service.ranking>=5))"));
+    EXPECT_FALSE(match("(&(objectClass=example.Service)(service.ranking>=50))"));
+    EXPECT_TRUE(match("(|(missing=*)(lang=cxx))"));
+    EXPECT_FALSE(match("(|(missing=*)(lang=c))"));
+    EXPECT_TRUE(match("(!(missing=*))"));
+    EXPECT_FALSE(match("(!(lang=cxx))"));
+    EXPECT_TRUE(match("(&(name=example.*)(|(lang=c)(lang=cxx))(!(missing=*))(service.version>=1.2.0)(objectClass=example.Service))"));
+    EXPECT_FALSE(match("(&(name=example.*)(|(lang=c)(lang=java))(service.version>=1.2.0)(objectClass=example.Service))"));
+    //same attribute used multiple times
+    EXPECT_TRUE(match("(&(lang=*)(lang=cxx)(!(lang=c))(lang>=b))"));
+    EXPECT_FALSE(match("(&(lang=*)(lang=cxx)(lang=c))"));
+}
+
+TEST_F(FilterTestSuite, CompiledNullPropertiesTest) {
+    celix_filter_t* filter = celix_filter_create("(!(lang=*))");
+    EXPECT_TRUE(celix_filter_match(filter, nullptr));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(lang=cxx)");
+    EXPECT_FALSE(celix_filter_match(filter, nullptr));
+    celix_filter_destroy(filter);
+}
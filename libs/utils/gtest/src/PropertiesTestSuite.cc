@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "celix_properties.h"
+#include "celix_filter.h"
+#include "celix_version.h"
+
+class PropertiesTestSuite : public ::testing::Test {
+public:
+};
+
+TEST_F(PropertiesTestSuite, TypedEntryTest) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "a", "10");
+    celix_properties_set(props, "b", "1.5");
+    celix_properties_set(props, "c", "true");
+    celix_properties_set(props, "d", "1.2.3");
+    celix_properties_set(props, "e", "value");
+
+    auto* entry = celix_properties_getEntry(props, "a");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_STREQ(entry->value, "10");
+    EXPECT_TRUE(entry->hasLongValue);
+    EXPECT_EQ(entry->longValue, 10);
+    EXPECT_TRUE(entry->hasDoubleValue);
+    EXPECT_FALSE(entry->hasBoolValue);
+
+    entry = celix_properties_getEntry(props, "b");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->hasDoubleValue);
+    EXPECT_DOUBLE_EQ(entry->doubleValue, 1.5);
+
+    entry = celix_properties_getEntry(props, "c");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->hasBoolValue);
+    EXPECT_TRUE(entry->boolValue);
+
+    entry = celix_properties_getEntry(props, "d");
+    ASSERT_NE(entry, nullptr);
+    ASSERT_NE(entry->versionValue, nullptr);
+    EXPECT_EQ(celix_version_getMajor(entry->versionValue), 1);
+    EXPECT_EQ(celix_version_getMinor(entry->versionValue), 2);
+    EXPECT_EQ(celix_version_getMicro(entry->versionValue), 3);
+
+    entry = celix_properties_getEntry(props, "e");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->hasLongValue);
+    EXPECT_FALSE(entry->hasDoubleValue);
+    EXPECT_FALSE(entry->hasBoolValue);
+    EXPECT_EQ(entry->versionValue, nullptr);
+
+    EXPECT_EQ(celix_properties_getEntry(props, "f"), nullptr);
+
+    //overriding a value also updates the typed values
+    celix_properties_set(props, "a", "not a number");
+    EXPECT_EQ(celix_properties_getAsLong(props, "a", -1), -1);
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, TypedSettersTest) {
+    auto* props = celix_properties_create();
+    celix_properties_setLong(props, "long", -42);
+    celix_properties_setBool(props, "bool", false);
+    celix_properties_setDouble(props, "double", 2.0);
+    auto* version = celix_version_createVersion(1, 2, 3, "qualifier");
+    celix_properties_setVersion(props, "version", version);
+    celix_version_destroy(version);
+
+    EXPECT_STREQ(celix_properties_get(props, "long", nullptr), "-42");
+    EXPECT_EQ(celix_properties_getAsLong(props, "long", 0), -42);
+    EXPECT_STREQ(celix_properties_get(props, "bool", nullptr), "false");
+    EXPECT_FALSE(celix_properties_getAsBool(props, "bool", true));
+    EXPECT_DOUBLE_EQ(celix_properties_getAsDouble(props, "double", 0.0), 2.0);
+    EXPECT_STREQ(celix_properties_get(props, "version", nullptr), "1.2.3.qualifier");
+
+    auto* v = celix_properties_getVersion(props, "version", nullptr);
+    ASSERT_NE(v, nullptr);
+    EXPECT_STREQ(celix_version_getQualifier(v), "qualifier");
+    EXPECT_EQ(celix_properties_getVersion(props, "long", nullptr), nullptr);
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, CopyAndIterateTest) {
+    auto* props = celix_properties_create();
+    celix_properties_setLong(props, "a", 1);
+    celix_properties_set(props, "b", "2.0.0");
+    celix_properties_set(props, "c", "value");
+
+    auto* copy = celix_properties_copy(props);
+    celix_properties_destroy(props);
+    EXPECT_EQ(celix_properties_size(copy), 3);
+    EXPECT_EQ(celix_properties_getAsLong(copy, "a", 0), 1);
+    EXPECT_NE(celix_properties_getVersion(copy, "b", nullptr), nullptr);
+
+    int count = 0;
+    const char* key;
+    CELIX_PROPERTIES_FOR_EACH(copy, key) {
+        EXPECT_NE(celix_properties_get(copy, key, nullptr), nullptr);
+        ++count;
+    }
+    EXPECT_EQ(count, 3);
+
+    celix_properties_unset(copy, "a");
+    EXPECT_EQ(celix_properties_size(copy), 2);
+    celix_properties_destroy(copy);
+}
+
+TEST_F(PropertiesTestSuite, TypedFilterCompareTest) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "ranking", "10");
+    celix_properties_set(props, "version", "1.10.0");
+
+    //numeric instead of lexical compare
+    auto* filter = celix_filter_create("(ranking>5)");
+    EXPECT_TRUE(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    filter = celix_filter_create("(ranking<=9.5)");
+    EXPECT_FALSE(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    //version instead of lexical compare
+    filter = celix_filter_create("(version>=1.9.0)");
+    EXPECT_TRUE(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    //version instead of numeric compare of the leading "1.10" part
+    filter = celix_filter_create("(version<1.5)");
+    EXPECT_FALSE(celix_filter_match(filter, props));
+    celix_filter_destroy(filter);
+
+    celix_properties_destroy(props);
+}
+
+TEST_F(PropertiesTestSuite, PartialTypedValuesTest) {
+    auto* props = celix_properties_create();
+    celix_properties_set(props, "version", "1.10.0");
+    celix_properties_set(props, "trueish", "trueish");
+    celix_properties_set(props, "padded", " TRUE ");
+    celix_properties_set(props, "prefixed", "2.5abc");
+
+    //only complete values are cached as double or bool
+    auto* entry = celix_properties_getEntry(props, "version");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->hasDoubleValue);
+    entry = celix_properties_getEntry(props, "trueish");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->hasBoolValue);
+    EXPECT_FALSE(celix_properties_getAsBool(props, "trueish", false));
+    entry = celix_properties_getEntry(props, "padded");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_TRUE(entry->hasBoolValue);
+    EXPECT_TRUE(entry->boolValue);
+
+    //getAsDouble still parses the leading part of the value
+    EXPECT_DOUBLE_EQ(celix_properties_getAsDouble(props, "prefixed", 0.0), 2.5);
+    celix_properties_destroy(props);
+}
@@ -55,7 +55,7 @@ namespace celix {
 
         bool operator==(const celix::PropertiesIterator& rhs) const {
             bool sameMap = iter._data1 == rhs.iter._data1; //map
-            bool sameIndex = iter._data5 == rhs.iter._data5; //index
+            bool sameIndex = iter._data2 == rhs.iter._data2; //index
             bool oneIsEnd = end || rhs.end;
             if (oneIsEnd) {
                 return sameMap && end && rhs.end;
@@ -89,7 +89,7 @@ namespace celix {
         std::string first{};
         std::string second{};
     private:
-        celix_properties_iterator_t iter{nullptr, nullptr, nullptr, 0, 0};
+        celix_properties_iterator_t iter{};
         bool end{false};
     };
 
@@ -53,6 +53,9 @@ struct celix_filter_struct {
     //type is celix_filter_t* for AND, OR and NOT operator and char* for SUBSTRING
     //for other operands children is NULL
     celix_array_list_t *children;
+
+    //compiled (flat) form of the filter, used by celix_filter_match. Only set for the root filter.
+    struct celix_filter_program *program;
 };
 
 
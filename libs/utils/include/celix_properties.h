@@ -21,6 +21,8 @@
 #include <stdbool.h>
 
 #include "celix_errno.h"
+#include "celix_string_hash_map.h"
+#include "celix_version.h"
 
 #ifndef CELIX_PROPERTIES_H_
 #define CELIX_PROPERTIES_H_
@@ -29,15 +31,30 @@
 extern "C" {
 #endif
 
-typedef struct hashMap celix_properties_t; //opaque struct, TODO try to make this a celix_properties struct
+typedef struct celix_properties celix_properties_t; //opaque struct
+
+/**
+ * @brief A properties entry.
+ *
+ * Besides the string value, a properties entry contains the typed (long, double, bool and version) values, which
+ * are parsed once when the value is set.
+ */
+typedef struct celix_properties_entry {
+    char* value; //string value of the entry, can be NULL.
+    bool hasLongValue; //true if the value could be parsed as long.
+    bool hasDoubleValue; //true if the complete value could be parsed as double.
+    bool hasBoolValue; //true if the value could be parsed as bool.
+    bool boolValue;
+    long longValue;
+    double doubleValue;
+    celix_version_t* versionValue; //NULL if the value is not a version (e.g. "1.2.3").
+} celix_properties_entry_t;
 
 typedef struct celix_properties_iterator {
     //private data
-    void* _data1;
-    void* _data2;
-    void* _data3;
-    int _data4;
-    int _data5;
+    void* _data1; //properties
+    size_t _data2; //index of the next entry
+    celix_string_hash_map_iterator_t _data3; //map iterator on the next entry
 } celix_properties_iterator_t;
 
 
@@ -79,6 +96,29 @@ void celix_properties_setBool(celix_properties_t *props, const char *key, bool v
 void celix_properties_setDouble(celix_properties_t *props, const char *key, double val);
 double celix_properties_getAsDouble(const celix_properties_t *props, const char *key, double defaultValue);
 
+/**
+ * @brief Returns the version value for the provided key or the default value if the value of the key is
+ * not a version (e.g. "1.2.3").
+ *
+ * The returned version is owned by the properties and is valid until the key is set, unset or the properties is
+ * destroyed.
+ */
+const celix_version_t* celix_properties_getVersion(const celix_properties_t *props, const char *key, const celix_version_t* defaultValue);
+
+/**
+ * @brief Sets the string representation of the provided version for the provided key.
+ */
+void celix_properties_setVersion(celix_properties_t *props, const char *key, const celix_version_t* version);
+
+/**
+ * @brief Returns the properties entry - with the pre-parsed typed values - for the provided key or NULL if the key
+ * is not present.
+ *
+ * The returned entry is owned by the properties and is valid until the key is set, unset or the properties is
+ * destroyed.
+ */
+const celix_properties_entry_t* celix_properties_getEntry(const celix_properties_t *properties, const char *key);
+
 int celix_properties_size(const celix_properties_t *properties);
 
 celix_properties_iterator_t celix_propertiesIterator_construct(const celix_properties_t *properties);
@@ -20,6 +20,7 @@
 #include "celix_file_utils.h"
 
 #include <sys/stat.h>
+#include <errno.h>
 #include <string.h>
 #include <stdio.h>
 #include <dirent.h>
@@ -77,6 +78,10 @@ celix_status_t celix_utils_createDirectory(const char* path, bool failIfPresent,
         char* subPath = strndup(path, slashAt - path);
         if (!celix_utils_directoryExists(subPath)) {
             int rc = mkdir(subPath, S_IRWXU);
+            if (rc != 0 && errno == EEXIST && celix_utils_directoryExists(subPath)) {
+                //note created in the meantime by another thread or process
+                rc = 0;
+            }
             if (rc != 0) {
                 status = CELIX_FILE_IO_EXCEPTION;
                 *errorOut = strerror(errno);
@@ -88,6 +93,10 @@ celix_status_t celix_utils_createDirectory(const char* path, bool failIfPresent,
     //create last part of the dir (expect when path ends with / then this is already done in the loop)
     if (status == CELIX_SUCCESS && strlen(path) >0 && path[strlen(path)-1] != '/') {
         int rc = mkdir(path, S_IRWXU);
+        if (rc != 0 && errno == EEXIST && !failIfPresent && celix_utils_directoryExists(path)) {
+            //note created in the meantime by another thread or process
+            rc = 0;
+        }
         if (rc != 0) {
             status = CELIX_FILE_IO_EXCEPTION;
             *errorOut = strerror(errno);
@@ -20,6 +20,7 @@
 #include "celix_string_hash_map.h"
 #include "celix_long_hash_map.h"
 #include "celix_utils.h"
+#include "celix_hash_map_private.h"
 
 #include <stdlib.h>
 #include <memory.h>
@@ -110,14 +111,8 @@ static unsigned int celix_hashMap_indexFor(unsigned int h, unsigned int length)
     return h & (length - 1);
 }
 
-static celix_hash_map_entry_t* celix_hashMap_getEntry(const celix_hash_map_t* map, const char* strKey, long longKey) {
-    celix_hash_map_key_t key;
-    if (map->keyType == CELIX_HASH_MAP_STRING_KEY) {
-        key.strKey = strKey;
-    } else {
-        key.longKey = longKey;
-    }
-    unsigned int hash = map->hashKeyFunction(&key);
+static celix_hash_map_entry_t* celix_hashMap_getEntryWithHash(const celix_hash_map_t* map, const celix_hash_map_key_t* keyPtr, unsigned int hash) {
+    celix_hash_map_key_t key = *keyPtr;
     unsigned int index = celix_hashMap_indexFor(hash, map->bucketsSize);
     for (celix_hash_map_entry_t* entry = map->buckets[index]; entry != NULL; entry = entry->next) {
         if (entry->hash == hash && map->equalsKeyFunction(&key, &entry->key)) {
@@ -127,6 +122,16 @@ static celix_hash_map_entry_t* celix_hashMap_getEntry(const celix_hash_map_t* ma
     return NULL;
 }
 
+static celix_hash_map_entry_t* celix_hashMap_getEntry(const celix_hash_map_t* map, const char* strKey, long longKey) {
+    celix_hash_map_key_t key;
+    if (map->keyType == CELIX_HASH_MAP_STRING_KEY) {
+        key.strKey = strKey;
+    } else {
+        key.longKey = longKey;
+    }
+    return celix_hashMap_getEntryWithHash(map, &key, map->hashKeyFunction(&key));
+}
+
 static void* celix_hashMap_get(const celix_hash_map_t* map, const char* strKey, long longKey) {
     celix_hash_map_entry_t* entry = celix_hashMap_getEntry(map, strKey, longKey);
     if (entry != NULL) {
@@ -477,6 +482,13 @@ void* celix_stringHashMap_get(const celix_string_hash_map_t* map, const char* ke
     return celix_hashMap_get(&map->genericMap, key, 0);
 }
 
+void* celix_stringHashMap_getWithHash(const celix_string_hash_map_t* map, const char* key, unsigned int hash) {
+    celix_hash_map_key_t k;
+    k.strKey = key;
+    celix_hash_map_entry_t* entry = celix_hashMap_getEntryWithHash(&map->genericMap, &k, hash);
+    return entry != NULL ? entry->value.ptrValue : NULL;
+}
+
 void* celix_longHashMap_get(const celix_long_hash_map_t* map, long key) {
     return celix_hashMap_get(&map->genericMap, NULL, key);
 }
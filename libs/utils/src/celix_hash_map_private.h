@@ -0,0 +1,41 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ *  KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CELIX_HASH_MAP_PRIVATE_H_
+#define CELIX_HASH_MAP_PRIVATE_H_
+
+#include "celix_string_hash_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Returns the value for the provided key, using an already calculated key hash.
+ *
+ * The hash must be calculated with celix_utils_stringHash. This is used by callers that look up the same
+ * (interned) key many times, e.g. compiled filters.
+ */
+void* celix_stringHashMap_getWithHash(const celix_string_hash_map_t* map, const char* key, unsigned int hash);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CELIX_HASH_MAP_PRIVATE_H_ */
@@ -22,11 +22,65 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <assert.h>
+#include <errno.h>
+#include <stdint.h>
 #include <utils.h>
 
 #include "celix_filter.h"
 #include "filter.h"
 #include "celix_errno.h"
+#include "celix_version.h"
+#include "celix_utils.h"
+#include "properties_private.h"
+
+/**
+ * Max number of unique attributes for which the properties entry lookups are cached during a single match.
+ */
+#define CELIX_FILTER_PROGRAM_MAX_CACHED_ATTRIBUTES 64
+
+typedef struct celix_filter_program celix_filter_program_t;
+
+/**
+ * Interned attribute key of a compiled filter program.
+ * Every unique attribute in a filter is stored once, together with its (pre-calculated) hash.
+ */
+typedef struct celix_filter_program_attribute {
+    const char* key;
+    unsigned int hash;
+} celix_filter_program_attribute_t;
+
+/**
+ * A single instruction of a compiled filter program.
+ *
+ * The instructions are stored in prefix order; the children of an AND, OR or NOT instruction directly follow the
+ * instruction and the `next` field points to the instruction after the complete (sub)program. This makes it
+ * possible to short-circuit by jumping over the remaining children.
+ */
+typedef struct celix_filter_instruction {
+    celix_filter_operand_t operand;
+    unsigned int next;
+    unsigned int attributeIndex;
+    const celix_filter_t* node; //the originating filter node, used for the string value and substring operands
+
+    //pre-parsed value for the ordering operands
+    bool hasDoubleValue;
+    double doubleValue;
+    celix_version_t* versionValue;
+} celix_filter_instruction_t;
+
+struct celix_filter_program {
+    unsigned int nrOfInstructions;
+    celix_filter_instruction_t* instructions;
+    unsigned int nrOfAttributes;
+    celix_filter_program_attribute_t* attributes;
+};
+
+typedef struct celix_filter_match_context {
+    const celix_filter_program_t* program;
+    const celix_properties_t* properties;
+    uint64_t lookedUp; //bitmask of the attribute indices for which a lookup is cached
+    const celix_properties_entry_t* entries[CELIX_FILTER_PROGRAM_MAX_CACHED_ATTRIBUTES];
+} celix_filter_match_context_t;
 
 static void filter_skipWhiteSpace(char* filterString, int* pos);
 static celix_filter_t * filter_parseFilter(char* filterString, int* pos);
@@ -38,7 +92,10 @@ static char * filter_parseAttr(char* filterString, int* pos);
 static char * filter_parseValue(char* filterString, int* pos);
 static celix_array_list_t* filter_parseSubstring(char* filterString, int* pos);
 
-static celix_status_t filter_compare(const celix_filter_t* filter, const char *propertyValue, bool *result);
+static celix_status_t filter_compare(const celix_filter_t* filter, const celix_properties_entry_t* entry, bool *result);
+static celix_filter_program_t* celix_filter_compile(const celix_filter_t* filter);
+static void celix_filter_destroyProgram(celix_filter_program_t* program);
+static bool celix_filter_matchTree(const celix_filter_t *filter, const celix_properties_t* properties);
 
 static void filter_skipWhiteSpace(char * filterString, int * pos) {
     int length;
@@ -415,14 +472,40 @@ celix_status_t filter_match(celix_filter_t * filter, celix_properties_t *propert
     return CELIX_SUCCESS;
 }
 
-static celix_status_t filter_compare(const celix_filter_t* filter, const char *propertyValue, bool *out) {
+/**
+ * Compares the typed value of a properties entry with the filter value for the ordering operands.
+ * If both the entry and the filter value are numeric (long or double) or versions, the typed values are compared,
+ * otherwise the string values are compared.
+ */
+static int filter_compareOrdering(const celix_filter_t* filter, const celix_properties_entry_t* entry) {
+    if (entry->hasDoubleValue) {
+        char* endptr = NULL;
+        errno = 0;
+        double filterDouble = strtod(filter->value, &endptr);
+        if (errno == 0 && endptr != filter->value && *endptr == '\0') {
+            return entry->doubleValue < filterDouble ? -1 : (entry->doubleValue > filterDouble ? 1 : 0);
+        }
+    }
+    if (entry->versionValue != NULL) {
+        celix_version_t* filterVersion = celix_version_createVersionFromString(filter->value);
+        if (filterVersion != NULL) {
+            int cmp = celix_version_compareTo(entry->versionValue, filterVersion);
+            celix_version_destroy(filterVersion);
+            return cmp;
+        }
+    }
+    return strcmp(entry->value, filter->value);
+}
+
+static celix_status_t filter_compare(const celix_filter_t* filter, const celix_properties_entry_t* entry, bool *out) {
     celix_status_t  status = CELIX_SUCCESS;
     bool result = false;
 
-    if (filter == NULL || propertyValue == NULL) {
+    if (filter == NULL || entry == NULL || entry->value == NULL) {
         *out = false;
         return status;
     }
+    const char* propertyValue = entry->value;
 
     switch (filter->operand) {
         case CELIX_FILTER_OPERAND_SUBSTRING: {
@@ -485,19 +568,19 @@ static celix_status_t filter_compare(const celix_filter_t* filter, const char *p
             return CELIX_SUCCESS;
         }
         case CELIX_FILTER_OPERAND_GREATER: {
-            *out = (strcmp(propertyValue, filter->value) > 0);
+            *out = (filter_compareOrdering(filter, entry) > 0);
             return CELIX_SUCCESS;
         }
         case CELIX_FILTER_OPERAND_GREATEREQUAL: {
-            *out = (strcmp(propertyValue, filter->value) >= 0);
+            *out = (filter_compareOrdering(filter, entry) >= 0);
             return CELIX_SUCCESS;
         }
         case CELIX_FILTER_OPERAND_LESS: {
-            *out = (strcmp(propertyValue, filter->value) < 0);
+            *out = (filter_compareOrdering(filter, entry) < 0);
             return CELIX_SUCCESS;
         }
         case CELIX_FILTER_OPERAND_LESSEQUAL: {
-            *out = (strcmp(propertyValue, filter->value) <= 0);
+            *out = (filter_compareOrdering(filter, entry) <= 0);
             return CELIX_SUCCESS;
         }
         case CELIX_FILTER_OPERAND_AND:
@@ -514,6 +597,231 @@ static celix_status_t filter_compare(const celix_filter_t* filter, const char *p
     return status;
 }
 
+static bool celix_filter_isComposite(const celix_filter_t* filter) {
+    return filter->operand == CELIX_FILTER_OPERAND_AND || filter->operand == CELIX_FILTER_OPERAND_OR ||
+           filter->operand == CELIX_FILTER_OPERAND_NOT;
+}
+
+static bool celix_filter_isOrdering(celix_filter_operand_t operand) {
+    return operand == CELIX_FILTER_OPERAND_GREATER || operand == CELIX_FILTER_OPERAND_GREATEREQUAL ||
+           operand == CELIX_FILTER_OPERAND_LESS || operand == CELIX_FILTER_OPERAND_LESSEQUAL;
+}
+
+/**
+ * Estimates in which order the children of an AND or OR should be evaluated, lower is earlier.
+ * For an AND the children that are most likely to fail (equals) are evaluated first and for an OR the children that
+ * are most likely to succeed (presence) are evaluated first. Composite children are evaluated last, because these are
+ * the most expensive to evaluate.
+ */
+static int celix_filter_evaluationRank(const celix_filter_t* filter, celix_filter_operand_t parentOperand) {
+    switch (filter->operand) {
+        case CELIX_FILTER_OPERAND_EQUAL:
+            return parentOperand == CELIX_FILTER_OPERAND_OR ? 1 : 0;
+        case CELIX_FILTER_OPERAND_PRESENT:
+            return parentOperand == CELIX_FILTER_OPERAND_OR ? 0 : 3;
+        case CELIX_FILTER_OPERAND_APPROX:
+        case CELIX_FILTER_OPERAND_GREATER:
+        case CELIX_FILTER_OPERAND_GREATEREQUAL:
+        case CELIX_FILTER_OPERAND_LESS:
+        case CELIX_FILTER_OPERAND_LESSEQUAL:
+            return 2;
+        case CELIX_FILTER_OPERAND_SUBSTRING:
+            return 3;
+        case CELIX_FILTER_OPERAND_NOT:
+            return 4;
+        default:
+            return 5;
+    }
+}
+
+static unsigned int celix_filter_countNodes(const celix_filter_t* filter) {
+    unsigned int count = 1;
+    if (celix_filter_isComposite(filter) && filter->children != NULL) {
+        for (int i = 0; i < celix_arrayList_size(filter->children); ++i) {
+            const celix_filter_t* child = celix_arrayList_get(filter->children, i);
+            if (child != NULL) {
+                count += celix_filter_countNodes(child);
+            }
+        }
+    }
+    return count;
+}
+
+static unsigned int celix_filter_internAttribute(celix_filter_program_t* program, const char* key) {
+    for (unsigned int i = 0; i < program->nrOfAttributes; ++i) {
+        if (strcmp(program->attributes[i].key, key) == 0) {
+            return i;
+        }
+    }
+    unsigned int index = program->nrOfAttributes++;
+    program->attributes[index].key = key;
+    program->attributes[index].hash = celix_utils_stringHash(key);
+    return index;
+}
+
+static bool celix_filter_compileNode(celix_filter_program_t* program, const celix_filter_t* filter) {
+    unsigned int index = program->nrOfInstructions++;
+    celix_filter_instruction_t* instr = &program->instructions[index];
+    instr->operand = filter->operand;
+    instr->node = filter;
+
+    bool ok = true;
+    if (celix_filter_isComposite(filter)) {
+        int size = filter->children == NULL ? 0 : celix_arrayList_size(filter->children);
+        const celix_filter_t** children = calloc(size == 0 ? 1 : size, sizeof(*children));
+        if (children == NULL) {
+            return false;
+        }
+        int nrOfChildren = 0;
+        for (int i = 0; i < size; ++i) {
+            const celix_filter_t* child = celix_arrayList_get(filter->children, i);
+            if (child == NULL) {
+                continue;
+            }
+            //stable insertion sort on evaluation rank
+            int rank = celix_filter_evaluationRank(child, filter->operand);
+            int pos = nrOfChildren;
+            while (pos > 0 && celix_filter_evaluationRank(children[pos - 1], filter->operand) > rank) {
+                children[pos] = children[pos - 1];
+                pos -= 1;
+            }
+            children[pos] = child;
+            nrOfChildren += 1;
+        }
+        for (int i = 0; ok && i < nrOfChildren; ++i) {
+            ok = celix_filter_compileNode(program, children[i]);
+        }
+        free(children);
+    } else {
+        instr->attributeIndex = celix_filter_internAttribute(program, filter->attribute);
+        if (celix_filter_isOrdering(filter->operand)) {
+            char* endptr = NULL;
+            errno = 0;
+            double d = strtod(filter->value, &endptr);
+            if (errno == 0 && endptr != filter->value && *endptr == '\0') {
+                instr->hasDoubleValue = true;
+                instr->doubleValue = d;
+            }
+            instr->versionValue = celix_version_createVersionFromString(filter->value);
+        }
+    }
+    //note instructions array is preallocated, so instr is still valid
+    instr->next = program->nrOfInstructions;
+    return ok;
+}
+
+/**
+ * Compiles a filter (tree) into a flat filter program.
+ * The program pre-parses the numeric and version values for the ordering operands, interns the attribute keys
+ * (including the pre-calculated key hash) and orders the children of AND and OR operands on evaluation rank.
+ */
+static celix_filter_program_t* celix_filter_compile(const celix_filter_t* filter) {
+    unsigned int nrOfNodes = celix_filter_countNodes(filter);
+    celix_filter_program_t* program = calloc(1, sizeof(*program));
+    if (program == NULL) {
+        return NULL;
+    }
+    program->instructions = calloc(nrOfNodes, sizeof(*program->instructions));
+    program->attributes = calloc(nrOfNodes, sizeof(*program->attributes));
+    if (program->instructions == NULL || program->attributes == NULL || !celix_filter_compileNode(program, filter)) {
+        celix_filter_destroyProgram(program);
+        return NULL;
+    }
+    return program;
+}
+
+static void celix_filter_destroyProgram(celix_filter_program_t* program) {
+    if (program != NULL) {
+        if (program->instructions != NULL) {
+            for (unsigned int i = 0; i < program->nrOfInstructions; ++i) {
+                if (program->instructions[i].versionValue != NULL) {
+                    celix_version_destroy(program->instructions[i].versionValue);
+                }
+            }
+        }
+        free(program->instructions);
+        free(program->attributes);
+        free(program);
+    }
+}
+
+static const celix_properties_entry_t* celix_filter_lookupEntry(celix_filter_match_context_t* ctx, unsigned int attributeIndex) {
+    const celix_filter_program_attribute_t* attr = &ctx->program->attributes[attributeIndex];
+    if (attributeIndex >= CELIX_FILTER_PROGRAM_MAX_CACHED_ATTRIBUTES) {
+        return celix_properties_getEntryWithHash(ctx->properties, attr->key, attr->hash);
+    }
+    uint64_t mask = ((uint64_t)1) << attributeIndex;
+    if ((ctx->lookedUp & mask) == 0) {
+        ctx->entries[attributeIndex] = celix_properties_getEntryWithHash(ctx->properties, attr->key, attr->hash);
+        ctx->lookedUp |= mask;
+    }
+    return ctx->entries[attributeIndex];
+}
+
+/**
+ * Compiled variant of filter_compareOrdering.
+ */
+static int celix_filter_compareOrderingCompiled(const celix_filter_instruction_t* instr, const celix_properties_entry_t* entry) {
+    if (entry->hasDoubleValue && instr->hasDoubleValue) {
+        return entry->doubleValue < instr->doubleValue ? -1 : (entry->doubleValue > instr->doubleValue ? 1 : 0);
+    }
+    if (entry->versionValue != NULL && instr->versionValue != NULL) {
+        return celix_version_compareTo(entry->versionValue, instr->versionValue);
+    }
+    return strcmp(entry->value, instr->node->value);
+}
+
+static bool celix_filter_evaluate(celix_filter_match_context_t* ctx, unsigned int index) {
+    const celix_filter_instruction_t* instr = &ctx->program->instructions[index];
+    switch (instr->operand) {
+        case CELIX_FILTER_OPERAND_AND:
+            for (unsigned int child = index + 1; child < instr->next; child = ctx->program->instructions[child].next) {
+                if (!celix_filter_evaluate(ctx, child)) {
+                    return false;
+                }
+            }
+            return true;
+        case CELIX_FILTER_OPERAND_OR:
+            for (unsigned int child = index + 1; child < instr->next; child = ctx->program->instructions[child].next) {
+                if (celix_filter_evaluate(ctx, child)) {
+                    return true;
+                }
+            }
+            return false;
+        case CELIX_FILTER_OPERAND_NOT:
+            return index + 1 < instr->next ? !celix_filter_evaluate(ctx, index + 1) : true;
+        default:
+            break;
+    }
+
+    const celix_properties_entry_t* entry = celix_filter_lookupEntry(ctx, instr->attributeIndex);
+    if (entry == NULL || entry->value == NULL) {
+        return false;
+    }
+    switch (instr->operand) {
+        case CELIX_FILTER_OPERAND_PRESENT:
+            return true;
+        case CELIX_FILTER_OPERAND_APPROX:
+        case CELIX_FILTER_OPERAND_EQUAL:
+            return strcmp(entry->value, instr->node->value) == 0;
+        case CELIX_FILTER_OPERAND_GREATER:
+            return celix_filter_compareOrderingCompiled(instr, entry) > 0;
+        case CELIX_FILTER_OPERAND_GREATEREQUAL:
+            return celix_filter_compareOrderingCompiled(instr, entry) >= 0;
+        case CELIX_FILTER_OPERAND_LESS:
+            return celix_filter_compareOrderingCompiled(instr, entry) < 0;
+        case CELIX_FILTER_OPERAND_LESSEQUAL:
+            return celix_filter_compareOrderingCompiled(instr, entry) <= 0;
+        case CELIX_FILTER_OPERAND_SUBSTRING: {
+            bool result = false;
+            filter_compare(instr->node, entry, &result);
+            return result;
+        }
+        default:
+            return false;
+    }
+}
+
 celix_status_t filter_getString(celix_filter_t * filter, const char **filterStr) {
     if (filter != NULL) {
         *filterStr = filter->filterStr;
@@ -554,6 +862,7 @@ celix_filter_t* celix_filter_create(const char *filterString) {
         free(filterStr);
     } else {
         filter->filterStr = filterStr;
+        filter->program = celix_filter_compile(filter);
     }
 
     return filter;
@@ -584,6 +893,8 @@ void celix_filter_destroy(celix_filter_t *filter) {
                 fprintf(stderr, "Filter Error: Corrupt filter. children has a value, but not an expected operand\n");
             }
         }
+        celix_filter_destroyProgram(filter->program);
+        filter->program = NULL;
         free((char*)filter->value);
         filter->value = NULL;
         free((char*)filter->attribute);
@@ -598,13 +909,30 @@ bool celix_filter_match(const celix_filter_t *filter, const celix_properties_t*
     if (filter == NULL) {
         return true; //matching on null(empty) filter is always true
     }
+    if (filter->program != NULL) {
+        celix_filter_match_context_t ctx;
+        ctx.program = filter->program;
+        ctx.properties = properties;
+        ctx.lookedUp = 0;
+        return celix_filter_evaluate(&ctx, 0);
+    }
+    return celix_filter_matchTree(filter, properties);
+}
+
+/**
+ * Matches a filter by walking the filter tree. Used for filters without a compiled program (i.e. child filters).
+ */
+static bool celix_filter_matchTree(const celix_filter_t *filter, const celix_properties_t* properties) {
+    if (filter == NULL) {
+        return true;
+    }
     bool result = false;
     switch (filter->operand) {
         case CELIX_FILTER_OPERAND_AND: {
             celix_array_list_t* children = filter->children;
             for (int i = 0; i < celix_arrayList_size(children); i++) {
                 celix_filter_t * sfilter = (celix_filter_t *) celix_arrayList_get(children, i);
-                bool mresult = celix_filter_match(sfilter, properties);
+                bool mresult = celix_filter_matchTree(sfilter, properties);
                 if (!mresult) {
                     return false;
                 }
@@ -615,7 +943,7 @@ bool celix_filter_match(const celix_filter_t *filter, const celix_properties_t*
             celix_array_list_t* children = filter->children;
             for (int i = 0; i < celix_arrayList_size(children); i++) {
                 celix_filter_t * sfilter = (celix_filter_t *) celix_arrayList_get(children, i);
-                bool mresult = celix_filter_match(sfilter, properties);
+                bool mresult = celix_filter_matchTree(sfilter, properties);
                 if (mresult) {
                     return true;
                 }
@@ -624,7 +952,7 @@ bool celix_filter_match(const celix_filter_t *filter, const celix_properties_t*
         }
         case CELIX_FILTER_OPERAND_NOT: {
             celix_filter_t * sfilter = celix_arrayList_get(filter->children, 0);
-            bool mresult = celix_filter_match(sfilter, properties);
+            bool mresult = celix_filter_matchTree(sfilter, properties);
             return !mresult;
         }
         case CELIX_FILTER_OPERAND_SUBSTRING :
@@ -634,8 +962,8 @@ bool celix_filter_match(const celix_filter_t *filter, const celix_properties_t*
         case CELIX_FILTER_OPERAND_LESS :
         case CELIX_FILTER_OPERAND_LESSEQUAL :
         case CELIX_FILTER_OPERAND_APPROX : {
-            char * value = (properties == NULL) ? NULL: (char*)celix_properties_get(properties, filter->attribute, NULL);
-            filter_compare(filter, value, &result);
+            const celix_properties_entry_t* entry = celix_properties_getEntry(properties, filter->attribute);
+            filter_compare(filter, entry, &result);
             return result;
         }
         case CELIX_FILTER_OPERAND_PRESENT: {
@@ -27,12 +27,18 @@
 #include "celix_build_assert.h"
 #include "celix_properties.h"
 #include "utils.h"
-#include "hash_map_private.h"
 #include <errno.h>
-#include "hash_map.h"
+#include "celix_string_hash_map.h"
+#include "celix_version.h"
+#include "celix_hash_map_private.h"
+#include "properties_private.h"
 
 #define MALLOC_BLOCK_SIZE        5
 
+struct celix_properties {
+    celix_string_hash_map_t* map; //key = char*, value = celix_properties_entry_t*
+};
+
 static void parseLine(const char* line, celix_properties_t *props);
 
 properties_pt properties_create(void) {
@@ -212,19 +218,98 @@ static void parseLine(const char* line, celix_properties_t *props) {
 
 
 
+/**
+ * Fills the typed values of the entry by parsing the string value of the entry once.
+ * Note that the parsing rules are the same as the - previous - parsing done in celix_properties_getAs*,
+ * except for double values which are only cached if the complete value is numeric and bool values which are only
+ * cached if the complete (trimmed) value is "true" or "false".
+ */
+static void celix_properties_parseEntryValues(celix_properties_entry_t* entry) {
+    const char* val = entry->value;
+    if (val == NULL) {
+        return;
+    }
+
+    char* enptr = NULL;
+    errno = 0;
+    long l = strtol(val, &enptr, 10);
+    if (enptr != val && errno == 0) {
+        entry->hasLongValue = true;
+        entry->longValue = l;
+    }
+
+    //note only complete numeric values are cached as double, so that e.g. "1.2.3" is not seen as double 1.2
+    enptr = NULL;
+    errno = 0;
+    double d = strtod(val, &enptr);
+    if (enptr != val && errno == 0) {
+        while (isspace(*enptr)) {
+            ++enptr;
+        }
+        if (*enptr == '\0') {
+            entry->hasDoubleValue = true;
+            entry->doubleValue = d;
+        }
+    }
+
+    //note only complete bool values are cached as bool, so that e.g. "trueish" is not seen as true
+    const char* trimmed = val;
+    while (isspace(*trimmed)) {
+        ++trimmed;
+    }
+    size_t trimmedLen = strlen(trimmed);
+    while (trimmedLen > 0 && isspace(trimmed[trimmedLen - 1])) {
+        --trimmedLen;
+    }
+    if (trimmedLen == strlen("true") && strncasecmp("true", trimmed, trimmedLen) == 0) {
+        entry->hasBoolValue = true;
+        entry->boolValue = true;
+    } else if (trimmedLen == strlen("false") && strncasecmp("false", trimmed, trimmedLen) == 0) {
+        entry->hasBoolValue = true;
+        entry->boolValue = false;
+    }
+
+    //only try to parse version like values (e.g. "1.2.3"), to prevent a version allocation for every numeric value
+    if (isdigit(val[0]) && strchr(val, '.') != NULL) {
+        entry->versionValue = celix_version_createVersionFromString(val);
+    }
+}
+
+static celix_properties_entry_t* celix_properties_createEntry(char* value) {
+    celix_properties_entry_t* entry = calloc(1, sizeof(*entry));
+    entry->value = value;
+    return entry;
+}
+
+static void celix_properties_destroyEntry(void* data) {
+    celix_properties_entry_t* entry = data;
+    if (entry != NULL) {
+        celix_version_destroy(entry->versionValue);
+        free(entry->value);
+        free(entry);
+    }
+}
+
+/**
+ * Puts the entry in the properties and destroys the replaced entry (if any).
+ */
+static void celix_properties_putEntry(celix_properties_t *properties, const char* key, celix_properties_entry_t* entry) {
+    celix_properties_entry_t* replaced = celix_stringHashMap_put(properties->map, key, entry);
+    celix_properties_destroyEntry(replaced);
+}
+
 celix_properties_t* celix_properties_create(void) {
-    return hashMap_create(utils_stringHash, utils_stringHash, utils_stringEquals, utils_stringEquals);
+    celix_properties_t* props = malloc(sizeof(*props));
+    celix_string_hash_map_create_options_t opts = CELIX_EMPTY_STRING_HASH_MAP_CREATE_OPTIONS;
+    opts.simpleRemovedCallback = celix_properties_destroyEntry;
+    props->map = celix_stringHashMap_createWithOptions(&opts);
+    return props;
 }
 
 void celix_properties_destroy(celix_properties_t *properties) {
     if (properties != NULL) {
-        hash_map_iterator_pt iter = hashMapIterator_create(properties);
-        while (hashMapIterator_hasNext(iter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-            hashMapEntry_clear(entry, true, true);
-        }
-        hashMapIterator_destroy(iter);
-        hashMap_destroy(properties, false, false);
+        celix_stringHashMap_destroy(properties->map);
+        free(properties);
     }
 }
 
@@ -303,35 +388,33 @@ celix_properties_t* celix_properties_loadFromString(const char *input) {
 
 void celix_properties_store(celix_properties_t *properties, const char *filename, const char *header) {
     FILE *file = fopen (filename, "w+" );
-    char *str;
+    const char *str;
 
     if (file != NULL) {
-        if (hashMap_size(properties) > 0) {
-            hash_map_iterator_pt iterator = hashMapIterator_create(properties);
-            while (hashMapIterator_hasNext(iterator)) {
-                hash_map_entry_pt entry = hashMapIterator_nextEntry(iterator);
-                str = hashMapEntry_getKey(entry);
-                for (int i = 0; i < strlen(str); i += 1) {
-                    if (str[i] == '#' || str[i] == '!' || str[i] == '=' || str[i] == ':') {
-                        fputc('\\', file);
-                    }
-                    fputc(str[i], file);
+        CELIX_STRING_HASH_MAP_ITERATE(properties->map, iter) {
+            const celix_properties_entry_t* entry = iter.value.ptrValue;
+            if (entry->value == NULL) {
+                continue;
+            }
+            str = iter.key;
+            for (int i = 0; i < strlen(str); i += 1) {
+                if (str[i] == '#' || str[i] == '!' || str[i] == '=' || str[i] == ':') {
+                    fputc('\\', file);
                 }
+                fputc(str[i], file);
+            }
 
-                fputc('=', file);
+            fputc('=', file);
 
-                str = hashMapEntry_getValue(entry);
-                for (int i = 0; i < strlen(str); i += 1) {
-                    if (str[i] == '#' || str[i] == '!' || str[i] == '=' || str[i] == ':') {
-                        fputc('\\', file);
-                    }
-                    fputc(str[i], file);
+            str = entry->value;
+            for (int i = 0; i < strlen(str); i += 1) {
+                if (str[i] == '#' || str[i] == '!' || str[i] == '=' || str[i] == ':') {
+                    fputc('\\', file);
                 }
-
-                fputc('\n', file);
-
+                fputc(str[i], file);
             }
-            hashMapIterator_destroy(iterator);
+
+            fputc('\n', file);
         }
         fclose(file);
     } else {
@@ -342,97 +425,114 @@ void celix_properties_store(celix_properties_t *properties, const char *filename
 celix_properties_t* celix_properties_copy(const celix_properties_t *properties) {
     celix_properties_t *copy = celix_properties_create();
     if (properties != NULL) {
-        hash_map_iterator_t iter = hashMapIterator_construct((hash_map_t*)properties);
-        while (hashMapIterator_hasNext(&iter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(&iter);
-            char *key = hashMapEntry_getKey(entry);
-            char *value = hashMapEntry_getValue(entry);
-            celix_properties_set(copy, key, value);
+        CELIX_STRING_HASH_MAP_ITERATE(properties->map, iter) {
+            const celix_properties_entry_t* entry = iter.value.ptrValue;
+            celix_properties_entry_t* entryCopy = celix_properties_createEntry(entry->value == NULL ? NULL : strdup(entry->value));
+            entryCopy->hasLongValue = entry->hasLongValue;
+            entryCopy->longValue = entry->longValue;
+            entryCopy->hasDoubleValue = entry->hasDoubleValue;
+            entryCopy->doubleValue = entry->doubleValue;
+            entryCopy->hasBoolValue = entry->hasBoolValue;
+            entryCopy->boolValue = entry->boolValue;
+            entryCopy->versionValue = entry->versionValue == NULL ? NULL : celix_version_copy(entry->versionValue);
+            celix_properties_putEntry(copy, iter.key, entryCopy);
         }
     }
     return copy;
 }
 
-const char* celix_properties_get(const celix_properties_t *properties, const char *key, const char *defaultValue) {
-    const char* value = NULL;
+const celix_properties_entry_t* celix_properties_getEntry(const celix_properties_t *properties, const char *key) {
+    const celix_properties_entry_t* entry = NULL;
     if (properties != NULL) {
-        value = hashMap_get((hash_map_t*)properties, (void*)key);
+        entry = celix_stringHashMap_get(properties->map, key);
     }
-    return value == NULL ? defaultValue : value;
+    return entry;
+}
+
+const celix_properties_entry_t* celix_properties_getEntryWithHash(const celix_properties_t *properties, const char *key, unsigned int keyHash) {
+    const celix_properties_entry_t* entry = NULL;
+    if (properties != NULL) {
+        entry = celix_stringHashMap_getWithHash(properties->map, key, keyHash);
+    }
+    return entry;
+}
+
+const char* celix_properties_get(const celix_properties_t *properties, const char *key, const char *defaultValue) {
+    const celix_properties_entry_t* entry = celix_properties_getEntry(properties, key);
+    return entry == NULL || entry->value == NULL ? defaultValue : entry->value;
 }
 
 void celix_properties_set(celix_properties_t *properties, const char *key, const char *value) {
     if (properties != NULL) {
-        hash_map_entry_pt entry = hashMap_getEntry(properties, key);
-        char *oldVal = NULL;
         char *newVal = value == NULL ? NULL : strndup(value, 1024 * 1024);
-        if (entry != NULL) {
-            char *oldKey = hashMapEntry_getKey(entry);
-            oldVal = hashMapEntry_getValue(entry);
-            hashMap_put(properties, oldKey, newVal);
-        } else {
-            hashMap_put(properties, strndup(key, 1024 * 1024), newVal);
-        }
-        free(oldVal);
+        celix_properties_entry_t* entry = celix_properties_createEntry(newVal);
+        celix_properties_parseEntryValues(entry);
+        celix_properties_putEntry(properties, key, entry);
     }
 }
 
 void celix_properties_setWithoutCopy(celix_properties_t *properties, char *key, char *value) {
     if (properties != NULL) {
-        hash_map_entry_pt entry = hashMap_getEntry(properties, key);
-        char *oldVal = NULL;
-        if (entry != NULL) {
-            char *oldKey = hashMapEntry_getKey(entry);
-            oldVal = hashMapEntry_getValue(entry);
-            hashMap_put(properties, oldKey, value);
-        } else {
-            hashMap_put(properties, key, value);
-        }
-        free(oldVal);
+        celix_properties_entry_t* entry = celix_properties_createEntry(value);
+        celix_properties_parseEntryValues(entry);
+        celix_properties_putEntry(properties, key, entry);
+        free(key); //note the string hash map stores a copy of the key.
     }
 }
 
 void celix_properties_unset(celix_properties_t *properties, const char *key) {
-    char* oldValue = hashMap_removeFreeKey(properties, key);
-    free(oldValue);
+    if (properties != NULL) {
+        celix_stringHashMap_remove(properties->map, key);
+    }
 }
 
 long celix_properties_getAsLong(const celix_properties_t *props, const char *key, long defaultValue) {
-    long result = defaultValue;
-    const char *val = celix_properties_get(props, key, NULL);
-    if (val != NULL) {
-        char *enptr = NULL;
-        errno = 0;
-        long r = strtol(val, &enptr, 10);
-        if (enptr != val && errno == 0) {
-            result = r;
-        }
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    return entry != NULL && entry->hasLongValue ? entry->longValue : defaultValue;
+}
+
+/**
+ * Writes a long as decimal string to buf, which should be at least 21 chars. Returns the start of the string in buf.
+ */
+static char* celix_properties_longToString(long value, char* buf, size_t bufSize) {
+    char* p = buf + bufSize - 1;
+    *p = '\0';
+    unsigned long v = value < 0 ? -(unsigned long)value : (unsigned long)value;
+    do {
+        *--p = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v != 0);
+    if (value < 0) {
+        *--p = '-';
     }
-    return result;
+    return p;
 }
 
 void celix_properties_setLong(celix_properties_t *props, const char *key, long value) {
-    char buf[32]; //should be enough to store long long int
-    int writen = snprintf(buf, 32, "%li", value);
-    if (writen <= 31) {
-        celix_properties_set(props, key, buf);
-    } else {
-        fprintf(stderr,"buf to small for value '%li'\n", value);
+    if (props != NULL) {
+        char buf[32]; //should be enough to store long long int
+        const char* str = celix_properties_longToString(value, buf, sizeof(buf));
+        celix_properties_entry_t* entry = celix_properties_createEntry(strdup(str));
+        entry->hasLongValue = true;
+        entry->longValue = value;
+        entry->hasDoubleValue = true;
+        entry->doubleValue = (double)value;
+        celix_properties_putEntry(props, key, entry);
     }
 }
 
 double celix_properties_getAsDouble(const celix_properties_t *props, const char *key, double defaultValue) {
-    double result = defaultValue;
-    const char *val = celix_properties_get(props, key, NULL);
-    if (val != NULL) {
-        char *enptr = NULL;
-        errno = 0;
-        double r = strtod(val, &enptr);
-        if (enptr != val && errno == 0) {
-            result = r;
-        }
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    if (entry == NULL || entry->value == NULL) {
+        return defaultValue;
+    } else if (entry->hasDoubleValue) {
+        return entry->doubleValue;
     }
-    return result;
+    //value is not a complete double, fallback to parsing the leading part of the value
+    char* enptr = NULL;
+    errno = 0;
+    double d = strtod(entry->value, &enptr);
+    return enptr != entry->value && errno == 0 ? d : defaultValue;
 }
 
 void celix_properties_setDouble(celix_properties_t *props, const char *key, double val) {
@@ -446,65 +546,57 @@ void celix_properties_setDouble(celix_properties_t *props, const char *key, doub
 }
 
 bool celix_properties_getAsBool(const celix_properties_t *props, const char *key, bool defaultValue) {
-    bool result = defaultValue;
-    const char *val = celix_properties_get(props, key, NULL);
-    if (val != NULL) {
-        char buf[32];
-        snprintf(buf, 32, "%s", val);
-        char *trimmed = utils_stringTrim(buf);
-        if (strncasecmp("true", trimmed, strlen("true")) == 0) {
-            result = true;
-        } else if (strncasecmp("false", trimmed, strlen("false")) == 0) {
-            result = false;
-        }
-    }
-    return result;
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    return entry != NULL && entry->hasBoolValue ? entry->boolValue : defaultValue;
 }
 
 void celix_properties_setBool(celix_properties_t *props, const char *key, bool val) {
-    celix_properties_set(props, key, val ? "true" : "false");
+    if (props != NULL) {
+        celix_properties_entry_t* entry = celix_properties_createEntry(strdup(val ? "true" : "false"));
+        entry->hasBoolValue = true;
+        entry->boolValue = val;
+        celix_properties_putEntry(props, key, entry);
+    }
+}
+
+const celix_version_t* celix_properties_getVersion(const celix_properties_t *props, const char *key, const celix_version_t* defaultValue) {
+    const celix_properties_entry_t* entry = celix_properties_getEntry(props, key);
+    return entry != NULL && entry->versionValue != NULL ? entry->versionValue : defaultValue;
+}
+
+void celix_properties_setVersion(celix_properties_t *props, const char *key, const celix_version_t* version) {
+    if (props != NULL && version != NULL) {
+        celix_properties_entry_t* entry = celix_properties_createEntry(celix_version_toString(version));
+        celix_properties_parseEntryValues(entry);
+        celix_properties_putEntry(props, key, entry);
+    }
 }
 
 int celix_properties_size(const celix_properties_t *properties) {
-    return hashMap_size((hash_map_t*)properties);
+    return properties == NULL ? 0 : (int)celix_stringHashMap_size(properties->map);
 }
 
 celix_properties_iterator_t celix_propertiesIterator_construct(const celix_properties_t *properties) {
     celix_properties_iterator_t iter;
-    CELIX_BUILD_ASSERT(sizeof(celix_properties_iterator_t) == sizeof(hash_map_iterator_t));
-    CELIX_BUILD_ASSERT(__alignof__(celix_properties_iterator_t) == __alignof__(hash_map_iterator_t));
-    hash_map_iterator_t mapIter = hashMapIterator_construct((hash_map_t*)properties);
-    iter._data1 = mapIter.map;
-    iter._data2 = mapIter.next;
-    iter._data3 = mapIter.current;
-    iter._data4 = mapIter.expectedModCount;
-    iter._data5 = mapIter.index;
+    memset(&iter, 0, sizeof(iter));
+    iter._data1 = (void*)properties;
+    if (properties != NULL) {
+        iter._data3 = celix_stringHashMap_begin(properties->map);
+    }
     return iter;
 }
 
 bool celix_propertiesIterator_hasNext(celix_properties_iterator_t *iter) {
-    hash_map_iterator_t mapIter;
-    mapIter.map = iter->_data1;
-    mapIter.next = iter->_data2;
-    mapIter.current = iter->_data3;
-    mapIter.expectedModCount = iter->_data4;
-    mapIter.index = iter->_data5;
-    bool hasNext = hashMapIterator_hasNext(&mapIter);
-    return hasNext;
+    return iter->_data1 != NULL && !celix_stringHashMapIterator_isEnd(&iter->_data3);
 }
+
 const char* celix_propertiesIterator_nextKey(celix_properties_iterator_t *iter) {
-    hash_map_iterator_t mapIter;
-    mapIter.map = iter->_data1;
-    mapIter.next = iter->_data2;
-    mapIter.current = iter->_data3;
-    mapIter.expectedModCount = iter->_data4;
-    mapIter.index = iter->_data5;
-    const char* result = (const char*)hashMapIterator_nextKey(&mapIter);
-    iter->_data1 = mapIter.map;
-    iter->_data2 = mapIter.next;
-    iter->_data3 = mapIter.current;
-    iter->_data4 = mapIter.expectedModCount;
-    iter->_data5 = mapIter.index;
+    if (!celix_propertiesIterator_hasNext(iter)) {
+        return NULL;
+    }
+    const char* result = iter->_data3.key;
+    celix_stringHashMapIterator_next(&iter->_data3);
+    iter->_data2 += 1;
     return result;
 }
 